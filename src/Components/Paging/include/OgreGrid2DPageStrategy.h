@@ -138,6 +138,8 @@ namespace Ogre
 		int32 mMinCellY;
 		int32 mMaxCellX;
 		int32 mMaxCellY;
+		/// How far ahead to predict camera motion (seconds)
+		Real mPredictionTime;
 
 		void updateDerivedMetrics();
 
@@ -174,6 +176,20 @@ namespace Ogre
 		virtual Real getLoadRadiusInCells() { return mLoadRadiusInCells; }
 		/// Get the Hold radius as a multiple of cells
 		virtual Real getHoldRadiusInCells(){ return mHoldRadiusInCells; }
+		/** Set how far ahead the motion of the camera should be predicted.
+		@remarks
+			When this is non-zero, the velocity of the camera (as tracked by the 
+			PageManager) is extrapolated over this period, and pages within the 
+			load radius of the predicted path are requested ahead of time, so that
+			they are ready when a fast-moving camera gets there. Pages are requested 
+			in order of how soon they'll be needed, and ones which drop off the 
+			predicted path are released again like any other page which isn't held.
+			This is a runtime setting which is not saved with the data.
+		@param secs The time to look ahead in seconds, or 0 to disable prediction (the default)
+		*/
+		virtual void setPredictionTime(Real secs) { mPredictionTime = secs; }
+		/// Get how far ahead the motion of the camera should be predicted
+		virtual Real getPredictionTime() const { return mPredictionTime; }
 
 		/// Set the index range of all cells (values outside this will be ignored)
 		virtual void setCellRange(int32 minX, int32 minY, int32 maxX, int32 maxY);
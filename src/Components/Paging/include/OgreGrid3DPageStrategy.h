@@ -120,6 +120,8 @@ namespace Ogre
 		int32 mMaxCellX;
 		int32 mMaxCellY;
 		int32 mMaxCellZ;
+		/// How far ahead to predict camera motion (seconds)
+		Real mPredictionTime;
 
 	public:
 		static const uint32 CHUNK_ID;
@@ -144,6 +146,17 @@ namespace Ogre
 		virtual void setHoldRadius(Real sz);
 		/// Get the Holding radius 
 		virtual Real getHoldRadius() const { return mHoldRadius; }
+		/** Set how far ahead the motion of the camera should be predicted.
+		@remarks
+			Pages within the load radius of the extrapolated camera path are 
+			requested ahead of time, regardless of whether they are visible yet.
+			This is a runtime setting which is not saved with the data.
+		@see Grid2DPageStrategyData::setPredictionTime
+		@param secs The time to look ahead in seconds, or 0 to disable prediction (the default)
+		*/
+		virtual void setPredictionTime(Real secs) { mPredictionTime = secs; }
+		/// Get how far ahead the motion of the camera should be predicted
+		virtual Real getPredictionTime() const { return mPredictionTime; }
 
 		/// Set the index range of all cells (values outside this will be ignored)
 		virtual void setCellRange(int32 minX, int32 minY, int32 minZ, int32 maxX, int32 maxY, int32 maxZ);
@@ -56,8 +56,11 @@ namespace Ogre
 		unsigned long mFrameLastHeld;
 		ContentCollectionList mContentCollections;
 		uint16 mWorkQueueChannel;
+		WorkQueue::RequestID mPendingRequestID;
 		bool mDeferredProcessInProgress;
+		bool mLoadSynchronous;
 		bool mModified;
+		bool mPinned;
 
 		SceneNode* mDebugNode;
 		void updateDebugDisplay();
@@ -65,7 +68,12 @@ namespace Ogre
 		struct PageData : public PageAlloc
 		{
 			ContentCollectionList collectionsToAdd;
+
+			~PageData();
 		};
+		typedef SharedPtr<PageData> PageDataPtr;
+		/// Prepared data waiting for its turn to be loaded (see PageManager::setPageLoadTimeLimit)
+		PageDataPtr mPreparedData;
 		/// Structure for holding background page requests
 		struct PageRequest
 		{
@@ -77,12 +85,11 @@ namespace Ogre
 		};
 		struct PageResponse
 		{
-			PageData* pageData;
+			/// Shared so that the data is released even if the response is aborted
+			PageDataPtr pageData;
 
 			_OgrePagingExport friend std::ostream& operator<<(std::ostream& o, const PageResponse& r)
 			{ return o; }		
-
-			PageResponse() : pageData(0) {}
 		};
 
 
@@ -125,6 +132,15 @@ namespace Ogre
 		@param synchronous Whether to force this to happen synchronously.
 		*/
 		virtual void load(bool synchronous);
+		/** Abandon a background load of this page which has not completed yet.
+		@remarks
+			The request is aborted in the WorkQueue, so if it has not started
+			it will never be processed, and if it has it will not be applied
+			to this page. This is done automatically when a page is destroyed, 
+			so that requests for pages which are no longer wanted don't hold up
+			the ones which are.
+		*/
+		virtual void abortLoad();
 		/** Unload this page. 
 		*/
 		virtual void unload();
@@ -137,6 +153,29 @@ namespace Ogre
 		*/
 		virtual bool isHeld() const;
 
+		/** Pin this page, so that it stays loaded even when it's not held.
+		@remarks
+			Pinned pages are never unloaded by the paging system, either when 
+			the strategy stops requesting them or to keep within the memory
+			budget of the PageManager. They can still be unloaded explicitly.
+		*/
+		virtual void setPinned(bool pinned) { mPinned = pinned; }
+		/// Get whether this page is pinned
+		virtual bool isPinned() const { return mPinned; }
+
+		/** Get an estimate of the memory used by this page's content, and by its
+			section for it, in bytes.
+		@see PageManager::setPageMemoryBudget, PagedWorldSection::getPageMemoryUsage
+		*/
+		virtual size_t getMemoryUsage() const;
+
+		/** Complete a load which was deferred because the per-frame time limit 
+			had been reached.
+		@remarks
+			You should not call this method directly, it's called by the PageManager.
+		*/
+		virtual void _finaliseLoad();
+
 		/// Save page data to an automatically generated file name
 		virtual void save();
 		/// Save page data to a file
@@ -81,6 +81,14 @@ namespace Ogre
 		/// Unprepare data - may be called in the background
 		virtual void unprepare() = 0;
 
+		/** Get an estimate of the memory used by this content, in bytes.
+		@remarks
+			This is what the memory budget of the PageManager is measured against
+			(see PageManager::setPageMemoryBudget), so content which holds 
+			significant resources should report them here.
+		*/
+		virtual size_t getMemoryUsage() const { return 0; }
+
 	};
 
 	/** @} */
@@ -92,6 +92,9 @@ namespace Ogre
 		/// Unprepare data - may be called in the background
 		virtual void unprepare() = 0;
 
+		/// Get an estimate of the memory used by this collection, in bytes
+		virtual size_t getMemoryUsage() const { return 0; }
+
 
 	};
 
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreResourceGroupManager.h"
 #include "OgreCommon.h"
 #include "OgreCamera.h"
+#include "OgreSceneManager.h"
 #include "OgreFrameListener.h"
 
 namespace Ogre
@@ -395,6 +396,9 @@ namespace Ogre
 			Cameras to track. You may not want to have all your cameras affect
 			the paging system, so just add the cameras you want it to keep track of
 			here. 
+		@par
+			The camera stops being tracked when it is destroyed, or when the 
+			SceneManager which created it is.
 		*/
 		void addCamera(Camera* c);
 
@@ -410,6 +414,45 @@ namespace Ogre
 		/** Returns a list of cameras being tracked. */
 		const CameraList& getCameraList() const;
 
+		/** Get the estimated velocity of a tracked camera, in world units per second.
+		@remarks
+			The velocity is measured from the derived position of the camera at the
+			start of each frame, and smoothed over time (see setCameraVelocitySmoothing).
+			It is used by strategies which predict where the camera is headed,
+			so that pages can be requested before they're needed. 
+		@return The velocity, or Vector3::ZERO if the camera is not being tracked
+			or hasn't been tracked for long enough to tell.
+		*/
+		const Vector3& getCameraVelocity(Camera* c) const;
+
+		/** Set the time over which changes in camera velocity are smoothed.
+		@remarks
+			Larger values give steadier predictions for cameras with jittery motion,
+			smaller values react faster when the camera changes direction. 
+		@param secs Smoothing time in seconds; 0 means use the last frame's velocity only
+		*/
+		void setCameraVelocitySmoothing(Real secs) { mCameraVelocitySmoothing = secs; }
+		/** Get the time over which changes in camera velocity are smoothed. */
+		Real getCameraVelocitySmoothing() const { return mCameraVelocitySmoothing; }
+
+		/** Update the tracked camera velocities, called at the start of each frame.
+		@remarks
+			You should not need to call this method directly.
+		*/
+		void _updateCameraMotion(Real timeSinceLastFrame);
+
+		/** Finish loading queued pages, at the start of each frame.
+		@remarks
+			You should not call this method directly.
+		*/
+		void _processPageLoadQueue();
+		/** Unload pages to meet the memory budget and update the statistics, 
+			at the end of each frame.
+		@remarks
+			You should not call this method directly.
+		*/
+		void _enforcePageMemoryBudget(Real timeSinceLastFrame);
+
 		/** Set the debug display level.
 		@remarks
 			This setting controls how much debug information is displayed in the scene.
@@ -434,10 +477,83 @@ namespace Ogre
 		/** Get whether paging operations are currently allowed to happen. */
 		bool getPagingOperationsEnabled() const { return mPagingEnabled; }
 
+		/** Set the amount of memory that loaded pages may use before the least 
+			recently used ones are unloaded.
+		@remarks
+			By default (a budget of 0) pages are unloaded as soon as the PageStrategy
+			stops requesting or holding them. With a budget, those pages stay loaded
+			in a cache instead, so that coming back to an area doesn't mean loading
+			it again, and at the end of each frame pages are unloaded, least recently
+			held first, until the total is within the budget. Pages which are still 
+			held or which are pinned (see Page::setPinned) are never unloaded to 
+			meet the budget, so it may be exceeded if they alone are larger than it.
+		@par
+			Memory use is measured with Page::getMemoryUsage, which is only as good 
+			as the estimates reported by the page content and by the section (see
+			PagedWorldSection::getPageMemoryUsage). Terrain pages report the 
+			memory of their Terrain. 
+		@param bytes The budget in bytes, or 0 to not cache pages at all
+		*/
+		void setPageMemoryBudget(size_t bytes) { mPageMemoryBudget = bytes; }
+		/** Get the amount of memory that loaded pages may use. */
+		size_t getPageMemoryBudget() const { return mPageMemoryBudget; }
+		/** Get the memory used by all loaded pages, as of the end of the last frame. 
+		@note Only calculated when a memory budget is set.
+		*/
+		size_t getPageMemoryUsage() const { return mPageMemoryUsage; }
+
+		/** Set the time that may be spent in each frame finishing the loading of 
+			pages in the main thread.
+		@remarks
+			Pages are prepared in the background, but the final step of loading 
+			them (Page::loadImpl, which creates the scene content) has to happen 
+			in the main thread. When many pages complete at the same time this
+			can cause a hitch, so with a limit set, pages which complete once the
+			time is used up wait for a later frame, oldest first. Pages loaded 
+			synchronously are never delayed. At least one page is loaded per frame
+			whatever its cost, so loading always progresses.
+		@param ms The limit in milliseconds, or 0 for no limit (the default)
+		*/
+		void setPageLoadTimeLimit(unsigned long ms) { mPageLoadTimeLimit = ms; }
+		/** Get the time that may be spent in each frame finishing the loading of pages. */
+		unsigned long getPageLoadTimeLimit() const { return mPageLoadTimeLimit; }
+		/** Get the number of prepared pages waiting for time to finish loading. */
+		size_t getQueuedPageLoadCount() const { return mPageLoadQueue.size(); }
+
+		/** Get the number of pages finished loading per second, averaged over the 
+			last second or so.
+		*/
+		Real getPagesLoadedPerSecond() const { return mPagesLoadedPerSecond; }
+		/** Get the number of pages unloaded by the paging system per second, 
+			either because they were no longer held or to stay within the memory 
+			budget, averaged over the last second or so.
+		*/
+		Real getPagesEvictedPerSecond() const { return mPagesEvictedPerSecond; }
+
+		/** Called by a Page when its data has been prepared and it's ready to 
+			finish loading.
+		@remarks
+			You should not call this method directly. The page is loaded now if
+			there is time left in this frame (or synchronous is true), otherwise
+			it's queued for a later frame. 
+		*/
+		void _queuePageLoad(Page* page, bool synchronous);
+		/** Remove a page from the queue of pages waiting to finish loading. 
+		@remarks
+			You should not call this method directly.
+		*/
+		void _cancelPageLoad(Page* page);
+		/** Record that the paging system unloaded a page. 
+		@remarks
+			You should not call this method directly.
+		*/
+		void _notifyPageEvicted() { ++mPagesEvicted; }
+
 
 	protected:
 
-		class EventRouter : public Camera::Listener, public FrameListener
+		class EventRouter : public Camera::Listener, public SceneManager::Listener, 
+			public FrameListener
 		{
 		public:
 			PageManager* pManager;
@@ -449,6 +565,7 @@ namespace Ogre
 
 			void cameraPreRenderScene(Camera* cam);
 			void cameraDestroyed(Camera* cam);
+			void sceneManagerDestroyed(SceneManager* source);
 			bool frameStarted(const FrameEvent& evt);
 			bool frameEnded(const FrameEvent& evt);
 		};
@@ -456,6 +573,25 @@ namespace Ogre
 		void createStandardStrategies();
 		void createStandardContentFactories();
 
+		/// Tracked motion of a camera
+		struct CameraMotion
+		{
+			Vector3 lastPosition;
+			Vector3 velocity;
+			bool positionValid;
+
+			CameraMotion() : lastPosition(Vector3::ZERO), velocity(Vector3::ZERO), positionValid(false) {}
+		};
+		typedef map<Camera*, CameraMotion>::type CameraMotionMap;
+		typedef deque<Page*>::type PageQueue;
+
+		/// Whether any tracked camera belongs to a scene manager
+		bool isTrackingSceneManager(SceneManager* sm) const;
+		/// Whether there is any time left this frame to finish loading pages
+		bool hasPageLoadTimeRemaining() const;
+		/// Finish loading a page, measuring the time it takes
+		void finalisePageLoad(Page* page);
+
 		WorldMap mWorlds;
 		StrategyMap mStrategies;
 		ContentCollectionFactoryMap mContentCollectionFactories;
@@ -465,10 +601,27 @@ namespace Ogre
 		PageProvider* mPageProvider;
 		String mPageResourceGroup;
 		CameraList mCameraList;
+		CameraMotionMap mCameraMotion;
+		Real mCameraVelocitySmoothing;
 		EventRouter mEventRouter;
 		uint8 mDebugDisplayLvl;
 		bool mPagingEnabled;
 
+		size_t mPageMemoryBudget;
+		size_t mPageMemoryUsage;
+		unsigned long mPageLoadTimeLimit;
+		/// Time spent finishing page loads this frame, in microseconds
+		unsigned long mFrameLoadTime;
+		/// Pages finished loading this frame
+		size_t mFramePagesLoaded;
+		PageQueue mPageLoadQueue;
+
+		size_t mPagesLoaded;
+		size_t mPagesEvicted;
+		Real mStatisticsTime;
+		Real mPagesLoadedPerSecond;
+		Real mPagesEvictedPerSecond;
+
 		Grid2DPageStrategy* mGrid2DPageStrategy;
 		Grid3DPageStrategy* mGrid3DPageStrategy;
 		SimplePageContentCollectionFactory* mSimpleCollectionFactory;
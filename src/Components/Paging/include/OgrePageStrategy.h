@@ -75,6 +75,28 @@ namespace Ogre
 	protected:
 		String mName;
 		PageManager* mManager;
+
+		/// A page which a strategy wants loaded, and how soon it will be needed
+		struct PageLoadRequest
+		{
+			PageID pageID;
+			/// Estimated time in seconds until the page is needed, 0 if it is needed now
+			Real timeToNeeded;
+			/// Squared distance to the viewer at that time, to order equally urgent pages
+			Real distanceSq;
+
+			PageLoadRequest(PageID id, Real t, Real d) : pageID(id), timeToNeeded(t), distanceSq(d) {}
+
+			bool operator<(const PageLoadRequest& rhs) const
+			{
+				if (timeToNeeded != rhs.timeToNeeded)
+					return timeToNeeded < rhs.timeToNeeded;
+				return distanceSq < rhs.distanceSq;
+			}
+		};
+		typedef vector<PageLoadRequest>::type PageLoadRequestList;
+		/// Requests being gathered in notifyCamera, kept to avoid reallocating
+		PageLoadRequestList mLoadRequests;
 	public:
 		PageStrategy(const String& name, PageManager* manager)
 			: mName(name), mManager(manager)
@@ -248,6 +248,18 @@ namespace Ogre
 		*/
 		virtual Page* getPage(PageID pageID);
 
+		/// Get the pages which currently exist in this section, whether loaded or loading
+		const PageMap& getPages() const { return mPages; }
+
+		/** Get an estimate of the memory this section uses for a page outside of 
+			the page's content, in bytes.
+		@remarks
+			Sections which load their own data alongside the pages, rather than as 
+			PageContent, override this so that it counts towards the memory budget
+			of the PageManager. Added to the content's usage by Page::getMemoryUsage.
+		*/
+		virtual size_t getPageMemoryUsage(PageID pageID) const { return 0; }
+
 		/** Remove all pages immediately. 
 		@remarks
 			Effectively 'resets' this section by deleting all pages. 
@@ -98,6 +98,7 @@ namespace Ogre
 		void load();
 		void unload();
 		void unprepare();
+		size_t getMemoryUsage() const;
 
 	protected:
 
@@ -55,6 +55,7 @@ namespace Ogre
 		, mMinCellY(-32768)
 		, mMaxCellX(32767)
 		, mMaxCellY(32767)
+		, mPredictionTime(0)
 	{
 		updateDerivedMetrics();
 		
@@ -329,6 +330,7 @@ namespace Ogre
 		int32 loadymin = fymin < ymin ? ymin : (int32)floor(fymin);
 		int32 loadymax = fymax > ymax ? ymax : (int32)ceil(fymax);
 
+		mLoadRequests.clear();
 		for (int32 cy = ymin; cy <= ymax; ++cy)
 		{
 			for (int32 cx = xmin; cx <= xmax; ++cx)
@@ -336,8 +338,10 @@ namespace Ogre
 				PageID pageID = stratData->calculatePageID(cx, cy);
 				if (cx >= loadxmin && cx <= loadxmax && cy >= loadymin && cy <= loadymax)
 				{
-					// in the 'load' range, request it
-					section->loadPage(pageID);
+					// in the 'load' range, request it (nearest first)
+					Vector2 mid;
+					stratData->getMidPointGridSpace(cx, cy, mid);
+					mLoadRequests.push_back(PageLoadRequest(pageID, 0, mid.squaredDistance(gridpos)));
 				}
 				else
 				{
@@ -347,8 +351,53 @@ namespace Ogre
 				// other pages will by inference be marked for unloading
 			}
 		}	
-		
 
+		Real predictionTime = stratData->getPredictionTime();
+		if (predictionTime > 0)
+		{
+			// velocity is a direction, so the origin of the grid doesn't matter
+			Vector2 gridVelocity(Vector2::ZERO);
+			stratData->convertWorldToGridSpace(mManager->getCameraVelocity(cam), gridVelocity);
+			Real speed = gridVelocity.length();
+			if (speed > 0)
+			{
+				// step roughly a cell at a time along the predicted path
+				const Real maxSteps = 16;
+				Real step = std::max(stratData->getCellSize() / speed, predictionTime / maxSteps);
+				size_t numSteps = (size_t)Math::Ceil(predictionTime / step);
+				for (size_t i = 1; i <= numSteps; ++i)
+				{
+					Real t = std::min(step * i, predictionTime);
+					Vector2 predictedPos = gridpos + gridVelocity * t;
+					int32 px, py;
+					stratData->determineGridLocation(predictedPos, &px, &py);
+					int32 pxmin = std::max(stratData->getCellRangeMinX(), (int32)floor((Real)px - loadRadius));
+					int32 pxmax = std::min(stratData->getCellRangeMaxX(), (int32)ceil((Real)px + loadRadius));
+					int32 pymin = std::max(stratData->getCellRangeMinY(), (int32)floor((Real)py - loadRadius));
+					int32 pymax = std::min(stratData->getCellRangeMaxY(), (int32)ceil((Real)py + loadRadius));
+					for (int32 cy = pymin; cy <= pymax; ++cy)
+					{
+						for (int32 cx = pxmin; cx <= pxmax; ++cx)
+						{
+							// already requested as part of the current load range?
+							if (cx >= loadxmin && cx <= loadxmax && cy >= loadymin && cy <= loadymax)
+								continue;
+							Vector2 mid;
+							stratData->getMidPointGridSpace(cx, cy, mid);
+							mLoadRequests.push_back(PageLoadRequest(stratData->calculatePageID(cx, cy), 
+								t, mid.squaredDistance(predictedPos)));
+						}
+					}
+				}
+			}
+		}
+
+		// Most urgent first, so that these are at the front of the work queue
+		// Pages requested more than once are only loaded the first time, later
+		// requests just keep them held
+		std::sort(mLoadRequests.begin(), mLoadRequests.end());
+		for (PageLoadRequestList::iterator i = mLoadRequests.begin(); i != mLoadRequests.end(); ++i)
+			section->loadPage(i->pageID);
 
 	}
 	//---------------------------------------------------------------------
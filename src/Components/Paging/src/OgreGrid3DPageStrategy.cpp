@@ -57,6 +57,7 @@ namespace Ogre
 		, mMaxCellX(511)
 		, mMaxCellY(511)
 		, mMaxCellZ(511)
+		, mPredictionTime(0)
 	{
 	}
 	//---------------------------------------------------------------------
@@ -288,6 +289,7 @@ namespace Ogre
 		int32 loadzmin = fzmin < zmin ? zmin : (int32)floor(fzmin);
 		int32 loadzmax = fzmax > zmax ? zmax : (int32)ceil(fzmax);
 
+		mLoadRequests.clear();
 		for (int32 cz = zmin; cz <= zmax; ++cz)
 		{
 		    for (int32 cy = ymin; cy <= ymax; ++cy)
@@ -305,7 +307,8 @@ namespace Ogre
                         Ogre::AxisAlignedBox bbox(bl, bl+stratData->getCellSize());
 
                         if( cam->isVisible(bbox) )
-    					    section->loadPage(pageID);
+    					    mLoadRequests.push_back(PageLoadRequest(pageID, 0, 
+								bbox.getCenter().squaredDistance(pos)));
                         else
 					        section->holdPage(pageID);
 				    }
@@ -318,6 +321,55 @@ namespace Ogre
 			    }
 		    }
         }
+
+		Real predictionTime = stratData->getPredictionTime();
+		const Vector3& velocity = mManager->getCameraVelocity(cam);
+		Real speed = velocity.length();
+		if (predictionTime > 0 && speed > 0)
+		{
+			// step roughly a cell at a time along the predicted path
+			const Vector3& cellSize = stratData->getCellSize();
+			const Real maxSteps = 16;
+			Real minCellSize = std::min(cellSize.x, std::min(cellSize.y, cellSize.z));
+			Real step = std::max(minCellSize / speed, predictionTime / maxSteps);
+			size_t numSteps = (size_t)Math::Ceil(predictionTime / step);
+			for (size_t i = 1; i <= numSteps; ++i)
+			{
+				Real t = std::min(step * i, predictionTime);
+				Vector3 predictedPos = pos + velocity * t;
+				int32 px, py, pz;
+				stratData->determineGridLocation(predictedPos, &px, &py, &pz);
+				int32 pxmin = std::max(stratData->getCellRangeMinX(), (int32)floor((Real)px - loadRadius/cellSize.x));
+				int32 pxmax = std::min(stratData->getCellRangeMaxX(), (int32)ceil((Real)px + loadRadius/cellSize.x));
+				int32 pymin = std::max(stratData->getCellRangeMinY(), (int32)floor((Real)py - loadRadius/cellSize.y));
+				int32 pymax = std::min(stratData->getCellRangeMaxY(), (int32)ceil((Real)py + loadRadius/cellSize.y));
+				int32 pzmin = std::max(stratData->getCellRangeMinZ(), (int32)floor((Real)pz - loadRadius/cellSize.z));
+				int32 pzmax = std::min(stratData->getCellRangeMaxZ(), (int32)ceil((Real)pz + loadRadius/cellSize.z));
+				for (int32 cz = pzmin; cz <= pzmax; ++cz)
+				{
+					for (int32 cy = pymin; cy <= pymax; ++cy)
+					{
+						for (int32 cx = pxmin; cx <= pxmax; ++cx)
+						{
+							// the current load range is governed by visibility
+							if (cx >= loadxmin && cx <= loadxmax 
+								&& cy >= loadymin && cy <= loadymax
+								&& cz >= loadzmin && cz <= loadzmax)
+								continue;
+							Vector3 mid;
+							stratData->getMidPointGridSpace(cx, cy, cz, mid);
+							mLoadRequests.push_back(PageLoadRequest(stratData->calculatePageID(cx, cy, cz), 
+								t, mid.squaredDistance(predictedPos)));
+						}
+					}
+				}
+			}
+		}
+
+		// Most urgent first, so that these are at the front of the work queue
+		std::sort(mLoadRequests.begin(), mLoadRequests.end());
+		for (PageLoadRequestList::iterator i = mLoadRequests.begin(); i != mLoadRequests.end(); ++i)
+			section->loadPage(i->pageID);
 	}
 	//---------------------------------------------------------------------
 	PageStrategyData* Grid3DPageStrategy::createData()
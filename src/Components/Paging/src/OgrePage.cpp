@@ -54,8 +54,11 @@ namespace Ogre
 	Page::Page(PageID pageID, PagedWorldSection* parent)
 		: mID(pageID)
 		, mParent(parent)
+		, mPendingRequestID(0)
 		, mDeferredProcessInProgress(false)
+		, mLoadSynchronous(false)
 		, mModified(false)
+		, mPinned(false)
 		, mDebugNode(0)
 	{
 		WorkQueue* wq = Root::getSingleton().getWorkQueue();
@@ -67,6 +70,8 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	Page::~Page()
 	{
+		abortLoad();
+
 		WorkQueue* wq = Root::getSingleton().getWorkQueue();
 		wq->removeRequestHandler(mWorkQueueChannel, this);
 		wq->removeResponseHandler(mWorkQueueChannel, this);
@@ -85,6 +90,16 @@ namespace Ogre
 		}
 	}
 	//---------------------------------------------------------------------
+	Page::PageData::~PageData()
+	{
+		// Anything not taken by the page (failed or aborted loads)
+		for (ContentCollectionList::iterator i = collectionsToAdd.begin(); 
+			i != collectionsToAdd.end(); ++i)
+		{
+			delete *i;
+		}
+	}
+	//---------------------------------------------------------------------
 	void Page::destroyAllContentCollections()
 	{
 		for (ContentCollectionList::iterator i = mContentCollections.begin(); 
@@ -186,12 +201,30 @@ namespace Ogre
 			destroyAllContentCollections();
 			PageRequest req(this);
 			mDeferredProcessInProgress = true;
-			Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, 
-				Any(req), 0, synchronous);
+			mLoadSynchronous = synchronous;
+			mPendingRequestID = Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, 
+				WORKQUEUE_PREPARE_REQUEST, Any(req), 0, synchronous);
+			mLoadSynchronous = false;
 		}
 
 	}
 	//---------------------------------------------------------------------
+	void Page::abortLoad()
+	{
+		if (mDeferredProcessInProgress)
+		{
+			if (mPreparedData.isNull())
+				Root::getSingleton().getWorkQueue()->abortRequest(mPendingRequestID);
+			else
+			{
+				// already prepared, just waiting for the main thread
+				getManager()->_cancelPageLoad(this);
+				mPreparedData.setNull();
+			}
+			mDeferredProcessInProgress = false;
+		}
+	}
+	//---------------------------------------------------------------------
 	void Page::unload()
 	{
 		destroyAllContentCollections();
@@ -217,7 +250,7 @@ namespace Ogre
 		if (preq.srcPage != this)
 			return false;
 		else
-			return true;
+			return ResponseHandler::canHandleResponse(res, srcQ);
 
 	}
 	//---------------------------------------------------------------------
@@ -231,11 +264,11 @@ namespace Ogre
 			return 0;
 
 		PageResponse res;
-		res.pageData = OGRE_NEW PageData();
+		res.pageData.bind(OGRE_NEW PageData());
 		WorkQueue::Response* response = 0;
 		try
 		{
-			prepareImpl(res.pageData);
+			prepareImpl(res.pageData.get());
 			response = OGRE_NEW WorkQueue::Response(req, true, Any(res));
 		}
 		catch (Exception& e)
@@ -261,14 +294,36 @@ namespace Ogre
 		// final loading behaviour
 		if (res->succeeded())
 		{
-			std::swap(mContentCollections, pres.pageData->collectionsToAdd);
-			loadImpl();
+			// the manager decides when there's time to do this
+			mPreparedData = pres.pageData;
+			getManager()->_queuePageLoad(this, mLoadSynchronous);
 		}
+		else
+			mDeferredProcessInProgress = false;
 
-		OGRE_DELETE pres.pageData;
+	}
+	//---------------------------------------------------------------------
+	void Page::_finaliseLoad()
+	{
+		if (mPreparedData.isNull())
+			return;
 
-		mDeferredProcessInProgress = false;
+		std::swap(mContentCollections, mPreparedData->collectionsToAdd);
+		mPreparedData.setNull();
+		loadImpl();
 
+		mDeferredProcessInProgress = false;
+	}
+	//---------------------------------------------------------------------
+	size_t Page::getMemoryUsage() const
+	{
+		size_t ret = mParent->getPageMemoryUsage(mID);
+		for (ContentCollectionList::const_iterator i = mContentCollections.begin();
+			i != mContentCollections.end(); ++i)
+		{
+			ret += (*i)->getMemoryUsage();
+		}
+		return ret;
 	}
 	//---------------------------------------------------------------------
 	bool Page::prepareImpl(PageData* dataToPopulate)
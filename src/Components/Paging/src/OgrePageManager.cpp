@@ -41,6 +41,8 @@ THE SOFTWARE.
 #include "OgreStreamSerialiser.h"
 #include "OgreRoot.h"
 #include "OgrePageContent.h"
+#include "OgrePage.h"
+#include "OgreTimer.h"
 
 namespace Ogre
 {
@@ -49,8 +51,19 @@ namespace Ogre
 		: mWorldNameGenerator("World")
 		, mPageProvider(0)
 		, mPageResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
+		, mCameraVelocitySmoothing(0.25f)
 		, mDebugDisplayLvl(0)
 		, mPagingEnabled(true)
+		, mPageMemoryBudget(0)
+		, mPageMemoryUsage(0)
+		, mPageLoadTimeLimit(0)
+		, mFrameLoadTime(0)
+		, mFramePagesLoaded(0)
+		, mPagesLoaded(0)
+		, mPagesEvicted(0)
+		, mStatisticsTime(0)
+		, mPagesLoadedPerSecond(0)
+		, mPagesEvictedPerSecond(0)
 		, mGrid2DPageStrategy(0)
 		, mGrid3DPageStrategy(0)
 		, mSimpleCollectionFactory(0)
@@ -70,6 +83,8 @@ namespace Ogre
 	PageManager::~PageManager()
 	{
 		Root::getSingleton().removeFrameListener(&mEventRouter);
+		while (!mCameraList.empty())
+			removeCamera(mCameraList.back());
 
 		OGRE_DELETE mGrid3DPageStrategy;
 		OGRE_DELETE mGrid2DPageStrategy;
@@ -478,6 +493,11 @@ namespace Ogre
 	{
 		if (std::find(mCameraList.begin(), mCameraList.end(), c) == mCameraList.end())
 		{
+			// listen once to each scene manager, to let go of its cameras 
+			// before it destroys them
+			SceneManager* sm = c->getSceneManager();
+			if (sm && !isTrackingSceneManager(sm))
+				sm->addListener(&mEventRouter);
 			mCameraList.push_back(c);
 			c->addListener(&mEventRouter);
 		}
@@ -490,9 +510,24 @@ namespace Ogre
 		{
 			c->removeListener(&mEventRouter);
 			mCameraList.erase(i);
+			mCameraMotion.erase(c);
+
+			SceneManager* sm = c->getSceneManager();
+			if (sm && !isTrackingSceneManager(sm))
+				sm->removeListener(&mEventRouter);
 		}
 	}
 	//---------------------------------------------------------------------
+	bool PageManager::isTrackingSceneManager(SceneManager* sm) const
+	{
+		for (CameraList::const_iterator c = mCameraList.begin(); c != mCameraList.end(); ++c)
+		{
+			if ((*c)->getSceneManager() == sm)
+				return true;
+		}
+		return false;
+	}
+	//---------------------------------------------------------------------
 	bool PageManager::hasCamera(Camera* c) const
 	{
 		return std::find(mCameraList.begin(), mCameraList.end(), c) != mCameraList.end();
@@ -503,6 +538,133 @@ namespace Ogre
 		return mCameraList;
 	}
 	//---------------------------------------------------------------------
+	const Vector3& PageManager::getCameraVelocity(Camera* c) const
+	{
+		CameraMotionMap::const_iterator i = mCameraMotion.find(c);
+		if (i != mCameraMotion.end())
+			return i->second.velocity;
+		else
+			return Vector3::ZERO;
+	}
+	//---------------------------------------------------------------------
+	void PageManager::_updateCameraMotion(Real timeSinceLastFrame)
+	{
+		for (CameraList::iterator c = mCameraList.begin(); c != mCameraList.end(); ++c)
+		{
+			CameraMotion& motion = mCameraMotion[*c];
+			const Vector3& pos = (*c)->getDerivedPosition();
+			if (motion.positionValid && timeSinceLastFrame > 0)
+			{
+				Vector3 frameVelocity = (pos - motion.lastPosition) / timeSinceLastFrame;
+				// exponential smoothing, independent of the frame rate
+				Real blend = 1;
+				if (mCameraVelocitySmoothing > timeSinceLastFrame)
+					blend = timeSinceLastFrame / mCameraVelocitySmoothing;
+				motion.velocity += (frameVelocity - motion.velocity) * blend;
+			}
+			motion.lastPosition = pos;
+			motion.positionValid = true;
+		}
+	}
+	//---------------------------------------------------------------------
+	bool PageManager::hasPageLoadTimeRemaining() const
+	{
+		// always allow one page per frame so that loading can't stall
+		return !mPageLoadTimeLimit || !mFramePagesLoaded || 
+			mFrameLoadTime < mPageLoadTimeLimit * 1000;
+	}
+	//---------------------------------------------------------------------
+	void PageManager::finalisePageLoad(Page* page)
+	{
+		Timer* timer = Root::getSingleton().getTimer();
+		unsigned long start = timer->getMicroseconds();
+
+		page->_finaliseLoad();
+
+		mFrameLoadTime += timer->getMicroseconds() - start;
+		++mFramePagesLoaded;
+		++mPagesLoaded;
+	}
+	//---------------------------------------------------------------------
+	void PageManager::_queuePageLoad(Page* page, bool synchronous)
+	{
+		// nothing jumps the queue unless it has to
+		if (synchronous || (mPageLoadQueue.empty() && hasPageLoadTimeRemaining()))
+			finalisePageLoad(page);
+		else
+			mPageLoadQueue.push_back(page);
+	}
+	//---------------------------------------------------------------------
+	void PageManager::_cancelPageLoad(Page* page)
+	{
+		PageQueue::iterator i = std::find(mPageLoadQueue.begin(), mPageLoadQueue.end(), page);
+		if (i != mPageLoadQueue.end())
+			mPageLoadQueue.erase(i);
+	}
+	//---------------------------------------------------------------------
+	void PageManager::_processPageLoadQueue()
+	{
+		mFrameLoadTime = 0;
+		mFramePagesLoaded = 0;
+		while (!mPageLoadQueue.empty() && hasPageLoadTimeRemaining())
+		{
+			Page* page = mPageLoadQueue.front();
+			mPageLoadQueue.pop_front();
+			finalisePageLoad(page);
+		}
+	}
+	//---------------------------------------------------------------------
+	void PageManager::_enforcePageMemoryBudget(Real timeSinceLastFrame)
+	{
+		if (mPageMemoryBudget && mPagingEnabled)
+		{
+			// Total up, and find the pages we're allowed to unload
+			typedef vector<std::pair<unsigned long, Page*> >::type PageAgeList;
+			PageAgeList candidates;
+			size_t usage = 0;
+			for (WorldMap::iterator w = mWorlds.begin(); w != mWorlds.end(); ++w)
+			{
+				const PagedWorld::SectionMap& sections = w->second->getSections();
+				for (PagedWorld::SectionMap::const_iterator s = sections.begin(); s != sections.end(); ++s)
+				{
+					const PagedWorldSection::PageMap& pages = s->second->getPages();
+					for (PagedWorldSection::PageMap::const_iterator p = pages.begin(); p != pages.end(); ++p)
+					{
+						Page* page = p->second;
+						usage += page->getMemoryUsage();
+						if (!page->isHeld() && !page->isPinned())
+							candidates.push_back(std::make_pair(page->getFrameLastHeld(), page));
+					}
+				}
+			}
+
+			if (usage > mPageMemoryBudget)
+			{
+				// least recently held first
+				std::sort(candidates.begin(), candidates.end());
+				for (PageAgeList::iterator i = candidates.begin(); 
+					i != candidates.end() && usage > mPageMemoryBudget; ++i)
+				{
+					Page* page = i->second;
+					usage -= page->getMemoryUsage();
+					page->getParentSection()->unloadPage(page);
+					++mPagesEvicted;
+				}
+			}
+			mPageMemoryUsage = usage;
+		}
+
+		mStatisticsTime += timeSinceLastFrame;
+		if (mStatisticsTime >= 1)
+		{
+			mPagesLoadedPerSecond = mPagesLoaded / mStatisticsTime;
+			mPagesEvictedPerSecond = mPagesEvicted / mStatisticsTime;
+			mPagesLoaded = 0;
+			mPagesEvicted = 0;
+			mStatisticsTime = 0;
+		}
+	}
+	//---------------------------------------------------------------------
 	//---------------------------------------------------------------------
 	void PageManager::EventRouter::cameraPreRenderScene(Camera* cam)
 	{
@@ -513,8 +675,21 @@ namespace Ogre
 		pManager->removeCamera(cam);
 	}
 	//---------------------------------------------------------------------
+	void PageManager::EventRouter::sceneManagerDestroyed(SceneManager* source)
+	{
+		// copy, removeCamera changes the list
+		CameraList cameras = *pCameraList;
+		for (CameraList::iterator c = cameras.begin(); c != cameras.end(); ++c)
+		{
+			if ((*c)->getSceneManager() == source)
+				pManager->removeCamera(*c);
+		}
+	}
+	//---------------------------------------------------------------------
 	bool PageManager::EventRouter::frameStarted(const FrameEvent& evt)
 	{
+		pManager->_updateCameraMotion(evt.timeSinceLastFrame);
+		pManager->_processPageLoadQueue();
 
 		for(WorldMap::iterator i = pWorldMap->begin(); i != pWorldMap->end(); ++i)
 		{
@@ -537,6 +712,8 @@ namespace Ogre
 		for(WorldMap::iterator i = pWorldMap->begin(); i != pWorldMap->end(); ++i)
 			i->second->frameEnd(evt.timeSinceLastFrame);
 
+		pManager->_enforcePageMemoryBudget(evt.timeSinceLastFrame);
+
 		return true;
 	}
 
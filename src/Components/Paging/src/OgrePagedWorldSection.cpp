@@ -333,14 +333,24 @@ namespace Ogre
 	{
 		mStrategy->frameEnd(timeElapsed, this);
 
+		// With a memory budget, pages which aren't used any more are cached 
+		// until the PageManager evicts them
+		PageManager* mgr = getManager();
+		bool cachePages = mgr->getPageMemoryBudget() != 0;
 		for (PageMap::iterator i = mPages.begin(); i != mPages.end(); )
 		{
 			// if this page wasn't used, unload
 			Page* p = i->second;
 			// pre-increment since unloading will remove it
 			++i;
-			if (!p->isHeld())
-				unloadPage(p);
+			if (!p->isHeld() && !p->isPinned() && !cachePages)
+			{
+				if (mgr->getPagingOperationsEnabled())
+				{
+					unloadPage(p);
+					mgr->_notifyPageEvicted();
+				}
+			}
 			else
 				p->frameEnd(timeElapsed);
 		}
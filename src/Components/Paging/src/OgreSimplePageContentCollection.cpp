@@ -123,6 +123,14 @@ namespace Ogre
 
 	}
 	//---------------------------------------------------------------------
+	size_t SimplePageContentCollection::getMemoryUsage() const
+	{
+		size_t ret = 0;
+		for (ContentList::const_iterator i = mContentList.begin(); i != mContentList.end(); ++i)
+			ret += (*i)->getMemoryUsage();
+		return ret;
+	}
+	//---------------------------------------------------------------------
 	void SimplePageContentCollection::unprepare()
 	{
 		for (ContentList::iterator i = mContentList.begin(); i != mContentList.end(); ++i)
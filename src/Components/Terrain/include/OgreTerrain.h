@@ -53,7 +53,7 @@ namespace Ogre
 		Terrain can be edited and stored.
 	The data format for this in a file is:<br/>
 	<b>TerrainData (Identifier 'TERR')</b>\n
-	[Version 1]
+	[Version 2]
 	<table>
 	<tr>
 		<td><b>Name</b></td>
@@ -90,10 +90,25 @@ namespace Ogre
 		<td>Vector3</td>
 		<td>The location of the centre of the terrain</td>
 	</tr>
+	<tr>
+		<td>Height data format</td>
+		<td>uint8</td>
+		<td>Version 2 only, which is written for progressive height levels (1); version 1 always has floating point heights</td>
+	</tr>
 	<tr>
 		<td>Height data</td>
 		<td>float[size*size]</td>
-		<td>List of floating point heights</td>
+		<td>List of floating point heights (floating point format only)</td>
+	</tr>
+	<tr>
+		<td>Height quantisation</td>
+		<td>float, float, uint16</td>
+		<td>Base height, height step and number of height levels (progressive format only)</td>
+	</tr>
+	<tr>
+		<td>Coarsest height level</td>
+		<td>TerrainHeightLevel</td>
+		<td>Heights at the lowest LOD (progressive format only, see below)</td>
 	</tr>
 	<tr>
 		<td>LayerDeclaration</td>
@@ -129,12 +144,46 @@ namespace Ogre
 	<tr>
 		<td>Delta data</td>
 		<td>float[size*size]</td>
-		<td>At each vertex, delta information for the LOD at which this vertex disappears</td>
+		<td>At each vertex, delta information for the LOD at which this vertex disappears
+			(floating point format only)</td>
 	</tr>
 	<tr>
 		<td>Quadtree delta data</td>
 		<td>float[quadtrees*lods]</td>
-		<td>At each quadtree node, for each lod a record of the max delta value in the region</td>
+		<td>At each quadtree node, for each lod a record of the max delta value in the region
+			(floating point format only)</td>
+	</tr>
+	<tr>
+		<td>Finer height levels</td>
+		<td>TerrainHeightLevel list</td>
+		<td>The remaining height levels, coarse to fine (progressive format only)</td>
+	</tr>
+	</table>
+	<b>TerrainHeightLevel (Identifier 'THLV')</b>\n
+	[Version 1]
+	<table>
+	<tr>
+		<td><b>Name</b></td>
+		<td><b>Type</b></td>
+		<td><b>Description</b></td>
+	</tr>
+	<tr>
+		<td>Level</td>
+		<td>uint16</td>
+		<td>Index of the level; level 0 holds every vertex of the lowest LOD, level n 
+			the vertices first used at LOD (levels - 1 - n)</td>
+	</tr>
+	<tr>
+		<td>Byte count</td>
+		<td>uint32</td>
+		<td>Size of the encoded heights</td>
+	</tr>
+	<tr>
+		<td>Encoded heights</td>
+		<td>uint8[byte count]</td>
+		<td>Quantised heights in row order, as zigzag varints of the difference from 
+			the previous height in level 0, or from the height predicted from the 
+			coarser levels otherwise</td>
 	</tr>
 	</table>
 	<b>TerrainLayerDeclaration (Identifier 'TDCL')</b>\n
@@ -282,6 +331,8 @@ namespace Ogre
 		static const uint16 TERRAINLAYERINSTANCE_CHUNK_VERSION;
 		static const uint32 TERRAINDERIVEDDATA_CHUNK_ID;
 		static const uint16 TERRAINDERIVEDDATA_CHUNK_VERSION;
+		static const uint32 TERRAINHEIGHTLEVEL_CHUNK_ID;
+		static const uint16 TERRAINHEIGHTLEVEL_CHUNK_VERSION;
 
 		static const size_t LOD_MORPH_CUSTOM_PARAM;
 
@@ -690,12 +741,17 @@ namespace Ogre
 		This is safe to do in a background thread as it creates no GPU resources.
 		It reads data from a native terrain data chunk. For more advanced uses, 
 		such as loading from a shared file, use the StreamSerialiser form.
+		@par
+		If the file holds progressive height data, only the number of height levels
+		given by TerrainGlobalOptions::getNumHeightLevelsOnPrepare is read, and
+		the file is kept open to read the rest later (see loadPendingHeightLevels).
 		*/
 		bool prepare(const String& filename);
 		/** Prepare terrain data from saved data.
 		@remarks
 			This is safe to do in a background thread as it creates no GPU resources.
-			It reads data from a native terrain data chunk. 
+			It reads data from a native terrain data chunk. All height levels
+			are read, since the stream is owned by the caller.
 		@return true if the preparation was successful
 		*/
 		bool prepare(StreamSerialiser& stream);
@@ -723,10 +779,29 @@ namespace Ogre
 
 		/** Load the terrain based on the data already populated via prepare methods. 
 		@remarks
-			This method must be called in the main render thread. 
+			This method must be called in the main render thread. If height levels
+			are still pending, loading them in the background is started.
 		*/
 		void load();
 
+		/** Get the number of progressive height levels which haven't been read yet.
+		@remarks
+			Terrains saved with progressive height data and prepared from a file
+			may hold only the coarser levels of their heights; the finer heights
+			are predicted from these until their own levels are read.
+		*/
+		uint16 getPendingHeightLevelCount() const { return mPendingHeightLevels; }
+
+		/** Read the height levels which weren't read when this terrain was prepared.
+		@remarks
+			This method must be called in the main render thread. The levels are
+			read coarse to fine, and the geometry and LOD information is updated 
+			as each one arrives.
+		@param synchronous If true, all levels are read before returning; otherwise
+			they're read one at a time by the WorkQueue.
+		*/
+		void loadPendingHeightLevels(bool synchronous = false);
+
 		/** Return whether the terrain is loaded. 
 		@remarks
 			Should only be called from the render thread really, since this is
@@ -734,6 +809,14 @@ namespace Ogre
 		*/
 		bool isLoaded() const { return mIsLoaded; }
 
+		/** Get an estimate of the memory used by this terrain, in bytes.
+		@remarks
+			Counts the height and delta data, the CPU copies of the blend and
+			derived maps, the textures and the vertex buffers of the quadtree.
+			Index buffers are shared between terrains and are not counted.
+		*/
+		size_t getMemoryUsage() const;
+
 		/** Returns whether this terrain has been modified since it was first loaded / defined. 
 		@remarks
 			This flag is reset on save().
@@ -768,7 +851,8 @@ namespace Ogre
 		@par
 			This pointer is not const, so you can update the height data if you
 			wish. However, changes will not be propagated until you call 
-			Terrain::dirty or Terrain::dirtyRect.
+			Terrain::dirty or Terrain::dirtyRect. If height levels are pending,
+			these read them first and keep the edited area as it is.
 		*/
 		float* getHeightData() const;
 
@@ -795,6 +879,20 @@ namespace Ogre
 		*/
 		float getHeightAtTerrainPosition(Real x, Real y);
 
+		/** Get the height data for a batch of terrain positions.
+		@remarks
+			Gives the same heights as calling getHeightAtTerrainPosition for every
+			position, but the interpolation is vectorised through OptimisedUtil,
+			which makes this the faster option for large numbers of queries (e.g.
+			ground clamping). Positions are clamped to the edge of the terrain.
+		@param x, y Pointers to the positions in terrain space, values from 0 to 1 
+			left/right bottom/top
+		@param outHeights Pointer to the buffer which receives one height per position
+		@param count The number of positions
+		*/
+		void getHeightAtTerrainPositions(const float* x, const float* y, 
+			float* outHeights, size_t count) const;
+
 		/** Get the height data for a given world position (projecting the point
 			down on to the terrain). 
 		@param x, y,z Position in world space. Positions will be clamped to the edge
@@ -1284,7 +1382,10 @@ namespace Ogre
 			0 indicates no limit
 		 @return A pair which contains whether the ray hit the terrain and, if so, where.
 		 @remarks This can be called from any thread as long as no parallel write to
-		 the heightmap data occurs.
+		 the heightmap data occurs. The ray descends the quadtree, skipping any node
+		 whose height range it passes over or under, so only the quads close to
+		 the surface are tested; height changes are taken into account once
+		 update() has been called.
 		 */
 		std::pair<bool, Vector3> rayIntersects(const Ray& ray, 
 			bool cascadeToNeighbours = false, Real distanceLimit = 0); //const;
@@ -1516,6 +1617,7 @@ namespace Ogre
 		void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
 
 		static const uint16 WORKQUEUE_DERIVED_DATA_REQUEST;
+		static const uint16 WORKQUEUE_HEIGHT_LEVEL_REQUEST;
 
 
 		/// Utility method, get the first LOD Level at which this vertex is no longer included
@@ -1645,6 +1747,11 @@ namespace Ogre
 		void calculateCurrentLod(Viewport* vp);
 		/// Test a single quad of the terrain for ray intersection.
 		std::pair<bool, Vector3> checkQuadIntersection(int x, int y, const Ray& ray); //const;
+		/** Test a ray in local vertex space against the quads under a node,
+			nearest child first, between the distances the ray enters and leaves the node.
+		*/
+		std::pair<bool, Vector3> rayIntersectsNode(const TerrainQuadTreeNode* node, 
+			const Ray& localRay, Real nearDist, Real farDist);
 
         /// Delete blend maps for all layers >= lowIndex
         void deleteBlendMaps(uint8 lowIndex);
@@ -1665,6 +1772,29 @@ namespace Ogre
 
 		void updateDerivedDataImpl(const Rect& rect, const Rect& lightmapExtraRect, bool synchronous, uint8 typeMask);
 
+		/// Prepare from saved data, optionally leaving finer height levels in the stream
+		bool prepareImpl(StreamSerialiser& stream, bool deferHeightLevels);
+		/// Write the progressive height levels in [firstLevel, lastLevel) of quantised heights
+		void writeHeightLevels(StreamSerialiser& stream, const int32* quantised, 
+			uint16 firstLevel, uint16 lastLevel);
+		/// Read a progressive height level into quantised heights, returns false if it's not the expected one
+		bool readHeightLevel(StreamSerialiser& stream, uint16 level, int32* quantised);
+		/// Predict the quantised heights of all levels from firstLevel on from the coarser ones
+		void predictHeightLevels(int32* quantised, uint16 firstLevel);
+		/// Convert quantised heights to the height data
+		void dequantiseHeights(const int32* quantised);
+		/** Read a pending height level into the quantised heights (background).
+		@param level The level to read
+		@return true if no more levels can be read after this one
+		*/
+		bool readNextHeightLevel(uint16 level);
+		/// Apply a height level read by readNextHeightLevel to the heights and deltas (main thread)
+		void finaliseHeightLevel(bool lastLevel);
+		/// Start reading the next pending height level in the background
+		void requestNextHeightLevel();
+		/// Free the stream and data used to read pending height levels
+		void freeHeightLevelStream();
+
 		void getEdgeRect(NeighbourIndex index, long range, Rect* outRect);
 		// get the equivalent of the passed in edge rectangle in neighbour
 		void getNeighbourEdgeRect(NeighbourIndex index, const Rect& inRect, Rect* outRect);
@@ -1748,6 +1878,71 @@ namespace Ogre
 			{ return o; }		
 		};
 
+		/// A data holder for communicating with the background height level read
+		struct HeightLevelRequest
+		{
+			Terrain* terrain;
+			// the level to read
+			uint16 level;
+			_OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const HeightLevelRequest& r)
+			{ return o; }		
+		};
+
+		/// A data holder for communicating with the background height level read
+		struct HeightLevelResponse
+		{
+			Terrain* terrain;
+			// whether there are no more levels to read
+			bool lastLevel;
+			_OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const HeightLevelResponse& r)
+			{ return o; }		
+		};
+
+		/// Stream the pending height levels are read from, owned by this terrain
+		StreamSerialiser* mHeightLevelSerialiser;
+		/// Quantised heights of the progressive format, kept while levels are pending
+		int32* mQuantisedHeightData;
+		float mQuantisedHeightBase;
+		float mQuantisedHeightStep;
+		uint16 mPendingHeightLevels;
+		/// Whether to carry on reading pending height levels in the background
+		bool mStreamHeightLevels;
+
+		/// Calculates ranges of the tiles of a normal map update
+		struct DerivedDataTileJob;
+		/** Calculate an area of the normal map tile by tile, spreading the tiles
+			over threads with WorkQueue::defaultParallelFor.
+		@param imageRect The area to calculate, in the space of the normal map
+		@param pData Storage for imageRect, written inverted in Y
+		*/
+		void calculateNormalsTiles(const Rect& imageRect, uint8* pData);
+		/// Calculate the normals of one tile of imageRect
+		void calculateNormalsTile(const Rect& tile, const Rect& imageRect, uint8* pData);
+		/** Calculate an area of the lightmap by sweeping a horizon across the 
+			terrain, away from the light.
+		@param imageRect The area to calculate, in the space of the lightmap
+		@param pData Storage for imageRect, written inverted in Y
+		*/
+		void calculateLightmapSweep(const Rect& imageRect, uint8* pData);
+		/** Get the horizon of a lightmap texel outside this terrain, from the 
+			neighbours towards the light.
+		@param x, y The texel, in the space of this terrain's lightmap
+		@param stepX, stepY One texel step towards the light
+		@param drop How much the light ray rises over one step
+		@param maxHeight Upper bound of the heights of the neighbours
+		@return The highest of the height and horizon of the texel, or a very low 
+			value if there's no neighbour there
+		*/
+		float getLightmapHorizonFromNeighbours(Real x, Real y, Real stepX, Real stepY, 
+			Real drop, Real maxHeight);
+		/** Get the height at a terrain position, which may be outside this terrain
+			in which case the neighbour is used. 
+		@return false if the position is not covered by this terrain or a neighbour
+		*/
+		bool getHeightAtTerrainPositionFromSelfOrNeighbour(Real x, Real y, float* outHeight);
+		/// Get the height at a point, which may be outside this terrain (clamped if there's no neighbour)
+		float getHeightFromSelfOrNeighbour(long x, long y);
+
 		String mMaterialName;
 		mutable MaterialPtr mMaterial;
 		mutable TerrainMaterialGeneratorPtr mMaterialGenerator;
@@ -1849,6 +2044,11 @@ namespace Ogre
 		Real mCompositeMapDistance;
 		String mResourceGroup;
 		bool mUseVertexCompressionWhenAvailable;
+		uint16 mDerivedDataTileSize;
+		bool mSaveProgressiveHeightData;
+		Real mHeightDataPrecision;
+		uint16 mNumHeightLevelsOnPrepare;
+		bool mSaveChunkedCompression;
 
 	public:
 		TerrainGlobalOptions();
@@ -2029,6 +2229,72 @@ namespace Ogre
 		 */
 		void setUseVertexCompressionWhenAvailable(bool enable) { mUseVertexCompressionWhenAvailable = enable; }
 
+		/** Get the size of the square tiles that normal map updates are split into.
+		*/
+		uint16 getDerivedDataTileSize() const { return mDerivedDataTileSize; }
+
+		/** Set the size of the square tiles that normal map updates are split into.
+		@remarks
+			Tiles are the unit of work handed out to the threads of a parallelFor. Smaller
+			tiles balance the load better, larger tiles have less overhead. The 
+			default is 64.
+		*/
+		void setDerivedDataTileSize(uint16 sz) { mDerivedDataTileSize = std::max<uint16>(sz, 1); }
+
+		/** Get whether terrains save their heights in the progressive format.
+		*/
+		bool getSaveProgressiveHeightData() const { return mSaveProgressiveHeightData; }
+
+		/** Set whether terrains save their heights in the progressive format.
+		@remarks
+			Progressive height data is quantised to getHeightDataPrecision and 
+			stored in levels from the lowest LOD up, each predicted from the one
+			before, which makes files much smaller and lets a terrain be rendered
+			after reading only its coarsest levels. The LOD delta data is not saved 
+			but recalculated on prepare. The default is false, which saves the 
+			exact floating point heights.
+		*/
+		void setSaveProgressiveHeightData(bool save) { mSaveProgressiveHeightData = save; }
+
+		/** Get the height step that progressive height data is quantised to.
+		*/
+		Real getHeightDataPrecision() const { return mHeightDataPrecision; }
+
+		/** Set the height step that progressive height data is quantised to.
+		@remarks
+			Saved heights are within half of this of the original ones. The step
+			is increased if needed to keep the quantised heights within 28 bits.
+			The default is 0.01.
+		*/
+		void setHeightDataPrecision(Real precision) { mHeightDataPrecision = precision; }
+
+		/** Get whether terrain files are saved in indexed, separately compressed chunks.
+		*/
+		bool getSaveChunkedCompression() const { return mSaveChunkedCompression; }
+
+		/** Set whether terrain files are saved in indexed, separately compressed chunks.
+		@remarks
+			Chunked files are compressed in parallel, and data late in the file,
+			such as the finer progressive height levels, can be read without 
+			inflating everything before it. Builds from before DeflateStream 
+			supported chunks can't read them, so the default is false, which 
+			saves a single deflate stream. Either kind is read.
+		*/
+		void setSaveChunkedCompression(bool chunked) { mSaveChunkedCompression = chunked; }
+
+		/** Get the number of progressive height levels read when a terrain is prepared.
+		*/
+		uint16 getNumHeightLevelsOnPrepare() const { return mNumHeightLevelsOnPrepare; }
+
+		/** Set the number of progressive height levels read when a terrain is 
+			prepared from a file.
+		@remarks
+			The other levels are read in the background once the terrain is loaded,
+			see Terrain::loadPendingHeightLevels. The default is 0, which reads all
+			levels on prepare.
+		*/
+		void setNumHeightLevelsOnPrepare(uint16 num) { mNumHeightLevelsOnPrepare = num; }
+
 		/** Override standard Singleton retrieval.
 		@remarks
 		Why do we do this? Well, it's because the Singleton
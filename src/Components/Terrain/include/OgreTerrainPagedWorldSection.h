@@ -142,6 +142,8 @@ namespace Ogre
 		void loadPage(PageID pageID, bool forceSynchronous = false);
 		/// Overridden from PagedWorldSection
 		void unloadPage(PageID pageID, bool forceSynchronous = false);
+		/// Overridden from PagedWorldSection, the memory used by the terrain of the page
+		size_t getPageMemoryUsage(PageID pageID) const;
 
 	protected:
 		TerrainGroup* mTerrainGroup;
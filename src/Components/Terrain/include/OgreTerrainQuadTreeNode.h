@@ -102,6 +102,8 @@ namespace Ogre
 		uint16 getXOffset() const { return mOffsetX; }
 		/// Get the vertical offset into the main terrain data of this node
 		uint16 getYOffset() const { return mOffsetY; }
+		/// Get the number of vertices along each side of this node at the highest LOD
+		uint16 getSize() const { return mSize; }
 		/// Is this a leaf node (no children)
 		bool isLeaf() const;
 		/// Get the base LOD level this node starts at (the highest LOD it handles)
@@ -125,6 +127,11 @@ namespace Ogre
 		void unload();
 		/// Unprepare node and children (perform CPU tasks, may be background thread)
 		void unprepare();
+		/** Get the size of the vertex buffers of this node and its children, in bytes.
+		@remarks
+			Both the CPU and the GPU copies are counted.
+		*/
+		size_t getMemoryUsage() const;
 		/// Save node to a stream
 		void save(StreamSerialiser& stream);
 
@@ -232,6 +239,20 @@ namespace Ogre
 		/// Get the maximum height of the node
 		Real getMaxHeight() const;
 
+		/** Recalculate the range of the height data covered by this node and
+			its children, for the region given.
+		@remarks
+			Unlike the bounds, which follow the vertex data, this range is taken
+			directly from the terrain's height data so it is exact at every level
+			of the tree, which is what hierarchical ray traversal relies on.
+		@param rect The region which changed, in top-level terrain coords
+		*/
+		void updateHeightDataRange(const Rect& rect);
+		/// Get the lowest height value covered by this node, in terrain space
+		float getHeightDataMin() const { return mHeightDataMin; }
+		/// Get the highest height value covered by this node, in terrain space
+		float getHeightDataMax() const { return mHeightDataMax; }
+
 		/** Calculate appropriate LOD for this node and children
 		@param cam The camera to be used (this should already be the LOD camera)
 		@param cFactor The cFactor which incorporates the viewport size, max pixel error and lod bias
@@ -275,6 +296,7 @@ namespace Ogre
 		Vector3 mLocalCentre; // relative to terrain centre
 		AxisAlignedBox mAABB; //relative to mLocalCentre
 		Real mBoundingRadius; //relative to mLocalCentre
+		float mHeightDataMin, mHeightDataMax; // exact range of the height data
 		int mCurrentLod; // -1 = none (do not render)
 		unsigned short mMaterialLodIndex;
 		float mLodTransition; // 0-1 transition to lower LOD
@@ -48,6 +48,7 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreDeflate.h"
+#include "OgreOptimisedUtil.h"
 
 
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
@@ -58,7 +59,7 @@ namespace Ogre
 {
 	//---------------------------------------------------------------------
 	const uint32 Terrain::TERRAIN_CHUNK_ID = StreamSerialiser::makeIdentifier("TERR");
-	const uint16 Terrain::TERRAIN_CHUNK_VERSION = 1;
+	const uint16 Terrain::TERRAIN_CHUNK_VERSION = 2;
 	const uint32 Terrain::TERRAINLAYERDECLARATION_CHUNK_ID = StreamSerialiser::makeIdentifier("TDCL");
 	const uint16 Terrain::TERRAINLAYERDECLARATION_CHUNK_VERSION = 1;
 	const uint32 Terrain::TERRAINLAYERSAMPLER_CHUNK_ID = StreamSerialiser::makeIdentifier("TSAM");
@@ -69,9 +70,12 @@ namespace Ogre
 	const uint16 Terrain::TERRAINLAYERINSTANCE_CHUNK_VERSION = 1;
 	const uint32 Terrain::TERRAINDERIVEDDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TDDA");
 	const uint16 Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION = 1;
+	const uint32 Terrain::TERRAINHEIGHTLEVEL_CHUNK_ID = StreamSerialiser::makeIdentifier("THLV");
+	const uint16 Terrain::TERRAINHEIGHTLEVEL_CHUNK_VERSION = 1;
 	// since 129^2 is the greatest power we can address in 16-bit index
 	const uint16 Terrain::TERRAIN_MAX_BATCH_SIZE = 129; 
 	const uint16 Terrain::WORKQUEUE_DERIVED_DATA_REQUEST = 1;
+	const uint16 Terrain::WORKQUEUE_HEIGHT_LEVEL_REQUEST = 2;
 	const size_t Terrain::LOD_MORPH_CUSTOM_PARAM = 1001;
 	const uint8 Terrain::DERIVED_DATA_DELTAS = 1;
 	const uint8 Terrain::DERIVED_DATA_NORMALS = 2;
@@ -79,6 +83,66 @@ namespace Ogre
 	// This MUST match the bitwise OR of all the types above with no extra bits!
 	const uint8 Terrain::DERIVED_DATA_ALL = 7;
 	//-----------------------------------------------------------------------
+	namespace
+	{
+		/// Append a signed value to a buffer as a zigzag encoded varint
+		void writeVarint(vector<uint8>::type& buffer, int32 value)
+		{
+			uint32 zigzag = ((uint32)value << 1) ^ (uint32)(value >> 31);
+			while (zigzag >= 0x80)
+			{
+				buffer.push_back((uint8)(zigzag | 0x80));
+				zigzag >>= 7;
+			}
+			buffer.push_back((uint8)zigzag);
+		}
+
+		/// Read a zigzag encoded varint, returns false if the buffer ends first
+		bool readVarint(const uint8*& pos, const uint8* end, int32* value)
+		{
+			uint32 zigzag = 0;
+			for (int shift = 0; shift < 35; shift += 7)
+			{
+				if (pos == end)
+					return false;
+				uint8 b = *pos++;
+				zigzag |= (uint32)(b & 0x7f) << shift;
+				if (!(b & 0x80))
+				{
+					*value = (int32)(zigzag >> 1) ^ -(int32)(zigzag & 1);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/** Predict a quantised height of a progressive height level from the 
+			coarser levels, which are at twice the step.
+		*/
+		int32 predictHeight(const int32* quantised, long size, long x, long y, long step)
+		{
+			bool oddX = ((x / step) & 1) != 0;
+			bool oddY = ((y / step) & 1) != 0;
+			if (oddX && oddY)
+			{
+				// centre of a coarser quad
+				const int32* below = quantised + (y - step) * size + x;
+				const int32* above = quantised + (y + step) * size + x;
+				return (int32)(((int64)below[-step] + below[step] + above[-step] + above[step]) / 4);
+			}
+			else if (oddX)
+			{
+				const int32* p = quantised + y * size + x;
+				return (int32)(((int64)p[-step] + p[step]) / 2);
+			}
+			else
+			{
+				const int32* p = quantised + y * size + x;
+				return (int32)(((int64)p[-step * size] + p[step * size]) / 2);
+			}
+		}
+	}
+	//-----------------------------------------------------------------------
 	template<> TerrainGlobalOptions* Singleton<TerrainGlobalOptions>::msSingleton = 0;
 	TerrainGlobalOptions* TerrainGlobalOptions::getSingletonPtr(void)
 	{
@@ -108,6 +172,11 @@ namespace Ogre
 		, mCompositeMapDistance(4000)
 		, mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
 		, mUseVertexCompressionWhenAvailable(true)
+		, mDerivedDataTileSize(64)
+		, mSaveProgressiveHeightData(false)
+		, mHeightDataPrecision(0.01f)
+		, mNumHeightLevelsOnPrepare(0)
+		, mSaveChunkedCompression(false)
 	{
 	}
 	//---------------------------------------------------------------------
@@ -149,6 +218,12 @@ namespace Ogre
 		, mDirtyLightmapFromNeighboursRect(0, 0, 0, 0)
 		, mDerivedDataUpdateInProgress(false)
 		, mDerivedUpdatePendingMask(0)
+		, mHeightLevelSerialiser(0)
+		, mQuantisedHeightData(0)
+		, mQuantisedHeightBase(0)
+		, mQuantisedHeightStep(0)
+		, mPendingHeightLevels(0)
+		, mStreamHeightLevels(false)
 		, mMaterialGenerationCount(0)
 		, mMaterialDirty(false)
 		, mMaterialParamsDirty(false)
@@ -194,6 +269,7 @@ namespace Ogre
 	Terrain::~Terrain()
 	{
 		mDerivedUpdatePendingMask = 0;
+		mStreamHeightLevels = false;
 		waitForDerivedProcesses();
 		WorkQueue* wq = Root::getSingleton().getWorkQueue();
 		wq->removeRequestHandler(mWorkQueueChannel, this);
@@ -243,6 +319,56 @@ namespace Ogre
 			return mQuadTree->getMaxHeight();
 	}
 	//---------------------------------------------------------------------
+	size_t Terrain::getMemoryUsage() const
+	{
+		size_t numVertices = (size_t)mSize * mSize;
+		size_t ret = 0;
+		if (mHeightData)
+			ret += numVertices * sizeof(float);
+		if (mDeltaData)
+			ret += numVertices * sizeof(float);
+
+		// CPU data, kept until the textures are created or for editing
+		size_t blendMapTexels = (size_t)mLayerBlendMapSizeActual * mLayerBlendMapSizeActual;
+		// blend textures are always RGBA, see getBlendTextureFormat
+		ret += mCpuBlendMapStorage.size() * blendMapTexels * 4;
+		for (TerrainLayerBlendMapList::const_iterator i = mLayerBlendMapList.begin(); 
+			i != mLayerBlendMapList.end(); ++i)
+		{
+			if (*i)
+				ret += blendMapTexels * sizeof(float);
+		}
+		if (mCpuColourMapStorage)
+			ret += (size_t)mGlobalColourMapSize * mGlobalColourMapSize * 3;
+		if (mCpuLightmapStorage)
+			ret += (size_t)mLightmapSize * mLightmapSize;
+		if (mCpuCompositeMapStorage)
+			ret += (size_t)mCompositeMapSize * mCompositeMapSize * 4;
+		if (mCpuTerrainNormalMap)
+			ret += mCpuTerrainNormalMap->getConsecutiveSize();
+
+		// GPU data
+		for (TexturePtrList::const_iterator i = mBlendTextureList.begin(); 
+			i != mBlendTextureList.end(); ++i)
+		{
+			if (!i->isNull())
+				ret += (*i)->getSize();
+		}
+		if (!mTerrainNormalMap.isNull())
+			ret += mTerrainNormalMap->getSize();
+		if (!mColourMap.isNull())
+			ret += mColourMap->getSize();
+		if (!mLightmap.isNull())
+			ret += mLightmap->getSize();
+		if (!mCompositeMap.isNull())
+			ret += mCompositeMap->getSize();
+
+		if (mQuadTree)
+			ret += mQuadTree->getMemoryUsage();
+
+		return ret;
+	}
+	//---------------------------------------------------------------------
 	Real Terrain::getBoundingRadius() const
 	{
 		if (!mQuadTree)
@@ -253,9 +379,16 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	void Terrain::save(const String& filename)
 	{
+		// finish reading first, this may be the file we're about to overwrite
+		loadPendingHeightLevels(true);
+
 		DataStreamPtr stream = Root::getSingleton().createFileStream(filename, _getDerivedResourceGroup(), true);
-		// Compress
-		DataStreamPtr compressStream(OGRE_NEW DeflateStream(filename, stream));
+		// Compress, optionally in indexed chunks so that data later in the file
+		// can be sought to without inflating everything before it
+		DeflateStream* deflateStream = OGRE_NEW DeflateStream(filename, stream);
+		DataStreamPtr compressStream(deflateStream);
+		if (TerrainGlobalOptions::getSingleton().getSaveChunkedCompression())
+			deflateStream->setChunkSize(256 * 1024);
 		StreamSerialiser ser(compressStream);
 		save(ser);
 	}
@@ -264,6 +397,7 @@ namespace Ogre
 	{
 		// wait for any queued processes to finish
 		waitForDerivedProcesses();
+		loadPendingHeightLevels(true);
 
 		if (mHeightDataModified)
 		{
@@ -278,7 +412,10 @@ namespace Ogre
 			finaliseHeightDeltas(rect, false);
 		}
 
-		stream.writeChunkBegin(TERRAIN_CHUNK_ID, TERRAIN_CHUNK_VERSION);
+		// Only the progressive format needs version 2, keep everything else
+		// readable by builds which know version 1 only
+		bool progressive = TerrainGlobalOptions::getSingleton().getSaveProgressiveHeightData();
+		stream.writeChunkBegin(TERRAIN_CHUNK_ID, progressive ? TERRAIN_CHUNK_VERSION : 1);
 
 		uint8 align = (uint8)mAlign;
 		stream.write(&align);
@@ -288,7 +425,41 @@ namespace Ogre
 		stream.write(&mMaxBatchSize);
 		stream.write(&mMinBatchSize);
 		stream.write(&mPos);
-		stream.write(mHeightData, mSize * mSize);
+
+		int32* quantised = 0;
+		if (progressive)
+		{
+			uint8 heightFormat = 1;
+			stream.write(&heightFormat);
+
+			size_t numVertices = mSize * mSize;
+			float minHeight = mHeightData[0];
+			float maxHeight = mHeightData[0];
+			for (size_t i = 1; i < numVertices; ++i)
+			{
+				minHeight = std::min(minHeight, mHeightData[i]);
+				maxHeight = std::max(maxHeight, mHeightData[i]);
+			}
+			// keep the quantised heights well within range of the predictions
+			float step = std::max((float)TerrainGlobalOptions::getSingleton().getHeightDataPrecision(), 
+				(maxHeight - minHeight) / (1 << 28));
+			if (step <= 0)
+				step = 1;
+
+			quantised = OGRE_ALLOC_T(int32, numVertices, MEMCATEGORY_GENERAL);
+			for (size_t i = 0; i < numVertices; ++i)
+				quantised[i] = (int32)((mHeightData[i] - minHeight) / step + 0.5f);
+
+			stream.write(&minHeight);
+			stream.write(&step);
+			stream.write(&mNumLodLevels);
+			// just the coarsest level up front, so it can be read without the rest
+			writeHeightLevels(stream, quantised, 0, 1);
+		}
+		else
+		{
+			stream.write(mHeightData, mSize * mSize);
+		}
 
 		writeLayerDeclaration(mLayerDecl, stream);
 
@@ -314,6 +485,21 @@ namespace Ogre
 				stream.write(pData, dataSz);
 			}
 		}
+		else if (mBlendTextureList.empty())
+		{
+			// never loaded, so the blend maps are still black
+			stream.write(&mLayerBlendMapSize);
+			int numBlendTex = getBlendTextureCount(numLayers);
+			for (int i = 0; i < numBlendTex; ++i)
+			{
+				PixelFormat fmt = getBlendTextureFormat(i, numLayers);
+				size_t dataSz = PixelUtil::getNumElemBytes(fmt) * mLayerBlendMapSize * mLayerBlendMapSize;
+				uint8* tmpData = (uint8*)OGRE_MALLOC(dataSz, MEMCATEGORY_GENERAL);
+				memset(tmpData, 0, dataSz);
+				stream.write(tmpData, dataSz);
+				OGRE_FREE(tmpData, MEMCATEGORY_GENERAL);
+			}
+		}
 		else
 		{
 			if (mLayerBlendMapSize != mLayerBlendMapSizeActual)
@@ -349,6 +535,15 @@ namespace Ogre
 			// save from CPU data if it's there, it means GPU data was never created
 			stream.write((uint8*)mCpuTerrainNormalMap->data, mSize * mSize * 3);
 		}
+		else if (mTerrainNormalMap.isNull())
+		{
+			// never loaded nor calculated, so calculate it now
+			Rect normalRect;
+			PixelBox* normalsBox = calculateNormals(Rect(0, 0, mSize, mSize), normalRect);
+			stream.write((uint8*)normalsBox->data, mSize * mSize * 3);
+			OGRE_FREE(normalsBox->data, MEMCATEGORY_GENERAL);
+			OGRE_DELETE normalsBox;
+		}
 		else
 		{
 			uint8* tmpData = (uint8*)OGRE_MALLOC(mSize * mSize * 3, MEMCATEGORY_GENERAL);
@@ -431,10 +626,19 @@ namespace Ogre
 			stream.writeChunkEnd(TERRAINDERIVEDDATA_CHUNK_ID);
 		}
 
-		// write deltas
-		stream.write(mDeltaData, mSize * mSize);
-		// write the quadtree
-		mQuadTree->save(stream);
+		if (progressive)
+		{
+			// finer heights last, deltas are recalculated from them on prepare
+			writeHeightLevels(stream, quantised, 1, mNumLodLevels);
+			OGRE_FREE(quantised, MEMCATEGORY_GENERAL);
+		}
+		else
+		{
+			// write deltas
+			stream.write(mDeltaData, mSize * mSize);
+			// write the quadtree
+			mQuadTree->save(stream);
+		}
 
 		stream.writeChunkEnd(TERRAIN_CHUNK_ID);
 
@@ -577,20 +781,40 @@ namespace Ogre
 		// stream direct if it's not actually compressed so this will still work
 		// with uncompressed streams
 		DataStreamPtr uncompressStream(OGRE_NEW DeflateStream(filename, stream));
-		StreamSerialiser ser(uncompressStream);
-		return prepare(ser);
+		StreamSerialiser* ser = OGRE_NEW StreamSerialiser(uncompressStream);
+		bool ret;
+		try
+		{
+			ret = prepareImpl(*ser, true);
+		}
+		catch (...)
+		{
+			OGRE_DELETE ser;
+			throw;
+		}
+		// kept if there are height levels left to read
+		if (mHeightLevelSerialiser != ser)
+			OGRE_DELETE ser;
+		return ret;
 
 	}
 	//---------------------------------------------------------------------
 	bool Terrain::prepare(StreamSerialiser& stream)
+	{
+		return prepareImpl(stream, false);
+	}
+	//---------------------------------------------------------------------
+	bool Terrain::prepareImpl(StreamSerialiser& stream, bool deferHeightLevels)
 	{
 		freeTemporaryResources();
 		freeCPUResources();
 
 		copyGlobalOptions();
 
-		if (!stream.readChunkBegin(TERRAIN_CHUNK_ID, TERRAIN_CHUNK_VERSION))
+		const StreamSerialiser::Chunk* chunk = stream.readChunkBegin(TERRAIN_CHUNK_ID, TERRAIN_CHUNK_VERSION);
+		if (!chunk)
 			return false;
+		uint16 version = chunk->version;
 
 		uint8 align;
 		stream.read(&align);
@@ -607,7 +831,30 @@ namespace Ogre
 
 		size_t numVertices = mSize * mSize;
 		mHeightData = OGRE_ALLOC_T(float, numVertices, MEMCATEGORY_GEOMETRY);
-		stream.read(mHeightData, numVertices);
+
+		uint8 heightFormat = 0;
+		if (version > 1)
+			stream.read(&heightFormat);
+		if (heightFormat == 0)
+		{
+			stream.read(mHeightData, numVertices);
+		}
+		else
+		{
+			uint16 numLevels;
+			stream.read(&mQuantisedHeightBase);
+			stream.read(&mQuantisedHeightStep);
+			stream.read(&numLevels);
+			if (numLevels != mNumLodLevels)
+			{
+				LogManager::getSingleton().stream(LML_CRITICAL) << "Error: terrain height data has "
+					<< numLevels << " levels, expected " << mNumLodLevels;
+				return false;
+			}
+			mQuantisedHeightData = OGRE_ALLOC_T(int32, numVertices, MEMCATEGORY_GEOMETRY);
+			if (!readHeightLevel(stream, 0, mQuantisedHeightData))
+				return false;
+		}
 
 
 		// Layer declaration
@@ -683,15 +930,54 @@ namespace Ogre
 
 		}
 
-		// Load delta data
 		mDeltaData = OGRE_ALLOC_T(float, numVertices, MEMCATEGORY_GEOMETRY);
-		stream.read(mDeltaData, numVertices);
+		if (heightFormat == 0)
+		{
+			// Load delta data
+			stream.read(mDeltaData, numVertices);
 
-		// Create & load quadtree
-		mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0, 0);
-		mQuadTree->prepare(stream);
+			// Create & load quadtree
+			mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0, 0);
+			mQuadTree->prepare(stream);
 
-		stream.readChunkEnd(TERRAIN_CHUNK_ID);
+			stream.readChunkEnd(TERRAIN_CHUNK_ID);
+		}
+		else
+		{
+			// Read the finer height levels, unless we're allowed to leave some for later
+			uint16 numLevelsToRead = mNumLodLevels;
+			uint16 numLevelsOnPrepare = TerrainGlobalOptions::getSingleton().getNumHeightLevelsOnPrepare();
+			if (deferHeightLevels && numLevelsOnPrepare)
+				numLevelsToRead = std::min(numLevelsToRead, numLevelsOnPrepare);
+			uint16 level = 1;
+			for (; level < numLevelsToRead; ++level)
+			{
+				if (!readHeightLevel(stream, level, mQuantisedHeightData))
+					return false;
+			}
+			mPendingHeightLevels = mNumLodLevels - level;
+			predictHeightLevels(mQuantisedHeightData, level);
+			dequantiseHeights(mQuantisedHeightData);
+
+			if (mPendingHeightLevels)
+			{
+				// leave the terrain chunk open for the remaining levels
+				mHeightLevelSerialiser = &stream;
+			}
+			else
+			{
+				OGRE_FREE(mQuantisedHeightData, MEMCATEGORY_GEOMETRY);
+				mQuantisedHeightData = 0;
+				stream.readChunkEnd(TERRAIN_CHUNK_ID);
+			}
+
+			mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0, 0);
+			mQuadTree->prepare();
+
+			Rect rect(0, 0, mSize, mSize);
+			calculateHeightDeltas(rect);
+			finaliseHeightDeltas(rect, true);
+		}
 
 		distributeVertexData();
 
@@ -701,6 +987,140 @@ namespace Ogre
 		return true;
 	}
 	//---------------------------------------------------------------------
+	void Terrain::writeHeightLevels(StreamSerialiser& stream, const int32* quantised, 
+		uint16 firstLevel, uint16 lastLevel)
+	{
+		long size = mSize;
+		vector<uint8>::type buffer;
+		for (uint16 level = firstLevel; level < lastLevel; ++level)
+		{
+			long step = 1L << (mNumLodLevels - 1 - level);
+			buffer.clear();
+			if (level == 0)
+			{
+				// every vertex of the lowest LOD, as the change along each row
+				int32 rowStart = 0;
+				for (long y = 0; y < size; y += step)
+				{
+					int32 prev = rowStart;
+					for (long x = 0; x < size; x += step)
+					{
+						int32 q = quantised[y * size + x];
+						writeVarint(buffer, q - prev);
+						prev = q;
+						if (!x)
+							rowStart = q;
+					}
+				}
+			}
+			else
+			{
+				// the vertices added at this level, as the error of the prediction 
+				// from the coarser levels
+				for (long y = 0; y < size; y += step)
+				{
+					bool oddRow = ((y / step) & 1) != 0;
+					for (long x = oddRow ? 0 : step; x < size; x += oddRow ? step : step * 2)
+						writeVarint(buffer, quantised[y * size + x] - predictHeight(quantised, size, x, y, step));
+				}
+			}
+
+			stream.writeChunkBegin(TERRAINHEIGHTLEVEL_CHUNK_ID, TERRAINHEIGHTLEVEL_CHUNK_VERSION);
+			stream.write(&level);
+			uint32 byteCount = (uint32)buffer.size();
+			stream.write(&byteCount);
+			stream.write(&buffer[0], byteCount);
+			stream.writeChunkEnd(TERRAINHEIGHTLEVEL_CHUNK_ID);
+		}
+	}
+	//---------------------------------------------------------------------
+	bool Terrain::readHeightLevel(StreamSerialiser& stream, uint16 level, int32* quantised)
+	{
+		if (!stream.readChunkBegin(TERRAINHEIGHTLEVEL_CHUNK_ID, TERRAINHEIGHTLEVEL_CHUNK_VERSION))
+			return false;
+
+		uint16 storedLevel;
+		uint32 byteCount;
+		stream.read(&storedLevel);
+		stream.read(&byteCount);
+		vector<uint8>::type buffer(byteCount);
+		if (storedLevel == level && byteCount)
+			stream.read(&buffer[0], byteCount);
+		stream.readChunkEnd(TERRAINHEIGHTLEVEL_CHUNK_ID);
+
+		if (storedLevel != level || buffer.empty())
+		{
+			LogManager::getSingleton().stream(LML_CRITICAL) << "Error: expected terrain height level "
+				<< level << " but found level " << storedLevel;
+			return false;
+		}
+
+		long size = mSize;
+		long step = 1L << (mNumLodLevels - 1 - level);
+		const uint8* pos = &buffer[0];
+		const uint8* end = pos + byteCount;
+		int32 residual;
+		bool valid = true;
+		if (level == 0)
+		{
+			int32 rowStart = 0;
+			for (long y = 0; y < size && valid; y += step)
+			{
+				int32 prev = rowStart;
+				for (long x = 0; x < size && valid; x += step)
+				{
+					valid = readVarint(pos, end, &residual);
+					int32 q = prev + residual;
+					quantised[y * size + x] = q;
+					prev = q;
+					if (!x)
+						rowStart = q;
+				}
+			}
+		}
+		else
+		{
+			for (long y = 0; y < size && valid; y += step)
+			{
+				bool oddRow = ((y / step) & 1) != 0;
+				for (long x = oddRow ? 0 : step; x < size && valid; x += oddRow ? step : step * 2)
+				{
+					valid = readVarint(pos, end, &residual);
+					quantised[y * size + x] = predictHeight(quantised, size, x, y, step) + residual;
+				}
+			}
+		}
+
+		if (!valid)
+		{
+			LogManager::getSingleton().stream(LML_CRITICAL) << "Error: terrain height level "
+				<< level << " is truncated";
+		}
+		return valid;
+	}
+	//---------------------------------------------------------------------
+	void Terrain::predictHeightLevels(int32* quantised, uint16 firstLevel)
+	{
+		long size = mSize;
+		for (uint16 level = std::max<uint16>(firstLevel, 1); level < mNumLodLevels; ++level)
+		{
+			long step = 1L << (mNumLodLevels - 1 - level);
+			for (long y = 0; y < size; y += step)
+			{
+				bool oddRow = ((y / step) & 1) != 0;
+				for (long x = oddRow ? 0 : step; x < size; x += oddRow ? step : step * 2)
+					quantised[y * size + x] = predictHeight(quantised, size, x, y, step);
+			}
+		}
+	}
+	//---------------------------------------------------------------------
+	void Terrain::dequantiseHeights(const int32* quantised)
+	{
+		size_t numVertices = mSize * mSize;
+		for (size_t i = 0; i < numVertices; ++i)
+			mHeightData[i] = mQuantisedHeightBase + quantised[i] * mQuantisedHeightStep;
+	}
+	//---------------------------------------------------------------------
 	bool Terrain::prepare(const ImportData& importData)
 	{
 		freeTemporaryResources();
@@ -1051,6 +1471,102 @@ namespace Ogre
 
 		mIsLoaded = true;
 
+		// the finer heights follow in the background
+		if (mPendingHeightLevels)
+			loadPendingHeightLevels();
+
+	}
+	//---------------------------------------------------------------------
+	void Terrain::loadPendingHeightLevels(bool synchronous)
+	{
+		if (!mPendingHeightLevels)
+			return;
+
+		if (synchronous)
+		{
+			// let a level being read in the background arrive first
+			mStreamHeightLevels = false;
+			waitForDerivedProcesses();
+			while (mPendingHeightLevels)
+			{
+				bool lastLevel = readNextHeightLevel(mNumLodLevels - mPendingHeightLevels);
+				finaliseHeightLevel(lastLevel);
+			}
+		}
+		else
+		{
+			mStreamHeightLevels = true;
+			// Only one background task per terrain at once; if a derived data
+			// update is running, the next level is requested when it's done
+			if (!mDerivedDataUpdateInProgress)
+				requestNextHeightLevel();
+		}
+	}
+	//---------------------------------------------------------------------
+	void Terrain::requestNextHeightLevel()
+	{
+		mDerivedDataUpdateInProgress = true;
+
+		HeightLevelRequest req;
+		req.terrain = this;
+		req.level = mNumLodLevels - mPendingHeightLevels;
+		Root::getSingleton().getWorkQueue()->addRequest(
+			mWorkQueueChannel, WORKQUEUE_HEIGHT_LEVEL_REQUEST, Any(req));
+	}
+	//---------------------------------------------------------------------
+	bool Terrain::readNextHeightLevel(uint16 level)
+	{
+		// Background thread (maybe)
+		// Only the quantised heights are touched here, mHeightData may be
+		// in use on the main thread until finaliseHeightLevel
+
+		bool lastLevel = level + 1 >= mNumLodLevels;
+		if (readHeightLevel(*mHeightLevelSerialiser, level, mQuantisedHeightData))
+		{
+			predictHeightLevels(mQuantisedHeightData, level + 1);
+			if (lastLevel)
+				mHeightLevelSerialiser->readChunkEnd(TERRAIN_CHUNK_ID);
+		}
+		else
+		{
+			// stay with the prediction, nothing more can be read
+			predictHeightLevels(mQuantisedHeightData, level);
+			lastLevel = true;
+		}
+		return lastLevel;
+	}
+	//---------------------------------------------------------------------
+	void Terrain::finaliseHeightLevel(bool lastLevel)
+	{
+		// Main thread
+
+		dequantiseHeights(mQuantisedHeightData);
+
+		Rect rect(0, 0, mSize, mSize);
+		Rect deltaRect = calculateHeightDeltas(rect);
+		mQuadTree->updateHeightDataRange(rect);
+		// keep the CPU vertex data current too, GPU data is recreated from it
+		mQuadTree->updateVertexData(true, false, rect, true);
+		finaliseHeightDeltas(deltaRect, true);
+		if (mIsLoaded)
+			mQuadTree->updateVertexData(true, true, rect, false);
+
+		if (lastLevel)
+			freeHeightLevelStream();
+		else
+			--mPendingHeightLevels;
+	}
+	//---------------------------------------------------------------------
+	void Terrain::freeHeightLevelStream()
+	{
+		OGRE_DELETE mHeightLevelSerialiser;
+		mHeightLevelSerialiser = 0;
+
+		OGRE_FREE(mQuantisedHeightData, MEMCATEGORY_GEOMETRY);
+		mQuantisedHeightData = 0;
+
+		mPendingHeightLevels = 0;
+		mStreamHeightLevels = false;
 	}
 	//---------------------------------------------------------------------
 	void Terrain::unload()
@@ -1106,6 +1622,9 @@ namespace Ogre
 		y = std::min(y, (long)mSize - 1L);
 		y = std::max(y, 0L);
 
+		// a pending level would overwrite the edit
+		loadPendingHeightLevels(true);
+
 		*getHeightData(x, y) = h;
 		Rect rect;
 		rect.left = x;
@@ -1181,6 +1700,13 @@ namespace Ogre
 				- plane.d) / plane.normal.z;
 
 
+	}
+	//---------------------------------------------------------------------
+	void Terrain::getHeightAtTerrainPositions(const float* x, const float* y, 
+		float* outHeights, size_t count) const
+	{
+		OptimisedUtil::getImplementation()->sampleHeightField(
+			mHeightData, mSize, x, y, outHeights, count);
 	}
 	//---------------------------------------------------------------------
 	float Terrain::getHeightAtWorldPosition(Real x, Real y, Real z)
@@ -1745,6 +2271,22 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	void Terrain::dirtyRect(const Rect& rect)
 	{
+		if (mPendingHeightLevels)
+		{
+			// Heights edited through getHeightData before the pending levels
+			// were read; read them now and put the edited area back on top
+			Rect clamped(std::max(0L, rect.left), std::max(0L, rect.top), 
+				std::min((long)mSize, rect.right), std::min((long)mSize, rect.bottom));
+			vector<float>::type edited;
+			for (long y = clamped.top; y < clamped.bottom; ++y)
+				edited.insert(edited.end(), getHeightData(clamped.left, y), 
+					getHeightData(clamped.left, y) + clamped.width());
+			loadPendingHeightLevels(true);
+			vector<float>::type::const_iterator src = edited.begin();
+			for (long y = clamped.top; y < clamped.bottom; ++y, src += clamped.width())
+				std::copy(src, src + clamped.width(), getHeightData(clamped.left, y));
+		}
+
 		mDirtyGeometryRect.merge(rect);
 		mDirtyGeometryRectForNeighbours.merge(rect);
 		mDirtyDerivedDataRect.merge(rect);
@@ -1787,6 +2329,7 @@ namespace Ogre
 	{
 		if (!mDirtyGeometryRect.isNull())
 		{
+			mQuadTree->updateHeightDataRange(mDirtyGeometryRect);
 			mQuadTree->updateVertexData(true, false, mDirtyGeometryRect, false);
 			mDirtyGeometryRect.setNull();
 		}
@@ -1860,6 +2403,8 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	void Terrain::freeCPUResources()
 	{
+		freeHeightLevelStream();
+
 		OGRE_FREE(mHeightData, MEMCATEGORY_GEOMETRY);
 		mHeightData = 0;
 
@@ -2229,8 +2774,8 @@ namespace Ogre
 		Ray localRay (rayOrigin, rayDirection);
 
 		// test if the ray actually hits the terrain's bounds
-		Real maxHeight = getMaxHeight();
-		Real minHeight = getMinHeight();
+		Real maxHeight = mQuadTree->getHeightDataMax();
+		Real minHeight = mQuadTree->getHeightDataMin();
 
 		AxisAlignedBox aabb (Vector3(0, minHeight, 0), Vector3(mSize, maxHeight, mSize));
 		std::pair<bool, Real> aabbTest = localRay.intersects(aabb);
@@ -2244,47 +2789,9 @@ namespace Ogre
 			}
 			return Result(false, Vector3());
 		}
-		// get intersection point and move inside
-		Vector3 cur = localRay.getPoint(aabbTest.second);
 
-		// now check every quad the ray touches
-		int quadX = std::min(std::max(static_cast<int>(cur.x), 0), (int)mSize-2);
-		int quadZ = std::min(std::max(static_cast<int>(cur.z), 0), (int)mSize-2);
-		int flipX = (rayDirection.x < 0 ? 0 : 1);
-		int flipZ = (rayDirection.z < 0 ? 0 : 1);
-		int xDir = (rayDirection.x < 0 ? -1 : 1);
-		int zDir = (rayDirection.z < 0 ? -1 : 1);
-
-		Result result(true, Vector3::ZERO);
-		Real dummyHighValue = (Real)mSize * 10000.0f;
-
-
-		while (cur.y >= (minHeight - 1e-3) && cur.y <= (maxHeight + 1e-3))
-		{
-			if (quadX < 0 || quadX >= (int)mSize-1 || quadZ < 0 || quadZ >= (int)mSize-1)
-				break;
-
-			result = checkQuadIntersection(quadX, quadZ, localRay);
-			if (result.first)
-				break;
-
-			// determine next quad to test
-			Real xDist = Math::RealEqual(rayDirection.x, 0.0) ? dummyHighValue : 
-				(quadX - cur.x + flipX) / rayDirection.x;
-			Real zDist = Math::RealEqual(rayDirection.z, 0.0) ? dummyHighValue : 
-				(quadZ - cur.z + flipZ) / rayDirection.z;
-			if (xDist < zDist)
-			{
-				quadX += xDir;
-				cur += rayDirection * xDist;
-			}
-			else
-			{
-				quadZ += zDir;
-				cur += rayDirection * zDist;
-			}
-
-		}
+		// now descend the quadtree towards the quads close to the ray
+		Result result = rayIntersectsNode(mQuadTree, localRay, 0, Math::POS_INFINITY);
 
 		if (result.first)
 		{
@@ -2320,6 +2827,122 @@ namespace Ogre
 		return result;
 	}
 	//---------------------------------------------------------------------
+	std::pair<bool, Vector3> Terrain::rayIntersectsNode(const TerrainQuadTreeNode* node, 
+		const Ray& localRay, Real nearDist, Real farDist)
+	{
+		typedef std::pair<bool, Vector3> Result;
+		// allow for the same rounding the quad test does
+		const Real heightEpsilon = 1e-3f;
+		long left = node->getXOffset();
+		long top = node->getYOffset();
+		long last = node->getSize() - 1;
+
+		if (!node->isLeaf())
+		{
+			// children don't overlap, so the order in which the ray enters them
+			// is the order in which it can hit them
+			Real childNear[4], childFar[4];
+			unsigned short order[4];
+			unsigned short numChildren = 0;
+			for (unsigned short i = 0; i < 4; ++i)
+			{
+				const TerrainQuadTreeNode* child = node->getChild(i);
+				Real cx = child->getXOffset(), cz = child->getYOffset(), csize = child->getSize() - 1;
+				AxisAlignedBox box(
+					Vector3(cx, child->getHeightDataMin() - heightEpsilon, cz), 
+					Vector3(cx + csize, child->getHeightDataMax() + heightEpsilon, cz + csize));
+				Real d1, d2;
+				if (!Math::intersects(localRay, box, &d1, &d2) || d1 > farDist || d2 < nearDist)
+					continue;
+
+				unsigned short pos = numChildren++;
+				for (; pos > 0 && childNear[pos - 1] > d1; --pos)
+				{
+					childNear[pos] = childNear[pos - 1];
+					childFar[pos] = childFar[pos - 1];
+					order[pos] = order[pos - 1];
+				}
+				childNear[pos] = d1;
+				childFar[pos] = d2;
+				order[pos] = i;
+			}
+
+			for (unsigned short i = 0; i < numChildren; ++i)
+			{
+				Result result = rayIntersectsNode(node->getChild(order[i]), localRay, 
+					childNear[i], childFar[i]);
+				if (result.first)
+					return result;
+			}
+			return Result(false, Vector3());
+		}
+
+		if (!node->getParent())
+		{
+			// a leaf root still needs its extents
+			AxisAlignedBox box(
+				Vector3((Real)left, node->getHeightDataMin() - heightEpsilon, (Real)top), 
+				Vector3((Real)(left + last), node->getHeightDataMax() + heightEpsilon, (Real)(top + last)));
+			if (!Math::intersects(localRay, box, &nearDist, &farDist))
+				return Result(false, Vector3());
+		}
+
+		// walk the quads of the leaf along the ray
+		const Vector3& origin = localRay.getOrigin();
+		const Vector3& dir = localRay.getDirection();
+		Vector3 cur = localRay.getPoint(nearDist);
+		long quadX = std::min(std::max((long)Math::Floor(cur.x), left), left + last - 1);
+		long quadZ = std::min(std::max((long)Math::Floor(cur.z), top), top + last - 1);
+		long xDir = (dir.x < 0 ? -1 : 1);
+		long zDir = (dir.z < 0 ? -1 : 1);
+		Real nextX = Math::RealEqual(dir.x, 0.0) ? Math::POS_INFINITY :
+			(quadX + (xDir > 0 ? 1 : 0) - origin.x) / dir.x;
+		Real nextZ = Math::RealEqual(dir.z, 0.0) ? Math::POS_INFINITY :
+			(quadZ + (zDir > 0 ? 1 : 0) - origin.z) / dir.z;
+		Real stepX = Math::RealEqual(dir.x, 0.0) ? Math::POS_INFINITY : Math::Abs(1 / dir.x);
+		Real stepZ = Math::RealEqual(dir.z, 0.0) ? Math::POS_INFINITY : Math::Abs(1 / dir.z);
+		Real enterDist = nearDist;
+
+		while (true)
+		{
+			Real exitDist = std::min(std::min(nextX, nextZ), farDist);
+
+			// skip quads the ray passes entirely above or below
+			const float* pQuad = getHeightData(quadX, quadZ);
+			float quadMin = std::min(std::min(pQuad[0], pQuad[1]), std::min(pQuad[mSize], pQuad[mSize + 1]));
+			float quadMax = std::max(std::max(pQuad[0], pQuad[1]), std::max(pQuad[mSize], pQuad[mSize + 1]));
+			Real enterY = origin.y + dir.y * enterDist;
+			Real exitY = origin.y + dir.y * exitDist;
+			if (std::min(enterY, exitY) <= quadMax + heightEpsilon && 
+				std::max(enterY, exitY) >= quadMin - heightEpsilon)
+			{
+				Result result = checkQuadIntersection(quadX, quadZ, localRay);
+				if (result.first)
+					return result;
+			}
+
+			if (exitDist >= farDist)
+				break;
+			if (nextX < nextZ)
+			{
+				quadX += xDir;
+				if (quadX < left || quadX >= left + last)
+					break;
+				nextX += stepX;
+			}
+			else
+			{
+				quadZ += zDir;
+				if (quadZ < top || quadZ >= top + last)
+					break;
+				nextZ += stepZ;
+			}
+			enterDist = exitDist;
+		}
+
+		return Result(false, Vector3());
+	}
+	//---------------------------------------------------------------------
 	std::pair<bool, Vector3> Terrain::checkQuadIntersection(int x, int z, const Ray& ray)
 	{
 		// build the two planes belonging to the quad's triangles
@@ -2966,10 +3589,14 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	bool Terrain::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
 	{
-		DerivedDataRequest ddr = any_cast<DerivedDataRequest>(req->getData());
+		Terrain* terrain;
+		if (req->getType() == WORKQUEUE_HEIGHT_LEVEL_REQUEST)
+			terrain = any_cast<HeightLevelRequest>(req->getData()).terrain;
+		else
+			terrain = any_cast<DerivedDataRequest>(req->getData()).terrain;
 		// only deal with own requests
 		// we do this because if we delete a terrain we want any pending tasks to be discarded
-		if (ddr.terrain != this)
+		if (terrain != this)
 			return false;
 		else
 			return RequestHandler::canHandleRequest(req, srcQ);
@@ -2978,10 +3605,15 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	bool Terrain::canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
 	{
-		DerivedDataRequest ddreq = any_cast<DerivedDataRequest>(res->getRequest()->getData());
+		const WorkQueue::Request* req = res->getRequest();
+		Terrain* terrain;
+		if (req->getType() == WORKQUEUE_HEIGHT_LEVEL_REQUEST)
+			terrain = any_cast<HeightLevelRequest>(req->getData()).terrain;
+		else
+			terrain = any_cast<DerivedDataRequest>(req->getData()).terrain;
 		// only deal with own requests
 		// we do this because if we delete a terrain we want any pending tasks to be discarded
-		if (ddreq.terrain != this)
+		if (terrain != this)
 			return false;
 		else
 			return true;
@@ -2992,6 +3624,18 @@ namespace Ogre
 	{
 		// Background thread (maybe)
 
+		if (req->getType() == WORKQUEUE_HEIGHT_LEVEL_REQUEST)
+		{
+			HeightLevelRequest hlr = any_cast<HeightLevelRequest>(req->getData());
+			if (hlr.terrain != this)
+				return 0;
+
+			HeightLevelResponse hlres;
+			hlres.terrain = this;
+			hlres.lastLevel = readNextHeightLevel(hlr.level);
+			return OGRE_NEW WorkQueue::Response(req, true, Any(hlres));
+		}
+
 		DerivedDataRequest ddr = any_cast<DerivedDataRequest>(req->getData());
 		// only deal with own requests; we shouldn't ever get here though
 		if (ddr.terrain != this)
@@ -3029,6 +3673,37 @@ namespace Ogre
 	{
 		// Main thread
 
+		if (res->getRequest()->getType() == WORKQUEUE_HEIGHT_LEVEL_REQUEST)
+		{
+			HeightLevelRequest hlreq = any_cast<HeightLevelRequest>(res->getRequest()->getData());
+			if (hlreq.terrain != this)
+				return;
+
+			mDerivedDataUpdateInProgress = false;
+			if (res->succeeded())
+			{
+				HeightLevelResponse hlres = any_cast<HeightLevelResponse>(res->getData());
+				finaliseHeightLevel(hlres.lastLevel);
+			}
+			else
+			{
+				// keep what we have, the stream can't be relied on anymore
+				freeHeightLevelStream();
+			}
+
+			// derived data updates requested meanwhile go before the next level
+			if (mDerivedUpdatePendingMask)
+			{
+				updateDerivedDataImpl(mDirtyDerivedDataRect, mDirtyLightmapFromNeighboursRect, 
+					false, mDerivedUpdatePendingMask);
+				mDirtyDerivedDataRect.setNull();
+				mDirtyLightmapFromNeighboursRect.setNull();
+			}
+			else if (mStreamHeightLevels && mPendingHeightLevels)
+				requestNextHeightLevel();
+			return;
+		}
+
 		DerivedDataResponse ddres = any_cast<DerivedDataResponse>(res->getData());
 		DerivedDataRequest ddreq = any_cast<DerivedDataRequest>(res->getRequest()->getData());
 
@@ -3085,6 +3760,9 @@ namespace Ogre
 			// update the composite map if enabled
 			if (mCompositeMapRequired)
 				updateCompositeMap();
+
+			if (mStreamHeightLevels && mPendingHeightLevels)
+				requestNextHeightLevel();
 		}
 
 	}
@@ -3132,59 +3810,130 @@ namespace Ogre
 
 		PixelBox* pixbox = OGRE_NEW PixelBox(widenedRect.width(), widenedRect.height(), 1, PF_BYTE_RGB, pData);
 
-		// Evaluate normal like this
-		//  3---2---1
-		//  | \ | / |
-		//	4---P---0
-		//  | / | \ |
-		//	5---6---7
+		calculateNormalsTiles(widenedRect, pData);
 
-		Plane plane;
-		for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
+		finalRect = widenedRect;
+
+		return pixbox;
+	}
+	//---------------------------------------------------------------------
+	void Terrain::calculateNormalsTile(const Rect& tile, const Rect& imageRect, uint8* pData)
+	{
+		// Normals by central differences on the heights; rows y-1, y and y+1 are
+		// kept from x-1 to x+1 inclusive, so the tile edges see neighbouring points
+		long width = tile.width();
+		long rowSize = width + 2;
+		vector<float>::type buffer(rowSize * 3 + width * 3);
+		float* rows[3] = { &buffer[0], &buffer[rowSize], &buffer[rowSize * 2] };
+		float* normalX = &buffer[rowSize * 3];
+		float* normalY = normalX + width;
+		float* normalZ = normalY + width;
+
+		for (long x = tile.left - 1; x <= tile.right; ++x)
+		{
+			rows[0][x - tile.left + 1] = getHeightFromSelfOrNeighbour(x, tile.top - 1);
+			rows[1][x - tile.left + 1] = getHeightFromSelfOrNeighbour(x, tile.top);
+		}
+
+		OptimisedUtil* util = OptimisedUtil::getImplementation();
+		for (long y = tile.top; y < tile.bottom; ++y)
 		{
-			for (long x = widenedRect.left; x < widenedRect.right; ++x)
+			float* above = rows[2];
+			if (y + 1 < mSize && tile.left > 0 && tile.right < mSize)
+				memcpy(above, getHeightData(tile.left - 1, y + 1), sizeof(float) * rowSize);
+			else
 			{
-				Vector3 cumulativeNormal = Vector3::ZERO;
-
-				// Build points to sample
-				Vector3 centrePoint;
-				Vector3 adjacentPoints[8];
-				getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
-				getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
-				getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
-				getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
-				getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
-				getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
-				getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
-				getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
-				getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
-
-				for (int i = 0; i < 8; ++i)
-				{
-					plane.redefine(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
-					cumulativeNormal += plane.normal;
-				}
+				for (long x = tile.left - 1; x <= tile.right; ++x)
+					above[x - tile.left + 1] = getHeightFromSelfOrNeighbour(x, y + 1);
+			}
 
-				// normalise & store normal
-				cumulativeNormal.normalise();
+			util->calculateHeightFieldNormals(rows[0] + 1, rows[1] + 1, above + 1, 
+				mScale, normalX, normalY, normalZ, width);
 
-				// encode as RGB, object space
-				// invert the Y to deal with image space
-				long storeX = x - widenedRect.left;
-				long storeY = widenedRect.bottom - y - 1;
+			// encode as RGB, object space
+			// invert the Y to deal with image space
+			long storeY = imageRect.bottom - y - 1;
+			uint8* pStore = pData + ((storeY * imageRect.width()) + tile.left - imageRect.left) * 3;
+			for (long i = 0; i < width; ++i)
+			{
+				Vector3 normal;
+				convertTerrainToWorldAxes(mAlign, Vector3(normalX[i], normalY[i], normalZ[i]), &normal);
+				*pStore++ = static_cast<uint8>((normal.x + 1.0f) * 0.5f * 255.0f);
+				*pStore++ = static_cast<uint8>((normal.y + 1.0f) * 0.5f * 255.0f);
+				*pStore++ = static_cast<uint8>((normal.z + 1.0f) * 0.5f * 255.0f);
+			}
+
+			// the row above becomes the centre row and so on
+			std::swap(rows[0], rows[1]);
+			std::swap(rows[1], rows[2]);
+		}
+	}
+	//---------------------------------------------------------------------
+	float Terrain::getHeightFromSelfOrNeighbour(long x, long y)
+	{
+		if (x >= 0 && y >=0 && x < mSize && y < mSize)
+			return *getHeightData(x, y);
 
-				uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
-				*pStore++ = static_cast<uint8>((cumulativeNormal.x + 1.0f) * 0.5f * 255.0f);
-				*pStore++ = static_cast<uint8>((cumulativeNormal.y + 1.0f) * 0.5f * 255.0f);
-				*pStore++ = static_cast<uint8>((cumulativeNormal.z + 1.0f) * 0.5f * 255.0f);
+		long nx, ny;
+		NeighbourIndex ni = NEIGHBOUR_EAST;
+		getNeighbourPointOverflow(x, y, &ni, &nx, &ny);
+		Terrain* neighbour = getNeighbour(ni);
+		if (neighbour)
+		{
+			// adjust to make it relative to our position
+			Vector3 offset = convertWorldToTerrainAxes(neighbour->getPosition() - getPosition());
+			return neighbour->getHeightAtPoint(nx, ny) + offset.z;
+		}
+		else
+		{
+			// use our heights after all, clamped
+			return getHeightAtPoint(x, y);
+		}
+	}
+	//---------------------------------------------------------------------
+	struct Terrain::DerivedDataTileJob : public WorkQueue::ParallelTask
+	{
+		Terrain* terrain;
+		Rect imageRect;
+		uint8* data;
+		long tileSize;
+		size_t tilesAcross;
+		size_t numTiles;
 
+		void execute(size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				Rect tile;
+				tile.left = imageRect.left + (long)(i % tilesAcross) * tileSize;
+				tile.top = imageRect.top + (long)(i / tilesAcross) * tileSize;
+				tile.right = std::min(tile.left + tileSize, imageRect.right);
+				tile.bottom = std::min(tile.top + tileSize, imageRect.bottom);
 
+				terrain->calculateNormalsTile(tile, imageRect, data);
 			}
 		}
+	};
+	//---------------------------------------------------------------------
+	void Terrain::calculateNormalsTiles(const Rect& imageRect, uint8* pData)
+	{
+		if (imageRect.isNull())
+			return;
 
-		finalRect = widenedRect;
+		TerrainGlobalOptions& opts = TerrainGlobalOptions::getSingleton();
 
-		return pixbox;
+		DerivedDataTileJob job;
+		job.terrain = this;
+		job.imageRect = imageRect;
+		job.data = pData;
+		job.tileSize = opts.getDerivedDataTileSize();
+		job.tilesAcross = (size_t)((imageRect.width() + job.tileSize - 1) / job.tileSize);
+		job.numTiles = job.tilesAcross * 
+			(size_t)((imageRect.height() + job.tileSize - 1) / job.tileSize);
+
+		// Usually called from a request handler of the same queue, which
+		// parallelFor copes with by doing the tiles no worker is free for
+		WorkQueue::defaultParallelFor(job, job.numTiles);
 	}
 	//---------------------------------------------------------------------
 	void Terrain::finaliseNormals(const Ogre::Rect &rect, Ogre::PixelBox *normalsBox)
@@ -3315,47 +4064,217 @@ namespace Ogre
 
 		PixelBox* pixbox = OGRE_NEW PixelBox(widenedRect.width(), widenedRect.height(), 1, PF_L8, pData);
 
+		if (!widenedRect.isNull())
+			calculateLightmapSweep(widenedRect, pData);
+
+		return pixbox;
+
+
+	}
+	//---------------------------------------------------------------------
+	void Terrain::calculateLightmapSweep(const Rect& imageRect, uint8* pData)
+	{
+		// Rather than casting a ray from every texel, lines of texels are visited
+		// in order away from the light, each line passing on to the next the 
+		// highest of the terrain and the shadow above it (the horizon). Every
+		// texel interpolates its horizon from the previous line, one step closer
+		// to the light, and is in shadow when the horizon is above it.
+
+		const Vector3& lightVec = TerrainGlobalOptions::getSingleton().getLightMapDirection();
 		Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
+		long lightmapSize = mLightmapSizeActual;
 
-		for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
+		// direction to the light in terrain axes, z is up
+		Vector3 toLight = convertWorldToTerrainAxes(-lightVec);
+		Real horizontal = Math::Sqrt(toLight.x * toLight.x + toLight.y * toLight.y);
+		if (horizontal < 1e-06 || lightmapSize < 2)
 		{
-			for (long x = widenedRect.left; x < widenedRect.right; ++x)
-			{
-				float litVal = 1.0f;
+			// light straight above (or below), no texel can shade another
+			memset(pData, toLight.z > 0 ? 255 : 0, imageRect.width() * imageRect.height());
+			return;
+		}
 
-				// convert to terrain space (not points, allow this to go between points)
-				float Tx = (float)x / (float)(mLightmapSizeActual-1);
-				float Ty = (float)y / (float)(mLightmapSizeActual-1);
+		// Lines run along the minor axis of the light direction, so each step 
+		// towards the light moves one texel on the major axis and at most one
+		// on the minor axis
+		bool majorIsX = Math::Abs(toLight.x) >= Math::Abs(toLight.y);
+		Real lightMajor = majorIsX ? toLight.x : toLight.y;
+		Real lightMinor = majorIsX ? toLight.y : toLight.x;
+		long majorStep = lightMajor > 0 ? 1 : -1;
+		Real minorStep = lightMinor / Math::Abs(lightMajor);
+		Real stepX = majorIsX ? (Real)majorStep : minorStep;
+		Real stepY = majorIsX ? minorStep : (Real)majorStep;
+		Real stepDist = mWorldSize / (Real)(lightmapSize - 1) * Math::Sqrt(1 + minorStep * minorStep);
+		Real drop = stepDist * toLight.z / horizontal;
+
+		// Neighbours can cast shadows onto our edges
+		Real maxNeighbourHeight = getMaxHeight();
+		for (int n = 0; n < (int)NEIGHBOUR_COUNT; ++n)
+		{
+			Terrain* neighbour = getNeighbour((NeighbourIndex)n);
+			if (neighbour)
+			{
+				Vector3 offset = convertWorldToTerrainAxes(neighbour->getPosition() - getPosition());
+				maxNeighbourHeight = std::max(maxNeighbourHeight, neighbour->getMaxHeight() + offset.z);
+			}
+		}
 
-				// get world space point
-				// add a little height padding to stop shadowing self
-				Vector3 wpos = Vector3::ZERO;
-				getPosition(Tx, Ty, getHeightAtTerrainPosition(Tx, Ty) + heightPad, &wpos);
-				wpos += getPosition();
-				// build ray, cast backwards along light direction
-				Ray ray(wpos, -lightVec);
+		// We stop after the last line of imageRect, away from the light
+		long lastLine = majorIsX 
+			? (majorStep > 0 ? imageRect.left : imageRect.right - 1)
+			: (majorStep > 0 ? imageRect.top : imageRect.bottom - 1);
+		long imageFirstLine = majorIsX 
+			? (majorStep > 0 ? imageRect.right - 1 : imageRect.left)
+			: (majorStep > 0 ? imageRect.bottom - 1 : imageRect.top);
+		long imageMinorBegin = majorIsX ? imageRect.top : imageRect.left;
+		long imageMinorEnd = majorIsX ? imageRect.bottom : imageRect.right;
+
+		// Nothing shadows imageRect from further than the drop takes to go
+		// from the highest neighbour to our lowest point, so the sweep starts
+		// that many lines before imageRect (plus a couple for rounding) rather
+		// than at the edge nearest the light. Earlier lines would only add
+		// horizons below every texel, which the max in the sweep throws away.
+		long firstLine = majorStep > 0 ? lightmapSize - 1 : 0;
+		if (drop > 0)
+		{
+			long marginLines = (long)Math::Ceil((maxNeighbourHeight - getMinHeight()) / drop) + 2;
+			if (marginLines < lightmapSize)
+			{
+				firstLine = imageFirstLine + majorStep * marginLines;
+				firstLine = std::max(0L, std::min(lightmapSize - 1, firstLine));
+			}
+		}
+		bool firstLineAtEdge = firstLine == (majorStep > 0 ? lightmapSize - 1 : 0);
+
+		// Horizons of a line are interpolated between prev[i + offset] and 
+		// prev[i + offset + 1] of the line before, so lines are padded on both sides
+		long offset = (long)Math::Floor(minorStep);
+		Real weight = minorStep - (Real)offset;
+		const long pad = 2;
+		vector<float>::type buffer((lightmapSize + pad * 2) * 2 + lightmapSize);
+		float* prevHorizon = &buffer[pad];
+		float* horizon = &buffer[lightmapSize + pad * 3];
+		float* heights = &buffer[(lightmapSize + pad * 2) * 2];
+		vector<uint8>::type lit(lightmapSize);
+
+		// Likewise, going one line towards the light the texels imageRect
+		// depends on spread from [b, e] to [b + offset, e + offset + 1], so only
+		// that cone of the minor axis is swept. Texels at the sides of the cone 
+		// read unswept horizons and may be wrong, but only the outside of the
+		// cone ever depends on them.
+		long sweepLines = Math::Abs(firstLine - imageFirstLine);
+		long minorBegin = std::max(0L, imageMinorBegin + sweepLines * std::min(offset, 0L));
+		long minorEnd = std::min(lightmapSize, imageMinorEnd + sweepLines * std::max(offset + 1, 0L));
+		long minorCount = minorEnd - minorBegin;
+		// Low enough not to shadow anything, without overflowing when interpolated
+		const float noHorizon = -1e30f;
+
+		OptimisedUtil* util = OptimisedUtil::getImplementation();
+		Real texelToTerrain = 1.0f / (Real)(lightmapSize - 1);
+		// terrain positions of the texels along a line, and of the line itself
+		vector<float>::type minorPos(lightmapSize), linePos(lightmapSize);
+		for (long i = 0; i < lightmapSize; ++i)
+			minorPos[i] = (float)(i * texelToTerrain);
+		const float* sampleX = majorIsX ? &linePos[0] : &minorPos[0];
+		const float* sampleY = majorIsX ? &minorPos[0] : &linePos[0];
+		for (long line = firstLine; ; line -= majorStep)
+		{
+			// The previous line is outside the terrain for the first line if it
+			// is at the edge, and so is its padding for every line
+			Real prevLine = (Real)(line + majorStep);
+			for (long i = minorBegin + offset; i <= minorEnd + offset; ++i)
+			{
+				if (i < 0 || i >= lightmapSize || (line == firstLine && firstLineAtEdge))
+				{
+					prevHorizon[i] = getLightmapHorizonFromNeighbours(
+						majorIsX ? prevLine : (Real)i, majorIsX ? (Real)i : prevLine, 
+						stepX, stepY, drop, maxNeighbourHeight);
+				}
+				else if (line == firstLine || i < minorBegin || i >= minorEnd)
+				{
+					prevHorizon[i] = noHorizon;
+				}
+			}
 
-				// Cascade into neighbours when casting, but don't travel further
-				// than world size
-				std::pair<bool, Vector3> rayHit = rayIntersects(ray, true, mWorldSize);
+			std::fill(linePos.begin() + minorBegin, linePos.begin() + minorEnd, 
+				(float)(line * texelToTerrain));
+			getHeightAtTerrainPositions(sampleX + minorBegin, sampleY + minorBegin, 
+				heights + minorBegin, minorCount);
 
-				if (rayHit.first)
-					litVal = 0.0f;
+			util->sweepHeightFieldHorizon(prevHorizon + minorBegin + offset, weight, drop, 
+				heights + minorBegin, heightPad, horizon + minorBegin, &lit[minorBegin], minorCount);
 
+			bool lineInImage = majorIsX 
+				? (line >= imageRect.left && line < imageRect.right)
+				: (line >= imageRect.top && line < imageRect.bottom);
+			if (lineInImage)
+			{
 				// encode as L8
 				// invert the Y to deal with image space
-				long storeX = x - widenedRect.left;
-				long storeY = widenedRect.bottom - y - 1;
+				for (long i = imageMinorBegin; i < imageMinorEnd; ++i)
+				{
+					long storeX = (majorIsX ? line : i) - imageRect.left;
+					long storeY = imageRect.bottom - (majorIsX ? i : line) - 1;
+					pData[(storeY * imageRect.width()) + storeX] = lit[i];
+				}
+			}
+
+			if (line == lastLine)
+				break;
+			std::swap(prevHorizon, horizon);
+		}
+	}
+	//---------------------------------------------------------------------
+	float Terrain::getLightmapHorizonFromNeighbours(Real x, Real y, Real stepX, Real stepY, 
+		Real drop, Real maxHeight)
+	{
+		// Low enough not to shadow anything, without overflowing when interpolated
+		const float noHorizon = -1e30f;
+
+		// Walk towards the light, no further than the world size as the shadow
+		// rays of the lightmap always did
+		Real texelToTerrain = 1.0f / (Real)(mLightmapSizeActual - 1);
+		Real stepDist = mWorldSize * texelToTerrain * Math::Sqrt(stepX * stepX + stepY * stepY);
+		long maxSteps = (long)(mWorldSize / stepDist);
+		float ret = noHorizon;
+		for (long step = 0; step <= maxSteps; ++step)
+		{
+			float height;
+			if (!getHeightAtTerrainPositionFromSelfOrNeighbour(
+				(x + step * stepX) * texelToTerrain, (y + step * stepY) * texelToTerrain, &height))
+				break;
 
-				uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX);
-				*pStore = (unsigned char)(litVal * 255.0);
+			ret = std::max(ret, (float)(height - step * drop));
 
-			}
+			// nothing further along can rise above what we have
+			if (drop >= 0 && maxHeight - (step + 1) * drop <= ret)
+				break;
 		}
+		return ret;
+	}
+	//---------------------------------------------------------------------
+	bool Terrain::getHeightAtTerrainPositionFromSelfOrNeighbour(Real x, Real y, float* outHeight)
+	{
+		// the far edges still belong to us
+		long offsetX = x == 1.0f ? 0 : (long)Math::Floor(x);
+		long offsetY = y == 1.0f ? 0 : (long)Math::Floor(y);
 
-		return pixbox;
+		if (offsetX == 0 && offsetY == 0)
+		{
+			*outHeight = getHeightAtTerrainPosition(x, y);
+			return true;
+		}
+		if (offsetX < -1 || offsetX > 1 || offsetY < -1 || offsetY > 1)
+			return false;
 
+		Terrain* neighbour = getNeighbour(getNeighbourIndex(offsetX, offsetY));
+		if (!neighbour)
+			return false;
 
+		// adjust to make it relative to our position
+		Vector3 offset = convertWorldToTerrainAxes(neighbour->getPosition() - getPosition());
+		*outHeight = neighbour->getHeightAtTerrainPosition(x - offsetX, y - offsetY) + offset.z;
+		return true;
 	}
 	//---------------------------------------------------------------------
 	void Terrain::finaliseLightmap(const Rect& rect, PixelBox* lightmapBox)
@@ -4315,6 +5234,8 @@ namespace Ogre
 		if(mWorldSize != newWorldSize)
 		{
 			waitForDerivedProcesses();
+			// the whole terrain is dirtied below, which would keep the coarse heights
+			loadPendingHeightLevels(true);
 
 			mWorldSize = newWorldSize;
 
@@ -4340,6 +5261,8 @@ namespace Ogre
 		if(mSize != newSize)
 		{
 			waitForDerivedProcesses();
+			// resampled from the current heights, so they must be complete
+			loadPendingHeightLevels(true);
 
 			size_t numVertices = newSize * newSize;
 
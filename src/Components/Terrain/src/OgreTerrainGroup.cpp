@@ -376,137 +376,80 @@ namespace Ogre
 	//---------------------------------------------------------------------
 	TerrainGroup::RayResult TerrainGroup::rayIntersects(const Ray& ray, Real distanceLimit /* = 0*/) const 
 	{
-		long curr_x, curr_z;
-		convertWorldPositionToTerrainSlot(ray.getOrigin(), &curr_x, &curr_z);
-		TerrainSlot* slot = getTerrainSlot(curr_x, curr_z);
 		RayResult result(false, 0, Vector3::ZERO);
 
-		Vector3 tmp, localRayDir, centreOrigin, offset;
-		// get the middle of the current tile
-		convertTerrainSlotToWorldPosition(curr_x, curr_z, &centreOrigin);
-		offset = ray.getOrigin() - centreOrigin;
-		localRayDir = ray.getDirection();
-		switch (getAlignment())
+		// Only the stretch of the ray within the bounds of the terrains can hit anything
+		AxisAlignedBox bounds;
+		for (TerrainSlotMap::const_iterator i = mTerrainSlots.begin(); i != mTerrainSlots.end(); ++i)
 		{
-		case Terrain::ALIGN_X_Y:
-			std::swap(localRayDir.y, localRayDir.z);
-			std::swap(offset.y, offset.z);
-			break;
-		case Terrain::ALIGN_Y_Z:
-			// x = z, z = y, y = -x
-			tmp.x = localRayDir.z; 
-			tmp.z = localRayDir.y; 
-			tmp.y = -localRayDir.x; 
-			localRayDir = tmp;
-			tmp.x = offset.z; 
-			tmp.z = offset.y; 
-			tmp.y = -offset.x; 
-			offset = tmp;
-			break;
-		case Terrain::ALIGN_X_Z:
-			// already in X/Z but values increase in -Z
-			localRayDir.z = -localRayDir.z;
-			offset.z = -offset.z;
-			break;
+			if (i->second->instance)
+				bounds.merge(i->second->instance->getWorldAABB());
 		}
-		// Normalise the offset  based on the world size of a square, and rebase to the bottom left
-		offset /= mTerrainWorldSize;
-		offset += 0.5f;
-		// this is our counter moving away from the 'current' square
-		Vector3 inc(Math::Abs(localRayDir.x), Math::Abs(localRayDir.y), Math::Abs(localRayDir.z));
-		long xdir = localRayDir.x > 0.0f ? 1 : -1;
-		long zdir = localRayDir.z > 0.0f ? 1 : -1;
-
-		// We're always counting from 0 to 1 regardless of what direction we're heading
-		if (xdir < 0)
-			offset.x = 1.0f - offset.x;
-		if (zdir < 0)
-			offset.z = 1.0f - offset.z;
-
-		// find next slot
-		bool keepSearching = true;
-		int numGaps = 0;
-		while(keepSearching)
+		Real nearDist, farDist;
+		if (!Math::intersects(ray, bounds, &nearDist, &farDist))
+			return result;
+		if (distanceLimit)
 		{
-			if (Math::RealEqual(inc.x, 0.0f) && Math::RealEqual(inc.z, 0.0f))
-				keepSearching = false;
-
-            while ( (!slot || !slot->instance) && keepSearching)
-			{
-				++numGaps;
-				/// if we don't find any filled slot in 6 traversals, give up
-				if (numGaps > 6)
-				{
-					keepSearching = false;
-					break;
-				}
-				// find next slot
-				Vector3 oldoffset = offset;
-				while (offset.x < 1.0f && offset.z < 1.0f)
-					offset += inc;
-				if (offset.x >= 1.0f && offset.z >= 1.0f)
-				{
-					// We crossed a corner, need to figure out which we passed first
-					Real diffz = 1.0f - oldoffset.z;
-					Real diffx = 1.0f - oldoffset.x;
-					Real distz = diffz / inc.z;
-					Real distx = diffx / inc.x;
-					if (distx < distz)
-					{
-						curr_x += xdir;
-						offset.x -= 1.0f;
-					}
-					else
-					{
-						curr_z += zdir;
-						offset.z -= 1.0f;
-					}
+			farDist = std::min(farDist, distanceLimit);
+			if (nearDist > farDist)
+				return result;
+		}
 
-				}
-				else if (offset.x >= 1.0f)
-				{
-					curr_x += xdir;
-					offset.x -= 1.0f;
-				}
-				else if (offset.z >= 1.0f)
-				{
-					curr_z += zdir;
-					offset.z -= 1.0f;
-				}
-				if (distanceLimit)
-				{
-					Vector3 worldPos;
-					convertTerrainSlotToWorldPosition(curr_x, curr_z, &worldPos);
-					if (ray.getOrigin().distance(worldPos) > distanceLimit)
-					{
-						keepSearching = false;
-						break;
-					}
-				}
-				slot = getTerrainSlot(curr_x, curr_z);
-			}
+		// Walk the slots the ray crosses in order, in terrain axes (z up) with one
+		// unit per slot, but keeping distances along the ray in world units
+		Vector3 origin, dir;
+		Terrain::convertWorldToTerrainAxes(mAlignment, ray.getOrigin() - mOrigin, &origin);
+		Terrain::convertWorldToTerrainAxes(mAlignment, ray.getDirection(), &dir);
+		origin /= mTerrainWorldSize;
+		origin.x += 0.5f;
+		origin.y += 0.5f;
+		dir /= mTerrainWorldSize;
+
+		Vector3 cur = origin + dir * nearDist;
+		long slotX = static_cast<long>(Math::Floor(cur.x));
+		long slotY = static_cast<long>(Math::Floor(cur.y));
+		long xDir = dir.x < 0.0f ? -1 : 1;
+		long yDir = dir.y < 0.0f ? -1 : 1;
+		Real nextX = Math::RealEqual(dir.x, 0.0f) ? Math::POS_INFINITY :
+			(slotX + (xDir > 0 ? 1 : 0) - origin.x) / dir.x;
+		Real nextY = Math::RealEqual(dir.y, 0.0f) ? Math::POS_INFINITY :
+			(slotY + (yDir > 0 ? 1 : 0) - origin.y) / dir.y;
+		Real stepX = Math::RealEqual(dir.x, 0.0f) ? Math::POS_INFINITY : Math::Abs(1.0f / dir.x);
+		Real stepY = Math::RealEqual(dir.y, 0.0f) ? Math::POS_INFINITY : Math::Abs(1.0f / dir.y);
+
+		while (true)
+		{
+			TerrainSlot* slot = getTerrainSlot(slotX, slotY);
 			if (slot && slot->instance)
 			{
-				numGaps = 0;
-				// don't cascade into neighbours
+				// don't cascade into neighbours, we visit them in order ourselves
 				std::pair<bool, Vector3> raypair = slot->instance->rayIntersects(ray, false, distanceLimit);
 				if (raypair.first)
 				{
-					keepSearching = false;
-					result.hit = true;
-					result.terrain = slot->instance;
-					result.position = raypair.second;
-				}
-				else
-				{
-					// not this one, trigger search for another slot
-					slot = 0;
+					if (!distanceLimit || ray.getOrigin().distance(raypair.second) <= distanceLimit)
+					{
+						result.hit = true;
+						result.terrain = slot->instance;
+						result.position = raypair.second;
+					}
+					break;
 				}
 			}
 
+			if (std::min(nextX, nextY) >= farDist)
+				break;
+			if (nextX < nextY)
+			{
+				slotX += xDir;
+				nextX += stepX;
+			}
+			else
+			{
+				slotY += yDir;
+				nextY += stepY;
+			}
 		}
 
-
 		return result;
 
 	}
@@ -220,6 +220,15 @@ namespace Ogre
 
 
 	}
+	//---------------------------------------------------------------------
+	size_t TerrainPagedWorldSection::getPageMemoryUsage(PageID pageID) const
+	{
+		long x, y;
+		// pageID is the same as a packed index
+		mTerrainGroup->unpackIndex(pageID, &x, &y);
+		Terrain* terrain = mTerrainGroup->getTerrain(x, y);
+		return terrain ? terrain->getMemoryUsage() : 0;
+	}
 
 
 
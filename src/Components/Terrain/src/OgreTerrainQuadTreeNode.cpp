@@ -59,6 +59,8 @@ namespace Ogre
 		, mDepth(depth)
 		, mQuadrant(quadrant)
 		, mBoundingRadius(0)
+		, mHeightDataMin(0)
+		, mHeightDataMax(0)
         , mCurrentLod(-1)
 		, mMaterialLodIndex(0)
 		, mLodTransition(0)
@@ -193,6 +195,9 @@ namespace Ogre
 				mChildren[i]->prepare();
 		}
 
+		if (!mParent)
+			updateHeightDataRange(Rect(mOffsetX, mOffsetY, mBoundaryX, mBoundaryY));
+
 	}
 	//---------------------------------------------------------------------
 	void TerrainQuadTreeNode::prepare(StreamSerialiser& stream)
@@ -222,6 +227,7 @@ namespace Ogre
 			rect.top = mOffsetY; rect.bottom = mBoundaryY;
 			rect.left = mOffsetX; rect.right = mBoundaryX;
 			postDeltaCalculation(rect);
+			updateHeightDataRange(rect);
 		}
 	}
 	//---------------------------------------------------------------------
@@ -485,7 +491,11 @@ namespace Ogre
 			|| rect.top <= mBoundaryY || rect.bottom > mOffsetY)
 		{
 			// Do we have vertex data?
+			VertexData* targetVertexData = 0;
 			if (mVertexDataRecord)
+				targetVertexData = cpuData ?
+					mVertexDataRecord->cpuVertexData : mVertexDataRecord->gpuVertexData;
+			if (targetVertexData)
 			{
 				// Trim to our bounds
 				Rect updateRect(mOffsetX, mOffsetY, mBoundaryX, mBoundaryY);
@@ -499,8 +509,6 @@ namespace Ogre
 				// if so, destroy it to free RAM, this should be fast enough to 
 				// to direct
 				HardwareVertexBufferSharedPtr posbuf, deltabuf;
-				VertexData* targetVertexData = cpuData ?
-					mVertexDataRecord->cpuVertexData : mVertexDataRecord->gpuVertexData;
 				if (positions) 
 					posbuf = targetVertexData->vertexBufferBinding->getBuffer(POSITION_BUFFER);
 				if (deltas)
@@ -535,6 +543,35 @@ namespace Ogre
 
 	}
 	//---------------------------------------------------------------------
+	size_t TerrainQuadTreeNode::getMemoryUsage() const
+	{
+		size_t ret = 0;
+		if (mVertexDataRecord)
+		{
+			VertexData* vertexData[2] = 
+				{ mVertexDataRecord->cpuVertexData, mVertexDataRecord->gpuVertexData };
+			for (int v = 0; v < 2; ++v)
+			{
+				if (!vertexData[v])
+					continue;
+				const VertexBufferBinding::VertexBufferBindingMap& bindings = 
+					vertexData[v]->vertexBufferBinding->getBindings();
+				for (VertexBufferBinding::VertexBufferBindingMap::const_iterator i = bindings.begin();
+					i != bindings.end(); ++i)
+				{
+					ret += i->second->getSizeInBytes();
+				}
+			}
+		}
+
+		if (!isLeaf())
+		{
+			for (int i = 0; i < 4; ++i)
+				ret += mChildren[i]->getMemoryUsage();
+		}
+		return ret;
+	}
+	//---------------------------------------------------------------------
 	const TerrainQuadTreeNode::VertexDataRecord* TerrainQuadTreeNode::getVertexDataRecord() const
 	{
 		return mNodeWithVertexData ? mNodeWithVertexData->mVertexDataRecord : 0;
@@ -1106,6 +1143,43 @@ namespace Ogre
 		}
 	}
 	//---------------------------------------------------------------------
+	void TerrainQuadTreeNode::updateHeightDataRange(const Rect& rect)
+	{
+		if (!rectIntersectsNode(rect))
+			return;
+
+		if (isLeaf())
+		{
+			// nodes share their edge vertices, so cover the boundary too
+			const float* pRow = mTerrain->getHeightData(mOffsetX, mOffsetY);
+			size_t rowSkip = mTerrain->getSize();
+			float minH = *pRow, maxH = *pRow;
+			for (uint16 y = 0; y < mSize; ++y, pRow += rowSkip)
+			{
+				for (uint16 x = 0; x < mSize; ++x)
+				{
+					minH = std::min(minH, pRow[x]);
+					maxH = std::max(maxH, pRow[x]);
+				}
+			}
+			mHeightDataMin = minH;
+			mHeightDataMax = maxH;
+		}
+		else
+		{
+			for (int i = 0; i < 4; ++i)
+				mChildren[i]->updateHeightDataRange(rect);
+
+			mHeightDataMin = mChildren[0]->mHeightDataMin;
+			mHeightDataMax = mChildren[0]->mHeightDataMax;
+			for (int i = 1; i < 4; ++i)
+			{
+				mHeightDataMin = std::min(mHeightDataMin, mChildren[i]->mHeightDataMin);
+				mHeightDataMax = std::max(mHeightDataMax, mChildren[i]->mHeightDataMax);
+			}
+		}
+	}
+	//---------------------------------------------------------------------
 	bool TerrainQuadTreeNode::rectContainsNode(const Rect& rect)
 	{
 		return (rect.left <= mOffsetX && rect.right > mBoundaryX &&
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreString.h"
 #include "OgreController.h"
 #include "OgreIteratorWrappers.h"
+#include "OgreIdString.h"
 
 namespace Ogre {
 
@@ -216,6 +217,10 @@ namespace Ogre {
 		AnimationState* getAnimationState(const String& name) const;
 		/// Tests if state for the named animation is present
 		bool hasAnimationState(const String& name) const;
+		/// Get an animation state by the interned name of the animation
+		AnimationState* getAnimationState(const IdString& name) const;
+		/// Tests if state for the animation with the interned name is present
+		bool hasAnimationState(const IdString& name) const;
 		/// Remove animation state with the given name
 		void removeAnimationState(const String& name);
 		/// Remove all animation states
@@ -257,6 +262,9 @@ namespace Ogre {
 	protected:
 		unsigned long mDirtyFrameNumber;
 		AnimationStateMap mAnimationStates;
+		/// Index of mAnimationStates by interned name
+		typedef HashMap<const String*, AnimationState*> AnimationStateIdMap;
+		AnimationStateIdMap mAnimationStatesById;
         EnabledAnimationStateList mEnabledAnimationStates;
 
 	};
@@ -214,6 +214,25 @@ namespace Ogre {
 		/** Retrieve the modification time of a given file */
 		virtual time_t getModifiedTime(const String& filename) = 0; 
 
+		/** Hints that the given files are about to be opened.
+		@remarks
+			Archives able to should start bringing the files' data in, e.g. by
+			asking the operating system to read them ahead, so that opening 
+			them shortly afterwards doesn't have to wait for the storage. The
+			default implementation does nothing.
+		@param filenames Fully qualified names of the files
+		*/
+		virtual void prefetch(const StringVector& filenames) { (void)filenames; }
+
+		/** Gets a key ordering files by where their data is held in storage.
+		@remarks
+			Opening files in increasing order of this key keeps reads close to
+			sequential. The default implementation returns 0 for every file, 
+			meaning no preference.
+		@param filename Fully qualified name of the file
+		*/
+		virtual uint64 getStorageOrder(const String& filename) { (void)filename; return 0; }
+
 
         /** Find all files or directories matching a given pattern in this
             archive and get some detailed information about them.
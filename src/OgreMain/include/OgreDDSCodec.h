@@ -37,15 +37,14 @@ namespace Ogre {
 	*  @{
 	*/
 
-	// Forward declarations
-	struct DXTColourBlock;
-	struct DXTExplicitAlphaBlock;
-	struct DXTInterpolatedAlphaBlock;
-
     /** Codec specialized in loading DDS (Direct Draw Surface) images.
 	@remarks
 		We implement our own codec here since we need to be able to keep DXT
 		data compressed if the card supports it.
+	@par
+		Images already compressed to PF_DXT1, PF_DXT3, PF_DXT5, PF_BC4_UNORM or 
+		PF_BC5_UNORM (see PixelUtil::bulkPixelConversion) can be saved along with
+		their mipmaps. BC4 and BC5 are always decompressed on load.
     */
     class _OgreExport DDSCodec : public ImageCodec
     {
@@ -59,13 +58,6 @@ namespace Ogre {
 		PixelFormat convertPixelFormat(uint32 rgbBits, uint32 rMask, 
 			uint32 gMask, uint32 bMask, uint32 aMask) const;
 
-		/// Unpack DXT colours into array of 16 colour values
-		void unpackDXTColour(PixelFormat pf, const DXTColourBlock& block, ColourValue* pCol) const;
-		/// Unpack DXT alphas into array of 16 colour values
-		void unpackDXTAlpha(const DXTExplicitAlphaBlock& block, ColourValue* pCol) const;
-		/// Unpack DXT alphas into array of 16 colour values
-		void unpackDXTAlpha(const DXTInterpolatedAlphaBlock& block, ColourValue* pCol) const;
-
 		/// Single registered codec instance
 		static DDSCodec* msInstance;
 	public:
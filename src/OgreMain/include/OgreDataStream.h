@@ -153,6 +153,11 @@ namespace Ogre {
 	*  @{
 	*/
 
+	class AsyncReadRequest;
+	class AsyncReadRequestListener;
+	/// Shared pointer to a request made with DataStream::readAsync
+	typedef SharedPtr<AsyncReadRequest> AsyncReadRequestPtr;
+
 	/** General purpose class used for encapsulating the reading and writing of data.
 	@remarks
 		This class performs basically the same tasks as std::basic_istream, 
@@ -297,8 +302,89 @@ namespace Ogre {
 
         /** Close the stream; this makes further operations invalid. */
         virtual void close(void) = 0;
-		
 
+		/** Starts reading bytes from a given offset, without waiting for them
+			to arrive.
+		@remarks
+			File streams hand the read to a worker thread of Root's WorkQueue, 
+			so the caller can get on with other work, such as decoding data read
+			earlier, and pick the result up through the request. Without Root,
+			or while its queue has no worker threads running, and for other 
+			streams, which have their data at hand, the read completes before 
+			this returns.
+		@par
+			The read position seen by read() is left as it was. The stream must 
+			stay open, the buffer valid and the stream otherwise unused until
+			the request completes.
+		@param buf Buffer to read into, at least count bytes long
+		@param offset Byte offset from the beginning of the stream to read from
+		@param count Number of bytes to read
+		@param listener Optional listener to notify when the read completes
+		*/
+		virtual AsyncReadRequestPtr readAsync(void* buf, size_t offset, size_t count, 
+			AsyncReadRequestListener* listener = 0);
+
+		/** Reads bytes from a given offset, leaving the read position as it was.
+		@remarks
+			Used to carry out readAsync requests, possibly from another thread.
+		*/
+		virtual size_t _readAt(void* buf, size_t offset, size_t count);
+
+	};
+
+	/** Listener notified when a read made with DataStream::readAsync completes.
+	@note
+		Reads of file streams may complete on a worker thread of Root's 
+		WorkQueue, and so do their notifications; anything done here must be
+		brief and thread safe. Further reads may be started from here.
+	*/
+	class _OgreExport AsyncReadRequestListener
+	{
+	public:
+		virtual ~AsyncReadRequestListener() {}
+		/// Called once the read has finished, successfully or not
+		virtual void readCompleted(AsyncReadRequest* request) = 0;
+	};
+
+	/** A read made with DataStream::readAsync.
+	@remarks
+		Use isComplete to poll the request or waitForCompletion to block on it;
+		the number of bytes read is known once the request is complete.
+	*/
+	class _OgreExport AsyncReadRequest : public StreamAlloc
+	{
+	protected:
+		DataStream* mStream;
+		void* mBuffer;
+		size_t mOffset;
+		size_t mCount;
+		size_t mBytesRead;
+		AsyncReadRequestListener* mListener;
+		bool mComplete;
+		OGRE_MUTEX(mCompleteMutex)
+		OGRE_THREAD_SYNCHRONISER(mCompleteSync)
+	public:
+		AsyncReadRequest(DataStream* stream, void* buf, size_t offset, size_t count, 
+			AsyncReadRequestListener* listener);
+
+		/// Gets the stream being read
+		DataStream* getStream() const { return mStream; }
+		/// Gets the buffer being read into
+		void* getBuffer() const { return mBuffer; }
+		/// Gets the offset into the stream the read starts at
+		size_t getOffset() const { return mOffset; }
+		/// Gets the number of bytes requested
+		size_t getCount() const { return mCount; }
+		/// Gets the number of bytes read, which is only valid once complete
+		size_t getBytesRead() const { return mBytesRead; }
+
+		/// Returns whether the read has finished
+		bool isComplete() const;
+		/// Blocks until the read has finished, returning the number of bytes read
+		size_t waitForCompletion();
+
+		/// Internal method to mark the read finished and notify the listener
+		void _notifyComplete(size_t bytesRead);
 	};
 
 	/** Shared pointer to allow data streams to be passed around without
@@ -473,6 +559,10 @@ namespace Ogre {
         */
         void close(void);
 
+		/** @copydoc DataStream::_readAt
+		*/
+		size_t _readAt(void* buf, size_t offset, size_t count);
+
 		/** Sets whether or not to free the encapsulated memory on close. */
 		void setFreeOnClose(bool free) { mFreeOnClose = free; }
 	};
@@ -604,7 +694,11 @@ namespace Ogre {
         /** @copydoc DataStream::close
         */
         void close(void);
-		
+
+		/** @copydoc DataStream::readAsync
+		*/
+		AsyncReadRequestPtr readAsync(void* buf, size_t offset, size_t count, 
+			AsyncReadRequestListener* listener = 0);
 		
 	};
 
@@ -656,6 +750,15 @@ namespace Ogre {
         */
         void close(void);
 
+		/** @copydoc DataStream::readAsync
+		*/
+		AsyncReadRequestPtr readAsync(void* buf, size_t offset, size_t count, 
+			AsyncReadRequestListener* listener = 0);
+
+		/** @copydoc DataStream::_readAt
+		*/
+		size_t _readAt(void* buf, size_t offset, size_t count);
+
 	};
 	/** @} */
 	/** @} */
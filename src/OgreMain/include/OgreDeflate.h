@@ -45,6 +45,17 @@ namespace Ogre
 		of the compressed data, it has no concrete source / data itself. The idea is
 		that you pass uncompressed data through this stream, and the underlying
 		stream reads/writes compressed data to the final source.
+	@par
+		Written data is compressed as one deflate stream by default. With setChunkSize
+		it is split into chunks which are deflated independently, spread over the 
+		threads of Root's WorkQueue by WorkQueue::defaultParallelFor,
+		and preceded by an index of their compressed sizes. Seeking in such a stream
+		only inflates the chunk containing the new position; a plain deflate stream
+		is inflated again from the start when seeking backwards.
+		Reading detects which kind of stream it is given. A chunked stream with 
+		a malformed header or index is rejected with ERR_INVALIDPARAMS. The 
+		underlying stream is kept just past the data of a chunked stream, as it 
+		is left past a plain one once that has been read to the end.
 	@note
 		This is an alternative to using a compressed archive since it is able to 
 		compress & decompress regardless of the actual source of the stream.
@@ -69,23 +80,40 @@ namespace Ogre
 		
 		/// Whether the underlying stream is valid compressed data
 		bool mIsCompressedValid;
-		
+
+		/// Position of the compressed data in the underlying stream
+		size_t mCompressedStart;
+		/// Uncompressed size of each chunk, 0 for a plain deflate stream
+		size_t mChunkSize;
+		/// Offsets of the chunks being read, relative to mCompressedStart, plus the end of the last one
+		vector<size_t>::type mChunkOffsets;
+		/// The inflated chunk mChunkData holds
+		size_t mCurrentChunk;
+		vector<uchar>::type mChunkData;
+		vector<uchar>::type mChunkCompressed;
+
 		
 		void init();
+		bool initChunked();
 		void destroy();
 		void compressFinal();
+		void compressChunks(const uchar* data, size_t size);
+		void restartInflate();
+		size_t readChunked(void* buf, size_t count);
 	public:
 		/** Constructor for creating unnamed stream wrapping another stream.
 		 @param compressedStream The stream that this stream will use when reading / 
 			writing compressed data. The access mode from this stream will be matched.
-		 @param tmpFileName Path/Filename to be used for temporary storage of incoming data
+		 @param tmpFileName Path/Filename to be used for temporary storage of incoming data,
+			which is kept in memory if left empty
 		*/
         DeflateStream(const DataStreamPtr& compressedStream, const String& tmpFileName = "");
 		/** Constructor for creating named stream wrapping another stream.
 		 @param name The name to give this stream
 		 @param compressedStream The stream that this stream will use when reading / 
 			writing compressed data. The access mode from this stream will be matched.
-		 @param tmpFileName Path/Filename to be used for temporary storage of incoming data
+		 @param tmpFileName Path/Filename to be used for temporary storage of incoming data,
+			which is kept in memory if left empty
 		 */
 		DeflateStream(const String& name, const DataStreamPtr& compressedStream, const String& tmpFileName="");	
 		
@@ -98,6 +126,20 @@ namespace Ogre
 			will actually be executed as passthroughs as a fallback. 
 		*/
 		bool isCompressedStreamValid() const { return mIsCompressedValid; }
+
+		/** Compress written data in independently deflated chunks of this many 
+			uncompressed bytes.
+		@remarks
+			Must be set before the stream is closed. 0, the default, writes a single
+			deflate stream, which is a little smaller but can't be compressed in 
+			parallel or read at random.
+		*/
+		void setChunkSize(size_t chunkSize);
+		/** Get the uncompressed size of the chunks of this stream, 0 if it's a single
+			deflate stream. 
+		*/
+		size_t getChunkSize() const { return mChunkSize; }
+
 		
 		/** @copydoc DataStream::read
 		 */
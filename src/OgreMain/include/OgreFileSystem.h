@@ -102,6 +102,12 @@ namespace Ogre {
 		/// @copydoc Archive::getModifiedTime
 		time_t getModifiedTime(const String& filename);
 
+		/// @copydoc Archive::prefetch
+		void prefetch(const StringVector& filenames);
+
+		/// @copydoc Archive::getStorageOrder
+		uint64 getStorageOrder(const String& filename);
+
 		/// Set whether filesystem enumeration will include hidden files or not.
 		/// This should be called prior to declaring and/or initializing filesystem
 		/// resource locations. The default is true (ignore hidden files).
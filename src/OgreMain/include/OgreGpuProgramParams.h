@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreSerializer.h"
 #include "OgreRenderOperation.h"
 #include "OgreAny.h"
+#include "OgreIdString.h"
 
 namespace Ogre {
 
@@ -312,7 +313,21 @@ namespace Ogre {
 		*/
 		void load(DataStreamPtr& stream);
 
+		/** Finds a constant definition by interned name, or returns null.
+		@remarks
+		The lookup goes through an index of copies of the entries in map, 
+		which is built on first use and rebuilt whenever the number of 
+		definitions changes. Code which alters existing definitions in place 
+		after that must call _clearIdIndex.
+		*/
+		const GpuConstantDefinition* find(const IdString& name) const;
+		/// Discards the interned name index, so the next find rebuilds it
+		void _clearIdIndex(void) { mIdIndex.clear(); }
+
 	protected:
+		typedef HashMap<const String*, GpuConstantDefinition> GpuConstantDefinitionIdMap;
+		mutable GpuConstantDefinitionIdMap mIdIndex;
+
 		/** Indicates whether all array entries will be generated and added to the definitions map
 		@remarks
 		Normally, the number of array entries added to the definitions map is capped at 16
@@ -1639,6 +1654,19 @@ namespace Ogre {
 		*/
 		void setNamedConstant(const String& name, const ColourValue& colour);
 
+		/** Sets named constants by interned name.
+		@remarks
+		These behave like the String versions, but look the parameter up 
+		through GpuNamedConstants::find, which avoids hashing and comparing
+		the name on every call; use them for parameters updated every frame.
+		*/
+		void setNamedConstant(const IdString& name, Real val);
+		void setNamedConstant(const IdString& name, int val);
+		void setNamedConstant(const IdString& name, const Vector4& vec);
+		void setNamedConstant(const IdString& name, const Vector3& vec);
+		void setNamedConstant(const IdString& name, const Matrix4& m);
+		void setNamedConstant(const IdString& name, const ColourValue& colour);
+
 		/** Sets a multiple value constant floating-point parameter to the program.
 		@par
 		Some systems only allow constants to be set on certain boundaries, 
@@ -1715,6 +1743,9 @@ namespace Ogre {
 		*/
 		const GpuConstantDefinition* _findNamedConstantDefinition(
 			const String& name, bool throwExceptionIfMissing = false) const;
+		/// As _findNamedConstantDefinition, but by interned name
+		const GpuConstantDefinition* _findNamedConstantDefinition(
+			const IdString& name, bool throwExceptionIfMissing = false) const;
 		/** Gets the physical buffer index associated with a logical float constant index. 
 		@note Only applicable to low-level programs.
 		@param logicalIndex The logical parameter index
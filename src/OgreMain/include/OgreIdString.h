@@ -0,0 +1,101 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __IdString_H__
+#define __IdString_H__
+
+#include "OgrePrerequisites.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup General
+	*  @{
+	*/
+	/** An interned string identifier with a precomputed hash.
+	@remarks
+		Looking something up by String means hashing the whole string and then
+		comparing it character by character on every call. An IdString does
+		that work once, when it is constructed: the text is interned in a 
+		process-wide table and the IdString keeps a pointer to the single
+		interned copy together with its hash. Two IdStrings made from equal 
+		text therefore share the same pointer, so comparing them or using them 
+		as a map key costs no more than comparing an integer, and can never
+		collide.
+	@par
+		Build IdStrings once (at load time, or as static members of the code
+		that does the lookups) and reuse them in per-frame code; constructing
+		one takes a lock and a hash table lookup, which is no cheaper than the 
+		String lookup it is meant to replace. Interned text is never released.
+	*/
+	class _OgreExport IdString
+	{
+	public:
+		/// Null identifier, which never matches anything
+		IdString() : mString(0), mHash(0) {}
+		explicit IdString(const String& str) { intern(str); }
+		explicit IdString(const char* str) { intern(String(str)); }
+
+		/// Returns true if this identifier was default constructed
+		bool isNull(void) const { return mString == 0; }
+		/// The precomputed FastHash of the text
+		uint32 getHash(void) const { return mHash; }
+		/// The text of this identifier, blank if null
+		const String& getString(void) const;
+		/** The address of the interned text, which is unique per text.
+		@remarks Used by containers which want to key on identity.
+		*/
+		const String* _getInterned(void) const { return mString; }
+
+		bool operator==(const IdString& rhs) const { return mString == rhs.mString; }
+		bool operator!=(const IdString& rhs) const { return mString != rhs.mString; }
+		/// Orders by identity; the order is stable for the process lifetime only
+		bool operator<(const IdString& rhs) const { return mString < rhs.mString; }
+
+		/// Returns the number of distinct strings interned so far
+		static size_t getInternedCount(void);
+
+	protected:
+		void intern(const String& str);
+
+		const String* mString;
+		uint32 mHash;
+	};
+
+	inline std::ostream& operator<<(std::ostream& o, const IdString& id)
+	{
+		o << id.getString();
+		return o;
+	}
+	/** @} */
+	/** @} */
+
+}
+
+#endif
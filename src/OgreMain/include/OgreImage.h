@@ -454,7 +454,11 @@ namespace Ogre {
 			FILTER_BILINEAR,
 			FILTER_BOX,
 			FILTER_TRIANGLE,
-			FILTER_BICUBIC
+			FILTER_BICUBIC,
+			/// Separable Lanczos (windowed sinc, 3 lobes) filter, sharp high quality downsampling
+			FILTER_LANCZOS,
+			/// Separable Kaiser windowed sinc filter, a little softer than Lanczos with less ringing
+			FILTER_KAISER
 		};
 		/** Scale a 1D, 2D or 3D image volume. 
 			@param 	src			PixelBox containing the source pointer, dimensions and format
@@ -462,11 +466,26 @@ namespace Ogre {
 			@param 	filter		Which filter to use
 			@remarks 	This function can do pixel format conversion in the process.
 			@note	dst and src can point to the same PixelBox object without any problem
+			@note	Large images are scaled in bands of rows, spread over the threads
+				of Root's WorkQueue by WorkQueue::defaultParallelFor. FILTER_LANCZOS 
+				and FILTER_KAISER work on a floating point copy of the image and are
+				slower than the other filters, but give much better results when 
+				reducing an image to less than half its size.
 		*/
 		static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR);
 		
 		/** Resize a 2D image, applying the appropriate filter. */
 		void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
+
+		/** Replace any mipmaps of the image with a full chain generated from the 
+			top level, down to 1x1.
+		@remarks
+			Each level is scaled from the one above it, for every face of the image.
+			Dynamic images are copied to a buffer owned by the image.
+		@param filter Which filter to use; FILTER_LANCZOS or FILTER_KAISER give 
+			the sharpest results with the least aliasing
+		*/
+		void generateMipmaps(Filter filter = FILTER_BILINEAR);
 		
         // Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, size_t width, size_t height, size_t depth, PixelFormat format);
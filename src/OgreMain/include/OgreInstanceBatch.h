@@ -135,6 +135,14 @@ namespace Ogre
 		/// When true remove the memory of the IndexData we've created because no one else will
 		bool mRemoveOwnIndexData;
 
+		typedef vector<float>::type FloatVec;
+		/// Copy of the 3x4 transforms last sent to the GPU, @see packTransforms3x4
+		FloatVec			mTransformShadow;
+		/// When true the GPU copy doesn't match mTransformShadow and needs to be fully sent again
+		bool				mTransformShadowDirty;
+		/// Per entity, what InstancedEntity::_getPackedWorldTransform returned this update
+		vector<const Matrix4*>::type mPackedWorldTransforms;
+
 		virtual void setupVertices( const SubMesh* baseSubMesh ) = 0;
 		virtual void setupIndices( const SubMesh* baseSubMesh ) = 0;
 		virtual void createAllInstancedEntities(void);
@@ -149,6 +157,21 @@ namespace Ogre
 		*/
 		void makeMatrixCameraRelative3x4( float *mat3x4, size_t numFloats );
 
+		/** Writes the 3x4 transforms of the given entities, in the same order, into
+			mTransformShadow; applying camera relative rendering when enabled.
+			Only the range of entities whose transforms changed since they were last written
+			needs to be sent to the GPU, so unchanged batches don't have to be uploaded at all.
+			Big batches are split across threads with WorkQueue::defaultParallelFor, after the
+			world transforms have been fetched from the calling thread.
+			@param entities The entities, as they're laid out in the GPU buffer
+			@param floatsPerEntity Number of floats each entity takes (12 per matrix)
+			@param outDirtyStart First float from mTransformShadow that needs to be sent
+			@param outDirtyEnd One past the last float from mTransformShadow that needs to be sent
+			@return False when nothing changed. The out params are left untouched then.
+		*/
+		bool packTransforms3x4( const InstancedEntityVec &entities, size_t floatsPerEntity,
+								size_t &outDirtyStart, size_t &outDirtyEnd );
+
 		/// Returns false on errors that would prevent building this batch from the given submesh
 		virtual bool checkSubMeshCompatibility( const SubMesh* baseSubMesh );
 
@@ -62,6 +62,9 @@ namespace Ogre
 	{
 		bool	mKeepStatic;
 
+		/// Entities that passed the individual cull check, in the order they're sent to the GPU
+		InstancedEntityVec	mVisibleEntities;
+
 		void setupVertices( const SubMesh* baseSubMesh );
 		void setupIndices( const SubMesh* baseSubMesh );
 
@@ -64,6 +64,8 @@ namespace Ogre
 
 		//Pointer to the buffer containing the per instance vertex data
 		HardwareVertexBufferSharedPtr mInstanceVertexBuffer;
+		//Temporary array used to store 3x4 matrices before they are converted to dual quaternions
+		vector<float>::type mTempTransformsArray3x4;
 
 		void setupVertices( const SubMesh* baseSubMesh );
 		void setupIndices( const SubMesh* baseSubMesh );
@@ -90,8 +90,6 @@ namespace Ogre
 
 		size_t					mRowLength;
 		size_t 					mWeightCount;
-		//Temporary array used to store 3x4 matrices before they are converted to dual quaternions
-		float* 					mTempTransformsArray3x4;
 
 		// The state of the usage of bone matrix lookup
 		bool mUseBoneMatrixLookup;
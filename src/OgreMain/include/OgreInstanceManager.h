@@ -118,6 +118,11 @@ namespace Ogre
 		SceneManager*			mSceneManager;
 
 		size_t					mMaxLookupTableInstances;
+
+		/// Statistics of instance data sent to the GPU, @see getUploadedBytesLastFrame
+		size_t					mUploadedBytes;
+		size_t					mUploadedBytesLastFrame;
+		unsigned long			mUploadFrame;
 		/** Finds a batch with at least one free instanced entity we can use.
 			If none found, creates one.
 		*/
@@ -261,6 +266,15 @@ namespace Ogre
 		/** Called by SceneManager when we told it we have at least one dirty batch */
 		void _updateDirtyBatches(void);
 
+		/** Returns the amount of bytes of per instance data (i.e. transforms) that batches from
+			this manager sent to the GPU during the last frame. Instances whose transforms didn't
+			change since they were last sent aren't sent again, thus aren't counted.
+		*/
+		size_t getUploadedBytesLastFrame(void) const;
+
+		/** Called by an InstanceBatch after writing per instance data to the GPU */
+		void _addUploadedBytes( size_t bytes );
+
 		typedef ConstMapIterator<InstanceBatchMap> InstanceBatchMapIterator;
 		typedef ConstVectorIterator<InstanceBatchVec> InstanceBatchIterator;
 
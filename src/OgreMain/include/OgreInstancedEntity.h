@@ -218,6 +218,26 @@ namespace Ogre
 		*/
 		virtual bool _updateAnimation(void);
 
+		/** Called by InstanceBatch, from the main thread, to get what _packTransforms3x4 needs
+			from our parent node. The node caches its full transform without any locking, so
+			this can't be left to the threads packing the transforms.
+			@return Null when we're not visible. Otherwise, without a skeleton, the matrix
+			to write; with one, any non null pointer.
+		*/
+		const Matrix4* _getPackedWorldTransform(void) const;
+
+		/** Called by InstanceBatch to write our transforms as 3x4 matrices, like getTransforms3x4,
+			but through OptimisedUtil and comparing against what xform already contains.
+			@remarks Safe to call from multiple threads as long as each writes to its own xform
+			@param worldTransform What _getPackedWorldTransform returned. When null, null
+			matrices are written.
+			@param translationOffset Subtracted from the translation of each matrix (camera
+			relative rendering). Ignored when writing null matrices.
+			@return true if any of the values in xform changed
+		*/
+		bool _packTransforms3x4( float *xform, const Matrix4 *worldTransform,
+								 const Vector3 &translationOffset ) const;
+
 		/** Sets the transformation look up number */
 		void setTransformLookupNumber(uint16 num) { mTransformLookupNumber = num;}
 
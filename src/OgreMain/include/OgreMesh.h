@@ -185,6 +185,10 @@ namespace Ogre {
 		PoseList mPoseList;
 		mutable bool mPosesIncludeNormals;
 
+		/// Triangles hierarchy for exact ray queries, built on demand
+		TriangleBVH* mTriangleBVH;
+		OGRE_MUTEX(mTriangleBVHMutex)
+
 
         /** Loads the mesh from disk.  This call only performs IO, it
             does not parse the bytestream or check for any errors therein.
@@ -345,6 +349,24 @@ namespace Ogre {
         */
         void _setBoundingSphereRadius(Real radius);
 
+		/** Gets a bounding volume hierarchy of the triangles of this mesh, to find
+			exactly which triangle a ray hits.
+		@remarks
+			The hierarchy is built on first use from level of detail 0, reading the
+			vertex and index buffers back, so they must either have shadow buffers
+			(the default) or not be write only. Since hardware buffers are locked, the
+			first call should be made from the thread owning the render system. 
+			Animation isn't taken into account.
+		@par
+			The hierarchy is kept until the mesh is unloaded, or until 
+			clearTriangleBVH is called after changing the geometry.
+		@return The hierarchy, or null if the mesh is not loaded
+		*/
+		const TriangleBVH* getTriangleBVH(void);
+		/** Discards the hierarchy returned by getTriangleBVH, so it is rebuilt
+			on next use. */
+		void clearTriangleBVH(void);
+
         /** Sets the name of the skeleton this Mesh uses for animation.
         @remarks
             Meshes can optionally be assigned a skeleton which can be used to animate
@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "OgreAnimable.h"
 #include "OgreAny.h"
 #include "OgreUserObjectBindings.h"
+#include "OgreSlotMap.h"
 
 namespace Ogre {
 
@@ -111,6 +112,8 @@ namespace Ogre {
 		MovableObjectFactory* mCreator;
 		/// SceneManager holding this object (if applicable)
 		SceneManager* mManager;
+		/// Handle in the SceneManager, if created without a name
+		SlotHandle mHandle;
         /// node to which this object is attached
         Node* mParentNode;
         bool mParentIsTagPoint;
@@ -187,6 +190,15 @@ namespace Ogre {
 		virtual void _notifyManager(SceneManager* man) { mManager = man; }
 		/** Get the manager of this object, if any (internal use only) */
 		virtual SceneManager* _getManager(void) const { return mManager; }
+		/** Notify the object of its handle in the manager (internal use only) */
+		void _notifyHandle(const SlotHandle& handle) { mHandle = handle; }
+		/** Gets the handle of this object in its SceneManager.
+		@remarks
+			This is null unless the object was created with 
+			SceneManager::createAnonymousMovableObject or one of the 
+			createAnonymous methods built on it.
+		*/
+		const SlotHandle& getHandle(void) const { return mHandle; }
 
         /** Returns the name of this object. */
 		virtual const String& getName(void) const { return mName; }
@@ -203,6 +203,104 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Packs the upper 3x4 part of an array of affine matrices into tightly
+            packed floats, as used by the instancing techniques.
+        @remarks
+            The destination is compared against the new values while it's being
+            written, so callers keeping a CPU copy of GPU data can tell whether
+            it needs to be uploaded again.
+        @param srcMatrices An array of pointers to the matrices to pack. No
+            alignment requirement.
+        @param destFloats Pointer to 12 * numMatrices floats that receive the
+            rows 0..2 of each matrix. No alignment requirement.
+        @param translationOffset Subtracted from the translation column of every
+            matrix (i.e. the camera position for camera relative rendering).
+        @param numMatrices Number of matrices to pack.
+        @return true if any of the destination floats changed.
+        */
+        virtual bool packAffineMatrices3x4(
+            const Matrix4* const* srcMatrices,
+            float* destFloats,
+            const Vector3& translationOffset,
+            size_t numMatrices) = 0;
+
+        /** Calculate the normals of a row of a height field by central differences.
+        @remarks
+            The normals are in height field axes, i.e. x along the row, y across
+            the rows and z up, and are unit length.
+        @param rowBelow Heights of the previous row, count values.
+        @param row Heights of the row itself, readable from row[-1] to row[count].
+        @param rowAbove Heights of the next row, count values.
+        @param spacing The distance between two samples of the height field.
+        @param destX, destY, destZ Receive the components of the count normals.
+        @param count Number of normals to calculate.
+        @note No alignment requirement for any of the arrays.
+        */
+        virtual void calculateHeightFieldNormals(
+            const float* rowBelow,
+            const float* row,
+            const float* rowAbove,
+            float spacing,
+            float* destX,
+            float* destY,
+            float* destZ,
+            size_t count) = 0;
+
+        /** Advance a horizon sweep across a height field by one line, towards
+            the side facing away from a directional light.
+        @remarks
+            The horizon of a sample is the height above which the light reaches
+            it. For every sample i of the line it is interpolated from the
+            previous line (the one towards the light) between prevHorizon[i] and
+            prevHorizon[i+1], lowered by drop, and compared against the height
+            of the sample.
+        @param prevHorizon For each sample of the previous line, the highest of
+            its height and its horizon. Readable from 0 to count.
+        @param weight Interpolation weight between prevHorizon[i] and prevHorizon[i+1].
+        @param drop How much the light ray rises, in height units, between this
+            line and the previous one.
+        @param heights Heights of the samples of this line.
+        @param bias Added to the heights before comparing, to avoid self shadowing.
+        @param destHorizon Receives the highest of height and horizon for every
+            sample, for the next line. Must not overlap prevHorizon.
+        @param destLit Receives 255 for samples reached by the light, 0 otherwise.
+        @param count Number of samples in the line.
+        @note No alignment requirement for any of the arrays.
+        */
+        virtual void sweepHeightFieldHorizon(
+            const float* prevHorizon,
+            float weight,
+            float drop,
+            const float* heights,
+            float bias,
+            float* destHorizon,
+            uint8* destLit,
+            size_t count) = 0;
+
+        /** Sample a square height field at arbitrary positions.
+        @remarks
+            Each quad of the field is split into two triangles the same way
+            the terrain tessellates it: along the diagonal from its lower left
+            to its upper right corner on even rows, along the other diagonal on
+            odd rows. A position is interpolated linearly over the triangle it
+            falls in, so the result lies on the rendered surface. Positions are
+            clamped to the edges of the field.
+        @param heights Pointer to size * size heights, one row after another.
+        @param size Number of samples along each side of the field, at least 2.
+        @param posX, posY Pointers to the positions to sample, from 0 to 1
+            across the field.
+        @param dest Pointer to the buffer which receives the heights.
+        @param count Number of positions to sample.
+        @note No alignment requirement for any of the arrays.
+        */
+        virtual void sampleHeightField(
+            const float* heights,
+            size_t size,
+            const float* posX,
+            const float* posY,
+            float* dest,
+            size_t count) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
@@ -153,8 +153,12 @@ namespace Ogre {
         PF_R8 = 42,
         /// 16-bit pixel format, 8 bits red, 8 bits green.
         PF_RG8 = 43,
+        /// BC4 (ATI1, RGTC1) single channel compression, 4 bits per pixel of red
+        PF_BC4_UNORM = 44,
+        /// BC5 (ATI2, RGTC2) two channel compression, 8 bits per pixel of red and green
+        PF_BC5_UNORM = 45,
 		// Number of pixel formats currently defined
-        PF_COUNT = 44
+        PF_COUNT = 46
     };
 	typedef vector<PixelFormat>::type PixelFormatList;
 
@@ -502,6 +506,12 @@ namespace Ogre {
 		 	@param	dst			PixelBox containing the destination pixels, pitches and format
 		 	@remarks The source and destination boxes must have the same
          	dimensions. In case the source and destination format match, a plain copy is done.
+			@par
+				Whole images can be compressed to PF_DXT1, PF_DXT3, PF_DXT5, PF_BC4_UNORM
+				and PF_BC5_UNORM, and decompressed from those and PF_DXT2 and PF_DXT4. Rows 
+				of blocks are spread over the threads of Root's WorkQueue by 
+				WorkQueue::defaultParallelFor.
+				DXT1 encodes texels with an alpha below 0.5 as transparent.
         */
         static void bulkPixelConversion(const PixelBox &src, const PixelBox &dst);
     };
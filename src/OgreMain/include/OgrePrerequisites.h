@@ -178,6 +178,7 @@ namespace Ogre {
     class HighLevelGpuProgramPtr;
 	class HighLevelGpuProgramManager;
 	class HighLevelGpuProgramFactory;
+	class IdString;
     class IndexData;
 	class InstanceBatch;
 	class InstanceBatchHW;
@@ -295,9 +296,11 @@ namespace Ogre {
     class StringInterface;
     class SubEntity;
     class SubMesh;
+	class SweepAndPrune;
 	class TagPoint;
     class Technique;
 	class TempBlendedBufferInfo;
+	class TriangleBVH;
 	class ExternalTextureSource;
     class TextureUnitState;
     class Texture;
@@ -156,6 +156,24 @@ namespace Ogre {
 
 		BackgroundProcessTicket addRequest(ResourceRequest& req);
 
+		/// A queued resource request whose file has not been read ahead yet
+		struct ReadAheadEntry
+		{
+			BackgroundProcessTicket ticket;
+			String resourceName;
+			String groupName;
+		};
+		typedef list<ReadAheadEntry>::type ReadAheadList;
+		/// Resource requests waiting to be handled, in the order they were queued
+		ReadAheadList mReadAheadList;
+		OGRE_MUTEX(mReadAheadMutex)
+		bool mReadAheadEnabled;
+
+		/** Starts reading the file of the next waiting resource request in the 
+			background, now that the request with the given ticket is handled.
+		*/
+		void readAheadAfter(BackgroundProcessTicket ticket);
+
 	public:
 		ResourceBackgroundQueue();
 		virtual ~ResourceBackgroundQueue();
@@ -306,6 +324,20 @@ namespace Ogre {
 		*/
 		void abortRequest( BackgroundProcessTicket ticket );
 
+		/** Sets whether to read resource files ahead of their requests.
+		@remarks
+			When a background request to prepare or load a single resource is
+			handled, the file of the next such request is read through with
+			DataStream::readAsync while the current resource is decoded, so 
+			that it is in the operating system's file cache by the time it is
+			needed. The reads go through Root's WorkQueue too, so this is skipped
+			unless it has more than one worker thread. Only files opened straight
+			from the file system are read ahead. Enabled by default.
+		*/
+		void setReadAheadEnabled(bool enabled) { mReadAheadEnabled = enabled; }
+		/// Gets whether resource files are read ahead of their requests
+		bool getReadAheadEnabled() const { return mReadAheadEnabled; }
+
 		/// Implementation for WorkQueue::RequestHandler
 		bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
 		/// Implementation for WorkQueue::RequestHandler
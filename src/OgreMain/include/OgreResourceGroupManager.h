@@ -280,6 +280,10 @@ namespace Ogre {
 			Archive* archive;
 			/// Whether this location was added recursively
 			bool recursive;
+			/** Files found when the location was indexed, kept for read-only 
+				archives only, so file pattern searches need not ask the archive.
+			*/
+			StringVectorPtr fileNames;
 		};
 		/// List of possible file locations
 		typedef list<ResourceLocation*>::type LocationList;
@@ -296,12 +300,32 @@ namespace Ogre {
         ResourceGroupListenerList mResourceGroupListenerList;
 
 		ResourceLoadingListener *mLoadingListener;
+		/// Whether files are prefetched and loaded in storage order
+		bool mPrefetchResources;
 
         /// Resource index entry, resourcename->location 
         typedef map<String, Archive*>::type ResourceLocationIndex;
 
 		/// List of resources which can be loaded / unloaded
 		typedef list<ResourcePtr>::type LoadUnloadResourceList;
+		struct ResourceGroup;
+		/** Index of resource names across all groups.
+		@remarks
+			Maps lower case resource names to the groups whose case sensitive
+			index holds them, with the number of such entries, so the groups 
+			containing a resource can be found without visiting every group.
+		*/
+		struct GlobalResourceIndex
+		{
+			OGRE_AUTO_MUTEX
+			typedef map<ResourceGroup*, size_t>::type GroupCountMap;
+			typedef HashMap<String, GroupCountMap> NameMap;
+			NameMap names;
+
+			void add(const String& filename, ResourceGroup* grp);
+			void remove(const String& filename, ResourceGroup* grp);
+			void removeGroup(ResourceGroup* grp);
+		};
 		/// Resource group entry
 		struct ResourceGroup
 		{
@@ -340,6 +364,8 @@ namespace Ogre {
             SceneManager* worldGeometrySceneManager;
 			// in global pool flag - if true the resource will be loaded even a different	group was requested in the load method as a parameter.
 			bool inGlobalPool;
+			/// Index across all groups, kept in step with resourceIndexCaseSensitive
+			GlobalResourceIndex* globalIndex;
 
 			void addToIndex(const String& filename, Archive* arch);
 			void removeFromIndex(const String& filename, Archive* arch);
@@ -349,6 +375,26 @@ namespace Ogre {
         /// Map from resource group names to groups
         typedef map<String, ResourceGroup*>::type ResourceGroupMap;
         ResourceGroupMap mResourceGroupMap;
+		GlobalResourceIndex mGlobalResourceIndex;
+
+		/// Cached contents of a read-only file archive
+		struct ArchiveIndexCacheEntry
+		{
+			/// Modification time of the archive file the names were listed at
+			time_t modifiedTime;
+			/// Size of the archive file the names were listed at
+			uint64 fileSize;
+			StringVectorPtr fileNames;
+		};
+		/// Cached archive contents, by archive type, recursion and name
+		typedef map<String, ArchiveIndexCacheEntry>::type ArchiveIndexCache;
+		ArchiveIndexCache mArchiveIndexCache;
+		OGRE_MUTEX(mArchiveIndexCacheMutex)
+
+		/** Lists the files of a newly added location, from the archive index cache
+			when it holds an up to date entry for it.
+		*/
+		StringVectorPtr listLocationFiles(Archive* arch, bool recursive);
 
         /// Group name for world resources
         String mWorldGroupName;
@@ -374,6 +420,14 @@ namespace Ogre {
 		void deleteGroup(ResourceGroup* grp);
 		/// Internal find method for auto groups
 		ResourceGroup* findGroupContainingResourceImpl(const String& filename);
+		/// Internal method for finding the archive holding a file in a group, or null
+		Archive* findResourceArchiveImpl(ResourceGroup* grp, const String& filename, 
+			bool searchLocations = true);
+		/** Hints the archives of a group about the resources in a list which are 
+			about to be read, and sorts those by where their files are stored.
+		*/
+		void prefetchResources(ResourceGroup* grp, LoadUnloadResourceList* resources, 
+			bool forLoad);
 		/// Internal event firing method
 		void fireResourceGroupScriptingStarted(const String& groupName, size_t scriptCount);
 		/// Internal event firing method
@@ -818,6 +872,14 @@ namespace Ogre {
 		*/
 		const String& findGroupContainingResource(const String& filename);
 
+		/** Find the archive a resource would be opened from, without opening it.
+		@param groupName The resource group to look in first; other groups are
+			searched if the resource is not found there
+		@param filename Fully qualified name of the file
+		@return The archive, or null if the resource could not be found
+		*/
+		Archive* _findResourceArchive(const String& groupName, const String& filename);
+
         /** Find all files or directories matching a given pattern in a group
             and get some detailed information about them.
         @param group The name of the resource group
@@ -1046,6 +1108,39 @@ namespace Ogre {
 		*/		
 		const LocationList& getResourceLocationList(const String& groupName);
 
+		/** Saves the list of files found in read-only file archives (e.g. zips)
+			added as resource locations so far, for loadArchiveIndexCache.
+		@remarks
+			Indexing a resource location means listing every file in it; with
+			many archives that dominates start up. Entries are keyed by archive
+			name, type and recursion, and are only used again while the 
+			archive file keeps the modification time and size it had when
+			listed.
+			Directories are never cached, since changes below them do not
+			show in their modification time.
+		*/
+		void saveArchiveIndexCache(DataStreamPtr stream);
+		/** Loads archive listings saved by saveArchiveIndexCache.
+		@remarks
+			Call this before adding resource locations. Entries whose archive
+			has changed since are simply listed again when it is added.
+		*/
+		void loadArchiveIndexCache(DataStreamPtr stream);
+
+		/** Sets whether to prefetch files when preparing or loading a group.
+		@remarks
+			Before each batch of resources sharing a loading order is prepared
+			or loaded, the archives holding their files are told which files
+			are coming (see Archive::prefetch), so that reading can start 
+			ahead, and those resources are reordered by where their files lie
+			in storage (see Archive::getStorageOrder) to keep reads sequential.
+			Resources without a file of their name in the group keep their 
+			place. Enabled by default.
+		*/
+		void setPrefetchResources(bool prefetch) { mPrefetchResources = prefetch; }
+		/// Gets whether files are prefetched when preparing or loading a group
+		bool getPrefetchResources() const { return mPrefetchResources; }
+
 		/// Sets a new loading listener
 		void setLoadingListener(ResourceLoadingListener *listener);
 		/// Returns the current loading listener
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreResourceGroupManager.h"
 #include "OgreIteratorWrappers.h"
 #include "OgreCommon.h"
+#include "OgreIdString.h"
 #include "OgreDataStream.h"
 #include "OgreStringVector.h"
 #include "OgreScriptLoader.h"
@@ -300,6 +301,14 @@ namespace Ogre {
         /** Retrieves a pointer to a resource by name, or null if the resource does not exist.
         */
         virtual ResourcePtr getByName(const String& name, const String& groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+        /** Retrieves a pointer to a resource by interned name, or null if the resource does not exist.
+		@remarks
+			Equivalent to the String version, but the name lookup is done on
+			the identity of the interned name rather than hashing and comparing
+			the text, which makes it the better choice for lookups repeated
+			every frame. Keep the IdString around rather than building it per call.
+        */
+        virtual ResourcePtr getByName(const IdString& name, const String& groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
         /** Retrieves a pointer to a resource by handle, or null if the resource does not exist.
         */
         virtual ResourcePtr getByHandle(ResourceHandle handle);
@@ -483,6 +492,11 @@ namespace Ogre {
 		virtual void addImpl( ResourcePtr& res );
 		/** Remove a resource from this manager; remove it from the lists. */
 		virtual void removeImpl( ResourcePtr& res );
+		/** Inserts into the name, interned name and handle maps under the write lock.
+		@return false if the name is already taken in that pool, in which case
+			nothing is inserted
+		*/
+		bool insertImpl( ResourcePtr& res, bool inGlobalPool );
 		/** Checks memory usage and pages out if required.
 		*/
 		virtual void checkUsage(void);
@@ -493,9 +507,22 @@ namespace Ogre {
 		typedef HashMap< String, ResourceMap > ResourceWithGroupMap;
 		typedef map<ResourceHandle, ResourcePtr>::type ResourceHandleMap;
     protected:
+		/// Index from interned name to the entry held in a ResourceMap
+		typedef HashMap< const String*, ResourcePtr* > ResourceIdMap;
+		typedef HashMap< String, ResourceIdMap > ResourceIdWithGroupMap;
+
         ResourceHandleMap mResourcesByHandle;
         ResourceMap mResources;
 		ResourceWithGroupMap mResourcesWithGroup;
+		ResourceIdMap mResourcesById;
+		ResourceIdWithGroupMap mResourcesWithGroupById;
+		/** Guards the maps above so lookups need not take the auto mutex.
+		@remarks
+			Lookups take it for reading only. Code that changes the maps holds 
+			the auto mutex as well and takes it for writing just around the 
+			change, so code already under the auto mutex may iterate freely.
+		*/
+		OGRE_RW_MUTEX(mResourcesMutex)
         ResourceHandle mNextHandle;
         size_t mMemoryBudget; // In bytes
         AtomicScalar<size_t> mMemoryUsage; // In bytes
@@ -40,6 +40,7 @@ Torus Knot Software Ltd.
 #include "OgreColourValue.h"
 #include "OgreCommon.h"
 #include "OgreSceneQuery.h"
+#include "OgreSweepAndPrune.h"
 #include "OgreAutoParamDataSource.h"
 #include "OgreAnimationState.h"
 #include "OgreRenderQueue.h"
@@ -423,6 +424,11 @@ namespace Ogre {
         */
         SceneNodeList mSceneNodes;
 
+		/** SceneNodes created by createAnonymousSceneNode, which are kept 
+			out of mSceneNodes and addressed by handle instead.
+		*/
+		SlotMap<SceneNode> mAnonymousSceneNodes;
+
         /// Camera in progress
         Camera* mCameraInProgress;
         /// Current Viewport
@@ -538,11 +544,24 @@ namespace Ogre {
 		struct MovableObjectCollection
 		{
 			MovableObjectMap map;
+			/// Objects created by createAnonymousMovableObject, addressed by handle
+			SlotMap<MovableObject> anonymous;
+			/// Distinguishes the names of anonymous objects of different types
+			uint32 anonymousId;
 			OGRE_MUTEX(mutex)
 		};
 		typedef map<String, MovableObjectCollection*>::type MovableObjectCollectionMap;
 		MovableObjectCollectionMap mMovableObjectCollectionMap;
 		NameGenerator mMovableNameGenerator;
+		/** Builds the name an anonymous object is known by in the maps of the
+			node it is attached to. These must be unique among siblings but are
+			never looked up, so they are made cheaply from the handle.
+		*/
+		static String makeAnonymousName(uint32 scope, const SlotHandle& handle);
+		/// Removes a node from the scene graph and deletes it
+		void deleteSceneNode(SceneNode* sn);
+		/// Adds a light to mTestLightInfos if it affects the camera's frustum
+		void testLightAffectingFrustum(Light* l, const Camera* camera);
 		/** Gets the movable object collection for the given type name.
 		@remarks
 			This method create new collection if the collection does not exist.
@@ -1297,6 +1316,37 @@ namespace Ogre {
             to delete the nodes when the scene is cleared.
         */
         virtual void destroySceneNode(SceneNode* sn);
+
+        /** Creates an instance of a SceneNode which is addressed by handle rather than by name.
+            @remarks
+                This behaves like createSceneNode, except that no name is generated and 
+                the node is not entered into the named node list, so it cannot be 
+                retrieved with getSceneNode(const String&). Instead, keep the handle 
+                returned by SceneNode::getHandle and use the handle overloads.
+            @par
+                Creating and destroying nodes this way costs O(1) and involves no 
+                string formatting, which matters when very many short-lived nodes 
+                are used. The node's name is an internal key which is unique among 
+                its siblings but has no other meaning.
+        */
+        virtual SceneNode* createAnonymousSceneNode(void);
+
+        /** Destroys a SceneNode created by createAnonymousSceneNode.
+            @remarks
+                Does nothing if the handle is stale, i.e. the node has already been 
+                destroyed.
+        */
+        virtual void destroySceneNode(const SlotHandle& handle);
+
+        /** Retrieves a SceneNode created by createAnonymousSceneNode.
+			@note Throws an exception if the handle is stale
+        */
+        virtual SceneNode* getSceneNode(const SlotHandle& handle) const;
+
+		/** Returns whether a handle refers to a live anonymous scene node.
+		*/
+		virtual bool hasSceneNode(const SlotHandle& handle) const;
+
         /** Gets the SceneNode at the root of the scene hierarchy.
             @remarks
                 The entire scene is held as a hierarchy of nodes, which
@@ -1358,6 +1408,24 @@ namespace Ogre {
         */
         virtual Entity* createEntity(const MeshPtr& pMesh);
 
+        /** Create an Entity (instance of a discrete mesh) addressed by handle rather than by name.
+            @see createAnonymousMovableObject
+            @param
+                meshName The name of the Mesh it is to be based on (e.g. 'knot.oof'). The
+                mesh will be loaded if it is not already.
+            @param
+                groupName The resource group the mesh belongs to.
+        */
+        virtual Entity* createAnonymousEntity(const String& meshName, 
+			const String& groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+
+        /** Create an Entity (instance of a discrete mesh) addressed by handle rather than by name.
+            @see createAnonymousMovableObject
+            @param
+                pMesh The pointer to the Mesh it is to be based on.
+        */
+        virtual Entity* createAnonymousEntity(const MeshPtr& pMesh);
+
         /** Prefab shapes available without loading a model.
             @note
                 Minimal implementation at present.
@@ -3257,6 +3325,29 @@ namespace Ogre {
 		the created object.
 		*/
 		virtual MovableObject* createMovableObject(const String& typeName, const NameValuePairList* params = 0);
+		/** Create a movable object of the type specified which is addressed by handle rather than by name.
+		@remarks
+			No name is generated and the object is not entered into the named 
+			collection for its type, so it cannot be retrieved with 
+			getMovableObject(const String&, const String&) or listed by 
+			getMovableObjectIterator; use the handle overloads and 
+			getAnonymousMovableObjectIterator for that.
+			Keep the handle returned by MovableObject::getHandle and use the 
+			handle overloads instead.
+		@par
+			Creating and destroying objects this way costs O(1) and involves no
+			string formatting, which matters when very many short-lived objects 
+			are used. The object's name is an internal key which is unique among 
+			objects attached to the same node but has no other meaning.
+		@note
+			Cameras always need a name; asking for an anonymous "Camera" creates
+			a normal, generated-name camera.
+		@param typeName The type of object to create
+		@param params Optional name/value pair list to give extra parameters to
+			the created object.
+		*/
+		virtual MovableObject* createAnonymousMovableObject(const String& typeName, 
+			const NameValuePairList* params = 0);
 		/** Destroys a MovableObject with the name specified, of the type specified.
 		@remarks
 			The MovableObject will automatically detach itself from any nodes
@@ -3269,6 +3360,12 @@ namespace Ogre {
 			on destruction.
 		*/
 		virtual void destroyMovableObject(MovableObject* m);
+		/** Destroys a MovableObject created by createAnonymousMovableObject.
+		@remarks
+			Does nothing if the handle is stale, i.e. the object has already been 
+			destroyed.
+		*/
+		virtual void destroyMovableObject(const SlotHandle& handle, const String& typeName);
 		/** Destroy all MovableObjects of a given type. */
 		virtual void destroyAllMovableObjectsByType(const String& typeName);
 		/** Destroy all MovableObjects. */
@@ -3286,6 +3383,20 @@ namespace Ogre {
 			if you are creating or deleting objects of this type in another thread.
 		*/
 		virtual MovableObjectIterator getMovableObjectIterator(const String& typeName);
+		/** Get a previously created anonymous MovableObject.
+		@note Throws an exception if the handle is stale
+		*/
+		virtual MovableObject* getMovableObject(const SlotHandle& handle, const String& typeName) const;
+		/** Returns whether a handle refers to a live anonymous movable object. */
+		virtual bool hasMovableObject(const SlotHandle& handle, const String& typeName) const;
+		typedef ConstVectorIterator<SlotMap<MovableObject>::ItemList> AnonymousMovableObjectIterator;
+		/** Get an iterator over the MovableObject instances of a given type 
+			created by createAnonymousMovableObject.
+		@note
+			The iterator returned from this method is not thread safe, do not use this
+			if you are creating or deleting objects of this type in another thread.
+		*/
+		virtual AnonymousMovableObjectIterator getAnonymousMovableObjectIterator(const String& typeName);
 		/** Inject a MovableObject instance created externally.
 		@remarks
 			This method 'injects' a MovableObject instance created externally into
@@ -3544,9 +3655,15 @@ namespace Ogre {
         void _handleLodEvents();
     };
 
-    /** Default implementation of IntersectionSceneQuery. */
+    /** Default implementation of IntersectionSceneQuery.
+	@remarks
+		Candidate pairs are found with a SweepAndPrune broad phase over the movable
+		objects passing the query masks, rather than by testing every object against 
+		every other one. Subclasses can change which objects take part by overriding 
+		addObjectsToBroadPhase, and which pairs are reported by overriding acceptPair.
+	*/
     class _OgreExport DefaultIntersectionSceneQuery : 
-        public IntersectionSceneQuery
+        public IntersectionSceneQuery, protected SweepAndPrune::Listener
     {
     public:
         DefaultIntersectionSceneQuery(SceneManager* creator);
@@ -3554,6 +3671,21 @@ namespace Ogre {
 
         /** See IntersectionSceneQuery. */
         void execute(IntersectionSceneQueryListener* listener);
+
+	protected:
+		/// Kept between executions so its storage is reused
+		SweepAndPrune mBroadPhase;
+		/// Listener of the execution in progress
+		IntersectionSceneQueryListener* mListener;
+
+		/** Adds the movable objects of the scene manager passing the query masks
+			to mBroadPhase. */
+		virtual void addObjectsToBroadPhase(void);
+		/** Tells whether a pair of objects with overlapping bounds is reported,
+			always true by default. */
+		virtual bool acceptPair(MovableObject* a, MovableObject* b) { return true; }
+		/// @copydoc SweepAndPrune::Listener::overlapFound
+		bool overlapFound(MovableObject* a, MovableObject* b);
     };
 
     /** Default implementation of RaySceneQuery. */
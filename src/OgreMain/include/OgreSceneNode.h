@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreNode.h"
 #include "OgreIteratorWrappers.h"
 #include "OgreAxisAlignedBox.h"
+#include "OgreSlotMap.h"
 
 namespace Ogre {
 
@@ -72,6 +73,8 @@ namespace Ogre {
 
         /// SceneManager which created this node
         SceneManager* mCreator;
+		/// Handle in the creator, if created by SceneManager::createAnonymousSceneNode
+		SlotHandle mHandle;
 
         /// World-Axis aligned bounding box, updated only through _update
         AxisAlignedBox mWorldAABB;
@@ -246,6 +249,17 @@ namespace Ogre {
         */
         SceneManager* getCreator(void) const { return mCreator; }
 
+		/** Gets the handle of this node in its creator.
+		@remarks
+			This is null unless the node was created with 
+			SceneManager::createAnonymousSceneNode, in which case it can be 
+			used to look the node up again instead of its name.
+		*/
+		const SlotHandle& getHandle(void) const { return mHandle; }
+
+		/** Sets the handle of this node in its creator (internal use only) */
+		void _notifyHandle(const SlotHandle& handle) { mHandle = handle; }
+
         /** This method removes and destroys the named child and all of its children.
         @remarks
             Unlike removeChild, which removes a single named child from this
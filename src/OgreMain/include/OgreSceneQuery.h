@@ -362,6 +362,13 @@ namespace Ogre {
         MovableObject* movable;
         /// The world fragment, or NULL if this is not a fragment result
         SceneQuery::WorldFragment* worldFragment;
+        /** Index of the triangle hit in its SubMesh, or NO_TRIANGLE if the result 
+            was not refined to triangles. @see RaySceneQuery::setQueryTriangles */
+        size_t triangleIndex;
+        /// Index of the SubMesh of the triangle hit, if triangleIndex is set
+        unsigned short subMeshIndex;
+        /// Value of triangleIndex for results which didn't hit a triangle
+        static const size_t NO_TRIANGLE = ~(size_t)0;
         /// Comparison operator for sorting
         bool operator < (const RaySceneQueryResultEntry& rhs) const
         {
@@ -370,6 +377,8 @@ namespace Ogre {
 
     };
     typedef vector<RaySceneQueryResultEntry>::type RaySceneQueryResult;
+    typedef vector<RaySceneQueryResult>::type RaySceneQueryResultList;
+    typedef vector<Ray>::type RayList;
 
     /** Specialises the SceneQuery class for querying along a ray. */
     class _OgreExport RaySceneQuery : public SceneQuery, public RaySceneQueryListener
@@ -379,6 +388,9 @@ namespace Ogre {
         bool mSortByDistance;
         ushort mMaxResults;
         RaySceneQueryResult mResult;
+        bool mQueryTriangles;
+        /// Copies of the world fragments in the results of the last executeBatch
+        list<SceneQuery::WorldFragment>::type mBatchWorldFragments;
 
     public:
         RaySceneQuery(SceneManager* mgr);
@@ -411,6 +423,45 @@ namespace Ogre {
         /** Gets the maximum number of results returned from the query (only relevant if 
         results are being sorted) */
         virtual ushort getMaxResults(void) const;
+        /** Sets whether the results on Entity objects are refined to the triangles
+            of their mesh.
+        @remarks
+            When enabled, the version of execute returning a collection and executeBatch
+            intersect the ray with the triangles of each Entity whose bounds it hits, 
+            using Mesh::getTriangleBVH. Entities whose triangles are missed are removed
+            from the results; for the others the distance is the exact distance to the
+            nearest triangle, which is identified by RaySceneQueryResultEntry::triangleIndex
+            and subMeshIndex. Sorting and the maximum number of results then apply to
+            these distances. Other movables and world fragments are left as they are.
+        @par
+            Animation is not taken into account, animated entities are tested in 
+            their bind pose. The listener version of execute is not affected.
+        */
+        virtual void setQueryTriangles(bool triangles);
+        /** Gets whether the results are refined to triangles. */
+        virtual bool getQueryTriangles(void) const;
+        /** Executes the query for many rays at once.
+        @remarks
+            Gives the same results as setting each ray in turn and calling the version
+            of execute returning a collection, but the rays are shared among threads
+            with WorkQueue::defaultParallelFor. Each thread traverses the scene with its
+            own query created by the scene manager, so the spatial structure of the
+            scene manager is used; when refining to triangles, the meshes missing their
+            triangle hierarchy get it built from the calling thread first and the 
+            triangles are then tested in parallel too.
+        @par
+            The scene must not be modified while this runs, and must have been updated 
+            since it was last modified (as it is after rendering a frame, or after 
+            SceneManager::_updateSceneGraph) since cached bounds and transforms are used.
+            Settings specific to a scene manager's query class are not passed on to the
+            queries of the threads.
+        @par
+            The world fragments in the results are copies held by this query, they 
+            stay valid until executeBatch is called again or this query is destroyed.
+        @param rays The rays to query
+        @param results Receives the results of each ray, in the same order
+        */
+        virtual void executeBatch(const RayList& rays, RaySceneQueryResultList& results);
         /** Executes the query, returning the results back in one list.
         @remarks
             This method executes the scene query as configured, gathers the results
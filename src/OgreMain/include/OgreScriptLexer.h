@@ -75,6 +75,26 @@ namespace Ogre {
 	typedef vector<ScriptTokenPtr>::type ScriptTokenList;
 	typedef SharedPtr<ScriptTokenList> ScriptTokenListPtr;
 
+	/** This struct represents a token which refers to its lexeme in the 
+		parsing input, rather than holding a copy of it.
+	@remarks
+		Tokenizing into these needs no allocations per token. The lexeme of
+		a quote which contains escaped quotes differs from the input text, 
+		so use ScriptLexer::getLexeme rather than reading the text directly.
+	*/
+	struct ScriptTokenRef
+	{
+		/// The offset of the lexeme in the input
+		uint32 offset;
+		/// The length of the lexeme in the input
+		uint32 length;
+		/// This is the id associated with the lexeme, which comes from a lexeme-token id mapping
+		uint32 type;
+		/// This holds the line number of the input stream where the token was found.
+		uint32 line;
+	};
+	typedef vector<ScriptTokenRef>::type ScriptTokenRefList;
+
 	class _OgreExport ScriptLexer : public ScriptCompilerAlloc
 	{
 	public:
@@ -83,8 +103,16 @@ namespace Ogre {
 
 		/** Tokenizes the given input and returns the list of tokens found */
 		ScriptTokenListPtr tokenize(const String &str, const String &source);
+		/** Tokenizes the given input into a flat list of tokens which refer 
+			into it, so the input must outlive the tokens.
+		*/
+		void tokenize(const String &str, ScriptTokenRefList &tokens);
+		/** Gets the lexeme of a token from a flat list, as tokenize would have
+			stored it in a ScriptToken.
+		*/
+		static String getLexeme(const String &str, const ScriptTokenRef &token);
 	private: // Private utility operations
-		void setToken(const String &lexeme, uint32 line, const String &source, ScriptTokenList *tokens);
+		void setToken(const String &str, size_t offset, size_t length, uint32 line, ScriptTokenRefList &tokens);
 		bool isWhitespace(Ogre::String::value_type c) const;
 		bool isNewline(Ogre::String::value_type c) const;
 	};
@@ -51,9 +51,15 @@ namespace Ogre {
 
 		ConcreteNodeListPtr parse(const ScriptTokenListPtr &tokens);
 		ConcreteNodeListPtr parseChunk(const ScriptTokenListPtr &tokens);
-	private:
-		ScriptToken *getToken(ScriptTokenList::iterator i, ScriptTokenList::iterator end, int offset);
-		ScriptTokenList::iterator skipNewlines(ScriptTokenList::iterator i, ScriptTokenList::iterator end);
+		/** Parses a flat token list from ScriptLexer, avoiding the copies of 
+			each token that ScriptTokenList involves.
+		@param str The input the tokens refer to
+		@param tokens The tokens from ScriptLexer::tokenize
+		@param source The name of the input, stored in the nodes
+		*/
+		ConcreteNodeListPtr parse(const String &str, const ScriptTokenRefList &tokens, const String &source);
+		/** Parses a flat token list from ScriptLexer as a chunk, see parse. */
+		ConcreteNodeListPtr parseChunk(const String &str, const ScriptTokenRefList &tokens, const String &source);
 	};
 	
 	/** @} */
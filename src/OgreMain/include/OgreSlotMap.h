@@ -0,0 +1,209 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SlotMap_H__
+#define __SlotMap_H__
+
+#include "OgrePrerequisites.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup General
+	*  @{
+	*/
+	/** Handle to an item held in a SlotMap.
+	@remarks
+		A handle is a slot index plus the generation of that slot at the time
+		the item was inserted. Slots are reused once their item is erased, but 
+		the generation is bumped, so a stale handle never resolves to the new 
+		occupant. The default constructed handle is null and never resolves.
+	*/
+	struct SlotHandle
+	{
+		uint32 index;
+		uint32 generation;
+
+		SlotHandle() : index(0), generation(0) {}
+		SlotHandle(uint32 idx, uint32 gen) : index(idx), generation(gen) {}
+
+		bool isNull(void) const { return generation == 0; }
+		bool operator==(const SlotHandle& rhs) const
+		{ return index == rhs.index && generation == rhs.generation; }
+		bool operator!=(const SlotHandle& rhs) const
+		{ return !(*this == rhs); }
+		bool operator<(const SlotHandle& rhs) const
+		{ return index < rhs.index || (index == rhs.index && generation < rhs.generation); }
+	};
+
+	/** Container of pointers addressed by generational handles.
+	@remarks
+		Insertion, lookup and removal are all O(1) and involve no hashing or
+		tree rebalancing, which makes this suitable for large numbers of 
+		short-lived objects which don't need to be found by name. 
+	@par
+		Items are kept packed in a contiguous array (removal moves the last
+		item into the hole), so iterating over getItems() is as cheap as 
+		iterating over a vector. The order of items is not stable across 
+		removals. The container does not own the items.
+	*/
+	template <typename T>
+	class SlotMap
+	{
+	public:
+		typedef typename vector<T*>::type ItemList;
+
+	protected:
+		struct Slot
+		{
+			/// Position of the item in mItems, or VACANT
+			uint32 item;
+			/// Incremented each time the slot is vacated, starts at 1
+			uint32 generation;
+		};
+		typedef typename vector<Slot>::type SlotList;
+		typedef typename vector<uint32>::type IndexList;
+
+		/// Item position of a slot which holds nothing
+		static const uint32 VACANT = 0xFFFFFFFF;
+
+		SlotList mSlots;
+		/// Packed items
+		ItemList mItems;
+		/// Slot index of each packed item
+		IndexList mItemSlots;
+		/// Vacant slots, reused last in first out
+		IndexList mFreeSlots;
+
+	public:
+		/// Add an item and return the handle that refers to it
+		SlotHandle insert(T* item)
+		{
+			uint32 index;
+			if (mFreeSlots.empty())
+			{
+				index = static_cast<uint32>(mSlots.size());
+				Slot slot = { VACANT, 1 };
+				mSlots.push_back(slot);
+			}
+			else
+			{
+				index = mFreeSlots.back();
+				mFreeSlots.pop_back();
+			}
+			Slot& slot = mSlots[index];
+			slot.item = static_cast<uint32>(mItems.size());
+			mItems.push_back(item);
+			mItemSlots.push_back(index);
+			return SlotHandle(index, slot.generation);
+		}
+
+		/// Get the handle the next call to insert will return
+		SlotHandle nextHandle(void) const
+		{
+			if (mFreeSlots.empty())
+				return SlotHandle(static_cast<uint32>(mSlots.size()), 1);
+			uint32 index = mFreeSlots.back();
+			return SlotHandle(index, mSlots[index].generation);
+		}
+
+		/// Get the item referred to by a handle, or null if it is stale
+		T* get(const SlotHandle& handle) const
+		{
+			return contains(handle) ? mItems[mSlots[handle.index].item] : 0;
+		}
+
+		/// Does the handle refer to a live item?
+		bool contains(const SlotHandle& handle) const
+		{
+			// A vacant slot already carries the generation its next item will
+			// get, so a handle from nextHandle() must not resolve until then
+			if (handle.index >= mSlots.size())
+				return false;
+			const Slot& slot = mSlots[handle.index];
+			return slot.item != VACANT && slot.generation == handle.generation;
+		}
+
+		/** Remove the item referred to by a handle.
+		@returns The item that was removed, or null if the handle was stale.
+		*/
+		T* erase(const SlotHandle& handle)
+		{
+			if (!contains(handle))
+				return 0;
+
+			Slot& slot = mSlots[handle.index];
+			uint32 pos = slot.item;
+			T* ret = mItems[pos];
+
+			// Fill the hole with the last item
+			uint32 last = static_cast<uint32>(mItems.size() - 1);
+			if (pos != last)
+			{
+				mItems[pos] = mItems[last];
+				mItemSlots[pos] = mItemSlots[last];
+				mSlots[mItemSlots[pos]].item = pos;
+			}
+			mItems.pop_back();
+			mItemSlots.pop_back();
+			slot.item = VACANT;
+
+			// Invalidate outstanding handles, skipping 0 which means null
+			if (++slot.generation == 0)
+				slot.generation = 1;
+			mFreeSlots.push_back(handle.index);
+			return ret;
+		}
+
+		/// Get the handle of the item at a position in getItems()
+		SlotHandle getHandle(size_t pos) const
+		{
+			uint32 index = mItemSlots[pos];
+			return SlotHandle(index, mSlots[index].generation);
+		}
+
+		/// The packed list of live items, in no particular order
+		const ItemList& getItems(void) const { return mItems; }
+
+		size_t size(void) const { return mItems.size(); }
+		bool empty(void) const { return mItems.empty(); }
+
+		/// Remove all items, invalidating all handles
+		void clear(void)
+		{
+			while (!mItems.empty())
+				erase(getHandle(mItems.size() - 1));
+		}
+	};
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -54,14 +54,23 @@ namespace Ogre
 		potential skipping. 
 	@par
 		The data format of a chunk is as follows:
-		-# Chunk ID (32-bit uint). This can be any number unique in a context, except the numbers 0x0000, 0x0001 and 0x1000, which are reserved for Ogre's use
-		-# Chunk version (16-bit uint). Chunks can change over time so this version number reflects that
+		-# Chunk ID (32-bit uint). This can be any number unique in a context, except the numbers 0x0000 to 0x0003 and 0x1000, which are reserved for Ogre's use
+		-# Chunk version (16-bit uint). Chunks can change over time so this version number reflects that.
+			The top bit is reserved, and is set when the chunk data is compressed.
 		-# Length (32-bit uint). The length of the chunk data section, including nested chunks. Note that
 			this length excludes this header, but includes the header of any nested chunks. 
 		-# Checksum (32-bit uint). Checksum value generated from the above - basically lets us check this is a valid chunk.
 		-# Chunk data
 		The 'Chunk data' section will contain chunk-specific data, which may include
-		other nested chunks.
+		other nested chunks. If the chunk is compressed, the data section holds
+		the uncompressed size (32-bit uint) followed by the zlib compressed data,
+		which is inflated transparently when the chunk is read.
+	@par
+		A writer can also finish the stream with a chunk directory, listing the
+		id, version, length and offset of every top-level chunk, followed by a
+		fixed-size locator chunk pointing at the directory. Readers on seekable
+		streams can then use seekToChunk to jump straight to a chunk rather than
+		scanning through everything before it.
 	*/
 	class _OgreExport StreamSerialiser : public StreamAlloc
 	{
@@ -98,9 +107,13 @@ namespace Ogre
 			uint32 length;
 			/// Location of the chunk (header) in bytes from the start of a stream (derived)
 			uint32 offset;
+			/// Whether the chunk data is compressed (stored in the top bit of the version)
+			bool compressed;
 
-			Chunk() : id(0), version(1), length(0), offset(0) {}
+			Chunk() : id(0), version(1), length(0), offset(0), compressed(false) {}
 		};
+		/// List of top-level chunks, in the order they appear in the stream
+		typedef vector<Chunk>::type ChunkDirectory;
 
 		/** Constructor.
 		@param stream The stream on which you will read / write data.
@@ -241,15 +254,55 @@ namespace Ogre
 		@param id The identifier of the new chunk. Any value that's unique in the
 			file context is valid, except for the numbers 0x0001 and 0x1000 which are reserved
 			for internal header identification use. 
-		@param version The version of the chunk you're writing
+		@param version The version of the chunk you're writing, which must be
+			less than 0x8000
+		@param compress If true, the data of this chunk (including any nested chunks)
+			is buffered and written zlib compressed when writeChunkEnd is called.
+			Reading a compressed chunk is no different to reading any other chunk.
 		*/
-		virtual void writeChunkBegin(uint32 id, uint16 version = 1);
+		virtual void writeChunkBegin(uint32 id, uint16 version = 1, bool compress = false);
 		/** End writing a chunk. 
 		@param id The identifier of the chunk - this is really just a safety check, 
 			since you can only end the chunk you most recently started.
 		*/
 		virtual void writeChunkEnd(uint32 id);
 
+		/** Write a directory of all the top-level chunks written so far.
+		@remarks
+			Call this once you have finished writing the stream. The directory
+			and a small locator chunk are appended, which allow readers to use
+			seekToChunk rather than reading through the stream sequentially.
+			Readers which do not use the directory simply see two more chunks.
+		*/
+		virtual void writeChunkDirectory();
+
+		/** Read the chunk directory from the end of the stream, if there is one.
+		@remarks
+			The stream must be seekable and of known size. The stream position
+			is left unchanged. This is called automatically by seekToChunk.
+		@return Whether a chunk directory was found
+		*/
+		virtual bool readChunkDirectory();
+
+		/** Get the chunk directory.
+		@remarks
+			When writing, this lists the top-level chunks written so far. When 
+			reading, it is only populated once readChunkDirectory has been called.
+		*/
+		virtual const ChunkDirectory& getChunkDirectory() const { return mChunkDirectory; }
+
+		/** Position the stream at the start of a top-level chunk, using the 
+			chunk directory.
+		@remarks
+			If this returns true, the next call to readChunkBegin will read the
+			requested chunk. No chunk may be open when you call this.
+		@param id The id of the chunk to find
+		@param index Which of the chunks with this id to find, if there are several
+		@return True if the chunk was found, false if it was not or the stream 
+			has no chunk directory
+		*/
+		virtual bool seekToChunk(uint32 id, size_t index = 0);
+
 		/** Write arbitrary data to a stream. 
 		@param buf Pointer to bytes
 		@param size The size of each element to write; each will be endian-flipped if
@@ -285,6 +338,9 @@ namespace Ogre
 
 
 		/** Read arbitrary data from a stream. 
+		@remarks
+			Data is read straight into the buffer you supply, with no intermediate
+			copies; endian flipping, if needed, is done in place.
 		@param buf Pointer to bytes
 		@param size The size of each element to read; each will be endian-flipped if
 		necessary
@@ -327,13 +383,28 @@ namespace Ogre
 		typedef deque<Chunk*>::type ChunkStack;
 		/// Current list of open chunks
 		ChunkStack mChunkStack;
+		typedef deque<DataStreamPtr>::type StreamStack;
+		/// Streams suspended while the data of a compressed chunk is processed
+		StreamStack mStreamStack;
+		/// Top-level chunks written, or read from the chunk directory
+		ChunkDirectory mChunkDirectory;
+		bool mChunkDirectoryRead;
 
 		static uint32 HEADER_ID;
 		static uint32 REVERSE_HEADER_ID;
+		static uint32 DIRECTORY_ID;
+		static uint32 DIRECTORY_LOCATOR_ID;
 		static uint32 CHUNK_HEADER_SIZE;
+		static uint16 COMPRESSED_VERSION_FLAG;
 
 		virtual Chunk* readChunkImpl();
-		virtual void writeChunkImpl(uint32 id, uint16 version);
+		virtual void writeChunkImpl(uint32 id, uint16 version, bool compressed = false);
+		/// Swap in a stream holding the inflated data of a compressed chunk
+		virtual void beginCompressedRead(Chunk* c);
+		/// Compress the buffered data of a chunk and write it to the real stream
+		virtual void endCompressedWrite(Chunk* c);
+		/// Restore the stream which was suspended for a compressed chunk
+		virtual DataStreamPtr popStream();
 		virtual void readHeader();
 		virtual void writeHeader();
 		virtual uint32 calculateChecksum(Chunk* c);
@@ -59,9 +59,14 @@ namespace Ogre {
         class.
     @par
         The String formats of each of the major types is listed with the methods. The basic types
-        like int and Real just use the underlying C runtime library atof and atoi family methods,
+        like int and Real are formatted and parsed as a standard stream would with default flags,
         however custom types like Vector3, ColourValue and Matrix4 are also supported by this class
         using custom formats.
+    @par
+        Since this class sits on hot paths like script parsing, the common cases are handled 
+        without constructing streams or temporary strings, and independently of the C locale. 
+        Only unusual requests (formatting flags, very long or out of range numbers) fall back 
+        to the standard streams.
     @author
         Steve Streeting
     */
@@ -0,0 +1,113 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SweepAndPrune_H__
+#define __SweepAndPrune_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Scene
+	*  @{
+	*/
+	/** Broad phase finding all the pairs of overlapping bounding boxes in a set
+		of movable objects.
+	@remarks
+		The boxes are sorted along the axis on which they are the most spread out,
+		then swept in order so that each box is only compared with the boxes whose
+		extent along that axis overlaps its own. This is O(N*logN + K) for K 
+		overlapping pairs rather than the O(N^2) of comparing every object with
+		every other one, which makes intersection queries usable on scenes of tens 
+		of thousands of objects.
+	@par
+		Boxes are copied when objects are added, so the objects must not move 
+		between adding them and calling findOverlaps. The storage is kept between
+		uses, so a query executed every frame should keep its instance around and
+		call clear rather than creating a new one.
+	*/
+	class _OgreExport SweepAndPrune : public SceneMgtAlloc
+	{
+	public:
+		/** Receives the pairs found by SweepAndPrune::findOverlaps. */
+		class _OgreExport Listener
+		{
+		public:
+			virtual ~Listener() {}
+			/** Called for each pair of objects whose bounding boxes overlap.
+			@return false to stop looking for more pairs
+			*/
+			virtual bool overlapFound(MovableObject* a, MovableObject* b) = 0;
+		};
+
+		SweepAndPrune();
+		~SweepAndPrune();
+
+		/** Removes all the objects, keeping the storage allocated. */
+		void clear(void);
+		/** Adds an object using its world bounding box. */
+		void addObject(MovableObject* obj);
+		/** Adds an object with a given bounding box.
+		@remarks
+			Null boxes never overlap anything and are ignored, infinite boxes 
+			overlap everything.
+		*/
+		void addObject(MovableObject* obj, const AxisAlignedBox& box);
+		/** Gets the number of objects added since the last clear. */
+		size_t getObjectCount(void) const { return mEntries.size() + mInfinite.size(); }
+
+		/** Reports every overlapping pair of objects once.
+		@return false if the listener stopped the search
+		*/
+		bool findOverlaps(Listener* listener);
+
+	protected:
+		struct Entry
+		{
+			Vector3 minimum;
+			Vector3 maximum;
+			MovableObject* object;
+		};
+		typedef vector<Entry>::type EntryList;
+		typedef vector<MovableObject*>::type MovableObjectList;
+
+		EntryList mEntries;
+		MovableObjectList mInfinite;
+		/// Sums of the box centres and of their squares, to pick the sweep axis
+		Vector3 mCentreSum;
+		Vector3 mCentreSquaredSum;
+	};
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TriangleBVH_H__
+#define __TriangleBVH_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreRay.h"
+
+namespace Ogre {
+
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Math
+	*  @{
+	*/
+	/** Bounding volume hierarchy over the triangles of a mesh, for exact ray
+		intersections.
+	@remarks
+		The hierarchy is built once from the positions of the triangles, split
+		along the surface area heuristic, and only read afterwards: intersecting
+		rays with it from several threads at once is safe.
+	@par
+		Triangles are identified by the index of the SubMesh they come from and 
+		their index within that SubMesh, counting in triangles rather than in 
+		indexes, including for strips and fans.
+	@see Mesh::getTriangleBVH
+	*/
+	class _OgreExport TriangleBVH : public GeometryAllocatedObject
+	{
+	public:
+		/** Details of a ray hitting a triangle. */
+		struct Hit
+		{
+			/// Distance along the ray
+			Real distance;
+			/// Index of the SubMesh the triangle comes from
+			unsigned short subMeshIndex;
+			/// Index of the triangle in its SubMesh
+			size_t triangleIndex;
+			/** Barycentric coordinates of the hit point, weights of the second and 
+				third vertices of the triangle */
+			Real u, v;
+		};
+
+		TriangleBVH();
+		~TriangleBVH();
+
+		/** Builds the hierarchy from the level of detail 0 of a mesh.
+		@remarks
+			The vertex and index buffers are read back, so they must either have 
+			shadow buffers or not be write only. Only triangle lists, strips and fans
+			are used. Skeletal, morph and pose animation aren't taken into account.
+		*/
+		void build(const Mesh* mesh);
+		/** Builds the hierarchy from triangles given by their vertices.
+		@param positions Three positions per triangle
+		@param subMeshIndices SubMesh index of each triangle, or null for all 0
+		@param triangleIndices Index of each triangle in its SubMesh, or null to 
+			number them in order
+		@param numTriangles Number of triangles
+		*/
+		void build(const Vector3* positions, const unsigned short* subMeshIndices, 
+			const size_t* triangleIndices, size_t numTriangles);
+		/** Removes all the triangles. */
+		void clear(void);
+
+		/** Finds the nearest triangle hit by a ray, hitting either side of the triangles.
+		@param ray The ray, in the space the positions were given in
+		@param hit Details of the hit, only written when a triangle is hit
+		@param maxDistance Triangles further than this along the ray are ignored
+		@return true if a triangle was hit
+		*/
+		bool intersects(const Ray& ray, Hit& hit, Real maxDistance = Math::POS_INFINITY) const;
+
+		/** Gets the number of triangles. */
+		size_t getTriangleCount(void) const { return mTriangles.size(); }
+		/** Gets the number of nodes of the hierarchy. */
+		size_t getNodeCount(void) const { return mNodes.size(); }
+		/** Gets the box bounding all the triangles. */
+		AxisAlignedBox getBounds(void) const;
+		/** Gets the memory used, in bytes. */
+		size_t getMemoryUsage(void) const;
+
+	protected:
+		struct Node
+		{
+			Vector3 minimum;
+			Vector3 maximum;
+			/// First triangle for leaves, index of the first child for inner nodes
+			uint32 first;
+			/// Number of triangles for leaves, 0 for inner nodes
+			uint32 count;
+		};
+		struct Triangle
+		{
+			Vector3 v0;
+			/// Edges from v0 to the two other vertices
+			Vector3 edge1;
+			Vector3 edge2;
+			size_t triangleIndex;
+			unsigned short subMeshIndex;
+		};
+		typedef vector<Node>::type NodeList;
+		typedef vector<Triangle>::type TriangleList;
+
+		NodeList mNodes;
+		TriangleList mTriangles;
+
+		/// Splits a node in two if it pays off, recursively
+		void subdivide(size_t nodeIndex, vector<Vector3>::type& centroids, size_t depth);
+		/// Recomputes the bounds of a node from its triangles
+		void updateBounds(Node& node) const;
+	};
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreAtomicWrappers.h"
 #include "OgreAny.h"
 #include "OgreSharedPtr.h"
+#include "OgreDataStream.h"
 
 namespace Ogre
 {
@@ -73,6 +74,8 @@ namespace Ogre
 		ChannelMap mChannelMap;
 		uint16 mNextChannel;
 		OGRE_MUTEX(mChannelMapMutex)
+		/// Limit on the threads a parallelFor uses, 0 for no limit
+		size_t mMaxParallelism;
 	public:
 		/// Numeric identifier for a request
 		typedef unsigned long long int RequestID;
@@ -217,7 +220,21 @@ namespace Ogre
 			virtual void handleResponse(const Response* res, const WorkQueue* srcQ) = 0;
 		};
 
-		WorkQueue() : mNextChannel(0) {}
+		/** Interface to a loop which parallelFor can split across threads.
+		@remarks
+			The iterations must be independent of each other, since they run in
+			no particular order and on any thread.
+		*/
+		class _OgreExport ParallelTask
+		{
+		public:
+			virtual ~ParallelTask() {}
+			/// Run the iterations from begin up to, but not including, end
+			virtual void execute(size_t begin, size_t end) = 0;
+		};
+
+		WorkQueue() : mNextChannel(0), mMaxParallelism(0), mParallelForChannel(0), 
+			mParallelForRegistered(false), mAsyncReadChannel(0), mAsyncReadRegistered(false) {}
 		virtual ~WorkQueue() {}
 
 		/** Start up the queue with the options that have been set.
@@ -338,6 +355,92 @@ namespace Ogre
 		*/
 		virtual uint16 getChannel(const String& channelName);
 
+		/** Run a loop on the calling thread and on this queue's worker threads,
+			returning once every iteration has run.
+		@remarks
+			The iterations are handed out grainSize at a time to whichever 
+			thread asks next, the caller included. The caller never waits for a 
+			range which no thread has started, so this may be called from a 
+			request handler of this queue without deadlocking, even if every 
+			worker is busy. In that case, or without worker threads running, 
+			the caller simply runs the whole loop.
+		@par
+			Helper requests are sent on the "Ogre/ParallelFor" channel; their
+			responses carry nothing and are discarded by processResponses as usual.
+			An exception thrown by the task on the calling thread is passed on
+			once the other threads are done; one thrown on a worker thread is
+			reported as an ERR_INTERNAL_ERROR.
+		@param task The loop body
+		@param count The number of iterations
+		@param grainSize The number of iterations handed out at a time, which 
+			should be enough to take much longer than handing them out
+		*/
+		void parallelFor(ParallelTask& task, size_t count, size_t grainSize = 1);
+
+		/** Run parallelFor on Root's work queue, or the whole loop on the calling 
+			thread if there is no Root.
+		@remarks
+			For code which may run with or without Root, such as image conversion.
+		*/
+		static void defaultParallelFor(ParallelTask& task, size_t count, size_t grainSize = 1);
+
+		/** Limit the number of threads, the caller included, parallelFor splits a
+			loop across.
+		@remarks
+			This is the only setting for the concurrency of parallel loops in 
+			OGRE, such as image scaling, texture compression and terrain normal
+			calculation. 0, the default, uses every worker thread.
+		*/
+		void setMaxParallelism(size_t threads) { mMaxParallelism = threads; }
+		/// Get the limit set by setMaxParallelism
+		size_t getMaxParallelism() const { return mMaxParallelism; }
+
+		/** Carry out a read made with DataStream::readAsync on one of this 
+			queue's worker threads.
+		@remarks
+			Reads are sent on the "Ogre/AsyncRead" channel, and complete on the 
+			worker thread. A read still waiting when the queue shuts down 
+			completes without reading anything, at the latest when the queue 
+			is destroyed.
+		@return false, having done nothing, if no worker threads are running
+		*/
+		bool readAsync(const AsyncReadRequestPtr& request);
+
+		/** Carry out a read on Root's work queue, or on the calling thread if 
+			there is no Root or its queue has no worker threads running.
+		@remarks
+			Used by the file streams to implement DataStream::readAsync.
+		*/
+		static void defaultReadAsync(const AsyncReadRequestPtr& request);
+
+	protected:
+		/// Runs ranges of parallelFor loops on the worker threads
+		class _OgreExport ParallelForHandler : public RequestHandler
+		{
+		public:
+			Response* handleRequest(const Request* req, const WorkQueue* srcQ);
+		};
+		ParallelForHandler mParallelForHandler;
+		uint16 mParallelForChannel;
+		bool mParallelForRegistered;
+
+		/// Carries out DataStream reads on the worker threads
+		class _OgreExport AsyncReadHandler : public RequestHandler
+		{
+		public:
+			/// Aborted reads are taken too, to complete them without reading
+			bool canHandleRequest(const Request* req, const WorkQueue* srcQ) { return true; }
+			Response* handleRequest(const Request* req, const WorkQueue* srcQ);
+		};
+		AsyncReadHandler mAsyncReadHandler;
+		uint16 mAsyncReadChannel;
+		bool mAsyncReadRegistered;
+
+		/** Get the number of worker threads which are running and may take part
+			in a parallelFor, 0 if requests are not processed in the background.
+		*/
+		virtual size_t getParallelWorkerCount() const { return 0; }
+
 	};
 
 	/** Base for a general purpose request / response style background work queue.
@@ -439,6 +542,9 @@ namespace Ogre
 		/// @copydoc WorkQueue::setResponseProcessingTimeLimit
 		virtual void setResponseProcessingTimeLimit(unsigned long ms) { mResposeTimeLimitMS = ms; }
 	protected:
+		/// @copydoc WorkQueue::getParallelWorkerCount
+		virtual size_t getParallelWorkerCount() const;
+
 		String mName;
 		size_t mWorkerThreadCount;
 		bool mWorkerRenderSystemAccess;
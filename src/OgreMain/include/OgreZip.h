@@ -46,11 +46,22 @@ namespace Ogre {
 	/** \addtogroup Resources
 	*  @{
 	*/
+	class ZipMapping;
+
 	/** Specialisation of the Archive class to allow reading of files from a zip
         format source archive.
     @remarks
         This archive format supports all archives compressed in the standard
         zip format, including iD pk3 files.
+	@par
+		Archives on disk are read natively: the file is memory mapped and the
+		central directory is indexed by name when the archive is loaded.
+		Stored entries are then opened as streams straight onto the mapping,
+		and deflated entries are inflated into memory by the calling thread,
+		so open() takes no lock and several threads may open files from the
+		same archive at once. Only stored and deflated entries of 
+		non-encrypted, non-Zip64 archives are supported this way. Archives 
+		using alternative file io (EmbeddedZip) are still read with zziplib.
     */
     class _OgreExport ZipArchive : public Archive 
     {
@@ -64,6 +75,32 @@ namespace Ogre {
         /// A pointer to file io alternative implementation 
         zzip_plugin_io_handlers* mPluginIo;
 
+		/// Central directory entry of a natively read archive
+		struct ZipEntry
+		{
+			String filename;
+			size_t localHeaderOffset;
+			size_t compressedSize;
+			size_t uncompressedSize;
+			uint16 method;
+			uint16 flags;
+		};
+		typedef vector<ZipEntry>::type ZipEntryList;
+		/// Lower case file name to index in mEntries
+		typedef HashMap<String, size_t> ZipEntryIndex;
+
+		/// The mapped archive, when read natively
+		SharedPtr<ZipMapping> mMapping;
+		ZipEntryList mEntries;
+		ZipEntryIndex mEntryIndex;
+
+		/// Reads the central directory of the mapped archive
+		void loadNative(void);
+		/// Finds an entry by name, or by unique base name if that fails
+		const ZipEntry* findEntry(const String& filename) const;
+		/// Opens an entry of the mapped archive
+		DataStreamPtr openNative(const String& filename) const;
+
 		OGRE_AUTO_MUTEX
     public:
         ZipArchive(const String& name, const String& archType, zzip_plugin_io_handlers* pluginIo = NULL);
@@ -104,6 +141,12 @@ namespace Ogre {
 
 		/// @copydoc Archive::getModifiedTime
 		time_t getModifiedTime(const String& filename);
+
+		/// @copydoc Archive::prefetch
+		void prefetch(const StringVector& filenames);
+
+		/// @copydoc Archive::getStorageOrder
+		uint64 getStorageOrder(const String& filename);
     };
 
     /** Specialisation of ArchiveFactory for Zip files. */
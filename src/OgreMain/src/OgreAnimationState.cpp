@@ -250,8 +250,9 @@ namespace Ogre
 			i != rhs.mAnimationStates.end(); ++i)
 		{
 			AnimationState* src = i->second;
-			mAnimationStates[src->getAnimationName()] = 
-				OGRE_NEW AnimationState(this, *src);
+			AnimationState* newState = OGRE_NEW AnimationState(this, *src);
+			mAnimationStates[src->getAnimationName()] = newState;
+			mAnimationStatesById[IdString(src->getAnimationName())._getInterned()] = newState;
 		}
 
         // Clone enabled animation state list
@@ -278,6 +279,7 @@ namespace Ogre
 		{
             mEnabledAnimationStates.remove(i->second);
 
+			mAnimationStatesById.erase(IdString(name)._getInterned());
 			OGRE_DELETE i->second;
 			mAnimationStates.erase(i);
 		}
@@ -293,6 +295,7 @@ namespace Ogre
 			OGRE_DELETE i->second;
 		}
 		mAnimationStates.clear();
+		mAnimationStatesById.clear();
         mEnabledAnimationStates.clear();
 
 	}
@@ -313,6 +316,7 @@ namespace Ogre
 		AnimationState* newState = OGRE_NEW AnimationState(name, this, timePos, 
 			length, weight, enabled);
 		mAnimationStates[name] = newState;
+		mAnimationStatesById[IdString(name)._getInterned()] = newState;
 
 		return newState;
 
@@ -339,6 +343,27 @@ namespace Ogre
 		return mAnimationStates.find(name) != mAnimationStates.end();
 	}
 	//---------------------------------------------------------------------
+	AnimationState* AnimationStateSet::getAnimationState(const IdString& name) const
+	{
+		OGRE_LOCK_AUTO_MUTEX
+
+		AnimationStateIdMap::const_iterator i = mAnimationStatesById.find(name._getInterned());
+		if (i == mAnimationStatesById.end())
+		{
+			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+				"No state found for animation named '" + name.getString() + "'", 
+				"AnimationStateSet::getAnimationState");
+		}
+		return i->second;
+	}
+	//---------------------------------------------------------------------
+	bool AnimationStateSet::hasAnimationState(const IdString& name) const
+	{
+		OGRE_LOCK_AUTO_MUTEX
+
+		return mAnimationStatesById.find(name._getInterned()) != mAnimationStatesById.end();
+	}
+	//---------------------------------------------------------------------
 	AnimationStateIterator AnimationStateSet::getAnimationStateIterator(void)
 	{
 		OGRE_LOCK_AUTO_MUTEX
@@ -0,0 +1,562 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef OGREBLOCKCOMPRESSION_H
+#define OGREBLOCKCOMPRESSION_H
+
+#include <algorithm>
+#include "OgreSIMDHelper.h"
+
+// this file is inlined into OgrePixelFormat.cpp!
+// do not include anywhere else.
+namespace Ogre {
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Image
+	*  @{
+	*/
+
+// encoding and decoding of the 4x4 texel blocks of the DXT (BC1-3) and
+// RGTC (BC4-5) formats.
+//
+// texels are 8 bit RGBA in PF_BYTE_RGBA byte order, 16 of them per block
+// in row order. blocks are read and written a byte at a time in their little
+// endian file layout, so no endian flipping is needed on either side.
+struct BlockCompression
+{
+	// size in bytes of one block of format, 0 if it isn't a block format we handle
+	static size_t getBlockSize(PixelFormat format)
+	{
+		switch (format)
+		{
+		case PF_DXT1:
+		case PF_BC4_UNORM:
+			return 8;
+		case PF_DXT2:
+		case PF_DXT3:
+		case PF_DXT4:
+		case PF_DXT5:
+		case PF_BC5_UNORM:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	// whether encodeBlock can write format. the premultiplied DXT2 and DXT4
+	// are only decoded
+	static bool canEncode(PixelFormat format)
+	{
+		return format == PF_DXT1 || format == PF_DXT3 || format == PF_DXT5 ||
+			format == PF_BC4_UNORM || format == PF_BC5_UNORM;
+	}
+
+	static bool canDecode(PixelFormat format)
+	{
+		return getBlockSize(format) != 0;
+	}
+
+	static void encodeBlock(PixelFormat format, const uint8* texels, uint8* block)
+	{
+		switch (format)
+		{
+		case PF_DXT1:
+			encodeColour(texels, block, true);
+			break;
+		case PF_DXT3:
+			encodeExplicitAlpha(texels + 3, block);
+			encodeColour(texels, block + 8, false);
+			break;
+		case PF_DXT5:
+			encodeInterpolated(texels + 3, block);
+			encodeColour(texels, block + 8, false);
+			break;
+		case PF_BC4_UNORM:
+			encodeInterpolated(texels, block);
+			break;
+		case PF_BC5_UNORM:
+			encodeInterpolated(texels, block);
+			encodeInterpolated(texels + 1, block + 8);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// BC4 decodes to (r, 0, 0, 1) and BC5 to (r, g, 0, 1), like the hardware does
+	static void decodeBlock(PixelFormat format, const uint8* block, uint8* texels)
+	{
+		switch (format)
+		{
+		case PF_DXT1:
+			decodeColour(block, texels, true);
+			break;
+		case PF_DXT2:
+		case PF_DXT3:
+			decodeColour(block + 8, texels, false);
+			decodeExplicitAlpha(block, texels + 3);
+			break;
+		case PF_DXT4:
+		case PF_DXT5:
+			decodeColour(block + 8, texels, false);
+			decodeInterpolated(block, texels + 3);
+			break;
+		case PF_BC4_UNORM:
+			for (size_t i = 0; i < 16; ++i)
+			{
+				texels[i * 4 + 1] = texels[i * 4 + 2] = 0;
+				texels[i * 4 + 3] = 0xFF;
+			}
+			decodeInterpolated(block, texels);
+			break;
+		case PF_BC5_UNORM:
+			for (size_t i = 0; i < 16; ++i)
+			{
+				texels[i * 4 + 2] = 0;
+				texels[i * 4 + 3] = 0xFF;
+			}
+			decodeInterpolated(block, texels);
+			decodeInterpolated(block + 8, texels + 1);
+			break;
+		default:
+			break;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// colour blocks, 2 R5G6B5 endpoints and 16 2-bit indexes
+
+	static uint16 readUInt16(const uint8* p) { return static_cast<uint16>(p[0] | (p[1] << 8)); }
+	static void writeUInt16(uint8* p, uint16 v) { p[0] = static_cast<uint8>(v); p[1] = static_cast<uint8>(v >> 8); }
+
+	static uint16 packR5G6B5(int r, int g, int b)
+	{
+		return static_cast<uint16>((((r * 31 + 127) / 255) << 11) |
+			(((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+	}
+
+	static void unpackR5G6B5(uint16 c, int* rgb)
+	{
+		int r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	// the 4 colours a block can index; the last one is transparent black in 3 colour mode
+	static void buildPalette(uint16 c0, uint16 c1, bool threeColour, uint8* palette)
+	{
+		int p0[3], p1[3];
+		unpackR5G6B5(c0, p0);
+		unpackR5G6B5(c1, p1);
+		for (size_t i = 0; i < 3; ++i)
+		{
+			palette[i] = static_cast<uint8>(p0[i]);
+			palette[4 + i] = static_cast<uint8>(p1[i]);
+			if (threeColour)
+			{
+				palette[8 + i] = static_cast<uint8>((p0[i] + p1[i]) / 2);
+				palette[12 + i] = 0;
+			}
+			else
+			{
+				palette[8 + i] = static_cast<uint8>((2 * p0[i] + p1[i] + 1) / 3);
+				palette[12 + i] = static_cast<uint8>((p0[i] + 2 * p1[i] + 1) / 3);
+			}
+		}
+		palette[3] = palette[7] = palette[11] = 0xFF;
+		palette[15] = threeColour ? 0 : 0xFF;
+	}
+
+	static void decodeColour(const uint8* block, uint8* texels, bool dxt1)
+	{
+		uint16 c0 = readUInt16(block), c1 = readUInt16(block + 2);
+		uint8 palette[16];
+		buildPalette(c0, c1, dxt1 && c0 <= c1, palette);
+		for (size_t i = 0; i < 16; ++i)
+		{
+			const uint8* col = palette + ((block[4 + i / 4] >> ((i % 4) * 2)) & 0x3) * 4;
+			texels[i * 4] = col[0];
+			texels[i * 4 + 1] = col[1];
+			texels[i * 4 + 2] = col[2];
+			// alpha of the DXT2-5 formats is decoded separately
+			if (dxt1)
+				texels[i * 4 + 3] = col[3];
+		}
+	}
+
+	// picks the closest of the first numColours palette entries for each of
+	// the texels, ignoring alpha, and returns the summed squared error.
+	// texels set in skip get index 3 and don't count
+	static uint32 selectColourIndexes(const uint8* texels, const uint8* palette,
+		size_t numColours, uint16 skip, uint8* indexes)
+	{
+		uint32 error = 0;
+#if __OGRE_HAVE_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+		__m128i pal[4];
+		for (size_t c = 0; c < 4; ++c)
+		{
+			// the same colour twice, as 16 bit channels
+			__m128i p = _mm_set1_epi32(palette[c * 4] | (palette[c * 4 + 1] << 8) | (palette[c * 4 + 2] << 16));
+			pal[c] = _mm_unpacklo_epi8(p, zero);
+		}
+		for (size_t i = 0; i < 16; i += 4)
+		{
+			__m128i t = _mm_and_si128(_mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(texels + i * 4)), rgbMask);
+			__m128i lo = _mm_unpacklo_epi8(t, zero), hi = _mm_unpackhi_epi8(t, zero);
+			__m128i best = _mm_set1_epi32(0x7FFFFFFF), bestIndex = zero;
+			for (size_t c = 0; c < numColours; ++c)
+			{
+				__m128i dlo = _mm_sub_epi16(lo, pal[c]), dhi = _mm_sub_epi16(hi, pal[c]);
+				// (r*r + g*g, b*b) for 2 texels each
+				__m128 slo = _mm_castsi128_ps(_mm_madd_epi16(dlo, dlo));
+				__m128 shi = _mm_castsi128_ps(_mm_madd_epi16(dhi, dhi));
+				__m128i dist = _mm_add_epi32(
+					_mm_castps_si128(_mm_shuffle_ps(slo, shi, _MM_SHUFFLE(2, 0, 2, 0))),
+					_mm_castps_si128(_mm_shuffle_ps(slo, shi, _MM_SHUFFLE(3, 1, 3, 1))));
+				// strictly closer, so ties go to the lowest index like the scalar path
+				__m128i closer = _mm_cmplt_epi32(dist, best);
+				best = _mm_or_si128(_mm_and_si128(closer, dist), _mm_andnot_si128(closer, best));
+				bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32((int)c)),
+					_mm_andnot_si128(closer, bestIndex));
+			}
+			OGRE_ALIGNED_DECL(uint32, dists[4], 16);
+			OGRE_ALIGNED_DECL(uint32, idx[4], 16);
+			_mm_store_si128(reinterpret_cast<__m128i*>(dists), best);
+			_mm_store_si128(reinterpret_cast<__m128i*>(idx), bestIndex);
+			for (size_t j = 0; j < 4; ++j)
+			{
+				if (skip & (1 << (i + j)))
+				{
+					indexes[i + j] = 3;
+					continue;
+				}
+				indexes[i + j] = static_cast<uint8>(idx[j]);
+				error += dists[j];
+			}
+		}
+#else
+		for (size_t i = 0; i < 16; ++i)
+		{
+			if (skip & (1 << i))
+			{
+				indexes[i] = 3;
+				continue;
+			}
+			uint32 best = 0xFFFFFFFF;
+			for (size_t c = 0; c < numColours; ++c)
+			{
+				int dr = texels[i * 4] - palette[c * 4];
+				int dg = texels[i * 4 + 1] - palette[c * 4 + 1];
+				int db = texels[i * 4 + 2] - palette[c * 4 + 2];
+				uint32 dist = static_cast<uint32>(dr * dr + dg * dg + db * db);
+				if (dist < best)
+				{
+					best = dist;
+					indexes[i] = static_cast<uint8>(c);
+				}
+			}
+			error += best;
+		}
+#endif
+		return error;
+	}
+
+	static void writeColourBlock(uint8* block, uint16 c0, uint16 c1, const uint8* indexes)
+	{
+		writeUInt16(block, c0);
+		writeUInt16(block + 2, c1);
+		for (size_t row = 0; row < 4; ++row)
+		{
+			block[4 + row] = static_cast<uint8>(indexes[row * 4] | (indexes[row * 4 + 1] << 2) |
+				(indexes[row * 4 + 2] << 4) | (indexes[row * 4 + 3] << 6));
+		}
+	}
+
+	// endpoints along the principal axis of the texels not in skip
+	static void fitColourEndpoints(const uint8* texels, uint16 skip, float* end0, float* end1)
+	{
+		float mean[3] = {0, 0, 0};
+		size_t count = 0;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			if (skip & (1 << i))
+				continue;
+			for (size_t c = 0; c < 3; ++c)
+				mean[c] += texels[i * 4 + c];
+			++count;
+		}
+		for (size_t c = 0; c < 3; ++c)
+			mean[c] /= count;
+
+		float cov[6] = {0, 0, 0, 0, 0, 0};
+		for (size_t i = 0; i < 16; ++i)
+		{
+			if (skip & (1 << i))
+				continue;
+			float r = texels[i * 4] - mean[0], g = texels[i * 4 + 1] - mean[1], b = texels[i * 4 + 2] - mean[2];
+			cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+			cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+		}
+
+		// a few power iterations find the principal axis well enough
+		float axis[3] = {1, 1, 1};
+		for (size_t iter = 0; iter < 4; ++iter)
+		{
+			float x = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+			float y = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+			float z = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+			float len = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+			if (len < 1e-6f)
+				break;
+			axis[0] = x / len; axis[1] = y / len; axis[2] = z / len;
+		}
+
+		float minDot = 1e30f, maxDot = -1e30f;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			if (skip & (1 << i))
+				continue;
+			float d = (texels[i * 4] - mean[0]) * axis[0] + (texels[i * 4 + 1] - mean[1]) * axis[1] +
+				(texels[i * 4 + 2] - mean[2]) * axis[2];
+			minDot = std::min(minDot, d);
+			maxDot = std::max(maxDot, d);
+		}
+		float lenSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+		for (size_t c = 0; c < 3; ++c)
+		{
+			end0[c] = mean[c] + axis[c] * maxDot / lenSq;
+			end1[c] = mean[c] + axis[c] * minDot / lenSq;
+		}
+	}
+
+	static int roundChannel(float c)
+	{
+		return static_cast<int>(std::min(std::max(c, 0.0f), 255.0f) + 0.5f);
+	}
+
+	static uint16 quantiseEndpoint(const float* c)
+	{
+		return packR5G6B5(roundChannel(c[0]), roundChannel(c[1]), roundChannel(c[2]));
+	}
+
+	// index choice in 4 colour mode for c0 > c1, or in 3 colour mode otherwise
+	static uint32 tryColourEndpoints(const uint8* texels, uint16 skip, uint16 c0, uint16 c1,
+		bool threeColour, uint8* indexes)
+	{
+		uint8 palette[16];
+		buildPalette(c0, c1, threeColour, palette);
+		return selectColourIndexes(texels, palette, threeColour ? 3 : 4, skip, indexes);
+	}
+
+	// least squares endpoints for the 4 colour mode indexes already chosen
+	static bool refineColourEndpoints(const uint8* texels, const uint8* indexes, float* end0, float* end1)
+	{
+		static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+		float aa = 0, bb = 0, ab = 0;
+		float ax[3] = {0, 0, 0}, bx[3] = {0, 0, 0};
+		for (size_t i = 0; i < 16; ++i)
+		{
+			float a = weights[indexes[i]], b = 1.0f - a;
+			aa += a * a; bb += b * b; ab += a * b;
+			for (size_t c = 0; c < 3; ++c)
+			{
+				ax[c] += a * texels[i * 4 + c];
+				bx[c] += b * texels[i * 4 + c];
+			}
+		}
+		float det = aa * bb - ab * ab;
+		if (std::abs(det) < 1e-6f)
+			return false;
+		for (size_t c = 0; c < 3; ++c)
+		{
+			end0[c] = (ax[c] * bb - bx[c] * ab) / det;
+			end1[c] = (bx[c] * aa - ax[c] * ab) / det;
+		}
+		return true;
+	}
+
+	// orders the endpoints for the mode wanted and picks the indexes
+	static uint32 encodeColourEndpoints(const uint8* texels, uint16 skip, uint16 c0, uint16 c1,
+		bool threeColour, uint16* out0, uint16* out1, uint8* indexes)
+	{
+		if (threeColour ? c0 > c1 : c0 < c1)
+			std::swap(c0, c1);
+		*out0 = c0;
+		*out1 = c1;
+		// equal endpoints read as 3 colour mode in DXT1, the first 3 entries are still the same
+		return tryColourEndpoints(texels, skip, c0, c1, threeColour || c0 == c1, indexes);
+	}
+
+	// with transparency allowed, texels with alpha below one half are encoded
+	// transparent using the 3 colour mode of DXT1
+	static void encodeColour(const uint8* texels, uint8* block, bool transparency)
+	{
+		uint16 transparent = 0;
+		if (transparency)
+		{
+			for (size_t i = 0; i < 16; ++i)
+			{
+				if (texels[i * 4 + 3] < 128)
+					transparent |= static_cast<uint16>(1 << i);
+			}
+		}
+		if (transparent == 0xFFFF)
+		{
+			uint8 indexes[16];
+			std::fill(indexes, indexes + 16, 3);
+			writeColourBlock(block, 0, 0, indexes);
+			return;
+		}
+
+		float end0[3], end1[3];
+		fitColourEndpoints(texels, transparent, end0, end1);
+		uint16 c0, c1;
+		uint8 indexes[16];
+		uint32 error = encodeColourEndpoints(texels, transparent, quantiseEndpoint(end0), 
+			quantiseEndpoint(end1), transparent != 0, &c0, &c1, indexes);
+
+		if (!transparent && c0 != c1)
+		{
+			float ref0[3], ref1[3];
+			if (refineColourEndpoints(texels, indexes, ref0, ref1))
+			{
+				uint16 r0, r1;
+				uint8 refined[16];
+				uint32 refinedError = encodeColourEndpoints(texels, 0, quantiseEndpoint(ref0),
+					quantiseEndpoint(ref1), false, &r0, &r1, refined);
+				if (refinedError < error)
+				{
+					c0 = r0;
+					c1 = r1;
+					std::copy(refined, refined + 16, indexes);
+				}
+			}
+		}
+		writeColourBlock(block, c0, c1, indexes);
+	}
+
+	//-------------------------------------------------------------------------
+	// explicit alpha, 16 4-bit values (DXT2/3)
+
+	static void encodeExplicitAlpha(const uint8* alpha, uint8* block)
+	{
+		for (size_t i = 0; i < 16; i += 2)
+		{
+			int a0 = (alpha[i * 4] * 15 + 127) / 255;
+			int a1 = (alpha[(i + 1) * 4] * 15 + 127) / 255;
+			block[i / 2] = static_cast<uint8>(a0 | (a1 << 4));
+		}
+	}
+
+	static void decodeExplicitAlpha(const uint8* block, uint8* alpha)
+	{
+		for (size_t i = 0; i < 16; ++i)
+			alpha[i * 4] = static_cast<uint8>(((block[i / 2] >> ((i % 2) * 4)) & 0xF) * 17);
+	}
+
+	//-------------------------------------------------------------------------
+	// interpolated single channel, 2 8-bit endpoints and 16 3-bit indexes (DXT4/5 alpha, BC4, BC5)
+
+	// values are read and written with a stride of 4, one channel of the texels
+	static void buildInterpolatedPalette(int v0, int v1, int* palette)
+	{
+		palette[0] = v0;
+		palette[1] = v1;
+		if (v0 > v1)
+		{
+			for (int i = 1; i < 7; ++i)
+				palette[i + 1] = ((7 - i) * v0 + i * v1 + 3) / 7;
+		}
+		else
+		{
+			for (int i = 1; i < 5; ++i)
+				palette[i + 1] = ((5 - i) * v0 + i * v1 + 2) / 5;
+			palette[6] = 0;
+			palette[7] = 0xFF;
+		}
+	}
+
+	static void decodeInterpolated(const uint8* block, uint8* values)
+	{
+		int palette[8];
+		buildInterpolatedPalette(block[0], block[1], palette);
+		uint64 bits = 0;
+		for (size_t i = 0; i < 6; ++i)
+			bits |= static_cast<uint64>(block[2 + i]) << (i * 8);
+		for (size_t i = 0; i < 16; ++i)
+			values[i * 4] = static_cast<uint8>(palette[(bits >> (i * 3)) & 0x7]);
+	}
+
+	static void encodeInterpolated(const uint8* values, uint8* block)
+	{
+		int minValue = 0xFF, maxValue = 0;
+		for (size_t i = 0; i < 16; ++i)
+		{
+			minValue = std::min<int>(minValue, values[i * 4]);
+			maxValue = std::max<int>(maxValue, values[i * 4]);
+		}
+		block[0] = static_cast<uint8>(maxValue);
+		block[1] = static_cast<uint8>(minValue);
+
+		// 8 value mode, or a single value when they're all equal
+		uint64 bits = 0;
+		if (maxValue != minValue)
+		{
+			int palette[8];
+			buildInterpolatedPalette(maxValue, minValue, palette);
+			for (size_t i = 0; i < 16; ++i)
+			{
+				int best = 0x7FFFFFFF;
+				uint64 index = 0;
+				for (size_t p = 0; p < 8; ++p)
+				{
+					int dist = std::abs(palette[p] - values[i * 4]);
+					if (dist < best)
+					{
+						best = dist;
+						index = p;
+					}
+				}
+				bits |= index << (i * 3);
+			}
+		}
+		for (size_t i = 0; i < 6; ++i)
+			block[2 + i] = static_cast<uint8>(bits >> (i * 8));
+	}
+};
+
+	/** @} */
+	/** @} */
+
+}
+
+#endif
@@ -93,22 +93,6 @@ namespace Ogre {
 		// 16 2-bit indexes, each byte here is one row
 		uint8 indexRow[4];
 	};
-	// An 8-byte DXT explicit alpha block, represents a 4x4 texel area. Used by DXT2/3
-	struct DXTExplicitAlphaBlock
-	{
-		// 16 4-bit values, each 16-bit value is one row
-		uint16 alphaRow[4];
-	};
-	// An 8-byte DXT interpolated alpha block, represents a 4x4 texel area. Used by DXT4/5
-	struct DXTInterpolatedAlphaBlock
-	{
-		// 2 alpha ranges
-		uint8 alpha_0;
-		uint8 alpha_1;
-		// 16 3-bit indexes. Unfortunately 3 bits doesn't map too well to row bytes
-		// so just stored raw
-		uint8 indexes[6];
-	};
 	
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 #pragma pack (pop)
@@ -214,13 +198,6 @@ namespace Ogre {
 		String notImplementedString = "";
 
 		// Check for all the 'not implemented' conditions
-		if (imgData->num_mipmaps != 0)
-		{
-			// No mip map functionality yet
-			notImplemented = true;
-			notImplementedString += " mipmaps";
-		}
-
 		if ((isVolume == true)&&(imgData->width != imgData->height))
 		{
 			// Square textures only
@@ -246,6 +223,11 @@ namespace Ogre {
 		case PF_X8R8G8B8:
 		case PF_R8G8B8:
 		case PF_FLOAT32_R:
+		case PF_DXT1:
+		case PF_DXT3:
+		case PF_DXT5:
+		case PF_BC4_UNORM:
+		case PF_BC5_UNORM:
 			break;
 		default:
 			// No crazy FOURCC or 565 et al. file formats at this stage
@@ -273,6 +255,7 @@ namespace Ogre {
 			uint32 ddsHeaderSizeOrPitch = 0;
 			uint32 ddsHeaderCaps1 = 0;
 			uint32 ddsHeaderCaps2 = 0;
+			uint32 ddsFourCC = (isFloat32r) ? D3DFMT_R32F : 0;
 			uint32 ddsMagic = DDS_MAGIC;
 
 			// Initalise the header flags
@@ -295,16 +278,46 @@ namespace Ogre {
 			case PF_FLOAT32_R:
 				ddsHeaderRgbBits = 32;
 				break;
+			case PF_DXT1:
+				ddsFourCC = FOURCC('D','X','T','1');
+				break;
+			case PF_DXT3:
+				ddsFourCC = FOURCC('D','X','T','3');
+				break;
+			case PF_DXT5:
+				ddsFourCC = FOURCC('D','X','T','5');
+				break;
+			case PF_BC4_UNORM:
+				ddsFourCC = FOURCC('A','T','I','1');
+				break;
+			case PF_BC5_UNORM:
+				ddsFourCC = FOURCC('A','T','I','2');
+				break;
 			default:
 				ddsHeaderRgbBits = 0;
 				break;
 			}
 
-			// Initalise the SizeOrPitch flags (power two textures for now)
-			ddsHeaderSizeOrPitch = ddsHeaderRgbBits * imgData->width;
+			if (PixelUtil::isCompressed(imgData->format))
+			{
+				// Size of the top level, blocks have no pitch
+				ddsHeaderFlags |= DDSD_LINEARSIZE;
+				ddsHeaderSizeOrPitch = (uint32)PixelUtil::getMemorySize(
+					imgData->width, imgData->height, 1, imgData->format);
+			}
+			else
+			{
+				// Initalise the SizeOrPitch flags (power two textures for now)
+				ddsHeaderSizeOrPitch = ddsHeaderRgbBits * imgData->width;
+			}
 
 			// Initalise the caps flags
 			ddsHeaderCaps1 = (isVolume||isCubeMap) ? DDSCAPS_COMPLEX|DDSCAPS_TEXTURE : DDSCAPS_TEXTURE;
+			if (imgData->num_mipmaps > 0)
+			{
+				ddsHeaderFlags |= DDSD_MIPMAPCOUNT;
+				ddsHeaderCaps1 |= DDSCAPS_COMPLEX|DDSCAPS_MIPMAP;
+			}
 			if (isVolume)
 			{
 				ddsHeaderCaps2 = DDSCAPS2_VOLUME;
@@ -325,7 +338,7 @@ namespace Ogre {
 			ddsHeader.height = (uint32)imgData->height;
 			ddsHeader.depth = (uint32)(isVolume ? imgData->depth : 0);
 			ddsHeader.depth = (uint32)(isCubeMap ? 6 : ddsHeader.depth);
-			ddsHeader.mipMapCount = 0;
+			ddsHeader.mipMapCount = (imgData->num_mipmaps > 0) ? imgData->num_mipmaps + 1 : 0;
 			ddsHeader.sizeOrPitch = ddsHeaderSizeOrPitch;
 			for (uint32 reserved1=0; reserved1<11; reserved1++) // XXX nasty constant 11
 			{
@@ -335,15 +348,16 @@ namespace Ogre {
 
 			ddsHeader.pixelFormat.size = DDS_PIXELFORMAT_SIZE;
 			ddsHeader.pixelFormat.flags = (hasAlpha) ? DDPF_RGB|DDPF_ALPHAPIXELS : DDPF_RGB;
-			ddsHeader.pixelFormat.flags = (isFloat32r) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
-			ddsHeader.pixelFormat.fourCC = (isFloat32r) ? D3DFMT_R32F : 0;
+			ddsHeader.pixelFormat.flags = (ddsFourCC) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
+			ddsHeader.pixelFormat.fourCC = ddsFourCC;
 			ddsHeader.pixelFormat.rgbBits = ddsHeaderRgbBits;
 
+			bool isBlocks = PixelUtil::isCompressed(imgData->format);
 			ddsHeader.pixelFormat.alphaMask = (hasAlpha)   ? 0xFF000000 : 0x00000000;
-			ddsHeader.pixelFormat.alphaMask = (isFloat32r) ? 0x00000000 : ddsHeader.pixelFormat.alphaMask;
-			ddsHeader.pixelFormat.redMask   = (isFloat32r) ? 0xFFFFFFFF :0x00FF0000;
-			ddsHeader.pixelFormat.greenMask = (isFloat32r) ? 0x00000000 :0x0000FF00;
-			ddsHeader.pixelFormat.blueMask  = (isFloat32r) ? 0x00000000 :0x000000FF;
+			ddsHeader.pixelFormat.alphaMask = (isFloat32r || isBlocks) ? 0x00000000 : ddsHeader.pixelFormat.alphaMask;
+			ddsHeader.pixelFormat.redMask   = (isFloat32r) ? 0xFFFFFFFF : (isBlocks) ? 0x00000000 : 0x00FF0000;
+			ddsHeader.pixelFormat.greenMask = (isFloat32r || isBlocks) ? 0x00000000 :0x0000FF00;
+			ddsHeader.pixelFormat.blueMask  = (isFloat32r || isBlocks) ? 0x00000000 :0x000000FF;
 
 			ddsHeader.caps.caps1 = ddsHeaderCaps1;
 			ddsHeader.caps.caps2 = ddsHeaderCaps2;
@@ -392,7 +406,12 @@ namespace Ogre {
 			return PF_FLOAT32_GR;
 		case D3DFMT_A32B32G32R32F:
 			return PF_FLOAT32_RGBA;
-		// We could support 3Dc here, but only ATI cards support it, not nVidia
+		case FOURCC('A','T','I','1'):
+		case FOURCC('B','C','4','U'):
+			return PF_BC4_UNORM;
+		case FOURCC('A','T','I','2'):
+		case FOURCC('B','C','5','U'):
+			return PF_BC5_UNORM;
 		default:
 			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
 				"Unsupported FourCC format found in DDS file", 
@@ -429,148 +448,6 @@ namespace Ogre {
 			"DDSCodec::convertPixelFormat");
 
 	}
-	//---------------------------------------------------------------------
-	void DDSCodec::unpackDXTColour(PixelFormat pf, const DXTColourBlock& block, 
-		ColourValue* pCol) const
-	{
-		// Note - we assume all values have already been endian swapped
-
-		// Colour lookup table
-		ColourValue derivedColours[4];
-
-		if (pf == PF_DXT1 && block.colour_0 <= block.colour_1)
-		{
-			// 1-bit alpha
-			PixelUtil::unpackColour(&(derivedColours[0]), PF_R5G6B5, &(block.colour_0));
-			PixelUtil::unpackColour(&(derivedColours[1]), PF_R5G6B5, &(block.colour_1));
-			// one intermediate colour, half way between the other two
-			derivedColours[2] = (derivedColours[0] + derivedColours[1]) / 2;
-			// transparent colour
-			derivedColours[3] = ColourValue::ZERO;
-		}
-		else
-		{
-			PixelUtil::unpackColour(&(derivedColours[0]), PF_R5G6B5, &(block.colour_0));
-			PixelUtil::unpackColour(&(derivedColours[1]), PF_R5G6B5, &(block.colour_1));
-			// first interpolated colour, 1/3 of the way along
-			derivedColours[2] = (2 * derivedColours[0] + derivedColours[1]) / 3;
-			// second interpolated colour, 2/3 of the way along
-			derivedColours[3] = (derivedColours[0] + 2 * derivedColours[1]) / 3;
-		}
-
-		// Process 4x4 block of texels
-		for (size_t row = 0; row < 4; ++row)
-		{
-			for (size_t x = 0; x < 4; ++x)
-			{
-				// LSB come first
-				uint8 colIdx = static_cast<uint8>(block.indexRow[row] >> (x * 2) & 0x3);
-				if (pf == PF_DXT1)
-				{
-					// Overwrite entire colour
-					pCol[(row * 4) + x] = derivedColours[colIdx];
-				}
-				else
-				{
-					// alpha has already been read (alpha precedes colour)
-					ColourValue& col = pCol[(row * 4) + x];
-					col.r = derivedColours[colIdx].r;
-					col.g = derivedColours[colIdx].g;
-					col.b = derivedColours[colIdx].b;
-				}
-			}
-
-		}
-
-
-	}
-	//---------------------------------------------------------------------
-	void DDSCodec::unpackDXTAlpha(
-		const DXTExplicitAlphaBlock& block, ColourValue* pCol) const
-	{
-		// Note - we assume all values have already been endian swapped
-		
-		// This is an explicit alpha block, 4 bits per pixel, LSB first
-		for (size_t row = 0; row < 4; ++row)
-		{
-			for (size_t x = 0; x < 4; ++x)
-			{
-				// Shift and mask off to 4 bits
-				uint8 val = static_cast<uint8>(block.alphaRow[row] >> (x * 4) & 0xF);
-				// Convert to [0,1]
-				pCol->a = (Real)val / (Real)0xF;
-				pCol++;
-				
-			}
-			
-		}
-
-	}
-	//---------------------------------------------------------------------
-	void DDSCodec::unpackDXTAlpha(
-		const DXTInterpolatedAlphaBlock& block, ColourValue* pCol) const
-	{
-		// 8 derived alpha values to be indexed
-		Real derivedAlphas[8];
-
-		// Explicit extremes
-		derivedAlphas[0] = block.alpha_0 / (Real)0xFF;
-		derivedAlphas[1] = block.alpha_1 / (Real)0xFF;
-		
-		
-		if (block.alpha_0 <= block.alpha_1)
-		{
-			// 4 interpolated alphas, plus zero and one			
-			// full range including extremes at [0] and [5]
-			// we want to fill in [1] through [4] at weights ranging
-			// from 1/5 to 4/5
-			Real denom = 1.0f / 5.0f;
-			for (size_t i = 0; i < 4; ++i) 
-			{
-				Real factor0 = (4 - i) * denom;
-				Real factor1 = (i + 1) * denom;
-				derivedAlphas[i + 2] = 
-					(factor0 * block.alpha_0) + (factor1 * block.alpha_1);
-			}
-			derivedAlphas[6] = 0.0f;
-			derivedAlphas[7] = 1.0f;
-
-		}
-		else
-		{
-			// 6 interpolated alphas
-			// full range including extremes at [0] and [7]
-			// we want to fill in [1] through [6] at weights ranging
-			// from 1/7 to 6/7
-			Real denom = 1.0f / 7.0f;
-			for (size_t i = 0; i < 6; ++i) 
-			{
-				Real factor0 = (6 - i) * denom;
-				Real factor1 = (i + 1) * denom;
-				derivedAlphas[i + 2] = 
-					(factor0 * block.alpha_0) + (factor1 * block.alpha_1);
-			}
-			
-		}
-
-		// Ok, now we've built the reference values, process the indexes
-		for (size_t i = 0; i < 16; ++i)
-		{
-			size_t baseByte = (i * 3) / 8;
-			size_t baseBit = (i * 3) % 8;
-			uint8 bits = static_cast<uint8>(block.indexes[baseByte] >> baseBit & 0x7);
-			// do we need to stitch in next byte too?
-			if (baseBit > 5)
-			{
-				uint8 extraBits = static_cast<uint8>(
-					(block.indexes[baseByte+1] << (8 - baseBit)) & 0xFF);
-				bits |= extraBits & 0x7;
-			}
-			pCol[i].a = derivedAlphas[bits];
-
-		}
-
-	}
     //---------------------------------------------------------------------
     Codec::DecodeResult DDSCodec::decode(DataStreamPtr& stream) const
     {
@@ -652,8 +529,10 @@ namespace Ogre {
 
 		if (PixelUtil::isCompressed(sourceFormat))
 		{
+			// No render system maps the BC4/5 formats yet
 			if (Root::getSingleton().getRenderSystem() == NULL ||
-				Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_TEXTURE_COMPRESSION_DXT) == false)
+				Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_TEXTURE_COMPRESSION_DXT) == false ||
+				sourceFormat == PF_BC4_UNORM || sourceFormat == PF_BC5_UNORM)
 			{
 				// We'll need to decompress
 				decompressDXT = true;
@@ -691,6 +570,13 @@ namespace Ogre {
 					// full alpha present, formats vary only in encoding 
 					imgData->format = PF_BYTE_RGBA;
 					break;
+				case PF_BC4_UNORM:
+					imgData->format = PF_L8;
+					break;
+				case PF_BC5_UNORM:
+					// blue is left at zero
+					imgData->format = PF_BYTE_RGB;
+					break;
                 default:
                     // all other cases need no special format handling
                     break;
@@ -738,82 +624,16 @@ namespace Ogre {
 					// Compressed data
 					if (decompressDXT)
 					{
-						DXTColourBlock col;
-						DXTInterpolatedAlphaBlock iAlpha;
-						DXTExplicitAlphaBlock eAlpha;
-						// 4x4 block of decompressed colour
-						ColourValue tempColours[16];
-						size_t destBpp = PixelUtil::getNumElemBytes(imgData->format);
-						size_t sx = std::min(width, (size_t)4);
-						size_t sy = std::min(height, (size_t)4);
-						size_t destPitchMinus4 = dstPitch - destBpp * sx;
-						// slices are done individually
-						for(size_t z = 0; z < depth; ++z)
-						{
-							// 4x4 blocks in x/y
-							for (size_t y = 0; y < height; y += 4)
-							{
-								for (size_t x = 0; x < width; x += 4)
-								{
-									if (sourceFormat == PF_DXT2 || 
-										sourceFormat == PF_DXT3)
-									{
-										// explicit alpha
-										stream->read(&eAlpha, sizeof(DXTExplicitAlphaBlock));
-										flipEndian(eAlpha.alphaRow, sizeof(uint16), 4);
-										unpackDXTAlpha(eAlpha, tempColours) ;
-									}
-									else if (sourceFormat == PF_DXT4 || 
-										sourceFormat == PF_DXT5)
-									{
-										// interpolated alpha
-										stream->read(&iAlpha, sizeof(DXTInterpolatedAlphaBlock));
-										flipEndian(&(iAlpha.alpha_0), sizeof(uint16), 1);
-										flipEndian(&(iAlpha.alpha_1), sizeof(uint16), 1);
-										unpackDXTAlpha(iAlpha, tempColours) ;
-									}
-									// always read colour
-									stream->read(&col, sizeof(DXTColourBlock));
-									flipEndian(&(col.colour_0), sizeof(uint16), 1);
-									flipEndian(&(col.colour_1), sizeof(uint16), 1);
-									unpackDXTColour(sourceFormat, col, tempColours);
-
-									// write 4x4 block to uncompressed version
-									for (size_t by = 0; by < sy; ++by)
-									{
-										for (size_t bx = 0; bx < sx; ++bx)
-										{
-											PixelUtil::packColour(tempColours[by*4+bx],
-												imgData->format, destPtr);
-											destPtr = static_cast<void*>(
-												static_cast<uchar*>(destPtr) + destBpp);
-										}
-										// advance to next row
-										destPtr = static_cast<void*>(
-											static_cast<uchar*>(destPtr) + destPitchMinus4);
-									}
-									// next block. Our dest pointer is 4 lines down
-									// from where it started
-									if (x + 4 >= width)
-									{
-										// Jump back to the start of the line
-										destPtr = static_cast<void*>(
-											static_cast<uchar*>(destPtr) - destPitchMinus4);
-									}
-									else
-									{
-										// Jump back up 4 rows and 4 pixels to the
-										// right to be at the next block to the right
-										destPtr = static_cast<void*>(
-											static_cast<uchar*>(destPtr) - dstPitch * sy + destBpp * sx);
-
-									}
-
-								}
-
-							}
-						}
-
+						// Read the whole level, then decode its blocks on as many 
+						// threads as PixelUtil is allowed
+						size_t dxtSize = PixelUtil::getMemorySize(width, height, depth, sourceFormat);
+						MemoryDataStream blocks(dxtSize);
+						stream->read(blocks.getPtr(), dxtSize);
+						PixelBox src(width, height, depth, sourceFormat, blocks.getPtr());
+						PixelBox dst(width, height, depth, imgData->format, destPtr);
+						PixelUtil::bulkPixelConversion(src, dst);
+						destPtr = static_cast<void*>(static_cast<uchar*>(destPtr) + 
+							PixelUtil::getMemorySize(width, height, depth, imgData->format));
 					}
 					else
 					{
@@ -842,9 +662,9 @@ namespace Ogre {
 					assert (dstPitch <= srcPitch);
 					long srcAdvance = static_cast<long>(srcPitch) - static_cast<long>(dstPitch);
 
-					for (size_t z = 0; z < imgData->depth; ++z)
+					for (size_t z = 0; z < depth; ++z)
 					{
-						for (size_t y = 0; y < imgData->height; ++y)
+						for (size_t y = 0; y < height; ++y)
 						{
 							stream->read(destPtr, dstPitch);
 							if (srcAdvance > 0)
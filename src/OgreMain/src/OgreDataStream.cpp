@@ -29,9 +29,51 @@ THE SOFTWARE.
 #include "OgreDataStream.h"
 #include "OgreLogManager.h"
 #include "OgreException.h"
+#include "OgreWorkQueue.h"
+
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+#	include <unistd.h>
+#endif
 
 namespace Ogre {
 
+	//-----------------------------------------------------------------------
+	//-----------------------------------------------------------------------
+	AsyncReadRequest::AsyncReadRequest(DataStream* stream, void* buf, size_t offset, 
+		size_t count, AsyncReadRequestListener* listener)
+		: mStream(stream), mBuffer(buf), mOffset(offset), mCount(count), 
+		mBytesRead(0), mListener(listener), mComplete(false)
+	{
+	}
+	//-----------------------------------------------------------------------
+	bool AsyncReadRequest::isComplete() const
+	{
+		OGRE_LOCK_MUTEX(mCompleteMutex)
+		return mComplete;
+	}
+	//-----------------------------------------------------------------------
+	size_t AsyncReadRequest::waitForCompletion()
+	{
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+		OGRE_LOCK_MUTEX_NAMED(mCompleteMutex, completeLock);
+		while (!mComplete)
+			OGRE_THREAD_WAIT(mCompleteSync, mCompleteMutex, completeLock);
+#endif
+		return mBytesRead;
+	}
+	//-----------------------------------------------------------------------
+	void AsyncReadRequest::_notifyComplete(size_t bytesRead)
+	{
+		mBytesRead = bytesRead;
+		// The listener goes first, so that waiting threads resume after it
+		if (mListener)
+			mListener->readCompleted(this);
+
+		OGRE_LOCK_MUTEX(mCompleteMutex)
+		mComplete = true;
+		OGRE_THREAD_NOTIFY_ALL(mCompleteSync)
+	}
+
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     template <typename T> DataStream& DataStream::operator >>(T& val)
@@ -169,6 +211,23 @@ namespace Ogre {
 
         return total;
     }
+	//-----------------------------------------------------------------------
+	AsyncReadRequestPtr DataStream::readAsync(void* buf, size_t offset, size_t count, 
+		AsyncReadRequestListener* listener)
+	{
+		AsyncReadRequestPtr request(OGRE_NEW AsyncReadRequest(this, buf, offset, count, listener));
+		request->_notifyComplete(_readAt(buf, offset, count));
+		return request;
+	}
+	//-----------------------------------------------------------------------
+	size_t DataStream::_readAt(void* buf, size_t offset, size_t count)
+	{
+		size_t pos = tell();
+		seek(offset);
+		size_t bytesRead = read(buf, count);
+		seek(pos);
+		return bytesRead;
+	}
     //-----------------------------------------------------------------------
     String DataStream::getAsString(void)
     {
@@ -458,6 +517,15 @@ namespace Ogre {
     {
         return mPos >= mEnd;
     }
+	//-----------------------------------------------------------------------
+	size_t MemoryDataStream::_readAt(void* buf, size_t offset, size_t count)
+	{
+		if (offset >= mSize)
+			return 0;
+		size_t cnt = std::min(count, mSize - offset);
+		memcpy(buf, mData + offset, cnt);
+		return cnt;
+	}
     //-----------------------------------------------------------------------
     void MemoryDataStream::close(void)    
     {
@@ -694,6 +762,14 @@ namespace Ogre {
             }
         }
     }
+	//-----------------------------------------------------------------------
+	AsyncReadRequestPtr FileStreamDataStream::readAsync(void* buf, size_t offset, 
+		size_t count, AsyncReadRequestListener* listener)
+	{
+		AsyncReadRequestPtr request(OGRE_NEW AsyncReadRequest(this, buf, offset, count, listener));
+		WorkQueue::defaultReadAsync(request);
+		return request;
+	}
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     FileHandleDataStream::FileHandleDataStream(FILE* handle, uint16 accessMode)
@@ -752,6 +828,25 @@ namespace Ogre {
     {
         return feof(mFileHandle) != 0;
     }
+	//-----------------------------------------------------------------------
+	AsyncReadRequestPtr FileHandleDataStream::readAsync(void* buf, size_t offset, 
+		size_t count, AsyncReadRequestListener* listener)
+	{
+		AsyncReadRequestPtr request(OGRE_NEW AsyncReadRequest(this, buf, offset, count, listener));
+		WorkQueue::defaultReadAsync(request);
+		return request;
+	}
+	//-----------------------------------------------------------------------
+	size_t FileHandleDataStream::_readAt(void* buf, size_t offset, size_t count)
+	{
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+		// Positional reads leave the file position alone
+		ssize_t bytesRead = pread(fileno(mFileHandle), buf, count, static_cast<off_t>(offset));
+		return bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+#else
+		return DataStream::_readAt(buf, offset, count);
+#endif
+	}
     //-----------------------------------------------------------------------
     void FileHandleDataStream::close(void)
     {
@@ -33,7 +33,7 @@ THE SOFTWARE.
 namespace Ogre {
 	//---------------------------------------------------------------------
 	DefaultIntersectionSceneQuery::DefaultIntersectionSceneQuery(SceneManager* creator)
-	: IntersectionSceneQuery(creator)
+	: IntersectionSceneQuery(creator), mListener(0)
 	{
 		// No world geometry results supported
 		mSupportedWorldFragments.insert(SceneQuery::WFT_NONE);
@@ -44,81 +44,49 @@ namespace Ogre {
 	}
 	//---------------------------------------------------------------------
 	void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+	{
+		mBroadPhase.clear();
+		addObjectsToBroadPhase();
+
+		mListener = listener;
+		mBroadPhase.findOverlaps(this);
+		mListener = 0;
+		// Don't hold on to the objects until the next execution
+		mBroadPhase.clear();
+	}
+	//---------------------------------------------------------------------
+	void DefaultIntersectionSceneQuery::addObjectsToBroadPhase(void)
 	{
 		// Iterate over all movable types
 		Root::MovableObjectFactoryIterator factIt = 
 			Root::getSingleton().getMovableObjectFactoryIterator();
 		while(factIt.hasMoreElements())
 		{
-			SceneManager::MovableObjectIterator objItA = 
-				mParentSceneMgr->getMovableObjectIterator(
-					factIt.getNext()->getType());
-			while (objItA.hasMoreElements())
+			const String& typeName = factIt.getNext()->getType();
+			SceneManager::MovableObjectIterator objIt = 
+				mParentSceneMgr->getMovableObjectIterator(typeName);
+			// followed by the objects of this type created without a name
+			SceneManager::AnonymousMovableObjectIterator anonObjIt = 
+				mParentSceneMgr->getAnonymousMovableObjectIterator(typeName);
+			while (objIt.hasMoreElements() || anonObjIt.hasMoreElements())
 			{
-				MovableObject* a = objItA.getNext();
+				MovableObject* a = objIt.hasMoreElements() ? 
+					objIt.getNext() : anonObjIt.getNext();
 				// skip entire section if type doesn't match
 				if (!(a->getTypeFlags() & mQueryTypeMask))
 					break;
 
-				// Skip if a does not pass the mask
-				if (!(a->getQueryFlags() & mQueryMask) ||
-					!a->isInScene())
-					continue;
-
-				// Check against later objects in the same group
-				SceneManager::MovableObjectIterator objItB = objItA;
-				while (objItB.hasMoreElements())
-				{
-					MovableObject* b = objItB.getNext();
-
-					// Apply mask to b (both must pass)
-					if ((b->getQueryFlags() & mQueryMask) && 
-						b->isInScene())
-					{
-						const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-						const AxisAlignedBox& box2 = b->getWorldBoundingBox();
-
-						if (box1.intersects(box2))
-						{
-							if (!listener->queryResult(a, b)) return;
-						}
-					}
-				}
-				// Check  against later groups
-				Root::MovableObjectFactoryIterator factItLater = factIt;
-				while (factItLater.hasMoreElements())
-				{
-					SceneManager::MovableObjectIterator objItC = 
-						mParentSceneMgr->getMovableObjectIterator(
-							factItLater.getNext()->getType());
-					while (objItC.hasMoreElements())
-					{
-						MovableObject* c = objItC.getNext();
-						// skip entire section if type doesn't match
-						if (!(c->getTypeFlags() & mQueryTypeMask))
-							break;
-
-						// Apply mask to c (both must pass)
-						if ((c->getQueryFlags() & mQueryMask) &&
-							c->isInScene())
-						{
-							const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-							const AxisAlignedBox& box2 = c->getWorldBoundingBox();
-
-							if (box1.intersects(box2))
-							{
-								if (!listener->queryResult(a, c)) return;
-							}
-						}
-					}
-
-				}
-
+				if ((a->getQueryFlags() & mQueryMask) && a->isInScene())
+					mBroadPhase.addObject(a);
 			}
-
-
 		}
-
+	}
+	//---------------------------------------------------------------------
+	bool DefaultIntersectionSceneQuery::overlapFound(MovableObject* a, MovableObject* b)
+	{
+		if (!acceptPair(a, b))
+			return true;
+		return mListener->queryResult(a, b);
 	}
 	//---------------------------------------------------------------------
 	DefaultAxisAlignedBoxSceneQuery::
@@ -140,12 +108,16 @@ namespace Ogre {
 			Root::getSingleton().getMovableObjectFactoryIterator();
 		while(factIt.hasMoreElements())
 		{
+			const String& typeName = factIt.getNext()->getType();
 			SceneManager::MovableObjectIterator objItA = 
-				mParentSceneMgr->getMovableObjectIterator(
-				factIt.getNext()->getType());
-			while (objItA.hasMoreElements())
+				mParentSceneMgr->getMovableObjectIterator(typeName);
+			// followed by the objects of this type created without a name
+			SceneManager::AnonymousMovableObjectIterator anonObjItA = 
+				mParentSceneMgr->getAnonymousMovableObjectIterator(typeName);
+			while (objItA.hasMoreElements() || anonObjItA.hasMoreElements())
 			{
-				MovableObject* a = objItA.getNext();
+				MovableObject* a = objItA.hasMoreElements() ? 
+					objItA.getNext() : anonObjItA.getNext();
 				// skip whole group if type doesn't match
 				if (!(a->getTypeFlags() & mQueryTypeMask))
 					break;
@@ -184,12 +156,16 @@ namespace Ogre {
 			Root::getSingleton().getMovableObjectFactoryIterator();
 		while(factIt.hasMoreElements())
 		{
+			const String& typeName = factIt.getNext()->getType();
 			SceneManager::MovableObjectIterator objItA = 
-				mParentSceneMgr->getMovableObjectIterator(
-				factIt.getNext()->getType());
-			while (objItA.hasMoreElements())
+				mParentSceneMgr->getMovableObjectIterator(typeName);
+			// followed by the objects of this type created without a name
+			SceneManager::AnonymousMovableObjectIterator anonObjItA = 
+				mParentSceneMgr->getAnonymousMovableObjectIterator(typeName);
+			while (objItA.hasMoreElements() || anonObjItA.hasMoreElements())
 			{
-				MovableObject* a = objItA.getNext();
+				MovableObject* a = objItA.hasMoreElements() ? 
+					objItA.getNext() : anonObjItA.getNext();
 				// skip whole group if type doesn't match
 				if (!(a->getTypeFlags() & mQueryTypeMask))
 					break;
@@ -231,12 +207,16 @@ namespace Ogre {
 			Root::getSingleton().getMovableObjectFactoryIterator();
 		while(factIt.hasMoreElements())
 		{
+			const String& typeName = factIt.getNext()->getType();
 			SceneManager::MovableObjectIterator objItA = 
-				mParentSceneMgr->getMovableObjectIterator(
-				factIt.getNext()->getType());
-			while (objItA.hasMoreElements())
+				mParentSceneMgr->getMovableObjectIterator(typeName);
+			// followed by the objects of this type created without a name
+			SceneManager::AnonymousMovableObjectIterator anonObjItA = 
+				mParentSceneMgr->getAnonymousMovableObjectIterator(typeName);
+			while (objItA.hasMoreElements() || anonObjItA.hasMoreElements())
 			{
-				MovableObject* a = objItA.getNext();
+				MovableObject* a = objItA.hasMoreElements() ? 
+					objItA.getNext() : anonObjItA.getNext();
 				// skip whole group if type doesn't match
 				if (!(a->getTypeFlags() & mQueryTypeMask))
 					break;
@@ -275,12 +255,16 @@ namespace Ogre {
 			Root::getSingleton().getMovableObjectFactoryIterator();
 		while(factIt.hasMoreElements())
 		{
+			const String& typeName = factIt.getNext()->getType();
 			SceneManager::MovableObjectIterator objItA = 
-				mParentSceneMgr->getMovableObjectIterator(
-				factIt.getNext()->getType());
-			while (objItA.hasMoreElements())
+				mParentSceneMgr->getMovableObjectIterator(typeName);
+			// followed by the objects of this type created without a name
+			SceneManager::AnonymousMovableObjectIterator anonObjItA = 
+				mParentSceneMgr->getAnonymousMovableObjectIterator(typeName);
+			while (objItA.hasMoreElements() || anonObjItA.hasMoreElements())
 			{
-				MovableObject* a = objItA.getNext();
+				MovableObject* a = objItA.hasMoreElements() ? 
+					objItA.getNext() : anonObjItA.getNext();
 				// skip whole group if type doesn't match
 				if (!(a->getTypeFlags() & mQueryTypeMask))
 					break;
@@ -28,6 +28,7 @@
 #include "OgreStableHeaders.h"
 #include "OgreDeflate.h"
 #include "OgreException.h"
+#include "OgreWorkQueue.h"
 
 #include <zlib.h>
 
@@ -43,6 +44,99 @@ namespace Ogre
 		OGRE_FREE(address, MEMCATEGORY_GENERAL);
 	}
 	#define OGRE_DEFLATE_TMP_SIZE 16384
+
+	namespace
+	{
+		/// 'OGZC', the start of a chunked stream
+		const uint32 CHUNKED_MAGIC = 'O' | ('G' << 8) | ('Z' << 16) | ('C' << 24);
+		const uint32 CHUNKED_VERSION = 1;
+		/// Magic, version, chunk size, chunk count and 64 bit uncompressed size
+		const size_t CHUNKED_HEADER_SIZE = 24;
+
+		// The chunked header and index are little endian
+		void writeUInt32(uchar* p, uint32 v)
+		{
+			for (size_t i = 0; i < 4; ++i)
+				p[i] = static_cast<uchar>(v >> (i * 8));
+		}
+		uint32 readUInt32(const uchar* p)
+		{
+			return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32)p[3] << 24);
+		}
+
+		/// Holds the written data until the stream is closed, when no temp file is used
+		class GrowableMemoryStream : public DataStream
+		{
+		public:
+			vector<uchar>::type mData;
+			size_t mPos;
+
+			GrowableMemoryStream() : DataStream(READ | WRITE), mPos(0) {}
+
+			size_t read(void* buf, size_t count)
+			{
+				count = std::min(count, mData.size() - mPos);
+				if (count)
+					memcpy(buf, &mData[mPos], count);
+				mPos += count;
+				return count;
+			}
+			size_t write(const void* buf, size_t count)
+			{
+				if (mPos + count > mData.size())
+					mData.resize(mPos + count);
+				if (count)
+					memcpy(&mData[mPos], buf, count);
+				mPos += count;
+				mSize = mData.size();
+				return count;
+			}
+			void skip(long count) { seek(static_cast<size_t>(static_cast<long>(mPos) + count)); }
+			void seek(size_t pos) { mPos = std::min(pos, mData.size()); }
+			size_t tell(void) const { return mPos; }
+			bool eof(void) const { return mPos >= mData.size(); }
+			void close(void) {}
+		};
+
+		/** Deflates chunks, each into its own buffer. A buffer is left empty if 
+			its chunk fails, a successful deflate stream never is.
+		*/
+		struct ChunkTask : public WorkQueue::ParallelTask
+		{
+			const uchar* data;
+			size_t size;
+			size_t chunkSize;
+			vector<uchar>::type* compressed;
+
+			void execute(size_t chunkBegin, size_t chunkEnd)
+			{
+				z_stream zs;
+				zs.zalloc = OgreZalloc;
+				zs.zfree = OgreZfree;
+				zs.opaque = 0;
+				if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK)
+					return;
+				for (size_t i = chunkBegin; i < chunkEnd; ++i)
+				{
+					size_t offset = i * chunkSize;
+					uLong inSize = static_cast<uLong>(std::min(chunkSize, size - offset));
+					vector<uchar>::type& out = compressed[i];
+					out.resize(deflateBound(&zs, inSize));
+
+					deflateReset(&zs);
+					zs.next_in = const_cast<Bytef*>(data + offset);
+					zs.avail_in = static_cast<uInt>(inSize);
+					zs.next_out = &out[0];
+					zs.avail_out = static_cast<uInt>(out.size());
+					if (deflate(&zs, Z_FINISH) == Z_STREAM_END)
+						out.resize(out.size() - zs.avail_out);
+					else
+						out.clear();
+				}
+				deflateEnd(&zs);
+			}
+		};
+	}
     //---------------------------------------------------------------------
 	DeflateStream::DeflateStream(const DataStreamPtr& compressedStream, const String& tmpFileName)
 	: DataStream(compressedStream->getAccessMode())
@@ -52,6 +146,9 @@ namespace Ogre
 	, mCurrentPos(0)
 	, mTmp(0)
 	, mIsCompressedValid(true)
+	, mCompressedStart(0)
+	, mChunkSize(0)
+	, mCurrentChunk(0)
 	{
 		init();
 	}
@@ -64,6 +161,9 @@ namespace Ogre
 	, mCurrentPos(0)
 	, mTmp(0)
 	, mIsCompressedValid(true)
+	, mCompressedStart(0)
+	, mChunkSize(0)
+	, mCurrentChunk(0)
 	{
 		init();
 	}
@@ -78,6 +178,7 @@ namespace Ogre
 		{
 			mTmp = (unsigned char*)OGRE_MALLOC(OGRE_DEFLATE_TMP_SIZE, MEMCATEGORY_GENERAL);
 			size_t restorePoint = mCompressedStream->tell();
+			mCompressedStart = restorePoint;
 			// read early chunk
 			mZStream->next_in = mTmp;
 			mZStream->avail_in = mCompressedStream->read(mTmp, OGRE_DEFLATE_TMP_SIZE);
@@ -89,7 +190,17 @@ namespace Ogre
 			else
 				mIsCompressedValid = true;
 			
-			if (mIsCompressedValid)
+			if (mIsCompressedValid && mZStream->avail_in >= 4 && readUInt32(mTmp) == CHUNKED_MAGIC)
+			{
+				if (!initChunked())
+				{
+					destroy();
+					OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+								"Malformed chunked deflate stream " + getName(),
+								"DeflateStream::init");
+				}
+			}
+			else if (mIsCompressedValid)
 			{
 				// in fact, inflateInit on some implementations doesn't try to read
 				// anything. We need to at least read something to test
@@ -114,30 +225,13 @@ namespace Ogre
 				mCompressedStream->seek(restorePoint);
 			}				
 		}
-		else 
+		else if (mTempFileName.empty())
+		{
+			// Keep the data in memory until it's compressed
+			mTmpWriteStream = DataStreamPtr(OGRE_NEW GrowableMemoryStream());
+		}
+		else
 		{
-            if(mTempFileName.empty())
-            {
-                // Write to temp file
-#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
-                char* tmpname = _tempnam(".", "ogre");
-                if (!tmpname)
-                {
-                    // Having no file name here will cause various problems later.
-                    OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Temporary file name generation failed.", "DeflateStream::init");
-                }
-                else
-                {
-                    mTempFileName = tmpname;
-                    free(tmpname);
-                }
-#else
-                char tmpname[L_tmpnam];
-                tmpnam(tmpname);
-                mTempFileName = tmpname;
-#endif
-            }
-
 			std::fstream *f = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL)();
 			f->open(mTempFileName.c_str(), std::ios::binary | std::ios::out);
 			mTmpWriteStream = DataStreamPtr(OGRE_NEW FileStreamDataStream(f));
@@ -145,6 +239,51 @@ namespace Ogre
 		}
 
 	}
+    //---------------------------------------------------------------------
+	bool DeflateStream::initChunked()
+	{
+		uchar header[CHUNKED_HEADER_SIZE];
+		mCompressedStream->seek(mCompressedStart);
+		if (mCompressedStream->read(header, CHUNKED_HEADER_SIZE) != CHUNKED_HEADER_SIZE ||
+			readUInt32(header + 4) != CHUNKED_VERSION)
+			return false;
+
+		mChunkSize = readUInt32(header + 8);
+		size_t numChunks = readUInt32(header + 12);
+		uint64 size = readUInt32(header + 16) | ((uint64)readUInt32(header + 20) << 32);
+		mSize = static_cast<size_t>(size);
+		if (!mChunkSize || numChunks != (mSize + mChunkSize - 1) / mChunkSize)
+			return false;
+
+		size_t streamSize = mCompressedStream->size();
+		if (streamSize && numChunks > (streamSize - mCompressedStart) / 4)
+			return false;
+
+		vector<uchar>::type index(numChunks * 4);
+		if (numChunks && mCompressedStream->read(&index[0], index.size()) != index.size())
+			return false;
+
+		// Offsets from the start of the stream, so the index is included.
+		// Every chunk holds data, so none can deflate to nothing.
+		mChunkOffsets.resize(numChunks + 1);
+		mChunkOffsets[0] = CHUNKED_HEADER_SIZE + index.size();
+		for (size_t i = 0; i < numChunks; ++i)
+		{
+			uint32 compressedSize = readUInt32(&index[i * 4]);
+			if (!compressedSize)
+				return false;
+			mChunkOffsets[i + 1] = mChunkOffsets[i] + compressedSize;
+		}
+		if (streamSize && mCompressedStart + mChunkOffsets.back() > streamSize)
+			return false;
+
+		mCurrentChunk = numChunks;
+		mChunkData.resize(mChunkSize);
+		// Leave the stream after the container, like a plain deflate stream 
+		// read to its end, so that whatever follows can be read
+		mCompressedStream->seek(mCompressedStart + mChunkOffsets.back());
+		return true;
+	}
     //---------------------------------------------------------------------
 	void DeflateStream::destroy()
 	{
@@ -162,6 +301,16 @@ namespace Ogre
 		close();
 		destroy();
 	}
+	//---------------------------------------------------------------------
+	void DeflateStream::setChunkSize(size_t chunkSize)
+	{
+		if ((getAccessMode() & WRITE) == 0)
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+						"The chunk size of a stream being read comes from the stream", 
+						"DeflateStream::setChunkSize");
+
+		mChunkSize = chunkSize;
+	}
     //---------------------------------------------------------------------
 	size_t DeflateStream::read(void* buf, size_t count)
 	{
@@ -174,6 +323,10 @@ namespace Ogre
 		{
 			return mTmpWriteStream->read(buf, count);
 		}
+		else if (mChunkSize)
+		{
+			return readChunked(buf, count);
+		}
 		else 
 		{
 
@@ -223,17 +376,68 @@ namespace Ogre
 							break;
 						}
 					}
+					else
+					{
+						// Truncated data, nothing left to inflate
+						break;
+					}
 				}
 			}
 			
-			// Cache the last bytes read
-			mReadCache.cacheData((char*)buf + cachereads, newReadUncompressed);
+			// Cache the last bytes read; caching nothing would move the
+			// cache position to its end and lose the rest of a rewound read
+			if (newReadUncompressed)
+				mReadCache.cacheData((char*)buf + cachereads, newReadUncompressed);
 			
 			mCurrentPos += newReadUncompressed + cachereads;
 			
 			return newReadUncompressed + cachereads;
 		}
 	}
+    //---------------------------------------------------------------------
+	size_t DeflateStream::readChunked(void* buf, size_t count)
+	{
+		count = std::min(count, mSize - std::min(mCurrentPos, mSize));
+		uchar* dst = static_cast<uchar*>(buf);
+		size_t done = 0;
+		while (done < count)
+		{
+			size_t chunk = mCurrentPos / mChunkSize;
+			if (chunk != mCurrentChunk)
+			{
+				// Inflate the whole chunk, reads around this position are likely
+				size_t compressedSize = mChunkOffsets[chunk + 1] - mChunkOffsets[chunk];
+				mChunkCompressed.resize(compressedSize);
+				mCompressedStream->seek(mCompressedStart + mChunkOffsets[chunk]);
+				size_t expected = std::min(mChunkSize, mSize - chunk * mChunkSize);
+				bool ok = mCompressedStream->read(&mChunkCompressed[0], compressedSize) == compressedSize;
+				if (ok)
+				{
+					inflateReset(mZStream);
+					mZStream->next_in = &mChunkCompressed[0];
+					mZStream->avail_in = static_cast<uInt>(compressedSize);
+					mZStream->next_out = &mChunkData[0];
+					mZStream->avail_out = static_cast<uInt>(expected);
+					ok = inflate(mZStream, Z_FINISH) == Z_STREAM_END && mZStream->avail_out == 0;
+				}
+				mCompressedStream->seek(mCompressedStart + mChunkOffsets.back());
+				if (!ok)
+				{
+					mCurrentChunk = mChunkOffsets.size() - 1;
+					OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+								"Error in compressed stream",
+								"DeflateStream::read");
+				}
+				mCurrentChunk = chunk;
+			}
+			size_t offset = mCurrentPos - chunk * mChunkSize;
+			size_t n = std::min(count - done, mChunkSize - offset);
+			memcpy(dst + done, &mChunkData[offset], n);
+			done += n;
+			mCurrentPos += n;
+		}
+		return done;
+	}
     //---------------------------------------------------------------------
 	size_t DeflateStream::write(const void* buf, size_t count)
 	{
@@ -246,13 +450,40 @@ namespace Ogre
     //---------------------------------------------------------------------
 	void DeflateStream::compressFinal()
 	{
-		// Close temp stream
-		mTmpWriteStream->close();
+		// Close temp stream, only once
+		DataStreamPtr tmpStream = mTmpWriteStream;
+		mTmpWriteStream.setNull();
+		tmpStream->close();
 		
 		// Copy & compress
 		// We do this rather than compress directly because some code seeks
 		// around while writing (e.g. to update size blocks) which is not
 		// possible when compressing on the fly
+
+		if (mTempFileName.empty())
+		{
+			GrowableMemoryStream* data = static_cast<GrowableMemoryStream*>(tmpStream.get());
+			compressChunks(data->mData.empty() ? 0 : &data->mData[0], data->mData.size());
+			return;
+		}
+
+		std::ifstream inFile;
+		inFile.open(mTempFileName.c_str(), std::ios::in | std::ios::binary);
+		if (mChunkSize)
+		{
+			// Chunks are compressed in parallel from memory
+			vector<uchar>::type data;
+			char in[OGRE_DEFLATE_TMP_SIZE];
+			do
+			{
+				inFile.read(in, OGRE_DEFLATE_TMP_SIZE);
+				data.insert(data.end(), in, in + inFile.gcount());
+			} while (inFile.good());
+			inFile.close();
+			remove(mTempFileName.c_str());
+			compressChunks(data.empty() ? 0 : &data[0], data.size());
+			return;
+		}
 		
 		int ret, flush;
 		char in[OGRE_DEFLATE_TMP_SIZE];
@@ -266,9 +497,6 @@ namespace Ogre
 						"DeflateStream::init");
 		}
 		
-		std::ifstream inFile;
-		inFile.open(mTempFileName.c_str(), std::ios::in | std::ios::binary);
-		
 		do 
 		{
 			inFile.read(in, OGRE_DEFLATE_TMP_SIZE);
@@ -306,6 +534,76 @@ namespace Ogre
 		remove(mTempFileName.c_str());
 						
 	}
+    //---------------------------------------------------------------------
+	void DeflateStream::compressChunks(const uchar* data, size_t size)
+	{
+		if (!mChunkSize)
+		{
+			// A single deflate stream, in one go
+			char out[OGRE_DEFLATE_TMP_SIZE];
+			if (deflateInit(mZStream, Z_DEFAULT_COMPRESSION) != Z_OK)
+			{
+				OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+							"Error initialising deflate compressed stream!",
+							"DeflateStream::compressChunks");
+			}
+			mZStream->next_in = const_cast<Bytef*>(data);
+			mZStream->avail_in = static_cast<uInt>(size);
+			int ret;
+			do
+			{
+				mZStream->avail_out = OGRE_DEFLATE_TMP_SIZE;
+				mZStream->next_out = (Bytef*)out;
+				ret = deflate(mZStream, Z_FINISH);
+				assert(ret != Z_STREAM_ERROR);
+				mCompressedStream->write(out, OGRE_DEFLATE_TMP_SIZE - mZStream->avail_out);
+			} while (ret != Z_STREAM_END);
+			deflateEnd(mZStream);
+			return;
+		}
+
+		const size_t numChunks = (size + mChunkSize - 1) / mChunkSize;
+		vector<vector<uchar>::type>::type compressed(numChunks);
+
+		ChunkTask task;
+		task.data = data;
+		task.size = size;
+		task.chunkSize = mChunkSize;
+		task.compressed = numChunks ? &compressed[0] : 0;
+		WorkQueue::defaultParallelFor(task, numChunks);
+
+		for (size_t i = 0; i < numChunks; ++i)
+		{
+			if (compressed[i].empty())
+				OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+							"Error compressing chunked stream!",
+							"DeflateStream::compressChunks");
+		}
+
+		// Header and index of the compressed chunk sizes, then the chunks
+		vector<uchar>::type header(CHUNKED_HEADER_SIZE + numChunks * 4);
+		writeUInt32(&header[0], CHUNKED_MAGIC);
+		writeUInt32(&header[4], CHUNKED_VERSION);
+		writeUInt32(&header[8], static_cast<uint32>(mChunkSize));
+		writeUInt32(&header[12], static_cast<uint32>(numChunks));
+		writeUInt32(&header[16], static_cast<uint32>(size));
+		writeUInt32(&header[20], static_cast<uint32>(static_cast<uint64>(size) >> 32));
+		for (size_t i = 0; i < numChunks; ++i)
+			writeUInt32(&header[CHUNKED_HEADER_SIZE + i * 4], static_cast<uint32>(compressed[i].size()));
+		mCompressedStream->write(&header[0], header.size());
+		for (size_t i = 0; i < numChunks; ++i)
+			mCompressedStream->write(&compressed[i][0], compressed[i].size());
+	}
+    //---------------------------------------------------------------------
+	void DeflateStream::restartInflate()
+	{
+		mCurrentPos = 0;
+		mReadCache.clear();
+		mZStream->next_in = mTmp;
+		mCompressedStream->seek(mCompressedStart);
+		mZStream->avail_in = mCompressedStream->read(mTmp, OGRE_DEFLATE_TMP_SIZE);			
+		inflateReset(mZStream);
+	}
     //---------------------------------------------------------------------
 	void DeflateStream::skip(long count)
 	{
@@ -321,28 +619,8 @@ namespace Ogre
 		}
 		else 
 		{
-			if (count > 0)
-			{
-				if (!mReadCache.ff(count))
-				{
-					OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-								"You can only skip within the cache range in a deflate stream.",
-								"DeflateStream::skip");
-				}
-			}
-			else if (count < 0)
-			{
-				if (!mReadCache.rewind((size_t)(-count)))
-				{
-					OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-								"You can only skip within the cache range in a deflate stream.",
-								"DeflateStream::skip");
-				}
-			}
-		}		
-		mCurrentPos = static_cast<size_t>(static_cast<long>(mCurrentPos) + count);
-		
-		
+			seek(static_cast<size_t>(std::max(static_cast<long>(mCurrentPos) + count, 0L)));
+		}
 	}
     //---------------------------------------------------------------------
 	void DeflateStream::seek( size_t pos )
@@ -356,19 +634,30 @@ namespace Ogre
 		{
 			mTmpWriteStream->seek(pos);
 		}
+		else if (mChunkSize)
+		{
+			// Only the chunk containing pos will need inflating
+			mCurrentPos = std::min(pos, mSize);
+		}
 		else
 		{
-			if (pos == 0)
+			if (pos < mCurrentPos)
 			{
-				mCurrentPos = 0;
-				mZStream->next_in = mTmp;
-				mCompressedStream->seek(0);
-				mZStream->avail_in = mCompressedStream->read(mTmp, OGRE_DEFLATE_TMP_SIZE);			
-				inflateReset(mZStream);
+				if (mReadCache.rewind(mCurrentPos - pos))
+				{
+					mCurrentPos = pos;
+					return;
+				}
+				// Gone from the cache, inflate again from the start
+				restartInflate();
 			}
-			else 
+
+			// Inflate up to pos, the cache is read first
+			char discard[OGRE_DEFLATE_TMP_SIZE];
+			while (mCurrentPos < pos)
 			{
-				skip(pos - tell());
+				if (!read(discard, std::min<size_t>(OGRE_DEFLATE_TMP_SIZE, pos - mCurrentPos)))
+					break;
 			}
 		}		
 	}
@@ -381,7 +670,7 @@ namespace Ogre
 		}
 		else if(getAccessMode() & WRITE) 
 		{
-			return mTmpWriteStream->tell();
+			return mTmpWriteStream.isNull() ? 0 : mTmpWriteStream->tell();
 		}
 		else
 		{
@@ -393,11 +682,13 @@ namespace Ogre
 	bool DeflateStream::eof(void) const
 	{
 		if (getAccessMode() & WRITE)
-			return mTmpWriteStream->eof();
+			return mTmpWriteStream.isNull() || mTmpWriteStream->eof();
 		else 
 		{
 			if (!mIsCompressedValid)
 				return mCompressedStream->eof();
+			else if (mChunkSize)
+				return mCurrentPos >= mSize;
 			else
 				return mCompressedStream->eof() && mZStream->avail_in == 0;
 		}
@@ -405,7 +696,8 @@ namespace Ogre
     //---------------------------------------------------------------------
 	void DeflateStream::close(void)
 	{
-		if (getAccessMode() & WRITE)
+		// Compress once, even if closed again on destruction
+		if ((getAccessMode() & WRITE) && !mTmpWriteStream.isNull())
 		{
 			compressFinal();
 		}
@@ -416,5 +708,3 @@ namespace Ogre
 	
 	
 }
-
-
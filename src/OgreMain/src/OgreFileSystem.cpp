@@ -45,6 +45,16 @@ THE SOFTWARE.
 #   define MAX_PATH MAXPATHLEN
 #endif
 
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+#   include <sys/ioctl.h>
+#   include <linux/fs.h>
+#   include <linux/fiemap.h>
+#endif
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
 #  define WIN32_LEAN_AND_MEAN
 #  if !defined(NOMINMAX) && defined(_MSC_VER)
@@ -404,6 +414,72 @@ namespace Ogre {
 		}
 
 	}
+	//-----------------------------------------------------------------------
+	void FileSystemArchive::prefetch(const StringVector& filenames)
+	{
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || \
+	OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+		for (StringVector::const_iterator i = filenames.begin(); i != filenames.end(); ++i)
+		{
+			String full_path = concatenate_path(mName, *i);
+			int fd = ::open(full_path.c_str(), O_RDONLY);
+			if (fd == -1)
+				continue;
+			// Starts reading the file into the page cache and returns
+#	if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+			struct stat tagStat;
+			if (fstat(fd, &tagStat) == 0)
+			{
+				struct radvisory advice;
+				advice.ra_offset = 0;
+				advice.ra_count = static_cast<int>(tagStat.st_size);
+				fcntl(fd, F_RDADVISE, &advice);
+			}
+#	else
+			posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#	endif
+			::close(fd);
+		}
+#else
+		(void)filenames;
+#endif
+	}
+	//-----------------------------------------------------------------------
+	uint64 FileSystemArchive::getStorageOrder(const String& filename)
+	{
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+		(void)filename;
+		return 0;
+#else
+		String full_path = concatenate_path(mName, filename);
+#	if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+		// Where the file's first extent lies on the device, if the file
+		// system will tell
+		int fd = ::open(full_path.c_str(), O_RDONLY);
+		if (fd != -1)
+		{
+			// Room for the header and a single extent
+			uint64 request[(sizeof(struct fiemap) + sizeof(struct fiemap_extent)) / sizeof(uint64) + 1];
+			memset(request, 0, sizeof(request));
+			struct fiemap* map = reinterpret_cast<struct fiemap*>(request);
+			map->fm_length = FIEMAP_MAX_OFFSET;
+			map->fm_extent_count = 1;
+			// Extents not yet written out (delayed allocation) have no place yet
+			bool mapped = ioctl(fd, FS_IOC_FIEMAP, map) == 0 && map->fm_mapped_extents > 0 &&
+				!(map->fm_extents[0].fe_flags & FIEMAP_EXTENT_UNKNOWN);
+			::close(fd);
+			if (mapped)
+				return map->fm_extents[0].fe_physical;
+		}
+#	endif
+		// Otherwise the inode number, which tends to follow the order files 
+		// were written in and so their placement
+		struct stat tagStat;
+		if (stat(full_path.c_str(), &tagStat) == 0)
+			return static_cast<uint64>(tagStat.st_ino);
+		return 0;
+#endif
+	}
     //-----------------------------------------------------------------------
     const String& FileSystemArchiveFactory::getType(void) const
     {
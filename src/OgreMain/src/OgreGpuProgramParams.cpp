@@ -248,6 +248,19 @@ namespace Ogre
 		ser.importNamedConstants(stream, this);
 	}
 	//---------------------------------------------------------------------
+	const GpuConstantDefinition* GpuNamedConstants::find(const IdString& name) const
+	{
+		if (mIdIndex.size() != map.size())
+		{
+			mIdIndex.clear();
+			for (GpuConstantDefinitionMap::const_iterator i = map.begin(); i != map.end(); ++i)
+				mIdIndex[IdString(i->first)._getInterned()] = i->second;
+		}
+
+		GpuConstantDefinitionIdMap::const_iterator i = mIdIndex.find(name._getInterned());
+		return i == mIdIndex.end() ? 0 : &(i->second);
+	}
+	//---------------------------------------------------------------------
 	//  GpuNamedConstantsSerializer methods
 	//---------------------------------------------------------------------
 	GpuNamedConstantsSerializer::GpuNamedConstantsSerializer()
@@ -1457,6 +1470,25 @@ namespace Ogre
 		}
 	}
 	//-----------------------------------------------------------------------------
+	const GpuConstantDefinition* 
+		GpuProgramParameters::_findNamedConstantDefinition(const IdString& name, 
+		bool throwExceptionIfNotFound) const
+	{
+		const GpuConstantDefinition* def = 
+			mNamedConstants.isNull() ? 0 : mNamedConstants->find(name);
+		if (!def && throwExceptionIfNotFound)
+		{
+			if (mNamedConstants.isNull())
+				OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+				"Named constants have not been initialised, perhaps a compile error.",
+				"GpuProgramParameters::_findNamedConstantDefinition");
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+				"Parameter called " + name.getString() + " does not exist. ",
+				"GpuProgramParameters::_findNamedConstantDefinition");
+		}
+		return def;
+	}
+	//-----------------------------------------------------------------------------
 	void GpuProgramParameters::setAutoConstant(size_t index, AutoConstantType acType, size_t extraInfo)
 	{
 		// Get auto constant definition for sizing
@@ -2356,6 +2388,54 @@ namespace Ogre
 			_writeRawConstant(def->physicalIndex, colour, def->elementSize);
 	}
 	//---------------------------------------------------------------------------
+	void GpuProgramParameters::setNamedConstant(const IdString& name, Real val)
+	{
+		const GpuConstantDefinition* def = 
+			_findNamedConstantDefinition(name, !mIgnoreMissingParams);
+		if (def)
+			_writeRawConstant(def->physicalIndex, val);
+	}
+	//---------------------------------------------------------------------------
+	void GpuProgramParameters::setNamedConstant(const IdString& name, int val)
+	{
+		const GpuConstantDefinition* def = 
+			_findNamedConstantDefinition(name, !mIgnoreMissingParams);
+		if (def)
+			_writeRawConstant(def->physicalIndex, val);
+	}
+	//---------------------------------------------------------------------------
+	void GpuProgramParameters::setNamedConstant(const IdString& name, const Vector4& vec)
+	{
+		const GpuConstantDefinition* def = 
+			_findNamedConstantDefinition(name, !mIgnoreMissingParams);
+		if (def)
+			_writeRawConstant(def->physicalIndex, vec, def->elementSize);
+	}
+	//---------------------------------------------------------------------------
+	void GpuProgramParameters::setNamedConstant(const IdString& name, const Vector3& vec)
+	{
+		const GpuConstantDefinition* def = 
+			_findNamedConstantDefinition(name, !mIgnoreMissingParams);
+		if (def)
+			_writeRawConstant(def->physicalIndex, vec);
+	}
+	//---------------------------------------------------------------------------
+	void GpuProgramParameters::setNamedConstant(const IdString& name, const Matrix4& m)
+	{
+		const GpuConstantDefinition* def = 
+			_findNamedConstantDefinition(name, !mIgnoreMissingParams);
+		if (def)
+			_writeRawConstant(def->physicalIndex, m, def->elementSize);
+	}
+	//---------------------------------------------------------------------------
+	void GpuProgramParameters::setNamedConstant(const IdString& name, const ColourValue& colour)
+	{
+		const GpuConstantDefinition* def = 
+			_findNamedConstantDefinition(name, !mIgnoreMissingParams);
+		if (def)
+			_writeRawConstant(def->physicalIndex, colour, def->elementSize);
+	}
+	//---------------------------------------------------------------------------
 	void GpuProgramParameters::setNamedConstant(const String& name, 
 		const int *val, size_t count, size_t multiple)
 	{
@@ -0,0 +1,82 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreIdString.h"
+#include "OgreCommon.h"
+#include "OgreString.h"
+
+namespace Ogre {
+
+	namespace
+	{
+		typedef HashMap<String, uint32> InternTable;
+
+		struct InternState
+		{
+			InternTable table;
+			OGRE_MUTEX(mutex)
+		};
+
+		// Function static so the table and its mutex exist before any other
+		// static is built, whichever translation unit that static lives in
+		InternState& getInternState(void)
+		{
+			static InternState state;
+			return state;
+		}
+	}
+	//-----------------------------------------------------------------------
+	void IdString::intern(const String& str)
+	{
+		InternState& state = getInternState();
+		OGRE_LOCK_MUTEX(state.mutex)
+		InternTable& table = state.table;
+		InternTable::iterator i = table.find(str);
+		if (i == table.end())
+		{
+			uint32 hash = FastHash(str.c_str(), static_cast<int>(str.size()));
+			i = table.insert(InternTable::value_type(str, hash)).first;
+		}
+		// Nodes of the table never move, so the key address is stable
+		mString = &i->first;
+		mHash = i->second;
+	}
+	//-----------------------------------------------------------------------
+	const String& IdString::getString(void) const
+	{
+		return mString ? *mString : StringUtil::BLANK;
+	}
+	//-----------------------------------------------------------------------
+	size_t IdString::getInternedCount(void)
+	{
+		InternState& state = getInternState();
+		OGRE_LOCK_MUTEX(state.mutex)
+		return state.table.size();
+	}
+
+}
@@ -33,8 +33,133 @@ THE SOFTWARE.
 #include "OgreColourValue.h"
 #include "OgreMath.h"
 #include "OgreImageResampler.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
+	namespace
+	{
+		/// Splitting a scale across threads doesn't pay off below this amount of pixels per range
+		const size_t MIN_PIXELS_PER_SCALE_TASK = 64 * 1024;
+
+		/// Signature shared by the resamplers in OgreImageResampler.h
+		typedef void (*ResampleFunc)(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd);
+
+		/// Rows scaled by one of the resamplers
+		struct ResampleTask : public WorkQueue::ParallelTask
+		{
+			ResampleFunc func;
+			const PixelBox* src;
+			const PixelBox* dst;
+
+			void execute(size_t begin, size_t end) { func(*src, *dst, begin, end); }
+		};
+
+		/// Rows of one SeparableResampler pass
+		struct SeparableTask : public WorkQueue::ParallelTask
+		{
+			const SeparableResampler::Contributions* contrib;
+			const float* src;
+			float* dst;
+			/// Filter along x if set, otherwise blend rows along y or z
+			bool columns;
+			size_t srcWidth;
+			size_t dstWidth;
+			size_t innerCount;
+			size_t srcAxisSize;
+			size_t dstAxisSize;
+
+			void execute(size_t begin, size_t end)
+			{
+				if (columns)
+					SeparableResampler::filterColumns(src, srcWidth, dst, dstWidth, *contrib, begin, end);
+				else
+					SeparableResampler::filterRows(src, dst, dstWidth * 4, innerCount, 
+						srcAxisSize, dstAxisSize, *contrib, begin, end);
+			}
+		};
+
+		/** Runs task over numRows rows, in ranges big enough for threads to pay off.
+		@param pixelsPerRow The number of pixels written per row
+		*/
+		void runInBands(WorkQueue::ParallelTask& task, size_t numRows, size_t pixelsPerRow)
+		{
+			size_t grainSize = MIN_PIXELS_PER_SCALE_TASK / std::max<size_t>(pixelsPerRow, 1);
+			WorkQueue::defaultParallelFor(task, numRows, std::max<size_t>(grainSize, 1));
+		}
+
+		/// Scales with one of the resamplers, in bands if the source isn't overwritten
+		void resample(ResampleFunc func, const PixelBox& src, const PixelBox& dst)
+		{
+			ResampleTask task;
+			task.func = func;
+			task.src = &src;
+			task.dst = &dst;
+			if (src.data == dst.data)
+				task.execute(0, dst.getHeight());
+			else
+				runInBands(task, dst.getHeight(), dst.getWidth() * dst.getDepth());
+		}
+
+		/// Scales with SeparableResampler, one axis at a time
+		void resampleSeparable(const PixelBox& src, const PixelBox& dst, 
+			SeparableResampler::Kernel kernel)
+		{
+			size_t width = src.getWidth(), height = src.getHeight(), depth = src.getDepth();
+			size_t dstWidth = dst.getWidth(), dstHeight = dst.getHeight(), dstDepth = dst.getDepth();
+
+			// Convert to floats, the passes alternate between the two buffers
+			vector<float>::type buffer(width * height * depth * 4), output;
+			PixelUtil::bulkPixelConversion(src, PixelBox(width, height, depth, PF_FLOAT32_RGBA, &buffer[0]));
+
+			SeparableResampler::Contributions contrib;
+			SeparableTask job;
+			job.contrib = &contrib;
+			if (dstWidth != width)
+			{
+				contrib.compute(width, dstWidth, kernel);
+				output.resize(dstWidth * height * depth * 4);
+				job.src = &buffer[0];
+				job.dst = &output[0];
+				job.columns = true;
+				job.srcWidth = width;
+				job.dstWidth = dstWidth;
+				runInBands(job, height * depth, dstWidth);
+				buffer.swap(output);
+				width = dstWidth;
+			}
+			job.columns = false;
+			job.dstWidth = width;
+			if (dstHeight != height)
+			{
+				contrib.compute(height, dstHeight, kernel);
+				output.resize(width * dstHeight * depth * 4);
+				job.src = &buffer[0];
+				job.dst = &output[0];
+				job.innerCount = 1;
+				job.srcAxisSize = height;
+				job.dstAxisSize = dstHeight;
+				runInBands(job, dstHeight * depth, width);
+				buffer.swap(output);
+				height = dstHeight;
+			}
+			if (dstDepth != depth)
+			{
+				contrib.compute(depth, dstDepth, kernel);
+				output.resize(width * height * dstDepth * 4);
+				job.src = &buffer[0];
+				job.dst = &output[0];
+				job.innerCount = height;
+				job.srcAxisSize = depth;
+				job.dstAxisSize = dstDepth;
+				runInBands(job, height * dstDepth, width);
+				buffer.swap(output);
+				depth = dstDepth;
+			}
+
+			PixelUtil::bulkPixelConversion(PixelBox(width, height, depth, PF_FLOAT32_RGBA, &buffer[0]), dst);
+		}
+	}
+
 	ImageCodec::~ImageCodec() {
 	}
 
@@ -340,6 +465,7 @@ namespace Ogre {
 		imgData->width = mWidth;
 		imgData->depth = mDepth;
 		imgData->size = mBufSize;
+		imgData->num_mipmaps = static_cast<ushort>(mNumMipmaps);
 		// Wrap in CodecDataPtr, this will delete
 		Codec::CodecDataPtr codeDataPtr(imgData);
 		// Wrap memory, be sure not to delete when stream destroyed
@@ -591,8 +717,17 @@ namespace Ogre {
 		assert(PixelUtil::isAccessible(scaled.format));
 		MemoryDataStreamPtr buf; // For auto-delete
 		PixelBox temp;
+		ResampleFunc func = 0;
 		switch (filter) 
 		{
+		case FILTER_LANCZOS:
+			resampleSeparable(src, scaled, SeparableResampler::KERNEL_LANCZOS);
+			break;
+
+		case FILTER_KAISER:
+			resampleSeparable(src, scaled, SeparableResampler::KERNEL_KAISER);
+			break;
+
 		default:
 		case FILTER_NEAREST:
 			if(src.format == scaled.format) 
@@ -610,18 +745,19 @@ namespace Ogre {
 			// super-optimized: no conversion
 			switch (PixelUtil::getNumElemBytes(src.format)) 
 			{
-			case 1: NearestResampler<1>::scale(src, temp); break;
-			case 2: NearestResampler<2>::scale(src, temp); break;
-			case 3: NearestResampler<3>::scale(src, temp); break;
-			case 4: NearestResampler<4>::scale(src, temp); break;
-			case 6: NearestResampler<6>::scale(src, temp); break;
-			case 8: NearestResampler<8>::scale(src, temp); break;
-			case 12: NearestResampler<12>::scale(src, temp); break;
-			case 16: NearestResampler<16>::scale(src, temp); break;
+			case 1: func = NearestResampler<1>::scale; break;
+			case 2: func = NearestResampler<2>::scale; break;
+			case 3: func = NearestResampler<3>::scale; break;
+			case 4: func = NearestResampler<4>::scale; break;
+			case 6: func = NearestResampler<6>::scale; break;
+			case 8: func = NearestResampler<8>::scale; break;
+			case 12: func = NearestResampler<12>::scale; break;
+			case 16: func = NearestResampler<16>::scale; break;
 			default:
 				// never reached
 				assert(false);
 			}
+			resample(func, src, temp);
 			if(temp.data != scaled.data)
 			{
 				// Blit temp buffer
@@ -653,14 +789,15 @@ namespace Ogre {
 				// super-optimized: byte-oriented math, no conversion
 				switch (PixelUtil::getNumElemBytes(src.format)) 
 				{
-				case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-				case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-				case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-				case 4: LinearResampler_Byte<4>::scale(src, temp); break;
+				case 1: func = LinearResampler_Byte<1>::scale; break;
+				case 2: func = LinearResampler_Byte<2>::scale; break;
+				case 3: func = LinearResampler_Byte<3>::scale; break;
+				case 4: func = LinearResampler_Byte<4>::scale; break;
 				default:
 					// never reached
 					assert(false);
 				}
+				resample(func, src, temp);
 				if(temp.data != scaled.data)
 				{
 					// Blit temp buffer
@@ -672,17 +809,53 @@ namespace Ogre {
 				if (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA)
 				{
 					// float32 to float32, avoid unpack/repack overhead
-					LinearResampler_Float32::scale(src, scaled);
+					resample(LinearResampler_Float32::scale, src, scaled);
 					break;
 				}
 				// else, fall through
 			default:
 				// non-optimized: floating-point math, performs conversion but always works
-				LinearResampler::scale(src, scaled);
+				resample(LinearResampler::scale, src, scaled);
 			}
 			break;
 		}
 	}
+	//-----------------------------------------------------------------------
+	void Image::generateMipmaps(Filter filter)
+	{
+		if (PixelUtil::isCompressed(mFormat))
+		{
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+				"Mipmaps can't be generated for compressed images", 
+				"Image::generateMipmaps");
+		}
+
+		// Count the levels down to 1x1
+		size_t numMipmaps = 0;
+		for (size_t w = mWidth, h = mHeight, d = mDepth; w > 1 || h > 1 || d > 1; ++numMipmaps)
+		{
+			if(w!=1) w /= 2;
+			if(h!=1) h /= 2;
+			if(d!=1) d /= 2;
+		}
+		size_t numFaces = getNumFaces();
+
+		// Keep the old buffer in a temp image while the new one is filled
+		Image old;
+		old.loadDynamicImage(mBuffer, mWidth, mHeight, mDepth, mFormat, mAutoDelete, numFaces, mNumMipmaps);
+		mNumMipmaps = numMipmaps;
+		mBufSize = calculateSize(mNumMipmaps, numFaces, mWidth, mHeight, mDepth, mFormat);
+		mBuffer = OGRE_ALLOC_T(uchar, mBufSize, MEMCATEGORY_GENERAL);
+		mAutoDelete = true;
+
+		for (size_t face = 0; face < numFaces; ++face)
+		{
+			PixelBox top = getPixelBox(face, 0);
+			PixelUtil::bulkPixelConversion(old.getPixelBox(face, 0), top);
+			for (size_t mip = 1; mip <= mNumMipmaps; ++mip)
+				Image::scale(getPixelBox(face, mip - 1), getPixelBox(face, mip), filter);
+		}
+	}
 
 	//-----------------------------------------------------------------------------    
 
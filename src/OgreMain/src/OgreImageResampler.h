@@ -29,6 +29,8 @@ THE SOFTWARE.
 #define OGREIMAGERESAMPLER_H
 
 #include <algorithm>
+#include "OgrePlatformInformation.h"
+#include "OgreSIMDHelper.h"
 
 // this file is inlined into OgreImage.cpp!
 // do not include anywhere else.
@@ -47,17 +49,34 @@ namespace Ogre {
 // sx2 = upper-bound integer x-position in source
 // sxf = fractional weight between sx1 and sx2
 // x,y,z = location of output pixel in destination
+//
+// every resampler can write a band of rows only: rowBegin and rowEnd are
+// relative to the top of the destination and apply to each of its slices.
+// bands don't overlap, so several of them can be scaled concurrently.
+
+// true if the SSE resampling paths can be used on this CPU
+inline bool resamplerHasSSE() {
+#if __OGRE_HAVE_SSE
+	return (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE) != 0;
+#else
+	return false;
+#endif
+}
 
 // nearest-neighbor resampler, does not convert formats.
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as simplifying memcpy() and replacing multiplies with bitshifts
 template<unsigned int elemsize> struct NearestResampler {
 	static void scale(const PixelBox& src, const PixelBox& dst) {
+		scale(src, dst, 0, dst.getHeight());
+	}
+
+	static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
 		// assert(src.format == dst.format);
 
-		// srcdata stays at beginning, pdst is a moving pointer
+		// srcdata and dstdata stay at beginning, pdst is a moving pointer
 		uchar* srcdata = (uchar*)src.data;
-		uchar* pdst = (uchar*)dst.data;
+		uchar* dstdata = (uchar*)dst.data;
 
 		// sx_48,sy_48,sz_48 represent current position in source
 		// using 16/48-bit fixed precision, incremented by steps
@@ -68,23 +87,22 @@ template<unsigned int elemsize> struct NearestResampler {
 		// note: ((stepz>>1) - 1) is an extra half-step increment to adjust
 		// for the center of the destination pixel, not the top-left corner
 		uint64 sz_48 = (stepz >> 1) - 1;
-		for (size_t z = dst.front; z < dst.back; z++, sz_48 += stepz) {
+		for (size_t z = 0; z < dst.getDepth(); z++, sz_48 += stepz) {
 			size_t srczoff = (size_t)(sz_48 >> 48) * src.slicePitch;
 			
-			uint64 sy_48 = (stepy >> 1) - 1;
-			for (size_t y = dst.top; y < dst.bottom; y++, sy_48 += stepy) {
+			uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+			for (size_t y = rowBegin; y < rowEnd; y++, sy_48 += stepy) {
 				size_t srcyoff = (size_t)(sy_48 >> 48) * src.rowPitch;
+				uchar* pdst = dstdata + elemsize*(y*dst.rowPitch + z*dst.slicePitch);
 			
 				uint64 sx_48 = (stepx >> 1) - 1;
-				for (size_t x = dst.left; x < dst.right; x++, sx_48 += stepx) {
+				for (size_t x = 0; x < dst.getWidth(); x++, sx_48 += stepx) {
 					uchar* psrc = srcdata +
 						elemsize*((size_t)(sx_48 >> 48) + srcyoff + srczoff);
                     memcpy(pdst, psrc, elemsize);
 					pdst += elemsize;
 				}
-				pdst += elemsize*dst.getRowSkip();
 			}
-			pdst += elemsize*dst.getSliceSkip();
 		}
 	}
 };
@@ -93,12 +111,16 @@ template<unsigned int elemsize> struct NearestResampler {
 // default floating-point linear resampler, does format conversion
 struct LinearResampler {
 	static void scale(const PixelBox& src, const PixelBox& dst) {
+		scale(src, dst, 0, dst.getHeight());
+	}
+
+	static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
 		size_t srcelemsize = PixelUtil::getNumElemBytes(src.format);
 		size_t dstelemsize = PixelUtil::getNumElemBytes(dst.format);
 
-		// srcdata stays at beginning, pdst is a moving pointer
+		// srcdata and dstdata stay at beginning, pdst is a moving pointer
 		uchar* srcdata = (uchar*)src.data;
-		uchar* pdst = (uchar*)dst.data;
+		uchar* dstdata = (uchar*)dst.data;
 		
 		// sx_48,sy_48,sz_48 represent current position in source
 		// using 16/48-bit fixed precision, incremented by steps
@@ -115,23 +137,24 @@ struct LinearResampler {
 		// note: ((stepz>>1) - 1) is an extra half-step increment to adjust
 		// for the center of the destination pixel, not the top-left corner
 		uint64 sz_48 = (stepz >> 1) - 1;
-		for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+		for (size_t z = 0; z < dst.getDepth(); z++, sz_48+=stepz) {
 			temp = static_cast<unsigned int>(sz_48 >> 32);
 			temp = (temp > 0x8000)? temp - 0x8000 : 0;
 			size_t sz1 = temp >> 16;				 // src z, sample #1
 			size_t sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
 			float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-			uint64 sy_48 = (stepy >> 1) - 1;
-			for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+			uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+			for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
 				temp = static_cast<unsigned int>(sy_48 >> 32);
 				temp = (temp > 0x8000)? temp - 0x8000 : 0;
 				size_t sy1 = temp >> 16;					// src y #1
 				size_t sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
 				float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+				uchar* pdst = dstdata + dstelemsize*(y*dst.rowPitch + z*dst.slicePitch);
 				
 				uint64 sx_48 = (stepx >> 1) - 1;
-				for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
+				for (size_t x = 0; x < dst.getWidth(); x++, sx_48+=stepx) {
 					temp = static_cast<unsigned int>(sx_48 >> 32);
 					temp = (temp > 0x8000)? temp - 0x8000 : 0;
 					size_t sx1 = temp >> 16;					// src x #1
@@ -164,26 +187,32 @@ struct LinearResampler {
 
 					pdst += dstelemsize;
 				}
-				pdst += dstelemsize*dst.getRowSkip();
 			}
-			pdst += dstelemsize*dst.getSliceSkip();
 		}
 	}
 };
 
 
 // float32 linear resampler, converts FLOAT32_RGB/FLOAT32_RGBA only.
-// avoids overhead of pixel unpack/repack function calls
+// avoids overhead of pixel unpack/repack function calls.
+// RGBA to RGBA is done with SSE where available
 struct LinearResampler_Float32 {
 	static void scale(const PixelBox& src, const PixelBox& dst) {
+		scale(src, dst, 0, dst.getHeight());
+	}
+
+	static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
 		size_t srcchannels = PixelUtil::getNumElemBytes(src.format) / sizeof(float);
 		size_t dstchannels = PixelUtil::getNumElemBytes(dst.format) / sizeof(float);
 		// assert(srcchannels == 3 || srcchannels == 4);
 		// assert(dstchannels == 3 || dstchannels == 4);
+#if __OGRE_HAVE_SSE
+		bool useSSE = srcchannels == 4 && dstchannels == 4 && resamplerHasSSE();
+#endif
 
-		// srcdata stays at beginning, pdst is a moving pointer
+		// srcdata and dstdata stay at beginning, pdst is a moving pointer
 		float* srcdata = (float*)src.data;
-		float* pdst = (float*)dst.data;
+		float* dstdata = (float*)dst.data;
 		
 		// sx_48,sy_48,sz_48 represent current position in source
 		// using 16/48-bit fixed precision, incremented by steps
@@ -200,28 +229,54 @@ struct LinearResampler_Float32 {
 		// note: ((stepz>>1) - 1) is an extra half-step increment to adjust
 		// for the center of the destination pixel, not the top-left corner
 		uint64 sz_48 = (stepz >> 1) - 1;
-		for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+		for (size_t z = 0; z < dst.getDepth(); z++, sz_48+=stepz) {
 			temp = static_cast<unsigned int>(sz_48 >> 32);
 			temp = (temp > 0x8000)? temp - 0x8000 : 0;
 			size_t sz1 = temp >> 16;				 // src z, sample #1
 			size_t sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
 			float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-			uint64 sy_48 = (stepy >> 1) - 1;
-			for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+			uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+			for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
 				temp = static_cast<unsigned int>(sy_48 >> 32);
 				temp = (temp > 0x8000)? temp - 0x8000 : 0;
 				size_t sy1 = temp >> 16;					// src y #1
 				size_t sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
 				float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+				float* pdst = dstdata + dstchannels*(y*dst.rowPitch + z*dst.slicePitch);
 				
 				uint64 sx_48 = (stepx >> 1) - 1;
-				for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
+				for (size_t x = 0; x < dst.getWidth(); x++, sx_48+=stepx) {
 					temp = static_cast<unsigned int>(sx_48 >> 32);
 					temp = (temp > 0x8000)? temp - 0x8000 : 0;
 					size_t sx1 = temp >> 16;					// src x #1
 					size_t sx2 = std::min(sx1+1,src.getWidth()-1);// src x #2
 					float sxf = (temp & 0xFFFF) / 65536.f; // weight of #2
+
+#if __OGRE_HAVE_SSE
+					if (useSSE) {
+#define SSE_ACCUM4(x,y,z,factor) \
+	accum = _mm_add_ps(accum, _mm_mul_ps(_mm_loadu_ps( \
+		srcdata + (x+y*src.rowPitch+z*src.slicePitch)*4), _mm_set1_ps(factor)))
+
+						// one register holds all four channels of a sample
+						__m128 accum = _mm_setzero_ps();
+						SSE_ACCUM4(sx1,sy1,sz1,(1.0f-sxf)*(1.0f-syf)*(1.0f-szf));
+						SSE_ACCUM4(sx2,sy1,sz1,      sxf *(1.0f-syf)*(1.0f-szf));
+						SSE_ACCUM4(sx1,sy2,sz1,(1.0f-sxf)*      syf *(1.0f-szf));
+						SSE_ACCUM4(sx2,sy2,sz1,      sxf *      syf *(1.0f-szf));
+						if (szf != 0.0f) {
+							SSE_ACCUM4(sx1,sy1,sz2,(1.0f-sxf)*(1.0f-syf)*      szf );
+							SSE_ACCUM4(sx2,sy1,sz2,      sxf *(1.0f-syf)*      szf );
+							SSE_ACCUM4(sx1,sy2,sz2,(1.0f-sxf)*      syf *      szf );
+							SSE_ACCUM4(sx2,sy2,sz2,      sxf *      syf *      szf );
+						}
+						_mm_storeu_ps(pdst, accum);
+						pdst += 4;
+						continue;
+#undef SSE_ACCUM4
+					}
+#endif
 					
 					// process R,G,B,A simultaneously for cache coherence?
 					float accum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
@@ -268,9 +323,7 @@ struct LinearResampler_Float32 {
 
 					pdst += dstchannels;
 				}
-				pdst += dstchannels*dst.getRowSkip();
 			}
-			pdst += dstchannels*dst.getSliceSkip();
 		}
 	}
 };
@@ -281,20 +334,25 @@ struct LinearResampler_Float32 {
 // only handles pixel formats that use 1 byte per color channel.
 // 2D only; punts 3D pixelboxes to default LinearResampler (slow).
 // templated on bytes-per-pixel to allow compiler optimizations, such
-// as unrolling loops and replacing multiplies with bitshifts
+// as unrolling loops and replacing multiplies with bitshifts.
+// 4 byte pixels are blended with SSE2 where available
 template<unsigned int channels> struct LinearResampler_Byte {
 	static void scale(const PixelBox& src, const PixelBox& dst) {
+		scale(src, dst, 0, dst.getHeight());
+	}
+
+	static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
 		// assert(src.format == dst.format);
 
 		// only optimized for 2D
 		if (src.getDepth() > 1 || dst.getDepth() > 1) {
-			LinearResampler::scale(src, dst);
+			LinearResampler::scale(src, dst, rowBegin, rowEnd);
 			return;
 		}
 
-		// srcdata stays at beginning of slice, pdst is a moving pointer
+		// srcdata and dstdata stay at beginning of slice, pdst is a moving pointer
 		uchar* srcdata = (uchar*)src.data;
-		uchar* pdst = (uchar*)dst.data;
+		uchar* dstdata = (uchar*)dst.data;
 
 		// sx_48,sy_48 represent current position in source
 		// using 16/48-bit fixed precision, incremented by steps
@@ -306,38 +364,244 @@ template<unsigned int channels> struct LinearResampler_Byte {
 		// integer bits represent the first sample (eg, sx1) and the
 		// fractional bits are the blend weight of the second sample
 		unsigned int temp;
+
+		// the source columns and their weights are the same for every row,
+		// sxoff1 and sxoff2 are byte offsets
+		size_t dstwidth = dst.getWidth();
+		vector<size_t>::type sxoff1(dstwidth), sxoff2(dstwidth);
+		vector<unsigned int>::type sxfs(dstwidth);
+		uint64 sx_48 = (stepx >> 1) - 1;
+		for (size_t x = 0; x < dstwidth; x++, sx_48+=stepx) {
+			temp = static_cast<unsigned int>(sx_48 >> 36);
+			temp = (temp > 0x800)? temp - 0x800 : 0;
+			sxfs[x] = temp & 0xFFF;
+			size_t sx1 = temp >> 12;
+			sxoff1[x] = sx1 * channels;
+			sxoff2[x] = std::min(sx1+1, src.right-src.left-1) * channels;
+		}
 		
-		uint64 sy_48 = (stepy >> 1) - 1;
-		for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+		uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+		for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
 			temp = static_cast<unsigned int>(sy_48 >> 36);
 			temp = (temp > 0x800)? temp - 0x800: 0;
 			unsigned int syf = temp & 0xFFF;
 			size_t sy1 = temp >> 12;
 			size_t sy2 = std::min(sy1+1, src.bottom-src.top-1);
-			size_t syoff1 = sy1 * src.rowPitch;
-			size_t syoff2 = sy2 * src.rowPitch;
-
-			uint64 sx_48 = (stepx >> 1) - 1;
-			for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
-				temp = static_cast<unsigned int>(sx_48 >> 36);
-				temp = (temp > 0x800)? temp - 0x800 : 0;
-				unsigned int sxf = temp & 0xFFF;
-				size_t sx1 = temp >> 12;
-				size_t sx2 = std::min(sx1+1, src.right-src.left-1);
+			const uchar* srcrow1 = srcdata + sy1 * src.rowPitch * channels;
+			const uchar* srcrow2 = srcdata + sy2 * src.rowPitch * channels;
+			uchar* pdst = dstdata + y * dst.rowPitch * channels;
+
+#if __OGRE_HAVE_SSE2
+			if (channels == 4) {
+				scaleRowSSE2(srcrow1, srcrow2, syf, &sxoff1[0], &sxoff2[0], &sxfs[0], dstwidth, pdst);
+				continue;
+			}
+#endif
 
+			for (size_t x = 0; x < dstwidth; x++) {
+				unsigned int sxf = sxfs[x];
 				unsigned int sxfsyf = sxf*syf;
 				for (unsigned int k = 0; k < channels; k++) {
 					unsigned int accum =
-						srcdata[(sx1 + syoff1)*channels+k]*(0x1000000-(sxf<<12)-(syf<<12)+sxfsyf) +
-						srcdata[(sx2 + syoff1)*channels+k]*((sxf<<12)-sxfsyf) +
-						srcdata[(sx1 + syoff2)*channels+k]*((syf<<12)-sxfsyf) +
-						srcdata[(sx2 + syoff2)*channels+k]*sxfsyf;
+						srcrow1[sxoff1[x]+k]*(0x1000000-(sxf<<12)-(syf<<12)+sxfsyf) +
+						srcrow1[sxoff2[x]+k]*((sxf<<12)-sxfsyf) +
+						srcrow2[sxoff1[x]+k]*((syf<<12)-sxfsyf) +
+						srcrow2[sxoff2[x]+k]*sxfsyf;
 					// accum is computed using 8/24-bit fixed-point math
 					// (maximum is 0xFF000000; rounding will not cause overflow)
 					*pdst++ = static_cast<uchar>((accum + 0x800000) >> 24);
 				}
 			}
-			pdst += channels*dst.getRowSkip();
+		}
+	}
+
+#if __OGRE_HAVE_SSE2
+	// widens the 4 channels of a pixel to floats
+	static inline __m128 unpackPixelSSE2(const uchar* p) {
+		int packed;
+		memcpy(&packed, p, sizeof(packed));
+		__m128i zero = _mm_setzero_si128();
+		__m128i wide = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+		return _mm_cvtepi32_ps(wide);
+	}
+
+	// blends a row of 4 channel pixels, all channels at once. may differ from
+	// the fixed-point path by one where the result is exactly half way
+	static void scaleRowSSE2(const uchar* srcrow1, const uchar* srcrow2, unsigned int syf,
+		const size_t* sxoff1, const size_t* sxoff2, const unsigned int* sxfs, size_t dstwidth, uchar* pdst) {
+		__m128 fy = _mm_set1_ps(syf / 4096.f);
+		__m128 half = _mm_set1_ps(0.5f);
+		for (size_t x = 0; x < dstwidth; x++) {
+			__m128 fx = _mm_set1_ps(sxfs[x] / 4096.f);
+			__m128 x1y1 = unpackPixelSSE2(srcrow1 + sxoff1[x]);
+			__m128 x2y1 = unpackPixelSSE2(srcrow1 + sxoff2[x]);
+			__m128 x1y2 = unpackPixelSSE2(srcrow2 + sxoff1[x]);
+			__m128 x2y2 = unpackPixelSSE2(srcrow2 + sxoff2[x]);
+			__m128 y1 = _mm_add_ps(x1y1, _mm_mul_ps(_mm_sub_ps(x2y1, x1y1), fx));
+			__m128 y2 = _mm_add_ps(x1y2, _mm_mul_ps(_mm_sub_ps(x2y2, x1y2), fx));
+			__m128 accum = _mm_add_ps(y1, _mm_mul_ps(_mm_sub_ps(y2, y1), fy));
+			__m128i result = _mm_cvttps_epi32(_mm_add_ps(accum, half));
+			result = _mm_packs_epi32(result, result);
+			result = _mm_packus_epi16(result, result);
+			int packed = _mm_cvtsi128_si32(result);
+			memcpy(pdst, &packed, sizeof(packed));
+			pdst += 4;
+		}
+	}
+#endif
+};
+
+
+// separable windowed sinc resampler, for high quality scaling and mipmap
+// generation. works on FLOAT32_RGBA copies of the image, filtering one
+// axis at a time; each pass writes a band of the rows of its output.
+// edges are clamped, and weights are normalised so flat areas stay flat.
+struct SeparableResampler {
+	enum Kernel {
+		// Lanczos windowed sinc, 3 lobes
+		KERNEL_LANCZOS,
+		// Kaiser windowed sinc, 3 lobes, alpha 4
+		KERNEL_KAISER
+	};
+
+	// kernel radius in source pixels, when not minifying
+	static float getRadius() { return 3.0f; }
+
+	static float sinc(float x) {
+		if (x == 0.0f)
+			return 1.0f;
+		x *= Math::PI;
+		return std::sin(x) / x;
+	}
+
+	// zeroth order modified Bessel function of the first kind
+	static float bessel0(float x) {
+		float sum = 1.0f, term = 1.0f, halfx = x * 0.5f;
+		for (int k = 1; k < 32 && term > sum * 1e-7f; ++k) {
+			term *= (halfx / k) * (halfx / k);
+			sum += term;
+		}
+		return sum;
+	}
+
+	static float evaluate(Kernel kernel, float x) {
+		float radius = getRadius();
+		x = std::fabs(x);
+		if (x >= radius)
+			return 0.0f;
+		if (kernel == KERNEL_LANCZOS)
+			return sinc(x) * sinc(x / radius);
+		const float alpha = 4.0f;
+		float t = x / radius;
+		return sinc(x) * bessel0(alpha * std::sqrt(1.0f - t * t)) / bessel0(alpha);
+	}
+
+	// source pixels and weights contributing to each destination pixel along one axis
+	struct Contributions {
+		vector<size_t>::type first;
+		vector<size_t>::type count;
+		// stride weights per destination pixel
+		vector<float>::type weights;
+		size_t stride;
+
+		void compute(size_t srcSize, size_t dstSize, Kernel kernel) {
+			float scale = (float)dstSize / srcSize;
+			// when minifying the kernel is widened to cover all the source pixels
+			float filterScale = std::max(1.0f / scale, 1.0f);
+			float support = getRadius() * filterScale;
+			stride = std::min((size_t)std::ceil(support * 2) + 2, srcSize);
+			first.resize(dstSize);
+			count.resize(dstSize);
+			weights.assign(dstSize * stride, 0.0f);
+
+			for (size_t i = 0; i < dstSize; ++i) {
+				float centre = (i + 0.5f) / scale;
+				int lo = (int)std::floor(centre - support);
+				int hi = (int)std::ceil(centre + support);
+				size_t clampedLo = (size_t)Math::Clamp(lo, 0, (int)srcSize - 1);
+				size_t clampedHi = (size_t)Math::Clamp(hi, 0, (int)srcSize - 1);
+				first[i] = clampedLo;
+				count[i] = std::min(clampedHi - clampedLo + 1, stride);
+				float* w = &weights[i * stride];
+				float total = 0.0f;
+				for (int s = lo; s <= hi; ++s) {
+					float weight = evaluate(kernel, (s + 0.5f - centre) / filterScale);
+					// samples beyond the edge repeat the edge pixel
+					size_t clamped = std::min((size_t)Math::Clamp(s, 0, (int)srcSize - 1) - clampedLo, count[i] - 1);
+					w[clamped] += weight;
+					total += weight;
+				}
+				if (total != 0.0f) {
+					for (size_t k = 0; k < count[i]; ++k)
+						w[k] /= total;
+				}
+			}
+		}
+	};
+
+	// filters along x. rows are srcWidth (input) and dstWidth (output) RGBA pixels
+	static void filterColumns(const float* src, size_t srcWidth, float* dst, size_t dstWidth,
+		const Contributions& contrib, size_t rowBegin, size_t rowEnd) {
+#if __OGRE_HAVE_SSE
+		bool useSSE = resamplerHasSSE();
+#endif
+		for (size_t row = rowBegin; row < rowEnd; ++row) {
+			const float* srcrow = src + row * srcWidth * 4;
+			float* pdst = dst + row * dstWidth * 4;
+			for (size_t x = 0; x < dstWidth; ++x, pdst += 4) {
+				const float* psrc = srcrow + contrib.first[x] * 4;
+				const float* w = &contrib.weights[x * contrib.stride];
+				size_t count = contrib.count[x];
+#if __OGRE_HAVE_SSE
+				if (useSSE) {
+					__m128 accum = _mm_setzero_ps();
+					for (size_t k = 0; k < count; ++k)
+						accum = _mm_add_ps(accum, _mm_mul_ps(_mm_loadu_ps(psrc + k * 4), _mm_set1_ps(w[k])));
+					_mm_storeu_ps(pdst, accum);
+					continue;
+				}
+#endif
+				float accum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (size_t k = 0; k < count; ++k) {
+					accum[0] += psrc[k*4+0] * w[k]; accum[1] += psrc[k*4+1] * w[k];
+					accum[2] += psrc[k*4+2] * w[k]; accum[3] += psrc[k*4+3] * w[k];
+				}
+				memcpy(pdst, accum, sizeof(accum));
+			}
+		}
+	}
+
+	// filters along y or z, by blending whole rows of rowFloats floats.
+	// output rows are numbered (outer * dstAxisSize + axis) * innerCount + inner,
+	// input rows likewise with srcAxisSize; for y innerCount is 1 and outer
+	// the slice, for z innerCount is the height and outer always 0
+	static void filterRows(const float* src, float* dst, size_t rowFloats, size_t innerCount,
+		size_t srcAxisSize, size_t dstAxisSize, const Contributions& contrib, size_t rowBegin, size_t rowEnd) {
+#if __OGRE_HAVE_SSE
+		bool useSSE = resamplerHasSSE();
+#endif
+		for (size_t row = rowBegin; row < rowEnd; ++row) {
+			size_t inner = row % innerCount;
+			size_t axis = (row / innerCount) % dstAxisSize;
+			size_t outer = row / innerCount / dstAxisSize;
+			float* pdst = dst + row * rowFloats;
+			std::fill(pdst, pdst + rowFloats, 0.0f);
+			const float* w = &contrib.weights[axis * contrib.stride];
+			for (size_t k = 0; k < contrib.count[axis]; ++k) {
+				size_t srcRow = (outer * srcAxisSize + contrib.first[axis] + k) * innerCount + inner;
+				const float* psrc = src + srcRow * rowFloats;
+				size_t i = 0;
+#if __OGRE_HAVE_SSE
+				if (useSSE) {
+					__m128 weight = _mm_set1_ps(w[k]);
+					for (; i + 4 <= rowFloats; i += 4)
+						_mm_storeu_ps(pdst + i, _mm_add_ps(_mm_loadu_ps(pdst + i), 
+							_mm_mul_ps(_mm_loadu_ps(psrc + i), weight)));
+				}
+#endif
+				for (; i < rowFloats; ++i)
+					pdst[i] += psrc[i] * w[k];
+			}
 		}
 	}
 };
@@ -34,10 +34,50 @@ THE SOFTWARE.
 #include "OgreSceneNode.h"
 #include "OgreCamera.h"
 #include "OgreLodStrategy.h"
+#include "OgreSceneManager.h"
 #include "OgreException.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre
 {
+	/// Entities per range handed to a thread; splitting further doesn't pay off
+	static const size_t c_entitiesPerUploadTask = 256;
+
+	/// Packs entities' transforms, @see InstanceBatch::packTransforms3x4
+	class TransformPackTask : public WorkQueue::ParallelTask
+	{
+	public:
+		typedef std::pair<size_t, size_t> DirtyRange;
+
+		InstancedEntity * const	*entities;
+		const Matrix4 * const	*worldTransforms;
+		size_t					floatsPerEntity;
+		float					*dest;
+		Vector3					translationOffset;
+
+		/// Range of entities that changed [first; last) for each range of
+		/// c_entitiesPerUploadTask entities, empty if none changed
+		vector<DirtyRange>::type dirtyRanges;
+
+		void execute( size_t begin, size_t end )
+		{
+			size_t firstDirty	= end;
+			size_t lastDirty	= begin;
+
+			for( size_t i=begin; i<end; ++i )
+			{
+				if( entities[i]->_packTransforms3x4( dest + i * floatsPerEntity, worldTransforms[i],
+													 translationOffset ) )
+				{
+					firstDirty	= std::min( firstDirty, i );
+					lastDirty	= i + 1;
+				}
+			}
+
+			dirtyRanges[begin / c_entitiesPerUploadTask] = DirtyRange( firstDirty, lastDirty );
+		}
+	};
+
 	InstanceBatch::InstanceBatch( InstanceManager *creator, MeshPtr &meshReference,
 									const MaterialPtr &material, size_t instancesPerBatch,
 									const Mesh::IndexMap *indexToBoneMap, const String &batchName ) :
@@ -57,7 +97,8 @@ namespace Ogre
 				mCachedCamera( 0 ),
 				mTransformSharingDirty(true),
 				mRemoveOwnVertexData(false),
-				mRemoveOwnIndexData(false)
+				mRemoveOwnIndexData(false),
+				mTransformShadowDirty(true)
 	{
 		assert( mInstancesPerBatch );
 
@@ -229,6 +270,65 @@ namespace Ogre
 		}
 	}
 	//-----------------------------------------------------------------------
+	bool InstanceBatch::packTransforms3x4( const InstancedEntityVec &entities, size_t floatsPerEntity,
+											size_t &outDirtyStart, size_t &outDirtyEnd )
+	{
+		const size_t numEntities = entities.size();
+		if( !numEntities )
+			return false;
+
+		if( mTransformShadow.size() < numEntities * floatsPerEntity )
+		{
+			//What's in the GPU beyond the old size was never written by us
+			mTransformShadow.resize( numEntities * floatsPerEntity );
+			mTransformShadowDirty = true;
+		}
+
+		const Vector3 translationOffset = ( mManager->getCameraRelativeRendering() && mCurrentCamera ) ?
+											mCurrentCamera->getDerivedPosition() : Vector3::ZERO;
+
+		//Nodes cache their full transform without any locking, so ask for it from this thread
+		mPackedWorldTransforms.resize( numEntities );
+		for( size_t i=0; i<numEntities; ++i )
+			mPackedWorldTransforms[i] = entities[i]->_getPackedWorldTransform();
+
+		TransformPackTask task;
+		task.entities			= &entities[0];
+		task.worldTransforms	= &mPackedWorldTransforms[0];
+		task.floatsPerEntity	= floatsPerEntity;
+		task.dest				= &mTransformShadow[0];
+		task.translationOffset	= translationOffset;
+		task.dirtyRanges.resize( (numEntities + c_entitiesPerUploadTask - 1) / c_entitiesPerUploadTask );
+		WorkQueue::defaultParallelFor( task, numEntities, c_entitiesPerUploadTask );
+
+		size_t firstDirty	= numEntities;
+		size_t lastDirty	= 0;
+		for( size_t i=0; i<task.dirtyRanges.size(); ++i )
+		{
+			const TransformPackTask::DirtyRange &range = task.dirtyRanges[i];
+			if( range.first < range.second )
+			{
+				firstDirty	= std::min( firstDirty, range.first );
+				lastDirty	= std::max( lastDirty, range.second );
+			}
+		}
+
+		if( mTransformShadowDirty )
+		{
+			firstDirty	= 0;
+			lastDirty	= numEntities;
+			mTransformShadowDirty = false;
+		}
+
+		if( firstDirty >= lastDirty )
+			return false;
+
+		outDirtyStart	= firstDirty * floatsPerEntity;
+		outDirtyEnd		= lastDirty * floatsPerEntity;
+
+		return true;
+	}
+	//-----------------------------------------------------------------------
 	RenderOperation InstanceBatch::build( const SubMesh* baseSubMesh )
 	{
 		if( checkSubMeshCompatibility( baseSubMesh ) )
@@ -171,12 +171,7 @@ namespace Ogre
 	//-----------------------------------------------------------------------
 	size_t InstanceBatchHW::updateVertexBuffer( Camera *currentCamera )
 	{
-		size_t retVal = 0;
-
-		//Now lock the vertex buffer and copy the 4x3 matrices, only those who need it!
-		const size_t bufferIdx = mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1;
-		float *pDest = static_cast<float*>(mRenderOperation.vertexData->vertexBufferBinding->
-											getBuffer(bufferIdx)->lock( HardwareBuffer::HBL_DISCARD ));
+		mVisibleEntities.clear();
 
 		InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
 		InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
@@ -186,22 +181,27 @@ namespace Ogre
 			//Cull on an individual basis, the less entities are visible, the less instances we draw.
 			//No need to use null matrices at all!
 			if( (*itor)->findVisible( currentCamera ) )
-			{
-				const size_t floatsWritten = (*itor)->getTransforms3x4( pDest );
+				mVisibleEntities.push_back( *itor );
+			++itor;
+		}
 
-				if( mManager->getCameraRelativeRendering() )
-					makeMatrixCameraRelative3x4( pDest, floatsWritten );
+		//Now copy the 4x3 matrices to the vertex buffer, only those who changed!
+		size_t dirtyStart, dirtyEnd;
+		if( packTransforms3x4( mVisibleEntities, 12, dirtyStart, dirtyEnd ) )
+		{
+			const size_t bufferIdx = mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1;
+			HardwareVertexBufferSharedPtr vertexBuffer = mRenderOperation.vertexData->
+																vertexBufferBinding->getBuffer( bufferIdx );
 
-				pDest += floatsWritten;
+			const size_t offset = dirtyStart * sizeof(float);
+			const size_t length = (dirtyEnd - dirtyStart) * sizeof(float);
+			vertexBuffer->writeData( offset, length, &mTransformShadow[dirtyStart],
+									 length == vertexBuffer->getSizeInBytes() );
 
-				++retVal;
-			}
-			++itor;
+			mCreator->_addUploadedBytes( length );
 		}
 
-		mRenderOperation.vertexData->vertexBufferBinding->getBuffer(bufferIdx)->unlock();
-
-		return retVal;
+		return mVisibleEntities.size();
 	}
 	//-----------------------------------------------------------------------
 	void InstanceBatchHW::_boundsDirty(void)
@@ -443,7 +443,8 @@ namespace Ogre
 		//If using dual quaternions, write 3x4 matrices to a temporary buffer, then convert to dual quaternions
 		if(mUseBoneDualQuaternions)
 		{
-			transforms = mTempTransformsArray3x4;
+			mTempTransformsArray3x4.resize( mMatricesPerInstance * 3 * 4 );
+			transforms = &mTempTransformsArray3x4[0];
 		}
 		
 		for(size_t i = 0 ; i < instanceCount ; ++i)
@@ -55,7 +55,6 @@ namespace Ogre
 				mMaxFloatsPerLine( std::numeric_limits<size_t>::max() ),
 				mRowLength(3),
 				mWeightCount(1),
-				mTempTransformsArray3x4(0),
 				mUseBoneMatrixLookup(false),
 				mMaxLookupTableInstances(16),
 				mUseBoneDualQuaternions(false),
@@ -83,8 +82,6 @@ namespace Ogre
 		//Remove the VTF texture
 		if( !mMatrixTexture.isNull() )
 			TextureManager::getSingleton().remove( mMatrixTexture->getName() );
-
-		OGRE_FREE(mTempTransformsArray3x4, MEMCATEGORY_GENERAL);
 	}
 
 	//-----------------------------------------------------------------------
@@ -257,11 +254,6 @@ namespace Ogre
 		}
 		mMatricesPerInstance = std::max<size_t>( 1, baseSubMesh->blendIndexToBoneIndexMap.size() );
 
-		if(mUseBoneDualQuaternions && !mTempTransformsArray3x4)
-		{
-			mTempTransformsArray3x4 = OGRE_ALLOC_T(float, mMatricesPerInstance * 3 * 4, MEMCATEGORY_GENERAL);
-		}
-		
 		mNumWorldMatrices = uniqueAnimations * mMatricesPerInstance;
 
 		//Calculate the width & height required to hold all the matrices. Start by filling the width
@@ -343,51 +335,33 @@ namespace Ogre
 	//-----------------------------------------------------------------------
 	void BaseInstanceBatchVTF::updateVertexTexture(void)
 	{
+		size_t dirtyStart, dirtyEnd;
+		if( !packTransforms3x4( mInstancedEntities, mMatricesPerInstance * 12, dirtyStart, dirtyEnd ) )
+			return; //Nothing changed since the last time, the texture is up to date
+
 		//Now lock the texture and copy the 4x3 matrices!
 		mMatrixTexture->getBuffer()->lock( HardwareBuffer::HBL_DISCARD );
 		const PixelBox &pixelBox = mMatrixTexture->getBuffer()->getCurrentLock();
 
 		float *pDest = static_cast<float*>(pixelBox.data);
 
-		InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
-		InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
-
-		float* transforms;
-
-		//If using dual quaternion skinning, write the transforms to a temporary buffer,
-		//then convert to dual quaternions, then later write to the pixel buffer
-		//Otherwise simply write the transforms to the pixel buffer directly
+		//The texture is discarded, so everything has to be written, not just the dirty range.
+		//If using dual quaternion skinning, convert the transforms while writing
+		size_t floatsWritten;
 		if(mUseBoneDualQuaternions)
 		{
-			transforms = mTempTransformsArray3x4;
+			floatsWritten = convert3x4MatricesToDualQuaternions( &mTransformShadow[0],
+											mInstancedEntities.size() * mMatricesPerInstance, pDest );
 		}
 		else
 		{
-			transforms = pDest;
+			floatsWritten = mInstancedEntities.size() * mMatricesPerInstance * 12;
+			memcpy( pDest, &mTransformShadow[0], floatsWritten * sizeof(float) );
 		}
 
-		
-		while( itor != end )
-		{
-			size_t floatsWritten = (*itor)->getTransforms3x4( transforms );
-
-			if( mManager->getCameraRelativeRendering() )
-				makeMatrixCameraRelative3x4( transforms, floatsWritten );
-
-			if(mUseBoneDualQuaternions)
-			{
-				floatsWritten = convert3x4MatricesToDualQuaternions(transforms, floatsWritten / 12, pDest);
-				pDest += floatsWritten;
-			}
-			else
-			{
-				transforms += floatsWritten;
-			}
-			
-			++itor;
-		}
-		
 		mMatrixTexture->getBuffer()->unlock();
+
+		mCreator->_addUploadedBytes( floatsWritten * sizeof(float) );
 	}
 	/** update the lookup numbers for entities with shared transforms */
 	void BaseInstanceBatchVTF::updateSharedLookupIndexes()
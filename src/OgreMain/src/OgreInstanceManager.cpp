@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "OgreSceneManager.h"
 #include "OgreMeshSerializer.h"
 #include "OgreHardwareBufferManager.h"
+#include "OgreRoot.h"
 
 namespace Ogre
 {
@@ -52,7 +53,10 @@ namespace Ogre
 				mInstancingFlags( instancingFlags ),
 				mSubMeshIdx( subMeshIdx ),
                 mSceneManager( sceneManager ),
-				mMaxLookupTableInstances(16)
+				mMaxLookupTableInstances(16),
+				mUploadedBytes(0),
+				mUploadedBytesLastFrame(0),
+				mUploadFrame(0)
 	{
 		mMeshReference = MeshManager::getSingleton().load( meshName, groupName );
 
@@ -496,6 +500,33 @@ namespace Ogre
 		mDirtyBatches.clear();
 	}
 	//-----------------------------------------------------------------------
+	size_t InstanceManager::getUploadedBytesLastFrame(void) const
+	{
+		const unsigned long currentFrame = Root::getSingleton().getNextFrameNumber();
+
+		if( currentFrame == mUploadFrame )
+			return mUploadedBytesLastFrame;
+		else if( currentFrame == mUploadFrame + 1 )
+			return mUploadedBytes;
+
+		return 0;
+	}
+	//-----------------------------------------------------------------------
+	void InstanceManager::_addUploadedBytes( size_t bytes )
+	{
+		const unsigned long currentFrame = Root::getSingleton().getNextFrameNumber();
+
+		if( currentFrame != mUploadFrame )
+		{
+			//Starting a new frame, keep the totals from the previous one (if it was the last one)
+			mUploadedBytesLastFrame = currentFrame == mUploadFrame + 1 ? mUploadedBytes : 0;
+			mUploadedBytes			= 0;
+			mUploadFrame			= currentFrame;
+		}
+
+		mUploadedBytes += bytes;
+	}
+	//-----------------------------------------------------------------------
 	// Helper functions to unshare the vertices
 	//-----------------------------------------------------------------------
 	typedef map<uint32, uint32>::type IndicesMap;
@@ -248,6 +248,55 @@ namespace Ogre
 		return retVal;
 	}
 	//-----------------------------------------------------------------------
+	const Matrix4* InstancedEntity::_getPackedWorldTransform(void) const
+	{
+		if( !isVisible() || !isInScene() )
+			return 0;
+
+		if( mSkeletonInstance || !mBatchOwner->useBoneWorldMatrices() )
+			return &Matrix4::IDENTITY;
+
+		return &_getParentNodeFullTransform();
+	}
+	//-----------------------------------------------------------------------
+	bool InstancedEntity::_packTransforms3x4( float *xform, const Matrix4 *worldTransform,
+											  const Vector3 &translationOffset ) const
+	{
+		OptimisedUtil *optimisedUtil = OptimisedUtil::getImplementation();
+
+		//Same layout as getTransforms3x4. When not attached, writes zero matrices
+		const bool visible = worldTransform != 0;
+		if( !mSkeletonInstance )
+		{
+			const Matrix4 *mat = visible ? worldTransform : &Matrix4::ZERO;
+			return optimisedUtil->packAffineMatrices3x4( &mat, xform,
+												visible ? translationOffset : Vector3::ZERO, 1 );
+		}
+
+		const Matrix4 *matrices = mBatchOwner->useBoneWorldMatrices() ? mBoneWorldMatrices :
+																		mBoneMatrices;
+		const Mesh::IndexMap *indexMap = mBatchOwner->_getIndexToBoneMap();
+		const size_t numMatrices = indexMap->size();
+
+		//Gather the matrix pointers in small chunks to keep them on the stack
+		const size_t c_chunkSize = 32;
+		const Matrix4 *chunk[c_chunkSize];
+
+		bool retVal = false;
+		for( size_t i=0; i<numMatrices; i += c_chunkSize )
+		{
+			const size_t chunkMatrices = std::min( c_chunkSize, numMatrices - i );
+			for( size_t j=0; j<chunkMatrices; ++j )
+				chunk[j] = visible ? &matrices[(*indexMap)[i+j]] : &Matrix4::ZERO;
+
+			retVal |= optimisedUtil->packAffineMatrices3x4( chunk, xform,
+										visible ? translationOffset : Vector3::ZERO, chunkMatrices );
+			xform += chunkMatrices * 12;
+		}
+
+		return retVal;
+	}
+	//-----------------------------------------------------------------------
 	bool InstancedEntity::findVisible( Camera *camera ) const
 	{
 		//Object is active
@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "OgreOptimisedUtil.h"
 #include "OgreTangentSpaceCalc.h"
 #include "OgreLodStrategyManager.h"
+#include "OgreTriangleBVH.h"
 
 
 namespace Ogre {
@@ -115,6 +116,7 @@ namespace Ogre {
 		mSharedVertexDataAnimationIncludesNormals(false),
 		mAnimationTypesDirty(true),
 		mPosesIncludeNormals(false),
+		mTriangleBVH(0),
 		sharedVertexData(0)
     {
 
@@ -342,6 +344,8 @@ namespace Ogre {
 
         // Removes reference to skeleton
         setSkeletonName(StringUtil::BLANK);
+
+		clearTriangleBVH();
     }
 
     //-----------------------------------------------------------------------
@@ -491,6 +495,27 @@ namespace Ogre {
 			}
 		}
     }
+    //-----------------------------------------------------------------------
+	const TriangleBVH* Mesh::getTriangleBVH(void)
+	{
+		OGRE_LOCK_MUTEX(mTriangleBVHMutex)
+
+		if (!mTriangleBVH && isLoaded())
+		{
+			TriangleBVH* bvh = OGRE_NEW TriangleBVH();
+			bvh->build(this);
+			mTriangleBVH = bvh;
+		}
+		return mTriangleBVH;
+	}
+    //-----------------------------------------------------------------------
+	void Mesh::clearTriangleBVH(void)
+	{
+		OGRE_LOCK_MUTEX(mTriangleBVHMutex)
+
+		OGRE_DELETE mTriangleBVH;
+		mTriangleBVH = 0;
+	}
     //-----------------------------------------------------------------------
     void Mesh::_setBoundingSphereRadius(Real radius)
     {
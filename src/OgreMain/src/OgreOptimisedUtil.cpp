@@ -344,6 +344,132 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        /// @copydoc OptimisedUtil::packAffineMatrices3x4
+        virtual bool packAffineMatrices3x4(
+            const Matrix4* const* srcMatrices,
+            float* destFloats,
+            const Vector3& translationOffset,
+            size_t numMatrices)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            bool changed = impl->packAffineMatrices3x4(
+                srcMatrices,
+                destFloats,
+                translationOffset,
+                numMatrices);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+
+            return changed;
+        }
+
+        /// @copydoc OptimisedUtil::calculateHeightFieldNormals
+        virtual void calculateHeightFieldNormals(
+            const float* rowBelow,
+            const float* row,
+            const float* rowAbove,
+            float spacing,
+            float* destX,
+            float* destY,
+            float* destZ,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->calculateHeightFieldNormals(
+                rowBelow,
+                row,
+                rowAbove,
+                spacing,
+                destX,
+                destY,
+                destZ,
+                count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::sweepHeightFieldHorizon
+        virtual void sweepHeightFieldHorizon(
+            const float* prevHorizon,
+            float weight,
+            float drop,
+            const float* heights,
+            float bias,
+            float* destHorizon,
+            uint8* destLit,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->sweepHeightFieldHorizon(
+                prevHorizon,
+                weight,
+                drop,
+                heights,
+                bias,
+                destHorizon,
+                destLit,
+                count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        /// @copydoc OptimisedUtil::sampleHeightField
+        virtual void sampleHeightField(
+            const float* heights,
+            size_t size,
+            const float* posX,
+            const float* posY,
+            float* dest,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->sampleHeightField(
+                heights,
+                size,
+                posX,
+                posY,
+                dest,
+                count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
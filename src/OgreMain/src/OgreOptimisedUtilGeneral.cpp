@@ -94,6 +94,44 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::packAffineMatrices3x4
+        virtual bool packAffineMatrices3x4(
+            const Matrix4* const* srcMatrices,
+            float* destFloats,
+            const Vector3& translationOffset,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::calculateHeightFieldNormals
+        virtual void calculateHeightFieldNormals(
+            const float* rowBelow,
+            const float* row,
+            const float* rowAbove,
+            float spacing,
+            float* destX,
+            float* destY,
+            float* destZ,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::sweepHeightFieldHorizon
+        virtual void sweepHeightFieldHorizon(
+            const float* prevHorizon,
+            float weight,
+            float drop,
+            const float* heights,
+            float bias,
+            float* destHorizon,
+            uint8* destLit,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::sampleHeightField
+        virtual void sampleHeightField(
+            const float* heights,
+            size_t size,
+            const float* posX,
+            const float* posY,
+            float* dest,
+            size_t count);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -392,6 +430,122 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    bool OptimisedUtilGeneral::packAffineMatrices3x4(
+        const Matrix4* const* srcMatrices,
+        float* pDest,
+        const Vector3& translationOffset,
+        size_t numMatrices)
+    {
+        bool changed = false;
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& m = *srcMatrices[i];
+
+            for (size_t row = 0; row < 3; ++row)
+            {
+                const float v[4] =
+                {
+                    static_cast<float>(m[row][0]),
+                    static_cast<float>(m[row][1]),
+                    static_cast<float>(m[row][2]),
+                    static_cast<float>(m[row][3] - translationOffset[row])
+                };
+
+                changed |= pDest[0] != v[0] || pDest[1] != v[1] ||
+                           pDest[2] != v[2] || pDest[3] != v[3];
+
+                *pDest++ = v[0];
+                *pDest++ = v[1];
+                *pDest++ = v[2];
+                *pDest++ = v[3];
+            }
+        }
+
+        return changed;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::calculateHeightFieldNormals(
+        const float* rowBelow,
+        const float* row,
+        const float* rowAbove,
+        float spacing,
+        float* destX,
+        float* destY,
+        float* destZ,
+        size_t count)
+    {
+        // normal = (-dh/dx, -dh/dy, 1), normalised
+        const float scale = -0.5f / spacing;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float nx = (row[i + 1] - row[i - 1]) * scale;
+            float ny = (rowAbove[i] - rowBelow[i]) * scale;
+            float invLength = 1.0f / Math::Sqrt(nx * nx + ny * ny + 1.0f);
+
+            destX[i] = nx * invLength;
+            destY[i] = ny * invLength;
+            destZ[i] = invLength;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::sweepHeightFieldHorizon(
+        const float* prevHorizon,
+        float weight,
+        float drop,
+        const float* heights,
+        float bias,
+        float* destHorizon,
+        uint8* destLit,
+        size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float horizon = prevHorizon[i] + (prevHorizon[i + 1] - prevHorizon[i]) * weight - drop;
+            float h = heights[i];
+
+            destLit[i] = horizon > h + bias ? 0 : 255;
+            destHorizon[i] = std::max(horizon, h);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::sampleHeightField(
+        const float* heights,
+        size_t size,
+        const float* posX,
+        const float* posY,
+        float* dest,
+        size_t count)
+    {
+        float scale = (float)(size - 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float px = std::min(std::max(posX[i], 0.0f), 1.0f) * scale;
+            float py = std::min(std::max(posY[i], 0.0f), 1.0f) * scale;
+            size_t cx = std::min((size_t)px, size - 2);
+            size_t cy = std::min((size_t)py, size - 2);
+            float fx = px - (float)cx;
+            float fy = py - (float)cy;
+
+            const float* pQuad = heights + cy * size + cx;
+            float h0 = pQuad[0];
+            float h1 = pQuad[1];
+            float h2 = pQuad[size + 1];
+            float h3 = pQuad[size];
+
+            // Pick the triangle, then the plane through it as base + fx * dx + fy * dy
+            bool oddRow = (cy & 1) != 0;
+            bool secondTri = oddRow ? (fx + fy >= 1.0f) : (fy > fx);
+            float dx = secondTri ? h2 - h3 : h1 - h0;
+            float dy = (secondTri != oddRow) ? h3 - h0 : h2 - h1;
+            float base = (secondTri && oddRow) ? h1 + h3 - h2 : h0;
+
+            dest[i] = base + fx * dx + fy * dy;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
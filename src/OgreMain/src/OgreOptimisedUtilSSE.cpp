@@ -132,6 +132,43 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::packAffineMatrices3x4
+        virtual bool __OGRE_SIMD_ALIGN_ATTRIBUTE packAffineMatrices3x4(
+            const Matrix4* const* srcMatrices,
+            float* destFloats,
+            const Vector3& translationOffset,
+            size_t numMatrices);
+        /// @copydoc OptimisedUtil::calculateHeightFieldNormals
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE calculateHeightFieldNormals(
+            const float* rowBelow,
+            const float* row,
+            const float* rowAbove,
+            float spacing,
+            float* destX,
+            float* destY,
+            float* destZ,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::sweepHeightFieldHorizon
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE sweepHeightFieldHorizon(
+            const float* prevHorizon,
+            float weight,
+            float drop,
+            const float* heights,
+            float bias,
+            float* destHorizon,
+            uint8* destLit,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::sampleHeightField
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE sampleHeightField(
+            const float* heights,
+            size_t size,
+            const float* posX,
+            const float* posY,
+            float* dest,
+            size_t count);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -271,6 +308,90 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::packAffineMatrices3x4
+        virtual bool packAffineMatrices3x4(
+            const Matrix4* const* srcMatrices,
+            float* destFloats,
+            const Vector3& translationOffset,
+            size_t numMatrices)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            return mImpl->packAffineMatrices3x4(
+                srcMatrices,
+                destFloats,
+                translationOffset,
+                numMatrices);
+        }
+
+        /// @copydoc OptimisedUtil::calculateHeightFieldNormals
+        virtual void calculateHeightFieldNormals(
+            const float* rowBelow,
+            const float* row,
+            const float* rowAbove,
+            float spacing,
+            float* destX,
+            float* destY,
+            float* destZ,
+            size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->calculateHeightFieldNormals(
+                rowBelow,
+                row,
+                rowAbove,
+                spacing,
+                destX,
+                destY,
+                destZ,
+                count);
+        }
+
+        /// @copydoc OptimisedUtil::sweepHeightFieldHorizon
+        virtual void sweepHeightFieldHorizon(
+            const float* prevHorizon,
+            float weight,
+            float drop,
+            const float* heights,
+            float bias,
+            float* destHorizon,
+            uint8* destLit,
+            size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->sweepHeightFieldHorizon(
+                prevHorizon,
+                weight,
+                drop,
+                heights,
+                bias,
+                destHorizon,
+                destLit,
+                count);
+        }
+
+        /// @copydoc OptimisedUtil::sampleHeightField
+        virtual void sampleHeightField(
+            const float* heights,
+            size_t size,
+            const float* posX,
+            const float* posY,
+            float* dest,
+            size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->sampleHeightField(
+                heights,
+                size,
+                posX,
+                posY,
+                dest,
+                count);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -2132,6 +2253,231 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    bool OptimisedUtilSSE::packAffineMatrices3x4(
+        const Matrix4* const* srcMatrices,
+        float* pDest,
+        const Vector3& translationOffset,
+        size_t numMatrices)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        // Only the w (translation) lane of each row is offset
+        const __m128 o0 = _mm_set_ps(translationOffset.x, 0.0f, 0.0f, 0.0f);
+        const __m128 o1 = _mm_set_ps(translationOffset.y, 0.0f, 0.0f, 0.0f);
+        const __m128 o2 = _mm_set_ps(translationOffset.z, 0.0f, 0.0f, 0.0f);
+
+        // Accumulates lanes that differ from what was in the destination
+        __m128 changed = _mm_setzero_ps();
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& m = *srcMatrices[i];
+
+            // Source and destination are both unaligned here
+            __m128 r0 = _mm_sub_ps(_mm_loadu_ps(m[0]), o0);
+            __m128 r1 = _mm_sub_ps(_mm_loadu_ps(m[1]), o1);
+            __m128 r2 = _mm_sub_ps(_mm_loadu_ps(m[2]), o2);
+
+            changed = _mm_or_ps(changed, _mm_cmpneq_ps(r0, _mm_loadu_ps(pDest + 0)));
+            changed = _mm_or_ps(changed, _mm_cmpneq_ps(r1, _mm_loadu_ps(pDest + 4)));
+            changed = _mm_or_ps(changed, _mm_cmpneq_ps(r2, _mm_loadu_ps(pDest + 8)));
+
+            _mm_storeu_ps(pDest + 0, r0);
+            _mm_storeu_ps(pDest + 4, r1);
+            _mm_storeu_ps(pDest + 8, r2);
+
+            pDest += 12;
+        }
+
+        return _mm_movemask_ps(changed) != 0;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::calculateHeightFieldNormals(
+        const float* rowBelow,
+        const float* row,
+        const float* rowAbove,
+        float spacing,
+        float* destX,
+        float* destY,
+        float* destZ,
+        size_t count)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const float scale = -0.5f / spacing;
+        const __m128 vScale = _mm_set1_ps(scale);
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 nx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + i + 1), _mm_loadu_ps(row + i - 1)), vScale);
+            __m128 ny = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(rowAbove + i), _mm_loadu_ps(rowBelow + i)), vScale);
+            __m128 lengthSq = __MM_ACCUM3_PS(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny), one);
+            // Full precision rather than _mm_rsqrt_ps, normals get quantised afterwards
+            // and approximations would show up as banding
+            __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+
+            _mm_storeu_ps(destX + i, _mm_mul_ps(nx, invLength));
+            _mm_storeu_ps(destY + i, _mm_mul_ps(ny, invLength));
+            _mm_storeu_ps(destZ + i, invLength);
+        }
+
+        // Leftovers
+        for (; i < count; ++i)
+        {
+            float nx = (row[i + 1] - row[i - 1]) * scale;
+            float ny = (rowAbove[i] - rowBelow[i]) * scale;
+            float invLength = 1.0f / Math::Sqrt(nx * nx + ny * ny + 1.0f);
+
+            destX[i] = nx * invLength;
+            destY[i] = ny * invLength;
+            destZ[i] = invLength;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::sweepHeightFieldHorizon(
+        const float* prevHorizon,
+        float weight,
+        float drop,
+        const float* heights,
+        float bias,
+        float* destHorizon,
+        uint8* destLit,
+        size_t count)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 vWeight = _mm_set1_ps(weight);
+        const __m128 vDrop = _mm_set1_ps(drop);
+        const __m128 vBias = _mm_set1_ps(bias);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 p0 = _mm_loadu_ps(prevHorizon + i);
+            __m128 p1 = _mm_loadu_ps(prevHorizon + i + 1);
+            __m128 horizon = _mm_sub_ps(__MM_LERP_PS(vWeight, p0, p1), vDrop);
+            __m128 h = _mm_loadu_ps(heights + i);
+
+            // One bit per sample, set when it's in shadow
+            int shadowed = _mm_movemask_ps(_mm_cmpgt_ps(horizon, _mm_add_ps(h, vBias)));
+            destLit[i + 0] = (shadowed & 1) ? 0 : 255;
+            destLit[i + 1] = (shadowed & 2) ? 0 : 255;
+            destLit[i + 2] = (shadowed & 4) ? 0 : 255;
+            destLit[i + 3] = (shadowed & 8) ? 0 : 255;
+
+            _mm_storeu_ps(destHorizon + i, _mm_max_ps(horizon, h));
+        }
+
+        // Leftovers
+        for (; i < count; ++i)
+        {
+            float horizon = prevHorizon[i] + (prevHorizon[i + 1] - prevHorizon[i]) * weight - drop;
+            float h = heights[i];
+
+            destLit[i] = horizon > h + bias ? 0 : 255;
+            destHorizon[i] = std::max(horizon, h);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::sampleHeightField(
+        const float* heights,
+        size_t size,
+        const float* posX,
+        const float* posY,
+        float* dest,
+        size_t count)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 vZero = _mm_setzero_ps();
+        const __m128 vOne = _mm_set1_ps(1.0f);
+        const __m128 vHalf = _mm_set1_ps(0.5f);
+        const __m128 vScale = _mm_set1_ps((float)(size - 1));
+        const __m128 vLastQuad = _mm_set1_ps((float)(size - 2));
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 px = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(posX + i), vZero), vOne), vScale);
+            __m128 py = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(posY + i), vZero), vOne), vScale);
+            __m128 cx = _mm_min_ps(__mm_floor_positive_ps(px), vLastQuad);
+            __m128 cy = _mm_min_ps(__mm_floor_positive_ps(py), vLastQuad);
+            __m128 fx = _mm_sub_ps(px, cx);
+            __m128 fy = _mm_sub_ps(py, cy);
+
+            // Gathering is scalar, there is nothing better before AVX2
+            OGRE_SIMD_ALIGNED_DECL(float, quadX[4]);
+            OGRE_SIMD_ALIGNED_DECL(float, quadY[4]);
+            OGRE_SIMD_ALIGNED_DECL(float, h0[4]);
+            OGRE_SIMD_ALIGNED_DECL(float, h1[4]);
+            OGRE_SIMD_ALIGNED_DECL(float, h2[4]);
+            OGRE_SIMD_ALIGNED_DECL(float, h3[4]);
+            _mm_store_ps(quadX, cx);
+            _mm_store_ps(quadY, cy);
+            for (size_t j = 0; j < 4; ++j)
+            {
+                const float* pQuad = heights + (size_t)quadY[j] * size + (size_t)quadX[j];
+                h0[j] = pQuad[0];
+                h1[j] = pQuad[1];
+                h2[j] = pQuad[size + 1];
+                h3[j] = pQuad[size];
+            }
+            __m128 v0 = _mm_load_ps(h0);
+            __m128 v1 = _mm_load_ps(h1);
+            __m128 v2 = _mm_load_ps(h2);
+            __m128 v3 = _mm_load_ps(h3);
+
+            // Same triangle selection as the general version, with masks
+            __m128 halfY = _mm_mul_ps(cy, vHalf);
+            __m128 oddRow = _mm_cmpneq_ps(halfY, __mm_floor_positive_ps(halfY));
+            __m128 secondTri = _mm_or_ps(
+                _mm_and_ps(oddRow, _mm_cmpge_ps(_mm_add_ps(fx, fy), vOne)),
+                _mm_andnot_ps(oddRow, _mm_cmpgt_ps(fy, fx)));
+            __m128 otherDiag = _mm_xor_ps(secondTri, oddRow);
+            __m128 bothSet = _mm_and_ps(secondTri, oddRow);
+
+            __m128 dx = _mm_or_ps(
+                _mm_and_ps(secondTri, _mm_sub_ps(v2, v3)),
+                _mm_andnot_ps(secondTri, _mm_sub_ps(v1, v0)));
+            __m128 dy = _mm_or_ps(
+                _mm_and_ps(otherDiag, _mm_sub_ps(v3, v0)),
+                _mm_andnot_ps(otherDiag, _mm_sub_ps(v2, v1)));
+            __m128 base = _mm_or_ps(
+                _mm_and_ps(bothSet, _mm_sub_ps(_mm_add_ps(v1, v3), v2)),
+                _mm_andnot_ps(bothSet, v0));
+
+            _mm_storeu_ps(dest + i, _mm_add_ps(_mm_add_ps(base, _mm_mul_ps(fx, dx)), _mm_mul_ps(fy, dy)));
+        }
+
+        // Leftovers
+        float scale = (float)(size - 1);
+        for (; i < count; ++i)
+        {
+            float px = std::min(std::max(posX[i], 0.0f), 1.0f) * scale;
+            float py = std::min(std::max(posY[i], 0.0f), 1.0f) * scale;
+            size_t cx = std::min((size_t)px, size - 2);
+            size_t cy = std::min((size_t)py, size - 2);
+            float fx = px - (float)cx;
+            float fy = py - (float)cy;
+
+            const float* pQuad = heights + cy * size + cx;
+            float h0 = pQuad[0];
+            float h1 = pQuad[1];
+            float h2 = pQuad[size + 1];
+            float h3 = pQuad[size];
+
+            bool oddRow = (cy & 1) != 0;
+            bool secondTri = oddRow ? (fx + fy >= 1.0f) : (fy > fx);
+            float dx = secondTri ? h2 - h3 : h1 - h0;
+            float dy = (secondTri != oddRow) ? h3 - h0 : h2 - h1;
+            float base = (secondTri && oddRow) ? h1 + h3 - h2 : h0;
+
+            dest[i] = base + fx * dx + fy * dy;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
@@ -434,3 +434,390 @@ inline int doOptimizedConversion(const Ogre::PixelBox &src, const Ogre::PixelBox
 /** @} */
 
 #endif // VC6 protection
+
+/** \addtogroup Core
+*  @{
+*/
+/** \addtogroup Image
+*  @{
+*/
+
+// Row conversions, used by PixelUtil::bulkPixelConversion for the format pairs
+// without a specialised converter above. Rows go through FLOAT32_RGBA and give
+// exactly the same results as PixelUtil::unpackColour and packColour per pixel,
+// but look the formats up once per row. 4 byte formats with 8 bit channels and
+// 16 bit floats are converted 4 values at a time with SSE2 where available.
+
+/** Converts count halfs to floats, as Bitwise::halfToFloat does */
+inline void halfToFloatRow(const Ogre::uint16 *src, float *dst, size_t count)
+{
+    size_t i = 0;
+#if __OGRE_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i expMantMask = _mm_set1_epi32(0x7fff);
+    const __m128i maxFinite = _mm_set1_epi32(0x7bff);
+    const __m128i expInfNan = _mm_set1_epi32(0xff << 23);
+    // Multiplying by 2^112 rebiases the exponent and normalises denormals
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(src + i)), zero);
+        __m128i expMant = _mm_and_si128(h, expMantMask);
+        __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expMant), 16);
+        __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMant, 13)), magic);
+        __m128i infNan = _mm_and_si128(_mm_cmpgt_epi32(expMant, maxFinite), expInfNan);
+        _mm_storeu_ps(dst + i, _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infNan))));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = Ogre::Bitwise::halfToFloat(src[i]);
+}
+
+/** Converts count floats to halfs, as Bitwise::floatToHalf does. That truncates
+    the mantissa and drops the sign of values too small for a half denormal */
+inline void floatToHalfRow(const float *src, Ogre::uint16 *dst, size_t count)
+{
+    size_t i = 0;
+#if __OGRE_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i signMask = _mm_set1_epi32(0x8000);
+    const __m128i expMask = _mm_set1_epi32(0xff);
+    const __m128i mantMask = _mm_set1_epi32(0x007fffff);
+    const __m128i absMask = _mm_set1_epi32(0x7fffffff);
+    const __m128i bias = _mm_set1_epi32(127 - 15);
+    const __m128i maxExp = _mm_set1_epi32(30);
+    const __m128i minDenormExp = _mm_set1_epi32(-11);
+    const __m128i infNanExp = _mm_set1_epi32(0xff - (127 - 15));
+    const __m128i inf = _mm_set1_epi32(0x7c00);
+    // Units of the smallest half denormal
+    const __m128 denormScale = _mm_set1_ps(16777216.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 f = _mm_loadu_ps(src + i);
+        __m128i bits = _mm_castps_si128(f);
+        __m128i s = _mm_and_si128(_mm_srli_epi32(bits, 16), signMask);
+        __m128i e = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), expMask), bias);
+        __m128i m = _mm_srli_epi32(_mm_and_si128(bits, mantMask), 13);
+
+        __m128i isOver = _mm_cmpgt_epi32(e, maxExp);
+        __m128i isNormal = _mm_andnot_si128(isOver, _mm_cmpgt_epi32(e, zero));
+        __m128i isDenorm = _mm_andnot_si128(_mm_cmpgt_epi32(e, zero), _mm_cmpgt_epi32(e, minDenormExp));
+
+        __m128i normal = _mm_or_si128(_mm_slli_epi32(e, 10), m);
+        __m128i denorm = _mm_cvttps_epi32(_mm_mul_ps(_mm_castsi128_ps(_mm_and_si128(bits, absMask)), denormScale));
+        // NaNs keep the top of their mantissa, and at least one bit of it
+        __m128i isNan = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(bits, mantMask), zero), 
+            _mm_cmpeq_epi32(e, infNanExp));
+        __m128i nanMant = _mm_or_si128(m, _mm_and_si128(_mm_cmpeq_epi32(m, zero), one));
+        __m128i over = _mm_or_si128(inf, _mm_and_si128(isNan, nanMant));
+
+        __m128i h = _mm_or_si128(_mm_and_si128(isNormal, normal), _mm_and_si128(isDenorm, denorm));
+        h = _mm_or_si128(h, _mm_and_si128(isOver, over));
+        h = _mm_or_si128(h, _mm_and_si128(_mm_or_si128(isOver, _mm_or_si128(isNormal, isDenorm)), s));
+        // Sign extend, so the signed pack doesn't saturate
+        h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+        _mm_storel_epi64((__m128i*)(dst + i), _mm_packs_epi32(h, h));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = Ogre::Bitwise::floatToHalf(src[i]);
+}
+
+/** True if the format is 4 bytes with 8 bit colour channels, and an 8 bit alpha or none */
+inline bool isFormat8888(Ogre::PixelFormat format)
+{
+    unsigned int flags = Ogre::PixelUtil::getFlags(format);
+    if (!(flags & Ogre::PFF_NATIVEENDIAN) || (flags & Ogre::PFF_LUMINANCE) || 
+        Ogre::PixelUtil::getNumElemBytes(format) != 4)
+        return false;
+    int bits[4];
+    Ogre::PixelUtil::getBitDepths(format, bits);
+    return bits[0] == 8 && bits[1] == 8 && bits[2] == 8 && (bits[3] == 8 || bits[3] == 0);
+}
+
+#if __OGRE_HAVE_SSE2
+/** Reorders the channels of a row between two formats passing isFormat8888. A 
+    missing source alpha becomes opaque, as unpacking and packing would make it */
+inline void swizzleRow8888(const Ogre::uint8 *src, Ogre::PixelFormat srcFormat, 
+    Ogre::uint8 *dst, Ogre::PixelFormat dstFormat, size_t count)
+{
+    unsigned char srcShifts[4], dstShifts[4];
+    Ogre::PixelUtil::getBitShifts(srcFormat, srcShifts);
+    Ogre::PixelUtil::getBitShifts(dstFormat, dstShifts);
+    bool srcAlpha = Ogre::PixelUtil::hasAlpha(srcFormat);
+    bool dstAlpha = Ogre::PixelUtil::hasAlpha(dstFormat);
+    int channels = srcAlpha && dstAlpha ? 4 : 3;
+    Ogre::uint32 fill = !srcAlpha && dstAlpha ? 0xFFu << dstShifts[3] : 0;
+
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i fillMask = _mm_set1_epi32((int)fill);
+    __m128i srcShift[4], dstShift[4];
+    for (int c = 0; c < 4; ++c)
+    {
+        srcShift[c] = _mm_cvtsi32_si128(srcShifts[c]);
+        dstShift[c] = _mm_cvtsi32_si128(dstShifts[c]);
+    }
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        __m128i result = fillMask;
+        for (int c = 0; c < channels; ++c)
+            result = _mm_or_si128(result, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(v, srcShift[c]), byteMask), dstShift[c]));
+        _mm_storeu_si128((__m128i*)(dst + i * 4), result);
+    }
+    for (; i < count; ++i)
+    {
+        Ogre::uint32 v, result = fill;
+        memcpy(&v, src + i * 4, 4);
+        for (int c = 0; c < channels; ++c)
+            result |= ((v >> srcShifts[c]) & 0xFF) << dstShifts[c];
+        memcpy(dst + i * 4, &result, 4);
+    }
+}
+
+/** Unpacks 4 pixels at a time of a format passing isFormat8888, returns how many were done */
+inline size_t unpackRow8888(const Ogre::uint8 *src, Ogre::PixelFormat format, float *dst, size_t count)
+{
+    unsigned char shifts[4];
+    Ogre::PixelUtil::getBitShifts(format, shifts);
+    bool hasAlpha = Ogre::PixelUtil::hasAlpha(format);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    // Divided rather than multiplied by the reciprocal, as Bitwise::fixedToFloat does
+    const __m128 maxValue = _mm_set1_ps(255.0f);
+    const __m128 opaque = _mm_set1_ps(1.0f);
+    __m128i shift[4];
+    for (int c = 0; c < 4; ++c)
+        shift[c] = _mm_cvtsi32_si128(shifts[c]);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        __m128 r = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(v, shift[0]), byteMask)), maxValue);
+        __m128 g = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(v, shift[1]), byteMask)), maxValue);
+        __m128 b = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(v, shift[2]), byteMask)), maxValue);
+        __m128 a = hasAlpha ? 
+            _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(v, shift[3]), byteMask)), maxValue) : opaque;
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        _mm_storeu_ps(dst + i * 4, r);
+        _mm_storeu_ps(dst + i * 4 + 4, g);
+        _mm_storeu_ps(dst + i * 4 + 8, b);
+        _mm_storeu_ps(dst + i * 4 + 12, a);
+    }
+    return i;
+}
+
+/** Packs 4 pixels at a time to a format passing isFormat8888, returns how many were done */
+inline size_t packRow8888(const float *src, Ogre::PixelFormat format, Ogre::uint8 *dst, size_t count)
+{
+    unsigned char shifts[4];
+    Ogre::PixelUtil::getBitShifts(format, shifts);
+    bool hasAlpha = Ogre::PixelUtil::hasAlpha(format);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 range = _mm_set1_ps(256.0f);
+    const __m128i maxValue = _mm_set1_epi32(0xff);
+    __m128i shift[4];
+    for (int c = 0; c < 4; ++c)
+        shift[c] = _mm_cvtsi32_si128(shifts[c]);
+
+// As Bitwise::floatToFixed: clamped, then truncated. NaN becomes 0
+#define FLOAT_TO_FIXED8(x) \
+    _mm_min_epi16(_mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(x, zero), one), range)), maxValue)
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 r = _mm_loadu_ps(src + i * 4);
+        __m128 g = _mm_loadu_ps(src + i * 4 + 4);
+        __m128 b = _mm_loadu_ps(src + i * 4 + 8);
+        __m128 a = _mm_loadu_ps(src + i * 4 + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        __m128i result = _mm_or_si128(_mm_sll_epi32(FLOAT_TO_FIXED8(r), shift[0]),
+            _mm_or_si128(_mm_sll_epi32(FLOAT_TO_FIXED8(g), shift[1]), _mm_sll_epi32(FLOAT_TO_FIXED8(b), shift[2])));
+        if (hasAlpha)
+            result = _mm_or_si128(result, _mm_sll_epi32(FLOAT_TO_FIXED8(a), shift[3]));
+        _mm_storeu_si128((__m128i*)(dst + i * 4), result);
+    }
+#undef FLOAT_TO_FIXED8
+    return i;
+}
+#endif
+
+/** Number of float or half channels of the float formats unpacked and packed a row at a time */
+inline size_t getFloatRowChannels(Ogre::PixelFormat format)
+{
+    switch (format)
+    {
+    case Ogre::PF_FLOAT32_R: case Ogre::PF_FLOAT16_R: return 1;
+    case Ogre::PF_FLOAT32_GR: case Ogre::PF_FLOAT16_GR: return 2;
+    case Ogre::PF_FLOAT32_RGB: case Ogre::PF_FLOAT16_RGB: return 3;
+    case Ogre::PF_FLOAT32_RGBA: case Ogre::PF_FLOAT16_RGBA: return 4;
+    default: return 0;
+    }
+}
+
+/** Converts a row of count pixels to FLOAT32_RGBA, as PixelUtil::unpackColour would */
+inline void unpackRow(const Ogre::uint8 *src, Ogre::PixelFormat format, float *dst, size_t count)
+{
+    using namespace Ogre;
+    unsigned int flags = PixelUtil::getFlags(format);
+    if (flags & PFF_NATIVEENDIAN)
+    {
+        size_t i = 0;
+#if __OGRE_HAVE_SSE2
+        if (isFormat8888(format))
+            i = unpackRow8888(src, format, dst, count);
+#endif
+        size_t elemBytes = PixelUtil::getNumElemBytes(format);
+        int bits[4];
+        uint32 masks[4];
+        unsigned char shifts[4];
+        PixelUtil::getBitDepths(format, bits);
+        PixelUtil::getBitMasks(format, masks);
+        PixelUtil::getBitShifts(format, shifts);
+        src += i * elemBytes;
+        dst += i * 4;
+        for (; i < count; ++i, src += elemBytes, dst += 4)
+        {
+            const unsigned int value = Bitwise::intRead(src, elemBytes);
+            if (flags & PFF_LUMINANCE)
+            {
+                dst[0] = dst[1] = dst[2] = Bitwise::fixedToFloat((value & masks[0]) >> shifts[0], bits[0]);
+            }
+            else
+            {
+                dst[0] = Bitwise::fixedToFloat((value & masks[0]) >> shifts[0], bits[0]);
+                dst[1] = Bitwise::fixedToFloat((value & masks[1]) >> shifts[1], bits[1]);
+                dst[2] = Bitwise::fixedToFloat((value & masks[2]) >> shifts[2], bits[2]);
+            }
+            dst[3] = (flags & PFF_HASALPHA) ? Bitwise::fixedToFloat((value & masks[3]) >> shifts[3], bits[3]) : 1.0f;
+        }
+        return;
+    }
+
+    size_t channels = getFloatRowChannels(format);
+    if (channels == 0)
+    {
+        // No row conversion, go through unpackColour
+        size_t elemBytes = PixelUtil::getNumElemBytes(format);
+        for (size_t i = 0; i < count; ++i, src += elemBytes, dst += 4)
+            PixelUtil::unpackColour(&dst[0], &dst[1], &dst[2], &dst[3], format, src);
+        return;
+    }
+
+    // Halfs are widened into the end of the row first. Pixel i is then read 
+    // from (4 - channels) * count + channels * i and written to 4 * i, which 
+    // never overwrites a pixel that hasn't been read yet
+    const float *packed = reinterpret_cast<const float*>(src);
+    if ((flags & PFF_FLOAT) && PixelUtil::getNumElemBytes(format) == channels * 2)
+    {
+        float *widened = dst + (4 - channels) * count;
+        halfToFloatRow(reinterpret_cast<const uint16*>(src), widened, channels * count);
+        packed = widened;
+    }
+    switch (channels)
+    {
+    case 4:
+        if (packed != dst)
+            memcpy(dst, packed, count * 4 * sizeof(float));
+        break;
+    case 3:
+        for (size_t i = 0; i < count; ++i, packed += 3, dst += 4)
+        {
+            float r = packed[0], g = packed[1], b = packed[2];
+            dst[0] = r; dst[1] = g; dst[2] = b; dst[3] = 1.0f;
+        }
+        break;
+    case 2:
+        for (size_t i = 0; i < count; ++i, packed += 2, dst += 4)
+        {
+            float g = packed[0], r = packed[1];
+            dst[0] = dst[2] = r; dst[1] = g; dst[3] = 1.0f;
+        }
+        break;
+    case 1:
+        for (size_t i = 0; i < count; ++i, packed += 1, dst += 4)
+        {
+            float r = packed[0];
+            dst[0] = dst[1] = dst[2] = r; dst[3] = 1.0f;
+        }
+        break;
+    }
+}
+
+/** Converts a row of count FLOAT32_RGBA pixels to format, as PixelUtil::packColour 
+    would. src is used as scratch space and overwritten */
+inline void packRow(float *src, Ogre::PixelFormat format, Ogre::uint8 *dst, size_t count)
+{
+    using namespace Ogre;
+    unsigned int flags = PixelUtil::getFlags(format);
+    if (flags & PFF_NATIVEENDIAN)
+    {
+        size_t i = 0;
+#if __OGRE_HAVE_SSE2
+        if (isFormat8888(format))
+            i = packRow8888(src, format, dst, count);
+#endif
+        size_t elemBytes = PixelUtil::getNumElemBytes(format);
+        int bits[4];
+        uint32 masks[4];
+        unsigned char shifts[4];
+        PixelUtil::getBitDepths(format, bits);
+        PixelUtil::getBitMasks(format, masks);
+        PixelUtil::getBitShifts(format, shifts);
+        src += i * 4;
+        dst += i * elemBytes;
+        for (; i < count; ++i, src += 4, dst += elemBytes)
+        {
+            const unsigned int value = ((Bitwise::floatToFixed(src[0], bits[0]) << shifts[0]) & masks[0]) |
+                ((Bitwise::floatToFixed(src[1], bits[1]) << shifts[1]) & masks[1]) |
+                ((Bitwise::floatToFixed(src[2], bits[2]) << shifts[2]) & masks[2]) |
+                ((Bitwise::floatToFixed(src[3], bits[3]) << shifts[3]) & masks[3]);
+            Bitwise::intWrite(dst, elemBytes, value);
+        }
+        return;
+    }
+
+    size_t channels = getFloatRowChannels(format);
+    if (channels == 0)
+    {
+        // No row conversion, go through packColour
+        size_t elemBytes = PixelUtil::getNumElemBytes(format);
+        for (size_t i = 0; i < count; ++i, src += 4, dst += elemBytes)
+            PixelUtil::packColour(src[0], src[1], src[2], src[3], format, dst);
+        return;
+    }
+
+    // Compact the channels in place, then copy or narrow them to halfs
+    float *packed = src;
+    switch (channels)
+    {
+    case 3:
+        for (size_t i = 0; i < count; ++i, src += 4, packed += 3)
+        {
+            packed[0] = src[0]; packed[1] = src[1]; packed[2] = src[2];
+        }
+        break;
+    case 2:
+        for (size_t i = 0; i < count; ++i, src += 4, packed += 2)
+        {
+            float r = src[0];
+            packed[0] = src[1]; packed[1] = r;
+        }
+        break;
+    case 1:
+        for (size_t i = 0; i < count; ++i, src += 4, packed += 1)
+            packed[0] = src[0];
+        break;
+    }
+    packed -= channels == 4 ? 0 : channels * count;
+    if (PixelUtil::getNumElemBytes(format) == channels * 2)
+        floatToHalfRow(packed, reinterpret_cast<uint16*>(dst), channels * count);
+    else
+        memcpy(dst, packed, channels * count * sizeof(float));
+}
+/** @} */
+/** @} */
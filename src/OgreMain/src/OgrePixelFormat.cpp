@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "OgreBitwise.h"
 #include "OgreColourValue.h"
 #include "OgreException.h"
+#include "OgreSIMDHelper.h"
+#include "OgreBlockCompression.h"
+#include "OgreWorkQueue.h"
 
 
 namespace {
@@ -658,6 +661,32 @@ namespace Ogre {
         0xFF0000, 0x00FF00, 0, 0,
         8, 0, 0, 0
         },
+    //-----------------------------------------------------------------------
+        {"PF_BC4_UNORM",
+        /* Bytes per element */
+        0,
+        /* Flags */
+        PFF_COMPRESSED,
+        /* Component type and count */
+        PCT_BYTE, 1,
+        /* rbits, gbits, bbits, abits */
+        0, 0, 0, 0,
+        /* Masks and shifts */
+        0, 0, 0, 0, 0, 0, 0, 0
+        },
+    //-----------------------------------------------------------------------
+        {"PF_BC5_UNORM",
+        /* Bytes per element */
+        0,
+        /* Flags */
+        PFF_COMPRESSED,
+        /* Component type and count */
+        PCT_BYTE, 2,
+        /* rbits, gbits, bbits, abits */
+        0, 0, 0, 0,
+        /* Masks and shifts */
+        0, 0, 0, 0, 0, 0, 0, 0
+        },
 
     };
     //-----------------------------------------------------------------------
@@ -723,11 +752,13 @@ namespace Ogre {
 				// DXT formats work by dividing the image into 4x4 blocks, then encoding each
 				// 4x4 block with a certain number of bytes. 
 				case PF_DXT1:
+				case PF_BC4_UNORM:
 					return ((width+3)/4)*((height+3)/4)*8 * depth;
 				case PF_DXT2:
 				case PF_DXT3:
 				case PF_DXT4:
 				case PF_DXT5:
+				case PF_BC5_UNORM:
 					return ((width+3)/4)*((height+3)/4)*16 * depth;
 
                 // Size calculations from the PVRTC OpenGL extension spec
@@ -803,6 +834,8 @@ namespace Ogre {
 				case PF_DXT3:
 				case PF_DXT4:
 				case PF_DXT5:
+				case PF_BC4_UNORM:
+				case PF_BC5_UNORM:
 					return ((width&3)==0 && (height&3)==0 && depth==1);
 				default:
 					return true;
@@ -1261,6 +1294,86 @@ namespace Ogre {
             }
         }
     }
+	//-----------------------------------------------------------------------
+	namespace
+	{
+		/// Splitting a compression across threads doesn't pay off below this amount of blocks per range
+		const size_t MIN_BLOCKS_PER_COMPRESSION_TASK = 1024;
+
+		/** Block rows to compress or decompress, counted over all slices. One of
+			src and dst is in a block format, the other one an accessible format.
+		*/
+		struct BlockTask : public WorkQueue::ParallelTask
+		{
+			const PixelBox* src;
+			const PixelBox* dst;
+
+			void execute(size_t rowBegin, size_t rowEnd)
+			{
+				const bool encode = PixelUtil::isCompressed(dst->format);
+				const PixelBox& image = encode ? *src : *dst;
+				const PixelFormat blockFormat = encode ? dst->format : src->format;
+				uint8* blocks = static_cast<uint8*>(encode ? dst->data : src->data);
+				const size_t blockSize = BlockCompression::getBlockSize(blockFormat);
+				const size_t width = image.getWidth(), height = image.getHeight();
+				const size_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+
+				// 4 rows of the image as PF_BYTE_RGBA, converted in one go
+				vector<uint8>::type rows(width * 4 * 4);
+				uint8 texels[16 * 4];
+				for (size_t row = rowBegin; row < rowEnd; ++row)
+				{
+					const size_t z = row / blocksY;
+					const size_t y = (row % blocksY) * 4;
+					const size_t numRows = std::min<size_t>(4, height - y);
+					PixelBox band = image.getSubVolume(Box(image.left, image.top + y, image.front + z, 
+						image.right, image.top + y + numRows, image.front + z + 1));
+					PixelBox bandRGBA(width, numRows, 1, PF_BYTE_RGBA, &rows[0]);
+					uint8* block = blocks + row * blocksX * blockSize;
+
+					if (encode)
+					{
+						PixelUtil::bulkPixelConversion(band, bandRGBA);
+						for (size_t bx = 0; bx < blocksX; ++bx, block += blockSize)
+						{
+							// Blocks over the edge repeat the last row and column
+							for (size_t i = 0; i < 16; ++i)
+							{
+								size_t tx = std::min(bx * 4 + i % 4, width - 1);
+								size_t ty = std::min(i / 4, numRows - 1);
+								memcpy(texels + i * 4, &rows[(ty * width + tx) * 4], 4);
+							}
+							BlockCompression::encodeBlock(blockFormat, texels, block);
+						}
+					}
+					else
+					{
+						for (size_t bx = 0; bx < blocksX; ++bx, block += blockSize)
+						{
+							BlockCompression::decodeBlock(blockFormat, block, texels);
+							const size_t numColumns = std::min<size_t>(4, width - bx * 4);
+							for (size_t ty = 0; ty < numRows; ++ty)
+								memcpy(&rows[(ty * width + bx * 4) * 4], texels + ty * 16, numColumns * 4);
+						}
+						PixelUtil::bulkPixelConversion(bandRGBA, band);
+					}
+				}
+			}
+		};
+
+		/// Compresses or decompresses all block rows, in ranges big enough for threads to pay off
+		void convertBlocks(const PixelBox& src, const PixelBox& dst)
+		{
+			const size_t numRows = ((src.getHeight() + 3) / 4) * src.getDepth();
+			const size_t blocksX = (src.getWidth() + 3) / 4;
+			const size_t grainSize = std::max<size_t>(MIN_BLOCKS_PER_COMPRESSION_TASK / std::max<size_t>(blocksX, 1), 1);
+
+			BlockTask task;
+			task.src = &src;
+			task.dst = &dst;
+			WorkQueue::defaultParallelFor(task, numRows, grainSize);
+		}
+	}
     //-----------------------------------------------------------------------
     /* Convert pixels from one format to another */
     void PixelUtil::bulkPixelConversion(void *srcp, PixelFormat srcFormat,
@@ -1278,7 +1391,7 @@ namespace Ogre {
 			   src.getHeight() == dst.getHeight() &&
 			   src.getDepth() == dst.getDepth());
 
-		// Check for compressed formats, we don't support decompression, compression or recoding
+		// Check for compressed formats, we support DXT and BC4/5 but no recoding
 		if(PixelUtil::isCompressed(src.format) || PixelUtil::isCompressed(dst.format))
 		{
 			if(src.format == dst.format)
@@ -1286,10 +1399,18 @@ namespace Ogre {
 				memcpy(dst.data, src.data, src.getConsecutiveSize());
 				return;
 			}
+			else if((!PixelUtil::isCompressed(src.format) && isAccessible(src.format) && 
+					BlockCompression::canEncode(dst.format)) ||
+				(!PixelUtil::isCompressed(dst.format) && isAccessible(dst.format) && 
+					BlockCompression::canDecode(src.format)))
+			{
+				convertBlocks(src, dst);
+				return;
+			}
 			else
 			{
 				OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
-					"This method can not be used to compress or decompress images",
+					"This method can only compress to or decompress from DXT and BC4/BC5 formats",
 					"PixelUtil::bulkPixelConversion");
 			}
 		}
@@ -1357,10 +1478,17 @@ namespace Ogre {
 			return;
 		}
 
+#if __OGRE_HAVE_SSE2
+		// Reordering 8 bit channels with SSE2 beats the converters below
+		const bool swizzle = isFormat8888(src.format) && isFormat8888(dst.format);
+#else
+		const bool swizzle = false;
+#endif
+
 // NB VC6 can't handle the templates required for optimised conversion, tough
 #if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
         // Is there a specialized, inlined, conversion?
-        if(doOptimizedConversion(src, dst))
+        if(!swizzle && doOptimizedConversion(src, dst))
         {
             // If so, good
             return;
@@ -1378,26 +1506,29 @@ namespace Ogre {
 		//uint8 *srcptr = static_cast<uint8*>(src.data), *dstptr = static_cast<uint8*>(dst.data);
 
         // Calculate pitches+skips in bytes
-        const size_t srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
+        const size_t srcRowPitchBytes = src.rowPitch*srcPixelSize;
         const size_t srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
-        const size_t dstRowSkipBytes = dst.getRowSkip()*dstPixelSize;
+        const size_t dstRowPitchBytes = dst.rowPitch*dstPixelSize;
         const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstPixelSize;
 
-        // The brute force fallback
-        float r = 0, g = 0, b = 0, a = 1;
+        // Everything else is converted a row at a time, through floats
+        const size_t width = src.getWidth();
+        vector<float>::type row(swizzle ? 0 : width * 4);
         for(size_t z=src.front; z<src.back; z++)
         {
             for(size_t y=src.top; y<src.bottom; y++)
             {
-                for(size_t x=src.left; x<src.right; x++)
+#if __OGRE_HAVE_SSE2
+                if(swizzle)
+                    swizzleRow8888(srcptr, src.format, dstptr, dst.format, width);
+                else
+#endif
                 {
-                    unpackColour(&r, &g, &b, &a, src.format, srcptr);
-                    packColour(r, g, b, a, dst.format, dstptr);
-                    srcptr += srcPixelSize;
-                    dstptr += dstPixelSize;
+                    unpackRow(srcptr, src.format, &row[0], width);
+                    packRow(&row[0], dst.format, dstptr, width);
                 }
-                srcptr += srcRowSkipBytes;
-                dstptr += dstRowSkipBytes;
+                srcptr += srcRowPitchBytes;
+                dstptr += dstRowPitchBytes;
             }
             srcptr += srcSliceSkipBytes;
             dstptr += dstSliceSkipBytes;
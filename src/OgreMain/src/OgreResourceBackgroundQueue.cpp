@@ -33,9 +33,55 @@ THE SOFTWARE.
 #include "OgreResourceManager.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreArchive.h"
 
 namespace Ogre {
 
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+	namespace
+	{
+		/// Size of the reads used to go through a file ahead of its request
+		const size_t READ_AHEAD_CHUNK_SIZE = 256 * 1024;
+
+		/** Reads a file through chunk by chunk in the background, so that it is
+			cached by the time it is opened again to prepare a resource. Deletes 
+			itself once the last read completes.
+		*/
+		class ReadAhead : public AsyncReadRequestListener, public ResourceAlloc
+		{
+		public:
+			ReadAhead(const DataStreamPtr& stream) 
+				: mStream(stream), mOffset(0)
+			{
+				mBuffer = OGRE_ALLOC_T(uchar, READ_AHEAD_CHUNK_SIZE, MEMCATEGORY_RESOURCE);
+			}
+			~ReadAhead()
+			{
+				OGRE_FREE(mBuffer, MEMCATEGORY_RESOURCE);
+			}
+
+			void start()
+			{
+				mStream->readAsync(mBuffer, 0, READ_AHEAD_CHUNK_SIZE, this);
+			}
+
+			void readCompleted(AsyncReadRequest* request)
+			{
+				mOffset += request->getBytesRead();
+				if (request->getBytesRead() == request->getCount() && mOffset < mStream->size())
+					mStream->readAsync(mBuffer, mOffset, READ_AHEAD_CHUNK_SIZE, this);
+				else
+					OGRE_DELETE this;
+			}
+
+		private:
+			DataStreamPtr mStream;
+			uchar* mBuffer;
+			size_t mOffset;
+		};
+	}
+#endif
+
 	// Note, no locks are required here anymore because all of the parallelisation
 	// is now contained in WorkQueue - this class is entirely single-threaded
 	//------------------------------------------------------------------------
@@ -52,6 +98,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------	
 	//------------------------------------------------------------------------
 	ResourceBackgroundQueue::ResourceBackgroundQueue()
+		: mReadAheadEnabled(true)
 	{
 	}
 	//------------------------------------------------------------------------
@@ -74,6 +121,9 @@ namespace Ogre {
 		wq->abortRequestsByChannel(mWorkQueueChannel);
 		wq->removeRequestHandler(mWorkQueueChannel, this);
 		wq->removeResponseHandler(mWorkQueueChannel, this);
+
+		OGRE_LOCK_MUTEX(mReadAheadMutex)
+		mReadAheadList.clear();
 	}
 	//------------------------------------------------------------------------
 	BackgroundProcessTicket ResourceBackgroundQueue::initialiseResourceGroup(
@@ -281,15 +331,75 @@ namespace Ogre {
 
 		Any data(req);
 
+		// Hold the lock until the request is listed, so that a worker can't 
+		// handle it before then
+		OGRE_LOCK_MUTEX(mReadAheadMutex)
 		WorkQueue::RequestID requestID = 
 			queue->addRequest(mWorkQueueChannel, (uint16)req.type, data);
 
+		if ((req.type == RT_PREPARE_RESOURCE || req.type == RT_LOAD_RESOURCE) && 
+			!req.isManual && mReadAheadEnabled)
+		{
+			ReadAheadEntry entry;
+			entry.ticket = requestID;
+			entry.resourceName = req.resourceName;
+			entry.groupName = req.groupName;
+			mReadAheadList.push_back(entry);
+		}
+
 
 		mOutstandingRequestSet.insert(requestID);
 
 		return requestID;
 	}
 	//-----------------------------------------------------------------------
+	void ResourceBackgroundQueue::readAheadAfter(BackgroundProcessTicket ticket)
+	{
+		ReadAheadEntry next;
+		{
+			OGRE_LOCK_MUTEX(mReadAheadMutex)
+			ReadAheadList::iterator i;
+			for (i = mReadAheadList.begin(); i != mReadAheadList.end(); ++i)
+			{
+				if (i->ticket == ticket)
+				{
+					mReadAheadList.erase(i);
+					break;
+				}
+			}
+			if (mReadAheadList.empty() || !mReadAheadEnabled)
+				return;
+			next = mReadAheadList.front();
+			mReadAheadList.pop_front();
+		}
+
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+		// The reads share the queue with the requests; with a single worker 
+		// thread they would only run after the next request has been handled
+		DefaultWorkQueueBase* queue = dynamic_cast<DefaultWorkQueueBase*>(Root::getSingleton().getWorkQueue());
+		if (queue && queue->getWorkerThreadCount() < 2)
+			return;
+
+		// Other archives, like zips, do their work when a file is opened, 
+		// so there would be nothing to gain there
+		Archive* arch = ResourceGroupManager::getSingleton()._findResourceArchive(
+			next.groupName, next.resourceName);
+		if (!arch || arch->getType() != "FileSystem")
+			return;
+
+		try
+		{
+			DataStreamPtr stream = arch->open(next.resourceName);
+			if (!stream.isNull() && stream->size() > 0)
+				(OGRE_NEW ReadAhead(stream))->start();
+		}
+		catch (Exception&)
+		{
+			// Reading ahead is only a hint, the request will report any error
+		}
+#endif
+	}
+	//-----------------------------------------------------------------------
 	bool ResourceBackgroundQueue::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
 	{
 		return true;
@@ -300,6 +410,9 @@ namespace Ogre {
 
 		ResourceRequest resreq = any_cast<ResourceRequest>(req->getData());
 
+		if( resreq.type == RT_PREPARE_RESOURCE || resreq.type == RT_LOAD_RESOURCE )
+			readAheadAfter(req->getID());
+
 		if( req->getAborted() )
 		{
 			if( resreq.type == RT_PREPARE_RESOURCE || resreq.type == RT_LOAD_RESOURCE )
@@ -34,8 +34,40 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef S_ISREG
+#	define S_ISREG(mode) (((mode) & S_IFMT) == S_IFREG)
+#endif
+
 namespace Ogre {
 
+	namespace
+	{
+		/// 'OGRI', marks an archive index cache
+		const uint32 ARCHIVE_INDEX_CACHE_ID = 0x4952474F;
+		/// Layout of the entries following the header
+		const uint32 ARCHIVE_INDEX_CACHE_VERSION = 2;
+
+		void writeCacheString(DataStreamPtr& stream, const String& str)
+		{
+			uint32 length = static_cast<uint32>(str.size());
+			stream->write(&length, sizeof(length));
+			if (length)
+				stream->write(str.data(), length);
+		}
+
+		bool readCacheString(DataStreamPtr& stream, String& str)
+		{
+			uint32 length = 0;
+			if (stream->read(&length, sizeof(length)) != sizeof(length))
+				return false;
+			str.resize(length);
+			return !length || stream->read(&str[0], length) == length;
+		}
+	}
+
     //-----------------------------------------------------------------------
     template<> ResourceGroupManager* Singleton<ResourceGroupManager>::msSingleton = 0;
     ResourceGroupManager* ResourceGroupManager::getSingletonPtr(void)
@@ -55,7 +87,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mPrefetchResources(true), mCurrentGroup(0)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME);
@@ -95,6 +127,7 @@ namespace Ogre {
         grp->name = name;
 		grp->inGlobalPool = inGlobalPool;
         grp->worldGeometrySceneManager = 0;
+		grp->globalIndex = &mGlobalResourceIndex;
         mResourceGroupMap.insert(
             ResourceGroupMap::value_type(name, grp));
     }
@@ -204,6 +237,9 @@ namespace Ogre {
 			for (oi = grp->loadResourceOrderMap.begin(); 
 				oi != grp->loadResourceOrderMap.end(); ++oi)
 			{
+				if (mPrefetchResources)
+					prefetchResources(grp, oi->second, false);
+
 				size_t n = 0;
 				LoadUnloadResourceList::iterator l = oi->second->begin();
 				while (l != oi->second->end())
@@ -301,6 +337,9 @@ namespace Ogre {
 			for (oi = grp->loadResourceOrderMap.begin(); 
 				oi != grp->loadResourceOrderMap.end(); ++oi)
 			{
+				if (mPrefetchResources)
+					prefetchResources(grp, oi->second, true);
+
 				size_t n = 0;
 				LoadUnloadResourceList::iterator l = oi->second->begin();
 				while (l != oi->second->end())
@@ -562,9 +601,12 @@ namespace Ogre {
 		loc->recursive = recursive;
         grp->locationList.push_back(loc);
         // Index resources
-        StringVectorPtr vec = pArch->find("*", recursive);
+        StringVectorPtr vec = listLocationFiles(pArch, recursive);
         for( StringVector::iterator it = vec->begin(); it != vec->end(); ++it )
 			grp->addToIndex(*it, pArch);
+		// Read-only archives can't change under us, keep the list for searches
+		if (pArch->isReadOnly())
+			loc->fileNames = vec;
 		
 		StringUtil::StrStreamType msg;
 		msg << "Added resource location '" << name << "' of type '" << locType
@@ -1356,6 +1398,8 @@ namespace Ogre {
 		    }
         }
 
+		mGlobalResourceIndex.removeGroup(grp);
+
 		// delete ResourceGroup
 		OGRE_DELETE_T(grp, ResourceGroup, MEMCATEGORY_RESOURCE);
 	}
@@ -1594,11 +1638,29 @@ namespace Ogre {
 
         OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME) // lock group mutex
 
+		// Plain file name patterns can be matched against the listings kept
+		// for read-only archives, in the order the archive gives them
+		bool nameOnly = !dirs && pattern.find('/') == String::npos && 
+			pattern.find('\\') == String::npos;
+
             // Iterate over the archives
             LocationList::iterator i, iend;
         iend = grp->locationList.end();
         for (i = grp->locationList.begin(); i != iend; ++i)
         {
+			const StringVectorPtr& fileNames = (*i)->fileNames;
+			if (nameOnly && !fileNames.isNull())
+			{
+				bool caseSensitive = (*i)->archive->isCaseSensitive();
+				String path, basename;
+				for (StringVector::const_iterator f = fileNames->begin(); f != fileNames->end(); ++f)
+				{
+					StringUtil::splitFilename(*f, basename, path);
+					if (StringUtil::match(basename, pattern, caseSensitive))
+						vec->push_back(*f);
+				}
+				continue;
+			}
             StringVectorPtr lst = (*i)->archive->find(pattern, (*i)->recursive, dirs);
             vec->insert(vec->end(), lst->begin(), lst->end());
         }
@@ -1695,6 +1757,104 @@ namespace Ogre {
 
 	}
 	//-----------------------------------------------------------------------
+	Archive* ResourceGroupManager::_findResourceArchive(const String& groupName, 
+		const String& filename)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+
+		ResourceGroup* grp = getResourceGroup(groupName);
+		Archive* arch = grp ? findResourceArchiveImpl(grp, filename) : 0;
+		if (!arch)
+		{
+			grp = findGroupContainingResourceImpl(filename);
+			if (grp)
+				arch = findResourceArchiveImpl(grp, filename);
+		}
+		return arch;
+	}
+	//-----------------------------------------------------------------------
+	Archive* ResourceGroupManager::findResourceArchiveImpl(ResourceGroup* grp, 
+		const String& filename, bool searchLocations)
+	{
+		OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME) // lock group mutex
+
+		ResourceLocationIndex::iterator rit = grp->resourceIndexCaseSensitive.find(filename);
+		if (rit != grp->resourceIndexCaseSensitive.end())
+			return rit->second;
+
+		String lcFilename = filename;
+		StringUtil::toLowerCase(lcFilename);
+		rit = grp->resourceIndexCaseInsensitive.find(lcFilename);
+		if (rit != grp->resourceIndexCaseInsensitive.end())
+			return rit->second;
+
+		if (!searchLocations)
+			return 0;
+		for (LocationList::iterator li = grp->locationList.begin(); li != grp->locationList.end(); ++li)
+		{
+			if ((*li)->archive->exists(filename))
+				return (*li)->archive;
+		}
+		return 0;
+	}
+	//-----------------------------------------------------------------------
+	namespace
+	{
+		/// Orders resource files by location, then by position in storage
+		struct StorageOrderLess
+		{
+			typedef std::pair<size_t, uint64> Key;
+			const map<Resource*, Key>::type* keys;
+
+			bool operator()(const ResourcePtr& a, const ResourcePtr& b) const
+			{
+				return keys->find(a.get())->second < keys->find(b.get())->second;
+			}
+		};
+	}
+	//-----------------------------------------------------------------------
+	void ResourceGroupManager::prefetchResources(ResourceGroup* grp, 
+		LoadUnloadResourceList* resources, bool forLoad)
+	{
+		OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME) // lock group mutex
+
+		// Position of each location, so files are read location by location
+		map<Archive*, size_t>::type locationIndex;
+		size_t index = 0;
+		for (LocationList::iterator li = grp->locationList.begin(); li != grp->locationList.end(); ++li)
+			locationIndex.insert(std::make_pair((*li)->archive, index++));
+
+		// Only resources with a file of their name, which still need reading
+		typedef map<Archive*, StringVector>::type ArchiveFileMap;
+		ArchiveFileMap files;
+		map<Resource*, StorageOrderLess::Key>::type keys;
+		vector<LoadUnloadResourceList::iterator>::type slots;
+		vector<ResourcePtr>::type sorted;
+		for (LoadUnloadResourceList::iterator i = resources->begin(); i != resources->end(); ++i)
+		{
+			Resource* res = i->get();
+			if (res->isLoaded() || (!forLoad && res->isPrepared()))
+				continue;
+			Archive* arch = findResourceArchiveImpl(grp, res->getName(), false);
+			if (!arch)
+				continue;
+
+			files[arch].push_back(res->getName());
+			keys[res] = StorageOrderLess::Key(locationIndex[arch], arch->getStorageOrder(res->getName()));
+			slots.push_back(i);
+			sorted.push_back(*i);
+		}
+
+		for (ArchiveFileMap::iterator f = files.begin(); f != files.end(); ++f)
+			f->first->prefetch(f->second);
+
+		// Put the sorted resources back into the places the unsorted ones held
+		StorageOrderLess less = { &keys };
+		std::stable_sort(sorted.begin(), sorted.end(), less);
+		for (size_t i = 0; i < slots.size(); ++i)
+			*slots[i] = sorted[i];
+	}
+	//-----------------------------------------------------------------------
 	time_t ResourceGroupManager::resourceModifiedTime(const String& groupName, const String& resourceName)
 	{
 		OGRE_LOCK_AUTO_MUTEX
@@ -1758,6 +1918,38 @@ namespace Ogre {
 	{
         OGRE_LOCK_AUTO_MUTEX
 
+		// Try the global index first; of the groups indexing the name pick
+		// the first by name, as the search below would
+		String lcFilename = filename;
+		StringUtil::toLowerCase(lcFilename);
+		ResourceGroupMap candidates;
+		{
+			OGRE_LOCK_MUTEX(mGlobalResourceIndex.OGRE_AUTO_MUTEX_NAME)
+			GlobalResourceIndex::NameMap::iterator ni = mGlobalResourceIndex.names.find(lcFilename);
+			if (ni != mGlobalResourceIndex.names.end())
+			{
+				GlobalResourceIndex::GroupCountMap::iterator gi;
+				for (gi = ni->second.begin(); gi != ni->second.end(); ++gi)
+					candidates[gi->first->name] = gi->first;
+			}
+		}
+		// Groups are only locked once the index is released, since the index
+		// is updated with the group lock held
+		ResourceGroup* indexed = 0;
+		for (ResourceGroupMap::iterator ci = candidates.begin(); ci != candidates.end() && !indexed; ++ci)
+		{
+			// Only the case insensitive archives may match by lower case name
+			ResourceGroup* grp = ci->second;
+			OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME)
+			if (grp->resourceIndexCaseSensitive.find(filename) != grp->resourceIndexCaseSensitive.end() ||
+				grp->resourceIndexCaseInsensitive.find(lcFilename) != grp->resourceIndexCaseInsensitive.end())
+			{
+				indexed = grp;
+			}
+		}
+		if (indexed)
+			return indexed;
+
 			// Iterate over resource groups and find
 		for (ResourceGroupMap::iterator i = mResourceGroupMap.begin();
 			i != mResourceGroupMap.end(); ++i)
@@ -1961,7 +2153,12 @@ namespace Ogre {
 	void ResourceGroupManager::ResourceGroup::addToIndex(const String& filename, Archive* arch)
 	{
 		// internal, assumes mutex lock has already been obtained
-		this->resourceIndexCaseSensitive[filename] = arch;
+		std::pair<ResourceLocationIndex::iterator, bool> inserted = 
+			this->resourceIndexCaseSensitive.insert(ResourceLocationIndex::value_type(filename, arch));
+		if (inserted.second)
+			globalIndex->add(filename, this);
+		else
+			inserted.first->second = arch;
 
 		if (!arch->isCaseSensitive())
 		{
@@ -1976,13 +2173,16 @@ namespace Ogre {
 		// internal, assumes mutex lock has already been obtained
 		ResourceLocationIndex::iterator i = this->resourceIndexCaseSensitive.find(filename);
 		if (i != this->resourceIndexCaseSensitive.end() && i->second == arch)
+		{
 			this->resourceIndexCaseSensitive.erase(i);
+			globalIndex->remove(filename, this);
+		}
 
 		if (!arch->isCaseSensitive())
 		{
 			String lcase = filename;
 			StringUtil::toLowerCase(lcase);
-			i = this->resourceIndexCaseInsensitive.find(filename);
+			i = this->resourceIndexCaseInsensitive.find(lcase);
 			if (i != this->resourceIndexCaseInsensitive.end() && i->second == arch)
 				this->resourceIndexCaseInsensitive.erase(i);
 		}
@@ -2011,6 +2211,7 @@ namespace Ogre {
 			if (rit->second == arch)
 			{
 				ResourceLocationIndex::iterator del = rit++;
+				globalIndex->remove(del->first, this);
 				this->resourceIndexCaseSensitive.erase(del);
 			}
 			else
@@ -2025,6 +2226,150 @@ namespace Ogre {
 	ScriptLoader::~ScriptLoader()
 	{
 	}
+	//---------------------------------------------------------------------
+	//---------------------------------------------------------------------
+	void ResourceGroupManager::GlobalResourceIndex::add(const String& filename, ResourceGroup* grp)
+	{
+		String lcase = filename;
+		StringUtil::toLowerCase(lcase);
+		OGRE_LOCK_AUTO_MUTEX
+		++names[lcase][grp];
+	}
+	//---------------------------------------------------------------------
+	void ResourceGroupManager::GlobalResourceIndex::remove(const String& filename, ResourceGroup* grp)
+	{
+		String lcase = filename;
+		StringUtil::toLowerCase(lcase);
+		OGRE_LOCK_AUTO_MUTEX
+		NameMap::iterator ni = names.find(lcase);
+		if (ni == names.end())
+			return;
+		GroupCountMap::iterator gi = ni->second.find(grp);
+		if (gi != ni->second.end() && --gi->second == 0)
+		{
+			ni->second.erase(gi);
+			if (ni->second.empty())
+				names.erase(ni);
+		}
+	}
+	//---------------------------------------------------------------------
+	void ResourceGroupManager::GlobalResourceIndex::removeGroup(ResourceGroup* grp)
+	{
+		OGRE_LOCK_AUTO_MUTEX
+		for (NameMap::iterator ni = names.begin(); ni != names.end(); )
+		{
+			ni->second.erase(grp);
+			if (ni->second.empty())
+				names.erase(ni++);
+			else
+				++ni;
+		}
+	}
+	//---------------------------------------------------------------------
+	StringVectorPtr ResourceGroupManager::listLocationFiles(Archive* arch, bool recursive)
+	{
+		// Only read-only archives which are plain files can be trusted to
+		// show any change in their modification time or size
+		struct stat tagStat;
+		bool cacheable = arch->isReadOnly() && 
+			stat(arch->getName().c_str(), &tagStat) == 0 && S_ISREG(tagStat.st_mode);
+		if (!cacheable)
+			return arch->find("*", recursive);
+
+		String key = arch->getType() + (recursive ? ":r:" : ":n:") + arch->getName();
+		{
+			OGRE_LOCK_MUTEX(mArchiveIndexCacheMutex)
+			ArchiveIndexCache::iterator i = mArchiveIndexCache.find(key);
+			if (i != mArchiveIndexCache.end() && 
+				i->second.modifiedTime == tagStat.st_mtime &&
+				i->second.fileSize == static_cast<uint64>(tagStat.st_size))
+			{
+				return i->second.fileNames;
+			}
+		}
+
+		ArchiveIndexCacheEntry entry;
+		entry.modifiedTime = tagStat.st_mtime;
+		entry.fileSize = static_cast<uint64>(tagStat.st_size);
+		entry.fileNames = arch->find("*", recursive);
+		OGRE_LOCK_MUTEX(mArchiveIndexCacheMutex)
+		mArchiveIndexCache[key] = entry;
+		return entry.fileNames;
+	}
+	//---------------------------------------------------------------------
+	void ResourceGroupManager::saveArchiveIndexCache(DataStreamPtr stream)
+	{
+		if (!stream->isWriteable())
+		{
+			OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+				"Unable to write to stream " + stream->getName(),
+				"ResourceGroupManager::saveArchiveIndexCache");
+		}
 
+		OGRE_LOCK_MUTEX(mArchiveIndexCacheMutex)
+
+		uint32 header[3] = { ARCHIVE_INDEX_CACHE_ID, ARCHIVE_INDEX_CACHE_VERSION, 
+			static_cast<uint32>(mArchiveIndexCache.size()) };
+		stream->write(header, sizeof(header));
+		for (ArchiveIndexCache::const_iterator i = mArchiveIndexCache.begin(); 
+			i != mArchiveIndexCache.end(); ++i)
+		{
+			writeCacheString(stream, i->first);
+			int64 modifiedTime = static_cast<int64>(i->second.modifiedTime);
+			stream->write(&modifiedTime, sizeof(modifiedTime));
+			stream->write(&i->second.fileSize, sizeof(i->second.fileSize));
+			uint32 count = static_cast<uint32>(i->second.fileNames->size());
+			stream->write(&count, sizeof(count));
+			for (StringVector::const_iterator f = i->second.fileNames->begin(); 
+				f != i->second.fileNames->end(); ++f)
+			{
+				writeCacheString(stream, *f);
+			}
+		}
+	}
+	//---------------------------------------------------------------------
+	void ResourceGroupManager::loadArchiveIndexCache(DataStreamPtr stream)
+	{
+		uint32 header[3] = { 0, 0, 0 };
+		if (stream->read(header, sizeof(header)) != sizeof(header) || 
+			header[0] != ARCHIVE_INDEX_CACHE_ID || header[1] != ARCHIVE_INDEX_CACHE_VERSION)
+		{
+			LogManager::getSingleton().logMessage("Ignoring archive index cache " + 
+				stream->getName() + ", it is not in the expected format");
+			return;
+		}
+
+		ArchiveIndexCache cache;
+		for (uint32 i = 0; i < header[2]; ++i)
+		{
+			String key;
+			int64 modifiedTime = 0;
+			uint64 fileSize = 0;
+			uint32 count = 0;
+			if (!readCacheString(stream, key) ||
+				stream->read(&modifiedTime, sizeof(modifiedTime)) != sizeof(modifiedTime) ||
+				stream->read(&fileSize, sizeof(fileSize)) != sizeof(fileSize) ||
+				stream->read(&count, sizeof(count)) != sizeof(count))
+			{
+				break;
+			}
+
+			ArchiveIndexCacheEntry entry;
+			entry.modifiedTime = static_cast<time_t>(modifiedTime);
+			entry.fileSize = fileSize;
+			entry.fileNames = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+			entry.fileNames->resize(count);
+			bool complete = true;
+			for (uint32 f = 0; f < count && complete; ++f)
+				complete = readCacheString(stream, entry.fileNames->at(f));
+			if (!complete)
+				break;
+			cache[key] = entry;
+		}
+
+		OGRE_LOCK_MUTEX(mArchiveIndexCacheMutex)
+		for (ArchiveIndexCache::iterator i = cache.begin(); i != cache.end(); ++i)
+			mArchiveIndexCache[i->first] = i->second;
+	}
 
 }
@@ -73,10 +73,15 @@ namespace Ogre {
 		bool isManual, ManualResourceLoader* loader, 
 		const NameValuePairList* params)
 	{
-		// Lock for the whole get / insert
+		// Most calls find an existing resource, which only needs the read lock
+		ResourcePtr res = getByName(name, group);
+		if (!res.isNull())
+			return ResourceCreateOrRetrieveResult(res, false);
+
+		// Lock for the whole get / insert, checking again under the lock
 		OGRE_LOCK_AUTO_MUTEX
 
-		ResourcePtr res = getByName(name, group);
+		res = getByName(name, group);
 		bool created = false;
 		if (res.isNull())
 		{
@@ -107,113 +112,114 @@ namespace Ogre {
         return r;
     }
     //-----------------------------------------------------------------------
-	void ResourceManager::addImpl( ResourcePtr& res )
+	bool ResourceManager::insertImpl( ResourcePtr& res, bool inGlobalPool )
 	{
-		OGRE_LOCK_AUTO_MUTEX
+		OGRE_LOCK_RW_MUTEX_WRITE(mResourcesMutex);
 
-			std::pair<ResourceMap::iterator, bool> result;
-		if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
+		std::pair<ResourceMap::iterator, bool> result;
+		ResourceIdMap* idMap;
+		if (inGlobalPool)
 		{
 			result = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
+			idMap = &mResourcesById;
 		}
 		else
 		{
-			ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(res->getGroup());
-
 			// we will create the group if it doesn't exists in our list
-			if( itGroup == mResourcesWithGroup.end())
-			{
-				ResourceMap dummy;
-				mResourcesWithGroup.insert( ResourceWithGroupMap::value_type( res->getGroup(), dummy ) );
-				itGroup = mResourcesWithGroup.find(res->getGroup());
-			}
+			ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.insert( 
+				ResourceWithGroupMap::value_type( res->getGroup(), ResourceMap() ) ).first;
 			result = itGroup->second.insert( ResourceMap::value_type( res->getName(), res ) );
+			idMap = &mResourcesWithGroupById[res->getGroup()];
+		}
+		if (!result.second)
+			return false;
+
+		// Index the entry by interned name too, for getByName(IdString)
+		(*idMap)[IdString(res->getName())._getInterned()] = &result.first->second;
 
+		// Insert the handle
+		std::pair<ResourceHandleMap::iterator, bool> resultHandle = 
+			mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
+		if (!resultHandle.second)
+		{
+			OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the handle " + 
+				StringConverter::toString((long) (res->getHandle())) + 
+				" already exists.", "ResourceManager::add");
 		}
+		return true;
+	}
+	//-----------------------------------------------------------------------
+	void ResourceManager::addImpl( ResourcePtr& res )
+	{
+		OGRE_LOCK_AUTO_MUTEX
 
-		if (!result.second)
+		// Ask the group manager before taking the write lock, it has its own
+		bool inGlobalPool = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
+		if (!insertImpl(res, inGlobalPool))
 		{
 			// Attempt to resolve the collision
-			if(ResourceGroupManager::getSingleton().getLoadingListener())
+			ResourceLoadingListener* listener = ResourceGroupManager::getSingleton().getLoadingListener();
+			if (listener && listener->resourceCollision(res.get(), this))
 			{
-				if(ResourceGroupManager::getSingleton().getLoadingListener()->resourceCollision(res.get(), this))
+				// Try to do the addition again, no seconds attempts to resolve collisions are allowed
+				if (!insertImpl(res, inGlobalPool))
 				{
-					// Try to do the addition again, no seconds attempts to resolve collisions are allowed
-					std::pair<ResourceMap::iterator, bool> insertResult;
-					if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
-					{
-						insertResult = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
-					}
-					else
-					{
-						ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(res->getGroup());
-						insertResult = itGroup->second.insert( ResourceMap::value_type( res->getName(), res ) );
-					}
-					if (!insertResult.second)
-					{
-						OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the name " + res->getName() + 
-							" already exists.", "ResourceManager::add");
-					}
-
-					std::pair<ResourceHandleMap::iterator, bool> resultHandle = 
-						mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
-					if (!resultHandle.second)
-					{
-						OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the handle " + 
-							StringConverter::toString((long) (res->getHandle())) + 
-							" already exists.", "ResourceManager::add");
-					}
+					OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the name " + res->getName() + 
+						" already exists.", "ResourceManager::add");
 				}
 			}
 		}
-		else
-		{
-			// Insert the handle
-			std::pair<ResourceHandleMap::iterator, bool> resultHandle = 
-				mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
-			if (!resultHandle.second)
-			{
-				OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the handle " + 
-					StringConverter::toString((long) (res->getHandle())) + 
-					" already exists.", "ResourceManager::add");
-			}
-		}
 	}
 	//-----------------------------------------------------------------------
 	void ResourceManager::removeImpl( ResourcePtr& res )
 	{
 		OGRE_LOCK_AUTO_MUTEX
 
-		if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
+		bool inGlobalPool = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
 		{
-			ResourceMap::iterator nameIt = mResources.find(res->getName());
-			if (nameIt != mResources.end())
+			OGRE_LOCK_RW_MUTEX_WRITE(mResourcesMutex);
+			if (inGlobalPool)
 			{
-				mResources.erase(nameIt);
+				ResourceMap::iterator nameIt = mResources.find(res->getName());
+				if (nameIt != mResources.end())
+				{
+					mResources.erase(nameIt);
+					mResourcesById.erase(IdString(res->getName())._getInterned());
+				}
 			}
-		}
-		else
-		{
-			ResourceWithGroupMap::iterator groupIt = mResourcesWithGroup.find(res->getGroup());
-			if (groupIt != mResourcesWithGroup.end())
+			else
 			{
-				ResourceMap::iterator nameIt = groupIt->second.find(res->getName());
-				if (nameIt != groupIt->second.end())
+				ResourceWithGroupMap::iterator groupIt = mResourcesWithGroup.find(res->getGroup());
+				if (groupIt != mResourcesWithGroup.end())
 				{
-					groupIt->second.erase(nameIt);
-				}
+					ResourceMap::iterator nameIt = groupIt->second.find(res->getName());
+					if (nameIt != groupIt->second.end())
+					{
+						groupIt->second.erase(nameIt);
+					}
 
-				if (groupIt->second.empty())
-				{
-					mResourcesWithGroup.erase(groupIt);
+					ResourceIdWithGroupMap::iterator idGroupIt = mResourcesWithGroupById.find(res->getGroup());
+					if (idGroupIt != mResourcesWithGroupById.end())
+					{
+						idGroupIt->second.erase(IdString(res->getName())._getInterned());
+						if (idGroupIt->second.empty())
+						{
+							mResourcesWithGroupById.erase(idGroupIt);
+						}
+					}
+
+					if (groupIt->second.empty())
+					{
+						mResourcesWithGroup.erase(groupIt);
+					}
 				}
 			}
-		}
 
-		ResourceHandleMap::iterator handleIt = mResourcesByHandle.find(res->getHandle());
-		if (handleIt != mResourcesByHandle.end())
-		{
-			mResourcesByHandle.erase(handleIt);
+			ResourceHandleMap::iterator handleIt = mResourcesByHandle.find(res->getHandle());
+			if (handleIt != mResourcesByHandle.end())
+			{
+				mResourcesByHandle.erase(handleIt);
+			}
 		}
 		// Tell resource group manager
 		ResourceGroupManager::getSingleton()._notifyResourceRemoved(res);
@@ -358,9 +364,18 @@ namespace Ogre {
 	{
 		OGRE_LOCK_AUTO_MUTEX
 
-		mResources.clear();
-		mResourcesWithGroup.clear();
-		mResourcesByHandle.clear();
+		// Resources may be destroyed here; let that happen outside the write lock
+		ResourceMap resources;
+		ResourceWithGroupMap resourcesWithGroup;
+		ResourceHandleMap resourcesByHandle;
+		{
+			OGRE_LOCK_RW_MUTEX_WRITE(mResourcesMutex);
+			resources.swap(mResources);
+			resourcesWithGroup.swap(mResourcesWithGroup);
+			resourcesByHandle.swap(mResourcesByHandle);
+			mResourcesById.clear();
+			mResourcesWithGroupById.clear();
+		}
 		// Notify resource group manager
 		ResourceGroupManager::getSingleton()._notifyAllResourcesRemoved(this);
 	}
@@ -397,7 +412,7 @@ namespace Ogre {
 		// if not in the global pool - get it from the grouped pool 
 		if(!ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(groupName))
 		{
-			OGRE_LOCK_AUTO_MUTEX
+			OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
 			ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(groupName);
 
 			if( itGroup != mResourcesWithGroup.end())
@@ -414,7 +429,7 @@ namespace Ogre {
 		// if didn't find it the grouped pool - get it from the global pool 
 		if (res.isNull())
 		{
-			OGRE_LOCK_AUTO_MUTEX
+			OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
 
 			ResourceMap::iterator it = mResources.find(name);
 
@@ -446,9 +461,48 @@ namespace Ogre {
 		return res;
     }
     //-----------------------------------------------------------------------
+    ResourcePtr ResourceManager::getByName(const IdString& name, const String& groupName /* = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME */)
+    {
+		// Same search order as the String version, on the interned indexes
+		bool autoDetect = (groupName == ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+		bool searchGroup = !autoDetect && 
+			!ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(groupName);
+		const String* key = name._getInterned();
+
+		OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
+
+		if (searchGroup)
+		{
+			ResourceIdWithGroupMap::iterator itGroup = mResourcesWithGroupById.find(groupName);
+			if (itGroup != mResourcesWithGroupById.end())
+			{
+				ResourceIdMap::iterator it = itGroup->second.find(key);
+				if (it != itGroup->second.end())
+					return *it->second;
+			}
+		}
+
+		ResourceIdMap::iterator it = mResourcesById.find(key);
+		if (it != mResourcesById.end())
+			return *it->second;
+
+		if (autoDetect)
+		{
+			ResourceIdWithGroupMap::iterator iter, iterE = mResourcesWithGroupById.end();
+			for (iter = mResourcesWithGroupById.begin(); iter != iterE; ++iter)
+			{
+				ResourceIdMap::iterator resIt = iter->second.find(key);
+				if (resIt != iter->second.end())
+					return *resIt->second;
+			}
+		}
+
+		return ResourcePtr();
+    }
+    //-----------------------------------------------------------------------
     ResourcePtr ResourceManager::getByHandle(ResourceHandle handle)
     {
-		OGRE_LOCK_AUTO_MUTEX
+		OGRE_LOCK_RW_MUTEX_READ(mResourcesMutex);
 
         ResourceHandleMap::iterator it = mResourcesByHandle.find(handle);
         if (it == mResourcesByHandle.end())
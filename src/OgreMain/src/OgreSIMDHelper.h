@@ -78,6 +78,15 @@ THE SOFTWARE.
 
 #endif // OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_X86
 
+// SSE2 integer instructions are only used when the compiler targets them 
+// anyway, which is always the case for x86-64
+#if __OGRE_HAVE_SSE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define __OGRE_HAVE_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define __OGRE_HAVE_SSE2 0
+#endif
+
 
 
 //---------------------------------------------------------------------
@@ -292,6 +301,19 @@ namespace Ogre {
             _mm_sub_ps(v3pt0, _mm_mul_ps(_mm_mul_ps(x, t), t)));
     }
 
+    /** Round down non-negative values below 2^23 to integers, without leaving
+        the SSE registers (SSE1 has no packed float to int conversion).
+    */
+    static FORCEINLINE __m128 __mm_floor_positive_ps(const __m128& x)
+    {
+        static const __m128 vMagic = { 8388608.0f, 8388608.0f, 8388608.0f, 8388608.0f };
+        static const __m128 v1pt0 = { 1.0f, 1.0f, 1.0f, 1.0f };
+        // Adding 2^23 pushes the fraction out of the mantissa (round to nearest),
+        // then step back down wherever that rounded up
+        __m128 r = _mm_sub_ps(_mm_add_ps(x, vMagic), vMagic);
+        return _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, x), v1pt0));
+    }
+
 // Macro to check the stack aligned for SSE
 #if OGRE_DEBUG_MODE
 #define __OGRE_CHECK_STACK_ALIGNED_FOR_SSE()        \
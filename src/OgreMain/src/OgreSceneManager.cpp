@@ -346,7 +346,8 @@ void SceneManager::destroyCamera(const String& name)
 			mShadowCamLightMapping.erase( camLightIt );
 
 		// Notify render system
-        mDestRenderSystem->_notifyCameraRemoved(i->second);
+		if (mDestRenderSystem)
+			mDestRenderSystem->_notifyCameraRemoved(i->second);
         OGRE_DELETE i->second;
         mCameras.erase(i);
     }
@@ -564,6 +565,20 @@ Entity* SceneManager::createEntity(const MeshPtr& pMesh)
     String name = mMovableNameGenerator.generate();
     return createEntity(name, pMesh);
 }
+//---------------------------------------------------------------------
+Entity* SceneManager::createAnonymousEntity(const String& meshName, const String& groupName)
+{
+	NameValuePairList params;
+	params["mesh"] = meshName;
+	params["resourceGroup"] = groupName;
+	return static_cast<Entity*>(
+		createAnonymousMovableObject(EntityFactory::FACTORY_TYPE_NAME, &params));
+}
+//---------------------------------------------------------------------
+Entity* SceneManager::createAnonymousEntity(const MeshPtr& pMesh)
+{
+	return createAnonymousEntity(pMesh->getName(), pMesh->getGroup());
+}
 //-----------------------------------------------------------------------
 Entity* SceneManager::getEntity(const String& name) const
 {
@@ -797,6 +812,13 @@ void SceneManager::clearScene(void)
 		OGRE_DELETE i->second;
 	}
 	mSceneNodes.clear();
+	const SlotMap<SceneNode>::ItemList& anonymousNodes = mAnonymousSceneNodes.getItems();
+	for (SlotMap<SceneNode>::ItemList::const_iterator i = anonymousNodes.begin();
+		i != anonymousNodes.end(); ++i)
+	{
+		OGRE_DELETE *i;
+	}
+	mAnonymousSceneNodes.clear();
 	mAutoTrackingSceneNodes.clear();
 
 
@@ -857,6 +879,21 @@ void SceneManager::destroySceneNode(const String& name)
             "SceneManager::destroySceneNode");
     }
 
+    deleteSceneNode(i->second);
+    mSceneNodes.erase(i);
+}
+//---------------------------------------------------------------------
+void SceneManager::destroySceneNode(SceneNode* sn)
+{
+	if (sn->getHandle().isNull())
+		destroySceneNode(sn->getName());
+	else
+		destroySceneNode(sn->getHandle());
+
+}
+//---------------------------------------------------------------------
+void SceneManager::deleteSceneNode(SceneNode* sn)
+{
     // Find any scene nodes which are tracking this node, and turn them off
     AutoTrackingSceneNodes::iterator ai, aiend;
     aiend = mAutoTrackingSceneNodes.end();
@@ -866,13 +903,13 @@ void SceneManager::destroySceneNode(const String& name)
 		AutoTrackingSceneNodes::iterator curri = ai++;
         SceneNode* n = *curri;
         // Tracking this node
-        if (n->getAutoTrackTarget() == i->second)
+        if (n->getAutoTrackTarget() == sn)
         {
             // turn off, this will notify SceneManager to remove
             n->setAutoTracking(false);
         }
         // node is itself a tracker
-        else if (n == i->second)
+        else if (n == sn)
         {
             mAutoTrackingSceneNodes.erase(curri);
         }
@@ -880,19 +917,65 @@ void SceneManager::destroySceneNode(const String& name)
 
 	// detach from parent (don't do this in destructor since bulk destruction
 	// behaves differently)
-	Node* parentNode = i->second->getParent();
+	Node* parentNode = sn->getParent();
 	if (parentNode)
 	{
-		parentNode->removeChild(i->second);
+		parentNode->removeChild(sn);
 	}
-    OGRE_DELETE i->second;
-    mSceneNodes.erase(i);
+    OGRE_DELETE sn;
 }
 //---------------------------------------------------------------------
-void SceneManager::destroySceneNode(SceneNode* sn)
+String SceneManager::makeAnonymousName(uint32 scope, const SlotHandle& handle)
 {
-	destroySceneNode(sn->getName());
-
+	// Written backwards without a stream; short enough to fit in the
+	// small string buffer of most implementations
+	char buf[40];
+	char* end = buf + sizeof(buf);
+	char* p = end;
+	const uint32 parts[3] = { handle.generation, handle.index, scope };
+	for (int i = 0; i < 3; ++i)
+	{
+		uint32 v = parts[i];
+		do
+		{
+			*--p = static_cast<char>('0' + v % 10);
+			v /= 10;
+		} while (v);
+		*--p = i < 2 ? ':' : '@';
+	}
+	return String(p, end);
+}
+//---------------------------------------------------------------------
+SceneNode* SceneManager::createAnonymousSceneNode(void)
+{
+	SlotHandle handle = mAnonymousSceneNodes.nextHandle();
+	SceneNode* sn = createSceneNodeImpl(makeAnonymousName(0, handle));
+	mAnonymousSceneNodes.insert(sn);
+	sn->_notifyHandle(handle);
+	return sn;
+}
+//---------------------------------------------------------------------
+void SceneManager::destroySceneNode(const SlotHandle& handle)
+{
+	SceneNode* sn = mAnonymousSceneNodes.erase(handle);
+	if (sn)
+		deleteSceneNode(sn);
+}
+//---------------------------------------------------------------------
+SceneNode* SceneManager::getSceneNode(const SlotHandle& handle) const
+{
+	SceneNode* sn = mAnonymousSceneNodes.get(handle);
+	if (!sn)
+	{
+		OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Anonymous SceneNode not found.",
+			"SceneManager::getSceneNode");
+	}
+	return sn;
+}
+//---------------------------------------------------------------------
+bool SceneManager::hasSceneNode(const SlotHandle& handle) const
+{
+	return mAnonymousSceneNodes.contains(handle);
 }
 //-----------------------------------------------------------------------
 SceneNode* SceneManager::getRootSceneNode(void)
@@ -4372,45 +4455,19 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
 
 		// Pre-allocate memory
 		mTestLightInfos.clear();
-		mTestLightInfos.reserve(lights->map.size());
+		mTestLightInfos.reserve(lights->map.size() + lights->anonymous.size());
 
 		MovableObjectIterator it(lights->map.begin(), lights->map.end());
 
 		while(it.hasMoreElements())
 		{
-			Light* l = static_cast<Light*>(it.getNext());
-
-			if (mCameraRelativeRendering)
-				l->_setCameraRelative(mCameraInProgress);
-			else
-				l->_setCameraRelative(0);
+			testLightAffectingFrustum(static_cast<Light*>(it.getNext()), camera);
+		}
 
-			if (l->isVisible())
-			{
-				LightInfo lightInfo;
-				lightInfo.light = l;
-				lightInfo.type = l->getType();
-				lightInfo.lightMask = l->getLightMask();
-				if (lightInfo.type == Light::LT_DIRECTIONAL)
-				{
-					// Always visible
-					lightInfo.position = Vector3::ZERO;
-					lightInfo.range = 0;
-					mTestLightInfos.push_back(lightInfo);
-				}
-				else
-				{
-					// NB treating spotlight as point for simplicity
-					// Just see if the lights attenuation range is within the frustum
-					lightInfo.range = l->getAttenuationRange();
-					lightInfo.position = l->getDerivedPosition();
-					Sphere sphere(lightInfo.position, lightInfo.range);
-					if (camera->isVisible(sphere))
-					{
-						mTestLightInfos.push_back(lightInfo);
-					}
-				}
-			}
+		AnonymousMovableObjectIterator ait(lights->anonymous.getItems());
+		while(ait.hasMoreElements())
+		{
+			testLightAffectingFrustum(static_cast<Light*>(ait.getNext()), camera);
 		}
 	} // release lock on lights collection
 
@@ -4465,6 +4522,41 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
 
 }
 //---------------------------------------------------------------------
+void SceneManager::testLightAffectingFrustum(Light* l, const Camera* camera)
+{
+	if (mCameraRelativeRendering)
+		l->_setCameraRelative(mCameraInProgress);
+	else
+		l->_setCameraRelative(0);
+
+	if (l->isVisible())
+	{
+		LightInfo lightInfo;
+		lightInfo.light = l;
+		lightInfo.type = l->getType();
+		lightInfo.lightMask = l->getLightMask();
+		if (lightInfo.type == Light::LT_DIRECTIONAL)
+		{
+			// Always visible
+			lightInfo.position = Vector3::ZERO;
+			lightInfo.range = 0;
+			mTestLightInfos.push_back(lightInfo);
+		}
+		else
+		{
+			// NB treating spotlight as point for simplicity
+			// Just see if the lights attenuation range is within the frustum
+			lightInfo.range = l->getAttenuationRange();
+			lightInfo.position = l->getDerivedPosition();
+			Sphere sphere(lightInfo.position, lightInfo.range);
+			if (camera->isVisible(sphere))
+			{
+				mTestLightInfos.push_back(lightInfo);
+			}
+		}
+	}
+}
+//---------------------------------------------------------------------
 bool SceneManager::ShadowCasterSceneQueryListener::queryResult(
     MovableObject* object)
 {
@@ -6730,6 +6822,8 @@ SceneManager::getMovableObjectCollection(const String& typeName)
 	{
 		// create
 		MovableObjectCollection* newCollection = OGRE_NEW_T(MovableObjectCollection, MEMCATEGORY_SCENE_CONTROL)();
+		// 0 is left for anonymous scene nodes
+		newCollection->anonymousId = static_cast<uint32>(mMovableObjectCollectionMap.size() + 1);
 		mMovableObjectCollectionMap[typeName] = newCollection;
 		return newCollection;
 	}
@@ -6796,6 +6890,85 @@ MovableObject* SceneManager::createMovableObject(const String& typeName, const N
 	return createMovableObject(name, typeName, params);
 }
 //---------------------------------------------------------------------
+MovableObject* SceneManager::createAnonymousMovableObject(const String& typeName, 
+	const NameValuePairList* params)
+{
+	// Cameras are only known by name
+	if (typeName == "Camera")
+	{
+		return createMovableObject(typeName, params);
+	}
+	MovableObjectFactory* factory = 
+		Root::getSingleton().getMovableObjectFactory(typeName);
+	MovableObjectCollection* objectMap = getMovableObjectCollection(typeName);
+
+	{
+		OGRE_LOCK_MUTEX(objectMap->mutex)
+
+		SlotHandle handle = objectMap->anonymous.nextHandle();
+		MovableObject* newObj = factory->createInstance(
+			makeAnonymousName(objectMap->anonymousId, handle), this, params);
+		objectMap->anonymous.insert(newObj);
+		newObj->_notifyHandle(handle);
+		return newObj;
+	}
+}
+//---------------------------------------------------------------------
+void SceneManager::destroyMovableObject(const SlotHandle& handle, const String& typeName)
+{
+	MovableObjectCollection* objectMap = getMovableObjectCollection(typeName);
+
+	{
+		OGRE_LOCK_MUTEX(objectMap->mutex)
+
+		MovableObject* m = objectMap->anonymous.erase(handle);
+		if (m)
+		{
+			m->_getCreator()->destroyInstance(m);
+		}
+	}
+}
+//---------------------------------------------------------------------
+MovableObject* SceneManager::getMovableObject(const SlotHandle& handle, const String& typeName) const
+{
+	const MovableObjectCollection* objectMap = getMovableObjectCollection(typeName);
+
+	{
+		OGRE_LOCK_MUTEX(objectMap->mutex)
+		MovableObject* m = objectMap->anonymous.get(handle);
+		if (!m)
+		{
+			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+				"Anonymous object of type '" + typeName + "' does not exist.", 
+				"SceneManager::getMovableObject");
+		}
+		return m;
+	}
+}
+//---------------------------------------------------------------------
+bool SceneManager::hasMovableObject(const SlotHandle& handle, const String& typeName) const
+{
+	OGRE_LOCK_MUTEX(mMovableObjectCollectionMapMutex)
+
+	MovableObjectCollectionMap::const_iterator i = 
+		mMovableObjectCollectionMap.find(typeName);
+	if (i == mMovableObjectCollectionMap.end())
+		return false;
+
+	{
+		OGRE_LOCK_MUTEX(i->second->mutex)
+		return i->second->anonymous.contains(handle);
+	}
+}
+//---------------------------------------------------------------------
+SceneManager::AnonymousMovableObjectIterator 
+SceneManager::getAnonymousMovableObjectIterator(const String& typeName)
+{
+	MovableObjectCollection* objectMap = getMovableObjectCollection(typeName);
+	// Iterator not thread safe! Warned in header.
+	return AnonymousMovableObjectIterator(objectMap->anonymous.getItems());
+}
+//---------------------------------------------------------------------
 void SceneManager::destroyMovableObject(const String& name, const String& typeName)
 {
 	// Nasty hack to make generalised Camera functions work without breaking add-on SMs
@@ -6844,6 +7017,14 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
 			}
 		}
 		objectMap->map.clear();
+
+		const SlotMap<MovableObject>::ItemList& anonymous = objectMap->anonymous.getItems();
+		for (SlotMap<MovableObject>::ItemList::const_iterator ai = anonymous.begin();
+			ai != anonymous.end(); ++ai)
+		{
+			factory->destroyInstance(*ai);
+		}
+		objectMap->anonymous.clear();
 	}
 }
 //---------------------------------------------------------------------
@@ -6874,8 +7055,15 @@ void SceneManager::destroyAllMovableObjects(void)
 					factory->destroyInstance(i->second);
 				}
 			}
+			const SlotMap<MovableObject>::ItemList& anonymous = coll->anonymous.getItems();
+			for (SlotMap<MovableObject>::ItemList::const_iterator ai = anonymous.begin();
+				ai != anonymous.end(); ++ai)
+			{
+				factory->destroyInstance(*ai);
+			}
 		}
 		coll->map.clear();
+		coll->anonymous.clear();
 	}
 
 }
@@ -6935,7 +7123,10 @@ SceneManager::getMovableObjectIterator(const String& typeName)
 //---------------------------------------------------------------------
 void SceneManager::destroyMovableObject(MovableObject* m)
 {
-	destroyMovableObject(m->getName(), m->getMovableType());
+	if (m->getHandle().isNull())
+		destroyMovableObject(m->getName(), m->getMovableType());
+	else
+		destroyMovableObject(m->getHandle(), m->getMovableType());
 }
 //---------------------------------------------------------------------
 void SceneManager::injectMovableObject(MovableObject* m)
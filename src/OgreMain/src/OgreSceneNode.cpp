@@ -402,7 +402,7 @@ namespace Ogre {
         pChild->removeAndDestroyAllChildren();
 
         removeChild(name);
-        pChild->getCreator()->destroySceneNode(name);
+        pChild->getCreator()->destroySceneNode(pChild);
 
     }
     //-----------------------------------------------------------------------
@@ -412,7 +412,7 @@ namespace Ogre {
         pChild->removeAndDestroyAllChildren();
 
         removeChild(index);
-        pChild->getCreator()->destroySceneNode(pChild->getName());
+        pChild->getCreator()->destroySceneNode(pChild);
     }
     //-----------------------------------------------------------------------
     void SceneNode::removeAndDestroyAllChildren(void)
@@ -426,7 +426,7 @@ namespace Ogre {
 			// SceneManager::destroySceneNode because it causes removal from parent)
 			++i;
             sn->removeAndDestroyAllChildren();
-            sn->getCreator()->destroySceneNode(sn->getName());
+            sn->getCreator()->destroySceneNode(sn);
         }
 	    mChildren.clear();
         needUpdate();
@@ -29,9 +29,194 @@ THE SOFTWARE.
 #include "OgreSceneQuery.h"
 #include "OgreException.h"
 #include "OgreSceneManager.h"
+#include "OgreEntity.h"
+#include "OgreTriangleBVH.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
 
+	const size_t RaySceneQueryResultEntry::NO_TRIANGLE;
+
+	namespace
+	{
+		/// Rays handed to a thread at a time by RaySceneQuery::executeBatch
+		const size_t RAYS_PER_BATCH_TASK = 32;
+
+		/// Sorts and truncates the results of a ray as RaySceneQuery::execute does
+		void sortRayResults(RaySceneQueryResult& result, bool sortByDistance, ushort maxResults)
+		{
+			if (!sortByDistance)
+				return;
+
+			if (maxResults != 0 && maxResults < result.size())
+			{
+				// Partially sort the N smallest elements, discard others
+				std::partial_sort(result.begin(), result.begin()+maxResults, result.end());
+				result.resize(maxResults);
+			}
+			else
+			{
+				// Sort entire result array
+				std::sort(result.begin(), result.end());
+			}
+		}
+
+		/// Builds the missing triangle hierarchies of the entities in the results
+		void buildTriangleBVHs(RaySceneQueryResult* results, size_t numResults)
+		{
+			set<Mesh*>::type meshes;
+			for (size_t r = 0; r < numResults; ++r)
+			{
+				for (RaySceneQueryResult::iterator i = results[r].begin(); i != results[r].end(); ++i)
+				{
+					if (i->movable && i->movable->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+						meshes.insert(static_cast<Entity*>(i->movable)->getMesh().get());
+				}
+			}
+			for (set<Mesh*>::type::iterator i = meshes.begin(); i != meshes.end(); ++i)
+				(*i)->getTriangleBVH();
+		}
+
+		/** Replaces the bounds distance of entity results by the exact distance 
+			to their triangles, removing the entities missed */
+		void refineRayResults(const Ray& ray, RaySceneQueryResult& result)
+		{
+			RaySceneQueryResult::iterator last = result.begin();
+			for (RaySceneQueryResult::iterator i = result.begin(); i != result.end(); ++i)
+			{
+				if (i->movable && i->movable->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+				{
+					Entity* entity = static_cast<Entity*>(i->movable);
+					const TriangleBVH* bvh = entity->getMesh()->getTriangleBVH();
+					if (!bvh)
+						continue;
+
+					// Into mesh space, affine transforms keep distances along the ray
+					Matrix4 inverse = entity->_getParentNodeFullTransform().inverseAffine();
+					Matrix3 rotScale;
+					inverse.extract3x3Matrix(rotScale);
+					Ray localRay(inverse.transformAffine(ray.getOrigin()), rotScale * ray.getDirection());
+
+					TriangleBVH::Hit hit;
+					if (!bvh->intersects(localRay, hit))
+						continue;
+					i->distance = hit.distance;
+					i->triangleIndex = hit.triangleIndex;
+					i->subMeshIndex = hit.subMeshIndex;
+				}
+				*last++ = *i;
+			}
+			result.erase(last, result.end());
+		}
+
+		/// Traverses the scene for ranges of rays of RaySceneQuery::executeBatch
+		class RayTraverseTask : public WorkQueue::ParallelTask
+		{
+		public:
+			RayTraverseTask(SceneManager* sceneMgr, const RaySceneQuery* source, 
+				const Ray* rays, RaySceneQueryResult* results, 
+				list<SceneQuery::WorldFragment>::type* fragments)
+				: mSceneMgr(sceneMgr), mSource(source), mRays(rays), mResults(results)
+				, mFragments(fragments)
+			{
+			}
+
+			~RayTraverseTask()
+			{
+				for (size_t i = 0; i < mQueries.size(); ++i)
+					mSceneMgr->destroyQuery(mQueries[i]);
+			}
+
+			void execute(size_t begin, size_t end)
+			{
+				RaySceneQuery* query = acquireQuery();
+				// World fragments belong to the query, which frees them on its next
+				// execute; copy them so the results can keep pointing at them
+				list<SceneQuery::WorldFragment>::type fragments;
+				for (size_t i = begin; i < end; ++i)
+				{
+					query->setRay(mRays[i]);
+					mResults[i].swap(query->execute());
+					for (RaySceneQueryResult::iterator r = mResults[i].begin(); r != mResults[i].end(); ++r)
+					{
+						if (r->worldFragment)
+						{
+							fragments.push_back(*r->worldFragment);
+							r->worldFragment = &fragments.back();
+						}
+					}
+				}
+				releaseQuery(query);
+
+				if (!fragments.empty())
+				{
+					// splicing keeps the elements where they are
+					OGRE_LOCK_MUTEX(mQueriesMutex)
+					mFragments->splice(mFragments->end(), fragments);
+				}
+			}
+
+		private:
+			SceneManager* mSceneMgr;
+			const RaySceneQuery* mSource;
+			const Ray* mRays;
+			RaySceneQueryResult* mResults;
+			list<SceneQuery::WorldFragment>::type* mFragments;
+			/// Every query created, and those no thread is using
+			vector<RaySceneQuery*>::type mQueries;
+			vector<RaySceneQuery*>::type mFreeQueries;
+			OGRE_MUTEX(mQueriesMutex)
+
+			/** The queries hold the ray being traced, so each thread needs its own.
+				There are never more than threads running the task. */
+			RaySceneQuery* acquireQuery()
+			{
+				OGRE_LOCK_MUTEX(mQueriesMutex)
+				if (!mFreeQueries.empty())
+				{
+					RaySceneQuery* query = mFreeQueries.back();
+					mFreeQueries.pop_back();
+					return query;
+				}
+
+				RaySceneQuery* query = mSceneMgr->createRayQuery(
+					Ray(), mSource->getQueryMask());
+				mQueries.push_back(query);
+				query->setQueryTypeMask(mSource->getQueryTypeMask());
+				query->setWorldFragmentType(mSource->getWorldFragmentType());
+				// Triangle results are refined and sorted afterwards
+				if (!mSource->getQueryTriangles())
+					query->setSortByDistance(mSource->getSortByDistance(), mSource->getMaxResults());
+				return query;
+			}
+
+			void releaseQuery(RaySceneQuery* query)
+			{
+				OGRE_LOCK_MUTEX(mQueriesMutex)
+				mFreeQueries.push_back(query);
+			}
+		};
+
+		/// Refines the results of ranges of rays to triangles, then sorts them
+		class RayRefineTask : public WorkQueue::ParallelTask
+		{
+		public:
+			const Ray* rays;
+			RaySceneQueryResult* results;
+			bool sortByDistance;
+			ushort maxResults;
+
+			void execute(size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					refineRayResults(rays[i], results[i]);
+					sortRayResults(results[i], sortByDistance, maxResults);
+				}
+			}
+		};
+	}
+
     //-----------------------------------------------------------------------
     SceneQuery::SceneQuery(SceneManager* mgr)
         : mParentSceneMgr(mgr), mQueryMask(0xFFFFFFFF), 
@@ -199,6 +384,7 @@ namespace Ogre {
     {
         mSortByDistance = false;
         mMaxResults = 0;
+        mQueryTriangles = false;
     }
     //-----------------------------------------------------------------------
     RaySceneQuery::~RaySceneQuery()
@@ -231,6 +417,16 @@ namespace Ogre {
         return mMaxResults;
     }
     //-----------------------------------------------------------------------
+    void RaySceneQuery::setQueryTriangles(bool triangles)
+    {
+        mQueryTriangles = triangles;
+    }
+    //-----------------------------------------------------------------------
+    bool RaySceneQuery::getQueryTriangles(void) const
+    {
+        return mQueryTriangles;
+    }
+    //-----------------------------------------------------------------------
     RaySceneQueryResult& RaySceneQuery::execute(void)
     {
         // Clear without freeing the vector buffer
@@ -239,24 +435,45 @@ namespace Ogre {
         // Call callback version with self as listener
         this->execute(this);
 
-        if (mSortByDistance)
+        if (mQueryTriangles)
         {
-            if (mMaxResults != 0 && mMaxResults < mResult.size())
-            {
-                // Partially sort the N smallest elements, discard others
-                std::partial_sort(mResult.begin(), mResult.begin()+mMaxResults, mResult.end());
-                mResult.resize(mMaxResults);
-            }
-            else
-            {
-                // Sort entire result array
-                std::sort(mResult.begin(), mResult.end());
-            }
+            buildTriangleBVHs(&mResult, 1);
+            refineRayResults(mRay, mResult);
         }
+        sortRayResults(mResult, mSortByDistance, mMaxResults);
 
         return mResult;
     }
     //-----------------------------------------------------------------------
+    void RaySceneQuery::executeBatch(const RayList& rays, RaySceneQueryResultList& results)
+    {
+        const size_t numRays = rays.size();
+        results.resize(numRays);
+        mBatchWorldFragments.clear();
+        if (!numRays)
+            return;
+
+        {
+            // The task destroys its queries once the whole batch is traversed
+            RayTraverseTask traverse(mParentSceneMgr, this, &rays[0], &results[0], 
+                &mBatchWorldFragments);
+            WorkQueue::defaultParallelFor(traverse, numRays, RAYS_PER_BATCH_TASK);
+        }
+
+        if (mQueryTriangles)
+        {
+            // Reading meshes back from hardware buffers must happen in this thread
+            buildTriangleBVHs(&results[0], numRays);
+
+            RayRefineTask refine;
+            refine.rays = &rays[0];
+            refine.results = &results[0];
+            refine.sortByDistance = mSortByDistance;
+            refine.maxResults = mMaxResults;
+            WorkQueue::defaultParallelFor(refine, numRays, RAYS_PER_BATCH_TASK);
+        }
+    }
+    //-----------------------------------------------------------------------
     RaySceneQueryResult& RaySceneQuery::getLastResults(void)
     {
         return mResult;
@@ -275,6 +492,8 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = obj;
         dets.worldFragment = NULL;
+        dets.triangleIndex = RaySceneQueryResultEntry::NO_TRIANGLE;
+        dets.subMeshIndex = 0;
         mResult.push_back(dets);
         // Continue
         return true;
@@ -287,6 +506,8 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = NULL;
         dets.worldFragment = fragment;
+        dets.triangleIndex = RaySceneQueryResultEntry::NO_TRIANGLE;
+        dets.subMeshIndex = 0;
         mResult.push_back(dets);
         // Continue
         return true;
@@ -283,7 +283,9 @@ namespace Ogre
 	{
 		ScriptLexer lexer;
 		ScriptParser parser;
-		ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(str, source));
+		ScriptTokenRefList tokens;
+		lexer.tokenize(str, tokens);
+		ConcreteNodeListPtr nodes = parser.parse(str, tokens, source);
 		return compile(nodes, group);
 	}
 
@@ -392,7 +394,9 @@ namespace Ogre
 
 		ScriptLexer lexer;
 		ScriptParser parser;
-		ConcreteNodeListPtr cst = parser.parse(lexer.tokenize(str, source));
+		ScriptTokenRefList tokens;
+		lexer.tokenize(str, tokens);
+		ConcreteNodeListPtr cst = parser.parse(str, tokens, source);
 
 		// Call the listener to intercept CST
 		if(mListener)
@@ -594,9 +598,11 @@ namespace Ogre
 			if(!stream.isNull())
 			{
 				ScriptLexer lexer;
-				ScriptTokenListPtr tokens = lexer.tokenize(stream->getAsString(), name);
+				String str = stream->getAsString();
+				ScriptTokenRefList tokens;
+				lexer.tokenize(str, tokens);
 				ScriptParser parser;
-				nodes = parser.parse(tokens);
+				nodes = parser.parse(str, tokens, name);
 			}
 		}
 
@@ -952,9 +958,10 @@ namespace Ogre
 				{
 					// Found the variable, so process it and insert it into the tree
 					ScriptLexer lexer;
-					ScriptTokenListPtr tokens = lexer.tokenize(varAccess.second, var->file);
+					ScriptTokenRefList tokens;
+					lexer.tokenize(varAccess.second, tokens);
 					ScriptParser parser;
-					ConcreteNodeListPtr cst = parser.parseChunk(tokens);
+					ConcreteNodeListPtr cst = parser.parseChunk(varAccess.second, tokens, var->file);
 					AbstractNodeListPtr ast = convertToAST(cst);
 
 					// Set up ownership for these nodes
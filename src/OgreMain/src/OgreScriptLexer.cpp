@@ -36,6 +36,26 @@ namespace Ogre{
 	}
 
 	ScriptTokenListPtr ScriptLexer::tokenize(const String &str, const String &source)
+	{
+		ScriptTokenRefList refs;
+		tokenize(str, refs);
+
+		ScriptTokenListPtr tokens(OGRE_NEW_T(ScriptTokenList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		tokens->reserve(refs.size());
+		for(ScriptTokenRefList::const_iterator i = refs.begin(); i != refs.end(); ++i)
+		{
+			ScriptTokenPtr token(OGRE_NEW_T(ScriptToken, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+			token->lexeme = getLexeme(str, *i);
+			token->line = i->line;
+			token->file = source;
+			token->type = i->type;
+			tokens->push_back(token);
+		}
+
+		return tokens;
+	}
+
+	void ScriptLexer::tokenize(const String &str, ScriptTokenRefList &tokens)
 	{
 		// State enums
 		enum{ READY = 0, COMMENT, MULTICOMMENT, WORD, QUOTE, VAR, POSSIBLECOMMENT };
@@ -49,16 +69,17 @@ namespace Ogre{
 		char c = 0, lastc = 0;
 #endif
 
-		String lexeme;
+		// The lexemes are runs of the input, so only their start needs tracking
+		size_t start = 0;
 		uint32 line = 1, state = READY, lastQuote = 0;
-		ScriptTokenListPtr tokens(OGRE_NEW_T(ScriptTokenList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		tokens.clear();
+		tokens.reserve(str.size() / 8);
 
 		// Iterate over the input
-		String::const_iterator i = str.begin(), end = str.end();
-		while(i != end)
+		for(size_t i = 0, size = str.size(); i != size; ++i)
 		{
 			lastc = c;
-			c = *i;
+			c = str[i];
 
 			if(c == quote)
 				lastQuote = line;
@@ -68,35 +89,32 @@ namespace Ogre{
 			case READY:
 				if(c == slash && lastc == slash)
 				{
-					// Comment start, clear out the lexeme
-					lexeme = "";
+					// Comment start
 					state = COMMENT;
 				}
 				else if(c == star && lastc == slash)
 				{
-					lexeme = "";
 					state = MULTICOMMENT;
 				}
 				else if(c == quote)
 				{
-					// Clear out the lexeme ready to be filled with quotes!
-					lexeme = c;
+					// The lexeme includes the quotes
+					start = i;
 					state = QUOTE;
 				}
 				else if(c == varopener)
 				{
 					// Set up to read in a variable
-					lexeme = c;
+					start = i;
 					state = VAR;
 				}
 				else if(isNewline(c))
 				{
-					lexeme = c;
-					setToken(lexeme, line, source, tokens.get());
+					setToken(str, i, 1, line, tokens);
 				}
 				else if(!isWhitespace(c))
 				{
-					lexeme = c;
+					start = i;
 					if(c == slash)
 						state = POSSIBLECOMMENT;
 					else
@@ -115,13 +133,11 @@ namespace Ogre{
 			case POSSIBLECOMMENT:
 				if(c == slash && lastc == slash)
 				{
-					lexeme = "";
 					state = COMMENT;
 					break;	
 				}
 				else if(c == star && lastc == slash)
 				{
-					lexeme = "";
 					state = MULTICOMMENT;
 					break;
 				}
@@ -130,93 +146,45 @@ namespace Ogre{
 					state = WORD;
 				}
 			case WORD:
+			case VAR:
 				if(isNewline(c))
 				{
-					setToken(lexeme, line, source, tokens.get());
-					lexeme = c;
-					setToken(lexeme, line, source, tokens.get());
+					setToken(str, start, i - start, line, tokens);
+					setToken(str, i, 1, line, tokens);
 					state = READY;
 				}
 				else if(isWhitespace(c))
 				{
-					setToken(lexeme, line, source, tokens.get());
+					setToken(str, start, i - start, line, tokens);
 					state = READY;
 				}
 				else if(c == openbrace || c == closebrace || c == colon)
 				{
-					setToken(lexeme, line, source, tokens.get());
-					lexeme = c;
-					setToken(lexeme, line, source, tokens.get());
+					setToken(str, start, i - start, line, tokens);
+					setToken(str, i, 1, line, tokens);
 					state = READY;
 				}
-				else
-				{
-					lexeme += c;
-				}
 				break;
 			case QUOTE:
-				if(c != backslash)
-				{
-					// Allow embedded quotes with escaping
-					if(c == quote && lastc == backslash)
-					{
-						lexeme += c;
-					}
-					else if(c == quote)
-					{
-						lexeme += c;
-						setToken(lexeme, line, source, tokens.get());
-						state = READY;
-					}
-					else
-					{
-						// Backtrack here and allow a backslash normally within the quote
-						if(lastc == backslash)
-							lexeme = lexeme + "\\" + c;
-						else
-							lexeme += c;
-					}
-				}
-				break;
-			case VAR:
-				if(isNewline(c))
-				{
-					setToken(lexeme, line, source, tokens.get());
-					lexeme = c;
-					setToken(lexeme, line, source, tokens.get());
-					state = READY;
-				}
-				else if(isWhitespace(c))
-				{
-					setToken(lexeme, line, source, tokens.get());
-					state = READY;
-				}
-				else if(c == openbrace || c == closebrace || c == colon)
+				// Allow embedded quotes with escaping
+				if(c == quote && lastc != backslash)
 				{
-					setToken(lexeme, line, source, tokens.get());
-					lexeme = c;
-					setToken(lexeme, line, source, tokens.get());
+					setToken(str, start, i + 1 - start, line, tokens);
 					state = READY;
 				}
-				else
-				{
-					lexeme += c;
-				}
 				break;
 			}
 
 			// Separate check for newlines just to track line numbers
 			if(c == cr || (c == lf && lastc != cr))
 				line++;
-			
-			i++;
 		}
 
 		// Check for valid exit states
 		if(state == WORD || state == VAR)
 		{
-			if(!lexeme.empty())
-				setToken(lexeme, line, source, tokens.get());
+			if(start != str.size())
+				setToken(str, start, str.size() - start, line, tokens);
 		}
 		else
 		{
@@ -228,11 +196,38 @@ namespace Ogre{
 					"ScriptLexer::tokenize");
 			}
 		}
+	}
 
-		return tokens;
+	String ScriptLexer::getLexeme(const String &str, const ScriptTokenRef &token)
+	{
+#if OGRE_WCHAR_T_STRINGS
+		const wchar_t quote = L'\"', backslash = L'\\';
+#else
+		const char quote = '\"', backslash = '\\';
+#endif
+
+		String::const_iterator begin = str.begin() + token.offset, end = begin + token.length;
+		if(token.type != TID_QUOTE || std::find(begin, end, backslash) == end)
+			return String(begin, end);
+
+		// Drop the backslash from escaped quotes, other backslashes are kept
+		String lexeme;
+		lexeme.reserve(token.length);
+		String::value_type c = 0, lastc = 0;
+		for(String::const_iterator i = begin; i != end; ++i)
+		{
+			lastc = c;
+			c = *i;
+			if(c == backslash)
+				continue;
+			if(lastc == backslash && c != quote)
+				lexeme += backslash;
+			lexeme += c;
+		}
+		return lexeme;
 	}
 
-	void ScriptLexer::setToken(const Ogre::String &lexeme, Ogre::uint32 line, const String &source, Ogre::ScriptTokenList *tokens)
+	void ScriptLexer::setToken(const String &str, size_t offset, size_t length, uint32 line, ScriptTokenRefList &tokens)
 	{
 #if OGRE_WCHAR_T_STRINGS
 		const wchar_t openBracket = L'{', closeBracket = L'}', colon = L':', 
@@ -242,42 +237,41 @@ namespace Ogre{
 			quote = '\"', var = '$';
 #endif
 
-		ScriptTokenPtr token(OGRE_NEW_T(ScriptToken, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
-		token->lexeme = lexeme;
-		token->line = line;
-		token->file = source;
-		bool ignore = false;
+		ScriptTokenRef token;
+		token.offset = static_cast<uint32>(offset);
+		token.length = static_cast<uint32>(length);
+		token.line = line;
+		String::value_type first = str[offset];
 
 		// Check the user token map first
-		if(lexeme.size() == 1 && isNewline(lexeme[0]))
+		if(length == 1 && isNewline(first))
 		{
-			token->type = TID_NEWLINE;
-			if(!tokens->empty() && tokens->back()->type == TID_NEWLINE)
-				ignore = true;
+			token.type = TID_NEWLINE;
+			if(!tokens.empty() && tokens.back().type == TID_NEWLINE)
+				return;
 		}
-		else if(lexeme.size() == 1 && lexeme[0] == openBracket)
-			token->type = TID_LBRACKET;
-		else if(lexeme.size() == 1 && lexeme[0] == closeBracket)
-			token->type = TID_RBRACKET;
-		else if(lexeme.size() == 1 && lexeme[0] == colon)
-			token->type = TID_COLON;
-		else if(lexeme[0] == var)
-			token->type = TID_VARIABLE;
+		else if(length == 1 && first == openBracket)
+			token.type = TID_LBRACKET;
+		else if(length == 1 && first == closeBracket)
+			token.type = TID_RBRACKET;
+		else if(length == 1 && first == colon)
+			token.type = TID_COLON;
+		else if(first == var)
+			token.type = TID_VARIABLE;
 		else
 		{
 			// This is either a non-zero length phrase or quoted phrase
-			if(lexeme.size() >= 2 && lexeme[0] == quote && lexeme[lexeme.size() - 1] == quote)
+			if(length >= 2 && first == quote && str[offset + length - 1] == quote)
 			{
-				token->type = TID_QUOTE;
+				token.type = TID_QUOTE;
 			}
 			else
 			{
-				token->type = TID_WORD;
+				token.type = TID_WORD;
 			}
 		}
 
-		if(!ignore)
-			tokens->push_back(token);
+		tokens.push_back(token);
 	}
 
 	bool ScriptLexer::isWhitespace(Ogre::String::value_type c) const
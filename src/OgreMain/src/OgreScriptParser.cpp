@@ -33,483 +33,389 @@ THE SOFTWARE.
 
 namespace Ogre
 {
-
-	ScriptParser::ScriptParser()
+	namespace
 	{
-	}
+		/// Gives the parser access to a ScriptTokenList
+		struct SharedTokenAccess
+		{
+			typedef ScriptTokenList::const_iterator iterator;
+
+			uint32 type(iterator i) const { return (*i)->type; }
+			uint32 line(iterator i) const { return (*i)->line; }
+			const String &file(iterator i) const { return (*i)->file; }
+			const String &lexeme(iterator i) const { return (*i)->lexeme; }
+			bool isLexeme(iterator i, const char *str) const { return (*i)->lexeme == str; }
+			String unquoted(iterator i) const { return (*i)->lexeme.substr(1, (*i)->lexeme.size() - 2); }
+		};
+
+		/// Gives the parser access to a ScriptTokenRefList, without copying lexemes until needed
+		struct TokenRefAccess
+		{
+			typedef ScriptTokenRefList::const_iterator iterator;
 
-	ConcreteNodeListPtr ScriptParser::parse(const ScriptTokenListPtr &tokens)
-	{
-		// MEMCATEGORY_GENERAL because SharedPtr can only free using that category
-		ConcreteNodeListPtr nodes(OGRE_NEW_T(ConcreteNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+			const String &mStr;
+			const String &mFile;
+
+			TokenRefAccess(const String &str, const String &file) : mStr(str), mFile(file) {}
+
+			uint32 type(iterator i) const { return i->type; }
+			uint32 line(iterator i) const { return i->line; }
+			const String &file(iterator) const { return mFile; }
+			String lexeme(iterator i) const { return ScriptLexer::getLexeme(mStr, *i); }
+			bool isLexeme(iterator i, const char *str) const { return mStr.compare(i->offset, i->length, str) == 0; }
+			String unquoted(iterator i) const
+			{
+				String::const_iterator begin = mStr.begin() + i->offset, end = begin + i->length;
+				if(std::find(begin, end, '\\') == end)
+					return String(begin + 1, end - 1);
+				String lexeme = ScriptLexer::getLexeme(mStr, *i);
+				return lexeme.substr(1, lexeme.size() - 2);
+			}
+		};
 
-		enum{READY, OBJECT};
-		uint32 state = READY;
+		template <typename Tokens>
+		typename Tokens::iterator skipNewlines(const Tokens &tokens, typename Tokens::iterator i, 
+			typename Tokens::iterator end)
+		{
+			while(i != end && tokens.type(i) == TID_NEWLINE)
+				++i;
+			return i;
+		}
+
+		/// Create a node for a word or quote token
+		template <typename Tokens>
+		ConcreteNodePtr createValueNode(const Tokens &tokens, typename Tokens::iterator i, ConcreteNode *parent)
+		{
+			ConcreteNodePtr node(OGRE_NEW ConcreteNode());
+			node->parent = parent;
+			node->file = tokens.file(i);
+			node->line = tokens.line(i);
+			node->type = tokens.type(i) == TID_WORD ? CNT_WORD : CNT_QUOTE;
+			if(node->type == CNT_QUOTE)
+				node->token = tokens.unquoted(i);
+			else
+				node->token = tokens.lexeme(i);
+			return node;
+		}
 
-		ConcreteNode *parent = 0;
-		ConcreteNodePtr node;
-		ScriptToken *token = 0;
-		ScriptTokenList::iterator i = tokens->begin(), end = tokens->end();
-		while(i != end)
+		/// Create a node for any token, keeping its lexeme as-is
+		template <typename Tokens>
+		ConcreteNodePtr createNode(const Tokens &tokens, typename Tokens::iterator i, ConcreteNodeType type)
 		{
-			token = (*i).get();
+			ConcreteNodePtr node(OGRE_NEW ConcreteNode());
+			node->token = tokens.lexeme(i);
+			node->file = tokens.file(i);
+			node->line = tokens.line(i);
+			node->type = type;
+			return node;
+		}
 
-			switch(state)
+		void insertNode(const ConcreteNodePtr &node, ConcreteNode *parent, ConcreteNodeList *nodes)
+		{
+			if(parent)
 			{
-			case READY:
-				if(token->type == TID_WORD)
-				{
-					if(token->lexeme == "import")
-					{
-						node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-						node->token = token->lexeme;
-						node->file = token->file;
-						node->line = token->line;
-						node->type = CNT_IMPORT;
-
-						// The next token is the target
-						++i;
-						if(i == end || ((*i)->type != TID_WORD && (*i)->type != TID_QUOTE))
-							OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-								Ogre::String("expected import target at line ") + 
-									Ogre::StringConverter::toString(node->line),
-								"ScriptParser::parse");
-						ConcreteNodePtr temp(OGRE_NEW ConcreteNode());
-						temp->parent = node.get();
-						temp->file = (*i)->file;
-						temp->line = (*i)->line;
-						temp->type = (*i)->type == TID_WORD ? CNT_WORD : CNT_QUOTE;
-						if(temp->type == CNT_QUOTE)
-							temp->token = (*i)->lexeme.substr(1, token->lexeme.size() - 2);
-						else
-							temp->token = (*i)->lexeme;
-						node->children.push_back(temp);
+				node->parent = parent;
+				parent->children.push_back(node);
+			}
+			else
+			{
+				node->parent = 0;
+				nodes->push_back(node);
+			}
+		}
 
-						// The second-next token is the source
-						++i;
-						++i;
-						if(i == end || ((*i)->type != TID_WORD && (*i)->type != TID_QUOTE))
-							OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-								Ogre::String("expected import source at line ") + 
-									Ogre::StringConverter::toString(node->line),
-								"ScriptParser::parse");
-						temp = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-						temp->parent = node.get();
-						temp->file = (*i)->file;
-						temp->line = (*i)->line;
-						temp->type = (*i)->type == TID_WORD ? CNT_WORD : CNT_QUOTE;
-						if(temp->type == CNT_QUOTE)
-							temp->token = (*i)->lexeme.substr(1, (*i)->lexeme.size() - 2);
-						else
-							temp->token = (*i)->lexeme;
-						node->children.push_back(temp);
+		template <typename Tokens>
+		ConcreteNodeListPtr parseTokens(const Tokens &tokens, typename Tokens::iterator i, 
+			typename Tokens::iterator end)
+		{
+			typedef typename Tokens::iterator iterator;
 
-						// Consume all the newlines
-						i = skipNewlines(i, end);
+			// MEMCATEGORY_GENERAL because SharedPtr can only free using that category
+			ConcreteNodeListPtr nodes(OGRE_NEW_T(ConcreteNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
 
-						// Insert the node
-						if(parent)
+			enum{READY, OBJECT};
+			uint32 state = READY;
+
+			ConcreteNode *parent = 0;
+			ConcreteNodePtr node;
+			while(i != end)
+			{
+				uint32 type = tokens.type(i);
+
+				switch(state)
+				{
+				case READY:
+					if(type == TID_WORD)
+					{
+						if(tokens.isLexeme(i, "import"))
 						{
-							node->parent = parent;
-							parent->children.push_back(node);
+							node = createNode(tokens, i, CNT_IMPORT);
+
+							// The next token is the target
+							++i;
+							if(i == end || (tokens.type(i) != TID_WORD && tokens.type(i) != TID_QUOTE))
+								OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+									Ogre::String("expected import target at line ") + 
+										Ogre::StringConverter::toString(node->line),
+									"ScriptParser::parse");
+							node->children.push_back(createValueNode(tokens, i, node.get()));
+
+							// The second-next token is the source
+							++i;
+							++i;
+							if(i == end || (tokens.type(i) != TID_WORD && tokens.type(i) != TID_QUOTE))
+								OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+									Ogre::String("expected import source at line ") + 
+										Ogre::StringConverter::toString(node->line),
+									"ScriptParser::parse");
+							node->children.push_back(createValueNode(tokens, i, node.get()));
+
+							// Consume all the newlines
+							i = skipNewlines(tokens, i, end);
+
+							// Insert the node
+							insertNode(node, parent, nodes.get());
+							node = ConcreteNodePtr();
+						}
+						else if(tokens.isLexeme(i, "set"))
+						{
+							node = createNode(tokens, i, CNT_VARIABLE_ASSIGN);
+
+							// The next token is the variable
+							++i;
+							if(i == end || tokens.type(i) != TID_VARIABLE)
+								OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+									Ogre::String("expected variable name at line ") + 
+										Ogre::StringConverter::toString(node->line),
+									"ScriptParser::parse");
+							ConcreteNodePtr temp = createNode(tokens, i, CNT_VARIABLE);
+							temp->parent = node.get();
+							node->children.push_back(temp);
+
+							// The next token is the assignment
+							++i;
+							if(i == end || (tokens.type(i) != TID_WORD && tokens.type(i) != TID_QUOTE))
+								OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+									Ogre::String("expected variable value at line ") + 
+										Ogre::StringConverter::toString(node->line),
+									"ScriptParser::parse");
+							node->children.push_back(createValueNode(tokens, i, node.get()));
+
+							// Consume all the newlines
+							i = skipNewlines(tokens, i, end);
+
+							// Insert the node
+							insertNode(node, parent, nodes.get());
+							node = ConcreteNodePtr();
 						}
 						else
 						{
-							node->parent = 0;
-							nodes->push_back(node);
+							node = createValueNode(tokens, i, 0);
+
+							// Insert the node
+							insertNode(node, parent, nodes.get());
+
+							// Set the parent
+							parent = node.get();
+
+							// Switch states
+							state = OBJECT;
+
+							node = ConcreteNodePtr();
 						}
-						node = ConcreteNodePtr();
 					}
-					else if(token->lexeme == "set")
+					else if(type == TID_RBRACKET)
 					{
-						node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-						node->token = token->lexeme;
-						node->file = token->file;
-						node->line = token->line;
-						node->type = CNT_VARIABLE_ASSIGN;
-
-						// The next token is the variable
-						++i;
-						if(i == end || (*i)->type != TID_VARIABLE)
-							OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-								Ogre::String("expected variable name at line ") + 
-									Ogre::StringConverter::toString(node->line),
-								"ScriptParser::parse");
-						ConcreteNodePtr temp(OGRE_NEW ConcreteNode());
-						temp->parent = node.get();
-						temp->file = (*i)->file;
-						temp->line = (*i)->line;
-						temp->type = CNT_VARIABLE;
-						temp->token = (*i)->lexeme;
-						node->children.push_back(temp);
-
-						// The next token is the assignment
-						++i;
-						if(i == end || ((*i)->type != TID_WORD && (*i)->type != TID_QUOTE))
-							OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-								Ogre::String("expected variable value at line ") + 
-									Ogre::StringConverter::toString(node->line),
-								"ScriptParser::parse");
-						temp = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-						temp->parent = node.get();
-						temp->file = (*i)->file;
-						temp->line = (*i)->line;
-						temp->type = (*i)->type == TID_WORD ? CNT_WORD : CNT_QUOTE;
-						if(temp->type == CNT_QUOTE)
-							temp->token = (*i)->lexeme.substr(1, (*i)->lexeme.size() - 2);
-						else
-							temp->token = (*i)->lexeme;
-						node->children.push_back(temp);
+						// Go up one level if we can
+						if(parent)
+							parent = parent->parent;
+
+						node = createNode(tokens, i, CNT_RBRACE);
 
 						// Consume all the newlines
-						i = skipNewlines(i, end);
+						i = skipNewlines(tokens, i, end);
 
 						// Insert the node
+						insertNode(node, parent, nodes.get());
+
+						// Move up another level
 						if(parent)
+							parent = parent->parent;
+
+						node = ConcreteNodePtr();
+					}
+					break;
+				case OBJECT:
+					if(type == TID_NEWLINE)
+					{
+						// Look ahead to the next non-newline token and if it isn't an {, this was a property
+						iterator next = skipNewlines(tokens, i, end);
+						if(next == end || tokens.type(next) != TID_LBRACKET)
 						{
-							node->parent = parent;
-							parent->children.push_back(node);
+							// Ended a property here
+							if(parent)
+								parent = parent->parent;
+							state = READY;
 						}
-						else
+					}
+					else if(type == TID_COLON)
+					{
+						node = createNode(tokens, i, CNT_COLON);
+
+						// The following token are the parent objects (base classes).
+						// Require at least one of them.
+
+						iterator j = i + 1;
+						j = skipNewlines(tokens, j, end);
+						if(j == end || (tokens.type(j) != TID_WORD && tokens.type(j) != TID_QUOTE)) {
+							OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+								Ogre::String("expected object identifier at line ") + 
+									Ogre::StringConverter::toString(node->line),
+								"ScriptParser::parse");
+						}
+
+						while(j != end && (tokens.type(j) == TID_WORD || tokens.type(j) == TID_QUOTE))
 						{
-							node->parent = 0;
-							nodes->push_back(node);
+							ConcreteNodePtr tempNode = createNode(tokens, j, 
+								tokens.type(j) == TID_WORD ? CNT_WORD : CNT_QUOTE);
+							tempNode->parent = node.get();
+							node->children.push_back(tempNode);
+							++j;
 						}
+
+						// Move it backwards once, since the end of the loop moves it forwards again anyway
+						j--;
+						i = j;
+
+						// Insert the node
+						insertNode(node, parent, nodes.get());
 						node = ConcreteNodePtr();
 					}
-					else
+					else if(type == TID_LBRACKET)
 					{
-						node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-						node->file = token->file;
-						node->line = token->line;
-						node->type = token->type == TID_WORD ? CNT_WORD : CNT_QUOTE;
-						if(node->type == CNT_QUOTE)
-							node->token = token->lexeme.substr(1, token->lexeme.size() - 2);
-						else
-							node->token = token->lexeme;
+						node = createNode(tokens, i, CNT_LBRACE);
+
+						// Consume all the newlines
+						i = skipNewlines(tokens, i, end);
 
 						// Insert the node
-						if(parent)
-						{
-							node->parent = parent;
-							parent->children.push_back(node);
-						}
-						else
-						{
-							node->parent = 0;
-							nodes->push_back(node);
-						}
+						insertNode(node, parent, nodes.get());
 
 						// Set the parent
 						parent = node.get();
 
-						// Switch states
-						state = OBJECT;
+						// Change the state
+						state = READY;
 
 						node = ConcreteNodePtr();
 					}
-				}
-				else if(token->type == TID_RBRACKET)
-				{
-					// Go up one level if we can
-					if(parent)
-						parent = parent->parent;
+					else if(type == TID_RBRACKET)
+					{
+						// Go up one level if we can
+						if(parent)
+							parent = parent->parent;
 
-					node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-					node->token = token->lexeme;
-					node->file = token->file;
-					node->line = token->line;
-					node->type = CNT_RBRACE;
+						// If the parent is currently a { then go up again
+						if(parent && parent->type == CNT_LBRACE && parent->parent)
+							parent = parent->parent;
 
-					// Consume all the newlines
-					i = skipNewlines(i, end);
+						node = createNode(tokens, i, CNT_RBRACE);
 
-					// Insert the node
-					if(parent)
-					{
-						node->parent = parent;
-						parent->children.push_back(node);
-					}
-					else
-					{
-						node->parent = 0;
-						nodes->push_back(node);
-					}
+						// Consume all the newlines
+						i = skipNewlines(tokens, i, end);
 
-					// Move up another level
-					if(parent)
-						parent = parent->parent;
+						// Insert the node
+						insertNode(node, parent, nodes.get());
 
-					node = ConcreteNodePtr();
-				}
-				break;
-			case OBJECT:
-				if(token->type == TID_NEWLINE)
-				{
-					// Look ahead to the next non-newline token and if it isn't an {, this was a property
-					ScriptTokenList::iterator next = skipNewlines(i, end);
-					if(next == end || (*next)->type != TID_LBRACKET)
-					{
-						// Ended a property here
+						// Move up another level
 						if(parent)
 							parent = parent->parent;
+
+						node = ConcreteNodePtr();
 						state = READY;
 					}
-				}
-				else if(token->type == TID_COLON)
-				{
-					node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-					node->token = token->lexeme;
-					node->file = token->file;
-					node->line = token->line;
-					node->type = CNT_COLON;
-
-					// The following token are the parent objects (base classes).
-                    // Require at least one of them.
-
-					ScriptTokenList::iterator j = i + 1;
-					j = skipNewlines(j, end);
-					if(j == end || ((*j)->type != TID_WORD && (*j)->type != TID_QUOTE)) {
-						OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-							Ogre::String("expected object identifier at line ") + 
-                                    Ogre::StringConverter::toString(node->line),
-							"ScriptParser::parse");
-                    }
-
-					while(j != end && ((*j)->type == TID_WORD || (*j)->type == TID_QUOTE))
+					else if(type == TID_VARIABLE)
 					{
-						ConcreteNodePtr tempNode = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-						tempNode->token = (*j)->lexeme;
-						tempNode->file = (*j)->file;
-						tempNode->line = (*j)->line;
-						tempNode->type = (*j)->type == TID_WORD ? CNT_WORD : CNT_QUOTE;
-						tempNode->parent = node.get();
-						node->children.push_back(tempNode);
-						++j;
-					}
+						node = createNode(tokens, i, CNT_VARIABLE);
 
-					// Move it backwards once, since the end of the loop moves it forwards again anyway
-					j--;
-					i = j;
-
-					// Insert the node
-					if(parent)
-					{
-						node->parent = parent;
-						parent->children.push_back(node);
+						// Insert the node
+						insertNode(node, parent, nodes.get());
+						node = ConcreteNodePtr();
 					}
-					else
+					else if(type == TID_QUOTE || type == TID_WORD)
 					{
-						node->parent = 0;
-						nodes->push_back(node);
-					}
-					node = ConcreteNodePtr();
-				}
-				else if(token->type == TID_LBRACKET)
-				{
-					node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-					node->token = token->lexeme;
-					node->file = token->file;
-					node->line = token->line;
-					node->type = CNT_LBRACE;
-
-					// Consume all the newlines
-					i = skipNewlines(i, end);
+						node = createValueNode(tokens, i, 0);
 
-					// Insert the node
-					if(parent)
-					{
-						node->parent = parent;
-						parent->children.push_back(node);
-					}
-					else
-					{
-						node->parent = 0;
-						nodes->push_back(node);
+						// Insert the node
+						insertNode(node, parent, nodes.get());
+						node = ConcreteNodePtr();
 					}
-
-					// Set the parent
-					parent = node.get();
-
-					// Change the state
-					state = READY;
-
-					node = ConcreteNodePtr();
+					break;
 				}
-				else if(token->type == TID_RBRACKET)
-				{
-					// Go up one level if we can
-					if(parent)
-						parent = parent->parent;
-
-					// If the parent is currently a { then go up again
-					if(parent && parent->type == CNT_LBRACE && parent->parent)
-						parent = parent->parent;
-
-					node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-					node->token = token->lexeme;
-					node->file = token->file;
-					node->line = token->line;
-					node->type = CNT_RBRACE;
 
-					// Consume all the newlines
-					i = skipNewlines(i, end);
+				++i;
+			}
 
-					// Insert the node
-					if(parent)
-					{
-						node->parent = parent;
-						parent->children.push_back(node);
-					}
-					else
-					{
-						node->parent = 0;
-						nodes->push_back(node);
-					}
+			return nodes;
+		}
 
-					// Move up another level
-					if(parent)
-						parent = parent->parent;
+		template <typename Tokens>
+		ConcreteNodeListPtr parseChunkTokens(const Tokens &tokens, typename Tokens::iterator i, 
+			typename Tokens::iterator end)
+		{
+			// MEMCATEGORY_GENERAL because SharedPtr can only free using that category
+			ConcreteNodeListPtr nodes(OGRE_NEW_T(ConcreteNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
 
-					node = ConcreteNodePtr();
-					state = READY;
-				}
-				else if(token->type == TID_VARIABLE)
-				{
-					node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-					node->token = token->lexeme;
-					node->file = token->file;
-					node->line = token->line;
-					node->type = CNT_VARIABLE;
-
-					// Insert the node
-					if(parent)
-					{
-						node->parent = parent;
-						parent->children.push_back(node);
-					}
-					else
-					{
-						node->parent = 0;
-						nodes->push_back(node);
-					}
-					node = ConcreteNodePtr();
-				}
-				else if(token->type == TID_QUOTE)
+			ConcreteNodePtr node;
+			for(; i != end; ++i)
+			{
+				switch(tokens.type(i))
 				{
-					node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-					node->token = token->lexeme.substr(1, token->lexeme.size() - 2);
-					node->file = token->file;
-					node->line = token->line;
-					node->type = CNT_QUOTE;
-
-					// Insert the node
-					if(parent)
-					{
-						node->parent = parent;
-						parent->children.push_back(node);
-					}
-					else
-					{
-						node->parent = 0;
-						nodes->push_back(node);
-					}
-					node = ConcreteNodePtr();
+				case TID_VARIABLE:
+					node = createNode(tokens, i, CNT_VARIABLE);
+					node->parent = 0;
+					break;
+				case TID_WORD:
+				case TID_QUOTE:
+					node = createValueNode(tokens, i, 0);
+					break;
+				default:
+					OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+						Ogre::String("unexpected token") + tokens.lexeme(i) + " at line " + 
+							Ogre::StringConverter::toString(tokens.line(i)),
+						"ScriptParser::parseChunk");
 				}
-				else if(token->type == TID_WORD)
-				{
-					node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-					node->token = token->lexeme;
-					node->file = token->file;
-					node->line = token->line;
-					node->type = CNT_WORD;
-
-					// Insert the node
-					if(parent)
-					{
-						node->parent = parent;
-						parent->children.push_back(node);
-					}
-					else
-					{
-						node->parent = 0;
-						nodes->push_back(node);
-					}
-					node = ConcreteNodePtr();
-				}
-				break;
+
+				if(!node.isNull())
+					nodes->push_back(node);
 			}
 
-			++i;
+			return nodes;
 		}
-
-		return nodes;
 	}
 
-	ConcreteNodeListPtr ScriptParser::parseChunk(const ScriptTokenListPtr &tokens)
+	ScriptParser::ScriptParser()
 	{
-		// MEMCATEGORY_GENERAL because SharedPtr can only free using that category
-		ConcreteNodeListPtr nodes(OGRE_NEW_T(ConcreteNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
-
-		ConcreteNodePtr node;
-		ScriptToken *token = 0;
-		for(ScriptTokenList::const_iterator i = tokens->begin(); i != tokens->end(); ++i)
-		{
-			token = (*i).get();
-
-			switch(token->type)
-			{
-			case TID_VARIABLE:
-				node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-				node->file = token->file;
-				node->line = token->line;
-				node->parent = 0;
-				node->token = token->lexeme;
-				node->type = CNT_VARIABLE;
-				break;
-			case TID_WORD:
-				node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-				node->file = token->file;
-				node->line = token->line;
-				node->parent = 0;
-				node->token = token->lexeme;
-				node->type = CNT_WORD;
-				break;
-			case TID_QUOTE:
-				node = ConcreteNodePtr(OGRE_NEW ConcreteNode());
-				node->file = token->file;
-				node->line = token->line;
-				node->parent = 0;
-				node->token = token->lexeme.substr(1, token->lexeme.size() - 2);
-				node->type = CNT_QUOTE;
-			default:
-				OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-					Ogre::String("unexpected token") + token->lexeme + " at line " + 
-						Ogre::StringConverter::toString(token->line),
-					"ScriptParser::parseChunk");
-			}
+	}
 
-			if(!node.isNull())
-				nodes->push_back(node);
-		}
+	ConcreteNodeListPtr ScriptParser::parse(const ScriptTokenListPtr &tokens)
+	{
+		return parseTokens(SharedTokenAccess(), tokens->begin(), tokens->end());
+	}
 
-		return nodes;
+	ConcreteNodeListPtr ScriptParser::parse(const String &str, const ScriptTokenRefList &tokens, const String &source)
+	{
+		return parseTokens(TokenRefAccess(str, source), tokens.begin(), tokens.end());
 	}
 
-	ScriptToken *ScriptParser::getToken(ScriptTokenList::iterator i, ScriptTokenList::iterator end, int offset)
+	ConcreteNodeListPtr ScriptParser::parseChunk(const ScriptTokenListPtr &tokens)
 	{
-		ScriptToken *token = 0;
-		ScriptTokenList::iterator iter = i + offset;
-		if(iter != end)
-			token = (*i).get();
-		return token;
+		return parseChunkTokens(SharedTokenAccess(), tokens->begin(), tokens->end());
 	}
 
-	ScriptTokenList::iterator ScriptParser::skipNewlines(ScriptTokenList::iterator i, ScriptTokenList::iterator end)
+	ConcreteNodeListPtr ScriptParser::parseChunk(const String &str, const ScriptTokenRefList &tokens, const String &source)
 	{
-		while(i != end && (*i)->type == TID_NEWLINE)
-			++i;
-		return i;
+		return parseChunkTokens(TokenRefAccess(str, source), tokens.begin(), tokens.end());
 	}
 
 }
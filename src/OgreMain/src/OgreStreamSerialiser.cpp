@@ -43,12 +43,62 @@ THE SOFTWARE.
 #include "OgreRay.h"
 #include "OgreSphere.h"
 #include <stdint.h>
+#include <zlib.h>
 
 namespace Ogre
 {
+	namespace
+	{
+		/** Growable in-memory stream which the data of a compressed chunk is
+			written to, before it's compressed at the end of the chunk. 
+		*/
+		class ChunkBufferStream : public DataStream
+		{
+		protected:
+			vector<uchar>::type mBuffer;
+			size_t mPos;
+		public:
+			ChunkBufferStream() : DataStream(READ | WRITE), mPos(0) {}
+
+			const uchar* getPtr() const { return mBuffer.empty() ? 0 : &mBuffer[0]; }
+
+			size_t read(void* buf, size_t count)
+			{
+				size_t cnt = std::min(count, mBuffer.size() - mPos);
+				if (cnt)
+					memcpy(buf, &mBuffer[mPos], cnt);
+				mPos += cnt;
+				return cnt;
+			}
+			size_t write(const void* buf, size_t count)
+			{
+				if (mPos + count > mBuffer.size())
+				{
+					mBuffer.resize(mPos + count);
+					mSize = mBuffer.size();
+				}
+				if (count)
+					memcpy(&mBuffer[mPos], buf, count);
+				mPos += count;
+				return count;
+			}
+			void skip(long count) { seek(mPos + count); }
+			void seek(size_t pos) 
+			{ 
+				assert(pos <= mBuffer.size());
+				mPos = std::min(pos, mBuffer.size()); 
+			}
+			size_t tell() const { return mPos; }
+			bool eof() const { return mPos >= mBuffer.size(); }
+			void close() {}
+		};
+	}
 	//---------------------------------------------------------------------
 	uint32 StreamSerialiser::HEADER_ID = 0x00000001;
 	uint32 StreamSerialiser::REVERSE_HEADER_ID = 0x10000000;
+	uint32 StreamSerialiser::DIRECTORY_ID = 0x00000002;
+	uint32 StreamSerialiser::DIRECTORY_LOCATOR_ID = 0x00000003;
+	uint16 StreamSerialiser::COMPRESSED_VERSION_FLAG = 0x8000;
 	uint32 StreamSerialiser::CHUNK_HEADER_SIZE = 
 		sizeof(uint32) + // id
 		sizeof(uint16) + // version
@@ -62,6 +112,7 @@ namespace Ogre
 		, mFlipEndian(false)
 		, mReadWriteHeader(autoHeader)
 		, mRealFormat(realFormat)
+		, mChunkDirectoryRead(false)
 	{
 		if (mEndian != ENDIAN_AUTO)
 		{
@@ -129,6 +180,9 @@ namespace Ogre
 		Chunk* chunk = readChunkImpl();
 		mChunkStack.push_back(chunk);
 
+		if (chunk->compressed)
+			beginCompressedRead(chunk);
+
 		return chunk;
 
 	}
@@ -161,6 +215,9 @@ namespace Ogre
 	{
 		Chunk* c = popChunk(id);
 
+		if (c->compressed)
+			popStream();
+
 		checkStream();
 
 		mStream->seek(c->offset);
@@ -197,6 +254,10 @@ namespace Ogre
 	{
 		Chunk* c = popChunk(id);
 
+		// the outer stream is already past the compressed data
+		if (c->compressed)
+			popStream();
+
 		checkStream();
 
 		// skip to the end of the chunk if we were not there already
@@ -212,6 +273,8 @@ namespace Ogre
 	{
 		const Chunk* c = getCurrentChunk();
 		assert(c->id == id);
+		if (c->compressed)
+			return mStream->eof();
 		return mStream->tell() == (c->offset + CHUNK_HEADER_SIZE + c->length);
 	}
 	//---------------------------------------------------------------------
@@ -320,10 +383,16 @@ namespace Ogre
 		mReadWriteHeader = false;
 	}
 	//---------------------------------------------------------------------
-	void StreamSerialiser::writeChunkBegin(uint32 id, uint16 version /* = 1 */)
+	void StreamSerialiser::writeChunkBegin(uint32 id, uint16 version /* = 1 */, 
+		bool compress /* = false */)
 	{
 		checkStream(false, false, true);
 
+		if (version & COMPRESSED_VERSION_FLAG)
+			OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+				"Chunk versions must be less than 0x8000", 
+				"StreamSerialiser::writeChunkBegin");
+
 		if (mReadWriteHeader)
 			writeHeader();
 
@@ -332,7 +401,14 @@ namespace Ogre
 				"Endian mode has not been determined, did you disable header without setting?", 
 				"StreamSerialiser::writeChunkBegin");
 
-		writeChunkImpl(id, version);
+		writeChunkImpl(id, version, compress);
+
+		if (compress)
+		{
+			// data goes to a buffer until the chunk ends
+			mStreamStack.push_back(mStream);
+			mStream = DataStreamPtr(OGRE_NEW ChunkBufferStream());
+		}
 
 	}
 	//---------------------------------------------------------------------
@@ -342,6 +418,9 @@ namespace Ogre
 
 		Chunk* c = popChunk(id);
 
+		if (c->compressed)
+			endCompressedWrite(c);
+
 		// update the sizes
 		size_t currPos = mStream->tell();
 		c->length = static_cast<uint32>(currPos - c->offset - CHUNK_HEADER_SIZE);
@@ -357,8 +436,135 @@ namespace Ogre
 		// seek back to previous position
 		mStream->seek(currPos);
 
+		// remember top-level chunks for the directory
+		if (mChunkStack.empty() && c->id != HEADER_ID && 
+			c->id != DIRECTORY_ID && c->id != DIRECTORY_LOCATOR_ID)
+			mChunkDirectory.push_back(*c);
+
+		OGRE_DELETE c;
+
+	}
+	//---------------------------------------------------------------------
+	void StreamSerialiser::writeChunkDirectory()
+	{
+		if (!mChunkStack.empty())
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Cannot write the chunk directory while chunks are still open", 
+				"StreamSerialiser::writeChunkDirectory");
+
+		// writes the header too if nothing else has been written
+		writeChunkBegin(DIRECTORY_ID);
+		uint32 directoryOffset = mChunkStack.back()->offset;
+
+		uint32 count = static_cast<uint32>(mChunkDirectory.size());
+		write(&count);
+		for (ChunkDirectory::iterator i = mChunkDirectory.begin(); i != mChunkDirectory.end(); ++i)
+		{
+			uint16 version = i->version;
+			if (i->compressed)
+				version |= COMPRESSED_VERSION_FLAG;
+			write(&i->id);
+			write(&version);
+			write(&i->length);
+			write(&i->offset);
+		}
+		writeChunkEnd(DIRECTORY_ID);
+
+		// Fixed size locator, always the last thing in the stream
+		writeChunkBegin(DIRECTORY_LOCATOR_ID);
+		write(&directoryOffset);
+		writeChunkEnd(DIRECTORY_LOCATOR_ID);
+	}
+	//---------------------------------------------------------------------
+	bool StreamSerialiser::readChunkDirectory()
+	{
+		checkStream(false, true, false);
+
+		if (mChunkDirectoryRead)
+			return !mChunkDirectory.empty();
+
+		if (!mChunkStack.empty())
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Cannot read the chunk directory while chunks are open", 
+				"StreamSerialiser::readChunkDirectory");
+
+		// Have we figured out the endian mode yet?
+		if (mReadWriteHeader)
+			readHeader();
+
+		if (mEndian == ENDIAN_AUTO)
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+			"Endian mode has not been determined, did you disable header without setting?", 
+			"StreamSerialiser::readChunkDirectory");
+
+		mChunkDirectoryRead = true;
+		mChunkDirectory.clear();
+
+		size_t locatorSize = CHUNK_HEADER_SIZE + sizeof(uint32);
+		size_t streamSize = mStream->size();
+		if (streamSize < locatorSize)
+			return false;
+
+		size_t homePos = mStream->tell();
+		mStream->seek(streamSize - locatorSize);
+		uint32 id;
+		read(&id);
+		if (id != DIRECTORY_LOCATOR_ID)
+		{
+			mStream->seek(homePos);
+			return false;
+		}
+		mStream->seek(streamSize - locatorSize);
+		Chunk* c = readChunkImpl();
+		OGRE_DELETE c;
+		uint32 directoryOffset;
+		read(&directoryOffset);
+
+		mStream->seek(directoryOffset);
+		c = readChunkImpl();
+		id = c->id;
 		OGRE_DELETE c;
+		if (id != DIRECTORY_ID)
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Corrupt chunk directory in stream " + mStream->getName(), 
+				"StreamSerialiser::readChunkDirectory");
+
+		uint32 count;
+		read(&count);
+		mChunkDirectory.resize(count);
+		for (ChunkDirectory::iterator i = mChunkDirectory.begin(); i != mChunkDirectory.end(); ++i)
+		{
+			read(&i->id);
+			read(&i->version);
+			read(&i->length);
+			read(&i->offset);
+			i->compressed = (i->version & COMPRESSED_VERSION_FLAG) != 0;
+			i->version &= ~COMPRESSED_VERSION_FLAG;
+		}
+
+		mStream->seek(homePos);
+		return true;
+	}
+	//---------------------------------------------------------------------
+	bool StreamSerialiser::seekToChunk(uint32 id, size_t index /* = 0 */)
+	{
+		if (!mChunkStack.empty())
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Cannot seek to a chunk while chunks are open", 
+				"StreamSerialiser::seekToChunk");
 
+		if (!readChunkDirectory())
+			return false;
+
+		for (ChunkDirectory::iterator i = mChunkDirectory.begin(); i != mChunkDirectory.end(); ++i)
+		{
+			if (i->id == id && index-- == 0)
+			{
+				mStream->seek(i->offset);
+				return true;
+			}
+		}
+		return false;
 	}
 	//---------------------------------------------------------------------
 	size_t StreamSerialiser::getOffsetFromChunkStart() const
@@ -369,6 +575,11 @@ namespace Ogre
 		{
 			return 0;
 		}
+		else if (mChunkStack.back()->compressed)
+		{
+			// the current stream only holds the chunk data
+			return mStream->tell();
+		}
 		else
 		{
 			size_t pos = mStream->tell();
@@ -389,6 +600,8 @@ namespace Ogre
 		read(&chunk->id);
 		read(&chunk->version);
 		read(&chunk->length);
+		chunk->compressed = (chunk->version & COMPRESSED_VERSION_FLAG) != 0;
+		chunk->version &= ~COMPRESSED_VERSION_FLAG;
 		
 		uint32 checksum;
 		read(&checksum);
@@ -411,24 +624,99 @@ namespace Ogre
 
 	}
 	//---------------------------------------------------------------------
-	void StreamSerialiser::writeChunkImpl(uint32 id, uint16 version)
+	void StreamSerialiser::writeChunkImpl(uint32 id, uint16 version, bool compressed)
 	{
 		Chunk* c = OGRE_NEW Chunk();
 		c->id = id;
 		c->version = version;
-		c->offset = mStream->tell();
+		c->offset = static_cast<uint32>(mStream->tell());
 		c->length = 0;
+		c->compressed = compressed;
 
 		mChunkStack.push_back(c);
 
+		uint16 storedVersion = compressed ? (version | COMPRESSED_VERSION_FLAG) : version;
 		write(&c->id);
-		write(&c->version);
+		write(&storedVersion);
 		write(&c->length);
 		// write length again, this is just a placeholder for the checksum (to come later)
 		write(&c->length);
 
 	}
 	//---------------------------------------------------------------------
+	void StreamSerialiser::beginCompressedRead(Chunk* c)
+	{
+		uint32 uncompressedSize;
+		read(&uncompressedSize);
+		uLong compressedSize = c->length - sizeof(uint32);
+
+		// Inflate straight out of memory streams, rather than copying first
+		uchar* compressedData = 0;
+		uchar* tmp = 0;
+		MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(mStream.get());
+		if (memStream && memStream->size() - memStream->tell() >= compressedSize)
+		{
+			compressedData = memStream->getCurrentPtr();
+			memStream->skip(compressedSize);
+		}
+		else
+		{
+			tmp = OGRE_ALLOC_T(uchar, compressedSize, MEMCATEGORY_GENERAL);
+			compressedData = tmp;
+			mStream->read(compressedData, compressedSize);
+		}
+
+		uchar* data = OGRE_ALLOC_T(uchar, uncompressedSize, MEMCATEGORY_GENERAL);
+		uLongf destLen = uncompressedSize;
+		int ret = uncompress(data, &destLen, compressedData, compressedSize);
+		if (tmp)
+			OGRE_FREE(tmp, MEMCATEGORY_GENERAL);
+
+		if (ret != Z_OK || destLen != uncompressedSize)
+		{
+			OGRE_FREE(data, MEMCATEGORY_GENERAL);
+			OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+				"Corrupt compressed chunk in stream " + mStream->getName() + " at byte "
+				+ StringConverter::toString(c->offset), 
+				"StreamSerialiser::beginCompressedRead");
+		}
+
+		mStreamStack.push_back(mStream);
+		mStream = DataStreamPtr(OGRE_NEW MemoryDataStream(mStream->getName(), 
+			data, uncompressedSize, true, true));
+	}
+	//---------------------------------------------------------------------
+	void StreamSerialiser::endCompressedWrite(Chunk* c)
+	{
+		DataStreamPtr bufferStream = popStream();
+		ChunkBufferStream* buffer = static_cast<ChunkBufferStream*>(bufferStream.get());
+
+		uint32 uncompressedSize = static_cast<uint32>(buffer->size());
+		uLongf compressedSize = compressBound(uncompressedSize);
+		uchar* compressedData = OGRE_ALLOC_T(uchar, compressedSize, MEMCATEGORY_GENERAL);
+		int ret = compress(compressedData, &compressedSize, buffer->getPtr(), uncompressedSize);
+		if (ret != Z_OK)
+		{
+			OGRE_FREE(compressedData, MEMCATEGORY_GENERAL);
+			OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+				"Error compressing chunk in stream " + mStream->getName(), 
+				"StreamSerialiser::endCompressedWrite");
+		}
+
+		write(&uncompressedSize);
+		mStream->write(compressedData, compressedSize);
+		OGRE_FREE(compressedData, MEMCATEGORY_GENERAL);
+	}
+	//---------------------------------------------------------------------
+	DataStreamPtr StreamSerialiser::popStream()
+	{
+		assert(!mStreamStack.empty());
+		DataStreamPtr current = mStream;
+		mStream = mStreamStack.back();
+		mStreamStack.pop_back();
+		return current;
+	}
+	//---------------------------------------------------------------------
 	void StreamSerialiser::writeData(const void* buf, size_t size, size_t count)
 	{
 		checkStream(false, false, true);
@@ -803,6 +1091,8 @@ namespace Ogre
 		// Otherwise checksums for the same data on different endians will not match
 		uint32 id = c->id;
 		uint16 version = c->version;
+		if (c->compressed)
+			version |= COMPRESSED_VERSION_FLAG;
 		uint32 length = c->length;
 #if OGRE_ENDIAN == OGRE_ENDIAN_BIG
 		flipEndian(&id, sizeof(uint32));
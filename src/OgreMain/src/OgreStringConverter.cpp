@@ -28,76 +28,328 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreStringConverter.h"
 
+#include <cstdio>
+#include <limits>
+
 namespace Ogre {
 
+	namespace
+	{
+		/// Enough for any Real formatted with %g, at any sensible precision
+		const size_t REAL_BUFFER_SIZE = 64;
+
+		/** Format a Real the way an ostream with default flags does, without
+			constructing a stream. Returns the number of characters written.
+		*/
+		size_t formatReal(char* buf, Real val, unsigned short precision)
+		{
+#ifdef WIN32
+			int n = _snprintf(buf, REAL_BUFFER_SIZE - 1, "%.*g", (int)precision, (double)val);
+#else
+			int n = snprintf(buf, REAL_BUFFER_SIZE - 1, "%.*g", (int)precision, (double)val);
+#endif
+			if (n < 0 || n >= (int)REAL_BUFFER_SIZE - 1)
+				n = (int)REAL_BUFFER_SIZE - 1;
+			buf[n] = 0;
+			// printf follows the C locale's decimal point, streams in Ogre don't
+			for (int i = 0; i < n; ++i)
+			{
+				char c = buf[i];
+				if (!(c >= '0' && c <= '9') && !(c >= 'a' && c <= 'z') && 
+					!(c >= 'A' && c <= 'Z') && c != '-' && c != '+')
+					buf[i] = '.';
+			}
+			return n;
+		}
+		/// Format a number of Reals separated by spaces
+		String formatReals(const Real* vals, size_t count)
+		{
+			char buf[REAL_BUFFER_SIZE * 16];
+			assert(count <= 16);
+			size_t len = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (i)
+					buf[len++] = ' ';
+				len += formatReal(buf + len, vals[i], 6);
+			}
+			return String(buf, len);
+		}
+		/// Right align text in a field, as an ostream with default flags does
+		String padString(const char* buf, size_t len, unsigned short width, char fill)
+		{
+			if (len >= width)
+				return String(buf, len);
+			String ret(width - len, fill);
+			ret.append(buf, len);
+			return ret;
+		}
+		/// Format any integer type without constructing a stream
+		template <typename T>
+		String formatInteger(T val, unsigned short width, char fill, std::ios::fmtflags flags)
+		{
+			if (flags)
+			{
+				// hex, left alignment etc, let the stream deal with it
+				stringstream stream;
+				stream.width(width);
+				stream.fill(fill);
+				stream.setf(flags);
+				stream << val;
+				return stream.str();
+			}
+
+			char buf[32];
+			char* end = buf + sizeof(buf);
+			char* p = end;
+			bool negative = val < T(0);
+			uint64 mag = negative ? uint64(0) - static_cast<uint64>(val) : static_cast<uint64>(val);
+			do
+			{
+				*--p = static_cast<char>('0' + (mag % 10));
+				mag /= 10;
+			} while (mag);
+			if (negative)
+				*--p = '-';
+			return padString(p, end - p, width, fill);
+		}
+
+		inline bool isSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+		}
+		inline bool isDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+		/** Parse a plain decimal number from the start of [p, end), skipping leading 
+			white space, without a stream and regardless of locale.
+		@remarks
+			This handles the numbers found in scripts, ie up to 19 significant digits 
+			and small exponents, which can be converted exactly. Anything else, and
+			malformed input, returns false so the caller can defer to a stream.
+		@param next Set to the first character after the number
+		*/
+		bool parseDecimal(const char* p, const char* end, double& result, const char*& next)
+		{
+			static const double powersOf10[] = 
+			{
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+
+			while (p != end && isSpace(*p))
+				++p;
+			bool negative = false;
+			if (p != end && (*p == '+' || *p == '-'))
+			{
+				negative = *p == '-';
+				++p;
+			}
+
+			uint64 mantissa = 0;
+			int significant = 0;
+			int exponent = 0;
+			bool anyDigits = false;
+			for (; p != end && isDigit(*p); ++p)
+			{
+				anyDigits = true;
+				if (mantissa == 0 && *p == '0')
+					continue;
+				if (++significant > 19)
+					return false;
+				mantissa = mantissa * 10 + (*p - '0');
+			}
+			if (p != end && *p == '.')
+			{
+				for (++p; p != end && isDigit(*p); ++p)
+				{
+					anyDigits = true;
+					--exponent;
+					if (mantissa == 0 && *p == '0')
+						continue;
+					if (++significant > 19)
+						return false;
+					mantissa = mantissa * 10 + (*p - '0');
+				}
+			}
+			if (!anyDigits)
+				return false;
+
+			if (p != end && (*p == 'e' || *p == 'E'))
+			{
+				++p;
+				bool negativeExp = false;
+				if (p != end && (*p == '+' || *p == '-'))
+				{
+					negativeExp = *p == '-';
+					++p;
+				}
+				if (p == end || !isDigit(*p))
+					return false;
+				int exp = 0;
+				for (; p != end && isDigit(*p); ++p)
+				{
+					if (exp > 1000)
+						return false;
+					exp = exp * 10 + (*p - '0');
+				}
+				exponent += negativeExp ? -exp : exp;
+			}
+
+			// Exact if the mantissa fits in a double and the power of 10 does too
+			double val;
+			if (mantissa == 0)
+				val = 0;
+			else if (mantissa > (uint64(1) << 53) || exponent < -22 || exponent > 22)
+				return false;
+			else if (exponent < 0)
+				val = (double)mantissa / powersOf10[-exponent];
+			else
+				val = (double)mantissa * powersOf10[exponent];
+
+			result = negative ? -val : val;
+			next = p;
+			return true;
+		}
+		/// Parse a Real from [begin, end), as an istream would
+		Real parseRealRange(const char* begin, const char* end, Real defaultValue)
+		{
+			double fast;
+			const char* next;
+			if (parseDecimal(begin, end, fast, next))
+				return static_cast<Real>(fast);
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+			String val(begin, end);
+			Real ret = 0;
+			int n = sscanf(val.c_str(), "%f", &ret);
+
+			if(n == 0){
+				// Nothing read, so try integer format
+				int ret2 = 0;
+				n = sscanf(val.c_str(), "%d", &ret2);
+				if(n == 1)
+					ret = (Real)ret2;
+			}
+			return ret;
+#else
+			// Use istringstream for direct correspondence with toString
+			StringStream str(String(begin, end));
+			Real ret = defaultValue;
+			if( !(str >> ret) )
+				return defaultValue;
+			return ret;
+#endif
+		}
+		/// Parse any integer type from a String, as an istream would
+		template <typename T>
+		T parseInteger(const String& val, T defaultValue)
+		{
+			const char* p = val.c_str();
+			const char* end = p + val.size();
+			while (p != end && isSpace(*p))
+				++p;
+			bool negative = false;
+			if (p != end && (*p == '+' || *p == '-'))
+			{
+				negative = *p == '-';
+				++p;
+			}
+			// unsigned types accept negative numbers and wrap, leave that to the stream
+			if (!negative || std::numeric_limits<T>::is_signed)
+			{
+				uint64 mag = 0;
+				int digits = 0;
+				for (; p != end && isDigit(*p) && digits <= 18; ++p, ++digits)
+					mag = mag * 10 + (*p - '0');
+				uint64 limit = negative ? 
+					uint64(0) - static_cast<uint64>(std::numeric_limits<T>::min()) :
+					static_cast<uint64>(std::numeric_limits<T>::max());
+				if (digits > 0 && digits <= 18 && (p == end || !isDigit(*p)) && mag <= limit)
+					return negative ? static_cast<T>(uint64(0) - mag) : static_cast<T>(mag);
+			}
+
+			// Use istringstream for direct correspondence with toString
+			StringStream str(val);
+			T ret = defaultValue;
+			if( !(str >> ret) )
+				return defaultValue;
+			return ret;
+		}
+		/** Parse space separated Reals from a String, as StringUtil::split and 
+			parseReal would, but without allocating.
+		@return The number of values in the string, which may be more than count
+		*/
+		size_t parseReals(const String& val, Real* out, size_t count)
+		{
+			const char* p = val.c_str();
+			const char* end = p + val.size();
+			size_t found = 0;
+			while (p != end)
+			{
+				// delimiters as StringUtil::split
+				if (*p == ' ' || *p == '\t' || *p == '\n')
+				{
+					++p;
+					continue;
+				}
+				const char* tokenEnd = p;
+				while (tokenEnd != end && *tokenEnd != ' ' && *tokenEnd != '\t' && *tokenEnd != '\n')
+					++tokenEnd;
+				if (found < count)
+					out[found] = parseRealRange(p, tokenEnd, 0);
+				++found;
+				p = tokenEnd;
+			}
+			return found;
+		}
+	}
+
     //-----------------------------------------------------------------------
     String StringConverter::toString(Real val, unsigned short precision, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f", val);
-		return String(buffer, n);
-#else
-        stringstream stream;
-        stream.precision(precision);
-        stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
-#endif
+		if (flags)
+		{
+			stringstream stream;
+			stream.precision(precision);
+			stream.width(width);
+			stream.fill(fill);
+			stream.setf(flags);
+			stream << val;
+			return stream.str();
+		}
+
+		char buf[REAL_BUFFER_SIZE];
+		size_t len = formatReal(buf, val, precision);
+		return padString(buf, len, width, fill);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(int val, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-        stringstream stream;
-		stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
+		return formatInteger(val, width, fill, flags);
     }
     //-----------------------------------------------------------------------
 #if OGRE_PLATFORM != OGRE_PLATFORM_NACL &&  ( OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64 || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS )
     String StringConverter::toString(unsigned int val, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-        stringstream stream;
-        stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
+		return formatInteger(val, width, fill, flags);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(size_t val, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-        stringstream stream;
-        stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
+		return formatInteger(val, width, fill, flags);
     }
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
     //-----------------------------------------------------------------------
     String StringConverter::toString(unsigned long val, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-        stringstream stream;
-        stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
+		return formatInteger(val, width, fill, flags);
     }
 
 #endif
@@ -106,100 +358,40 @@ namespace Ogre {
     String StringConverter::toString(size_t val, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-        stringstream stream;
-		stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
+		return formatInteger(val, width, fill, flags);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(unsigned long val, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-        stringstream stream;
-		stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
+		return formatInteger(val, width, fill, flags);
     }
     //-----------------------------------------------------------------------
 #endif
     String StringConverter::toString(long val, 
         unsigned short width, char fill, std::ios::fmtflags flags)
     {
-        stringstream stream;
-		stream.width(width);
-        stream.fill(fill);
-        if (flags)
-            stream.setf(flags);
-        stream << val;
-        return stream.str();
+		return formatInteger(val, width, fill, flags);
     }
 	//-----------------------------------------------------------------------
     String StringConverter::toString(const Vector2& val)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f %f", val.x, val.y);
-		return String(buffer, n);
-#else
-        stringstream stream;
-		stream << val.x << " " << val.y;
-        return stream.str();
-#endif
+		return formatReals(val.ptr(), 2);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Vector3& val)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f %f %f", val.x, val.y, val.z);
-		return String(buffer, n);
-#else
-        stringstream stream;
-		stream << val.x << " " << val.y << " " << val.z;
-        return stream.str();
-#endif
+		return formatReals(val.ptr(), 3);
     }
 	//-----------------------------------------------------------------------
     String StringConverter::toString(const Vector4& val)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f %f %f %f", val.x, val.y, val.z, val.w);
-		return String(buffer, n);
-#else
-        stringstream stream;
-		stream << val.x << " " << val.y << " " << val.z << " " << val.w;
-        return stream.str();
-#endif
+		return formatReals(val.ptr(), 4);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Matrix3& val)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f %f %f %f %f %f %f %f %f", val[0][0], 
-			val[0][1], val[0][2], val[1][0], val[1][1], val[1][2],
-			val[2][0], val[2][1], val[2][2]);
-		return String(buffer, n);
-#else
-		stringstream stream;
-        stream << val[0][0] << " " 
-            << val[0][1] << " "             
-            << val[0][2] << " "             
-            << val[1][0] << " "             
-            << val[1][1] << " "             
-            << val[1][2] << " "             
-            << val[2][0] << " "             
-            << val[2][1] << " "             
-            << val[2][2];
-        return stream.str();
-#endif
+		return formatReals(val[0], 9);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(bool val, bool yesNo)
@@ -228,154 +420,68 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Matrix4& val)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f %f %f %f %f %f %f %f %f %f %f %f %f %f %f %f", 
-			val[0][0], val[0][1], val[0][2], val[0][3], 
-			val[1][0], val[1][1], val[1][2], val[1][3], 
-			val[2][0], val[2][1], val[2][2], val[2][3],
-			val[3][0], val[3][1], val[3][2], val[3][3]);
-		return String(buffer, n);
-#else
-		stringstream stream;
-        stream << val[0][0] << " " 
-            << val[0][1] << " "             
-            << val[0][2] << " "             
-            << val[0][3] << " "             
-            << val[1][0] << " "             
-            << val[1][1] << " "             
-            << val[1][2] << " "             
-            << val[1][3] << " "             
-            << val[2][0] << " "             
-            << val[2][1] << " "             
-            << val[2][2] << " "             
-            << val[2][3] << " "             
-            << val[3][0] << " "             
-            << val[3][1] << " "             
-            << val[3][2] << " "             
-            << val[3][3];
-        return stream.str();
-#endif
+		return formatReals(val[0], 16);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Quaternion& val)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f %f %f %f", val.w, val.x, val.y, val.z);
-		return String(buffer, n);
-#else
-		stringstream stream;
-        stream  << val.w << " " << val.x << " " << val.y << " " << val.z;
-        return stream.str();
-#endif
+		return formatReals(val.ptr(), 4);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const ColourValue& val)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		static char buffer[128] = "";
-		int n = snprintf(buffer, 128, "%f %f %f %f", val.r, val.g, val.b, val.a);
-		return String(buffer, n);
-#else
-		stringstream stream;
-        stream << val.r << " " << val.g << " " << val.b << " " << val.a;
-        return stream.str();
-#endif
+		return formatReals(val.ptr(), 4);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const StringVector& val)
     {
-		stringstream stream;
+		size_t len = 0;
         StringVector::const_iterator i, iend, ibegin;
         ibegin = val.begin();
         iend = val.end();
+        for (i = ibegin; i != iend; ++i)
+            len += i->size() + 1;
+
+		String ret;
+		ret.reserve(len);
         for (i = ibegin; i != iend; ++i)
         {
             if (i != ibegin)
-                stream << " ";
+                ret += ' ';
 
-            stream << *i; 
+            ret += *i; 
         }
-        return stream.str();
+        return ret;
     }
     //-----------------------------------------------------------------------
     Real StringConverter::parseReal(const String& val, Real defaultValue)
     {
-#if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
-		Real ret = 0;
-		int n = sscanf(val.c_str(), "%f", &ret);
-		
-		if(n == 0){
-			// Nothing read, so try integer format
-			int ret2 = 0;
-			n = sscanf(val.c_str(), "%d", &ret2);
-			if(n == 1)
-				ret = (Real)ret2;
-		}
-#else
-		// Use istringstream for direct correspondence with toString
-		StringStream str(val);
-		Real ret = defaultValue;
-        if( !(str >> ret) )
-            return defaultValue;
-#endif
-        return ret;
+		return parseRealRange(val.c_str(), val.c_str() + val.size(), defaultValue);
     }
     //-----------------------------------------------------------------------
     int StringConverter::parseInt(const String& val, int defaultValue)
     {
-		// Use istringstream for direct correspondence with toString
-		StringStream str(val);
-		int ret = defaultValue;
-        if( !(str >> ret) )
-            return defaultValue;
-
-        return ret;
+		return parseInteger(val, defaultValue);
     }
     //-----------------------------------------------------------------------
     unsigned int StringConverter::parseUnsignedInt(const String& val, unsigned int defaultValue)
     {
-		// Use istringstream for direct correspondence with toString
-		StringStream str(val);
-		unsigned int ret = defaultValue;
-        if( !(str >> ret) )
-            return defaultValue;
-
-		return ret;
+		return parseInteger(val, defaultValue);
     }
     //-----------------------------------------------------------------------
     long StringConverter::parseLong(const String& val, long defaultValue)
     {
-		// Use istringstream for direct correspondence with toString
-		StringStream str(val);
-		long ret = defaultValue;
-        if( !(str >> ret) )
-            return defaultValue;
-
-		return ret;
+		return parseInteger(val, defaultValue);
     }
     //-----------------------------------------------------------------------
     unsigned long StringConverter::parseUnsignedLong(const String& val, unsigned long defaultValue)
     {
-		// Use istringstream for direct correspondence with toString
-		StringStream str(val);
-		unsigned long ret = defaultValue;
-        if( !(str >> ret) )
-            return defaultValue;
-
-		return ret;
+		return parseInteger(val, defaultValue);
     }
     //-----------------------------------------------------------------------
     size_t StringConverter::parseSizeT(const String& val, size_t defaultValue)
     {
-		// Use istringstream for direct correspondence with toString
-		StringStream str(val);
-		size_t ret = defaultValue;
-        if( !(str >> ret) )
-            return defaultValue;
-
-		return ret;
+		return parseInteger(val, defaultValue);
     }
     //-----------------------------------------------------------------------
     bool StringConverter::parseBool(const String& val, bool defaultValue)
@@ -392,111 +498,98 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Vector2 StringConverter::parseVector2(const String& val, const Vector2& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 2)
+		Real v[2];
+        if (parseReals(val, v, 2) != 2)
         {
             return defaultValue;
         }
         else
         {
-            return Vector2(parseReal(vec[0]),parseReal(vec[1]));
+            return Vector2(v[0], v[1]);
         }
     }
 	//-----------------------------------------------------------------------
     Vector3 StringConverter::parseVector3(const String& val, const Vector3& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 3)
+		Real v[3];
+        if (parseReals(val, v, 3) != 3)
         {
             return defaultValue;
         }
         else
         {
-            return Vector3(parseReal(vec[0]),parseReal(vec[1]),parseReal(vec[2]));
+            return Vector3(v[0], v[1], v[2]);
         }
     }
 	//-----------------------------------------------------------------------
     Vector4 StringConverter::parseVector4(const String& val, const Vector4& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 4)
+		Real v[4];
+        if (parseReals(val, v, 4) != 4)
         {
             return defaultValue;
         }
         else
         {
-            return Vector4(parseReal(vec[0]),parseReal(vec[1]),parseReal(vec[2]),parseReal(vec[3]));
+            return Vector4(v[0], v[1], v[2], v[3]);
         }
     }
     //-----------------------------------------------------------------------
     Matrix3 StringConverter::parseMatrix3(const String& val, const Matrix3& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 9)
+		Real v[9];
+        if (parseReals(val, v, 9) != 9)
         {
             return defaultValue;
         }
         else
         {
-            return Matrix3(parseReal(vec[0]),parseReal(vec[1]),parseReal(vec[2]),
-                parseReal(vec[3]),parseReal(vec[4]),parseReal(vec[5]),
-                parseReal(vec[6]),parseReal(vec[7]),parseReal(vec[8]));
+            return Matrix3(v[0], v[1], v[2],
+                v[3], v[4], v[5],
+                v[6], v[7], v[8]);
         }
     }
     //-----------------------------------------------------------------------
     Matrix4 StringConverter::parseMatrix4(const String& val, const Matrix4& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 16)
+		Real v[16];
+        if (parseReals(val, v, 16) != 16)
         {
             return defaultValue;
         }
         else
         {
-            return Matrix4(parseReal(vec[0]),parseReal(vec[1]),parseReal(vec[2]), parseReal(vec[3]),
-                parseReal(vec[4]),parseReal(vec[5]), parseReal(vec[6]), parseReal(vec[7]),
-                parseReal(vec[8]),parseReal(vec[9]), parseReal(vec[10]), parseReal(vec[11]),
-                parseReal(vec[12]),parseReal(vec[13]), parseReal(vec[14]), parseReal(vec[15]));
+            return Matrix4(v[0], v[1], v[2], v[3],
+                v[4], v[5], v[6], v[7],
+                v[8], v[9], v[10], v[11],
+                v[12], v[13], v[14], v[15]);
         }
     }
     //-----------------------------------------------------------------------
     Quaternion StringConverter::parseQuaternion(const String& val, const Quaternion& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 4)
+		Real v[4];
+        if (parseReals(val, v, 4) != 4)
         {
             return defaultValue;
         }
         else
         {
-            return Quaternion(parseReal(vec[0]),parseReal(vec[1]),parseReal(vec[2]), parseReal(vec[3]));
+            return Quaternion(v[0], v[1], v[2], v[3]);
         }
     }
     //-----------------------------------------------------------------------
     ColourValue StringConverter::parseColourValue(const String& val, const ColourValue& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() == 4)
+		Real v[4];
+		size_t count = parseReals(val, v, 4);
+        if (count == 4)
         {
-            return ColourValue(parseReal(vec[0]),parseReal(vec[1]),parseReal(vec[2]), parseReal(vec[3]));
+            return ColourValue(v[0], v[1], v[2], v[3]);
         }
-        else if (vec.size() == 3)
+        else if (count == 3)
         {
-            return ColourValue(parseReal(vec[0]),parseReal(vec[1]),parseReal(vec[2]), 1.0f);
+            return ColourValue(v[0], v[1], v[2], 1.0f);
         }
         else
         {
@@ -511,6 +604,12 @@ namespace Ogre {
 	//-----------------------------------------------------------------------
 	bool StringConverter::isNumber(const String& val)
 	{
+		double fast;
+		const char* next;
+		const char* end = val.c_str() + val.size();
+		if (parseDecimal(val.c_str(), end, fast, next))
+			return next == end;
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
 		float test;
 		int n = sscanf(val.c_str(), "%f", &test);
@@ -523,5 +622,3 @@ namespace Ogre {
 #endif
 	}
 }
-
-
@@ -0,0 +1,148 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSweepAndPrune.h"
+#include "OgreMovableObject.h"
+
+namespace Ogre {
+
+	namespace
+	{
+		template <int Axis>
+		struct EntryLess
+		{
+			template <typename T>
+			bool operator()(const T& a, const T& b) const
+			{
+				return a.minimum[Axis] < b.minimum[Axis];
+			}
+		};
+
+		template <int Axis, typename EntryList>
+		bool sweep(EntryList& entries, SweepAndPrune::Listener* listener)
+		{
+			static const int axis1 = (Axis + 1) % 3;
+			static const int axis2 = (Axis + 2) % 3;
+
+			std::sort(entries.begin(), entries.end(), EntryLess<Axis>());
+
+			typename EntryList::const_iterator end = entries.end();
+			for (typename EntryList::const_iterator a = entries.begin(); a != end; ++a)
+			{
+				const Real sweepEnd = a->maximum[Axis];
+				for (typename EntryList::const_iterator b = a + 1; 
+					b != end && b->minimum[Axis] <= sweepEnd; ++b)
+				{
+					if (a->minimum[axis1] <= b->maximum[axis1] && b->minimum[axis1] <= a->maximum[axis1] &&
+						a->minimum[axis2] <= b->maximum[axis2] && b->minimum[axis2] <= a->maximum[axis2])
+					{
+						if (!listener->overlapFound(a->object, b->object))
+							return false;
+					}
+				}
+			}
+			return true;
+		}
+	}
+	//---------------------------------------------------------------------
+	SweepAndPrune::SweepAndPrune()
+		: mCentreSum(Vector3::ZERO)
+		, mCentreSquaredSum(Vector3::ZERO)
+	{
+	}
+	//---------------------------------------------------------------------
+	SweepAndPrune::~SweepAndPrune()
+	{
+	}
+	//---------------------------------------------------------------------
+	void SweepAndPrune::clear(void)
+	{
+		mEntries.clear();
+		mInfinite.clear();
+		mCentreSum = Vector3::ZERO;
+		mCentreSquaredSum = Vector3::ZERO;
+	}
+	//---------------------------------------------------------------------
+	void SweepAndPrune::addObject(MovableObject* obj)
+	{
+		addObject(obj, obj->getWorldBoundingBox());
+	}
+	//---------------------------------------------------------------------
+	void SweepAndPrune::addObject(MovableObject* obj, const AxisAlignedBox& box)
+	{
+		if (box.isNull())
+			return;
+		if (box.isInfinite())
+		{
+			mInfinite.push_back(obj);
+			return;
+		}
+
+		Entry entry;
+		entry.minimum = box.getMinimum();
+		entry.maximum = box.getMaximum();
+		entry.object = obj;
+		mEntries.push_back(entry);
+
+		Vector3 centre = (entry.minimum + entry.maximum) * 0.5f;
+		mCentreSum += centre;
+		mCentreSquaredSum += centre * centre;
+	}
+	//---------------------------------------------------------------------
+	bool SweepAndPrune::findOverlaps(Listener* listener)
+	{
+		// Infinite boxes overlap everything
+		for (MovableObjectList::iterator i = mInfinite.begin(); i != mInfinite.end(); ++i)
+		{
+			for (MovableObjectList::iterator j = i + 1; j != mInfinite.end(); ++j)
+			{
+				if (!listener->overlapFound(*i, *j))
+					return false;
+			}
+			for (EntryList::iterator j = mEntries.begin(); j != mEntries.end(); ++j)
+			{
+				if (!listener->overlapFound(*i, j->object))
+					return false;
+			}
+		}
+
+		if (mEntries.size() < 2)
+			return true;
+
+		// Sweep along the axis with the largest variance, it has the least
+		// overlapping extents to go through
+		Real count = (Real)mEntries.size();
+		Vector3 variance = mCentreSquaredSum - mCentreSum * mCentreSum / count;
+		if (variance.x >= variance.y && variance.x >= variance.z)
+			return sweep<0>(mEntries, listener);
+		else if (variance.y >= variance.z)
+			return sweep<1>(mEntries, listener);
+		else
+			return sweep<2>(mEntries, listener);
+	}
+}
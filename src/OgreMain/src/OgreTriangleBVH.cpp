@@ -0,0 +1,518 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreTriangleBVH.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreHardwareBufferManager.h"
+
+namespace Ogre {
+
+	namespace
+	{
+		/// Number of buckets the triangles are sorted in when looking for a split
+		const size_t NUM_SPLIT_BINS = 12;
+		/// Deep enough for any sensible mesh, keeps the traversal stack bounded
+		const size_t MAX_TREE_DEPTH = 60;
+
+		inline Real halfSurfaceArea(const Vector3& minimum, const Vector3& maximum)
+		{
+			Vector3 d = maximum - minimum;
+			return d.x * d.y + d.y * d.z + d.z * d.x;
+		}
+
+		struct Bin
+		{
+			Vector3 minimum;
+			Vector3 maximum;
+			size_t count;
+
+			Bin() : minimum(Math::POS_INFINITY, Math::POS_INFINITY, Math::POS_INFINITY),
+				maximum(Math::NEG_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY), count(0) {}
+
+			void grow(const Bin& other)
+			{
+				minimum.makeFloor(other.minimum);
+				maximum.makeCeil(other.maximum);
+				count += other.count;
+			}
+			Real cost(void) const
+			{
+				return count ? halfSurfaceArea(minimum, maximum) * count : 0;
+			}
+		};
+
+		/// Reads vertex positions from a locked buffer
+		struct PositionReader
+		{
+			const unsigned char* base;
+			size_t vertexSize;
+			const VertexElement* element;
+			/// Components read from each position, at most 3
+			unsigned short components;
+			bool isFloat;
+
+			/// Returns false for position formats which can't be read
+			bool setElement(const VertexElement* elem)
+			{
+				element = elem;
+				switch (elem->getType())
+				{
+				case VET_FLOAT1:
+				case VET_FLOAT2:
+				case VET_FLOAT3:
+				case VET_FLOAT4:
+					isFloat = true;
+					break;
+				case VET_SHORT1:
+				case VET_SHORT2:
+				case VET_SHORT3:
+				case VET_SHORT4:
+					isFloat = false;
+					break;
+				default:
+					return false;
+				}
+				components = std::min<unsigned short>(
+					VertexElement::getTypeCount(elem->getType()), 3);
+				return true;
+			}
+
+			Vector3 operator()(size_t index) const
+			{
+				unsigned char* vertex = const_cast<unsigned char*>(base + index * vertexSize);
+				Vector3 position(Vector3::ZERO);
+				if (isFloat)
+				{
+					float* pFloat;
+					element->baseVertexPointerToElement(vertex, &pFloat);
+					for (unsigned short i = 0; i < components; ++i)
+						position[i] = pFloat[i];
+				}
+				else
+				{
+					unsigned short* pShort;
+					element->baseVertexPointerToElement(vertex, &pShort);
+					for (unsigned short i = 0; i < components; ++i)
+						position[i] = static_cast<short>(pShort[i]);
+				}
+				return position;
+			}
+		};
+	}
+	//---------------------------------------------------------------------
+	TriangleBVH::TriangleBVH()
+	{
+	}
+	//---------------------------------------------------------------------
+	TriangleBVH::~TriangleBVH()
+	{
+	}
+	//---------------------------------------------------------------------
+	void TriangleBVH::clear(void)
+	{
+		mNodes.clear();
+		mTriangles.clear();
+	}
+	//---------------------------------------------------------------------
+	void TriangleBVH::build(const Mesh* mesh)
+	{
+		vector<Vector3>::type positions;
+		vector<unsigned short>::type subMeshIndices;
+		vector<size_t>::type triangleIndices;
+
+		for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+		{
+			const SubMesh* subMesh = mesh->getSubMesh(s);
+			RenderOperation::OperationType opType = subMesh->operationType;
+			if (opType != RenderOperation::OT_TRIANGLE_LIST &&
+				opType != RenderOperation::OT_TRIANGLE_STRIP &&
+				opType != RenderOperation::OT_TRIANGLE_FAN)
+				continue;
+
+			const VertexData* vertexData = subMesh->useSharedVertices ? 
+				mesh->sharedVertexData : subMesh->vertexData;
+			if (!vertexData)
+				continue;
+			const VertexElement* posElem = 
+				vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+			PositionReader reader;
+			if (!posElem || !reader.setElement(posElem))
+				continue;
+
+			const IndexData* indexData = subMesh->indexData;
+			bool indexed = indexData && indexData->indexCount && !indexData->indexBuffer.isNull();
+			size_t numIndexes = indexed ? indexData->indexCount : vertexData->vertexCount;
+			size_t numTriangles = opType == RenderOperation::OT_TRIANGLE_LIST ? 
+				numIndexes / 3 : (numIndexes >= 3 ? numIndexes - 2 : 0);
+			if (!numTriangles)
+				continue;
+
+			HardwareVertexBufferSharedPtr vbuf = 
+				vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+			reader.vertexSize = vbuf->getVertexSize();
+			// Indexes are relative to the start of the vertex data
+			reader.base = static_cast<const unsigned char*>(
+				vbuf->lock(HardwareBuffer::HBL_READ_ONLY)) + vertexData->vertexStart * reader.vertexSize;
+
+			const uint16* p16Idx = 0;
+			const uint32* p32Idx = 0;
+			if (indexed)
+			{
+				const void* pIndex = indexData->indexBuffer->lock(HardwareBuffer::HBL_READ_ONLY);
+				if (indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT)
+					p32Idx = static_cast<const uint32*>(pIndex) + indexData->indexStart;
+				else
+					p16Idx = static_cast<const uint16*>(pIndex) + indexData->indexStart;
+			}
+
+			positions.reserve(positions.size() + numTriangles * 3);
+			size_t index[3];
+			for (size_t t = 0; t < numTriangles; ++t)
+			{
+				size_t first = opType == RenderOperation::OT_TRIANGLE_LIST ? t * 3 : t;
+				for (size_t i = 0; i < 3; ++i)
+				{
+					size_t n = first + i;
+					if (opType == RenderOperation::OT_TRIANGLE_FAN && i == 0)
+						n = 0;
+					index[i] = p32Idx ? p32Idx[n] : (p16Idx ? p16Idx[n] : n);
+				}
+				positions.push_back(reader(index[0]));
+				positions.push_back(reader(index[1]));
+				positions.push_back(reader(index[2]));
+				subMeshIndices.push_back(s);
+				triangleIndices.push_back(t);
+			}
+
+			if (indexed)
+				indexData->indexBuffer->unlock();
+			vbuf->unlock();
+		}
+
+		build(positions.empty() ? 0 : &positions[0], 
+			subMeshIndices.empty() ? 0 : &subMeshIndices[0], 
+			triangleIndices.empty() ? 0 : &triangleIndices[0], subMeshIndices.size());
+	}
+	//---------------------------------------------------------------------
+	void TriangleBVH::build(const Vector3* positions, const unsigned short* subMeshIndices, 
+		const size_t* triangleIndices, size_t numTriangles)
+	{
+		clear();
+		if (!numTriangles)
+			return;
+
+		mTriangles.resize(numTriangles);
+		vector<Vector3>::type centroids(numTriangles);
+		for (size_t i = 0; i < numTriangles; ++i)
+		{
+			Triangle& tri = mTriangles[i];
+			const Vector3* v = positions + i * 3;
+			tri.v0 = v[0];
+			tri.edge1 = v[1] - v[0];
+			tri.edge2 = v[2] - v[0];
+			tri.subMeshIndex = subMeshIndices ? subMeshIndices[i] : 0;
+			tri.triangleIndex = triangleIndices ? triangleIndices[i] : i;
+			centroids[i] = (v[0] + v[1] + v[2]) / 3;
+		}
+
+		// A binary tree with single triangle leaves has 2N-1 nodes
+		mNodes.reserve(numTriangles * 2);
+		Node root;
+		root.first = 0;
+		root.count = (uint32)numTriangles;
+		updateBounds(root);
+		mNodes.push_back(root);
+		subdivide(0, centroids, 1);
+	}
+	//---------------------------------------------------------------------
+	void TriangleBVH::updateBounds(Node& node) const
+	{
+		node.minimum = Vector3(Math::POS_INFINITY, Math::POS_INFINITY, Math::POS_INFINITY);
+		node.maximum = Vector3(Math::NEG_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY);
+		for (uint32 i = node.first; i < node.first + node.count; ++i)
+		{
+			const Triangle& tri = mTriangles[i];
+			Vector3 v1 = tri.v0 + tri.edge1;
+			Vector3 v2 = tri.v0 + tri.edge2;
+			node.minimum.makeFloor(tri.v0);
+			node.minimum.makeFloor(v1);
+			node.minimum.makeFloor(v2);
+			node.maximum.makeCeil(tri.v0);
+			node.maximum.makeCeil(v1);
+			node.maximum.makeCeil(v2);
+		}
+	}
+	//---------------------------------------------------------------------
+	void TriangleBVH::subdivide(size_t nodeIndex, vector<Vector3>::type& centroids, size_t depth)
+	{
+		// Copied, mNodes grows below
+		const uint32 first = mNodes[nodeIndex].first;
+		const uint32 count = mNodes[nodeIndex].count;
+		if (count <= 2 || depth >= MAX_TREE_DEPTH)
+			return;
+
+		Vector3 centreMin = centroids[first];
+		Vector3 centreMax = centroids[first];
+		for (uint32 i = first + 1; i < first + count; ++i)
+		{
+			centreMin.makeFloor(centroids[i]);
+			centreMax.makeCeil(centroids[i]);
+		}
+
+		// Find the cheapest split among the bin boundaries of the 3 axes
+		Real bestCost = Math::POS_INFINITY;
+		int bestAxis = -1;
+		size_t bestSplit = 0;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			Real extent = centreMax[axis] - centreMin[axis];
+			if (extent <= 0)
+				continue;
+			Real scale = NUM_SPLIT_BINS / extent;
+
+			Bin bins[NUM_SPLIT_BINS];
+			for (uint32 i = first; i < first + count; ++i)
+			{
+				size_t b = std::min(NUM_SPLIT_BINS - 1, 
+					(size_t)((centroids[i][axis] - centreMin[axis]) * scale));
+				const Triangle& tri = mTriangles[i];
+				Bin& bin = bins[b];
+				bin.minimum.makeFloor(tri.v0);
+				bin.minimum.makeFloor(tri.v0 + tri.edge1);
+				bin.minimum.makeFloor(tri.v0 + tri.edge2);
+				bin.maximum.makeCeil(tri.v0);
+				bin.maximum.makeCeil(tri.v0 + tri.edge1);
+				bin.maximum.makeCeil(tri.v0 + tri.edge2);
+				++bin.count;
+			}
+
+			// Costs of everything right of each boundary
+			Real rightCosts[NUM_SPLIT_BINS];
+			Bin right;
+			for (size_t b = NUM_SPLIT_BINS - 1; b > 0; --b)
+			{
+				right.grow(bins[b]);
+				rightCosts[b] = right.cost();
+			}
+			Bin left;
+			for (size_t b = 1; b < NUM_SPLIT_BINS; ++b)
+			{
+				left.grow(bins[b - 1]);
+				Real cost = left.cost() + rightCosts[b];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b;
+				}
+			}
+		}
+
+		const Node& node = mNodes[nodeIndex];
+		Real leafCost = halfSurfaceArea(node.minimum, node.maximum) * count;
+		if (bestAxis < 0 || bestCost >= leafCost)
+			return;
+
+		// Partition the triangles, keeping their centroids in step
+		Real scale = NUM_SPLIT_BINS / (centreMax[bestAxis] - centreMin[bestAxis]);
+		uint32 i = first;
+		uint32 j = first + count;
+		while (i < j)
+		{
+			size_t b = std::min(NUM_SPLIT_BINS - 1, 
+				(size_t)((centroids[i][bestAxis] - centreMin[bestAxis]) * scale));
+			if (b < bestSplit)
+			{
+				++i;
+			}
+			else
+			{
+				--j;
+				std::swap(mTriangles[i], mTriangles[j]);
+				std::swap(centroids[i], centroids[j]);
+			}
+		}
+		uint32 leftCount = i - first;
+		if (leftCount == 0 || leftCount == count)
+			return;
+
+		uint32 childIndex = (uint32)mNodes.size();
+		Node child;
+		child.first = first;
+		child.count = leftCount;
+		updateBounds(child);
+		mNodes.push_back(child);
+		child.first = first + leftCount;
+		child.count = count - leftCount;
+		updateBounds(child);
+		mNodes.push_back(child);
+
+		mNodes[nodeIndex].first = childIndex;
+		mNodes[nodeIndex].count = 0;
+
+		subdivide(childIndex, centroids, depth + 1);
+		subdivide(childIndex + 1, centroids, depth + 1);
+	}
+	//---------------------------------------------------------------------
+	namespace
+	{
+		/// Distance at which a ray enters a box, if it does before maxDistance
+		inline bool rayBoxEntry(const Vector3& minimum, const Vector3& maximum, 
+			const Vector3& origin, const Vector3& invDir, Real maxDistance, Real& entry)
+		{
+			Real tmin = 0;
+			Real tmax = maxDistance;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (Math::Abs(invDir[axis]) > std::numeric_limits<Real>::max())
+				{
+					// Parallel to the slab, 0 * infinity would give NaN. The ray
+					// is either always or never between its planes.
+					if (origin[axis] < minimum[axis] || origin[axis] > maximum[axis])
+						return false;
+					continue;
+				}
+				Real t1 = (minimum[axis] - origin[axis]) * invDir[axis];
+				Real t2 = (maximum[axis] - origin[axis]) * invDir[axis];
+				tmin = std::max(tmin, std::min(t1, t2));
+				tmax = std::min(tmax, std::max(t1, t2));
+			}
+
+			entry = tmin;
+			return tmin <= tmax && tmin < maxDistance;
+		}
+	}
+	//---------------------------------------------------------------------
+	bool TriangleBVH::intersects(const Ray& ray, Hit& hit, Real maxDistance) const
+	{
+		if (mNodes.empty())
+			return false;
+
+		const Vector3& origin = ray.getOrigin();
+		const Vector3& dir = ray.getDirection();
+		Vector3 invDir(1 / dir.x, 1 / dir.y, 1 / dir.z);
+
+		Real entry;
+		if (!rayBoxEntry(mNodes[0].minimum, mNodes[0].maximum, origin, invDir, maxDistance, entry))
+			return false;
+
+		Real closest = maxDistance;
+		const Triangle* closestTri = 0;
+		Real closestU = 0, closestV = 0;
+
+		uint32 stack[MAX_TREE_DEPTH + 1];
+		size_t stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize)
+		{
+			const Node& node = mNodes[stack[--stackSize]];
+			if (node.count)
+			{
+				for (uint32 i = node.first; i < node.first + node.count; ++i)
+				{
+					// Moller-Trumbore, either side of the triangle
+					const Triangle& tri = mTriangles[i];
+					Vector3 p = dir.crossProduct(tri.edge2);
+					Real det = tri.edge1.dotProduct(p);
+					if (det == 0)
+						continue;
+					Real invDet = 1 / det;
+					Vector3 s = origin - tri.v0;
+					Real u = s.dotProduct(p) * invDet;
+					if (u < 0 || u > 1)
+						continue;
+					Vector3 q = s.crossProduct(tri.edge1);
+					Real v = dir.dotProduct(q) * invDet;
+					if (v < 0 || u + v > 1)
+						continue;
+					Real t = tri.edge2.dotProduct(q) * invDet;
+					if (t >= 0 && t < closest)
+					{
+						closest = t;
+						closestTri = &tri;
+						closestU = u;
+						closestV = v;
+					}
+				}
+			}
+			else
+			{
+				// Visit the nearest child first, the other one may then be culled
+				const Node& child1 = mNodes[node.first];
+				const Node& child2 = mNodes[node.first + 1];
+				Real entry1, entry2;
+				bool hit1 = rayBoxEntry(child1.minimum, child1.maximum, origin, invDir, closest, entry1);
+				bool hit2 = rayBoxEntry(child2.minimum, child2.maximum, origin, invDir, closest, entry2);
+				if (hit1 && hit2)
+				{
+					if (entry1 <= entry2)
+					{
+						stack[stackSize++] = node.first + 1;
+						stack[stackSize++] = node.first;
+					}
+					else
+					{
+						stack[stackSize++] = node.first;
+						stack[stackSize++] = node.first + 1;
+					}
+				}
+				else if (hit1)
+				{
+					stack[stackSize++] = node.first;
+				}
+				else if (hit2)
+				{
+					stack[stackSize++] = node.first + 1;
+				}
+			}
+		}
+
+		if (!closestTri)
+			return false;
+
+		hit.distance = closest;
+		hit.subMeshIndex = closestTri->subMeshIndex;
+		hit.triangleIndex = closestTri->triangleIndex;
+		hit.u = closestU;
+		hit.v = closestV;
+		return true;
+	}
+	//---------------------------------------------------------------------
+	AxisAlignedBox TriangleBVH::getBounds(void) const
+	{
+		if (mNodes.empty())
+			return AxisAlignedBox::BOX_NULL;
+		return AxisAlignedBox(mNodes[0].minimum, mNodes[0].maximum);
+	}
+	//---------------------------------------------------------------------
+	size_t TriangleBVH::getMemoryUsage(void) const
+	{
+		return mNodes.capacity() * sizeof(Node) + mTriangles.capacity() * sizeof(Triangle);
+	}
+}
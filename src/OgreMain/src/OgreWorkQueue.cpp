@@ -32,6 +32,254 @@ THE SOFTWARE.
 #include "OgreRenderSystem.h"
 
 namespace Ogre {
+
+	namespace
+	{
+		/// Shared by the caller of a parallelFor and its helper requests
+		struct ParallelForState
+		{
+			WorkQueue::ParallelTask* task;
+			size_t count;
+			size_t grainSize;
+			/// Start of the next range to hand out, may run past count
+			AtomicScalar<size_t> next;
+			/// Threads taking ranges right now
+			AtomicScalar<size_t> running;
+			AtomicScalar<uint32> failed;
+			String failure;
+			OGRE_MUTEX(mutex)
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+			OGRE_THREAD_SYNCHRONISER(finished)
+#endif
+
+			ParallelForState(WorkQueue::ParallelTask* t, size_t n, size_t grain)
+				: task(t), count(n), grainSize(grain), next(0), running(0), failed(0) {}
+
+			/// Run ranges until none are left. The task is only touched for a 
+			/// range taken here, so late helpers never use it once the caller
+			/// has returned.
+			void runRanges()
+			{
+				while (true)
+				{
+					size_t end = (next += grainSize);
+					size_t begin = end - grainSize;
+					if (begin >= count)
+						break;
+					task->execute(begin, std::min(end, count));
+				}
+			}
+
+			/// Stop handing out ranges
+			void abandon() { next += count; }
+		};
+		typedef SharedPtr<ParallelForState> ParallelForStatePtr;
+
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+		/// Counts a helper as running for its lifetime, however it leaves
+		struct ParallelForHelperScope
+		{
+			ParallelForState& state;
+
+			ParallelForHelperScope(ParallelForState& s) : state(s) { state.running += 1; }
+			~ParallelForHelperScope()
+			{
+				if (state.running += static_cast<size_t>(-1))
+					return;
+				// the last one out wakes the caller
+				OGRE_LOCK_MUTEX(state.mutex)
+				OGRE_THREAD_NOTIFY_ALL(state.finished)
+			}
+		};
+#endif
+
+		/// Needed to hold the state in an Any
+		std::ostream& operator<<(std::ostream& o, const ParallelForStatePtr& s)
+		{
+			return o;
+		}
+
+		/** A read waiting in the queue. The queue deletes requests it never gets
+			to, so the read is completed, without reading, once the last copy 
+			goes unless a worker got to it first.
+		*/
+		struct PendingRead
+		{
+			AsyncReadRequestPtr request;
+
+			PendingRead(const AsyncReadRequestPtr& r) : request(r) {}
+			~PendingRead()
+			{
+				if (!request->isComplete())
+					request->_notifyComplete(0);
+			}
+		};
+		typedef SharedPtr<PendingRead> PendingReadPtr;
+
+		/// Needed to hold the read in an Any
+		std::ostream& operator<<(std::ostream& o, const PendingReadPtr& r)
+		{
+			return o;
+		}
+	}
+	//---------------------------------------------------------------------
+	void WorkQueue::parallelFor(ParallelTask& task, size_t count, size_t grainSize)
+	{
+		grainSize = std::max<size_t>(grainSize, 1);
+		size_t numRanges = (count + grainSize - 1) / grainSize;
+		size_t numHelpers = std::min(getParallelWorkerCount(), numRanges ? numRanges - 1 : 0);
+		if (mMaxParallelism)
+			numHelpers = std::min(numHelpers, mMaxParallelism - 1);
+
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+		if (numHelpers)
+		{
+			{
+				OGRE_LOCK_MUTEX(mChannelMapMutex)
+				if (!mParallelForRegistered)
+				{
+					mParallelForChannel = getChannel("Ogre/ParallelFor");
+					addRequestHandler(mParallelForChannel, &mParallelForHandler);
+					mParallelForRegistered = true;
+				}
+			}
+
+			ParallelForStatePtr state(OGRE_NEW_T(ParallelForState, MEMCATEGORY_GENERAL)(
+				&task, count, grainSize), SPFM_DELETE_T);
+			for (size_t i = 0; i < numHelpers; ++i)
+				addRequest(mParallelForChannel, 0, Any(state));
+
+			state->running += 1;
+			try
+			{
+				state->runRanges();
+			}
+			catch (...)
+			{
+				// Helpers may still be in the task, which is about to go away
+				state->abandon();
+				state->running += static_cast<size_t>(-1);
+				OGRE_LOCK_MUTEX_NAMED(state->mutex, lock)
+				while (state->running.get())
+					OGRE_THREAD_WAIT(state->finished, state->mutex, lock);
+				throw;
+			}
+			state->running += static_cast<size_t>(-1);
+
+			{
+				OGRE_LOCK_MUTEX_NAMED(state->mutex, lock)
+				while (state->running.get())
+					OGRE_THREAD_WAIT(state->finished, state->mutex, lock);
+			}
+			if (state->failed.get())
+			{
+				OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+					"A parallel task failed on a worker thread: " + state->failure,
+					"WorkQueue::parallelFor");
+			}
+			return;
+		}
+#endif
+		if (count)
+			task.execute(0, count);
+	}
+	//---------------------------------------------------------------------
+	WorkQueue::Response* WorkQueue::ParallelForHandler::handleRequest(const Request* req, const WorkQueue* srcQ)
+	{
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+		ParallelForStatePtr state = any_cast<ParallelForStatePtr>(req->getData());
+		ParallelForHelperScope scope(*state);
+		try
+		{
+			state->runRanges();
+		}
+		catch (Exception& e)
+		{
+			state->abandon();
+			OGRE_LOCK_MUTEX(state->mutex)
+			state->failure = e.getFullDescription();
+			state->failed.set(1);
+		}
+		catch (std::exception& e)
+		{
+			state->abandon();
+			OGRE_LOCK_MUTEX(state->mutex)
+			state->failure = e.what();
+			state->failed.set(1);
+		}
+		catch (...)
+		{
+			state->abandon();
+			OGRE_LOCK_MUTEX(state->mutex)
+			state->failure = "unknown exception";
+			state->failed.set(1);
+		}
+#endif
+		return OGRE_NEW Response(req, true, Any());
+	}
+	//---------------------------------------------------------------------
+	void WorkQueue::defaultParallelFor(ParallelTask& task, size_t count, size_t grainSize)
+	{
+		Root* root = Root::getSingletonPtr();
+		if (root && root->getWorkQueue())
+			root->getWorkQueue()->parallelFor(task, count, grainSize);
+		else if (count)
+			task.execute(0, count);
+	}
+	//---------------------------------------------------------------------
+	bool WorkQueue::readAsync(const AsyncReadRequestPtr& request)
+	{
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+		if (!getParallelWorkerCount())
+			return false;
+
+		{
+			OGRE_LOCK_MUTEX(mChannelMapMutex)
+			if (!mAsyncReadRegistered)
+			{
+				mAsyncReadChannel = getChannel("Ogre/AsyncRead");
+				addRequestHandler(mAsyncReadChannel, &mAsyncReadHandler);
+				mAsyncReadRegistered = true;
+			}
+		}
+
+		PendingReadPtr read(OGRE_NEW_T(PendingRead, MEMCATEGORY_GENERAL)(request), SPFM_DELETE_T);
+		addRequest(mAsyncReadChannel, 0, Any(read));
+		return true;
+#else
+		return false;
+#endif
+	}
+	//---------------------------------------------------------------------
+	WorkQueue::Response* WorkQueue::AsyncReadHandler::handleRequest(const Request* req, const WorkQueue* srcQ)
+	{
+		PendingReadPtr read = any_cast<PendingReadPtr>(req->getData());
+		const AsyncReadRequestPtr& request = read->request;
+		size_t bytesRead = 0;
+		if (!req->getAborted())
+		{
+			try
+			{
+				bytesRead = request->getStream()->_readAt(
+					request->getBuffer(), request->getOffset(), request->getCount());
+			}
+			catch (...)
+			{
+				bytesRead = 0;
+			}
+		}
+		request->_notifyComplete(bytesRead);
+		return OGRE_NEW Response(req, true, Any());
+	}
+	//---------------------------------------------------------------------
+	void WorkQueue::defaultReadAsync(const AsyncReadRequestPtr& request)
+	{
+		Root* root = Root::getSingletonPtr();
+		if (root && root->getWorkQueue() && root->getWorkQueue()->readAsync(request))
+			return;
+		request->_notifyComplete(request->getStream()->_readAt(
+			request->getBuffer(), request->getOffset(), request->getCount()));
+	}
 	//---------------------------------------------------------------------
 	uint16 WorkQueue::getChannel(const String& channelName)
 	{
@@ -97,6 +345,15 @@ namespace Ogre {
 		mWorkerThreadCount = c;
 	}
 	//---------------------------------------------------------------------
+	size_t DefaultWorkQueueBase::getParallelWorkerCount() const
+	{
+#if OGRE_THREAD_SUPPORT
+		return mIsRunning && !mPaused && !mShuttingDown ? mWorkerThreadCount : 0;
+#else
+		return 0;
+#endif
+	}
+	//---------------------------------------------------------------------
 	bool DefaultWorkQueueBase::getWorkersCanAccessRenderSystem() const
 	{
 		return mWorkerRenderSystemAccess;
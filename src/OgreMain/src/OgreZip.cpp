@@ -36,10 +36,171 @@ THE SOFTWARE.
 
 #include <zzip/zzip.h>
 #include <zzip/plugin.h>
+#include <zlib.h>
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#	define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#  define OGRE_ZIP_MAP_WIN32
+#elif OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+    OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS || \
+    OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || \
+    OGRE_PLATFORM == OGRE_PLATFORM_BLACKBERRY
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  define OGRE_ZIP_MAP_POSIX
+#endif
 
 
 namespace Ogre {
 
+    /** Read-only view of a whole archive file in memory.
+    @remarks
+        Memory mapped where the platform allows it, read in otherwise. Streams
+        of stored entries point straight into it and hold a reference, so it 
+        stays valid for as long as they do, even if the archive is unloaded.
+    */
+    class ZipMapping : public ArchiveAlloc
+    {
+    public:
+        ZipMapping(const String& filename) : mData(0), mSize(0)
+        {
+#if defined(OGRE_ZIP_MAP_WIN32)
+            HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, 
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+            if (file != INVALID_HANDLE_VALUE)
+            {
+                mSize = static_cast<size_t>(GetFileSize(file, 0));
+                HANDLE mapping = mSize ? CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0) : 0;
+                if (mapping)
+                {
+                    mData = static_cast<uchar*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    // The view keeps the file open
+                    CloseHandle(mapping);
+                }
+                CloseHandle(file);
+            }
+#elif defined(OGRE_ZIP_MAP_POSIX)
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd != -1)
+            {
+                struct stat st;
+                if (fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    mSize = static_cast<size_t>(st.st_size);
+                    void* data = mmap(0, mSize, PROT_READ, MAP_SHARED, fd, 0);
+                    mData = (data == MAP_FAILED) ? 0 : static_cast<uchar*>(data);
+                }
+                // The mapping keeps the file open
+                ::close(fd);
+            }
+#else
+            std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+            if (file)
+            {
+                file.seekg(0, std::ios::end);
+                mSize = static_cast<size_t>(file.tellg());
+                file.seekg(0, std::ios::beg);
+                if (mSize)
+                {
+                    mData = OGRE_ALLOC_T(uchar, mSize, MEMCATEGORY_GENERAL);
+                    if (!file.read(reinterpret_cast<char*>(mData), mSize))
+                    {
+                        OGRE_FREE(mData, MEMCATEGORY_GENERAL);
+                        mData = 0;
+                    }
+                }
+            }
+#endif
+            if (!mData)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+                    filename + " - error whilst opening archive: Unable to read zip file.",
+                    "ZipMapping::ZipMapping");
+            }
+        }
+
+        ~ZipMapping()
+        {
+#if defined(OGRE_ZIP_MAP_WIN32)
+            UnmapViewOfFile(mData);
+#elif defined(OGRE_ZIP_MAP_POSIX)
+            munmap(mData, mSize);
+#else
+            OGRE_FREE(mData, MEMCATEGORY_GENERAL);
+#endif
+        }
+
+        const uchar* getData(void) const { return mData; }
+        size_t getSize(void) const { return mSize; }
+
+        /// Hints that a range of the archive will be read soon
+        void willNeed(size_t offset, size_t size) const
+        {
+#if defined(OGRE_ZIP_MAP_POSIX)
+            if (offset >= mSize)
+                return;
+            // madvise wants a page aligned start
+            size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            size_t start = offset - offset % pageSize;
+            size_t end = std::min(mSize, offset + size);
+            madvise(mData + start, end - start, MADV_WILLNEED);
+#else
+            (void)offset;
+            (void)size;
+#endif
+        }
+
+    private:
+        uchar* mData;
+        size_t mSize;
+    };
+    //-----------------------------------------------------------------------
+    /// Stream over a stored entry, reading straight from the mapped archive
+    class ZipMappedDataStream : public MemoryDataStream
+    {
+    public:
+        ZipMappedDataStream(const String& name, const SharedPtr<ZipMapping>& mapping, 
+            const uchar* data, size_t size)
+            : MemoryDataStream(name, const_cast<uchar*>(data), size, false, true)
+            , mMapping(mapping)
+        {
+        }
+    protected:
+        SharedPtr<ZipMapping> mMapping;
+    };
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        // Zip records are little endian and unaligned
+        uint16 readZipUint16(const uchar* p)
+        {
+            return static_cast<uint16>(p[0] | (p[1] << 8));
+        }
+
+        uint32 readZipUint32(const uchar* p)
+        {
+            return static_cast<uint32>(p[0]) | (static_cast<uint32>(p[1]) << 8) |
+                (static_cast<uint32>(p[2]) << 16) | (static_cast<uint32>(p[3]) << 24);
+        }
+
+        const uint32 ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+        const uint32 ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+        const uint32 ZIP_END_OF_DIR_SIGNATURE = 0x06054b50;
+        const uint32 ZIP64_END_OF_DIR_LOCATOR_SIGNATURE = 0x07064b50;
+        const size_t ZIP64_END_OF_DIR_LOCATOR_SIZE = 20;
+        const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+        const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+        const size_t ZIP_END_OF_DIR_SIZE = 22;
+        const uint16 ZIP_METHOD_STORED = 0;
+        const uint16 ZIP_METHOD_DEFLATED = 8;
+        const uint16 ZIP_FLAG_ENCRYPTED = 1;
+    }
+
     /// Utility method to format out zzip errors
     String getZzipErrorDescription(zzip_error_t zzipError) 
     {
@@ -84,7 +245,12 @@ namespace Ogre {
     void ZipArchive::load()
     {
 		OGRE_LOCK_AUTO_MUTEX
-        if (!mZzipDir)
+        if (!mPluginIo)
+        {
+            if (mMapping.isNull())
+                loadNative();
+        }
+        else if (!mZzipDir)
         {
             zzip_error_t zzipError;
             mZzipDir = zzip_dir_open_ext_io(mName.c_str(), &zzipError, 0, mPluginIo);
@@ -128,11 +294,215 @@ namespace Ogre {
             mZzipDir = 0;
             mFileList.clear();
         }
+        if (!mMapping.isNull())
+        {
+            // Streams still open on stored entries keep their own reference
+            mMapping.setNull();
+            mEntries.clear();
+            mEntryIndex.clear();
+            mFileList.clear();
+        }
     
     }
+    //-----------------------------------------------------------------------
+    void ZipArchive::loadNative(void)
+    {
+        SharedPtr<ZipMapping> mapping(OGRE_NEW ZipMapping(mName));
+        const uchar* data = mapping->getData();
+        const size_t size = mapping->getSize();
+        const String corrupted = mName + " - error whilst opening archive: Corrupted archive.";
+
+        // The end of central directory record is followed by at most 64k of comment
+        size_t endOfDir = size_t(-1);
+        if (size >= ZIP_END_OF_DIR_SIZE)
+        {
+            size_t minPos = size > ZIP_END_OF_DIR_SIZE + 0xFFFF ? size - ZIP_END_OF_DIR_SIZE - 0xFFFF : 0;
+            for (size_t pos = size - ZIP_END_OF_DIR_SIZE + 1; pos-- > minPos; )
+            {
+                if (readZipUint32(data + pos) == ZIP_END_OF_DIR_SIGNATURE)
+                {
+                    endOfDir = pos;
+                    break;
+                }
+            }
+        }
+        if (endOfDir == size_t(-1))
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, corrupted, "ZipArchive::load");
+
+        const uint16 numEntries = readZipUint16(data + endOfDir + 10);
+        const uint32 dirSize = readZipUint32(data + endOfDir + 12);
+        const uint32 dirOffset = readZipUint32(data + endOfDir + 16);
+        // A plain archive may hold exactly 0xFFFF entries, only the locator 
+        // in front of the end of central directory tells Zip64 apart
+        if (endOfDir >= ZIP64_END_OF_DIR_LOCATOR_SIZE && 
+            readZipUint32(data + endOfDir - ZIP64_END_OF_DIR_LOCATOR_SIZE) == ZIP64_END_OF_DIR_LOCATOR_SIGNATURE)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, 
+                mName + " - error whilst opening archive: Zip64 archives are not supported.",
+                "ZipArchive::load");
+        }
+        if (static_cast<size_t>(dirOffset) + dirSize > endOfDir)
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, corrupted, "ZipArchive::load");
+
+        ZipEntryList entries;
+        entries.reserve(numEntries);
+        size_t pos = dirOffset;
+        for (uint16 i = 0; i < numEntries; ++i)
+        {
+            const uchar* header = data + pos;
+            if (pos + ZIP_CENTRAL_HEADER_SIZE > endOfDir || 
+                readZipUint32(header) != ZIP_CENTRAL_HEADER_SIGNATURE)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, corrupted, "ZipArchive::load");
+            }
+            const size_t nameLength = readZipUint16(header + 28);
+            const size_t nextPos = pos + ZIP_CENTRAL_HEADER_SIZE + nameLength + 
+                readZipUint16(header + 30) + readZipUint16(header + 32);
+            if (nextPos > endOfDir)
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, corrupted, "ZipArchive::load");
+
+            ZipEntry entry;
+            entry.filename.assign(reinterpret_cast<const char*>(header + ZIP_CENTRAL_HEADER_SIZE), nameLength);
+            entry.flags = readZipUint16(header + 8);
+            entry.method = readZipUint16(header + 10);
+            entry.compressedSize = readZipUint32(header + 20);
+            entry.uncompressedSize = readZipUint32(header + 24);
+            entry.localHeaderOffset = readZipUint32(header + 42);
+            entries.push_back(entry);
+            pos = nextPos;
+        }
+
+        // Everything parsed, so commit
+        mMapping = mapping;
+        mEntries.swap(entries);
+        for (size_t i = 0; i < mEntries.size(); ++i)
+        {
+            const ZipEntry& entry = mEntries[i];
+            FileInfo info;
+            info.archive = this;
+            StringUtil::splitFilename(entry.filename, info.basename, info.path);
+            info.filename = entry.filename;
+            info.compressedSize = entry.compressedSize;
+            info.uncompressedSize = entry.uncompressedSize;
+            // folder entries, as zziplib reports them
+            if (info.basename.empty())
+            {
+                info.filename = info.filename.substr (0, info.filename.length () - 1);
+                StringUtil::splitFilename(info.filename, info.basename, info.path);
+                info.compressedSize = size_t (-1);
+            }
+            else
+            {
+                String key = entry.filename;
+                StringUtil::toLowerCase(key);
+                mEntryIndex.insert(ZipEntryIndex::value_type(key, i));
+            }
+            mFileList.push_back(info);
+        }
+    }
+    //-----------------------------------------------------------------------
+    const ZipArchive::ZipEntry* ZipArchive::findEntry(const String& filename) const
+    {
+        String key = filename;
+        StringUtil::toLowerCase(key);
+        ZipEntryIndex::const_iterator i = mEntryIndex.find(key);
+        if (i != mEntryIndex.end())
+            return &mEntries[i->second];
+
+        // Try if we find the file; if there are more with the same name open none
+        const FileInfoListPtr fileNfo = findFileInfo(filename, true);
+        if (fileNfo->size() == 1)
+        {
+            key = fileNfo->at(0).filename;
+            StringUtil::toLowerCase(key);
+            i = mEntryIndex.find(key);
+            if (i != mEntryIndex.end())
+                return &mEntries[i->second];
+        }
+        return 0;
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr ZipArchive::openNative(const String& filename) const
+    {
+        const ZipEntry* entry = findEntry(filename);
+        if (!entry)
+        {
+            LogManager::getSingleton().logMessage(
+                mName + " - Unable to open file " + filename + ", error was 'Unknown error.'");
+            return DataStreamPtr();
+        }
+
+        const uchar* data = mMapping->getData();
+        const size_t size = mMapping->getSize();
+        const size_t headerPos = entry->localHeaderOffset;
+        String error;
+        size_t dataPos = 0;
+        if (headerPos + ZIP_LOCAL_HEADER_SIZE > size || 
+            readZipUint32(data + headerPos) != ZIP_LOCAL_HEADER_SIGNATURE)
+        {
+            error = "Corrupted archive.";
+        }
+        else
+        {
+            dataPos = headerPos + ZIP_LOCAL_HEADER_SIZE + 
+                readZipUint16(data + headerPos + 26) + readZipUint16(data + headerPos + 28);
+            // stored data is mapped as is, so both sizes must cover the same bytes
+            if (dataPos + entry->compressedSize > size ||
+                (entry->method == ZIP_METHOD_STORED && entry->compressedSize != entry->uncompressedSize))
+                error = "Corrupted archive.";
+            else if (entry->flags & ZIP_FLAG_ENCRYPTED)
+                error = "Encrypted entries are not supported.";
+        }
+
+        if (error.empty())
+        {
+            if (entry->method == ZIP_METHOD_STORED)
+            {
+                return DataStreamPtr(OGRE_NEW ZipMappedDataStream(entry->filename, mMapping, 
+                    data + dataPos, entry->uncompressedSize));
+            }
+            else if (entry->method == ZIP_METHOD_DEFLATED)
+            {
+                // Inflate state is local, so threads can open entries concurrently
+                uchar* buffer = OGRE_ALLOC_T(uchar, std::max<size_t>(entry->uncompressedSize, 1), 
+                    MEMCATEGORY_GENERAL);
+                z_stream zs;
+                memset(&zs, 0, sizeof(zs));
+                zs.next_in = const_cast<Bytef*>(data + dataPos);
+                zs.avail_in = static_cast<uInt>(entry->compressedSize);
+                zs.next_out = buffer;
+                zs.avail_out = static_cast<uInt>(entry->uncompressedSize);
+                int ret = inflateInit2(&zs, -MAX_WBITS);
+                if (ret == Z_OK)
+                {
+                    ret = inflate(&zs, Z_FINISH);
+                    inflateEnd(&zs);
+                }
+                if (ret == Z_STREAM_END && zs.total_out == entry->uncompressedSize)
+                {
+                    return DataStreamPtr(OGRE_NEW MemoryDataStream(entry->filename, buffer, 
+                        entry->uncompressedSize, true, true));
+                }
+                OGRE_FREE(buffer, MEMCATEGORY_GENERAL);
+                error = "Corrupted archive.";
+            }
+            else
+            {
+                error = "Unsupported compression format.";
+            }
+        }
+
+        LogManager::getSingleton().logMessage(
+            mName + " - Unable to open file " + entry->filename + ", error was '" + error + "'");
+        return DataStreamPtr();
+    }
     //-----------------------------------------------------------------------
 	DataStreamPtr ZipArchive::open(const String& filename, bool readOnly) const
     {
+		// The native index is read-only once loaded, no need to lock
+		if (!mMapping.isNull())
+			return openNative(filename);
+
 		// zziplib is not threadsafe
 		OGRE_LOCK_AUTO_MUTEX
         String lookUpFileName = filename;
@@ -255,6 +625,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
 	bool ZipArchive::exists(const String& filename)
 	{
+		if (!mMapping.isNull())
+		{
+			String key = filename;
+			StringUtil::toLowerCase(key);
+			return mEntryIndex.find(key) != mEntryIndex.end();
+		}
+
 		// zziplib is not threadsafe
 		OGRE_LOCK_AUTO_MUTEX
 		ZZIP_STAT zstat;
@@ -282,6 +659,27 @@ namespace Ogre {
 
 	}
 	//-----------------------------------------------------------------------
+	void ZipArchive::prefetch(const StringVector& filenames)
+	{
+		if (mMapping.isNull())
+			return;
+		for (StringVector::const_iterator i = filenames.begin(); i != filenames.end(); ++i)
+		{
+			const ZipEntry* entry = findEntry(*i);
+			// The local header ahead of the data is 30 bytes plus the name
+			// and an extra field of unknown length
+			if (entry)
+				mMapping->willNeed(entry->localHeaderOffset, 
+					entry->compressedSize + 30 + entry->filename.size() + 1024);
+		}
+	}
+	//-----------------------------------------------------------------------
+	uint64 ZipArchive::getStorageOrder(const String& filename)
+	{
+		const ZipEntry* entry = mMapping.isNull() ? 0 : findEntry(filename);
+		return entry ? static_cast<uint64>(entry->localHeaderOffset) : 0;
+	}
+	//-----------------------------------------------------------------------
     void ZipArchive::checkZzipError(int zzipError, const String& operation) const
     {
         if (zzipError != ZZIP_NO_ERROR)
@@ -0,0 +1,96 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHNode_H__
+#define __BVHNode_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneNode.h"
+#include "OgreBVHTree.h"
+
+namespace Ogre
+{
+	/** \addtogroup Plugins
+	*  @{
+	*/
+	/** \addtogroup BVHSceneManager
+	*  @{
+	*/
+	/** SceneNode living in the BVHTree of a BVHSceneManager.
+	@remarks
+		Like OctreeNode, the world bounds of this node only cover its own
+		attached objects, not its children, since each node is a separate
+		proxy of the tree.
+	*/
+	class _OgreBVHPluginExport BVHNode : public SceneNode
+	{
+	public:
+		BVHNode(SceneManager* creator);
+		BVHNode(SceneManager* creator, const String& name);
+		~BVHNode();
+
+		/** Overridden from Node to remove the proxies of the subtree */
+		Node* removeChild(unsigned short index);
+		/** Overridden from Node to remove the proxies of the subtree */
+		Node* removeChild(const String& name);
+		/** Overridden from Node to remove the proxies of the subtree */
+		Node* removeChild(Node* child);
+		/** Overridden from Node to remove the proxies of the subtree */
+		void removeAllChildren(void);
+
+		/** Adds the attached objects of this node to the render queue */
+		void _addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+			VisibleObjectsBoundsInfo* visibleBounds);
+
+		/** Gets the proxy of this node in the tree, or BVHTree::NULL_PROXY */
+		BVHTree::ProxyId _getProxy(void) const { return mProxy; }
+		/** Sets the proxy of this node in the tree, for use by BVHSceneManager */
+		void _setProxy(BVHTree::ProxyId proxy) { mProxy = proxy; }
+		/** Gets the world bounds centre at the last tree update */
+		const Vector3& _getLastCentre(void) const { return mLastCentre; }
+		/** Sets the world bounds centre at the last tree update */
+		void _setLastCentre(const Vector3& centre) { mLastCentre = centre; }
+		/** Tells whether the node is kept out of the tree because its bounds are infinite */
+		bool _isInfinite(void) const { return mInfinite; }
+		/** Sets whether the node is kept out of the tree because its bounds are infinite */
+		void _setInfinite(bool infinite) { mInfinite = infinite; }
+
+	protected:
+		/** Updates the bounds from the attached objects only, then the tree. */
+		void _updateBounds(void);
+
+		void _removeNodeAndChildren(void);
+
+		BVHTree::ProxyId mProxy;
+		Vector3 mLastCentre;
+		bool mInfinite;
+	};
+	/** @} */
+	/** @} */
+}
+
+#endif
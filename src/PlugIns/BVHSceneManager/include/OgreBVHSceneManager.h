@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHSceneManager_H__
+#define __BVHSceneManager_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneManager.h"
+#include "OgreBVHTree.h"
+
+namespace Ogre
+{
+	/** \addtogroup Plugins
+	*  @{
+	*/
+	/** \addtogroup BVHSceneManager
+	*  @{
+	*/
+	/** SceneManager keeping its nodes in a dynamic bounding volume hierarchy.
+	@remarks
+		Every BVHNode with attached objects is a proxy of a BVHTree, which is
+		refitted incrementally as nodes move. Nodes only moving a little inside
+		their fattened box don't touch the tree, so scenes with many moving
+		objects are cheap to update, and there is no world size to set up front.
+		The tree is used to find visible objects and by all the scene queries.
+	@par
+		Options are:
+		"FatMargin", Real *; absolute distance by which proxy boxes are fattened.
+		"RelativeFatMargin", Real *; fraction of their size by which proxy boxes are fattened.
+		"DisplacementMultiplier", Real *; how many frames of motion a proxy box is stretched by.
+		"TreeHeight", int * (read only).
+		"ProxyCount", size_t * (read only).
+	*/
+	class _OgreBVHPluginExport BVHSceneManager : public SceneManager
+	{
+	public:
+		typedef list<SceneNode*>::type SceneNodeList;
+		typedef vector<std::pair<SceneNode*, SceneNode*> >::type SceneNodePairList;
+
+		BVHSceneManager(const String& name);
+		~BVHSceneManager();
+
+		/// @copydoc SceneManager::getTypeName
+		const String& getTypeName(void) const;
+
+		/// @copydoc SceneManager::destroySceneNode
+		void destroySceneNode(const String& name);
+		/// @copydoc SceneManager::destroySceneNode(const SlotHandle&)
+		void destroySceneNode(const SlotHandle& handle);
+		/// @copydoc SceneManager::clearScene
+		void clearScene(void);
+
+		/** Walks the tree, adding the visible nodes to the render queue */
+		void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+			bool onlyShadowCasters);
+
+		/** Adds the node to the tree, or updates its proxy if it's already there */
+		void _updateBVHNode(BVHNode* node);
+		/** Removes the node from the tree */
+		void _removeBVHNode(BVHNode* node);
+
+		/** Adds the nodes whose world bounds intersect the box to the list */
+		void findNodesIn(const AxisAlignedBox& box, SceneNodeList& list, SceneNode* exclude = 0);
+		/** Adds the nodes whose world bounds intersect the sphere to the list */
+		void findNodesIn(const Sphere& sphere, SceneNodeList& list, SceneNode* exclude = 0);
+		/** Adds the nodes whose world bounds intersect the volume to the list */
+		void findNodesIn(const PlaneBoundedVolume& volume, SceneNodeList& list, SceneNode* exclude = 0);
+		/** Adds the nodes whose world bounds intersect the ray to the list */
+		void findNodesIn(const Ray& ray, SceneNodeList& list, SceneNode* exclude = 0);
+		/** Adds every pair of distinct nodes whose world bounds intersect to the list */
+		void findIntersectingNodes(SceneNodePairList& pairs);
+
+		/** Gets the tree holding the nodes */
+		const BVHTree& getTree(void) const { return mTree; }
+
+		/// @copydoc SceneManager::setOption
+		bool setOption(const String& key, const void* val);
+		/// @copydoc SceneManager::getOption
+		bool getOption(const String& key, void* val);
+		/// @copydoc SceneManager::getOptionKeys
+		bool getOptionKeys(StringVector& refKeys);
+
+		AxisAlignedBoxSceneQuery* createAABBQuery(const AxisAlignedBox& box, unsigned long mask);
+		SphereSceneQuery* createSphereQuery(const Sphere& sphere, unsigned long mask);
+		PlaneBoundedVolumeListSceneQuery* createPlaneBoundedVolumeQuery(
+			const PlaneBoundedVolumeList& volumes, unsigned long mask);
+		RaySceneQuery* createRayQuery(const Ray& ray, unsigned long mask);
+		IntersectionSceneQuery* createIntersectionQuery(unsigned long mask);
+
+	protected:
+		typedef set<BVHNode*>::type BVHNodeSet;
+
+		/// Proxies of the nodes with finite bounds
+		BVHTree mTree;
+		/// Nodes with infinite bounds, which intersect everything
+		BVHNodeSet mInfiniteNodes;
+
+		SceneNode* createSceneNodeImpl(void);
+		SceneNode* createSceneNodeImpl(const String& name);
+	};
+
+	/// Factory for BVHSceneManager
+	class BVHSceneManagerFactory : public SceneManagerFactory
+	{
+	protected:
+		void initMetaData(void) const;
+	public:
+		BVHSceneManagerFactory() {}
+		~BVHSceneManagerFactory() {}
+		/// Factory type name
+		static const String FACTORY_TYPE_NAME;
+		SceneManager* createInstance(const String& instanceName);
+		void destroyInstance(SceneManager* instance);
+	};
+	/** @} */
+	/** @} */
+}
+
+#endif
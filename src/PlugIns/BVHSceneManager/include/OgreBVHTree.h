@@ -0,0 +1,227 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHTree_H__
+#define __BVHTree_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre
+{
+	/** \addtogroup Plugins
+	*  @{
+	*/
+	/** \addtogroup BVHSceneManager
+	*  @{
+	*/
+	/** Dynamic bounding volume hierarchy of axis aligned boxes.
+	@remarks
+		Each leaf of the tree, called a proxy, stores a box that is fattened
+		by a margin around the real bounds of its user. Users moving a little
+		then don't need to touch the tree at all; only when the real bounds
+		leave the fat box is the proxy removed and inserted again.
+	@par
+		Insertion picks the sibling which grows the surface area of the tree
+		the least, and the tree is rebalanced with rotations on the way back up,
+		so its height stays logarithmic whatever the insertion order.
+	*/
+	class _OgreBVHPluginExport BVHTree : public NodeAlloc
+	{
+	public:
+		/// Identifies a proxy of the tree
+		typedef int ProxyId;
+		/// Value of ProxyId which doesn't refer to any proxy
+		static const ProxyId NULL_PROXY = -1;
+
+		/// Result of testing a volume against the box of a tree node, @see walk
+		enum Containment
+		{
+			/// The box is entirely outside the volume
+			CONTAIN_NONE,
+			/// The box is partially inside the volume
+			CONTAIN_PARTIAL,
+			/// The box is entirely inside the volume, so are all of its proxies
+			CONTAIN_FULL
+		};
+
+		BVHTree();
+		~BVHTree();
+
+		/** Adds a proxy to the tree.
+		@param box Real bounds of the proxy, which must be finite
+		@param userData Returned by getUserData and passed to the walk visitors
+		*/
+		ProxyId createProxy(const AxisAlignedBox& box, void* userData);
+		/** Removes a proxy from the tree. */
+		void destroyProxy(ProxyId id);
+		/** Updates the bounds of a proxy.
+		@param box New real bounds of the proxy
+		@param displacement How far the proxy moved since the last update, used to
+			stretch the fat box in the direction of motion
+		@return true if the proxy had to be moved in the tree
+		*/
+		bool moveProxy(ProxyId id, const AxisAlignedBox& box, const Vector3& displacement);
+		/** Gets the user data given to createProxy. */
+		void* getUserData(ProxyId id) const
+		{
+			assert(id >= 0 && id < (ProxyId)mNodes.size() && mNodes[id].isLeaf());
+			return mNodes[id].userData;
+		}
+		/** Gets the fattened box stored for a proxy. */
+		AxisAlignedBox getFatBox(ProxyId id) const;
+		/** Removes all proxies. */
+		void clear();
+
+		/** Sets the absolute distance by which proxy boxes are fattened. */
+		void setMargin(Real margin) { mMargin = margin; }
+		/** Gets the absolute distance by which proxy boxes are fattened. */
+		Real getMargin() const { return mMargin; }
+		/** Sets the fraction of their size by which proxy boxes are fattened. */
+		void setRelativeMargin(Real margin) { mRelativeMargin = margin; }
+		/** Gets the fraction of their size by which proxy boxes are fattened. */
+		Real getRelativeMargin() const { return mRelativeMargin; }
+		/** Sets how many times the last displacement of a proxy its box is stretched by. */
+		void setDisplacementMultiplier(Real multiplier) { mDisplacementMultiplier = multiplier; }
+		/** Gets how many times the last displacement of a proxy its box is stretched by. */
+		Real getDisplacementMultiplier() const { return mDisplacementMultiplier; }
+
+		/** Gets the number of proxies in the tree. */
+		size_t getProxyCount() const { return mProxyCount; }
+		/** Gets the height of the tree, 0 for a single proxy or an empty tree. */
+		int getHeight() const { return mRoot == NULL_PROXY ? 0 : mNodes[mRoot].height; }
+		/** Gets the largest index a proxy may have, useful to size lookup tables. */
+		size_t getProxyCapacity() const { return mNodes.size(); }
+		/** Checks the structure of the tree, returns false if it is corrupted. */
+		bool validate() const;
+
+		/** Visits the proxies whose fat box is inside a volume.
+		@param tester Functor taking the minimum and maximum of a box and returning
+			its Containment in the volume. Once a node returns CONTAIN_FULL its proxies
+			are visited without being tested.
+		@param visitor Functor taking a ProxyId, its user data, and a bool telling
+			whether the fat box was found fully inside the volume. It returns false
+			to stop the walk.
+		@return false if the visitor stopped the walk
+		*/
+		template <typename Tester, typename Visitor>
+		bool walk(const Tester& tester, Visitor& visitor) const
+		{
+			if (mRoot == NULL_PROXY)
+				return true;
+
+			// Entries are (node << 1) | fullyInside
+			int localStack[WALK_STACK_SIZE];
+			vector<int>::type heapStack;
+			int* stack = localStack;
+			size_t stackSize = WALK_STACK_SIZE;
+			size_t count = 0;
+			stack[count++] = mRoot << 1;
+
+			while (count)
+			{
+				int entry = stack[--count];
+				int index = entry >> 1;
+				bool full = (entry & 1) != 0;
+				const TreeNode& node = mNodes[index];
+
+				if (!full)
+				{
+					Containment c = tester(node.minimum, node.maximum);
+					if (c == CONTAIN_NONE)
+						continue;
+					full = (c == CONTAIN_FULL);
+				}
+
+				if (node.isLeaf())
+				{
+					if (!visitor(index, node.userData, full))
+						return false;
+					continue;
+				}
+
+				if (count + 2 > stackSize)
+				{
+					// Only a very unbalanced tree gets here. Copy out of the local
+					// array once, after that the entries already live in heapStack.
+					if (stack == localStack)
+						heapStack.assign(stack, stack + count);
+					heapStack.resize(stackSize * 2);
+					stackSize = heapStack.size();
+					stack = &heapStack[0];
+				}
+				stack[count++] = (node.child1 << 1) | (full ? 1 : 0);
+				stack[count++] = (node.child2 << 1) | (full ? 1 : 0);
+			}
+			return true;
+		}
+
+	protected:
+		enum { WALK_STACK_SIZE = 128 };
+
+		struct TreeNode
+		{
+			/// Fat box of the proxy or union of the children
+			Vector3 minimum;
+			Vector3 maximum;
+			void* userData;
+			/// Parent index, or next free node when unused
+			int parent;
+			int child1;
+			int child2;
+			/// 0 for leaves, -1 for free nodes
+			int height;
+
+			bool isLeaf() const { return child1 == NULL_PROXY; }
+		};
+		typedef vector<TreeNode>::type TreeNodeList;
+
+		TreeNodeList mNodes;
+		int mRoot;
+		int mFreeList;
+		size_t mProxyCount;
+		Real mMargin;
+		Real mRelativeMargin;
+		Real mDisplacementMultiplier;
+
+		int allocateNode();
+		void freeNode(int index);
+		void insertLeaf(int leaf);
+		void removeLeaf(int leaf);
+		/// Rotates the subtree if it is unbalanced, returns its new root
+		int balance(int index);
+		/// Sets the box of a node to the union of its children
+		void refit(int index);
+		/// Sets the fat box of a leaf from real bounds
+		void fatten(int leaf, const AxisAlignedBox& box, const Vector3& displacement);
+		bool validate(int index, int& proxies) const;
+	};
+	/** @} */
+	/** @} */
+}
+
+#endif
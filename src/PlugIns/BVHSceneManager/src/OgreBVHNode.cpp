@@ -0,0 +1,126 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHNode.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreRenderQueue.h"
+
+namespace Ogre
+{
+	//---------------------------------------------------------------------
+	BVHNode::BVHNode(SceneManager* creator)
+		: SceneNode(creator)
+		, mProxy(BVHTree::NULL_PROXY)
+		, mLastCentre(Vector3::ZERO)
+		, mInfinite(false)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHNode::BVHNode(SceneManager* creator, const String& name)
+		: SceneNode(creator, name)
+		, mProxy(BVHTree::NULL_PROXY)
+		, mLastCentre(Vector3::ZERO)
+		, mInfinite(false)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHNode::~BVHNode()
+	{
+	}
+	//---------------------------------------------------------------------
+	void BVHNode::_removeNodeAndChildren(void)
+	{
+		static_cast<BVHSceneManager*>(mCreator)->_removeBVHNode(this);
+
+		ChildNodeMap::iterator i, iend = mChildren.end();
+		for (i = mChildren.begin(); i != iend; ++i)
+		{
+			static_cast<BVHNode*>(i->second)->_removeNodeAndChildren();
+		}
+	}
+	//---------------------------------------------------------------------
+	Node* BVHNode::removeChild(unsigned short index)
+	{
+		BVHNode* child = static_cast<BVHNode*>(SceneNode::removeChild(index));
+		child->_removeNodeAndChildren();
+		return child;
+	}
+	//---------------------------------------------------------------------
+	Node* BVHNode::removeChild(const String& name)
+	{
+		BVHNode* child = static_cast<BVHNode*>(SceneNode::removeChild(name));
+		child->_removeNodeAndChildren();
+		return child;
+	}
+	//---------------------------------------------------------------------
+	Node* BVHNode::removeChild(Node* child)
+	{
+		BVHNode* node = static_cast<BVHNode*>(SceneNode::removeChild(child));
+		node->_removeNodeAndChildren();
+		return node;
+	}
+	//---------------------------------------------------------------------
+	void BVHNode::removeAllChildren(void)
+	{
+		ChildNodeMap::iterator i, iend = mChildren.end();
+		for (i = mChildren.begin(); i != iend; ++i)
+		{
+			BVHNode* child = static_cast<BVHNode*>(i->second);
+			child->setParent(0);
+			child->_removeNodeAndChildren();
+		}
+		mChildren.clear();
+		mChildrenToUpdate.clear();
+	}
+	//---------------------------------------------------------------------
+	void BVHNode::_updateBounds(void)
+	{
+		mWorldAABB.setNull();
+
+		ObjectMap::iterator i, iend = mObjectsByName.end();
+		for (i = mObjectsByName.begin(); i != iend; ++i)
+		{
+			mWorldAABB.merge(i->second->getWorldBoundingBox(true));
+		}
+
+		BVHSceneManager* mgr = static_cast<BVHSceneManager*>(mCreator);
+		if (!mWorldAABB.isNull() && mIsInSceneGraph)
+			mgr->_updateBVHNode(this);
+		else if (mProxy != BVHTree::NULL_PROXY || mInfinite)
+			mgr->_removeBVHNode(this);
+	}
+	//---------------------------------------------------------------------
+	void BVHNode::_addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+		VisibleObjectsBoundsInfo* visibleBounds)
+	{
+		ObjectMap::iterator i, iend = mObjectsByName.end();
+		for (i = mObjectsByName.begin(); i != iend; ++i)
+		{
+			queue->processVisibleObject(i->second, cam, onlyShadowCasters, visibleBounds);
+		}
+	}
+}
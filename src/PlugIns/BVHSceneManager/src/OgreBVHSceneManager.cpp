@@ -0,0 +1,554 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSceneManager.h"
+#include "OgreBVHNode.h"
+#include "OgreBVHSceneQuery.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+#include "OgreSphere.h"
+#include "OgreRay.h"
+#include "OgrePlaneBoundedVolume.h"
+
+namespace Ogre
+{
+	//---------------------------------------------------------------------
+	namespace
+	{
+		/// Tests tree boxes against a box
+		struct BoxTester
+		{
+			const AxisAlignedBox& box;
+			BoxTester(const AxisAlignedBox& b) : box(b) {}
+
+			BVHTree::Containment operator()(const Vector3& minimum, const Vector3& maximum) const
+			{
+				if (box.isNull())
+					return BVHTree::CONTAIN_NONE;
+				if (box.isInfinite())
+					return BVHTree::CONTAIN_FULL;
+
+				const Vector3& boxMin = box.getMinimum();
+				const Vector3& boxMax = box.getMaximum();
+				if (maximum.x < boxMin.x || maximum.y < boxMin.y || maximum.z < boxMin.z ||
+					minimum.x > boxMax.x || minimum.y > boxMax.y || minimum.z > boxMax.z)
+					return BVHTree::CONTAIN_NONE;
+				if (boxMin.x <= minimum.x && boxMin.y <= minimum.y && boxMin.z <= minimum.z &&
+					boxMax.x >= maximum.x && boxMax.y >= maximum.y && boxMax.z >= maximum.z)
+					return BVHTree::CONTAIN_FULL;
+				return BVHTree::CONTAIN_PARTIAL;
+			}
+		};
+		/// Tests tree boxes against a sphere
+		struct SphereTester
+		{
+			const Sphere& sphere;
+			SphereTester(const Sphere& s) : sphere(s) {}
+
+			BVHTree::Containment operator()(const Vector3& minimum, const Vector3& maximum) const
+			{
+				const Vector3& centre = sphere.getCenter();
+				Real radius2 = sphere.getRadius() * sphere.getRadius();
+
+				// Distance to the closest and the farthest points of the box
+				Real nearDist2 = 0, farDist2 = 0;
+				for (int i = 0; i < 3; ++i)
+				{
+					Real toMin = centre[i] - minimum[i];
+					Real toMax = maximum[i] - centre[i];
+					if (toMin < 0)
+						nearDist2 += toMin * toMin;
+					else if (toMax < 0)
+						nearDist2 += toMax * toMax;
+					Real farAxis = std::max(Math::Abs(toMin), Math::Abs(toMax));
+					farDist2 += farAxis * farAxis;
+				}
+
+				if (nearDist2 > radius2)
+					return BVHTree::CONTAIN_NONE;
+				return farDist2 <= radius2 ? BVHTree::CONTAIN_FULL : BVHTree::CONTAIN_PARTIAL;
+			}
+		};
+		/// Tests tree boxes against a convex set of planes
+		struct PlanesTester
+		{
+			const Plane* planes;
+			size_t numPlanes;
+			Plane::Side outside;
+			/// Plane to ignore, for frustums with an infinite far distance
+			size_t skipPlane;
+
+			PlanesTester(const Plane* p, size_t count, Plane::Side outsideSide, size_t skip = ~(size_t)0)
+				: planes(p), numPlanes(count), outside(outsideSide), skipPlane(skip) {}
+
+			BVHTree::Containment operator()(const Vector3& minimum, const Vector3& maximum) const
+			{
+				Vector3 centre = (minimum + maximum) * 0.5f;
+				Vector3 halfSize = (maximum - minimum) * 0.5f;
+				bool inside = true;
+				for (size_t i = 0; i < numPlanes; ++i)
+				{
+					if (i == skipPlane)
+						continue;
+					Plane::Side side = planes[i].getSide(centre, halfSize);
+					if (side == outside)
+						return BVHTree::CONTAIN_NONE;
+					if (side == Plane::BOTH_SIDE)
+						inside = false;
+				}
+				return inside ? BVHTree::CONTAIN_FULL : BVHTree::CONTAIN_PARTIAL;
+			}
+		};
+		/// Tests tree boxes against a ray
+		struct RayTester
+		{
+			const Ray& ray;
+			RayTester(const Ray& r) : ray(r) {}
+
+			BVHTree::Containment operator()(const Vector3& minimum, const Vector3& maximum) const
+			{
+				return ray.intersects(AxisAlignedBox(minimum, maximum)).first ?
+					BVHTree::CONTAIN_PARTIAL : BVHTree::CONTAIN_NONE;
+			}
+		};
+		/// Accepts every tree box
+		struct AllTester
+		{
+			BVHTree::Containment operator()(const Vector3&, const Vector3&) const
+			{
+				return BVHTree::CONTAIN_FULL;
+			}
+		};
+
+		/// Collects the nodes whose real bounds pass the tester
+		template <typename Tester>
+		struct NodeCollector
+		{
+			const Tester& tester;
+			BVHSceneManager::SceneNodeList& list;
+			SceneNode* exclude;
+
+			NodeCollector(const Tester& t, BVHSceneManager::SceneNodeList& l, SceneNode* e)
+				: tester(t), list(l), exclude(e) {}
+
+			bool operator()(BVHTree::ProxyId, void* userData, bool fullyInside)
+			{
+				BVHNode* node = static_cast<BVHNode*>(userData);
+				if (node == exclude)
+					return true;
+				// The fat box passing doesn't mean the real bounds do
+				const AxisAlignedBox& box = node->_getWorldAABB();
+				if (fullyInside ||
+					tester(box.getMinimum(), box.getMaximum()) != BVHTree::CONTAIN_NONE)
+				{
+					list.push_back(node);
+				}
+				return true;
+			}
+		};
+
+		template <typename Tester>
+		void collectNodes(const BVHTree& tree, const set<BVHNode*>::type& infiniteNodes,
+			const Tester& tester, BVHSceneManager::SceneNodeList& list, SceneNode* exclude)
+		{
+			NodeCollector<Tester> collector(tester, list, exclude);
+			tree.walk(tester, collector);
+
+			set<BVHNode*>::type::const_iterator i, iend = infiniteNodes.end();
+			for (i = infiniteNodes.begin(); i != iend; ++i)
+			{
+				if (*i != exclude)
+					list.push_back(*i);
+			}
+		}
+
+		/// Adds the nodes found in the view frustum to the render queue
+		struct VisibleNodeCollector
+		{
+			Camera* cam;
+			RenderQueue* queue;
+			VisibleObjectsBoundsInfo* visibleBounds;
+			bool onlyShadowCasters;
+			bool displayNodes;
+			bool showBoundingBoxes;
+
+			bool operator()(BVHTree::ProxyId, void* userData, bool fullyInside)
+			{
+				BVHNode* node = static_cast<BVHNode*>(userData);
+				if (fullyInside || cam->isVisible(node->_getWorldAABB()))
+					addNode(node);
+				return true;
+			}
+
+			void addNode(BVHNode* node)
+			{
+				node->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+
+				if (displayNodes)
+					queue->addRenderable(node->getDebugRenderable());
+
+				if (showBoundingBoxes || node->getShowBoundingBox())
+					node->_addBoundingBoxToQueue(queue);
+			}
+		};
+
+		/// Collects the nodes intersecting one node, with a greater proxy to report each pair once
+		struct PairCollector
+		{
+			BVHNode* node;
+			BVHSceneManager::SceneNodePairList& pairs;
+
+			PairCollector(BVHNode* n, BVHSceneManager::SceneNodePairList& p)
+				: node(n), pairs(p) {}
+
+			bool operator()(BVHTree::ProxyId id, void* userData, bool)
+			{
+				BVHNode* other = static_cast<BVHNode*>(userData);
+				if (id > node->_getProxy() &&
+					node->_getWorldAABB().intersects(other->_getWorldAABB()))
+				{
+					pairs.push_back(std::make_pair((SceneNode*)node, (SceneNode*)other));
+				}
+				return true;
+			}
+		};
+
+		/// Runs a PairCollector for every proxy of the tree
+		struct PairFinder
+		{
+			const BVHTree& tree;
+			BVHSceneManager::SceneNodePairList& pairs;
+
+			PairFinder(const BVHTree& t, BVHSceneManager::SceneNodePairList& p)
+				: tree(t), pairs(p) {}
+
+			bool operator()(BVHTree::ProxyId id, void* userData, bool)
+			{
+				BVHNode* node = static_cast<BVHNode*>(userData);
+				PairCollector collector(node, pairs);
+				tree.walk(BoxTester(node->_getWorldAABB()), collector);
+				return true;
+			}
+		};
+	}
+	//---------------------------------------------------------------------
+	BVHSceneManager::BVHSceneManager(const String& name)
+		: SceneManager(name)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHSceneManager::~BVHSceneManager()
+	{
+		// Empty the tree while we can, the base class destroys the nodes later
+		clearScene();
+	}
+	//---------------------------------------------------------------------
+	const String& BVHSceneManager::getTypeName(void) const
+	{
+		return BVHSceneManagerFactory::FACTORY_TYPE_NAME;
+	}
+	//---------------------------------------------------------------------
+	SceneNode* BVHSceneManager::createSceneNodeImpl(void)
+	{
+		return OGRE_NEW BVHNode(this);
+	}
+	//---------------------------------------------------------------------
+	SceneNode* BVHSceneManager::createSceneNodeImpl(const String& name)
+	{
+		return OGRE_NEW BVHNode(this, name);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::destroySceneNode(const String& name)
+	{
+		BVHNode* node = static_cast<BVHNode*>(getSceneNode(name));
+		_removeBVHNode(node);
+
+		SceneManager::destroySceneNode(name);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::destroySceneNode(const SlotHandle& handle)
+	{
+		if (hasSceneNode(handle))
+			_removeBVHNode(static_cast<BVHNode*>(getSceneNode(handle)));
+
+		SceneManager::destroySceneNode(handle);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::clearScene(void)
+	{
+		// The root node survives, so it must forget about its proxy
+		if (mSceneRoot)
+			_removeBVHNode(static_cast<BVHNode*>(mSceneRoot));
+
+		SceneManager::clearScene();
+		mTree.clear();
+		mInfiniteNodes.clear();
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::_updateBVHNode(BVHNode* node)
+	{
+		const AxisAlignedBox& box = node->_getWorldAABB();
+
+		if (box.isInfinite())
+		{
+			if (node->_getProxy() != BVHTree::NULL_PROXY)
+			{
+				mTree.destroyProxy(node->_getProxy());
+				node->_setProxy(BVHTree::NULL_PROXY);
+			}
+			if (!node->_isInfinite())
+			{
+				mInfiniteNodes.insert(node);
+				node->_setInfinite(true);
+			}
+			return;
+		}
+
+		if (node->_isInfinite())
+		{
+			mInfiniteNodes.erase(node);
+			node->_setInfinite(false);
+		}
+
+		Vector3 centre = box.getCenter();
+		if (node->_getProxy() == BVHTree::NULL_PROXY)
+			node->_setProxy(mTree.createProxy(box, node));
+		else
+			mTree.moveProxy(node->_getProxy(), box, centre - node->_getLastCentre());
+		node->_setLastCentre(centre);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::_removeBVHNode(BVHNode* node)
+	{
+		if (node->_getProxy() != BVHTree::NULL_PROXY)
+		{
+			mTree.destroyProxy(node->_getProxy());
+			node->_setProxy(BVHTree::NULL_PROXY);
+		}
+		if (node->_isInfinite())
+		{
+			mInfiniteNodes.erase(node);
+			node->_setInfinite(false);
+		}
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::_findVisibleObjects(Camera* cam,
+		VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+	{
+		VisibleNodeCollector collector;
+		collector.cam = cam;
+		collector.queue = getRenderQueue();
+		collector.visibleBounds = visibleBounds;
+		collector.onlyShadowCasters = onlyShadowCasters;
+		collector.displayNodes = mDisplayNodes;
+		collector.showBoundingBoxes = mShowBoundingBoxes;
+
+		// Cull against the same frustum the camera uses for objects
+		const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+		PlanesTester tester(frustum->getFrustumPlanes(), 6, Plane::NEGATIVE_SIDE,
+			frustum->getFarClipDistance() == 0 ? (size_t)FRUSTUM_PLANE_FAR : ~(size_t)0);
+		mTree.walk(tester, collector);
+
+		BVHNodeSet::iterator i, iend = mInfiniteNodes.end();
+		for (i = mInfiniteNodes.begin(); i != iend; ++i)
+		{
+			collector.addNode(*i);
+		}
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::findNodesIn(const AxisAlignedBox& box, SceneNodeList& list, SceneNode* exclude)
+	{
+		collectNodes(mTree, mInfiniteNodes, BoxTester(box), list, exclude);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::findNodesIn(const Sphere& sphere, SceneNodeList& list, SceneNode* exclude)
+	{
+		collectNodes(mTree, mInfiniteNodes, SphereTester(sphere), list, exclude);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::findNodesIn(const PlaneBoundedVolume& volume, SceneNodeList& list, SceneNode* exclude)
+	{
+		if (volume.planes.empty())
+		{
+			collectNodes(mTree, mInfiniteNodes, AllTester(), list, exclude);
+			return;
+		}
+		collectNodes(mTree, mInfiniteNodes,
+			PlanesTester(&volume.planes[0], volume.planes.size(), volume.outside), list, exclude);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::findNodesIn(const Ray& ray, SceneNodeList& list, SceneNode* exclude)
+	{
+		collectNodes(mTree, mInfiniteNodes, RayTester(ray), list, exclude);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManager::findIntersectingNodes(SceneNodePairList& pairs)
+	{
+		PairFinder finder(mTree, pairs);
+		mTree.walk(AllTester(), finder);
+
+		// Infinite bounds intersect everything
+		BVHNodeSet::iterator i, iend = mInfiniteNodes.end();
+		for (i = mInfiniteNodes.begin(); i != iend; ++i)
+		{
+			SceneNodeList others;
+			collectNodes(mTree, BVHNodeSet(i, iend), AllTester(), others, *i);
+
+			SceneNodeList::iterator o, oend = others.end();
+			for (o = others.begin(); o != oend; ++o)
+				pairs.push_back(std::make_pair((SceneNode*)*i, *o));
+		}
+	}
+	//---------------------------------------------------------------------
+	bool BVHSceneManager::setOption(const String& key, const void* val)
+	{
+		if (key == "FatMargin")
+		{
+			mTree.setMargin(*static_cast<const Real*>(val));
+			return true;
+		}
+		else if (key == "RelativeFatMargin")
+		{
+			mTree.setRelativeMargin(*static_cast<const Real*>(val));
+			return true;
+		}
+		else if (key == "DisplacementMultiplier")
+		{
+			mTree.setDisplacementMultiplier(*static_cast<const Real*>(val));
+			return true;
+		}
+
+		return SceneManager::setOption(key, val);
+	}
+	//---------------------------------------------------------------------
+	bool BVHSceneManager::getOption(const String& key, void* val)
+	{
+		if (key == "FatMargin")
+		{
+			*static_cast<Real*>(val) = mTree.getMargin();
+			return true;
+		}
+		else if (key == "RelativeFatMargin")
+		{
+			*static_cast<Real*>(val) = mTree.getRelativeMargin();
+			return true;
+		}
+		else if (key == "DisplacementMultiplier")
+		{
+			*static_cast<Real*>(val) = mTree.getDisplacementMultiplier();
+			return true;
+		}
+		else if (key == "TreeHeight")
+		{
+			*static_cast<int*>(val) = mTree.getHeight();
+			return true;
+		}
+		else if (key == "ProxyCount")
+		{
+			*static_cast<size_t*>(val) = mTree.getProxyCount();
+			return true;
+		}
+
+		return SceneManager::getOption(key, val);
+	}
+	//---------------------------------------------------------------------
+	bool BVHSceneManager::getOptionKeys(StringVector& refKeys)
+	{
+		SceneManager::getOptionKeys(refKeys);
+		refKeys.push_back("FatMargin");
+		refKeys.push_back("RelativeFatMargin");
+		refKeys.push_back("DisplacementMultiplier");
+		refKeys.push_back("TreeHeight");
+		refKeys.push_back("ProxyCount");
+		return true;
+	}
+	//---------------------------------------------------------------------
+	AxisAlignedBoxSceneQuery*
+	BVHSceneManager::createAABBQuery(const AxisAlignedBox& box, unsigned long mask)
+	{
+		BVHAxisAlignedBoxSceneQuery* q = OGRE_NEW BVHAxisAlignedBoxSceneQuery(this);
+		q->setBox(box);
+		q->setQueryMask(mask);
+		return q;
+	}
+	//---------------------------------------------------------------------
+	SphereSceneQuery*
+	BVHSceneManager::createSphereQuery(const Sphere& sphere, unsigned long mask)
+	{
+		BVHSphereSceneQuery* q = OGRE_NEW BVHSphereSceneQuery(this);
+		q->setSphere(sphere);
+		q->setQueryMask(mask);
+		return q;
+	}
+	//---------------------------------------------------------------------
+	PlaneBoundedVolumeListSceneQuery*
+	BVHSceneManager::createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes,
+		unsigned long mask)
+	{
+		BVHPlaneBoundedVolumeListSceneQuery* q = OGRE_NEW BVHPlaneBoundedVolumeListSceneQuery(this);
+		q->setVolumes(volumes);
+		q->setQueryMask(mask);
+		return q;
+	}
+	//---------------------------------------------------------------------
+	RaySceneQuery*
+	BVHSceneManager::createRayQuery(const Ray& ray, unsigned long mask)
+	{
+		BVHRaySceneQuery* q = OGRE_NEW BVHRaySceneQuery(this);
+		q->setRay(ray);
+		q->setQueryMask(mask);
+		return q;
+	}
+	//---------------------------------------------------------------------
+	IntersectionSceneQuery*
+	BVHSceneManager::createIntersectionQuery(unsigned long mask)
+	{
+		BVHIntersectionSceneQuery* q = OGRE_NEW BVHIntersectionSceneQuery(this);
+		q->setQueryMask(mask);
+		return q;
+	}
+	//---------------------------------------------------------------------
+	const String BVHSceneManagerFactory::FACTORY_TYPE_NAME = "BVHSceneManager";
+	//---------------------------------------------------------------------
+	void BVHSceneManagerFactory::initMetaData(void) const
+	{
+		mMetaData.typeName = FACTORY_TYPE_NAME;
+		mMetaData.description = "Scene manager organising the scene in a dynamic bounding volume hierarchy.";
+		mMetaData.sceneTypeMask = 0xFFFF; // support all types
+		mMetaData.worldGeometrySupported = false;
+	}
+	//---------------------------------------------------------------------
+	SceneManager* BVHSceneManagerFactory::createInstance(const String& instanceName)
+	{
+		return OGRE_NEW BVHSceneManager(instanceName);
+	}
+	//---------------------------------------------------------------------
+	void BVHSceneManagerFactory::destroyInstance(SceneManager* instance)
+	{
+		OGRE_DELETE instance;
+	}
+}
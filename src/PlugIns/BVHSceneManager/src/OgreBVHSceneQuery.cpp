@@ -0,0 +1,259 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSceneQuery.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreEntity.h"
+
+namespace Ogre
+{
+	//---------------------------------------------------------------------
+	namespace
+	{
+		/// Reports the objects of the nodes passing the masks and the volume test
+		template <typename Volume>
+		bool reportObjects(const BVHSceneManager::SceneNodeList& nodes, const Volume& volume,
+			uint32 queryMask, uint32 typeMask, SceneQueryListener* listener)
+		{
+			BVHSceneManager::SceneNodeList::const_iterator it, itend = nodes.end();
+			for (it = nodes.begin(); it != itend; ++it)
+			{
+				SceneNode::ObjectIterator oit = (*it)->getAttachedObjectIterator();
+				while (oit.hasMoreElements())
+				{
+					MovableObject* m = oit.getNext();
+					if (!(m->getQueryFlags() & queryMask) ||
+						!(m->getTypeFlags() & typeMask) ||
+						!m->isInScene() ||
+						!volume.intersects(m->getWorldBoundingBox()))
+						continue;
+
+					if (!listener->queryResult(m))
+						return false;
+
+					// deal with attached objects, since they are not directly attached to nodes
+					if (m->getMovableType() == "Entity")
+					{
+						Entity* e = static_cast<Entity*>(m);
+						Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+						while (childIt.hasMoreElements())
+						{
+							MovableObject* c = childIt.getNext();
+							if ((c->getQueryFlags() & queryMask) &&
+								volume.intersects(c->getWorldBoundingBox()))
+							{
+								if (!listener->queryResult(c))
+									return false;
+							}
+						}
+					}
+				}
+			}
+			return true;
+		}
+	}
+	//---------------------------------------------------------------------
+	BVHIntersectionSceneQuery::BVHIntersectionSceneQuery(SceneManager* creator)
+		: DefaultIntersectionSceneQuery(creator)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHIntersectionSceneQuery::~BVHIntersectionSceneQuery()
+	{
+	}
+	//---------------------------------------------------------------------
+	void BVHIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+	{
+		BVHSceneManager* mgr = static_cast<BVHSceneManager*>(mParentSceneMgr);
+
+		// Objects of a same node may intersect each other too, so the nodes
+		// go through the list of pairs with themselves
+		BVHSceneManager::SceneNodePairList pairs;
+		mgr->findIntersectingNodes(pairs);
+		BVHSceneManager::SceneNodeList nodes;
+		mgr->findNodesIn(AxisAlignedBox(AxisAlignedBox::EXTENT_INFINITE), nodes);
+		for (BVHSceneManager::SceneNodeList::iterator n = nodes.begin(); n != nodes.end(); ++n)
+			pairs.push_back(std::make_pair(*n, *n));
+
+		BVHSceneManager::SceneNodePairList::iterator p, pend = pairs.end();
+		for (p = pairs.begin(); p != pend; ++p)
+		{
+			bool sameNode = p->first == p->second;
+			SceneNode::ObjectIterator ait = p->first->getAttachedObjectIterator();
+			while (ait.hasMoreElements())
+			{
+				MovableObject* a = ait.getNext();
+				if (!(a->getQueryFlags() & mQueryMask) ||
+					!(a->getTypeFlags() & mQueryTypeMask) ||
+					!a->isInScene())
+					continue;
+
+				const AxisAlignedBox& box1 = a->getWorldBoundingBox();
+				SceneNode::ObjectIterator bit = p->second->getAttachedObjectIterator();
+				if (sameNode)
+				{
+					// Only check against the objects after a
+					while (bit.hasMoreElements() && bit.getNext() != a) {}
+				}
+				while (bit.hasMoreElements())
+				{
+					MovableObject* b = bit.getNext();
+					if ((b->getQueryFlags() & mQueryMask) &&
+						(b->getTypeFlags() & mQueryTypeMask) &&
+						b->isInScene() &&
+						box1.intersects(b->getWorldBoundingBox()))
+					{
+						if (!listener->queryResult(a, b))
+							return;
+					}
+				}
+			}
+		}
+	}
+	//---------------------------------------------------------------------
+	BVHAxisAlignedBoxSceneQuery::BVHAxisAlignedBoxSceneQuery(SceneManager* creator)
+		: DefaultAxisAlignedBoxSceneQuery(creator)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHAxisAlignedBoxSceneQuery::~BVHAxisAlignedBoxSceneQuery()
+	{
+	}
+	//---------------------------------------------------------------------
+	void BVHAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
+	{
+		BVHSceneManager::SceneNodeList nodes;
+		static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mAABB, nodes);
+
+		reportObjects(nodes, mAABB, mQueryMask, mQueryTypeMask, listener);
+	}
+	//---------------------------------------------------------------------
+	BVHSphereSceneQuery::BVHSphereSceneQuery(SceneManager* creator)
+		: DefaultSphereSceneQuery(creator)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHSphereSceneQuery::~BVHSphereSceneQuery()
+	{
+	}
+	//---------------------------------------------------------------------
+	void BVHSphereSceneQuery::execute(SceneQueryListener* listener)
+	{
+		BVHSceneManager::SceneNodeList nodes;
+		static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mSphere, nodes);
+
+		reportObjects(nodes, mSphere, mQueryMask, mQueryTypeMask, listener);
+	}
+	//---------------------------------------------------------------------
+	BVHPlaneBoundedVolumeListSceneQuery::BVHPlaneBoundedVolumeListSceneQuery(SceneManager* creator)
+		: DefaultPlaneBoundedVolumeListSceneQuery(creator)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHPlaneBoundedVolumeListSceneQuery::~BVHPlaneBoundedVolumeListSceneQuery()
+	{
+	}
+	//---------------------------------------------------------------------
+	void BVHPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
+	{
+		BVHSceneManager* mgr = static_cast<BVHSceneManager*>(mParentSceneMgr);
+		set<SceneNode*>::type checkedSceneNodes;
+
+		PlaneBoundedVolumeList::iterator pi, piend = mVolumes.end();
+		for (pi = mVolumes.begin(); pi != piend; ++pi)
+		{
+			BVHSceneManager::SceneNodeList nodes;
+			mgr->findNodesIn(*pi, nodes);
+
+			// avoid reporting the same scene node for several volumes
+			BVHSceneManager::SceneNodeList::iterator it = nodes.begin();
+			while (it != nodes.end())
+			{
+				if (checkedSceneNodes.insert(*it).second)
+					++it;
+				else
+					it = nodes.erase(it);
+			}
+
+			if (!reportObjects(nodes, *pi, mQueryMask, mQueryTypeMask, listener))
+				return;
+		}
+	}
+	//---------------------------------------------------------------------
+	BVHRaySceneQuery::BVHRaySceneQuery(SceneManager* creator)
+		: DefaultRaySceneQuery(creator)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHRaySceneQuery::~BVHRaySceneQuery()
+	{
+	}
+	//---------------------------------------------------------------------
+	void BVHRaySceneQuery::execute(RaySceneQueryListener* listener)
+	{
+		BVHSceneManager::SceneNodeList nodes;
+		static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mRay, nodes);
+
+		BVHSceneManager::SceneNodeList::iterator it, itend = nodes.end();
+		for (it = nodes.begin(); it != itend; ++it)
+		{
+			SceneNode::ObjectIterator oit = (*it)->getAttachedObjectIterator();
+			while (oit.hasMoreElements())
+			{
+				MovableObject* m = oit.getNext();
+				if (!(m->getQueryFlags() & mQueryMask) ||
+					!(m->getTypeFlags() & mQueryTypeMask) ||
+					!m->isInScene())
+					continue;
+
+				std::pair<bool, Real> result = mRay.intersects(m->getWorldBoundingBox());
+				if (!result.first)
+					continue;
+
+				if (!listener->queryResult(m, result.second))
+					return;
+
+				// deal with attached objects, since they are not directly attached to nodes
+				if (m->getMovableType() == "Entity")
+				{
+					Entity* e = static_cast<Entity*>(m);
+					Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+					while (childIt.hasMoreElements())
+					{
+						MovableObject* c = childIt.getNext();
+						if (c->getQueryFlags() & mQueryMask)
+						{
+							result = mRay.intersects(c->getWorldBoundingBox());
+							if (result.first && !listener->queryResult(c, result.second))
+								return;
+						}
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,430 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHTree.h"
+
+namespace Ogre
+{
+	const BVHTree::ProxyId BVHTree::NULL_PROXY;
+	//---------------------------------------------------------------------
+	namespace
+	{
+		inline Real surfaceArea(const Vector3& minimum, const Vector3& maximum)
+		{
+			Vector3 d = maximum - minimum;
+			return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+		inline Real mergedArea(const Vector3& min1, const Vector3& max1,
+			const Vector3& min2, const Vector3& max2)
+		{
+			Vector3 minimum = min1;
+			Vector3 maximum = max1;
+			minimum.makeFloor(min2);
+			maximum.makeCeil(max2);
+			return surfaceArea(minimum, maximum);
+		}
+	}
+	//---------------------------------------------------------------------
+	BVHTree::BVHTree()
+		: mRoot(NULL_PROXY)
+		, mFreeList(NULL_PROXY)
+		, mProxyCount(0)
+		, mMargin(0.1f)
+		, mRelativeMargin(0.1f)
+		, mDisplacementMultiplier(2)
+	{
+	}
+	//---------------------------------------------------------------------
+	BVHTree::~BVHTree()
+	{
+	}
+	//---------------------------------------------------------------------
+	void BVHTree::clear()
+	{
+		mNodes.clear();
+		mRoot = NULL_PROXY;
+		mFreeList = NULL_PROXY;
+		mProxyCount = 0;
+	}
+	//---------------------------------------------------------------------
+	int BVHTree::allocateNode()
+	{
+		int index;
+		if (mFreeList != NULL_PROXY)
+		{
+			index = mFreeList;
+			mFreeList = mNodes[index].parent;
+		}
+		else
+		{
+			index = (int)mNodes.size();
+			mNodes.push_back(TreeNode());
+		}
+
+		TreeNode& node = mNodes[index];
+		node.userData = 0;
+		node.parent = NULL_PROXY;
+		node.child1 = NULL_PROXY;
+		node.child2 = NULL_PROXY;
+		node.height = 0;
+		return index;
+	}
+	//---------------------------------------------------------------------
+	void BVHTree::freeNode(int index)
+	{
+		TreeNode& node = mNodes[index];
+		node.parent = mFreeList;
+		node.height = -1;
+		node.userData = 0;
+		mFreeList = index;
+	}
+	//---------------------------------------------------------------------
+	BVHTree::ProxyId BVHTree::createProxy(const AxisAlignedBox& box, void* userData)
+	{
+		assert(box.isFinite() && "Only finite boxes can be put in a BVHTree");
+
+		int leaf = allocateNode();
+		mNodes[leaf].userData = userData;
+		fatten(leaf, box, Vector3::ZERO);
+		insertLeaf(leaf);
+		++mProxyCount;
+		return leaf;
+	}
+	//---------------------------------------------------------------------
+	void BVHTree::destroyProxy(ProxyId id)
+	{
+		assert(id >= 0 && id < (ProxyId)mNodes.size() && mNodes[id].isLeaf());
+
+		removeLeaf(id);
+		freeNode(id);
+		--mProxyCount;
+	}
+	//---------------------------------------------------------------------
+	bool BVHTree::moveProxy(ProxyId id, const AxisAlignedBox& box, const Vector3& displacement)
+	{
+		assert(id >= 0 && id < (ProxyId)mNodes.size() && mNodes[id].isLeaf());
+		assert(box.isFinite() && "Only finite boxes can be put in a BVHTree");
+
+		const TreeNode& node = mNodes[id];
+		const Vector3& minimum = box.getMinimum();
+		const Vector3& maximum = box.getMaximum();
+		if (node.minimum.x <= minimum.x && node.minimum.y <= minimum.y && node.minimum.z <= minimum.z &&
+			node.maximum.x >= maximum.x && node.maximum.y >= maximum.y && node.maximum.z >= maximum.z)
+		{
+			// Still inside the fat box
+			return false;
+		}
+
+		removeLeaf(id);
+		fatten(id, box, displacement);
+		insertLeaf(id);
+		return true;
+	}
+	//---------------------------------------------------------------------
+	AxisAlignedBox BVHTree::getFatBox(ProxyId id) const
+	{
+		assert(id >= 0 && id < (ProxyId)mNodes.size() && mNodes[id].isLeaf());
+		return AxisAlignedBox(mNodes[id].minimum, mNodes[id].maximum);
+	}
+	//---------------------------------------------------------------------
+	void BVHTree::fatten(int leaf, const AxisAlignedBox& box, const Vector3& displacement)
+	{
+		TreeNode& node = mNodes[leaf];
+		Vector3 extension = box.getHalfSize() * mRelativeMargin + Vector3(mMargin, mMargin, mMargin);
+		node.minimum = box.getMinimum() - extension;
+		node.maximum = box.getMaximum() + extension;
+
+		// Predict the motion, so that steadily moving proxies are moved less often
+		Vector3 d = displacement * mDisplacementMultiplier;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (d[i] < 0)
+				node.minimum[i] += d[i];
+			else
+				node.maximum[i] += d[i];
+		}
+	}
+	//---------------------------------------------------------------------
+	void BVHTree::refit(int index)
+	{
+		TreeNode& node = mNodes[index];
+		const TreeNode& child1 = mNodes[node.child1];
+		const TreeNode& child2 = mNodes[node.child2];
+		node.minimum = child1.minimum;
+		node.maximum = child1.maximum;
+		node.minimum.makeFloor(child2.minimum);
+		node.maximum.makeCeil(child2.maximum);
+		node.height = 1 + std::max(child1.height, child2.height);
+	}
+	//---------------------------------------------------------------------
+	void BVHTree::insertLeaf(int leaf)
+	{
+		if (mRoot == NULL_PROXY)
+		{
+			mRoot = leaf;
+			mNodes[leaf].parent = NULL_PROXY;
+			return;
+		}
+
+		// Find the best sibling, going down the cheapest branch
+		const Vector3 leafMin = mNodes[leaf].minimum;
+		const Vector3 leafMax = mNodes[leaf].maximum;
+		int index = mRoot;
+		while (!mNodes[index].isLeaf())
+		{
+			const TreeNode& node = mNodes[index];
+			Real area = surfaceArea(node.minimum, node.maximum);
+			Real combinedArea = mergedArea(node.minimum, node.maximum, leafMin, leafMax);
+
+			// Cost of making a new parent for this node and the leaf
+			Real cost = 2 * combinedArea;
+			// Minimum cost of pushing the leaf further down the tree
+			Real inheritanceCost = 2 * (combinedArea - area);
+
+			Real costs[2];
+			int children[2] = { node.child1, node.child2 };
+			for (int c = 0; c < 2; ++c)
+			{
+				const TreeNode& child = mNodes[children[c]];
+				costs[c] = mergedArea(child.minimum, child.maximum, leafMin, leafMax) + inheritanceCost;
+				if (!child.isLeaf())
+					costs[c] -= surfaceArea(child.minimum, child.maximum);
+			}
+
+			if (cost < costs[0] && cost < costs[1])
+				break;
+
+			index = costs[0] < costs[1] ? children[0] : children[1];
+		}
+
+		int sibling = index;
+		int oldParent = mNodes[sibling].parent;
+		// May reallocate mNodes, so no references are held across it
+		int newParent = allocateNode();
+		mNodes[newParent].parent = oldParent;
+		mNodes[newParent].child1 = sibling;
+		mNodes[newParent].child2 = leaf;
+		mNodes[sibling].parent = newParent;
+		mNodes[leaf].parent = newParent;
+		refit(newParent);
+
+		if (oldParent != NULL_PROXY)
+		{
+			if (mNodes[oldParent].child1 == sibling)
+				mNodes[oldParent].child1 = newParent;
+			else
+				mNodes[oldParent].child2 = newParent;
+		}
+		else
+		{
+			mRoot = newParent;
+		}
+
+		// Fix the boxes and heights up to the root
+		index = mNodes[newParent].parent;
+		while (index != NULL_PROXY)
+		{
+			index = balance(index);
+			refit(index);
+			index = mNodes[index].parent;
+		}
+	}
+	//---------------------------------------------------------------------
+	void BVHTree::removeLeaf(int leaf)
+	{
+		if (leaf == mRoot)
+		{
+			mRoot = NULL_PROXY;
+			return;
+		}
+
+		int parent = mNodes[leaf].parent;
+		int grandParent = mNodes[parent].parent;
+		int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+		if (grandParent != NULL_PROXY)
+		{
+			// Replace the parent with the sibling
+			if (mNodes[grandParent].child1 == parent)
+				mNodes[grandParent].child1 = sibling;
+			else
+				mNodes[grandParent].child2 = sibling;
+			mNodes[sibling].parent = grandParent;
+			freeNode(parent);
+
+			int index = grandParent;
+			while (index != NULL_PROXY)
+			{
+				index = balance(index);
+				refit(index);
+				index = mNodes[index].parent;
+			}
+		}
+		else
+		{
+			mRoot = sibling;
+			mNodes[sibling].parent = NULL_PROXY;
+			freeNode(parent);
+		}
+	}
+	//---------------------------------------------------------------------
+	int BVHTree::balance(int iA)
+	{
+		TreeNode& A = mNodes[iA];
+		if (A.isLeaf() || A.height < 2)
+			return iA;
+
+		int iB = A.child1;
+		int iC = A.child2;
+		TreeNode& B = mNodes[iB];
+		TreeNode& C = mNodes[iC];
+		int balance = C.height - B.height;
+
+		if (balance > 1)
+		{
+			// Rotate C up
+			int iF = C.child1;
+			int iG = C.child2;
+			TreeNode& F = mNodes[iF];
+			TreeNode& G = mNodes[iG];
+
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+
+			if (C.parent != NULL_PROXY)
+			{
+				if (mNodes[C.parent].child1 == iA)
+					mNodes[C.parent].child1 = iC;
+				else
+					mNodes[C.parent].child2 = iC;
+			}
+			else
+			{
+				mRoot = iC;
+			}
+
+			// Keep the higher grand child under C
+			if (F.height > G.height)
+			{
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+			}
+			else
+			{
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+			}
+			refit(iA);
+			refit(iC);
+			return iC;
+		}
+
+		if (balance < -1)
+		{
+			// Rotate B up
+			int iD = B.child1;
+			int iE = B.child2;
+			TreeNode& D = mNodes[iD];
+			TreeNode& E = mNodes[iE];
+
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+
+			if (B.parent != NULL_PROXY)
+			{
+				if (mNodes[B.parent].child1 == iA)
+					mNodes[B.parent].child1 = iB;
+				else
+					mNodes[B.parent].child2 = iB;
+			}
+			else
+			{
+				mRoot = iB;
+			}
+
+			if (D.height > E.height)
+			{
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+			}
+			else
+			{
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+			}
+			refit(iA);
+			refit(iB);
+			return iB;
+		}
+
+		return iA;
+	}
+	//---------------------------------------------------------------------
+	bool BVHTree::validate() const
+	{
+		int proxies = 0;
+		if (mRoot != NULL_PROXY)
+		{
+			if (mNodes[mRoot].parent != NULL_PROXY || !validate(mRoot, proxies))
+				return false;
+		}
+		return (size_t)proxies == mProxyCount;
+	}
+	//---------------------------------------------------------------------
+	bool BVHTree::validate(int index, int& proxies) const
+	{
+		const TreeNode& node = mNodes[index];
+		if (node.isLeaf())
+		{
+			++proxies;
+			return node.height == 0 && node.child2 == NULL_PROXY;
+		}
+
+		const TreeNode& child1 = mNodes[node.child1];
+		const TreeNode& child2 = mNodes[node.child2];
+		if (child1.parent != index || child2.parent != index)
+			return false;
+		// Rotations keep the tree roughly balanced, but not strictly AVL
+		if (node.height != 1 + std::max(child1.height, child2.height))
+			return false;
+
+		Vector3 minimum = child1.minimum;
+		Vector3 maximum = child1.maximum;
+		minimum.makeFloor(child2.minimum);
+		maximum.makeCeil(child2.maximum);
+		if (minimum != node.minimum || maximum != node.maximum)
+			return false;
+
+		return validate(node.child1, proxies) && validate(node.child2, proxies);
+	}
+}
@@ -102,13 +102,25 @@ public:
     */
     Octree * mChildren[ 2 ][ 2 ][ 2 ];
 
+    /** Factor by which the culling bounds of this octree are bigger than its box.
+    @remarks
+    Children inherit it from their parent. The classic value is 2, which makes
+    each octant overlap its siblings by half their size.
+    */
+    Real mLooseness;
+
     /** Determines if this octree is twice as big as the given box.
     @remarks
     This method is used by the OctreeSceneManager to determine if the given
-    box will fit into a child of this octree.
+    box will fit into a child of this octree. With a looseness other than 2,
+    the given box must be no bigger than (looseness - 1) times a child.
     */
     bool _isTwiceSize( const AxisAlignedBox &box ) const;
 
+    /** Returns true if the given box is completely inside the culling bounds of this octree.
+    */
+    bool _isInCullBounds( const AxisAlignedBox &box ) const;
+
     /**  Returns the appropriate indexes for the child of this octree into which the box will fit.
     @remarks
     This is used by the OctreeSceneManager to determine which child to traverse next when
@@ -123,6 +135,24 @@ public:
     */
     void _getCullBounds( AxisAlignedBox * ) const;
 
+    /** Returns the parent octree, null for the root.
+    */
+    Octree * _getParent() const
+    {
+        return mParent;
+    };
+
+    /** Returns how many levels down from the root this octree is.
+    */
+    int _getDepth() const;
+
+    /** Creates the root octree to be used when growing the world bounds.
+    @remarks
+    The new octree is twice as big as this one, extended towards the given point,
+    and gets this octree as one of its children. This octree must be the root.
+    */
+    Octree * _grow( const Vector3 &towards );
+
 
 	typedef list< OctreeNode * >::type NodeList;
     /** Public list of SceneNodes attached to this particular octree
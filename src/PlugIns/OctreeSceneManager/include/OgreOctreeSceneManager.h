@@ -104,6 +104,9 @@ public:
     /** Deletes a scene node */
     virtual void destroySceneNode( const String &name );
 
+    /** Deletes an anonymous scene node */
+    virtual void destroySceneNode( const SlotHandle &handle );
+
 
 
     /** Does nothing more */
@@ -131,6 +134,9 @@ public:
     * to a different octant.
     */
     void _updateOctreeNode( OctreeNode * );
+    /** Loose mode version of _updateOctreeNode, relocates the node relative to its current octant.
+    */
+    void _updateLooseOctreeNode( OctreeNode * );
     /** Removes the given octree node */
     void _removeOctreeNode( OctreeNode * );
     /** Adds the Octree Node, starting at the given octree, and recursing at max to the specified depth.
@@ -163,10 +169,14 @@ public:
         mShowBoxes = b;
     };
 
-    void setLooseOctree( bool b )
-    {
-        mLoose = b;
-    };
+    /** Switches between the classic octree and a loose one.
+    @remarks
+    In loose mode, moving nodes stay in their octant for as long as they fit in
+    its culling bounds, and are otherwise moved up the tree only as far as needed.
+    Nodes leaving the world bounds make the tree grow towards them instead of
+    being dumped into the root. The tree is rebuilt when the mode changes.
+    */
+    void setLooseOctree( bool b );
 
 
     /** Resizes the octree to the given size */
@@ -178,6 +188,8 @@ public:
         "Size", AxisAlignedBox *;
         "Depth", int *;
         "ShowOctree", bool *;
+        "LooseOctree", bool *;
+        "Looseness", Real * (must be greater than 1, default 2);
     */
 
     virtual bool setOption( const String &, const void * );
@@ -221,7 +233,12 @@ protected:
     bool mShowBoxes;
 
 
+    /// Loose mode flag, @see setLooseOctree
     bool mLoose;
+    /// Culling bounds scale of the octants
+    Real mLooseness;
+    /// Number of times the loose octree root has grown since it was built
+    int mGrowDepth;
 
     Real mCorners[ 24 ];
     static unsigned long mColors[ 8 ];
@@ -42,15 +42,16 @@ email                : janders@users.sf.net
 
 namespace Ogre
 {
-/** Octree implementation of IntersectionSceneQuery. */
+/** Octree implementation of IntersectionSceneQuery.
+@remarks
+    Uses the sweep and prune broad phase of DefaultIntersectionSceneQuery, which 
+    scales better than looking up the octree nodes around each object.
+*/
 class _OgreOctreePluginExport OctreeIntersectionSceneQuery :  public DefaultIntersectionSceneQuery
 {
 public:
     OctreeIntersectionSceneQuery(SceneManager* creator);
     ~OctreeIntersectionSceneQuery();
-
-    /** See IntersectionSceneQuery. */
-    void execute(IntersectionSceneQueryListener* listener);
 };
 
 /** Octree implementation of RaySceneQuery. */
@@ -50,12 +50,29 @@ bool Octree::_isTwiceSize( const AxisAlignedBox &box ) const
 	if (box.isInfinite())
 		return false;
 
-    Vector3 halfMBoxSize = mBox.getHalfSize();
+    // A child is half our size, and its culling bounds are (looseness - 1)
+    // children bigger, which is how much a box centered in the child may take
+    Vector3 halfMBoxSize = mBox.getHalfSize() * ( mLooseness - 1 );
     Vector3 boxSize = box.getSize();
     return ((boxSize.x <= halfMBoxSize.x) && (boxSize.y <= halfMBoxSize.y) && (boxSize.z <= halfMBoxSize.z));
 
 }
 
+/** Returns true if the box is completely contained by the culling bounds.
+*/
+bool Octree::_isInCullBounds( const AxisAlignedBox &box ) const
+{
+    if ( box.isNull() )
+        return true;
+    if ( box.isInfinite() )
+        return false;
+
+    AxisAlignedBox cullBounds;
+    _getCullBounds( &cullBounds );
+
+    return cullBounds.contains( box );
+}
+
 /** It's assumed the the given box has already been proven to fit into
 * a child.  Since it's a loose octree, only the centers need to be
 * compared to find the appropriate node.
@@ -85,7 +102,8 @@ void Octree::_getChildIndexes( const AxisAlignedBox &box, int *x, int *y, int *z
 
 Octree::Octree( Octree * parent ) 
     : mWireBoundingBox(0),
-      mHalfSize( 0, 0, 0 )
+      mHalfSize( 0, 0, 0 ),
+      mLooseness( parent ? parent->mLooseness : 2 )
 {
     //initialize all children to null.
     for ( int i = 0; i < 2; i++ )
@@ -145,7 +163,58 @@ void Octree::_removeNode( OctreeNode * n )
 
 void Octree::_getCullBounds( AxisAlignedBox *b ) const
 {
-    b -> setExtents( mBox.getMinimum() - mHalfSize, mBox.getMaximum() + mHalfSize );
+    const Vector3 border = mHalfSize * ( mLooseness - 1 );
+    b -> setExtents( mBox.getMinimum() - border, mBox.getMaximum() + border );
+}
+
+int Octree::_getDepth() const
+{
+    int depth = 0;
+
+    for ( Octree *o = mParent; o != 0; o = o->mParent )
+        ++depth;
+
+    return depth;
+}
+
+Octree * Octree::_grow( const Vector3 &towards )
+{
+    assert( mParent == 0 && "Only the root octree can grow" );
+
+    const Vector3 &min = mBox.getMinimum();
+    const Vector3 &max = mBox.getMaximum();
+    const Vector3 size = max - min;
+    const Vector3 center = mBox.getCenter();
+
+    Vector3 newMin = min;
+    Vector3 newMax = max;
+    int index[ 3 ];
+
+    // Grow each axis towards the point, we end up being the child in the opposite corner
+    for ( int i = 0; i < 3; i++ )
+    {
+        if ( towards[ i ] < center[ i ] )
+        {
+            newMin[ i ] -= size[ i ];
+            index[ i ] = 1;
+        }
+        else
+        {
+            newMax[ i ] += size[ i ];
+            index[ i ] = 0;
+        }
+    }
+
+    Octree *newRoot = OGRE_NEW Octree( 0 );
+    newRoot->mLooseness = mLooseness;
+    newRoot->mBox.setExtents( newMin, newMax );
+    newRoot->mHalfSize = ( newMax - newMin ) / 2;
+    newRoot->mChildren[ index[ 0 ] ][ index[ 1 ] ][ index[ 2 ] ] = this;
+    newRoot->mNumNodes = mNumNodes;
+
+    mParent = newRoot;
+
+    return newRoot;
 }
 
 WireBoundingBox* Octree::getWireBoundingBox()
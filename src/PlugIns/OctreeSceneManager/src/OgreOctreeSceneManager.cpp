@@ -290,6 +290,9 @@ unsigned short OctreeSceneManager::mIndexes[ 24 ] = {0, 1, 1, 2, 2, 3, 3, 0,
         0, 6, 6, 5, 5, 1,             //left
         3, 7, 7, 4, 4, 2,             //right
         6, 7, 5, 4 };          //front
+/// How many times the loose octree may double its size to follow nodes that leave the world
+static const int OCTREE_MAX_GROW_DEPTH = 8;
+
 unsigned long OctreeSceneManager::mColors[ 8 ] = {white, white, white, white, white, white, white, white };
 
 
@@ -298,6 +301,8 @@ OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
     AxisAlignedBox b( -10000, -10000, -10000, 10000, 10000, 10000 );
     int depth = 8; 
     mOctree = 0;
+    mLoose = false;
+    mLooseness = 2;
     init( b, depth );
 }
 
@@ -305,6 +310,8 @@ OctreeSceneManager::OctreeSceneManager(const String& name, AxisAlignedBox &box,
 : SceneManager(name)
 {
     mOctree = 0;
+    mLoose = false;
+    mLooseness = 2;
     init( box, max_depth );
 }
 
@@ -320,8 +327,10 @@ void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
         OGRE_DELETE mOctree;
 
     mOctree = OGRE_NEW Octree( 0 );
+    mOctree -> mLooseness = mLooseness;
 
     mMaxDepth = depth;
+    mGrowDepth = 0;
     mBox = box;
 
     mOctree -> mBox = box;
@@ -391,6 +400,14 @@ void OctreeSceneManager::destroySceneNode( const String &name )
     SceneManager::destroySceneNode( name );
 }
 
+void OctreeSceneManager::destroySceneNode( const SlotHandle &handle )
+{
+    if ( hasSceneNode( handle ) )
+        _removeOctreeNode( static_cast < OctreeNode* > ( getSceneNode( handle ) ) );
+
+    SceneManager::destroySceneNode( handle );
+}
+
 bool OctreeSceneManager::getOptionValues( const String & key, StringVector  &refValueList )
 {
     return SceneManager::getOptionValues( key, refValueList );
@@ -402,6 +419,8 @@ bool OctreeSceneManager::getOptionKeys( StringVector & refKeys )
     refKeys.push_back( "Size" );
     refKeys.push_back( "ShowOctree" );
     refKeys.push_back( "Depth" );
+    refKeys.push_back( "LooseOctree" );
+    refKeys.push_back( "Looseness" );
 
     return true;
 }
@@ -418,6 +437,12 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
 	if (!mOctree)
 		return;
 
+    if ( mLoose )
+    {
+        _updateLooseOctreeNode( onode );
+        return ;
+    }
+
     if ( onode -> getOctant() == 0 )
     {
         //if outside the octree, force into the root node.
@@ -440,6 +465,52 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
     }
 }
 
+void OctreeSceneManager::_updateLooseOctreeNode( OctreeNode * onode )
+{
+    const AxisAlignedBox& box = onode -> _getWorldAABB();
+    Octree * octant = onode -> getOctant();
+
+    // Loose bounds let the node wander around its octant without being reinserted
+    if ( octant != 0 && octant -> _isInCullBounds( box ) )
+        return ;
+
+    if ( octant != 0 )
+        _removeOctreeNode( onode );
+
+    if ( box.isInfinite() )
+    {
+        mOctree -> _addNode( onode );
+        return ;
+    }
+
+    // Climb up from the old octant until one can hold the node, instead of
+    // walking down from the root again
+    const Vector3 center = box.getCenter();
+    Octree * target = octant ? octant : mOctree;
+
+    while ( target != 0 && !( target -> mBox.contains( center ) && target -> _isInCullBounds( box ) ) )
+        target = target -> _getParent();
+
+    // Left the world bounds, extend the tree towards the node
+    while ( target == 0 && mGrowDepth < OCTREE_MAX_GROW_DEPTH )
+    {
+        mOctree = mOctree -> _grow( center );
+        ++mGrowDepth;
+
+        if ( mOctree -> mBox.contains( center ) && mOctree -> _isInCullBounds( box ) )
+            target = mOctree;
+    }
+
+    if ( target == 0 )
+    {
+        //too far away even for the grown tree, force into the root node.
+        mOctree -> _addNode( onode );
+        return ;
+    }
+
+    _addOctreeNode( onode, target, target -> _getDepth() );
+}
+
 /** Only removes the node from the octree.  It leaves the octree, even if it's empty.
 */
 void OctreeSceneManager::_removeOctreeNode( OctreeNode * n )
@@ -471,7 +542,7 @@ void OctreeSceneManager::_addOctreeNode( OctreeNode * n, Octree *octant, int dep
 
     //if the octree is twice as big as the scene node,
     //we will add it to a child.
-    if ( ( depth < mMaxDepth ) && octant -> _isTwiceSize( bx ) )
+    if ( ( depth < mMaxDepth + mGrowDepth ) && octant -> _isTwiceSize( bx ) )
     {
         int x, y, z;
         octant -> _getChildIndexes( bx, &x, &y, &z );
@@ -1005,6 +1076,17 @@ void OctreeSceneManager::findNodesIn( const Ray &r, list< SceneNode * >::type &l
     _findNodes( r, list, exclude, false, mOctree );
 }
 
+void OctreeSceneManager::setLooseOctree( bool b )
+{
+    if ( mLoose == b )
+        return;
+
+    mLoose = b;
+    // Nodes are placed differently in each mode, so start from a fresh tree
+    AxisAlignedBox box = mOctree->mBox;
+    resize( box );
+}
+
 void OctreeSceneManager::resize( const AxisAlignedBox &box )
 {
     list< SceneNode * >::type nodes;
@@ -1015,7 +1097,9 @@ void OctreeSceneManager::resize( const AxisAlignedBox &box )
     OGRE_DELETE mOctree;
 
     mOctree = OGRE_NEW Octree( 0 );
+    mOctree->mLooseness = mLooseness;
     mOctree->mBox = box;
+    mGrowDepth = 0;
 
 	const Vector3 min = box.getMinimum();
 	const Vector3 max = box.getMaximum();
@@ -1056,6 +1140,23 @@ bool OctreeSceneManager::setOption( const String & key, const void * val )
         return true;
     }
 
+    else if ( key == "LooseOctree" )
+    {
+        setLooseOctree( * static_cast < const bool * > ( val ) );
+        return true;
+    }
+
+    else if ( key == "Looseness" )
+    {
+        Real looseness = * static_cast < const Real * > ( val );
+        if ( looseness <= 1 )
+            return false;
+        mLooseness = looseness;
+        AxisAlignedBox box = mOctree->mBox;
+        resize(box);
+        return true;
+    }
+
 
     return SceneManager::setOption( key, val );
 
@@ -1084,6 +1185,18 @@ bool OctreeSceneManager::getOption( const String & key, void *val )
         return true;
     }
 
+    else if ( key == "LooseOctree" )
+    {
+        * static_cast < bool * > ( val ) = mLoose;
+        return true;
+    }
+
+    else if ( key == "Looseness" )
+    {
+        * static_cast < Real * > ( val ) = mLooseness;
+        return true;
+    }
+
 
     return SceneManager::getOption( key, val );
 
@@ -54,73 +54,6 @@ OctreeIntersectionSceneQuery::OctreeIntersectionSceneQuery(SceneManager* creator
 OctreeIntersectionSceneQuery::~OctreeIntersectionSceneQuery()
 {}
 //---------------------------------------------------------------------
-void OctreeIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
-{
-    typedef std::pair<MovableObject *, MovableObject *> MovablePair;
-    typedef std::set
-        < std::pair<MovableObject *, MovableObject *> > MovableSet;
-
-    MovableSet set;
-
-	// Iterate over all movable types
-	Root::MovableObjectFactoryIterator factIt = 
-		Root::getSingleton().getMovableObjectFactoryIterator();
-	while(factIt.hasMoreElements())
-	{
-		SceneManager::MovableObjectIterator it = 
-			mParentSceneMgr->getMovableObjectIterator(
-			factIt.getNext()->getType());
-		while( it.hasMoreElements() )
-		{
-
-			MovableObject * e = it.getNext();
-
-			Ogre::list< SceneNode * >::type list;
-			//find the nodes that intersect the AAB
-			static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( e->getWorldBoundingBox(), list, 0 );
-			//grab all moveables from the node that intersect...
-			Ogre::list< SceneNode * >::type::iterator nit = list.begin();
-			while( nit != list.end() )
-			{
-				SceneNode::ObjectIterator oit = (*nit) -> getAttachedObjectIterator();
-				while( oit.hasMoreElements() )
-				{
-					MovableObject * m = oit.getNext();
-
-					if( m != e &&
-							set.find( MovablePair(e,m)) == set.end() &&
-							set.find( MovablePair(m,e)) == set.end() &&
-							(m->getQueryFlags() & mQueryMask) &&
-							(m->getTypeFlags() & mQueryTypeMask) &&
-							m->isInScene() && 
-							e->getWorldBoundingBox().intersects( m->getWorldBoundingBox() ) )
-					{
-						listener -> queryResult( e, m );
-						// deal with attached objects, since they are not directly attached to nodes
-						if (m->getMovableType() == "Entity")
-						{
-							Entity* e2 = static_cast<Entity*>(m);
-							Entity::ChildObjectListIterator childIt = e2->getAttachedObjectIterator();
-							while(childIt.hasMoreElements())
-							{
-								MovableObject* c = childIt.getNext();
-								if (c->getQueryFlags() & mQueryMask && 
-									e->getWorldBoundingBox().intersects( c->getWorldBoundingBox() ))
-								{
-									listener->queryResult(e, c);
-								}
-							}
-						}
-					}
-					set.insert( MovablePair(e,m) );
-
-				}
-				++nit;
-			}
-
-		}
-	}
-}
 /** Creates a custom Octree AAB query */
 OctreeAxisAlignedBoxSceneQuery::OctreeAxisAlignedBoxSceneQuery(SceneManager* creator)
         : DefaultAxisAlignedBoxSceneQuery(creator)
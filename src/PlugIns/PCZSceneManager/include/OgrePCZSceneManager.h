@@ -128,6 +128,13 @@ namespace Ogre
         virtual	SceneNode * createSceneNode ( void );
         /** Creates a PCZSceneNode */
         virtual SceneNode * createSceneNode ( const String &name );
+        /** Creates a named PCZSceneNode, since zones track nodes through the 
+            named node list */
+        virtual SceneNode * createAnonymousSceneNode ( void );
+        /** Creates a named movable object, since zones track lights through 
+            the named object lists */
+        virtual MovableObject * createAnonymousMovableObject ( const String &typeName, 
+            const NameValuePairList* params = 0 );
         /** Creates a specialized PCZCamera */
         virtual Camera * createCamera( const String &name );
 
@@ -43,15 +43,21 @@ Code Style Update	 :
 
 namespace Ogre
 {
-    /** PCZ implementation of IntersectionSceneQuery. */
+    /** PCZ implementation of IntersectionSceneQuery.
+    @remarks
+        Uses the sweep and prune broad phase of DefaultIntersectionSceneQuery, and 
+        only reports the objects sharing a zone, either as their home zone or as a 
+        zone their node is visiting through a portal.
+    */
     class _OgrePCZPluginExport PCZIntersectionSceneQuery :  public DefaultIntersectionSceneQuery
     {
     public:
         PCZIntersectionSceneQuery(SceneManager* creator);
         ~PCZIntersectionSceneQuery();
 
-        /** See IntersectionSceneQuery. */
-        void execute(IntersectionSceneQueryListener* listener);
+    protected:
+        /** See DefaultIntersectionSceneQuery. */
+        bool acceptPair(MovableObject* a, MovableObject* b);
     };
     /** PCZ implementation of AxisAlignedBoxSceneQuery. */
     class _OgrePCZPluginExport PCZAxisAlignedBoxSceneQuery : public DefaultAxisAlignedBoxSceneQuery
@@ -359,6 +359,17 @@ namespace Ogre
         return on;
     }
 
+    SceneNode * PCZSceneManager::createAnonymousSceneNode( void )
+    {
+        return createSceneNode();
+    }
+
+    MovableObject * PCZSceneManager::createAnonymousMovableObject( const String &typeName, 
+        const NameValuePairList* params )
+    {
+        return createMovableObject( typeName, params );
+    }
+
     // Create a camera for the scene
     Camera * PCZSceneManager::createCamera( const String &name )
     {
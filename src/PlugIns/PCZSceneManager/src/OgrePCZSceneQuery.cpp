@@ -52,72 +52,20 @@ namespace Ogre
     PCZIntersectionSceneQuery::~PCZIntersectionSceneQuery()
     {}
     //---------------------------------------------------------------------
-    void PCZIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    bool PCZIntersectionSceneQuery::acceptPair(MovableObject* a, MovableObject* b)
     {
-        typedef std::pair<MovableObject *, MovableObject *> MovablePair;
-        typedef std::set
-            < std::pair<MovableObject *, MovableObject *> > MovableSet;
+        PCZSceneNode * nodeA = static_cast<PCZSceneNode*>(a->getParentSceneNode());
+        PCZSceneNode * nodeB = static_cast<PCZSceneNode*>(b->getParentSceneNode());
+        if (!nodeA || !nodeB || nodeA == nodeB)
+            return true;
 
-        MovableSet set;
-
-	    // Iterate over all movable types
-	    Root::MovableObjectFactoryIterator factIt = 
-		    Root::getSingleton().getMovableObjectFactoryIterator();
-	    while(factIt.hasMoreElements())
-	    {
-		    SceneManager::MovableObjectIterator it = 
-			    mParentSceneMgr->getMovableObjectIterator(
-			    factIt.getNext()->getType());
-		    while( it.hasMoreElements() )
-		    {
-
-			    MovableObject * e = it.getNext();
-                PCZone * zone = ((PCZSceneNode*)(e->getParentSceneNode()))->getHomeZone();
-			    PCZSceneNodeList list;
-			    //find the nodes that intersect the AAB
-			    static_cast<PCZSceneManager*>( mParentSceneMgr ) -> findNodesIn( e->getWorldBoundingBox(), list, zone, 0 );
-			    //grab all moveables from the node that intersect...
-			    PCZSceneNodeList::iterator nit = list.begin();
-			    while( nit != list.end() )
-			    {
-				    SceneNode::ObjectIterator oit = (*nit) -> getAttachedObjectIterator();
-				    while( oit.hasMoreElements() )
-				    {
-					    MovableObject * m = oit.getNext();
-
-					    if( m != e &&
-							set.find( MovablePair(e,m)) == set.end() &&
-							set.find( MovablePair(m,e)) == set.end() &&
-							(m->getQueryFlags() & mQueryMask) &&
-							(m->getTypeFlags() & mQueryTypeMask) &&
-							m->isInScene() && 
-							e->getWorldBoundingBox().intersects( m->getWorldBoundingBox() ) )
-					    {
-						    listener -> queryResult( e, m );
-						    // deal with attached objects, since they are not directly attached to nodes
-						    if (m->getMovableType() == "Entity")
-						    {
-							    Entity* e2 = static_cast<Entity*>(m);
-							    Entity::ChildObjectListIterator childIt = e2->getAttachedObjectIterator();
-							    while(childIt.hasMoreElements())
-							    {
-								    MovableObject* c = childIt.getNext();
-								    if (c->getQueryFlags() & mQueryMask && 
-									    e->getWorldBoundingBox().intersects( c->getWorldBoundingBox() ))
-								    {
-									    listener->queryResult(e, c);
-								    }
-							    }
-						    }
-					    }
-					    set.insert( MovablePair(e,m) );
-
-				    }
-				    ++nit;
-			    }
-
-		    }
-	    }
+        PCZone * zoneA = nodeA->getHomeZone();
+        PCZone * zoneB = nodeB->getHomeZone();
+        if (!zoneA || !zoneB)
+            return true;
+        return zoneA == zoneB || 
+            nodeA->isVisitingZone(zoneB) || 
+            nodeB->isVisitingZone(zoneA);
     }
     /** Creates a custom PCZ AAB query */
     PCZAxisAlignedBoxSceneQuery::PCZAxisAlignedBoxSceneQuery(SceneManager* creator)
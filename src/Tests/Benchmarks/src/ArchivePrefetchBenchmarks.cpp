@@ -0,0 +1,130 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ArchivePrefetchBenchmarks.h"
+#include "OgreFileSystem.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ArchivePrefetchBenchmarks );
+
+namespace
+{
+	const size_t NUM_FILES = 64;
+	const size_t FILE_SIZE = 512 * 1024;
+
+	/// Drops a file from the page cache, so the next read has to go to disk
+	void evict(const String& filename)
+	{
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+		int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd != -1)
+		{
+			fsync(fd);
+			posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+			::close(fd);
+		}
+#else
+		(void)filename;
+#endif
+	}
+
+	struct StorageOrderLess
+	{
+		FileSystemArchive* arch;
+		bool operator()(const String& a, const String& b) const
+		{
+			return arch->getStorageOrder(a) < arch->getStorageOrder(b);
+		}
+	};
+}
+
+void ArchivePrefetchBenchmarks::setUp()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	// Written in a scrambled order, so that declaration order and storage
+	// order differ
+	mFileNames.clear();
+	vector<uchar>::type data(FILE_SIZE, 0x5A);
+	for (size_t i = 0; i < NUM_FILES; ++i)
+	{
+		size_t n = (i * 37) % NUM_FILES;
+		mFileNames.push_back("prefetchBenchmark" + StringConverter::toString(i) + ".dat");
+		DataStreamPtr out = arch.create("prefetchBenchmark" + StringConverter::toString(n) + ".dat");
+		out->write(&data[0], FILE_SIZE);
+	}
+}
+
+void ArchivePrefetchBenchmarks::tearDown()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+	for (size_t i = 0; i < mFileNames.size(); ++i)
+		arch.remove(mFileNames[i]);
+}
+
+unsigned long ArchivePrefetchBenchmarks::readAll(bool prefetch)
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+	for (size_t i = 0; i < mFileNames.size(); ++i)
+		evict(mFileNames[i]);
+
+	Timer timer;
+	StringVector order = mFileNames;
+	if (prefetch)
+	{
+		arch.prefetch(order);
+		StorageOrderLess less = { &arch };
+		std::stable_sort(order.begin(), order.end(), less);
+	}
+
+	vector<uchar>::type data(FILE_SIZE);
+	for (size_t i = 0; i < order.size(); ++i)
+		arch.open(order[i])->read(&data[0], FILE_SIZE);
+	return timer.getMicroseconds();
+}
+
+void ArchivePrefetchBenchmarks::benchmarkColdLoad()
+{
+	unsigned long plain = readAll(false);
+	unsigned long prefetched = readAll(true);
+
+	std::cout << "Cold read of " << NUM_FILES << " files of " << FILE_SIZE / 1024 << "KB: " 
+		<< plain << " us in declaration order, " << prefetched 
+		<< " us prefetched in storage order" << std::endl;
+}
@@ -0,0 +1,126 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "BVHSceneManagerBenchmarks.h"
+#include "OgreRoot.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreBVHTree.h"
+#include "OgreMovableObject.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( BVHSceneManagerBenchmarks );
+
+namespace
+{
+	/// Object with nothing to render and a fixed local bounding box
+	class BoxObject : public MovableObject
+	{
+	protected:
+		AxisAlignedBox mBox;
+		static String msMovableType;
+
+	public:
+		BoxObject(const String& name, const AxisAlignedBox& box)
+			: MovableObject(name), mBox(box) {}
+
+		const String& getMovableType(void) const { return msMovableType; }
+		const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+		Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+		void _updateRenderQueue(RenderQueue* queue) {}
+		void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+	};
+	String BoxObject::msMovableType = "BoxObject";
+
+	Real nextRandom(uint32& seed)
+	{
+		seed = seed * 1664525 + 1013904223;
+		return (Real)(seed >> 8) / (Real)(1 << 24);
+	}
+
+	Vector3 randomVector(uint32& seed, Real range)
+	{
+		return Vector3((nextRandom(seed) - 0.5f) * range,
+			(nextRandom(seed) - 0.5f) * range, (nextRandom(seed) - 0.5f) * range);
+	}
+}
+
+void BVHSceneManagerBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "BVHSceneManagerBenchmarks.log");
+	mSceneMgr = OGRE_NEW BVHSceneManager("BVHBenchmark");
+}
+
+void BVHSceneManagerBenchmarks::tearDown()
+{
+	OGRE_DELETE mSceneMgr;
+	OGRE_DELETE mRoot;
+}
+
+void BVHSceneManagerBenchmarks::benchmarkMovingObjects()
+{
+	// Every object moving a little every frame, most of them shouldn't touch the tree
+	const size_t numObjects = 100000;
+	const size_t numFrames = 10;
+
+	vector<SceneNode*>::type nodes;
+	vector<BoxObject*>::type objects;
+	uint32 seed = 12345;
+	for (size_t i = 0; i < numObjects; ++i)
+	{
+		Real size = 1 + nextRandom(seed) * 20;
+		BoxObject* obj = OGRE_NEW BoxObject("BoxObject" + StringConverter::toString(i),
+			AxisAlignedBox(-size, -size, -size, size, size, size));
+		SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+			randomVector(seed, 2000));
+		node->attachObject(obj);
+		nodes.push_back(node);
+		objects.push_back(obj);
+	}
+	mSceneMgr->_updateSceneGraph(0);
+
+	Timer timer;
+	for (size_t frame = 0; frame < numFrames; ++frame)
+	{
+		for (size_t i = 0; i < nodes.size(); ++i)
+			nodes[i]->translate(randomVector(seed, 10));
+		mSceneMgr->_updateSceneGraph(0);
+	}
+	unsigned long elapsed = timer.getMicroseconds();
+
+	int height = 0;
+	mSceneMgr->getOption("TreeHeight", &height);
+	std::cout << "BVHSceneManager, " << numObjects << " objects moving for " << numFrames 
+		<< " frames: " << elapsed << " us, tree height " << height << std::endl;
+
+	mSceneMgr->clearScene();
+	for (size_t i = 0; i < objects.size(); ++i)
+		OGRE_DELETE objects[i];
+}
@@ -0,0 +1,82 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "IdStringBenchmarks.h"
+#include "OgreIdString.h"
+#include "OgreRoot.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( IdStringBenchmarks );
+
+void IdStringBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "IdStringBenchmarks.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+}
+
+void IdStringBenchmarks::tearDown()
+{
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void IdStringBenchmarks::benchmarkResourceLookup()
+{
+	MaterialManager& mgr = MaterialManager::getSingleton();
+	vector<String>::type names;
+	vector<IdString>::type ids;
+	for (int i = 0; i < 2000; ++i)
+	{
+		names.push_back("IdStringBenchmarks/Some/Fairly/Long/Material/Path/" + StringConverter::toString(i));
+		ids.push_back(IdString(names.back()));
+		mgr.create(names.back(), ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	}
+
+	const size_t iterations = 100;
+	size_t found = 0;
+	Timer timer;
+	for (size_t n = 0; n < iterations; ++n)
+		for (size_t i = 0; i < names.size(); ++i)
+			found += mgr.getByName(names[i]).isNull() ? 0 : 1;
+	unsigned long stringTime = timer.getMicroseconds();
+
+	timer.reset();
+	for (size_t n = 0; n < iterations; ++n)
+		for (size_t i = 0; i < ids.size(); ++i)
+			found += mgr.getByName(ids[i]).isNull() ? 0 : 1;
+	unsigned long idTime = timer.getMicroseconds();
+
+	std::cout << "Resource lookup of " << iterations * names.size() << " names: String " 
+		<< stringTime << " us, IdString " << idTime << " us, " << found << " found" << std::endl;
+}
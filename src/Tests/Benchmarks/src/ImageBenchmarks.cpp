@@ -0,0 +1,81 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ImageBenchmarks.h"
+#include "OgreImage.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreTimer.h"
+#include <cstdlib>
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ImageBenchmarks );
+
+void ImageBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "ImageBenchmarks.log");
+}
+
+void ImageBenchmarks::tearDown()
+{
+	OGRE_DELETE mRoot;
+}
+
+void ImageBenchmarks::benchmarkScale()
+{
+	size_t size = PixelUtil::getMemorySize(4096, 4096, 1, PF_A8R8G8B8);
+	uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+	srand(0);
+	for (size_t i = 0; i < size; ++i)
+		data[i] = (uchar)rand();
+	Image large;
+	large.loadDynamicImage(data, 4096, 4096, 1, PF_A8R8G8B8, true);
+
+	vector<uchar>::type scaled(PixelUtil::getMemorySize(2000, 2000, 1, PF_A8R8G8B8));
+	PixelBox scaledBox(2000, 2000, 1, PF_A8R8G8B8, &scaled[0]);
+	Image::Filter filters[2] = { Image::FILTER_BILINEAR, Image::FILTER_LANCZOS };
+	const char* filterNames[2] = { "bilinear", "lanczos" };
+	for (int f = 0; f < 2; ++f)
+	{
+		Timer timer;
+		Image::scale(large.getPixelBox(), scaledBox, filters[f]);
+		unsigned long singleTime = timer.getMicroseconds();
+
+		// Root only starts its work queue with the first window
+		mRoot->getWorkQueue()->startup();
+		timer.reset();
+		Image::scale(large.getPixelBox(), scaledBox, filters[f]);
+		unsigned long sharedTime = timer.getMicroseconds();
+		mRoot->getWorkQueue()->shutdown();
+
+		std::cout << "Image::scale, 4096x4096 to 2000x2000 " << filterNames[f] << ": " 
+			<< singleTime << " us on the calling thread, " << sharedTime 
+			<< " us shared with the workers" << std::endl;
+	}
+}
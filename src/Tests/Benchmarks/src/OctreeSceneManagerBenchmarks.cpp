@@ -0,0 +1,141 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OctreeSceneManagerBenchmarks.h"
+#include "OgreRoot.h"
+#include "OgreOctreeSceneManager.h"
+#include "OgreMovableObject.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( OctreeSceneManagerBenchmarks );
+
+namespace
+{
+	/// Object with nothing to render and a fixed local bounding box
+	class BoxObject : public MovableObject
+	{
+	protected:
+		AxisAlignedBox mBox;
+		static String msMovableType;
+
+	public:
+		BoxObject(const String& name, const AxisAlignedBox& box)
+			: MovableObject(name), mBox(box) {}
+
+		const String& getMovableType(void) const { return msMovableType; }
+		const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+		Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+		void _updateRenderQueue(RenderQueue* queue) {}
+		void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+	};
+	String BoxObject::msMovableType = "BoxObject";
+
+	/// Cheap deterministic generator so loose and classic runs see the same scene
+	Real nextRandom(uint32& seed)
+	{
+		seed = seed * 1664525 + 1013904223;
+		return (Real)(seed >> 8) / (Real)(1 << 24);
+	}
+}
+
+void OctreeSceneManagerBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "OctreeSceneManagerBenchmarks.log");
+}
+
+void OctreeSceneManagerBenchmarks::tearDown()
+{
+	OGRE_DELETE mRoot;
+}
+
+unsigned long OctreeSceneManagerBenchmarks::moveObjects(OctreeSceneManager* sceneMgr,
+	size_t numObjects, size_t numFrames)
+{
+	const Real worldSize = 2000;
+	vector<SceneNode*>::type nodes;
+	vector<BoxObject*>::type objects;
+	uint32 seed = 12345;
+	for (size_t i = 0; i < numObjects; ++i)
+	{
+		Real size = 1 + nextRandom(seed) * 20;
+		BoxObject* obj = OGRE_NEW BoxObject("BoxObject" + StringConverter::toString(i),
+			AxisAlignedBox(-size, -size, -size, size, size, size));
+		SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+			Vector3((nextRandom(seed) - 0.5f) * worldSize,
+				(nextRandom(seed) - 0.5f) * worldSize,
+				(nextRandom(seed) - 0.5f) * worldSize));
+		node->attachObject(obj);
+		nodes.push_back(node);
+		objects.push_back(obj);
+	}
+	sceneMgr->_updateSceneGraph(0);
+
+	Timer timer;
+	seed = 54321;
+	for (size_t frame = 0; frame < numFrames; ++frame)
+	{
+		for (size_t i = 0; i < nodes.size(); ++i)
+		{
+			// Small steps, like most moving objects do from one frame to the next
+			nodes[i]->translate((nextRandom(seed) - 0.5f) * 10,
+				(nextRandom(seed) - 0.5f) * 10, (nextRandom(seed) - 0.5f) * 10);
+		}
+		sceneMgr->_updateSceneGraph(0);
+	}
+	unsigned long elapsed = timer.getMicroseconds();
+
+	sceneMgr->clearScene();
+	for (size_t i = 0; i < objects.size(); ++i)
+		OGRE_DELETE objects[i];
+	return elapsed;
+}
+
+void OctreeSceneManagerBenchmarks::benchmarkMovingObjects()
+{
+	// Compares both modes on a large scene with every object moving every frame
+	const size_t numObjects = 100000;
+	const size_t numFrames = 10;
+
+	OctreeSceneManager* sceneMgr = OGRE_NEW OctreeSceneManager("MovingObjects");
+	AxisAlignedBox worldBox(-1000, -1000, -1000, 1000, 1000, 1000);
+	sceneMgr->setOption("Size", &worldBox);
+
+	unsigned long classicTime = moveObjects(sceneMgr, numObjects, numFrames);
+
+	bool loose = true;
+	sceneMgr->setOption("LooseOctree", &loose);
+	unsigned long looseTime = moveObjects(sceneMgr, numObjects, numFrames);
+
+	std::cout << "OctreeSceneManager, " << numObjects << " objects moving for " << numFrames 
+		<< " frames: classic " << classicTime << " us, loose " << looseTime << " us" << std::endl;
+
+	OGRE_DELETE sceneMgr;
+}
@@ -0,0 +1,140 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PixelFormatBenchmarks.h"
+#include "OgrePixelFormat.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreTimer.h"
+#include <cstdlib>
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( PixelFormatBenchmarks );
+
+void PixelFormatBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "PixelFormatBenchmarks.log");
+}
+
+void PixelFormatBenchmarks::tearDown()
+{
+	OGRE_DELETE mRoot;
+}
+
+void PixelFormatBenchmarks::benchmarkConversion()
+{
+	// The conversions of the texture pipeline: loading, render targets and readback
+	const PixelFormat pairs[][2] = {
+		{PF_A8R8G8B8, PF_A8B8G8R8}, {PF_A8B8G8R8, PF_B8G8R8A8}, {PF_R8G8B8A8, PF_A8R8G8B8},
+		{PF_X8R8G8B8, PF_A8B8G8R8}, {PF_R8G8B8, PF_A8R8G8B8}, {PF_L8, PF_A8R8G8B8},
+		{PF_A8R8G8B8, PF_FLOAT32_RGBA}, {PF_FLOAT32_RGBA, PF_A8R8G8B8},
+		{PF_A8B8G8R8, PF_FLOAT16_RGBA}, {PF_FLOAT16_RGBA, PF_A8B8G8R8},
+		{PF_FLOAT16_RGBA, PF_FLOAT32_RGBA}, {PF_FLOAT32_RGBA, PF_FLOAT16_RGBA},
+		{PF_FLOAT16_RGB, PF_FLOAT32_RGB}, {PF_FLOAT32_RGB, PF_FLOAT16_RGB},
+		{PF_FLOAT16_GR, PF_FLOAT32_GR}, {PF_FLOAT32_R, PF_L8}, {PF_R8G8B8, PF_FLOAT32_RGB}
+	};
+	const size_t width = 1024, height = 1024;
+	const size_t bytes = width * height * 16;
+	vector<uint8>::type input(bytes), output(bytes);
+	srand(0);
+	for (size_t i = 0; i < bytes; ++i)
+		input[i] = (uint8)rand();
+
+	for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); ++p)
+	{
+		PixelBox srcBox(width, height, 1, pairs[p][0], &input[0]);
+		PixelBox dstBox(width, height, 1, pairs[p][1], &output[0]);
+
+		Timer timer;
+		PixelUtil::bulkPixelConversion(srcBox, dstBox);
+		unsigned long bulkTime = timer.getMicroseconds();
+
+		// What bulkPixelConversion falls back to without a faster path
+		size_t srcPixelSize = PixelUtil::getNumElemBytes(pairs[p][0]);
+		size_t dstPixelSize = PixelUtil::getNumElemBytes(pairs[p][1]);
+		float r, g, b, a;
+		timer.reset();
+		for (size_t i = 0; i < width * height; ++i)
+		{
+			PixelUtil::unpackColour(&r, &g, &b, &a, pairs[p][0], &input[i * srcPixelSize]);
+			PixelUtil::packColour(r, g, b, a, pairs[p][1], &output[i * dstPixelSize]);
+		}
+		unsigned long naiveTime = timer.getMicroseconds();
+
+		std::cout << "bulkPixelConversion " << PixelUtil::getFormatName(pairs[p][0]) << " -> " 
+			<< PixelUtil::getFormatName(pairs[p][1]) << ", " << width << "x" << height << ": " 
+			<< bulkTime << " us, " << naiveTime << " us pixel by pixel" << std::endl;
+	}
+}
+
+void PixelFormatBenchmarks::benchmarkBlockCompression()
+{
+	const size_t width = 2048, height = 2048;
+	vector<uint8>::type image(width * height * 4);
+	srand(0);
+	for (size_t y = 0; y < height; ++y)
+	{
+		for (size_t x = 0; x < width; ++x)
+		{
+			uint8* p = &image[(y * width + x) * 4];
+			p[0] = (uint8)(x * 255 / width);
+			p[1] = (uint8)std::min<int>(255, y * 255 / height + rand() % 8);
+			p[2] = (uint8)((x + y) * 255 / (width + height));
+			p[3] = ((x / 16 + y / 16) % 3) ? 0xFF : 0;
+		}
+	}
+	PixelBox src(width, height, 1, PF_BYTE_RGBA, &image[0]);
+	vector<uint8>::type decoded(image.size());
+	PixelBox dst(width, height, 1, PF_BYTE_RGBA, &decoded[0]);
+
+	const PixelFormat formats[] = { PF_DXT1, PF_DXT5, PF_BC4_UNORM, PF_BC5_UNORM };
+	for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+	{
+		vector<uint8>::type blocks(PixelUtil::getMemorySize(width, height, 1, formats[f]));
+		PixelBox compressed(width, height, 1, formats[f], &blocks[0]);
+
+		Timer timer;
+		PixelUtil::bulkPixelConversion(src, compressed);
+		unsigned long singleTime = timer.getMicroseconds();
+
+		// Root only starts its work queue with the first window
+		mRoot->getWorkQueue()->startup();
+		timer.reset();
+		PixelUtil::bulkPixelConversion(src, compressed);
+		unsigned long sharedTime = timer.getMicroseconds();
+		timer.reset();
+		PixelUtil::bulkPixelConversion(compressed, dst);
+		unsigned long decodeTime = timer.getMicroseconds();
+		mRoot->getWorkQueue()->shutdown();
+
+		std::cout << "Compressing " << width << "x" << height << " to " << PixelUtil::getFormatName(formats[f])
+			<< ": " << singleTime << " us on the calling thread, " << sharedTime 
+			<< " us shared with the workers, decompressing " << decodeTime << " us" << std::endl;
+	}
+}
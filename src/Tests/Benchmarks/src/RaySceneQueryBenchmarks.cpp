@@ -0,0 +1,153 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RaySceneQueryBenchmarks.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreEntity.h"
+#include "OgreManualObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreMeshManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreStringConverter.h"
+#include "OgreWorkQueue.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( RaySceneQueryBenchmarks );
+
+namespace
+{
+	MeshPtr createSphereMesh(const String& name)
+	{
+		const size_t rings = 16, segments = 24;
+		ManualObject sphere("SphereBuilder");
+		sphere.begin("RayQueryBenchmarks", RenderOperation::OT_TRIANGLE_LIST);
+		for (size_t r = 0; r <= rings; ++r)
+		{
+			Radian theta(Math::PI * r / rings);
+			for (size_t s = 0; s <= segments; ++s)
+			{
+				Radian phi(Math::TWO_PI * s / segments);
+				sphere.position(Math::Sin(theta) * Math::Cos(phi), Math::Cos(theta), 
+					Math::Sin(theta) * Math::Sin(phi));
+			}
+		}
+		for (uint32 r = 0; r < rings; ++r)
+		{
+			for (uint32 s = 0; s < segments; ++s)
+			{
+				uint32 first = r * (segments + 1) + s;
+				uint32 second = first + segments + 1;
+				sphere.triangle(first, second, second + 1);
+				sphere.triangle(first, second + 1, first + 1);
+			}
+		}
+		sphere.end();
+		return sphere.convertToMesh(name);
+	}
+
+	Ray randomRay(Real range)
+	{
+		Vector3 origin(Math::RangeRandom(-range, range), Math::RangeRandom(-range, range), 
+			Math::RangeRandom(-range, range));
+		Vector3 target(Math::RangeRandom(-range, range) * 0.5f, Math::RangeRandom(-range, range) * 0.5f,
+			Math::RangeRandom(-range, range) * 0.5f);
+		return Ray(origin, (target - origin).normalisedCopy());
+	}
+}
+
+void RaySceneQueryBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "RaySceneQueryBenchmarks.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+	MaterialPtr material = MaterialManager::getSingleton().create("RayQueryBenchmarks", 
+		ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	material->removeAllTechniques();
+	mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+	// Root only starts its work queue with the first window
+	mRoot->getWorkQueue()->startup();
+}
+
+void RaySceneQueryBenchmarks::tearDown()
+{
+	mRoot->getWorkQueue()->shutdown();
+	mRoot->destroySceneManager(mSceneMgr);
+	MeshManager::getSingleton().removeAll();
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void RaySceneQueryBenchmarks::benchmarkBatch()
+{
+	MeshPtr mesh = createSphereMesh("RayQueryBenchmarksSphere.mesh");
+	for (size_t i = 0; i < 300; ++i)
+	{
+		Entity* entity = mSceneMgr->createEntity("Sphere" + StringConverter::toString(i), mesh->getName());
+		SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(
+			Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200)));
+		node->setScale(Vector3(Math::RangeRandom(2, 20)));
+		node->attachObject(entity);
+	}
+	mSceneMgr->_updateSceneGraph(0);
+
+	RayList rays;
+	for (size_t i = 0; i < 2000; ++i)
+		rays.push_back(randomRay(400));
+
+	RaySceneQuery* query = mSceneMgr->createRayQuery(Ray());
+	query->setSortByDistance(true, 5);
+
+	for (int triangles = 0; triangles < 2; ++triangles)
+	{
+		query->setQueryTriangles(triangles != 0);
+
+		Timer timer;
+		size_t numHits = 0;
+		for (size_t i = 0; i < rays.size(); ++i)
+		{
+			query->setRay(rays[i]);
+			numHits += query->execute().size();
+		}
+		unsigned long singleTime = timer.getMicroseconds();
+
+		timer.reset();
+		RaySceneQueryResultList results;
+		query->executeBatch(rays, results);
+		unsigned long batchTime = timer.getMicroseconds();
+
+		std::cout << "RaySceneQuery, " << rays.size() << " rays" << (triangles ? " with triangles" : "")
+			<< ", " << numHits << " hits: " << singleTime << " us one by one, " 
+			<< batchTime << " us batched" << std::endl;
+	}
+
+	mSceneMgr->destroyQuery(query);
+	mSceneMgr->destroyAllEntities();
+}
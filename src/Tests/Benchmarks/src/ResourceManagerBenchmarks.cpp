@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ResourceManagerBenchmarks.h"
+#include "OgreRoot.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ResourceManagerBenchmarks );
+
+namespace
+{
+	const int NUM_NAMES = 1000;
+
+	String lookupName(int i)
+	{
+		return "ResourceManagerBenchmarks/" + StringConverter::toString(i);
+	}
+
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+	/// Looks names up over and over until told to stop
+	struct LookupWorker OGRE_THREAD_WORKER_INHERIT
+	{
+		const vector<String>::type* names;
+		const bool* stop;
+		size_t* lookups;
+
+		void operator()()
+		{
+			MaterialManager& mgr = MaterialManager::getSingleton();
+			size_t n = 0;
+			while (!*(volatile const bool*)stop)
+			{
+				for (size_t i = 0; i < names->size(); ++i, ++n)
+					mgr.getByName((*names)[i]);
+			}
+			*lookups = n;
+		}
+		void run() { (*this)(); }
+	};
+
+	/// Runs numThreads lookup threads while this thread creates numCreates materials, returns lookups per second
+	double runLookups(const vector<String>::type& names, size_t numThreads, int numCreates, int createBase)
+	{
+		typedef vector<OGRE_THREAD_TYPE*>::type ThreadList;
+		vector<size_t>::type lookups(numThreads);
+		vector<LookupWorker>::type workers(numThreads);
+		bool stop = false;
+		ThreadList threads;
+
+		Timer timer;
+		for (size_t t = 0; t < numThreads; ++t)
+		{
+			LookupWorker w = { &names, &stop, &lookups[t] };
+			workers[t] = w;
+			OGRE_THREAD_CREATE(thread, workers[t]);
+			threads.push_back(thread);
+		}
+		for (int i = 0; i < numCreates; ++i)
+		{
+			MaterialManager::getSingleton().create(lookupName(createBase + i), 
+				ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+		}
+		OGRE_THREAD_SLEEP(200)
+		*(volatile bool*)&stop = true;
+
+		size_t total = 0;
+		for (size_t t = 0; t < numThreads; ++t)
+		{
+			threads[t]->join();
+			OGRE_THREAD_DESTROY(threads[t]);
+			total += lookups[t];
+		}
+		return total / (timer.getMicroseconds() / 1000000.0);
+	}
+#endif
+}
+
+void ResourceManagerBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "ResourceManagerBenchmarks.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+}
+
+void ResourceManagerBenchmarks::tearDown()
+{
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void ResourceManagerBenchmarks::benchmarkConcurrentLookups()
+{
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+	vector<String>::type names;
+	for (int i = 0; i < NUM_NAMES; ++i)
+	{
+		names.push_back(lookupName(i));
+		MaterialManager::getSingleton().create(names.back(), 
+			ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	}
+
+	int createBase = NUM_NAMES;
+	size_t numThreads[] = { 1, 2, 4 };
+	for (size_t i = 0; i < sizeof(numThreads) / sizeof(numThreads[0]); ++i)
+	{
+		double rate = runLookups(names, numThreads[i], 500, createBase);
+		createBase += 500;
+		std::cout << "getByName with " << numThreads[i] << " threads while creating: " 
+			<< (size_t)(rate / 1000) << "k lookups/s" << std::endl;
+	}
+#endif
+}
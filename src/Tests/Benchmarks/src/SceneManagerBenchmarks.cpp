@@ -0,0 +1,109 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SceneManagerBenchmarks.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreEntity.h"
+#include "OgreManualObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreMeshManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( SceneManagerBenchmarks );
+
+void SceneManagerBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "SceneManagerBenchmarks.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+	MaterialPtr material = MaterialManager::getSingleton().create("SceneManagerBenchmarks", 
+		ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	material->removeAllTechniques();
+	mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+}
+
+void SceneManagerBenchmarks::tearDown()
+{
+	mRoot->destroySceneManager(mSceneMgr);
+	MeshManager::getSingleton().removeAll();
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void SceneManagerBenchmarks::benchmarkAnonymousChurn()
+{
+	ManualObject box("BoxBuilder");
+	box.begin("SceneManagerBenchmarks", RenderOperation::OT_TRIANGLE_LIST);
+	box.position(-1, -1, -1);
+	box.position(1, -1, -1);
+	box.position(1, 1, 1);
+	box.triangle(0, 1, 2);
+	box.end();
+	MeshPtr mesh = box.convertToMesh("SceneManagerBenchmarksBox.mesh");
+
+	SceneNode* root = mSceneMgr->getRootSceneNode();
+	const size_t count = 20000;
+	vector<SceneNode*>::type nodes(count);
+	vector<Entity*>::type entities(count);
+
+	Timer timer;
+	for (size_t i = 0; i < count; ++i)
+	{
+		nodes[i] = root->createChildSceneNode();
+		entities[i] = mSceneMgr->createEntity(mesh);
+		nodes[i]->attachObject(entities[i]);
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		mSceneMgr->destroyEntity(entities[i]);
+		mSceneMgr->destroySceneNode(nodes[i]);
+	}
+	unsigned long namedTime = timer.getMicroseconds();
+
+	timer.reset();
+	for (size_t i = 0; i < count; ++i)
+	{
+		nodes[i] = mSceneMgr->createAnonymousSceneNode();
+		root->addChild(nodes[i]);
+		entities[i] = mSceneMgr->createAnonymousEntity(mesh);
+		nodes[i]->attachObject(entities[i]);
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		mSceneMgr->destroyMovableObject(entities[i]);
+		mSceneMgr->destroySceneNode(nodes[i]);
+	}
+	unsigned long anonymousTime = timer.getMicroseconds();
+
+	std::cout << "SceneManager, " << count << " nodes and entities created and destroyed: "
+		<< namedTime << " us named, " << anonymousTime << " us anonymous" << std::endl;
+}
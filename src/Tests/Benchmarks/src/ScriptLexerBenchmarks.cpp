@@ -0,0 +1,87 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ScriptLexerBenchmarks.h"
+#include "OgreScriptLexer.h"
+#include "OgreScriptParser.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ScriptLexerBenchmarks );
+
+void ScriptLexerBenchmarks::setUp()
+{
+}
+
+void ScriptLexerBenchmarks::tearDown()
+{
+}
+
+void ScriptLexerBenchmarks::benchmarkParse()
+{
+	StringStream script;
+	for (int i = 0; i < 2000; ++i)
+	{
+		script << "material Test/Material" << i << "\n{\n\ttechnique\n\t{\n\t\tpass\n\t\t{\n"
+			<< "\t\t\tambient 0.5 0.5 0.5 1\n\t\t\tdiffuse " << i * 0.001 << " 0.25 0.75 1\n"
+			<< "\t\t\tscene_blend alpha_blend\n\t\t\ttexture_unit\n\t\t\t{\n"
+			<< "\t\t\t\ttexture \"Texture" << i << ".png\"\n\t\t\t\tscroll_anim 0.1 0.2\n"
+			<< "\t\t\t}\n\t\t}\n\t}\n}\n";
+	}
+	String str = script.str();
+	String source = "ScriptLexerBenchmarks/Performance.material";
+	ScriptLexer lexer;
+	ScriptParser parser;
+
+	// Best of a few runs, since parsing time is dominated by node allocation
+	unsigned long tokenTime = ~0UL, tokenParseTime = ~0UL, refTime = ~0UL, refParseTime = ~0UL;
+	ConcreteNodeListPtr nodes, refNodes;
+	ScriptTokenRefList refs;
+	Timer timer;
+	for (int n = 0; n < 5; ++n)
+	{
+		timer.reset();
+		ScriptTokenListPtr tokens = lexer.tokenize(str, source);
+		tokenTime = std::min(tokenTime, timer.getMicroseconds());
+		timer.reset();
+		nodes = parser.parse(tokens);
+		tokenParseTime = std::min(tokenParseTime, timer.getMicroseconds());
+
+		timer.reset();
+		lexer.tokenize(str, refs);
+		refTime = std::min(refTime, timer.getMicroseconds());
+		timer.reset();
+		refNodes = parser.parse(str, refs, source);
+		refParseTime = std::min(refParseTime, timer.getMicroseconds());
+	}
+
+	std::cout << "Lexing and parsing " << refs.size() << " tokens: ScriptTokenList "
+		<< tokenTime << " + " << tokenParseTime << " us, ScriptTokenRefList "
+		<< refTime << " + " << refParseTime << " us" << std::endl;
+}
@@ -0,0 +1,129 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "StringBenchmarks.h"
+#include "OgreStringConverter.h"
+#include "OgreVector3.h"
+#include "OgreColourValue.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( StringBenchmarks );
+
+namespace
+{
+	// Stream based conversions, as StringConverter used to do them
+	template <typename T>
+	T streamParse(const String& val, T defaultValue)
+	{
+		StringStream str(val);
+		T ret = defaultValue;
+		if (!(str >> ret))
+			return defaultValue;
+		return ret;
+	}
+	Vector3 streamParseVector3(const String& val)
+	{
+		vector<String>::type vec = StringUtil::split(val);
+		if (vec.size() != 3)
+			return Vector3::ZERO;
+		return Vector3(streamParse<Real>(vec[0], 0), streamParse<Real>(vec[1], 0), 
+			streamParse<Real>(vec[2], 0));
+	}
+	ColourValue streamParseColourValue(const String& val)
+	{
+		vector<String>::type vec = StringUtil::split(val);
+		if (vec.size() != 4)
+			return ColourValue::Black;
+		return ColourValue(streamParse<Real>(vec[0], 0), streamParse<Real>(vec[1], 0), 
+			streamParse<Real>(vec[2], 0), streamParse<Real>(vec[3], 0));
+	}
+	String streamToString(const ColourValue& val)
+	{
+		StringStream stream;
+		stream << val.r << " " << val.g << " " << val.b << " " << val.a;
+		return stream.str();
+	}
+}
+
+void StringBenchmarks::setUp()
+{
+}
+
+void StringBenchmarks::tearDown()
+{
+}
+
+void StringBenchmarks::benchmarkConverter()
+{
+	// The kind of values found in material scripts
+	vector<String>::type values;
+	for (int i = 0; i < 2000; ++i)
+	{
+		values.push_back(StringConverter::toString(ColourValue(i * 0.001f, 0.5f, 1.0f - i * 0.0005f, 1)));
+		values.push_back(StringConverter::toString(Vector3(i * 1.5f, -i * 0.25f, 100)));
+		values.push_back(StringConverter::toString(i * 0.125f));
+	}
+	size_t bytes = 0;
+	for (size_t i = 0; i < values.size(); ++i)
+		bytes += values[i].size();
+
+	const size_t iterations = 20;
+	Real sum = 0;
+	Timer timer;
+	for (size_t n = 0; n < iterations; ++n)
+	{
+		for (size_t i = 0; i < values.size(); i += 3)
+		{
+			ColourValue c = streamParseColourValue(values[i]);
+			sum += c.r + streamParseVector3(values[i + 1]).x + streamParse<Real>(values[i + 2], 0);
+			sum += streamToString(c).size();
+		}
+	}
+	unsigned long streamTime = timer.getMicroseconds();
+
+	timer.reset();
+	for (size_t n = 0; n < iterations; ++n)
+	{
+		for (size_t i = 0; i < values.size(); i += 3)
+		{
+			ColourValue c = StringConverter::parseColourValue(values[i]);
+			sum += c.r + StringConverter::parseVector3(values[i + 1]).x + 
+				StringConverter::parseReal(values[i + 2]);
+			sum += StringConverter::toString(c).size();
+		}
+	}
+	unsigned long fastTime = timer.getMicroseconds();
+
+	double mb = double(bytes * iterations) / (1024 * 1024);
+	std::cout << "Parsing and formatting " << values.size() * iterations 
+		<< " script values: streams " << streamTime << " us (" 
+		<< mb / (streamTime / 1e6) << " MB/s), StringConverter " << fastTime << " us ("
+		<< mb / (fastTime / 1e6) << " MB/s), checksum " << sum << std::endl;
+}
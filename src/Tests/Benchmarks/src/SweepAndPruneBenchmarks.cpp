@@ -0,0 +1,107 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SweepAndPruneBenchmarks.h"
+#include "OgreSweepAndPrune.h"
+#include "OgreManualObject.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( SweepAndPruneBenchmarks );
+
+namespace
+{
+	/// Only counts the pairs
+	class PairCounter : public SweepAndPrune::Listener
+	{
+	public:
+		size_t count;
+
+		PairCounter() : count(0) {}
+
+		bool overlapFound(MovableObject* a, MovableObject* b)
+		{
+			++count;
+			return true;
+		}
+	};
+}
+
+void SweepAndPruneBenchmarks::setUp()
+{
+}
+
+void SweepAndPruneBenchmarks::tearDown()
+{
+}
+
+void SweepAndPruneBenchmarks::benchmarkLargeScene()
+{
+	const size_t numBoxes = 20000;
+	const Real worldSize = 400;
+	vector<MovableObject*>::type objects;
+	vector<AxisAlignedBox>::type boxes;
+	for (size_t i = 0; i < numBoxes; ++i)
+	{
+		Vector3 centre(Math::RangeRandom(-worldSize, worldSize),
+			Math::RangeRandom(-worldSize, worldSize), Math::RangeRandom(-worldSize, worldSize));
+		Vector3 halfSize(Math::RangeRandom(0.5f, 10), Math::RangeRandom(0.5f, 10), 
+			Math::RangeRandom(0.5f, 10));
+		boxes.push_back(AxisAlignedBox(centre - halfSize, centre + halfSize));
+		objects.push_back(OGRE_NEW ManualObject("Box" + StringConverter::toString(i)));
+	}
+
+	Timer timer;
+	SweepAndPrune broadPhase;
+	for (size_t i = 0; i < objects.size(); ++i)
+		broadPhase.addObject(objects[i], boxes[i]);
+	PairCounter counter;
+	broadPhase.findOverlaps(&counter);
+	unsigned long sweepTime = timer.getMicroseconds();
+
+	timer.reset();
+	size_t expected = 0;
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		for (size_t j = i + 1; j < boxes.size(); ++j)
+		{
+			if (boxes[i].intersects(boxes[j]))
+				++expected;
+		}
+	}
+	unsigned long bruteForceTime = timer.getMicroseconds();
+
+	CPPUNIT_ASSERT_EQUAL(expected, counter.count);
+	std::cout << "SweepAndPrune, " << objects.size() << " objects, " << expected 
+		<< " pairs: " << sweepTime << " us, brute force " << bruteForceTime << " us" << std::endl;
+
+	for (size_t i = 0; i < objects.size(); ++i)
+		OGRE_DELETE objects[i];
+}
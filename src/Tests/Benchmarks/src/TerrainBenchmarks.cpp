@@ -0,0 +1,184 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "TerrainBenchmarks.h"
+#include "OgreTimer.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TerrainBenchmarks );
+
+void TerrainBenchmarks::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "TerrainBenchmarks.log");
+	mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+	mOptions = OGRE_NEW TerrainGlobalOptions();
+	// Root only starts its work queue with the first window
+	mRoot->getWorkQueue()->startup();
+}
+
+void TerrainBenchmarks::tearDown()
+{
+	mRoot->getWorkQueue()->shutdown();
+	OGRE_DELETE mOptions;
+	OGRE_DELETE mRoot;
+}
+
+Terrain* TerrainBenchmarks::createHillsTerrain(uint16 size)
+{
+	Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+
+	float* heights = OGRE_ALLOC_T(float, size * size, MEMCATEGORY_GEOMETRY);
+	Real freq = 513.0f / size;
+	for (uint16 y = 0; y < size; ++y)
+		for (uint16 x = 0; x < size; ++x)
+			heights[y * size + x] = 100.0f * Math::Sin(x * 0.05f * freq) * Math::Cos(y * 0.03f * freq);
+
+	Terrain::ImportData imp;
+	imp.inputFloat = heights;
+	imp.deleteInputData = true;
+	imp.terrainSize = size;
+	imp.worldSize = 1000;
+	imp.minBatchSize = 33;
+	imp.maxBatchSize = 65;
+	t->prepare(imp);
+
+	return t;
+}
+
+void TerrainBenchmarks::freePixelBox(PixelBox* box)
+{
+	OGRE_FREE(box->data, MEMCATEGORY_GENERAL);
+	OGRE_DELETE box;
+}
+
+Ray TerrainBenchmarks::createTestRay(Terrain* t, int i)
+{
+	// Spread over the terrain and slanted in all directions, from well above it
+	Real halfSize = t->getWorldSize() * 0.5f;
+	Vector3 origin(halfSize * Math::Sin(i * 0.37f), 300, halfSize * Math::Cos(i * 0.71f));
+	Vector3 dir(Math::Sin(i * 1.3f), -0.5f - 0.5f * Math::Cos(i * 0.9f), Math::Cos(i * 1.7f));
+	dir.normalise();
+	return Ray(t->getPosition() + origin, dir);
+}
+
+void TerrainBenchmarks::benchmarkDerivedData()
+{
+	const uint16 sizes[3] = { 1025, 2049, 4097 };
+	for (int i = 0; i < 3; ++i)
+	{
+		mOptions->setLightMapSize(sizes[i] - 1);
+		Terrain* t = createHillsTerrain(sizes[i]);
+
+		Rect all(0, 0, sizes[i], sizes[i]);
+		Rect normalRect, lightmapRect;
+		Timer timer;
+		PixelBox* normals = t->calculateNormals(all, normalRect);
+		unsigned long normalTime = timer.getMilliseconds();
+		timer.reset();
+		PixelBox* lightmap = t->calculateLightmap(all, Rect(0, 0, 0, 0), lightmapRect);
+		unsigned long lightmapTime = timer.getMilliseconds();
+
+		std::cout << "Terrain " << sizes[i] << ": normals " << normalTime 
+			<< " ms, lightmap " << sizes[i] - 1 << "x" << sizes[i] - 1 << " " 
+			<< lightmapTime << " ms" << std::endl;
+
+		freePixelBox(normals);
+		freePixelBox(lightmap);
+		OGRE_DELETE t;
+	}
+}
+
+void TerrainBenchmarks::benchmarkQueries()
+{
+	Terrain* t = createHillsTerrain(2049);
+
+	const size_t count = 1000000;
+	vector<float>::type x(count), y(count), heights(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = 0.5f + 0.5f * Math::Sin(i * 0.013f);
+		y[i] = 0.5f + 0.5f * Math::Cos(i * 0.029f);
+	}
+	Timer timer;
+	for (size_t i = 0; i < count; ++i)
+		heights[i] = t->getHeightAtTerrainPosition(x[i], y[i]);
+	unsigned long singleTime = timer.getMilliseconds();
+	timer.reset();
+	t->getHeightAtTerrainPositions(&x[0], &y[0], &heights[0], count);
+	unsigned long batchTime = timer.getMilliseconds();
+
+	const int numRays = 10000;
+	int hits = 0;
+	timer.reset();
+	for (int i = 0; i < numRays; ++i)
+	{
+		if (t->rayIntersects(createTestRay(t, i)).first)
+			++hits;
+	}
+	unsigned long rayTime = timer.getMilliseconds();
+
+	std::cout << "Terrain 2049: " << count << " heights " << singleTime << " ms single, " 
+		<< batchTime << " ms batched; " << numRays << " rays " << rayTime << " ms" << std::endl;
+	CPPUNIT_ASSERT(hits > 0);
+
+	OGRE_DELETE t;
+}
+
+void TerrainBenchmarks::benchmarkProgressivePrepare()
+{
+	Terrain* t = createHillsTerrain(2049);
+	const String rawFile = "TerrainBenchmarksRaw.dat";
+	const String progressiveFile = "TerrainBenchmarksProgressive.dat";
+
+	t->save(rawFile);
+	mOptions->setSaveProgressiveHeightData(true);
+	mOptions->setSaveChunkedCompression(true);
+	t->save(progressiveFile);
+	size_t rawSize = Root::getSingleton().openFileStream(rawFile)->size();
+	size_t progressiveSize = Root::getSingleton().openFileStream(progressiveFile)->size();
+	OGRE_DELETE t;
+
+	Timer timer;
+	Terrain* full = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(full->prepare(progressiveFile));
+	unsigned long fullTime = timer.getMilliseconds();
+
+	mOptions->setNumHeightLevelsOnPrepare(1);
+	timer.reset();
+	Terrain* coarse = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(coarse->prepare(progressiveFile));
+	unsigned long coarseTime = timer.getMilliseconds();
+
+	std::cout << "Terrain 2049 file: " << rawSize << " bytes with float heights, " 
+		<< progressiveSize << " bytes progressive; prepare " << fullTime 
+		<< " ms all levels, " << coarseTime << " ms coarsest level" << std::endl;
+
+	OGRE_DELETE coarse;
+	OGRE_DELETE full;
+	std::remove(rawFile.c_str());
+	std::remove(progressiveFile.c_str());
+}
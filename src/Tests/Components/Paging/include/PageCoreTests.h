@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 #include "OgrePageManager.h"
 #include "OgreGrid2DPageStrategy.h"
+#include "OgreHardwareBufferManager.h"
 
 using namespace Ogre; 
 
@@ -39,14 +40,21 @@ class PageCoreTests : public CppUnit::TestFixture
 	// CppUnit macros for setting up the test suite
 	CPPUNIT_TEST_SUITE( PageCoreTests );
 	CPPUNIT_TEST(testSimpleCreateSaveLoadWorld);
+	CPPUNIT_TEST(testPredictiveLoading);
+	CPPUNIT_TEST(testBudgetedLoading);
+	CPPUNIT_TEST(testCameraDestroyed);
 	CPPUNIT_TEST_SUITE_END();
 
 	Root* mRoot;
+	HardwareBufferManager* mBufMgr;
 	PageManager* mPageManager;
 	SceneManager* mSceneMgr;
 public:
 	void setUp();
 	void tearDown();
 	void testSimpleCreateSaveLoadWorld();
+	void testPredictiveLoading();
+	void testBudgetedLoading();
+	void testCameraDestroyed();
 	void testLoadWorld();
 };
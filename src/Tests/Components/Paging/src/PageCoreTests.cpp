@@ -27,12 +27,89 @@ THE SOFTWARE.
 */
 #include "PageCoreTests.h"
 #include "OgrePaging.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgrePageContentFactory.h"
+#include "OgreTimer.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION( PageCoreTests );
 
+namespace
+{
+	/// Run the frame events without rendering anything
+	void simulateFrame(Root* root, Real timeSinceLastFrame)
+	{
+		FrameEvent evt;
+		evt.timeSinceLastEvent = evt.timeSinceLastFrame = timeSinceLastFrame;
+		root->_fireFrameStarted(evt);
+		root->_fireFrameRenderingQueued(evt);
+		root->_fireFrameEnded(evt);
+	}
+
+	/// Content which takes a fixed amount of memory and time to load
+	class TestPageContent : public PageContent
+	{
+	public:
+		TestPageContent(PageContentFactory* creator) : PageContent(creator) {}
+
+		void save(StreamSerialiser& stream) {}
+		bool prepare(StreamSerialiser& ser) { return true; }
+		void load()
+		{
+			Timer timer;
+			while (timer.getMilliseconds() < 2) {}
+		}
+		void unload() {}
+		void unprepare() {}
+		size_t getMemoryUsage() const { return 1000; }
+	};
+
+	class TestPageContentFactory : public PageContentFactory
+	{
+	public:
+		const String& getName() const
+		{
+			static const String name("Test");
+			return name;
+		}
+		PageContent* createInstance() { return OGRE_NEW TestPageContent(this); }
+		void destroyInstance(PageContent* c) { OGRE_DELETE c; }
+	};
+
+	/// Fills every page with one TestPageContent
+	class TestPageProvider : public PageProvider
+	{
+	public:
+		bool prepareProceduralPage(Page* page, PagedWorldSection* section) { return true; }
+		bool loadProceduralPage(Page* page, PagedWorldSection* section)
+		{
+			if (!page->getContentCollectionCount())
+			{
+				SimplePageContentCollection* coll = static_cast<SimplePageContentCollection*>(
+					page->createContentCollection("Simple"));
+				coll->createContent("Test");
+			}
+			return true;
+		}
+	};
+
+	size_t countLoadedPages(PagedWorldSection* section)
+	{
+		size_t ret = 0;
+		const PagedWorldSection::PageMap& pages = section->getPages();
+		for (PagedWorldSection::PageMap::const_iterator i = pages.begin(); i != pages.end(); ++i)
+		{
+			if (i->second->getContentCollectionCount())
+				++ret;
+		}
+		return ret;
+	}
+}
+
 void PageCoreTests::setUp()
 {
 	mRoot = OGRE_NEW Root();
+	// for cameras, without a render system
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
 	mPageManager = OGRE_NEW PageManager();
 
 	mRoot->addResourceLocation("./", "FileSystem");
@@ -45,6 +122,7 @@ void PageCoreTests::tearDown()
 {
 	OGRE_DELETE mPageManager;
 	OGRE_DELETE mRoot;
+	OGRE_DELETE mBufMgr;
 }
 
 
@@ -84,3 +162,153 @@ void PageCoreTests::testSimpleCreateSaveLoadWorld()
 
 }
 
+void PageCoreTests::testPredictiveLoading()
+{
+	PagedWorld* world = mPageManager->createWorld();
+	PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr);
+	Grid2DPageStrategyData* data = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+	data->setCellSize(100);
+	data->setLoadRadius(100);
+	data->setHoldRadius(200);
+
+	Camera* cam = mSceneMgr->createCamera("PagingCam");
+	mPageManager->addCamera(cam);
+
+	// Fly along +X at 500 units per second, 10 frames per second
+	for (int i = 0; i < 20; ++i)
+	{
+		cam->setPosition(i * 50.0f, 0, 0);
+		simulateFrame(mRoot, 0.1f);
+	}
+	CPPUNIT_ASSERT(mPageManager->getCameraVelocity(cam).positionEquals(Vector3(500, 0, 0), 1));
+
+	// Camera is in cell 10; without prediction nothing beyond the hold radius
+	PageID ahead = data->calculatePageID(15, 0);
+	CPPUNIT_ASSERT(section->getPage(ahead) == 0);
+
+	data->setPredictionTime(1.0f);
+	cam->setPosition(1000, 0, 0);
+	simulateFrame(mRoot, 0.1f);
+	// 1 second ahead is cell 15, and the load radius beyond it
+	CPPUNIT_ASSERT(section->getPage(ahead) != 0);
+	CPPUNIT_ASSERT(section->getPage(data->calculatePageID(16, 1)) != 0);
+	CPPUNIT_ASSERT(section->getPage(data->calculatePageID(18, 0)) == 0);
+	// nothing behind the camera
+	CPPUNIT_ASSERT(section->getPage(data->calculatePageID(3, 0)) == 0);
+
+	// Stop, the pages on the predicted path are dropped once the velocity settles
+	for (int i = 0; i < 20; ++i)
+		simulateFrame(mRoot, 0.1f);
+	CPPUNIT_ASSERT(mPageManager->getCameraVelocity(cam).length() < 10);
+	CPPUNIT_ASSERT(section->getPage(ahead) == 0);
+	CPPUNIT_ASSERT(section->getPage(data->calculatePageID(10, 0)) != 0);
+
+	mPageManager->removeCamera(cam);
+	mPageManager->destroyWorld(world);
+	mSceneMgr->destroyCamera(cam);
+}
+
+void PageCoreTests::testBudgetedLoading()
+{
+	TestPageContentFactory contentFactory;
+	mPageManager->addContentFactory(&contentFactory);
+	TestPageProvider provider;
+	mPageManager->setPageProvider(&provider);
+	mRoot->getWorkQueue()->startup();
+
+	PagedWorld* world = mPageManager->createWorld();
+	PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr);
+	Grid2DPageStrategyData* data = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+	data->setCellSize(100);
+	data->setLoadRadius(100);
+	data->setHoldRadius(200);
+
+	Camera* cam = mSceneMgr->createCamera("PagingCam");
+	mPageManager->addCamera(cam);
+
+	// Each page takes 2ms to load, so only one can be loaded per frame
+	mPageManager->setPageLoadTimeLimit(1);
+	mPageManager->setPageMemoryBudget(15000);
+
+	size_t loaded = 0;
+	bool queued = false;
+	for (int i = 0; i < 500 && loaded < 9; ++i)
+	{
+		simulateFrame(mRoot, 0.1f);
+		size_t nowLoaded = countLoadedPages(section);
+		CPPUNIT_ASSERT(nowLoaded <= loaded + 1);
+		loaded = nowLoaded;
+		queued = queued || mPageManager->getQueuedPageLoadCount() > 0;
+		OGRE_THREAD_SLEEP(1);
+	}
+	// 3x3 pages in the load radius
+	CPPUNIT_ASSERT_EQUAL((size_t)9, loaded);
+	CPPUNIT_ASSERT(queued);
+	CPPUNIT_ASSERT(mPageManager->getPagesLoadedPerSecond() > 0);
+	CPPUNIT_ASSERT_EQUAL((size_t)9000, mPageManager->getPageMemoryUsage());
+
+	Page* pinned = section->getPage(data->calculatePageID(1, 1));
+	pinned->setPinned(true);
+	Page* oldest = section->getPage(data->calculatePageID(-1, -1));
+
+	// Fly away, the old pages are kept until the budget is exceeded
+	cam->setPosition(1000, 0, 0);
+	mPageManager->setPageLoadTimeLimit(0);
+	for (int i = 0; i < 500 && countLoadedPages(section) < 15; ++i)
+	{
+		simulateFrame(mRoot, 0.1f);
+		OGRE_THREAD_SLEEP(1);
+	}
+	for (int i = 0; i < 20; ++i)
+		simulateFrame(mRoot, 0.1f);
+	CPPUNIT_ASSERT_EQUAL((size_t)15, countLoadedPages(section));
+	CPPUNIT_ASSERT_EQUAL((size_t)15000, mPageManager->getPageMemoryUsage());
+	CPPUNIT_ASSERT(section->getPage(data->calculatePageID(10, 0)) != 0);
+	CPPUNIT_ASSERT(section->getPage(data->calculatePageID(1, 1)) == pinned);
+	// Only the pages around the camera are left with no budget
+	mPageManager->setPageMemoryBudget(0);
+	simulateFrame(mRoot, 0.1f);
+	CPPUNIT_ASSERT_EQUAL((size_t)10, countLoadedPages(section));
+	CPPUNIT_ASSERT(section->getPage(data->calculatePageID(1, 1)) == pinned);
+	// statistics are updated every second
+	Real evictedPerSecond = 0;
+	for (int i = 0; i < 12; ++i)
+	{
+		simulateFrame(mRoot, 0.1f);
+		evictedPerSecond = std::max(evictedPerSecond, mPageManager->getPagesEvictedPerSecond());
+	}
+	CPPUNIT_ASSERT(evictedPerSecond >= 4);
+
+	mPageManager->removeCamera(cam);
+	mPageManager->destroyWorld(world);
+	mSceneMgr->destroyCamera(cam);
+	mPageManager->setPageProvider(0);
+	mPageManager->removeContentFactory(&contentFactory);
+}
+
+void PageCoreTests::testCameraDestroyed()
+{
+	PagedWorld* world = mPageManager->createWorld();
+	world->createSection("Grid2D", mSceneMgr);
+
+	SceneManager* otherSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+	Camera* cam = mSceneMgr->createCamera("PagingCam");
+	Camera* otherCam = otherSceneMgr->createCamera("OtherPagingCam");
+	mPageManager->addCamera(cam);
+	mPageManager->addCamera(otherCam);
+	simulateFrame(mRoot, 0.1f);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, mPageManager->getCameraList().size());
+
+	// Destroying a camera stops it being tracked
+	mSceneMgr->destroyCamera(cam);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, mPageManager->getCameraList().size());
+	CPPUNIT_ASSERT(mPageManager->hasCamera(otherCam));
+
+	// So does destroying the scene manager which owns it
+	mRoot->destroySceneManager(otherSceneMgr);
+	CPPUNIT_ASSERT(mPageManager->getCameraList().empty());
+
+	// Frames no longer touch the destroyed cameras
+	simulateFrame(mRoot, 0.1f);
+	mPageManager->destroyWorld(world);
+}
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "OgreRoot.h"
+#include "OgreTerrain.h"
 
 using namespace Ogre; 
 
@@ -37,13 +38,33 @@ class TerrainTests : public CppUnit::TestFixture
 	// CppUnit macros for setting up the test suite
 	CPPUNIT_TEST_SUITE( TerrainTests );
 	CPPUNIT_TEST(testCreate);
+	CPPUNIT_TEST(testDerivedDataThreads);
+	CPPUNIT_TEST(testDerivedDataReference);
+	CPPUNIT_TEST(testHeightQueries);
+	CPPUNIT_TEST(testRayIntersects);
+	CPPUNIT_TEST(testMemoryUsage);
+	CPPUNIT_TEST(testProgressiveHeightData);
+	CPPUNIT_TEST(testSaveVersion);
+	CPPUNIT_TEST(testEditPendingHeightLevels);
 	CPPUNIT_TEST_SUITE_END();
 
 	Root* mRoot;
 	SceneManager* mSceneMgr;
 
+	Terrain* createHillsTerrain(uint16 size);
+	void freePixelBox(PixelBox* box);
+	Ray createTestRay(Terrain* t, int i);
+
 public:
 	void setUp();
 	void tearDown();
 	void testCreate();
+	void testDerivedDataThreads();
+	void testDerivedDataReference();
+	void testHeightQueries();
+	void testRayIntersects();
+	void testMemoryUsage();
+	void testProgressiveHeightData();
+	void testSaveVersion();
+	void testEditPendingHeightLevels();
 };
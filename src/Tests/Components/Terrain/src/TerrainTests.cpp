@@ -27,8 +27,11 @@ THE SOFTWARE.
 */
 #include "TerrainTests.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainQuadTreeNode.h"
 #include "OgreConfigFile.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreDeflate.h"
+#include "OgreStreamSerialiser.h"
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION( TerrainTests );
@@ -87,3 +90,453 @@ void TerrainTests::testCreate()
 
 	OGRE_DELETE t;
 }
+
+Terrain* TerrainTests::createHillsTerrain(uint16 size)
+{
+	Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+
+	// Rolling hills, so that there are both lit and shadowed areas
+	float* heights = OGRE_ALLOC_T(float, size * size, MEMCATEGORY_GEOMETRY);
+	Real freq = 513.0f / size;
+	for (uint16 y = 0; y < size; ++y)
+		for (uint16 x = 0; x < size; ++x)
+			heights[y * size + x] = 100.0f * Math::Sin(x * 0.05f * freq) * Math::Cos(y * 0.03f * freq);
+
+	Terrain::ImportData imp;
+	imp.inputFloat = heights;
+	imp.deleteInputData = true;
+	imp.terrainSize = size;
+	imp.worldSize = 1000;
+	imp.minBatchSize = 33;
+	imp.maxBatchSize = 65;
+	t->prepare(imp);
+
+	return t;
+}
+
+void TerrainTests::freePixelBox(PixelBox* box)
+{
+	OGRE_FREE(box->data, MEMCATEGORY_GENERAL);
+	OGRE_DELETE box;
+}
+
+void TerrainTests::testDerivedDataThreads()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	opts->setDerivedDataTileSize(32);
+
+	const uint16 size = 513;
+	Terrain* t = createHillsTerrain(size);
+
+	// Once on this thread only, then shared with the workers of Root's queue
+	Rect all(0, 0, size, size);
+	PixelBox* normals[2];
+	Rect normalRect[2];
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	for (int i = 0; i < 2; ++i)
+	{
+		if (i == 1)
+			queue->startup();
+		normals[i] = t->calculateNormals(all, normalRect[i]);
+	}
+	queue->shutdown();
+
+	// Tiles must join up into exactly what a single pass produces
+	for (int i = 0; i < 2; ++i)
+	{
+		CPPUNIT_ASSERT(normalRect[i].left == 0 && normalRect[i].top == 0);
+		CPPUNIT_ASSERT(normalRect[i].right == size && normalRect[i].bottom == size);
+	}
+	CPPUNIT_ASSERT(memcmp(normals[0]->data, normals[1]->data, normals[0]->getConsecutiveSize()) == 0);
+
+	freePixelBox(normals[0]);
+	freePixelBox(normals[1]);
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+}
+
+void TerrainTests::testDerivedDataReference()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	opts->setLightMapSize(512);
+	opts->setLightMapDirection(Vector3(1, -0.4f, 0.3f).normalisedCopy());
+
+	const uint16 size = 513;
+	Terrain* t = createHillsTerrain(size);
+
+	Rect all(0, 0, size, size);
+	Rect normalRect, lightmapRect;
+	PixelBox* normals = t->calculateNormals(all, normalRect);
+	PixelBox* lightmap = t->calculateLightmap(all, Rect(0, 0, 0, 0), lightmapRect);
+
+	// Normals must agree with fitting planes through the neighbouring points
+	const uint8* pNormal = static_cast<const uint8*>(normals->data);
+	int maxDiff = 0;
+	for (long y = 1; y < size - 1; ++y)
+	{
+		for (long x = 1; x < size - 1; ++x)
+		{
+			Vector3 centre, adjacent[8];
+			t->getPoint(x, y, &centre);
+			t->getPoint(x+1, y, &adjacent[0]);
+			t->getPoint(x+1, y+1, &adjacent[1]);
+			t->getPoint(x, y+1, &adjacent[2]);
+			t->getPoint(x-1, y+1, &adjacent[3]);
+			t->getPoint(x-1, y, &adjacent[4]);
+			t->getPoint(x-1, y-1, &adjacent[5]);
+			t->getPoint(x, y-1, &adjacent[6]);
+			t->getPoint(x+1, y-1, &adjacent[7]);
+			Vector3 normal = Vector3::ZERO;
+			for (int i = 0; i < 8; ++i)
+				normal += Plane(centre, adjacent[i], adjacent[(i+1)%8]).normal;
+			normal.normalise();
+
+			const uint8* pStore = pNormal + ((size - y - 1) * size + x) * 3;
+			for (int c = 0; c < 3; ++c)
+				maxDiff = std::max(maxDiff, 
+					std::abs((int)pStore[c] - (int)((normal[c] + 1.0f) * 0.5f * 255.0f)));
+		}
+	}
+	CPPUNIT_ASSERT(maxDiff <= 3);
+
+	// The lightmap must agree with casting a shadow ray from every texel, 
+	// apart from texels on the edges of shadows
+	const uint8* pLit = static_cast<const uint8*>(lightmap->data);
+	const Vector3& lightVec = opts->getLightMapDirection();
+	Real heightPad = (t->getMaxHeight() - t->getMinHeight()) * 1.0e-3f;
+	size_t numDifferent = 0, numShadowed = 0;
+	for (long y = 0; y < 512; ++y)
+	{
+		for (long x = 0; x < 512; ++x)
+		{
+			Real tx = x / 511.0f, ty = y / 511.0f;
+			Vector3 pos;
+			t->getPosition(tx, ty, t->getHeightAtTerrainPosition(tx, ty) + heightPad, &pos);
+			bool shadowed = t->rayIntersects(Ray(pos + t->getPosition(), -lightVec), true, 1000).first;
+			bool litHere = pLit[(511 - y) * 512 + x] != 0;
+			if (shadowed == litHere)
+				++numDifferent;
+			if (!litHere)
+				++numShadowed;
+		}
+	}
+	CPPUNIT_ASSERT(numShadowed > 512 * 512 / 10 && numShadowed < 512 * 512 * 9 / 10);
+	CPPUNIT_ASSERT(numDifferent < 512 * 512 / 50);
+
+	// Updating part of the lightmap must give the same texels as updating all 
+	// of it, whether the part is near the light or far from it
+	const Rect parts[] = { Rect(200, 100, 300, 180), Rect(20, 400, 90, 500), Rect(420, 30, 500, 70) };
+	for (size_t p = 0; p < sizeof(parts) / sizeof(parts[0]); ++p)
+	{
+		Rect partRect;
+		PixelBox* part = t->calculateLightmap(parts[p], Rect(0, 0, 0, 0), partRect);
+		CPPUNIT_ASSERT(!partRect.isNull());
+		const uint8* pPart = static_cast<const uint8*>(part->data);
+		for (long y = partRect.top; y < partRect.bottom; ++y)
+		{
+			for (long x = partRect.left; x < partRect.right; ++x)
+			{
+				CPPUNIT_ASSERT_EQUAL(pLit[(511 - y) * 512 + x], 
+					pPart[(partRect.bottom - y - 1) * partRect.width() + x - partRect.left]);
+			}
+		}
+		freePixelBox(part);
+	}
+
+	freePixelBox(normals);
+	freePixelBox(lightmap);
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+}
+
+Ray TerrainTests::createTestRay(Terrain* t, int i)
+{
+	// Spread over the terrain and slanted in all directions, from well above it
+	Real halfSize = t->getWorldSize() * 0.5f;
+	Vector3 origin(halfSize * Math::Sin(i * 0.37f), 300, halfSize * Math::Cos(i * 0.71f));
+	Vector3 dir(Math::Sin(i * 1.3f), -0.5f - 0.5f * Math::Cos(i * 0.9f), Math::Cos(i * 1.7f));
+	dir.normalise();
+	return Ray(t->getPosition() + origin, dir);
+}
+
+void TerrainTests::testHeightQueries()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	Terrain* t = createHillsTerrain(513);
+
+	// odd count to go through the leftover path too
+	const size_t count = 1001;
+	vector<float>::type x(count), y(count), heights(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = 0.5f + 0.5f * Math::Sin(i * 0.13f);
+		y[i] = 0.5f + 0.5f * Math::Cos(i * 0.29f);
+	}
+	// corners and edges
+	x[0] = 0; y[0] = 0;
+	x[1] = 1; y[1] = 1;
+	x[2] = 1; y[2] = 0.3f;
+	x[3] = 0.7f; y[3] = 1;
+
+	t->getHeightAtTerrainPositions(&x[0], &y[0], &heights[0], count);
+	for (size_t i = 0; i < count; ++i)
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(t->getHeightAtTerrainPosition(x[i], y[i]), heights[i], 1e-2);
+
+	// outside the terrain is clamped to the edge
+	float outX[2] = { -0.5f, 1.5f }, outY[2] = { 0.25f, 2.0f };
+	float outHeights[2];
+	t->getHeightAtTerrainPositions(outX, outY, outHeights, 2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(t->getHeightAtTerrainPosition(0, 0.25f), outHeights[0], 1e-2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(t->getHeightAtTerrainPosition(1, 1), outHeights[1], 1e-2);
+
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+}
+
+void TerrainTests::testRayIntersects()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	Terrain* t = createHillsTerrain(513);
+	Real step = t->getWorldSize() / (t->getSize() - 1) * 0.1f;
+
+	// Compare with marching along the ray in small steps
+	int hits = 0, mismatches = 0;
+	for (int i = 0; i < 500; ++i)
+	{
+		Ray ray = createTestRay(t, i);
+		std::pair<bool, Vector3> result = t->rayIntersects(ray);
+
+		bool refHit = false;
+		Real above = 0, below = 0;
+		for (Real dist = 0; dist < 2000; dist += step)
+		{
+			Vector3 p = ray.getPoint(dist);
+			Vector3 terrainPos;
+			t->getTerrainPosition(p, &terrainPos);
+			if (terrainPos.x < 0 || terrainPos.x > 1 || terrainPos.y < 0 || terrainPos.y > 1)
+			{
+				if (dist > 0)
+					break;
+				continue;
+			}
+			if (terrainPos.z <= t->getHeightAtTerrainPosition(terrainPos.x, terrainPos.y))
+			{
+				refHit = true;
+				below = dist;
+				break;
+			}
+			above = dist;
+		}
+
+		if (refHit != result.first)
+			++mismatches;
+		else if (refHit)
+		{
+			++hits;
+			Real dist = ray.getOrigin().distance(result.second);
+			if (dist < above - 1e-2f || dist > below + 1e-2f)
+				++mismatches;
+		}
+	}
+	// a few grazing rays can go either way
+	CPPUNIT_ASSERT(hits > 100);
+	CPPUNIT_ASSERT(mismatches <= 5);
+
+	// a ray passing over everything misses, one starting below the surface hits
+	Vector3 top = t->getPosition() + Vector3(0, 200, 0);
+	CPPUNIT_ASSERT(!t->rayIntersects(Ray(top, Vector3(1, 0.01f, 0).normalisedCopy())).first);
+	Vector3 centre = t->getPosition() + Vector3(0, t->getHeightAtWorldPosition(t->getPosition()), 0);
+	std::pair<bool, Vector3> result = t->rayIntersects(Ray(top, Vector3::NEGATIVE_UNIT_Y));
+	CPPUNIT_ASSERT(result.first);
+	CPPUNIT_ASSERT(result.second.positionEquals(centre, 1e-2f));
+
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+}
+
+void TerrainTests::testMemoryUsage()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	Terrain* t = createHillsTerrain(513);
+
+	// at least the heights, deltas and CPU vertex data of a prepared terrain
+	size_t heightsSize = 513 * 513 * sizeof(float);
+	size_t usage = t->getMemoryUsage();
+	CPPUNIT_ASSERT(usage > heightsSize * 2);
+	CPPUNIT_ASSERT(t->getQuadTree()->getMemoryUsage() > 0);
+	CPPUNIT_ASSERT(usage < heightsSize * 20);
+
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+}
+
+void TerrainTests::testProgressiveHeightData()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	Terrain* t = createHillsTerrain(513);
+	const size_t numVertices = 513 * 513;
+	const String rawFile = "TerrainTestsRaw.dat";
+	const String progressiveFile = "TerrainTestsProgressive.dat";
+
+	t->save(rawFile);
+	opts->setSaveProgressiveHeightData(true);
+	opts->setSaveChunkedCompression(true);
+	t->save(progressiveFile);
+	size_t rawSize = Root::getSingleton().openFileStream(rawFile)->size();
+	size_t progressiveSize = Root::getSingleton().openFileStream(progressiveFile)->size();
+	CPPUNIT_ASSERT(progressiveSize < rawSize);
+
+	// All levels, within the precision of the original heights
+	Terrain* full = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(full->prepare(progressiveFile));
+	CPPUNIT_ASSERT_EQUAL((uint16)0, full->getPendingHeightLevelCount());
+	for (size_t i = 0; i < numVertices; ++i)
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(t->getHeightData()[i], full->getHeightData()[i], 0.0051);
+
+	// Only the coarsest level, the rest read afterwards
+	opts->setNumHeightLevelsOnPrepare(1);
+	Terrain* coarse = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(coarse->prepare(progressiveFile));
+	CPPUNIT_ASSERT_EQUAL((uint16)(coarse->getNumLodLevels() - 1), coarse->getPendingHeightLevelCount());
+	long step = 1 << (coarse->getNumLodLevels() - 1);
+	for (long y = 0; y < 513; y += step)
+		for (long x = 0; x < 513; x += step)
+			CPPUNIT_ASSERT_EQUAL(full->getHeightAtPoint(x, y), coarse->getHeightAtPoint(x, y));
+	coarse->loadPendingHeightLevels(true);
+	CPPUNIT_ASSERT_EQUAL((uint16)0, coarse->getPendingHeightLevelCount());
+	CPPUNIT_ASSERT(memcmp(full->getHeightData(), coarse->getHeightData(), numVertices * sizeof(float)) == 0);
+	CPPUNIT_ASSERT(memcmp(full->getDeltaData(), coarse->getDeltaData(), numVertices * sizeof(float)) == 0);
+
+	// The same in the background
+	mRoot->getWorkQueue()->startup();
+	Terrain* streamed = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(streamed->prepare(progressiveFile));
+	streamed->loadPendingHeightLevels();
+	while (streamed->getPendingHeightLevelCount())
+	{
+		OGRE_THREAD_SLEEP(10);
+		mRoot->getWorkQueue()->processResponses();
+	}
+	CPPUNIT_ASSERT(memcmp(full->getHeightData(), streamed->getHeightData(), numVertices * sizeof(float)) == 0);
+
+	OGRE_DELETE streamed;
+	OGRE_DELETE coarse;
+	OGRE_DELETE full;
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+	std::remove(rawFile.c_str());
+	std::remove(progressiveFile.c_str());
+}
+
+void TerrainTests::testSaveVersion()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	Terrain* t = createHillsTerrain(65);
+	const String file = "TerrainTestsVersion.dat";
+
+	// Builds which only know version 1 must read a default save
+	t->save(file);
+	{
+		DataStreamPtr stream(OGRE_NEW DeflateStream(file, Root::getSingleton().openFileStream(file)));
+		StreamSerialiser ser(stream);
+		const StreamSerialiser::Chunk* chunk = ser.readChunkBegin(Terrain::TERRAIN_CHUNK_ID, 1);
+		CPPUNIT_ASSERT(chunk);
+		CPPUNIT_ASSERT_EQUAL((uint16)1, chunk->version);
+		uint8 align;
+		uint16 size, batchSize;
+		Real worldSize;
+		Vector3 pos;
+		ser.read(&align);
+		ser.read(&size);
+		ser.read(&worldSize);
+		ser.read(&batchSize);
+		ser.read(&batchSize);
+		ser.read(&pos);
+		CPPUNIT_ASSERT_EQUAL((uint16)65, size);
+		// heights straight after the header, no format byte
+		float heights[2];
+		ser.read(heights, 2);
+		CPPUNIT_ASSERT_EQUAL(t->getHeightAtPoint(0, 0), heights[0]);
+		CPPUNIT_ASSERT_EQUAL(t->getHeightAtPoint(1, 0), heights[1]);
+	}
+
+	// The progressive format needs version 2
+	opts->setSaveProgressiveHeightData(true);
+	t->save(file);
+	{
+		DataStreamPtr stream(OGRE_NEW DeflateStream(file, Root::getSingleton().openFileStream(file)));
+		StreamSerialiser ser(stream);
+		const StreamSerialiser::Chunk* chunk = ser.readChunkBegin(Terrain::TERRAIN_CHUNK_ID, 2);
+		CPPUNIT_ASSERT(chunk);
+		CPPUNIT_ASSERT_EQUAL((uint16)2, chunk->version);
+	}
+
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+	std::remove(file.c_str());
+}
+
+void TerrainTests::testEditPendingHeightLevels()
+{
+	TerrainGlobalOptions* opts = OGRE_NEW TerrainGlobalOptions();
+	Terrain* t = createHillsTerrain(129);
+	const size_t numVertices = 129 * 129;
+	const String file = "TerrainTestsEdit.dat";
+	opts->setSaveProgressiveHeightData(true);
+	t->save(file);
+
+	Terrain* full = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(full->prepare(file));
+
+	// An edit reads the pending levels first, so they don't overwrite it
+	opts->setNumHeightLevelsOnPrepare(1);
+	Terrain* edited = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(edited->prepare(file));
+	CPPUNIT_ASSERT(edited->getPendingHeightLevelCount() > 0);
+	edited->setHeightAtPoint(5, 7, 1234.0f);
+	CPPUNIT_ASSERT_EQUAL((uint16)0, edited->getPendingHeightLevelCount());
+	CPPUNIT_ASSERT_EQUAL(1234.0f, edited->getHeightAtPoint(5, 7));
+	full->setHeightAtPoint(5, 7, 1234.0f);
+	CPPUNIT_ASSERT(memcmp(full->getHeightData(), edited->getHeightData(), numVertices * sizeof(float)) == 0);
+
+	// Edits through the height data pointer are kept once announced
+	Terrain* dirtied = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(dirtied->prepare(file));
+	CPPUNIT_ASSERT(dirtied->getPendingHeightLevelCount() > 0);
+	for (long y = 10; y < 13; ++y)
+		for (long x = 20; x < 24; ++x)
+			*dirtied->getHeightData(x, y) = (float)(x + y);
+	dirtied->dirtyRect(Rect(20, 10, 24, 13));
+	CPPUNIT_ASSERT_EQUAL((uint16)0, dirtied->getPendingHeightLevelCount());
+	dirtied->setHeightAtPoint(5, 7, 1234.0f);
+	for (long y = 10; y < 13; ++y)
+		for (long x = 20; x < 24; ++x)
+			*full->getHeightData(x, y) = (float)(x + y);
+	CPPUNIT_ASSERT(memcmp(full->getHeightData(), dirtied->getHeightData(), numVertices * sizeof(float)) == 0);
+
+	// Changing the world size doesn't keep the coarse heights
+	Terrain* scaled = OGRE_NEW Terrain(mSceneMgr);
+	CPPUNIT_ASSERT(scaled->prepare(file));
+	CPPUNIT_ASSERT(scaled->getPendingHeightLevelCount() > 0);
+	scaled->setWorldSize(2000);
+	CPPUNIT_ASSERT_EQUAL((uint16)0, scaled->getPendingHeightLevelCount());
+	for (size_t i = 0; i < numVertices; ++i)
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(t->getHeightData()[i], scaled->getHeightData()[i], 0.0051);
+	OGRE_DELETE scaled;
+
+	// and saved
+	dirtied->save(file);
+	Terrain* reloaded = OGRE_NEW Terrain(mSceneMgr);
+	opts->setNumHeightLevelsOnPrepare(0);
+	CPPUNIT_ASSERT(reloaded->prepare(file));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(31.0f, reloaded->getHeightAtPoint(21, 10), 0.0051);
+
+	OGRE_DELETE reloaded;
+	OGRE_DELETE dirtied;
+	OGRE_DELETE edited;
+	OGRE_DELETE full;
+	OGRE_DELETE t;
+	OGRE_DELETE opts;
+	std::remove(file.c_str());
+}
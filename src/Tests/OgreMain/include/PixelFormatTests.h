@@ -38,6 +38,8 @@ class PixelFormatTests : public CppUnit::TestFixture
     CPPUNIT_TEST( testIntegerPackUnpack );
     CPPUNIT_TEST( testFloatPackUnpack );
     CPPUNIT_TEST( testBulkConversion );
+    CPPUNIT_TEST( testConversionPairs );
+    CPPUNIT_TEST( testBlockCompression );
     CPPUNIT_TEST_SUITE_END();
 public:
     void setUp();
@@ -46,6 +48,8 @@ public:
     void testIntegerPackUnpack();
     void testFloatPackUnpack();
     void testBulkConversion();
+    void testConversionPairs();
+    void testBlockCompression();
 
     // Utils
     void setupBoxes(PixelFormat srcFormat, PixelFormat dstFormat);
@@ -33,6 +33,8 @@ class StreamSerialiserTests : public CppUnit::TestFixture
 	// CppUnit macros for setting up the test suite
 	CPPUNIT_TEST_SUITE( StreamSerialiserTests );
 	CPPUNIT_TEST(testWriteBasic);
+	CPPUNIT_TEST(testCompressedChunks);
+	CPPUNIT_TEST(testChunkDirectory);
 
 	CPPUNIT_TEST_SUITE_END();
 protected:
@@ -41,6 +43,8 @@ public:
 	void tearDown();
 
 	void testWriteBasic();
+	void testCompressedChunks();
+	void testChunkDirectory();
 
 
 };
@@ -53,6 +53,8 @@ class StringTests : public CppUnit::TestFixture
 	CPPUNIT_TEST(testParseQuaternion);
 	CPPUNIT_TEST(testParseBool);
 	CPPUNIT_TEST(testParseColourValue);
+	CPPUNIT_TEST(testConverterMatchesStreams);
+	CPPUNIT_TEST(testConverterScriptValues);
 
     CPPUNIT_TEST_SUITE_END();
 protected:
@@ -87,6 +89,8 @@ public:
 	void testParseQuaternion();
 	void testParseBool();
 	void testParseColourValue();
+	void testConverterMatchesStreams();
+	void testConverterScriptValues();
 
 
 };
@@ -43,6 +43,10 @@ class ZipArchiveTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testFindFileInfoRecursive);
     CPPUNIT_TEST(testFileRead);
     CPPUNIT_TEST(testReadInterleave);
+    CPPUNIT_TEST(testStoredRead);
+    CPPUNIT_TEST(testStoredSizeMismatch);
+    CPPUNIT_TEST(testMaxEntries);
+    CPPUNIT_TEST(testConcurrentOpen);
     CPPUNIT_TEST_SUITE_END();
 protected:
     Ogre::String testPath;
@@ -60,5 +64,9 @@ public:
     void testFindFileInfoRecursive();
     void testFileRead();
     void testReadInterleave();
+    void testStoredRead();
+    void testStoredSizeMismatch();
+    void testMaxEntries();
+    void testConcurrentOpen();
 
 };
@@ -0,0 +1,126 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ArchivePrefetchTests.h"
+#include "OgreFileSystem.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ArchivePrefetchTests );
+
+namespace
+{
+	const size_t NUM_FILES = 16;
+	const size_t FILE_SIZE = 64 * 1024;
+
+	struct StorageOrderLess
+	{
+		FileSystemArchive* arch;
+		bool operator()(const String& a, const String& b) const
+		{
+			return arch->getStorageOrder(a) < arch->getStorageOrder(b);
+		}
+	};
+}
+
+void ArchivePrefetchTests::setUp()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	// Written in a scrambled order, so that declaration order and storage
+	// order differ
+	mFileNames.clear();
+	vector<uint32>::type data(FILE_SIZE / sizeof(uint32));
+	for (size_t i = 0; i < NUM_FILES; ++i)
+	{
+		size_t n = (i * 37) % NUM_FILES;
+		mFileNames.push_back("prefetchTest" + StringConverter::toString(i) + ".dat");
+		for (size_t j = 0; j < data.size(); ++j)
+			data[j] = (uint32)(n * data.size() + j);
+		DataStreamPtr out = arch.create("prefetchTest" + StringConverter::toString(n) + ".dat");
+		out->write(&data[0], FILE_SIZE);
+	}
+}
+
+void ArchivePrefetchTests::tearDown()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+	for (size_t i = 0; i < mFileNames.size(); ++i)
+		arch.remove(mFileNames[i]);
+}
+
+void ArchivePrefetchTests::readAll(const StringVector& names, bool prefetch)
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	StringVector order = names;
+	if (prefetch)
+	{
+		arch.prefetch(order);
+		StorageOrderLess less = { &arch };
+		std::stable_sort(order.begin(), order.end(), less);
+	}
+
+	vector<uint32>::type data(FILE_SIZE / sizeof(uint32));
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		DataStreamPtr in = arch.open(order[i]);
+		CPPUNIT_ASSERT_EQUAL(FILE_SIZE, in->read(&data[0], FILE_SIZE));
+		// Each file still holds what was written to it
+		size_t n = StringConverter::parseUnsignedInt(order[i].substr(12));
+		CPPUNIT_ASSERT_EQUAL((uint32)(n * data.size()), data[0]);
+		CPPUNIT_ASSERT_EQUAL((uint32)(n * data.size() + data.size() - 1), data.back());
+	}
+}
+
+void ArchivePrefetchTests::testStorageOrder()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	StringVector order = mFileNames;
+	StorageOrderLess less = { &arch };
+	std::stable_sort(order.begin(), order.end(), less);
+	CPPUNIT_ASSERT_EQUAL(mFileNames.size(), order.size());
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+	for (size_t i = 0; i < order.size(); ++i)
+		CPPUNIT_ASSERT(arch.getStorageOrder(order[i]) != 0);
+#endif
+	// Missing files have no order to give
+	CPPUNIT_ASSERT_EQUAL((uint64)0, arch.getStorageOrder("prefetchTestMissing.dat"));
+}
+
+void ArchivePrefetchTests::testPrefetchedRead()
+{
+	readAll(mFileNames, false);
+	readAll(mFileNames, true);
+}
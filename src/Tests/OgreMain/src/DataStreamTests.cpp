@@ -0,0 +1,133 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "DataStreamTests.h"
+#include "OgreDataStream.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include <fstream>
+#include <cstdio>
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( DataStreamTests );
+
+namespace
+{
+	/// Counts completed reads, which may complete on different threads
+	class CountingListener : public AsyncReadRequestListener
+	{
+	public:
+		AtomicScalar<size_t> completed;
+		CountingListener() : completed(0) {}
+		void readCompleted(AsyncReadRequest*) { completed += 1; }
+	};
+}
+
+void DataStreamTests::setUp()
+{
+	mFileName = "testDataStream.dat";
+	mData.resize(300000);
+	for (size_t i = 0; i < mData.size(); ++i)
+		mData[i] = (uchar)(i * 7 + (i >> 8));
+
+	std::ofstream out(mFileName.c_str(), std::ios::binary);
+	out.write((const char*)&mData[0], mData.size());
+}
+void DataStreamTests::tearDown()
+{
+	std::remove(mFileName.c_str());
+}
+
+void DataStreamTests::checkAsyncReads(DataStream& stream)
+{
+	uchar head[16];
+	CPPUNIT_ASSERT_EQUAL(sizeof(head), stream.read(head, sizeof(head)));
+
+	CountingListener listener;
+	vector<uchar>::type first(100000), last(100000);
+	AsyncReadRequestPtr firstReq = stream.readAsync(&first[0], 1000, first.size(), &listener);
+	// Runs past the end, so only the rest of the stream comes back
+	AsyncReadRequestPtr lastReq = stream.readAsync(&last[0], mData.size() - 5000, last.size(), &listener);
+
+	CPPUNIT_ASSERT_EQUAL(first.size(), firstReq->waitForCompletion());
+	CPPUNIT_ASSERT_EQUAL((size_t)5000, lastReq->waitForCompletion());
+	CPPUNIT_ASSERT(firstReq->isComplete() && lastReq->isComplete());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, listener.completed.get());
+	CPPUNIT_ASSERT(memcmp(&first[0], &mData[1000], first.size()) == 0);
+	CPPUNIT_ASSERT(memcmp(&last[0], &mData[mData.size() - 5000], 5000) == 0);
+
+	// The synchronous read position is where it was
+	uchar next[16];
+	CPPUNIT_ASSERT_EQUAL(sizeof(next), stream.read(next, sizeof(next)));
+	CPPUNIT_ASSERT(memcmp(next, &mData[sizeof(head)], sizeof(next)) == 0);
+}
+
+void DataStreamTests::testAsyncReadFileStream()
+{
+	std::ifstream* in = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)(
+		mFileName.c_str(), std::ios::in | std::ios::binary);
+	FileStreamDataStream stream(in);
+	checkAsyncReads(stream);
+}
+
+void DataStreamTests::testAsyncReadFileHandle()
+{
+	FileHandleDataStream stream(fopen(mFileName.c_str(), "rb"));
+	checkAsyncReads(stream);
+}
+
+void DataStreamTests::testAsyncReadMemory()
+{
+	MemoryDataStream stream(&mData[0], mData.size());
+	checkAsyncReads(stream);
+
+	// Data in memory is read straight away
+	uchar buf[4];
+	AsyncReadRequestPtr req = stream.readAsync(buf, 10, sizeof(buf));
+	CPPUNIT_ASSERT(req->isComplete());
+	CPPUNIT_ASSERT_EQUAL(sizeof(buf), req->getBytesRead());
+}
+
+void DataStreamTests::testAsyncReadWorkers()
+{
+	// Root only starts its work queue with the first window
+	Root root("", "", "DataStreamTests.log");
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(root.getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	queue->startup();
+
+	std::ifstream* in = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)(
+		mFileName.c_str(), std::ios::in | std::ios::binary);
+	FileStreamDataStream fileStream(in);
+	checkAsyncReads(fileStream);
+	FileHandleDataStream handleStream(fopen(mFileName.c_str(), "rb"));
+	checkAsyncReads(handleStream);
+
+	queue->shutdown();
+}
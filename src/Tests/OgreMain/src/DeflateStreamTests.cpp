@@ -0,0 +1,226 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "DeflateStreamTests.h"
+#include "OgreDeflate.h"
+#include "OgreFileSystem.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( DeflateStreamTests );
+
+void DeflateStreamTests::setUp()
+{
+	mFileName = "testDeflate.dat";
+	// compressible but not trivially so
+	mData.resize(100000);
+	uint32 seed = 12345;
+	for (size_t i = 0; i < mData.size(); ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		mData[i] = (uint32)i ^ (seed >> 24);
+	}
+}
+void DeflateStreamTests::tearDown()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+	if (arch.exists(mFileName))
+		arch.remove(mFileName);
+}
+
+void DeflateStreamTests::writeData(size_t chunkSize)
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	DataStreamPtr stream = arch.create(mFileName);
+	DeflateStream* deflate = OGRE_NEW DeflateStream(mFileName, stream);
+	DataStreamPtr compressStream(deflate);
+	deflate->setChunkSize(chunkSize);
+	CPPUNIT_ASSERT_EQUAL(chunkSize, deflate->getChunkSize());
+
+	// write in uneven pieces so chunk boundaries don't line up with writes
+	const uchar* src = (const uchar*)&mData[0];
+	size_t total = mData.size() * sizeof(uint32);
+	size_t written = 0;
+	size_t piece = 1;
+	while (written < total)
+	{
+		size_t n = std::min(piece, total - written);
+		CPPUNIT_ASSERT_EQUAL(n, compressStream->write(src + written, n));
+		written += n;
+		piece = piece * 3 + 7;
+	}
+	compressStream->close();
+	stream->close();
+}
+
+void DeflateStreamTests::checkSeeks(bool knownSize)
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	DataStreamPtr stream = arch.open(mFileName);
+	DataStreamPtr compressStream(OGRE_NEW DeflateStream(mFileName, stream));
+	size_t total = mData.size() * sizeof(uint32);
+	// plain deflate streams don't record their uncompressed size
+	if (knownSize)
+		CPPUNIT_ASSERT_EQUAL(total, compressStream->size());
+
+	// sequential read of the whole thing
+	vector<uint32>::type inData(mData.size());
+	CPPUNIT_ASSERT_EQUAL(total, compressStream->read(&inData[0], total));
+	CPPUNIT_ASSERT(inData == mData);
+	if (knownSize)
+		CPPUNIT_ASSERT(compressStream->eof());
+
+	// random access, backwards and forwards
+	uint32 seed = 777;
+	for (int i = 0; i < 50; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		size_t index = (seed >> 8) % (mData.size() - 16);
+		compressStream->seek(index * sizeof(uint32));
+		CPPUNIT_ASSERT_EQUAL(index * sizeof(uint32), compressStream->tell());
+		uint32 values[16];
+		CPPUNIT_ASSERT_EQUAL(sizeof(values), compressStream->read(values, sizeof(values)));
+		for (int v = 0; v < 16; ++v)
+			CPPUNIT_ASSERT_EQUAL(mData[index + v], values[v]);
+	}
+
+	// relative skips
+	compressStream->seek(4000);
+	compressStream->skip(-2000);
+	uint32 value;
+	compressStream->read(&value, sizeof(value));
+	CPPUNIT_ASSERT_EQUAL(mData[500], value);
+	compressStream->skip(4 * sizeof(uint32));
+	compressStream->read(&value, sizeof(value));
+	CPPUNIT_ASSERT_EQUAL(mData[505], value);
+}
+
+void DeflateStreamTests::testPlainRoundTrip()
+{
+	writeData(0);
+	checkSeeks(false);
+}
+
+void DeflateStreamTests::testChunkedRoundTrip()
+{
+	// several chunks, last one partial
+	writeData(64 * 1024);
+	checkSeeks(true);
+}
+
+void DeflateStreamTests::testChunkedWorkers()
+{
+	// Root only starts its work queue with the first window
+	Root root("", "", "DeflateStreamTests.log");
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(root.getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	queue->startup();
+	// chunks deflated on the workers land in the same places
+	writeData(16 * 1024);
+	queue->shutdown();
+	checkSeeks(true);
+}
+
+vector<uchar>::type DeflateStreamTests::writeChunkedWithTrailer(const String& trailer)
+{
+	size_t total = mData.size() * sizeof(uint32);
+	MemoryDataStream* memory = OGRE_NEW MemoryDataStream(total * 2);
+	DataStreamPtr stream(memory);
+	DeflateStream* deflate = OGRE_NEW DeflateStream(stream);
+	DataStreamPtr compressStream(deflate);
+	deflate->setChunkSize(16 * 1024);
+	compressStream->write(&mData[0], total);
+	compressStream->close();
+	stream->write(trailer.c_str(), trailer.size());
+	return vector<uchar>::type(memory->getPtr(), memory->getPtr() + stream->tell());
+}
+
+namespace
+{
+	DataStreamPtr readOnlyStream(vector<uchar>::type& bytes)
+	{
+		return DataStreamPtr(OGRE_NEW MemoryDataStream(&bytes[0], bytes.size(), false, true));
+	}
+
+	void setUInt32(vector<uchar>::type& bytes, size_t pos, uint32 value)
+	{
+		for (size_t i = 0; i < 4; ++i)
+			bytes[pos + i] = static_cast<uchar>(value >> (i * 8));
+	}
+}
+
+void DeflateStreamTests::testChunkedStreamEnd()
+{
+	const String trailer = "trailer";
+	vector<uchar>::type bytes = writeChunkedWithTrailer(trailer);
+	DataStreamPtr underlying = readOnlyStream(bytes);
+
+	// Reads out of order still leave the underlying stream after the data
+	DataStreamPtr compressStream(OGRE_NEW DeflateStream(underlying));
+	size_t total = mData.size() * sizeof(uint32);
+	uint32 value;
+	compressStream->seek(total - sizeof(value));
+	compressStream->read(&value, sizeof(value));
+	CPPUNIT_ASSERT_EQUAL(mData.back(), value);
+	compressStream->seek(0);
+	compressStream->read(&value, sizeof(value));
+	CPPUNIT_ASSERT_EQUAL(mData.front(), value);
+
+	char text[16] = { 0 };
+	CPPUNIT_ASSERT_EQUAL(trailer.size(), underlying->read(text, sizeof(text)));
+	CPPUNIT_ASSERT_EQUAL(trailer, String(text));
+}
+
+void DeflateStreamTests::testMalformedChunked()
+{
+	// Header: magic, version, chunk size, chunk count, 64 bit size, then the index
+	vector<uchar>::type bytes = writeChunkedWithTrailer("");
+
+	// A chunk claiming to have no compressed data
+	vector<uchar>::type emptyChunk = bytes;
+	setUInt32(emptyChunk, 24, 0);
+	CPPUNIT_ASSERT_THROW(DeflateStream(readOnlyStream(emptyChunk)), InvalidParametersException);
+
+	// Chunks running past the end of the stream
+	vector<uchar>::type truncated(bytes.begin(), bytes.end() - 100);
+	CPPUNIT_ASSERT_THROW(DeflateStream(readOnlyStream(truncated)), InvalidParametersException);
+
+	// An index far larger than the stream
+	vector<uchar>::type manyChunks = bytes;
+	setUInt32(manyChunks, 12, 0x10000000);
+	setUInt32(manyChunks, 16, 0);
+	setUInt32(manyChunks, 20, 0x400);
+	CPPUNIT_ASSERT_THROW(DeflateStream(readOnlyStream(manyChunks)), InvalidParametersException);
+}
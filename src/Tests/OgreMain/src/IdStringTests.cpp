@@ -0,0 +1,155 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "IdStringTests.h"
+#include "OgreIdString.h"
+#include "OgreRoot.h"
+#include "OgreAnimationState.h"
+#include "OgreGpuProgramParams.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( IdStringTests );
+
+void IdStringTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "IdStringTests.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+}
+
+void IdStringTests::tearDown()
+{
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void IdStringTests::testInterning()
+{
+	String text = "IdStringTests/Interning";
+	IdString a(text);
+	IdString b("IdStringTests/Interning");
+	IdString c("IdStringTests/Other");
+
+	CPPUNIT_ASSERT(a == b);
+	CPPUNIT_ASSERT(a != c);
+	CPPUNIT_ASSERT(a._getInterned() == b._getInterned());
+	CPPUNIT_ASSERT_EQUAL(text, a.getString());
+	CPPUNIT_ASSERT_EQUAL(FastHash(text.c_str(), (int)text.size()), a.getHash());
+
+	size_t count = IdString::getInternedCount();
+	IdString d(text);
+	CPPUNIT_ASSERT_EQUAL(count, IdString::getInternedCount());
+
+	IdString null;
+	CPPUNIT_ASSERT(null.isNull());
+	CPPUNIT_ASSERT(!a.isNull());
+	CPPUNIT_ASSERT(null != IdString(""));
+	CPPUNIT_ASSERT_EQUAL(StringUtil::BLANK, null.getString());
+}
+
+void IdStringTests::testResourceLookup()
+{
+	MaterialManager& mgr = MaterialManager::getSingleton();
+	MaterialPtr global = mgr.create("IdStringTests/Global", 
+		ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	ResourceGroupManager::getSingleton().createResourceGroup("IdStringTests", false);
+	MaterialPtr grouped = mgr.create("IdStringTests/Grouped", "IdStringTests");
+
+	IdString globalId("IdStringTests/Global");
+	IdString groupedId("IdStringTests/Grouped");
+	CPPUNIT_ASSERT(mgr.getByName(globalId) == mgr.getByName("IdStringTests/Global"));
+	CPPUNIT_ASSERT(mgr.getByName(globalId).get() == global.get());
+	CPPUNIT_ASSERT(mgr.getByName(groupedId).get() == grouped.get());
+	CPPUNIT_ASSERT(mgr.getByName(groupedId, "IdStringTests").get() == grouped.get());
+	CPPUNIT_ASSERT(mgr.getByName(IdString("IdStringTests/Missing")).isNull());
+
+	mgr.remove(grouped->getHandle());
+	CPPUNIT_ASSERT(mgr.getByName(groupedId).isNull());
+	mgr.remove(global->getHandle());
+	CPPUNIT_ASSERT(mgr.getByName(globalId).isNull());
+
+	// Re-creating under the same name is found again
+	MaterialPtr again = mgr.create("IdStringTests/Global", 
+		ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	CPPUNIT_ASSERT(mgr.getByName(globalId).get() == again.get());
+	ResourceGroupManager::getSingleton().destroyResourceGroup("IdStringTests");
+}
+
+void IdStringTests::testAnimationStateLookup()
+{
+	AnimationStateSet set;
+	AnimationState* walk = set.createAnimationState("Walk", 0, 1);
+	set.createAnimationState("Run", 0, 1);
+
+	CPPUNIT_ASSERT_EQUAL(walk, set.getAnimationState(IdString("Walk")));
+	CPPUNIT_ASSERT(set.hasAnimationState(IdString("Run")));
+	CPPUNIT_ASSERT(!set.hasAnimationState(IdString("Jump")));
+
+	AnimationStateSet copy(set);
+	CPPUNIT_ASSERT(copy.hasAnimationState(IdString("Walk")));
+	CPPUNIT_ASSERT(copy.getAnimationState(IdString("Walk")) != walk);
+
+	set.removeAnimationState("Run");
+	CPPUNIT_ASSERT(!set.hasAnimationState(IdString("Run")));
+	set.removeAllAnimationStates();
+	CPPUNIT_ASSERT(!set.hasAnimationState(IdString("Walk")));
+	CPPUNIT_ASSERT_THROW(set.getAnimationState(IdString("Walk")), Exception);
+}
+
+void IdStringTests::testNamedConstantLookup()
+{
+	GpuNamedConstantsPtr named(OGRE_NEW GpuNamedConstants());
+	GpuConstantDefinition def;
+	def.constType = GCT_FLOAT4;
+	def.elementSize = 4;
+	def.physicalIndex = 0;
+	named->map["diffuse"] = def;
+	def.physicalIndex = 4;
+	named->map["specular"] = def;
+	named->floatBufferSize = 8;
+
+	CPPUNIT_ASSERT(named->find(IdString("specular")));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, named->find(IdString("specular"))->physicalIndex);
+	CPPUNIT_ASSERT(!named->find(IdString("ambient")));
+
+	// Adding a definition rebuilds the index
+	def.physicalIndex = 8;
+	named->map["ambient"] = def;
+	named->floatBufferSize = 12;
+	CPPUNIT_ASSERT(named->find(IdString("ambient")));
+
+	GpuProgramParametersSharedPtr params(OGRE_NEW GpuProgramParameters());
+	params->_setNamedConstants(named);
+	params->setNamedConstant(IdString("specular"), Vector4(1, 2, 3, 4));
+	CPPUNIT_ASSERT_EQUAL(3.0f, *params->getFloatPointer(6));
+	params->setIgnoreMissingParams(false);
+	CPPUNIT_ASSERT_THROW(params->setNamedConstant(IdString("emissive"), 1.0f), Exception);
+}
@@ -0,0 +1,187 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ImageTests.h"
+#include "OgreImage.h"
+#include "OgreColourValue.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include <cstdlib>
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ImageTests );
+
+namespace
+{
+	/// An image of reproducible random bytes
+	void createRandomImage(Image& image, size_t width, size_t height, PixelFormat format)
+	{
+		size_t size = PixelUtil::getMemorySize(width, height, 1, format);
+		uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+		srand(0);
+		for (size_t i = 0; i < size; ++i)
+			data[i] = (uchar)rand();
+		image.loadDynamicImage(data, width, height, 1, format, true);
+	}
+
+	/// Largest difference between the channels of two byte buffers
+	int maxDifference(const uchar* a, const uchar* b, size_t size)
+	{
+		int result = 0;
+		for (size_t i = 0; i < size; ++i)
+			result = std::max(result, std::abs((int)a[i] - (int)b[i]));
+		return result;
+	}
+}
+
+void ImageTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "ImageTests.log");
+}
+
+void ImageTests::tearDown()
+{
+	OGRE_DELETE mRoot;
+}
+
+void ImageTests::setWorkersRunning(bool running)
+{
+	// Root only starts its work queue with the first window
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	if (running)
+	{
+		queue->setWorkerThreadCount(3);
+		queue->startup();
+	}
+	else
+		queue->shutdown();
+}
+
+void ImageTests::testScaleBands()
+{
+	Image src;
+	createRandomImage(src, 1024, 1024, PF_A8R8G8B8);
+
+	size_t size = PixelUtil::getMemorySize(700, 300, 1, PF_A8R8G8B8);
+	vector<uchar>::type single(size), banded(size), viaFloat(size);
+	PixelBox singleBox(700, 300, 1, PF_A8R8G8B8, &single[0]);
+	PixelBox bandedBox(700, 300, 1, PF_A8R8G8B8, &banded[0]);
+
+	// Bands shared with the workers must not change the result
+	Image::scale(src.getPixelBox(), singleBox, Image::FILTER_BILINEAR);
+	setWorkersRunning(true);
+	Image::scale(src.getPixelBox(), bandedBox, Image::FILTER_BILINEAR);
+	CPPUNIT_ASSERT(single == banded);
+
+	Image::scale(src.getPixelBox(), bandedBox, Image::FILTER_NEAREST);
+	setWorkersRunning(false);
+	Image::scale(src.getPixelBox(), singleBox, Image::FILTER_NEAREST);
+	CPPUNIT_ASSERT(single == banded);
+
+	// The byte resampler matches the floating point one, but for rounding
+	Image::scale(src.getPixelBox(), singleBox, Image::FILTER_BILINEAR);
+	Image floatSrc;
+	floatSrc.loadDynamicImage(OGRE_ALLOC_T(uchar, PixelUtil::getMemorySize(1024, 1024, 1, PF_FLOAT32_RGBA), 
+		MEMCATEGORY_GENERAL), 1024, 1024, 1, PF_FLOAT32_RGBA, true);
+	PixelUtil::bulkPixelConversion(src.getPixelBox(), floatSrc.getPixelBox());
+	vector<float>::type floatScaled(700 * 300 * 4);
+	PixelBox floatBox(700, 300, 1, PF_FLOAT32_RGBA, &floatScaled[0]);
+	Image::scale(floatSrc.getPixelBox(), floatBox, Image::FILTER_BILINEAR);
+	PixelUtil::bulkPixelConversion(floatBox, PixelBox(700, 300, 1, PF_A8R8G8B8, &viaFloat[0]));
+	CPPUNIT_ASSERT(maxDifference(&single[0], &viaFloat[0], size) <= 1);
+}
+
+void ImageTests::testSeparableFilters()
+{
+	// One pixel black and white stripes
+	Image stripes;
+	stripes.loadDynamicImage(OGRE_ALLOC_T(uchar, 256 * 64, MEMCATEGORY_GENERAL), 256, 64, 1, PF_L8, true);
+	for (size_t y = 0; y < 64; ++y)
+		for (size_t x = 0; x < 256; ++x)
+			stripes.getData()[y * 256 + x] = (x % 2) ? 255 : 0;
+
+	Image::Filter filters[2] = { Image::FILTER_LANCZOS, Image::FILTER_KAISER };
+	for (int f = 0; f < 2; ++f)
+	{
+		// on the calling thread, then shared with the workers
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			setWorkersRunning(pass == 1);
+
+			// Reduced to a quarter, the stripes average to grey instead of aliasing
+			vector<float>::type scaled(64 * 16 * 4);
+			PixelBox box(64, 16, 1, PF_FLOAT32_RGBA, &scaled[0]);
+			Image::scale(stripes.getPixelBox(), box, filters[f]);
+			// The edge columns repeat a single stripe, so they are left out
+			for (size_t y = 0; y < 16; ++y)
+			{
+				for (size_t x = 1; x < 63; ++x)
+				{
+					CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, scaled[(y * 64 + x) * 4], 0.02);
+					CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, scaled[(y * 64 + x) * 4 + 3], 1e-4);
+				}
+			}
+
+			// Flat areas stay flat when enlarging too, in every axis
+			vector<float>::type flat(8 * 8 * 8 * 4, 0.25f), enlarged(20 * 5 * 13 * 4);
+			PixelBox flatBox(8, 8, 8, PF_FLOAT32_RGBA, &flat[0]);
+			PixelBox enlargedBox(20, 5, 13, PF_FLOAT32_RGBA, &enlarged[0]);
+			Image::scale(flatBox, enlargedBox, filters[f]);
+			for (size_t i = 0; i < enlarged.size(); ++i)
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, enlarged[i], 1e-4);
+		}
+	}
+}
+
+void ImageTests::testGenerateMipmaps()
+{
+	Image image;
+	createRandomImage(image, 64, 32, PF_R8G8B8);
+	vector<uchar>::type top(image.getData(), image.getData() + image.getSize());
+
+	image.generateMipmaps(Image::FILTER_KAISER);
+	CPPUNIT_ASSERT_EQUAL((size_t)6, image.getNumMipmaps());
+	CPPUNIT_ASSERT_EQUAL(Image::calculateSize(6, 1, 64, 32, 1, PF_R8G8B8), image.getSize());
+	CPPUNIT_ASSERT(std::equal(top.begin(), top.end(), image.getData()));
+
+	PixelBox last = image.getPixelBox(0, 6);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, last.getWidth());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, last.getHeight());
+	// Random bytes average to about half intensity
+	ColourValue average;
+	PixelUtil::unpackColour(&average, PF_R8G8B8, last.data);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, average.r, 0.05);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, average.g, 0.05);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, average.b, 0.05);
+
+	// Existing mipmaps are replaced
+	image.generateMipmaps(Image::FILTER_BILINEAR);
+	CPPUNIT_ASSERT_EQUAL((size_t)6, image.getNumMipmaps());
+	CPPUNIT_ASSERT(std::equal(top.begin(), top.end(), image.getData()));
+}
@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "InstanceBatchTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreInstanceBatch.h"
+#include "OgreInstancedEntity.h"
+#include "OgreManualObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreMeshManager.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreWorkQueue.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( InstanceBatchTests );
+
+namespace
+{
+	/// Batch with no GPU side, exposing the transform packing
+	class PackingBatch : public InstanceBatch
+	{
+	public:
+		PackingBatch(MeshPtr& mesh, size_t instances)
+			: InstanceBatch(0, mesh, MaterialPtr(), instances, 0, "InstanceBatchTests/Batch")
+		{
+			createAllInstancedEntities();
+		}
+
+		const InstancedEntityVec& getEntities() const { return mInstancedEntities; }
+		const FloatVec& getTransformShadow() const { return mTransformShadow; }
+
+		bool pack(size_t& dirtyStart, size_t& dirtyEnd)
+		{
+			return packTransforms3x4(mInstancedEntities, 12, dirtyStart, dirtyEnd);
+		}
+
+		void getWorldTransforms(Matrix4* xform) const {}
+		unsigned short getNumWorldTransforms(void) const { return 1; }
+
+	protected:
+		void setupVertices(const SubMesh* baseSubMesh) {}
+		void setupIndices(const SubMesh* baseSubMesh) {}
+		size_t calculateMaxNumInstances(const SubMesh* baseSubMesh, uint16 flags) const
+		{
+			return mInstancesPerBatch;
+		}
+	};
+
+	MeshPtr createTriangleMesh(const String& name)
+	{
+		ManualObject triangle("TriangleBuilder");
+		triangle.begin("InstanceBatchTests", RenderOperation::OT_TRIANGLE_LIST);
+		triangle.position(-1, -1, 0);
+		triangle.position(1, -1, 0);
+		triangle.position(0, 1, 0);
+		triangle.triangle(0, 1, 2);
+		triangle.end();
+		return triangle.convertToMesh(name);
+	}
+
+	void checkPacked(const Matrix4& m, const Vector3& offset, const float* packed)
+	{
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int col = 0; col < 4; ++col)
+			{
+				Real expected = m[row][col] - (col == 3 ? offset[row] : 0);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, (Real)packed[row * 4 + col], 1e-4);
+			}
+		}
+	}
+}
+
+void InstanceBatchTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "InstanceBatchTests.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+	MaterialPtr material = MaterialManager::getSingleton().create("InstanceBatchTests", 
+		ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	material->removeAllTechniques();
+	mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+}
+
+void InstanceBatchTests::tearDown()
+{
+	mRoot->destroySceneManager(mSceneMgr);
+	MeshManager::getSingleton().removeAll();
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void InstanceBatchTests::testPackAffineMatrices3x4()
+{
+	const size_t count = 7;
+	Matrix4 matrices[count];
+	const Matrix4* pointers[count];
+	for (size_t i = 0; i < count; ++i)
+	{
+		matrices[i].makeTransform(Vector3(i * 1.5f, -2.0f * i, 3.0f), Vector3(1, 2, 0.5f + i), 
+			Quaternion(Degree(i * 20.0f), Vector3(1, 1, 0).normalisedCopy()));
+		pointers[i] = &matrices[i];
+	}
+
+	const Vector3 offset(10, 20, 30);
+	float packed[count * 12 + 1];
+	for (size_t i = 0; i < count * 12 + 1; ++i)
+		packed[i] = -1.0f;
+
+	OptimisedUtil* util = OptimisedUtil::getImplementation();
+	CPPUNIT_ASSERT(util->packAffineMatrices3x4(pointers, packed, offset, count));
+	for (size_t i = 0; i < count; ++i)
+		checkPacked(matrices[i], offset, &packed[i * 12]);
+	// Writes nothing past the last matrix
+	CPPUNIT_ASSERT_EQUAL(-1.0f, packed[count * 12]);
+
+	// Packing the same values again changes nothing
+	CPPUNIT_ASSERT(!util->packAffineMatrices3x4(pointers, packed, offset, count));
+
+	// A single element changing is noticed, wherever it is
+	matrices[count - 1][2][1] += 0.25f;
+	CPPUNIT_ASSERT(util->packAffineMatrices3x4(pointers, packed, offset, count));
+	checkPacked(matrices[count - 1], offset, &packed[(count - 1) * 12]);
+	CPPUNIT_ASSERT(!util->packAffineMatrices3x4(pointers, packed, offset, count));
+
+	// So is a different translation offset
+	CPPUNIT_ASSERT(util->packAffineMatrices3x4(pointers, packed, Vector3::ZERO, count));
+	checkPacked(matrices[0], Vector3::ZERO, packed);
+}
+
+void InstanceBatchTests::testSkipUnchangedTransforms()
+{
+	MeshPtr mesh = createTriangleMesh("InstanceBatchTestsTriangle.mesh");
+
+	// Enough entities for the packing to be split in several ranges
+	const size_t count = 700;
+	PackingBatch* batch = OGRE_NEW PackingBatch(mesh, count);
+	batch->_notifyManager(mSceneMgr);
+
+	const InstanceBatch::InstancedEntityVec& entities = batch->getEntities();
+	vector<SceneNode*>::type nodes(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		entities[i]->setInUse(true);
+		nodes[i] = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(Real(i), 0, 0));
+		nodes[i]->attachObject(entities[i]);
+	}
+	mSceneMgr->getRootSceneNode()->_update(true, false);
+
+	// Everything is sent the first time
+	size_t dirtyStart = 1, dirtyEnd = 1;
+	CPPUNIT_ASSERT(batch->pack(dirtyStart, dirtyEnd));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, dirtyStart);
+	CPPUNIT_ASSERT_EQUAL(count * 12, dirtyEnd);
+	for (size_t i = 0; i < count; i += 99)
+		checkPacked(nodes[i]->_getFullTransform(), Vector3::ZERO, &batch->getTransformShadow()[i * 12]);
+
+	// Then nothing while nothing moves
+	dirtyStart = dirtyEnd = 1;
+	CPPUNIT_ASSERT(!batch->pack(dirtyStart, dirtyEnd));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, dirtyStart);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, dirtyEnd);
+
+	// Only the moved entity
+	nodes[300]->translate(0, 1, 0);
+	mSceneMgr->getRootSceneNode()->_update(true, false);
+	CPPUNIT_ASSERT(batch->pack(dirtyStart, dirtyEnd));
+	CPPUNIT_ASSERT_EQUAL((size_t)300 * 12, dirtyStart);
+	CPPUNIT_ASSERT_EQUAL((size_t)301 * 12, dirtyEnd);
+	checkPacked(nodes[300]->_getFullTransform(), Vector3::ZERO, &batch->getTransformShadow()[300 * 12]);
+
+	// The span of entities moved in different ranges
+	nodes[10]->translate(0, 1, 0);
+	nodes[650]->translate(0, 1, 0);
+	mSceneMgr->getRootSceneNode()->_update(true, false);
+	CPPUNIT_ASSERT(batch->pack(dirtyStart, dirtyEnd));
+	CPPUNIT_ASSERT_EQUAL((size_t)10 * 12, dirtyStart);
+	CPPUNIT_ASSERT_EQUAL((size_t)651 * 12, dirtyEnd);
+
+	// Hidden entities are sent as zero matrices
+	entities[500]->setVisible(false);
+	CPPUNIT_ASSERT(batch->pack(dirtyStart, dirtyEnd));
+	CPPUNIT_ASSERT_EQUAL((size_t)500 * 12, dirtyStart);
+	CPPUNIT_ASSERT_EQUAL((size_t)501 * 12, dirtyEnd);
+	checkPacked(Matrix4::ZERO, Vector3::ZERO, &batch->getTransformShadow()[500 * 12]);
+
+	// Same results when the ranges run on worker threads
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	queue->startup();
+	entities[500]->setVisible(true);
+	nodes[20]->translate(0, 1, 0);
+	mSceneMgr->getRootSceneNode()->_update(true, false);
+	CPPUNIT_ASSERT(batch->pack(dirtyStart, dirtyEnd));
+	CPPUNIT_ASSERT_EQUAL((size_t)20 * 12, dirtyStart);
+	CPPUNIT_ASSERT_EQUAL((size_t)501 * 12, dirtyEnd);
+	CPPUNIT_ASSERT(!batch->pack(dirtyStart, dirtyEnd));
+	queue->shutdown();
+
+	for (size_t i = 0; i < count; ++i)
+		nodes[i]->detachAllObjects();
+	OGRE_DELETE batch;
+}
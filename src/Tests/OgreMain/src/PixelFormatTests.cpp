@@ -26,6 +26,8 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "PixelFormatTests.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 #include <cstdlib>
 
 // Register the suite
@@ -223,7 +225,122 @@ void PixelFormatTests::testBulkConversion()
 	testCase(PF_X8B8G8R8, PF_A8B8G8R8);
 	testCase(PF_X8B8G8R8, PF_B8G8R8A8);
 	testCase(PF_X8B8G8R8, PF_R8G8B8A8);
+    // Row conversions
+    testCase(PF_A8R8G8B8, PF_FLOAT32_RGBA);
+    testCase(PF_FLOAT32_RGBA, PF_A8R8G8B8);
+    testCase(PF_FLOAT32_RGBA, PF_B8G8R8A8);
+    testCase(PF_FLOAT16_RGBA, PF_FLOAT32_RGBA);
+    testCase(PF_FLOAT32_RGBA, PF_FLOAT16_RGBA);
+    testCase(PF_FLOAT16_RGB, PF_FLOAT16_GR);
+    testCase(PF_FLOAT32_GR, PF_FLOAT16_R);
+    testCase(PF_FLOAT16_R, PF_FLOAT32_RGB);
+    testCase(PF_FLOAT32_R, PF_L8);
+    testCase(PF_R5G6B5, PF_FLOAT16_RGBA);
+    testCase(PF_SHORT_RGBA, PF_A4R4G4B4);
 
     //CPPUNIT_ASSERT_MESSAGE("Conversion mismatch", false);
 }
 
+void PixelFormatTests::testConversionPairs()
+{
+    // The conversions of the texture pipeline: loading, render targets and readback
+    const PixelFormat pairs[][2] = {
+        {PF_A8R8G8B8, PF_A8B8G8R8}, {PF_A8B8G8R8, PF_B8G8R8A8}, {PF_R8G8B8A8, PF_A8R8G8B8},
+        {PF_X8R8G8B8, PF_A8B8G8R8}, {PF_R8G8B8, PF_A8R8G8B8}, {PF_L8, PF_A8R8G8B8},
+        {PF_A8R8G8B8, PF_FLOAT32_RGBA}, {PF_FLOAT32_RGBA, PF_A8R8G8B8},
+        {PF_A8B8G8R8, PF_FLOAT16_RGBA}, {PF_FLOAT16_RGBA, PF_A8B8G8R8},
+        {PF_FLOAT16_RGBA, PF_FLOAT32_RGBA}, {PF_FLOAT32_RGBA, PF_FLOAT16_RGBA},
+        {PF_FLOAT16_RGB, PF_FLOAT32_RGB}, {PF_FLOAT32_RGB, PF_FLOAT16_RGB},
+        {PF_FLOAT16_GR, PF_FLOAT32_GR}, {PF_FLOAT32_R, PF_L8}, {PF_R8G8B8, PF_FLOAT32_RGB}
+    };
+    const size_t width = 512, height = 256;
+    const size_t bytes = width * height * 16;
+    vector<uint8>::type input(bytes), output(bytes), reference(bytes);
+    srand(0);
+    for (size_t i = 0; i < bytes; ++i)
+        input[i] = (uint8)rand();
+
+    for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); ++p)
+    {
+        PixelBox srcBox(width, height, 1, pairs[p][0], &input[0]);
+        PixelBox dstBox(width, height, 1, pairs[p][1], &output[0]);
+        PixelBox refBox(width, height, 1, pairs[p][1], &reference[0]);
+
+        naiveBulkPixelConversion(srcBox, refBox);
+        PixelUtil::bulkPixelConversion(srcBox, dstBox);
+
+        StringUtil::StrStreamType msg;
+        msg << "Conversion mismatch [" << PixelUtil::getFormatName(pairs[p][0]) << 
+            "->" << PixelUtil::getFormatName(pairs[p][1]) << "]";
+        CPPUNIT_ASSERT_MESSAGE(msg.str().c_str(), 
+            memcmp(&output[0], &reference[0], dstBox.getConsecutiveSize()) == 0);
+    }
+}
+
+
+void PixelFormatTests::testBlockCompression()
+{
+    // Smooth gradients with a bit of noise, and an alpha cutout for DXT1.
+    // Not a multiple of 4 to get partial blocks on the edges
+    const size_t width = 258, height = 130;
+    vector<uint8>::type image(width * height * 4);
+    srand(0);
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            uint8* p = &image[(y * width + x) * 4];
+            p[0] = (uint8)(x * 255 / width);
+            p[1] = (uint8)std::min<int>(255, y * 255 / height + rand() % 8);
+            p[2] = (uint8)((x + y) * 255 / (width + height));
+            p[3] = ((x / 16 + y / 16) % 3) ? 0xFF : 0;
+        }
+    }
+    PixelBox src(width, height, 1, PF_BYTE_RGBA, &image[0]);
+
+    // Root only starts its work queue with the first window
+    Root root("", "", "PixelFormatTests.log");
+    DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(root.getWorkQueue());
+    queue->setWorkerThreadCount(3);
+
+    const PixelFormat formats[] = { PF_DXT1, PF_DXT3, PF_DXT5, PF_BC4_UNORM, PF_BC5_UNORM };
+    const size_t channels[] = { 4, 4, 4, 1, 2 };
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+    {
+        vector<uint8>::type blocks(PixelUtil::getMemorySize(width, height, 1, formats[f]));
+        PixelBox compressed(width, height, 1, formats[f], &blocks[0]);
+
+        PixelUtil::bulkPixelConversion(src, compressed);
+
+        // Root's workers split the rows of blocks, the result is the same
+        vector<uint8>::type threadedBlocks(blocks.size());
+        PixelBox threaded(width, height, 1, formats[f], &threadedBlocks[0]);
+        queue->startup();
+        PixelUtil::bulkPixelConversion(src, threaded);
+        queue->shutdown();
+        CPPUNIT_ASSERT(blocks == threadedBlocks);
+
+        vector<uint8>::type decoded(image.size());
+        PixelBox dst(width, height, 1, PF_BYTE_RGBA, &decoded[0]);
+        PixelUtil::bulkPixelConversion(compressed, dst);
+
+        // Colour error stays small, alpha is kept where it is stored
+        double error = 0;
+        size_t count = 0;
+        for (size_t i = 0; i < width * height; ++i)
+        {
+            bool transparent = image[i * 4 + 3] == 0;
+            if (formats[f] == PF_DXT1)
+                CPPUNIT_ASSERT_EQUAL(transparent, decoded[i * 4 + 3] == 0);
+            else if (channels[f] == 4)
+                CPPUNIT_ASSERT_EQUAL(image[i * 4 + 3], decoded[i * 4 + 3]);
+            if (formats[f] == PF_DXT1 && transparent)
+                continue;
+            for (size_t c = 0; c < std::min<size_t>(channels[f], 3); ++c)
+                error += std::abs((int)image[i * 4 + c] - (int)decoded[i * 4 + c]);
+            count += std::min<size_t>(channels[f], 3);
+        }
+        error /= count;
+        CPPUNIT_ASSERT(error < 3);
+    }
+}
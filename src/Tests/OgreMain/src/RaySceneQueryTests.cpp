@@ -0,0 +1,390 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RaySceneQueryTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreEntity.h"
+#include "OgreManualObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreMeshManager.h"
+#include "OgreTriangleBVH.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreStringConverter.h"
+#include "OgreSubMesh.h"
+#include "OgreWorkQueue.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( RaySceneQueryTests );
+
+namespace
+{
+	/// Triangle list of a sphere centred on the origin
+	void createSpherePositions(Real radius, size_t rings, size_t segments, vector<Vector3>::type& positions)
+	{
+		for (size_t r = 0; r < rings; ++r)
+		{
+			Radian theta0(Math::PI * r / rings);
+			Radian theta1(Math::PI * (r + 1) / rings);
+			for (size_t s = 0; s < segments; ++s)
+			{
+				Radian phi0(Math::TWO_PI * s / segments);
+				Radian phi1(Math::TWO_PI * (s + 1) / segments);
+				Vector3 v00(Math::Sin(theta0) * Math::Cos(phi0), Math::Cos(theta0), Math::Sin(theta0) * Math::Sin(phi0));
+				Vector3 v01(Math::Sin(theta0) * Math::Cos(phi1), Math::Cos(theta0), Math::Sin(theta0) * Math::Sin(phi1));
+				Vector3 v10(Math::Sin(theta1) * Math::Cos(phi0), Math::Cos(theta1), Math::Sin(theta1) * Math::Sin(phi0));
+				Vector3 v11(Math::Sin(theta1) * Math::Cos(phi1), Math::Cos(theta1), Math::Sin(theta1) * Math::Sin(phi1));
+				positions.push_back(v00 * radius);
+				positions.push_back(v10 * radius);
+				positions.push_back(v11 * radius);
+				positions.push_back(v00 * radius);
+				positions.push_back(v11 * radius);
+				positions.push_back(v01 * radius);
+			}
+		}
+	}
+
+	MeshPtr createSphereMesh(const String& name)
+	{
+		vector<Vector3>::type positions;
+		createSpherePositions(1, 16, 24, positions);
+
+		ManualObject sphere("SphereBuilder");
+		sphere.begin("RayQueryTests", RenderOperation::OT_TRIANGLE_LIST);
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			sphere.position(positions[i]);
+			sphere.index((uint32)i);
+		}
+		sphere.end();
+		return sphere.convertToMesh(name);
+	}
+
+	/// Returns one world fragment per ray, freed on the next execute like BSP does
+	class FragmentRaySceneQuery : public RaySceneQuery
+	{
+	public:
+		FragmentRaySceneQuery(SceneManager* creator) : RaySceneQuery(creator), mFragment(0)
+		{
+			mSupportedWorldFragments.insert(SceneQuery::WFT_SINGLE_INTERSECTION);
+		}
+		~FragmentRaySceneQuery() { OGRE_DELETE_T(mFragment, WorldFragment, MEMCATEGORY_SCENE_CONTROL); }
+
+		void execute(RaySceneQueryListener* listener)
+		{
+			OGRE_DELETE_T(mFragment, WorldFragment, MEMCATEGORY_SCENE_CONTROL);
+			mFragment = OGRE_NEW_T(WorldFragment, MEMCATEGORY_SCENE_CONTROL)();
+			mFragment->fragmentType = SceneQuery::WFT_SINGLE_INTERSECTION;
+			mFragment->singleIntersection = mRay.getPoint(10);
+			listener->queryResult(mFragment, 10);
+		}
+
+	private:
+		WorldFragment* mFragment;
+	};
+
+	class FragmentSceneManager : public DefaultSceneManager
+	{
+	public:
+		FragmentSceneManager() : DefaultSceneManager("FragmentSceneManager") {}
+
+		RaySceneQuery* createRayQuery(const Ray& ray, unsigned long mask)
+		{
+			RaySceneQuery* query = OGRE_NEW FragmentRaySceneQuery(this);
+			query->setRay(ray);
+			query->setQueryMask(mask);
+			return query;
+		}
+	};
+
+	Ray randomRay(Real range)
+	{
+		Vector3 origin(Math::RangeRandom(-range, range), Math::RangeRandom(-range, range), 
+			Math::RangeRandom(-range, range));
+		Vector3 target(Math::RangeRandom(-range, range) * 0.5f, Math::RangeRandom(-range, range) * 0.5f,
+			Math::RangeRandom(-range, range) * 0.5f);
+		return Ray(origin, (target - origin).normalisedCopy());
+	}
+}
+
+void RaySceneQueryTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "RaySceneQueryTests.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+	// Without techniques materials can load with no render system
+	MaterialPtr material = MaterialManager::getSingleton().create("RayQueryTests", 
+		ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	material->removeAllTechniques();
+	mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+}
+
+void RaySceneQueryTests::tearDown()
+{
+	mRoot->destroySceneManager(mSceneMgr);
+	MeshManager::getSingleton().removeAll();
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void RaySceneQueryTests::testTriangleBVH()
+{
+	vector<Vector3>::type positions;
+	createSpherePositions(10, 32, 48, positions);
+	// Some triangles crossing the sphere, to get overlapping nodes
+	for (size_t i = 0; i < 200; ++i)
+	{
+		Vector3 centre(Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10));
+		for (size_t v = 0; v < 3; ++v)
+			positions.push_back(centre + Vector3(Math::RangeRandom(-3, 3), Math::RangeRandom(-3, 3), 
+				Math::RangeRandom(-3, 3)));
+	}
+	size_t numTriangles = positions.size() / 3;
+
+	TriangleBVH bvh;
+	bvh.build(&positions[0], 0, 0, numTriangles);
+	CPPUNIT_ASSERT_EQUAL(numTriangles, bvh.getTriangleCount());
+	CPPUNIT_ASSERT(bvh.getNodeCount() > 1);
+
+	for (size_t r = 0; r < 500; ++r)
+	{
+		Ray ray = randomRay(30);
+
+		Real expected = Math::POS_INFINITY;
+		size_t expectedTriangle = 0;
+		for (size_t t = 0; t < numTriangles; ++t)
+		{
+			std::pair<bool, Real> result = Math::intersects(ray, 
+				positions[t * 3], positions[t * 3 + 1], positions[t * 3 + 2], true, true);
+			if (result.first && result.second < expected)
+			{
+				expected = result.second;
+				expectedTriangle = t;
+			}
+		}
+
+		TriangleBVH::Hit hit;
+		bool found = bvh.intersects(ray, hit);
+		CPPUNIT_ASSERT_EQUAL(expected != Math::POS_INFINITY, found);
+		if (found)
+		{
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, hit.distance, 1e-3);
+			// Triangles hit at the same distance may be told apart differently
+			if (Math::Abs(expected - hit.distance) > 1e-5)
+				CPPUNIT_ASSERT_EQUAL(expectedTriangle, hit.triangleIndex);
+			Vector3 point = ray.getPoint(hit.distance);
+			const Vector3* tri = &positions[hit.triangleIndex * 3];
+			Vector3 interpolated = tri[0] * (1 - hit.u - hit.v) + tri[1] * hit.u + tri[2] * hit.v;
+			CPPUNIT_ASSERT(point.positionEquals(interpolated, 1e-3f));
+		}
+	}
+}
+
+void RaySceneQueryTests::testTriangleResults()
+{
+	MeshPtr mesh = createSphereMesh("RayQuerySphere.mesh");
+	Entity* entity = mSceneMgr->createEntity("Sphere", mesh->getName());
+	SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(100, 0, 0));
+	node->setScale(10, 10, 10);
+	node->attachObject(entity);
+	mSceneMgr->_updateSceneGraph(0);
+
+	RaySceneQuery* query = mSceneMgr->createRayQuery(Ray());
+	query->setSortByDistance(true);
+
+	// Through the centre: hits the sphere 10 units before the centre
+	query->setRay(Ray(Vector3(0, 0, 0), Vector3::UNIT_X));
+	RaySceneQueryResult& result = query->execute();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, result.size());
+	CPPUNIT_ASSERT_EQUAL(RaySceneQueryResultEntry::NO_TRIANGLE, result[0].triangleIndex);
+	Real boundsDistance = result[0].distance;
+
+	query->setQueryTriangles(true);
+	query->execute();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, result.size());
+	CPPUNIT_ASSERT(result[0].triangleIndex != RaySceneQueryResultEntry::NO_TRIANGLE);
+	CPPUNIT_ASSERT_EQUAL((unsigned short)0, result[0].subMeshIndex);
+	CPPUNIT_ASSERT(result[0].distance > boundsDistance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(90, result[0].distance, 0.1);
+
+	// Through a corner of the bounds, but missing the sphere
+	query->setRay(Ray(Vector3(0, 9.5f, 9.5f), Vector3::UNIT_X));
+	query->setQueryTriangles(false);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, query->execute().size());
+	query->setQueryTriangles(true);
+	CPPUNIT_ASSERT(query->execute().empty());
+
+	mSceneMgr->destroyQuery(query);
+	mSceneMgr->destroyEntity(entity);
+}
+
+void RaySceneQueryTests::testAxisAlignedRays()
+{
+	// A triangle with an edge along z at y = 1, the top of its box
+	Vector3 positions[] = 
+	{
+		Vector3(5, 1, -1), Vector3(5, 1, 1), Vector3(5, -1, 0),
+		Vector3(8, -4, 3), Vector3(9, -4, 3), Vector3(8, -3, 3)
+	};
+	TriangleBVH bvh;
+	bvh.build(positions, 0, 0, 2);
+
+	// Parallel to two slabs, one of them on the boundary of the box
+	TriangleBVH::Hit hit;
+	CPPUNIT_ASSERT(bvh.intersects(Ray(Vector3(0, 1, 0), Vector3::UNIT_X), hit));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(5, hit.distance, 1e-5);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, hit.triangleIndex);
+	CPPUNIT_ASSERT(bvh.intersects(Ray(Vector3(0, 0, 0), Vector3::UNIT_X), hit));
+	CPPUNIT_ASSERT(!bvh.intersects(Ray(Vector3(0, 1.5f, 0), Vector3::UNIT_X), hit));
+	CPPUNIT_ASSERT(!bvh.intersects(Ray(Vector3(0, 0, 0), Vector3::NEGATIVE_UNIT_X), hit));
+
+	CPPUNIT_ASSERT(bvh.intersects(Ray(Vector3(8.25f, -3.75f, 0), Vector3::UNIT_Z), hit));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3, hit.distance, 1e-5);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, hit.triangleIndex);
+}
+
+void RaySceneQueryTests::testShortPositions()
+{
+	MeshPtr mesh = MeshManager::getSingleton().createManual("RayQueryShorts.mesh", 
+		ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+	SubMesh* subMesh = mesh->createSubMesh();
+	subMesh->useSharedVertices = false;
+	subMesh->operationType = RenderOperation::OT_TRIANGLE_LIST;
+	subMesh->vertexData = OGRE_NEW VertexData();
+	subMesh->vertexData->vertexCount = 3;
+	subMesh->vertexData->vertexDeclaration->addElement(0, 0, VET_SHORT4, VES_POSITION);
+
+	HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+		VertexElement::getTypeSize(VET_SHORT4), 3, HardwareBuffer::HBU_STATIC);
+	short shorts[] = { 0, 0, 10, 1,  20, 0, 10, 1,  0, -20, 10, 1 };
+	vbuf->writeData(0, sizeof(shorts), shorts);
+	subMesh->vertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+	// Read as shorts, not as the floats they would make up
+	TriangleBVH bvh;
+	bvh.build(mesh.get());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, bvh.getTriangleCount());
+
+	TriangleBVH::Hit hit;
+	CPPUNIT_ASSERT(bvh.intersects(Ray(Vector3(5, -5, 0), Vector3::UNIT_Z), hit));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10, hit.distance, 1e-5);
+	CPPUNIT_ASSERT(!bvh.intersects(Ray(Vector3(15, -15, 0), Vector3::UNIT_Z), hit));
+}
+
+void RaySceneQueryTests::testBatch()
+{
+	MeshPtr mesh = createSphereMesh("RayQuerySphere.mesh");
+	for (size_t i = 0; i < 100; ++i)
+	{
+		Entity* entity = mSceneMgr->createEntity("Sphere" + StringConverter::toString(i), mesh->getName());
+		SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(
+			Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200)));
+		node->setScale(Vector3(Math::RangeRandom(5, 30)));
+		node->attachObject(entity);
+	}
+	mSceneMgr->_updateSceneGraph(0);
+
+	RayList rays;
+	for (size_t i = 0; i < 500; ++i)
+		rays.push_back(randomRay(400));
+
+	RaySceneQuery* query = mSceneMgr->createRayQuery(Ray());
+	query->setSortByDistance(true, 5);
+
+	// Once on the calling thread only, then shared with worker threads
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	for (int run = 0; run < 4; ++run)
+	{
+		bool triangles = (run & 1) != 0;
+		if (run == 2)
+			queue->startup();
+		query->setQueryTriangles(triangles);
+
+		RaySceneQueryResultList expected(rays.size());
+		for (size_t i = 0; i < rays.size(); ++i)
+		{
+			query->setRay(rays[i]);
+			expected[i] = query->execute();
+		}
+
+		RaySceneQueryResultList results;
+		query->executeBatch(rays, results);
+
+		CPPUNIT_ASSERT_EQUAL(rays.size(), results.size());
+		size_t numHits = 0;
+		for (size_t i = 0; i < rays.size(); ++i)
+		{
+			CPPUNIT_ASSERT_EQUAL(expected[i].size(), results[i].size());
+			for (size_t j = 0; j < results[i].size(); ++j)
+			{
+				CPPUNIT_ASSERT_EQUAL(expected[i][j].movable, results[i][j].movable);
+				CPPUNIT_ASSERT_EQUAL(expected[i][j].distance, results[i][j].distance);
+				CPPUNIT_ASSERT_EQUAL(expected[i][j].triangleIndex, results[i][j].triangleIndex);
+			}
+			numHits += results[i].size();
+		}
+		CPPUNIT_ASSERT(numHits > 0);
+	}
+	queue->shutdown();
+
+	mSceneMgr->destroyQuery(query);
+	mSceneMgr->destroyAllEntities();
+}
+
+void RaySceneQueryTests::testBatchWorldFragments()
+{
+	FragmentSceneManager sceneMgr;
+	RayList rays;
+	for (size_t i = 0; i < 200; ++i)
+		rays.push_back(randomRay(400));
+
+	RaySceneQuery* query = sceneMgr.createRayQuery(Ray(), 0xFFFFFFFF);
+	query->setWorldFragmentType(SceneQuery::WFT_SINGLE_INTERSECTION);
+
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	queue->startup();
+	RaySceneQueryResultList results;
+	query->executeBatch(rays, results);
+	queue->shutdown();
+
+	// The fragments outlive the queries of the threads
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL((size_t)1, results[i].size());
+		const SceneQuery::WorldFragment* fragment = results[i][0].worldFragment;
+		CPPUNIT_ASSERT(fragment);
+		CPPUNIT_ASSERT_EQUAL(SceneQuery::WFT_SINGLE_INTERSECTION, fragment->fragmentType);
+		CPPUNIT_ASSERT_EQUAL(rays[i].getPoint(10), fragment->singleIntersection);
+	}
+
+	sceneMgr.destroyQuery(query);
+}
@@ -0,0 +1,296 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ResourceManagerTests.h"
+#include "OgreRoot.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreStringConverter.h"
+#include "OgreArchiveFactory.h"
+#include "OgreArchiveManager.h"
+#include <fstream>
+#include <cstdio>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#	include <sys/utime.h>
+#else
+#	include <utime.h>
+#endif
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ResourceManagerTests );
+
+namespace
+{
+	const int NUM_NAMES = 1000;
+
+	String lookupName(int i)
+	{
+		return "ResourceManagerTests/" + StringConverter::toString(i);
+	}
+
+	/// Read-only archive over a plain file, counting how often it is listed
+	class ListCountingArchive : public Archive
+	{
+	public:
+		static size_t msListings;
+
+		ListCountingArchive(const String& name) : Archive(name, "ListCounting") {}
+		bool isCaseSensitive() const { return true; }
+		void load() {}
+		void unload() {}
+		DataStreamPtr open(const String&, bool) const { return DataStreamPtr(); }
+		StringVectorPtr list(bool recursive, bool dirs) { return find("*", recursive, dirs); }
+		FileInfoListPtr listFileInfo(bool, bool) 
+		{ 
+			return FileInfoListPtr(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		}
+		StringVectorPtr find(const String& pattern, bool recursive, bool)
+		{
+			++msListings;
+			StringVectorPtr ret(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+			if (StringUtil::match("listed.material", pattern))
+				ret->push_back("listed.material");
+			if (recursive && StringUtil::match("sub/listed.png", pattern))
+				ret->push_back("sub/listed.png");
+			return ret;
+		}
+		FileInfoListPtr findFileInfo(const String&, bool, bool) const
+		{
+			return FileInfoListPtr(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+		}
+		bool exists(const String&) { return false; }
+		time_t getModifiedTime(const String&) { return 0; }
+	};
+	size_t ListCountingArchive::msListings = 0;
+
+	class ListCountingArchiveFactory : public ArchiveFactory
+	{
+	public:
+		const String& getType() const 
+		{ 
+			static const String type = "ListCounting";
+			return type;
+		}
+		Archive* createInstance(const String& name) { return OGRE_NEW ListCountingArchive(name); }
+		void destroyInstance(Archive* arch) { OGRE_DELETE arch; }
+	};
+	ListCountingArchiveFactory listCountingFactory;
+
+	/// The archive index cache is only trusted for archives which are plain files
+	const String listCountingFile = "ResourceManagerTests.archive";
+
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+	/// Looks names up over and over until told to stop
+	struct LookupWorker OGRE_THREAD_WORKER_INHERIT
+	{
+		const vector<String>::type* names;
+		const bool* stop;
+		size_t* lookups;
+		size_t* misses;
+
+		void operator()()
+		{
+			MaterialManager& mgr = MaterialManager::getSingleton();
+			size_t n = 0, missed = 0;
+			while (!*(volatile const bool*)stop)
+			{
+				for (size_t i = 0; i < names->size(); ++i, ++n)
+					missed += mgr.getByName((*names)[i]).isNull() ? 1 : 0;
+			}
+			*lookups = n;
+			*misses = missed;
+		}
+		void run() { (*this)(); }
+	};
+
+	/// Runs numThreads lookup threads while this thread creates numCreates materials
+	void runLookups(const vector<String>::type& names, size_t numThreads, 
+		int numCreates, int createBase, size_t& misses)
+	{
+		typedef vector<OGRE_THREAD_TYPE*>::type ThreadList;
+		vector<size_t>::type lookups(numThreads), missed(numThreads);
+		vector<LookupWorker>::type workers(numThreads);
+		bool stop = false;
+		ThreadList threads;
+
+		for (size_t t = 0; t < numThreads; ++t)
+		{
+			LookupWorker w = { &names, &stop, &lookups[t], &missed[t] };
+			workers[t] = w;
+			OGRE_THREAD_CREATE(thread, workers[t]);
+			threads.push_back(thread);
+		}
+		for (int i = 0; i < numCreates; ++i)
+		{
+			MaterialManager::getSingleton().create(lookupName(createBase + i), 
+				ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+		}
+		OGRE_THREAD_SLEEP(20)
+		*(volatile bool*)&stop = true;
+
+		misses = 0;
+		for (size_t t = 0; t < numThreads; ++t)
+		{
+			threads[t]->join();
+			OGRE_THREAD_DESTROY(threads[t]);
+			misses += missed[t];
+		}
+	}
+#endif
+}
+
+void ResourceManagerTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "ResourceManagerTests.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+}
+
+void ResourceManagerTests::tearDown()
+{
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void ResourceManagerTests::testCreateOrRetrieve()
+{
+	MaterialManager& mgr = MaterialManager::getSingleton();
+	ResourceManager::ResourceCreateOrRetrieveResult first = mgr.createOrRetrieve(
+		"ResourceManagerTests/Single", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	ResourceManager::ResourceCreateOrRetrieveResult second = mgr.createOrRetrieve(
+		"ResourceManagerTests/Single", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	CPPUNIT_ASSERT(first.second);
+	CPPUNIT_ASSERT(!second.second);
+	CPPUNIT_ASSERT(first.first == second.first);
+	CPPUNIT_ASSERT(mgr.getByHandle(first.first->getHandle()) == first.first);
+
+	mgr.remove(first.first->getHandle());
+	CPPUNIT_ASSERT(mgr.getByName("ResourceManagerTests/Single").isNull());
+	CPPUNIT_ASSERT(mgr.getByHandle(first.first->getHandle()).isNull());
+}
+
+void ResourceManagerTests::testConcurrentLookups()
+{
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+	vector<String>::type names;
+	for (int i = 0; i < NUM_NAMES; ++i)
+	{
+		names.push_back(lookupName(i));
+		MaterialManager::getSingleton().create(names.back(), 
+			ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	}
+
+	int createBase = NUM_NAMES;
+	size_t numThreads[] = { 1, 2, 4 };
+	for (size_t i = 0; i < sizeof(numThreads) / sizeof(numThreads[0]); ++i)
+	{
+		size_t misses = 0;
+		runLookups(names, numThreads[i], 500, createBase, misses);
+		createBase += 500;
+
+		// Everything looked up existed before the threads started
+		CPPUNIT_ASSERT_EQUAL((size_t)0, misses);
+	}
+#endif
+}
+
+void ResourceManagerTests::testFindGroupContainingResource()
+{
+	std::ofstream(listCountingFile.c_str()) << "archive";
+	ArchiveManager::getSingleton().addArchiveFactory(&listCountingFactory);
+
+	ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+	rgm.addResourceLocation(listCountingFile, "ListCounting", "ResourceManagerTests/B", true);
+	rgm.addResourceLocation(listCountingFile, "ListCounting", "ResourceManagerTests/A", false);
+
+	// The first group by name wins, as it did when every group was searched
+	CPPUNIT_ASSERT_EQUAL(String("ResourceManagerTests/A"), rgm.findGroupContainingResource("listed.material"));
+	CPPUNIT_ASSERT_EQUAL(String("ResourceManagerTests/B"), rgm.findGroupContainingResource("sub/listed.png"));
+	// The archive is case sensitive
+	CPPUNIT_ASSERT_THROW(rgm.findGroupContainingResource("Listed.material"), Exception);
+
+	rgm.removeResourceLocation(listCountingFile, "ResourceManagerTests/A");
+	CPPUNIT_ASSERT_EQUAL(String("ResourceManagerTests/B"), rgm.findGroupContainingResource("listed.material"));
+	rgm.destroyResourceGroup("ResourceManagerTests/B");
+	CPPUNIT_ASSERT_THROW(rgm.findGroupContainingResource("listed.material"), Exception);
+
+	std::remove(listCountingFile.c_str());
+}
+
+void ResourceManagerTests::testArchiveIndexCache()
+{
+	std::ofstream(listCountingFile.c_str()) << "archive";
+	ArchiveManager::getSingleton().addArchiveFactory(&listCountingFactory);
+	ListCountingArchive::msListings = 0;
+
+	ResourceGroupManager* rgm = ResourceGroupManager::getSingletonPtr();
+	rgm->addResourceLocation(listCountingFile, "ListCounting", "ResourceManagerTests/A", true);
+	rgm->addResourceLocation(listCountingFile, "ListCounting", "ResourceManagerTests/B", true);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, ListCountingArchive::msListings);
+
+	// Name patterns are served from the listing kept for the location
+	StringVectorPtr found = rgm->findResourceNames("ResourceManagerTests/B", "*.png");
+	CPPUNIT_ASSERT_EQUAL((size_t)1, found->size());
+	CPPUNIT_ASSERT_EQUAL(String("sub/listed.png"), found->at(0));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, ListCountingArchive::msListings);
+
+	DataStreamPtr cache(OGRE_NEW MemoryDataStream(4096));
+	rgm->saveArchiveIndexCache(cache);
+
+	// A new manager picks the listing up from the saved cache
+	tearDown();
+	setUp();
+	ArchiveManager::getSingleton().addArchiveFactory(&listCountingFactory);
+	rgm = ResourceGroupManager::getSingletonPtr();
+
+	cache->seek(0);
+	rgm->loadArchiveIndexCache(cache);
+	rgm->addResourceLocation(listCountingFile, "ListCounting", "ResourceManagerTests/A", true);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, ListCountingArchive::msListings);
+	CPPUNIT_ASSERT_EQUAL(String("ResourceManagerTests/A"), rgm->findGroupContainingResource("listed.material"));
+
+	// Non recursive listings are cached apart
+	rgm->addResourceLocation(listCountingFile, "ListCounting", "ResourceManagerTests/B", false);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, ListCountingArchive::msListings);
+
+	// A change in size is noticed even if the modification time is kept
+	struct stat before;
+	stat(listCountingFile.c_str(), &before);
+	std::ofstream(listCountingFile.c_str(), std::ios::app) << " grown";
+	utimbuf times;
+	times.actime = before.st_atime;
+	times.modtime = before.st_mtime;
+	utime(listCountingFile.c_str(), &times);
+	rgm->addResourceLocation(listCountingFile, "ListCounting", "ResourceManagerTests/C", true);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, ListCountingArchive::msListings);
+
+	std::remove(listCountingFile.c_str());
+}
@@ -0,0 +1,229 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SceneManagerTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreEntity.h"
+#include "OgreLight.h"
+#include "OgreManualObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreMeshManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreSlotMap.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( SceneManagerTests );
+
+namespace
+{
+	MeshPtr createBoxMesh(const String& name)
+	{
+		ManualObject box("BoxBuilder");
+		box.begin("SceneManagerTests", RenderOperation::OT_TRIANGLE_LIST);
+		box.position(-1, -1, -1);
+		box.position(1, -1, -1);
+		box.position(1, 1, 1);
+		box.triangle(0, 1, 2);
+		box.end();
+		return box.convertToMesh(name);
+	}
+}
+
+void SceneManagerTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "SceneManagerTests.log");
+	mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+	MaterialManager::getSingleton().initialise();
+	// Without techniques materials can load with no render system
+	MaterialPtr material = MaterialManager::getSingleton().create("SceneManagerTests", 
+		ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	material->removeAllTechniques();
+	mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+}
+
+void SceneManagerTests::tearDown()
+{
+	mRoot->destroySceneManager(mSceneMgr);
+	MeshManager::getSingleton().removeAll();
+	OGRE_DELETE mBufMgr;
+	OGRE_DELETE mRoot;
+}
+
+void SceneManagerTests::testSlotMapVacantSlots()
+{
+	int a = 0, b = 0, c = 0;
+	SlotMap<int> slots;
+	SlotHandle handleA = slots.insert(&a);
+	slots.insert(&b);
+	slots.erase(handleA);
+
+	// A freed slot which is not reused yet resolves nothing, not even for the
+	// handle its next item will get
+	SlotHandle vacant = slots.nextHandle();
+	CPPUNIT_ASSERT_EQUAL(handleA.index, vacant.index);
+	CPPUNIT_ASSERT(!slots.contains(handleA));
+	CPPUNIT_ASSERT(!slots.contains(vacant));
+	CPPUNIT_ASSERT(slots.get(vacant) == 0);
+	CPPUNIT_ASSERT(slots.erase(vacant) == 0);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, slots.size());
+
+	SlotHandle handleC = slots.insert(&c);
+	CPPUNIT_ASSERT(handleC == vacant);
+	CPPUNIT_ASSERT_EQUAL(&c, slots.get(handleC));
+	CPPUNIT_ASSERT(slots.get(handleA) == 0);
+}
+
+void SceneManagerTests::testAnonymousSceneNodes()
+{
+	SceneNode* root = mSceneMgr->getRootSceneNode();
+	SceneNode* a = mSceneMgr->createAnonymousSceneNode();
+	SceneNode* b = mSceneMgr->createAnonymousSceneNode();
+	CPPUNIT_ASSERT(!a->getHandle().isNull());
+	CPPUNIT_ASSERT(a->getHandle() != b->getHandle());
+	CPPUNIT_ASSERT(a->getName() != b->getName());
+	CPPUNIT_ASSERT_EQUAL(a, mSceneMgr->getSceneNode(a->getHandle()));
+	CPPUNIT_ASSERT(!mSceneMgr->hasSceneNode(a->getName()));
+
+	// Siblings in the graph, alongside a named node
+	root->addChild(a);
+	root->addChild(b);
+	SceneNode* named = mSceneMgr->createSceneNode("Named");
+	root->addChild(named);
+	CPPUNIT_ASSERT_EQUAL((unsigned short)3, root->numChildren());
+
+	// Stale handles don't resolve, even once the slot is reused
+	SlotHandle handleA = a->getHandle();
+	mSceneMgr->destroySceneNode(a);
+	CPPUNIT_ASSERT(!mSceneMgr->hasSceneNode(handleA));
+	CPPUNIT_ASSERT_EQUAL((unsigned short)2, root->numChildren());
+	SceneNode* c = mSceneMgr->createAnonymousSceneNode();
+	CPPUNIT_ASSERT_EQUAL(handleA.index, c->getHandle().index);
+	CPPUNIT_ASSERT(handleA != c->getHandle());
+	CPPUNIT_ASSERT(!mSceneMgr->hasSceneNode(handleA));
+	mSceneMgr->destroySceneNode(handleA);
+	CPPUNIT_ASSERT(mSceneMgr->hasSceneNode(c->getHandle()));
+
+	// Destroyed along with their parent
+	b->addChild(c);
+	SlotHandle handleB = b->getHandle();
+	SlotHandle handleC = c->getHandle();
+	root->removeAndDestroyChild(b->getName());
+	CPPUNIT_ASSERT(!mSceneMgr->hasSceneNode(handleB));
+	CPPUNIT_ASSERT(!mSceneMgr->hasSceneNode(handleC));
+	CPPUNIT_ASSERT(mSceneMgr->hasSceneNode("Named"));
+
+	SceneNode* d = mSceneMgr->createAnonymousSceneNode();
+	SlotHandle handleD = d->getHandle();
+	mSceneMgr->clearScene();
+	CPPUNIT_ASSERT(!mSceneMgr->hasSceneNode(handleD));
+}
+
+void SceneManagerTests::testAnonymousMovableObjects()
+{
+	MeshPtr mesh = createBoxMesh("SceneManagerTestsBox.mesh");
+	SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(100, 0, 0));
+
+	// Anonymous objects of different types can share a node
+	Entity* entity = mSceneMgr->createAnonymousEntity(mesh);
+	Light* light = static_cast<Light*>(
+		mSceneMgr->createAnonymousMovableObject(LightFactory::FACTORY_TYPE_NAME));
+	node->attachObject(entity);
+	node->attachObject(light);
+	CPPUNIT_ASSERT_EQUAL((unsigned short)2, node->numAttachedObjects());
+	CPPUNIT_ASSERT_EQUAL(static_cast<MovableObject*>(entity), 
+		mSceneMgr->getMovableObject(entity->getHandle(), EntityFactory::FACTORY_TYPE_NAME));
+	CPPUNIT_ASSERT(!mSceneMgr->hasEntity(entity->getName()));
+	CPPUNIT_ASSERT(!mSceneMgr->getMovableObjectIterator(EntityFactory::FACTORY_TYPE_NAME).hasMoreElements());
+	SceneManager::AnonymousMovableObjectIterator it = 
+		mSceneMgr->getAnonymousMovableObjectIterator(EntityFactory::FACTORY_TYPE_NAME);
+	CPPUNIT_ASSERT_EQUAL(static_cast<MovableObject*>(entity), it.getNext());
+	CPPUNIT_ASSERT(!it.hasMoreElements());
+
+	// Still found by the default scene queries
+	mSceneMgr->_updateSceneGraph(0);
+	RaySceneQuery* query = mSceneMgr->createRayQuery(Ray(Vector3::ZERO, Vector3::UNIT_X));
+	RaySceneQueryResult& result = query->execute();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, result.size());
+	CPPUNIT_ASSERT_EQUAL(static_cast<MovableObject*>(entity), result[0].movable);
+	mSceneMgr->destroyQuery(query);
+
+	// Destroyed by pointer, by handle, or in bulk
+	SlotHandle entityHandle = entity->getHandle();
+	mSceneMgr->destroyMovableObject(entity);
+	CPPUNIT_ASSERT(!mSceneMgr->hasMovableObject(entityHandle, EntityFactory::FACTORY_TYPE_NAME));
+	CPPUNIT_ASSERT_EQUAL((unsigned short)1, node->numAttachedObjects());
+	SlotHandle lightHandle = light->getHandle();
+	mSceneMgr->destroyMovableObject(lightHandle, LightFactory::FACTORY_TYPE_NAME);
+	CPPUNIT_ASSERT(!mSceneMgr->hasMovableObject(lightHandle, LightFactory::FACTORY_TYPE_NAME));
+	// no-op on a stale handle
+	mSceneMgr->destroyMovableObject(lightHandle, LightFactory::FACTORY_TYPE_NAME);
+
+	Entity* other = mSceneMgr->createAnonymousEntity(mesh->getName());
+	SlotHandle otherHandle = other->getHandle();
+	mSceneMgr->destroyAllEntities();
+	CPPUNIT_ASSERT(!mSceneMgr->hasMovableObject(otherHandle, EntityFactory::FACTORY_TYPE_NAME));
+}
+
+void SceneManagerTests::testAnonymousChurn()
+{
+	MeshPtr mesh = createBoxMesh("SceneManagerTestsBox.mesh");
+	SceneNode* root = mSceneMgr->getRootSceneNode();
+	const size_t count = 200;
+	vector<SceneNode*>::type nodes(count);
+	vector<Entity*>::type entities(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		nodes[i] = root->createChildSceneNode();
+		entities[i] = mSceneMgr->createEntity(mesh);
+		nodes[i]->attachObject(entities[i]);
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		mSceneMgr->destroyEntity(entities[i]);
+		mSceneMgr->destroySceneNode(nodes[i]);
+	}
+	CPPUNIT_ASSERT_EQUAL((unsigned short)0, root->numChildren());
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		nodes[i] = mSceneMgr->createAnonymousSceneNode();
+		root->addChild(nodes[i]);
+		entities[i] = mSceneMgr->createAnonymousEntity(mesh);
+		nodes[i]->attachObject(entities[i]);
+	}
+	CPPUNIT_ASSERT_EQUAL((unsigned short)count, root->numChildren());
+	for (size_t i = 0; i < count; ++i)
+	{
+		mSceneMgr->destroyMovableObject(entities[i]);
+		mSceneMgr->destroySceneNode(nodes[i]);
+	}
+	CPPUNIT_ASSERT_EQUAL((unsigned short)0, root->numChildren());
+}
@@ -0,0 +1,160 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ScriptLexerTests.h"
+#include "OgreScriptLexer.h"
+#include "OgreScriptParser.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ScriptLexerTests );
+
+namespace
+{
+	const char* testScript = 
+		"// A comment\n"
+		"import * from \"base.material\"\n"
+		"set $colour \"1 0 0 1\"\n"
+		"material Test/Material : Base/Material \"Quoted Base\"\n"
+		"{\n"
+		"\t/* multi\n"
+		"\t   line */ technique\n"
+		"\t{\n"
+		"\t\tpass\r\n"
+		"\t\t{\n"
+		"\t\t\tambient $colour\n"
+		"\t\t\tdiffuse 0.5 0.5 0.5 1\n"
+		"\t\t\ttexture_unit { texture \"with \\\"escaped\\\" quotes\" }\n"
+		"\t\t}\n"
+		"\t}\n"
+		"}\n";
+}
+
+void ScriptLexerTests::setUp()
+{
+}
+void ScriptLexerTests::tearDown()
+{
+}
+void ScriptLexerTests::testTokenRefs()
+{
+	String str = testScript;
+	ScriptLexer lexer;
+	ScriptTokenRefList refs;
+	lexer.tokenize(str, refs);
+	ScriptTokenListPtr tokens = lexer.tokenize(str, "test.material");
+
+	CPPUNIT_ASSERT_EQUAL(tokens->size(), refs.size());
+	for (size_t i = 0; i < refs.size(); ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL((*tokens)[i]->lexeme, ScriptLexer::getLexeme(str, refs[i]));
+		CPPUNIT_ASSERT_EQUAL((*tokens)[i]->type, refs[i].type);
+		CPPUNIT_ASSERT_EQUAL((*tokens)[i]->line, refs[i].line);
+	}
+
+	// Words refer straight into the input
+	CPPUNIT_ASSERT_EQUAL((uint32)TID_WORD, refs[0].type);
+	CPPUNIT_ASSERT_EQUAL(String("import"), str.substr(refs[0].offset, refs[0].length));
+	CPPUNIT_ASSERT_EQUAL((uint32)2, refs[0].line);
+
+	// Escaped quotes lose their backslash, as they always have
+	size_t last = refs.size() - 1;
+	while (refs[last].type != TID_QUOTE)
+		--last;
+	const ScriptTokenRef& quote = refs[last];
+	CPPUNIT_ASSERT_EQUAL((uint32)TID_QUOTE, quote.type);
+	CPPUNIT_ASSERT_EQUAL(String("\"with \"escaped\" quotes\""), ScriptLexer::getLexeme(str, quote));
+
+	CPPUNIT_ASSERT_THROW(lexer.tokenize(String("word \"unterminated"), refs), Exception);
+}
+void ScriptLexerTests::checkSameNodes(const ConcreteNodeList& a, const ConcreteNodeList& b)
+{
+	CPPUNIT_ASSERT_EQUAL(a.size(), b.size());
+	for (ConcreteNodeList::const_iterator i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j)
+	{
+		CPPUNIT_ASSERT_EQUAL((*i)->token, (*j)->token);
+		CPPUNIT_ASSERT_EQUAL((*i)->file, (*j)->file);
+		CPPUNIT_ASSERT_EQUAL((*i)->line, (*j)->line);
+		CPPUNIT_ASSERT_EQUAL((*i)->type, (*j)->type);
+		checkSameNodes((*i)->children, (*j)->children);
+	}
+}
+void ScriptLexerTests::testParseTokenRefs()
+{
+	String str = testScript;
+	ScriptLexer lexer;
+	ScriptParser parser;
+	ScriptTokenRefList refs;
+	lexer.tokenize(str, refs);
+
+	ConcreteNodeListPtr nodes = parser.parse(str, refs, "test.material");
+	checkSameNodes(*parser.parse(lexer.tokenize(str, "test.material")), *nodes);
+
+	// import, set, material
+	CPPUNIT_ASSERT_EQUAL((size_t)3, nodes->size());
+	ConcreteNodeList::const_iterator i = nodes->begin();
+	CPPUNIT_ASSERT_EQUAL(CNT_IMPORT, (*i)->type);
+	CPPUNIT_ASSERT_EQUAL(String("base.material"), (*i)->children.back()->token);
+	++i;
+	CPPUNIT_ASSERT_EQUAL(CNT_VARIABLE_ASSIGN, (*i)->type);
+	CPPUNIT_ASSERT_EQUAL(String("1 0 0 1"), (*i)->children.back()->token);
+	++i;
+	CPPUNIT_ASSERT_EQUAL(String("material"), (*i)->token);
+	CPPUNIT_ASSERT_EQUAL(String("test.material"), (*i)->file);
+
+	String chunk = "1 \"0\" $x";
+	lexer.tokenize(chunk, refs);
+	ConcreteNodeListPtr chunkNodes = parser.parseChunk(chunk, refs, "test.material");
+	CPPUNIT_ASSERT_EQUAL((size_t)3, chunkNodes->size());
+	CPPUNIT_ASSERT_EQUAL(CNT_QUOTE, (*++chunkNodes->begin())->type);
+	CPPUNIT_ASSERT_EQUAL(String("0"), (*++chunkNodes->begin())->token);
+}
+void ScriptLexerTests::testParseLargeScript()
+{
+	StringStream script;
+	for (int i = 0; i < 200; ++i)
+	{
+		script << "material Test/Material" << i << "\n{\n\ttechnique\n\t{\n\t\tpass\n\t\t{\n"
+			<< "\t\t\tambient 0.5 0.5 0.5 1\n\t\t\tdiffuse " << i * 0.001 << " 0.25 0.75 1\n"
+			<< "\t\t\tscene_blend alpha_blend\n\t\t\ttexture_unit\n\t\t\t{\n"
+			<< "\t\t\t\ttexture \"Texture" << i << ".png\"\n\t\t\t\tscroll_anim 0.1 0.2\n"
+			<< "\t\t\t}\n\t\t}\n\t}\n}\n";
+	}
+	String str = script.str();
+	String source = "ScriptLexerTests/Large.material";
+	ScriptLexer lexer;
+	ScriptParser parser;
+
+	ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(str, source));
+	ScriptTokenRefList refs;
+	lexer.tokenize(str, refs);
+	ConcreteNodeListPtr refNodes = parser.parse(str, refs, source);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)200, nodes->size());
+	checkSameNodes(*nodes, *refNodes);
+}
@@ -102,3 +102,165 @@ void StreamSerialiserTests::testWriteBasic()
 
 	CPPUNIT_ASSERT(!arch.exists(fileName));
 }
+//--------------------------------------------------------------------------
+void StreamSerialiserTests::testCompressedChunks()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	String fileName = "testSerialiserCompressed.dat";
+	uint32 outerID = StreamSerialiser::makeIdentifier("OUTR");
+	uint32 innerID = StreamSerialiser::makeIdentifier("INNR");
+	uint32 emptyID = StreamSerialiser::makeIdentifier("EMPT");
+	uint32 nextID = StreamSerialiser::makeIdentifier("NEXT");
+	vector<uint32>::type values(4096);
+	for (size_t i = 0; i < values.size(); ++i)
+		values[i] = static_cast<uint32>(i % 16);
+	String aTestString = "Some text here";
+	// write the data
+	{
+		DataStreamPtr stream = arch.create(fileName);
+		StreamSerialiser serialiser(stream);
+
+		serialiser.writeChunkBegin(outerID, 2, true);
+		serialiser.write(&aTestString);
+		serialiser.writeChunkBegin(innerID);
+		serialiser.write(&values[0], values.size());
+		serialiser.writeChunkEnd(innerID);
+		serialiser.writeChunkEnd(outerID);
+
+		serialiser.writeChunkBegin(emptyID, 1, true);
+		serialiser.writeChunkEnd(emptyID);
+
+		serialiser.writeChunkBegin(nextID);
+		serialiser.write(&aTestString);
+		serialiser.writeChunkEnd(nextID);
+	}
+
+	// read it back
+	{
+		DataStreamPtr stream = arch.open(fileName);
+		// repetitive data should have shrunk a lot
+		CPPUNIT_ASSERT(stream->size() < values.size() * sizeof(uint32) / 4);
+
+		StreamSerialiser serialiser(stream);
+
+		const StreamSerialiser::Chunk* c = serialiser.readChunkBegin(outerID, 2);
+		CPPUNIT_ASSERT(c);
+		CPPUNIT_ASSERT(c->compressed);
+		CPPUNIT_ASSERT_EQUAL((uint16)2, c->version);
+
+		String inString;
+		serialiser.read(&inString);
+		CPPUNIT_ASSERT_EQUAL(aTestString, inString);
+		CPPUNIT_ASSERT_EQUAL(aTestString.size() + 4, serialiser.getOffsetFromChunkStart());
+
+		c = serialiser.readChunkBegin(innerID, 1);
+		CPPUNIT_ASSERT(c);
+		CPPUNIT_ASSERT(!c->compressed);
+		vector<uint32>::type inValues(values.size());
+		serialiser.read(&inValues[0], inValues.size());
+		CPPUNIT_ASSERT(inValues == values);
+		CPPUNIT_ASSERT(serialiser.isEndOfChunk(innerID));
+		serialiser.readChunkEnd(innerID);
+		CPPUNIT_ASSERT(serialiser.isEndOfChunk(outerID));
+		serialiser.readChunkEnd(outerID);
+
+		// rewinding a compressed chunk
+		c = serialiser.readChunkBegin(emptyID, 1);
+		CPPUNIT_ASSERT(c);
+		serialiser.undoReadChunk(emptyID);
+		c = serialiser.readChunkBegin(emptyID, 1);
+		CPPUNIT_ASSERT(c);
+		CPPUNIT_ASSERT(serialiser.isEndOfChunk(emptyID));
+		serialiser.readChunkEnd(emptyID);
+
+		c = serialiser.readChunkBegin(nextID, 1);
+		CPPUNIT_ASSERT(c);
+		serialiser.read(&inString);
+		CPPUNIT_ASSERT_EQUAL(aTestString, inString);
+		serialiser.readChunkEnd(nextID);
+	}
+
+	arch.remove(fileName);
+}
+//--------------------------------------------------------------------------
+void StreamSerialiserTests::testChunkDirectory()
+{
+	FileSystemArchive arch("./", "FileSystem");
+	arch.load();
+
+	String fileName = "testSerialiserDirectory.dat";
+	uint32 pageID = StreamSerialiser::makeIdentifier("PAGE");
+	uint32 otherID = StreamSerialiser::makeIdentifier("OTHR");
+	// write the data
+	{
+		DataStreamPtr stream = arch.create(fileName);
+		StreamSerialiser serialiser(stream);
+
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			serialiser.writeChunkBegin(pageID, 1, (i % 2) == 1);
+			serialiser.write(&i);
+			serialiser.writeChunkEnd(pageID);
+			serialiser.writeChunkBegin(otherID);
+			serialiser.writeChunkEnd(otherID);
+		}
+		CPPUNIT_ASSERT_EQUAL((size_t)16, serialiser.getChunkDirectory().size());
+		serialiser.writeChunkDirectory();
+	}
+
+	// random access
+	{
+		DataStreamPtr stream = arch.open(fileName);
+		StreamSerialiser serialiser(stream);
+
+		CPPUNIT_ASSERT(serialiser.readChunkDirectory());
+		CPPUNIT_ASSERT_EQUAL((size_t)16, serialiser.getChunkDirectory().size());
+		CPPUNIT_ASSERT(serialiser.getChunkDirectory()[2].compressed);
+
+		for (uint32 i = 8; i-- > 0; )
+		{
+			CPPUNIT_ASSERT(serialiser.seekToChunk(pageID, i));
+			const StreamSerialiser::Chunk* c = serialiser.readChunkBegin(pageID, 1);
+			CPPUNIT_ASSERT(c);
+			uint32 val;
+			serialiser.read(&val);
+			CPPUNIT_ASSERT_EQUAL(i, val);
+			serialiser.readChunkEnd(pageID);
+		}
+		CPPUNIT_ASSERT(!serialiser.seekToChunk(pageID, 8));
+		CPPUNIT_ASSERT(!serialiser.seekToChunk(StreamSerialiser::makeIdentifier("NONE")));
+	}
+
+	// sequential readers just see some extra chunks
+	{
+		DataStreamPtr stream = arch.open(fileName);
+		StreamSerialiser serialiser(stream);
+		size_t count = 0;
+		while (stream->tell() < stream->size())
+		{
+			const StreamSerialiser::Chunk* c = serialiser.readChunkBegin();
+			serialiser.readChunkEnd(c->id);
+			++count;
+		}
+		CPPUNIT_ASSERT_EQUAL((size_t)18, count);
+	}
+
+	// no directory
+	{
+		DataStreamPtr stream = arch.create(fileName);
+		StreamSerialiser serialiser(stream);
+		serialiser.writeChunkBegin(pageID);
+		serialiser.writeChunkEnd(pageID);
+	}
+	{
+		DataStreamPtr stream = arch.open(fileName);
+		StreamSerialiser serialiser(stream);
+		CPPUNIT_ASSERT(!serialiser.seekToChunk(pageID));
+		CPPUNIT_ASSERT(serialiser.readChunkBegin(pageID, 1));
+		serialiser.readChunkEnd(pageID);
+	}
+
+	arch.remove(fileName);
+}
@@ -31,12 +31,58 @@ THE SOFTWARE.
 #include "OgreQuaternion.h"
 #include "OgreMatrix4.h"
 #include "OgreColourValue.h"
+#include <clocale>
 
 using namespace Ogre;
 
 // Regsiter the suite
 CPPUNIT_TEST_SUITE_REGISTRATION( StringTests );
 
+namespace
+{
+	// Stream based conversions, as StringConverter used to do them
+	template <typename T>
+	String streamToString(T val, unsigned short width = 0, char fill = ' ')
+	{
+		StringStream stream;
+		stream.width(width);
+		stream.fill(fill);
+		stream << val;
+		return stream.str();
+	}
+	template <typename T>
+	T streamParse(const String& val, T defaultValue)
+	{
+		StringStream str(val);
+		T ret = defaultValue;
+		if (!(str >> ret))
+			return defaultValue;
+		return ret;
+	}
+	Vector3 streamParseVector3(const String& val)
+	{
+		vector<String>::type vec = StringUtil::split(val);
+		if (vec.size() != 3)
+			return Vector3::ZERO;
+		return Vector3(streamParse<Real>(vec[0], 0), streamParse<Real>(vec[1], 0), 
+			streamParse<Real>(vec[2], 0));
+	}
+	ColourValue streamParseColourValue(const String& val)
+	{
+		vector<String>::type vec = StringUtil::split(val);
+		if (vec.size() != 4)
+			return ColourValue::Black;
+		return ColourValue(streamParse<Real>(vec[0], 0), streamParse<Real>(vec[1], 0), 
+			streamParse<Real>(vec[2], 0), streamParse<Real>(vec[3], 0));
+	}
+	String streamToString(const ColourValue& val)
+	{
+		StringStream stream;
+		stream << val.r << " " << val.g << " " << val.b << " " << val.a;
+		return stream.str();
+	}
+}
+
 void StringTests::setUp()
 {
 	testFileNoPath = "testfile.txt";
@@ -222,3 +268,89 @@ void StringTests::testParseColourValue()
 	CPPUNIT_ASSERT_EQUAL(r, t);
 
 }
+void StringTests::testConverterMatchesStreams()
+{
+	Real reals[] = { 0, -0.0f, 1, -1, 0.5f, 23.454f, 1e-7f, 3.5e12f, -123456.7f, 
+		0.1f, 1.0f / 3.0f, 65504, 1e30f };
+	for (size_t i = 0; i < sizeof(reals) / sizeof(Real); ++i)
+	{
+		String expected = streamToString(reals[i]);
+		CPPUNIT_ASSERT_EQUAL(expected, StringConverter::toString(reals[i]));
+		CPPUNIT_ASSERT_EQUAL(streamToString(reals[i], 12, '*'), 
+			StringConverter::toString(reals[i], 6, 12, '*'));
+		CPPUNIT_ASSERT_EQUAL(streamParse<Real>(expected, 0), StringConverter::parseReal(expected));
+	}
+
+	int ints[] = { 0, 7, -7, 2147483647, -2147483647 - 1 };
+	for (size_t i = 0; i < sizeof(ints) / sizeof(int); ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL(streamToString(ints[i]), StringConverter::toString(ints[i]));
+		CPPUNIT_ASSERT_EQUAL(streamToString(ints[i], 5, '0'), StringConverter::toString(ints[i], 5, '0'));
+		CPPUNIT_ASSERT_EQUAL(ints[i], StringConverter::parseInt(streamToString(ints[i])));
+	}
+	CPPUNIT_ASSERT_EQUAL(String("+255"), StringConverter::toString(255, 0, ' ', std::ios::showpos));
+
+	// Odd input must behave as the streams do
+	const char* texts[] = { "", " ", "abc", "  1.5", "1.5abc", "-.5", "+2.", ".", "1e", "1e-3", 
+		"1.5e+2x", "0x10", "inf", "--1", "1,5", "00000000000000000000001.25", 
+		"123456789012345678901234567890", "1e400", "4.9e-60", "\t-3\r", "99999999999", 
+		"-2147483648", "2147483648", "-1", "+12" };
+	for (size_t i = 0; i < sizeof(texts) / sizeof(const char*); ++i)
+	{
+		String text = texts[i];
+		CPPUNIT_ASSERT_EQUAL(streamParse<Real>(text, 42), StringConverter::parseReal(text, 42));
+		CPPUNIT_ASSERT_EQUAL(streamParse<int>(text, 42), StringConverter::parseInt(text, 42));
+		CPPUNIT_ASSERT_EQUAL(streamParse<unsigned int>(text, 42), 
+			StringConverter::parseUnsignedInt(text, 42));
+		CPPUNIT_ASSERT_EQUAL(streamParse<long>(text, 42), StringConverter::parseLong(text, 42));
+		StringStream str(text);
+		float tst;
+		str >> tst;
+		CPPUNIT_ASSERT_EQUAL(!str.fail() && str.eof(), StringConverter::isNumber(text));
+	}
+
+	CPPUNIT_ASSERT_EQUAL(Vector3(1, 2, 3), StringConverter::parseVector3("\t1  2\n3 "));
+	CPPUNIT_ASSERT_EQUAL(Vector3::UNIT_X, StringConverter::parseVector3("1 2", Vector3::UNIT_X));
+	CPPUNIT_ASSERT_EQUAL(Vector3::UNIT_X, StringConverter::parseVector3("1 2 3 4", Vector3::UNIT_X));
+
+	StringVector strings;
+	strings.push_back("one");
+	strings.push_back("two");
+	CPPUNIT_ASSERT_EQUAL(String("one two"), StringConverter::toString(strings));
+
+	// The C locale must not leak into the results
+	if (setlocale(LC_NUMERIC, "de_DE.UTF-8") || setlocale(LC_NUMERIC, "de_DE") ||
+		setlocale(LC_NUMERIC, "fr_FR.UTF-8"))
+	{
+		String s = StringConverter::toString(Real(1.5));
+		Real r = StringConverter::parseReal("2.25");
+		setlocale(LC_NUMERIC, "C");
+		CPPUNIT_ASSERT_EQUAL(String("1.5"), s);
+		CPPUNIT_ASSERT_EQUAL(Real(2.25), r);
+	}
+}
+void StringTests::testConverterScriptValues()
+{
+	// The kind of values found in material scripts
+	vector<String>::type values;
+	for (int i = 0; i < 2000; ++i)
+	{
+		values.push_back(StringConverter::toString(ColourValue(i * 0.001f, 0.5f, 1.0f - i * 0.0005f, 1)));
+		values.push_back(StringConverter::toString(Vector3(i * 1.5f, -i * 0.25f, 100)));
+		values.push_back(StringConverter::toString(i * 0.125f));
+	}
+
+	Real sum = 0, fastSum = 0;
+	for (size_t i = 0; i < values.size(); i += 3)
+	{
+		ColourValue c = streamParseColourValue(values[i]);
+		sum += c.r + streamParseVector3(values[i + 1]).x + streamParse<Real>(values[i + 2], 0);
+		sum += streamToString(c).size();
+
+		c = StringConverter::parseColourValue(values[i]);
+		fastSum += c.r + StringConverter::parseVector3(values[i + 1]).x + 
+			StringConverter::parseReal(values[i + 2]);
+		fastSum += StringConverter::toString(c).size();
+	}
+	CPPUNIT_ASSERT_EQUAL(sum, fastSum);
+}
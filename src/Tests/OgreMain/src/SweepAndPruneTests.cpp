@@ -0,0 +1,177 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SweepAndPruneTests.h"
+#include "OgreSweepAndPrune.h"
+#include "OgreManualObject.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( SweepAndPruneTests );
+
+namespace
+{
+	typedef vector<MovableObject*>::type ObjectList;
+	typedef vector<AxisAlignedBox>::type BoxList;
+	typedef std::pair<MovableObject*, MovableObject*> ObjectPair;
+
+	/// Records the pairs, in a canonical order so duplicates can be spotted
+	class PairCollector : public SweepAndPrune::Listener
+	{
+	public:
+		set<ObjectPair>::type pairs;
+		size_t count;
+		size_t limit;
+
+		PairCollector(size_t maxPairs = ~(size_t)0) : count(0), limit(maxPairs) {}
+
+		bool overlapFound(MovableObject* a, MovableObject* b)
+		{
+			pairs.insert(a < b ? ObjectPair(a, b) : ObjectPair(b, a));
+			return ++count < limit;
+		}
+	};
+
+	void createBoxes(size_t numBoxes, Real worldSize, ObjectList& objects, BoxList& boxes)
+	{
+		for (size_t i = 0; i < numBoxes; ++i)
+		{
+			Vector3 centre(Math::RangeRandom(-worldSize, worldSize),
+				Math::RangeRandom(-worldSize, worldSize), Math::RangeRandom(-worldSize, worldSize));
+			Vector3 halfSize(Math::RangeRandom(0.5f, 10), Math::RangeRandom(0.5f, 10), 
+				Math::RangeRandom(0.5f, 10));
+			boxes.push_back(AxisAlignedBox(centre - halfSize, centre + halfSize));
+			objects.push_back(OGRE_NEW ManualObject("Box" + StringConverter::toString(i)));
+		}
+	}
+
+	void destroyBoxes(ObjectList& objects)
+	{
+		for (ObjectList::iterator i = objects.begin(); i != objects.end(); ++i)
+			OGRE_DELETE *i;
+		objects.clear();
+	}
+
+	size_t countOverlaps(const BoxList& boxes)
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < boxes.size(); ++i)
+		{
+			for (size_t j = i + 1; j < boxes.size(); ++j)
+			{
+				if (boxes[i].intersects(boxes[j]))
+					++count;
+			}
+		}
+		return count;
+	}
+}
+
+void SweepAndPruneTests::setUp()
+{
+}
+
+void SweepAndPruneTests::tearDown()
+{
+}
+
+void SweepAndPruneTests::testOverlaps()
+{
+	ObjectList objects;
+	BoxList boxes;
+	createBoxes(2000, 200, objects, boxes);
+	// Flat boxes spread along y, so the sweep isn't always on the same axis
+	for (size_t i = 0; i < 200; ++i)
+	{
+		Real y = Math::RangeRandom(-5000, 5000);
+		boxes[i] = AxisAlignedBox(-200, y, -200, 200, y + 1, 200);
+	}
+	boxes.push_back(AxisAlignedBox::BOX_INFINITE);
+	objects.push_back(OGRE_NEW ManualObject("Infinite"));
+	boxes.push_back(AxisAlignedBox::BOX_NULL);
+	objects.push_back(OGRE_NEW ManualObject("Null"));
+
+	SweepAndPrune broadPhase;
+	for (size_t i = 0; i < objects.size(); ++i)
+		broadPhase.addObject(objects[i], boxes[i]);
+	CPPUNIT_ASSERT_EQUAL(objects.size() - 1, broadPhase.getObjectCount());
+
+	PairCollector collector;
+	CPPUNIT_ASSERT(broadPhase.findOverlaps(&collector));
+	// Each pair exactly once
+	CPPUNIT_ASSERT_EQUAL(collector.pairs.size(), collector.count);
+	CPPUNIT_ASSERT_EQUAL(countOverlaps(boxes), collector.count);
+
+	// Reusing it gives the same results
+	broadPhase.clear();
+	CPPUNIT_ASSERT_EQUAL((size_t)0, broadPhase.getObjectCount());
+	for (size_t i = 0; i < objects.size(); ++i)
+		broadPhase.addObject(objects[i], boxes[i]);
+	PairCollector again;
+	broadPhase.findOverlaps(&again);
+	CPPUNIT_ASSERT(collector.pairs == again.pairs);
+
+	destroyBoxes(objects);
+}
+
+void SweepAndPruneTests::testStopSearch()
+{
+	ObjectList objects;
+	BoxList boxes;
+	createBoxes(100, 1, objects, boxes);
+
+	SweepAndPrune broadPhase;
+	for (size_t i = 0; i < objects.size(); ++i)
+		broadPhase.addObject(objects[i], boxes[i]);
+
+	PairCollector collector(3);
+	CPPUNIT_ASSERT(!broadPhase.findOverlaps(&collector));
+	CPPUNIT_ASSERT_EQUAL((size_t)3, collector.count);
+
+	destroyBoxes(objects);
+}
+
+void SweepAndPruneTests::testLargeScene()
+{
+	// Dense enough for most boxes to overlap another, SweepAndPruneBenchmarks times a bigger one
+	ObjectList objects;
+	BoxList boxes;
+	createBoxes(3000, 150, objects, boxes);
+
+	SweepAndPrune broadPhase;
+	for (size_t i = 0; i < objects.size(); ++i)
+		broadPhase.addObject(objects[i], boxes[i]);
+	PairCollector collector;
+	broadPhase.findOverlaps(&collector);
+
+	CPPUNIT_ASSERT_EQUAL(collector.pairs.size(), collector.count);
+	CPPUNIT_ASSERT_EQUAL(countOverlaps(boxes), collector.count);
+
+	destroyBoxes(objects);
+}
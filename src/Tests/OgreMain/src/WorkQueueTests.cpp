@@ -0,0 +1,214 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "WorkQueueTests.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreException.h"
+#include "OgreString.h"
+
+using namespace Ogre;
+
+// Register the suite
+CPPUNIT_TEST_SUITE_REGISTRATION( WorkQueueTests );
+
+namespace
+{
+	/// Counts how often each iteration ran and on how many threads
+	class CountingTask : public WorkQueue::ParallelTask
+	{
+	public:
+		vector<uint32>::type runs;
+		size_t grainSize;
+		bool badRange;
+		OGRE_MUTEX(mutex)
+		set<String>::type threads;
+
+		CountingTask(size_t count, size_t grain) : runs(count, 0), grainSize(grain), badRange(false) {}
+
+		void execute(size_t begin, size_t end)
+		{
+			OGRE_LOCK_MUTEX(mutex)
+			if (begin % grainSize || end > runs.size() || (end - begin > grainSize))
+				badRange = true;
+			for (size_t i = begin; i < end; ++i)
+				++runs[i];
+			StringUtil::StrStreamType id;
+#if OGRE_THREAD_SUPPORT
+			id << OGRE_THREAD_CURRENT_ID;
+#endif
+			threads.insert(id.str());
+			// Long enough for the workers to pick up some of the ranges
+			OGRE_THREAD_SLEEP(1);
+		}
+
+		bool ranOnce() const
+		{
+			for (size_t i = 0; i < runs.size(); ++i)
+			{
+				if (runs[i] != 1)
+					return false;
+			}
+			return true;
+		}
+
+		size_t threadCount() const { return threads.size(); }
+	};
+
+	/// Throws from one iteration, an Ogre::Exception or something else
+	class ThrowingTask : public WorkQueue::ParallelTask
+	{
+	public:
+		size_t throwAt;
+		bool throwOther;
+
+		ThrowingTask(size_t at, bool other = false) : throwAt(at), throwOther(other) {}
+
+		void execute(size_t begin, size_t end)
+		{
+			if (begin <= throwAt && throwAt < end)
+			{
+				if (throwOther)
+					throw (int)throwAt;
+				OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Failing iteration", "ThrowingTask::execute");
+			}
+			OGRE_THREAD_SLEEP(1);
+		}
+	};
+}
+
+void WorkQueueTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "WorkQueueTests.log");
+}
+
+void WorkQueueTests::tearDown()
+{
+	OGRE_DELETE mRoot;
+}
+
+void WorkQueueTests::testParallelForWithoutWorkers()
+{
+	// Root's queue is only started with the first window
+	CountingTask task(100, 7);
+	mRoot->getWorkQueue()->parallelFor(task, 100, 7);
+	CPPUNIT_ASSERT(task.ranOnce());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, task.threadCount());
+
+	CountingTask fallback(10, 1);
+	WorkQueue::defaultParallelFor(fallback, 10);
+	CPPUNIT_ASSERT(fallback.ranOnce());
+
+	CountingTask empty(0, 1);
+	mRoot->getWorkQueue()->parallelFor(empty, 0);
+	CPPUNIT_ASSERT(!empty.badRange);
+}
+
+void WorkQueueTests::testParallelFor()
+{
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	queue->startup();
+
+	CountingTask task(1000, 10);
+	WorkQueue::defaultParallelFor(task, 1000, 10);
+	CPPUNIT_ASSERT(task.ranOnce());
+	CPPUNIT_ASSERT(!task.badRange);
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+	CPPUNIT_ASSERT(task.threadCount() > 1);
+#endif
+
+	// A count which isn't a multiple of the grain
+	CountingTask uneven(95, 10);
+	queue->parallelFor(uneven, 95, 10);
+	CPPUNIT_ASSERT(uneven.ranOnce());
+	CPPUNIT_ASSERT(!uneven.badRange);
+
+	queue->shutdown();
+}
+
+void WorkQueueTests::testParallelForMaxParallelism()
+{
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	queue->startup();
+
+	queue->setMaxParallelism(1);
+	CountingTask serial(200, 10);
+	queue->parallelFor(serial, 200, 10);
+	CPPUNIT_ASSERT(serial.ranOnce());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, serial.threadCount());
+
+	queue->setMaxParallelism(2);
+	CountingTask pair(200, 10);
+	queue->parallelFor(pair, 200, 10);
+	CPPUNIT_ASSERT(pair.ranOnce());
+	CPPUNIT_ASSERT(pair.threadCount() <= 2);
+
+	queue->shutdown();
+}
+
+void WorkQueueTests::testParallelForException()
+{
+	DefaultWorkQueueBase* queue = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+	queue->setWorkerThreadCount(3);
+	queue->startup();
+
+	// Whichever thread runs the failing range, the caller hears about it
+	for (size_t at = 0; at < 100; at += 33)
+	{
+		ThrowingTask task(at);
+		bool thrown = false;
+		try
+		{
+			queue->parallelFor(task, 100, 1);
+		}
+		catch (Exception&)
+		{
+			thrown = true;
+		}
+		CPPUNIT_ASSERT(thrown);
+	}
+
+	// Nor does the caller wait forever when it isn't an exception class we know
+	for (size_t at = 0; at < 100; at += 33)
+	{
+		ThrowingTask task(at, true);
+		bool thrown = false;
+		try
+		{
+			queue->parallelFor(task, 100, 1);
+		}
+		catch (...)
+		{
+			thrown = true;
+		}
+		CPPUNIT_ASSERT(thrown);
+	}
+
+	queue->shutdown();
+}
@@ -27,6 +27,9 @@ THE SOFTWARE.
 */
 #include "ZipArchiveTests.h"
 #include "OgreZip.h"
+#include "OgreStringConverter.h"
+#include "OgreLogManager.h"
+#include <fstream>
 
 using namespace Ogre;
 
@@ -269,3 +272,168 @@ void ZipArchiveTests::testReadInterleave()
     CPPUNIT_ASSERT(stream2->eof());
 
 }
+
+namespace
+{
+    void writeZipUint16(std::ofstream& out, uint16 v)
+    {
+        out.put(char(v & 0xFF)).put(char(v >> 8));
+    }
+    void writeZipUint32(std::ofstream& out, uint32 v)
+    {
+        writeZipUint16(out, uint16(v & 0xFFFF));
+        writeZipUint16(out, uint16(v >> 16));
+    }
+    /** Writes a zip of stored entries all holding the same contents; the CRC is 
+        left blank. The uncompressed size is written as given, to make it wrong. */
+    void writeStoredZip(const String& zipName, const StringVector& names, const String& contents,
+        uint32 uncompressedSize)
+    {
+        std::ofstream out(zipName.c_str(), std::ios::binary);
+        const uint32 size = uint32(contents.size());
+        vector<uint32>::type offsets;
+        uint32 pos = 0;
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            // local header
+            offsets.push_back(pos);
+            writeZipUint32(out, 0x04034b50);
+            writeZipUint16(out, 10); writeZipUint16(out, 0); writeZipUint16(out, 0);
+            writeZipUint32(out, 0); writeZipUint32(out, 0);
+            writeZipUint32(out, size); writeZipUint32(out, uncompressedSize);
+            writeZipUint16(out, uint16(names[i].size())); writeZipUint16(out, 0);
+            out << names[i] << contents;
+            pos += 30 + uint32(names[i].size()) + size;
+        }
+        // central directory
+        const uint32 dirOffset = pos;
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            writeZipUint32(out, 0x02014b50);
+            writeZipUint16(out, 10); writeZipUint16(out, 10); writeZipUint16(out, 0); writeZipUint16(out, 0);
+            writeZipUint32(out, 0); writeZipUint32(out, 0);
+            writeZipUint32(out, size); writeZipUint32(out, uncompressedSize);
+            writeZipUint16(out, uint16(names[i].size())); writeZipUint16(out, 0); writeZipUint16(out, 0);
+            writeZipUint16(out, 0); writeZipUint16(out, 0); writeZipUint32(out, 0);
+            writeZipUint32(out, offsets[i]);
+            out << names[i];
+            pos += 46 + uint32(names[i].size());
+        }
+        // end of central directory
+        const uint16 numEntries = uint16(names.size());
+        writeZipUint32(out, 0x06054b50);
+        writeZipUint16(out, 0); writeZipUint16(out, 0); writeZipUint16(out, numEntries); writeZipUint16(out, numEntries);
+        writeZipUint32(out, pos - dirOffset); writeZipUint32(out, dirOffset);
+        writeZipUint16(out, 0);
+    }
+    /// Writes a zip with a single stored entry
+    void writeStoredZip(const String& zipName, const String& name, const String& contents)
+    {
+        writeStoredZip(zipName, StringVector(1, name), contents, uint32(contents.size()));
+    }
+
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+    /// Opens and reads both root files over and over
+    struct OpenWorker
+    {
+        ZipArchive* arch;
+        size_t failures;
+
+        void operator()()
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                DataStreamPtr stream1 = arch->open("rootfile.txt");
+                DataStreamPtr stream2 = arch->open("rootfile2.txt");
+                if (stream1.isNull() || stream2.isNull() ||
+                    stream1->getLine() != "this is line 1 in file 1" ||
+                    stream2->getLine() != "this is line 1 in file 2")
+                {
+                    ++failures;
+                }
+            }
+        }
+    };
+#endif
+}
+void ZipArchiveTests::testStoredRead()
+{
+    const String zipName = "StoredArchiveTest.zip";
+    writeStoredZip(zipName, "data/stored.txt", "stored entry contents");
+
+    DataStreamPtr stream;
+    {
+        ZipArchive arch(zipName, "Zip");
+        arch.load();
+        CPPUNIT_ASSERT(arch.exists("data/stored.txt"));
+        CPPUNIT_ASSERT(arch.exists("DATA/Stored.txt"));
+        CPPUNIT_ASSERT(!arch.exists("stored.txt"));
+
+        // Found by base name as well, since it is unique
+        stream = arch.open("stored.txt");
+        CPPUNIT_ASSERT(!stream.isNull());
+    }
+
+    // The stream stays readable after the archive is gone
+    CPPUNIT_ASSERT_EQUAL((size_t)21, stream->size());
+    CPPUNIT_ASSERT_EQUAL(String("stored entry contents"), stream->getAsString());
+    stream.setNull();
+    ::remove(zipName.c_str());
+}
+void ZipArchiveTests::testStoredSizeMismatch()
+{
+    // Reading the claimed size would run past the end of the mapping
+    const String zipName = "StoredMismatchTest.zip";
+    writeStoredZip(zipName, StringVector(1, "stored.txt"), "short", 1 << 20);
+    // the failure is logged
+    LogManager logManager;
+    logManager.createLog("StoredMismatchTest.log", true, false, true);
+    {
+        ZipArchive arch(zipName, "Zip");
+        arch.load();
+        CPPUNIT_ASSERT(arch.exists("stored.txt"));
+        CPPUNIT_ASSERT(arch.open("stored.txt").isNull());
+    }
+    ::remove(zipName.c_str());
+}
+void ZipArchiveTests::testMaxEntries()
+{
+    // Exactly 0xFFFF entries still fit a plain archive, it is not Zip64
+    const String zipName = "MaxEntriesTest.zip";
+    StringVector names;
+    for (uint32 i = 0; i < 0xFFFF; ++i)
+        names.push_back("e" + StringConverter::toString(i));
+    writeStoredZip(zipName, names, "x", 1);
+    {
+        ZipArchive arch(zipName, "Zip");
+        arch.load();
+        CPPUNIT_ASSERT_EQUAL((size_t)0xFFFF, arch.list()->size());
+        DataStreamPtr stream = arch.open("e65534");
+        CPPUNIT_ASSERT(!stream.isNull());
+        CPPUNIT_ASSERT_EQUAL(String("x"), stream->getAsString());
+    }
+    ::remove(zipName.c_str());
+}
+void ZipArchiveTests::testConcurrentOpen()
+{
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+    ZipArchive arch(testPath, "Zip");
+    arch.load();
+
+    const size_t numThreads = 4;
+    OpenWorker worker = { &arch, 0 };
+    vector<OpenWorker>::type workers(numThreads, worker);
+    vector<OGRE_THREAD_TYPE*>::type threads;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        OGRE_THREAD_CREATE(thread, workers[t]);
+        threads.push_back(thread);
+    }
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads[t]->join();
+        OGRE_THREAD_DESTROY(threads[t]);
+        CPPUNIT_ASSERT_EQUAL((size_t)0, workers[t].failures);
+    }
+#endif
+}
@@ -0,0 +1,278 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "BVHSceneManagerTests.h"
+#include "OgreBVHTree.h"
+#include "OgreMovableObject.h"
+#include "OgreStringConverter.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( BVHSceneManagerTests );
+
+namespace
+{
+	/// Object with nothing to render and a fixed local bounding box
+	class BoxObject : public MovableObject
+	{
+	protected:
+		AxisAlignedBox mBox;
+		static String msMovableType;
+
+	public:
+		BoxObject(const String& name, const AxisAlignedBox& box)
+			: MovableObject(name), mBox(box) {}
+
+		const String& getMovableType(void) const { return msMovableType; }
+		const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+		Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+		void _updateRenderQueue(RenderQueue* queue) {}
+		void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+	};
+	String BoxObject::msMovableType = "BoxObject";
+
+	typedef vector<SceneNode*>::type SceneNodeVec;
+	typedef vector<BoxObject*>::type BoxObjectVec;
+
+	Real nextRandom(uint32& seed)
+	{
+		seed = seed * 1664525 + 1013904223;
+		return (Real)(seed >> 8) / (Real)(1 << 24);
+	}
+
+	Vector3 randomVector(uint32& seed, Real range)
+	{
+		return Vector3((nextRandom(seed) - 0.5f) * range,
+			(nextRandom(seed) - 0.5f) * range, (nextRandom(seed) - 0.5f) * range);
+	}
+
+	void createObjects(SceneManager* sceneMgr, size_t numObjects, Real worldSize,
+		SceneNodeVec& nodes, BoxObjectVec& objects)
+	{
+		uint32 seed = 12345;
+		for (size_t i = 0; i < numObjects; ++i)
+		{
+			Real size = 1 + nextRandom(seed) * 20;
+			BoxObject* obj = OGRE_NEW BoxObject("BoxObject" + StringConverter::toString(i),
+				AxisAlignedBox(-size, -size, -size, size, size, size));
+			SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+				randomVector(seed, worldSize));
+			node->attachObject(obj);
+			nodes.push_back(node);
+			objects.push_back(obj);
+		}
+	}
+
+	/// Counts what the listener is given
+	struct CountingListener : public SceneQueryListener, public RaySceneQueryListener,
+		public IntersectionSceneQueryListener
+	{
+		size_t count;
+		CountingListener() : count(0) {}
+
+		bool queryResult(MovableObject*) { ++count; return true; }
+		bool queryResult(SceneQuery::WorldFragment*) { return true; }
+		bool queryResult(MovableObject*, Real) { ++count; return true; }
+		bool queryResult(SceneQuery::WorldFragment*, Real) { return true; }
+		bool queryResult(MovableObject*, MovableObject*) { ++count; return true; }
+		bool queryResult(MovableObject*, SceneQuery::WorldFragment*) { return true; }
+	};
+
+	struct CountingVisitor
+	{
+		size_t count;
+		CountingVisitor() : count(0) {}
+		bool operator()(BVHTree::ProxyId, void*, bool) { ++count; return true; }
+	};
+
+	struct AcceptAll
+	{
+		BVHTree::Containment operator()(const Vector3&, const Vector3&) const
+		{
+			return BVHTree::CONTAIN_FULL;
+		}
+	};
+}
+
+void BVHSceneManagerTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "BVHSceneManagerTests.log");
+	mSceneMgr = OGRE_NEW BVHSceneManager("BVHTest");
+}
+
+void BVHSceneManagerTests::tearDown()
+{
+	OGRE_DELETE mSceneMgr;
+	OGRE_DELETE mRoot;
+}
+
+void BVHSceneManagerTests::testTreeStructure()
+{
+	BVHTree tree;
+	vector<BVHTree::ProxyId>::type proxies;
+	uint32 seed = 42;
+
+	for (size_t i = 0; i < 2000; ++i)
+	{
+		Vector3 pos = randomVector(seed, 1000);
+		proxies.push_back(tree.createProxy(AxisAlignedBox(pos, pos + Vector3(5, 5, 5)), 0));
+	}
+	CPPUNIT_ASSERT(tree.validate());
+	CPPUNIT_ASSERT_EQUAL((size_t)2000, tree.getProxyCount());
+	// Balanced, so far below the proxy count
+	CPPUNIT_ASSERT(tree.getHeight() < 30);
+
+	// Small moves stay in the fat box, big ones don't
+	AxisAlignedBox box = tree.getFatBox(proxies[0]);
+	Vector3 centre = box.getCenter();
+	CPPUNIT_ASSERT(!tree.moveProxy(proxies[0], AxisAlignedBox(centre - Vector3(2.5f, 2.5f, 2.5f) + Vector3(0.1f, 0, 0),
+		centre + Vector3(2.5f, 2.5f, 2.5f) + Vector3(0.1f, 0, 0)), Vector3(0.1f, 0, 0)));
+	CPPUNIT_ASSERT(tree.moveProxy(proxies[0], AxisAlignedBox(centre + Vector3(100, 100, 100),
+		centre + Vector3(105, 105, 105)), Vector3(100, 100, 100)));
+
+	for (size_t i = 0; i < proxies.size(); i += 2)
+	{
+		Vector3 pos = randomVector(seed, 1000);
+		tree.moveProxy(proxies[i], AxisAlignedBox(pos, pos + Vector3(5, 5, 5)), Vector3::ZERO);
+	}
+	for (size_t i = 1; i < proxies.size(); i += 2)
+		tree.destroyProxy(proxies[i]);
+	CPPUNIT_ASSERT(tree.validate());
+	CPPUNIT_ASSERT_EQUAL((size_t)1000, tree.getProxyCount());
+
+	CountingVisitor visitor;
+	tree.walk(AcceptAll(), visitor);
+	CPPUNIT_ASSERT_EQUAL((size_t)1000, visitor.count);
+}
+
+void BVHSceneManagerTests::testQueries()
+{
+	SceneNodeVec nodes;
+	BoxObjectVec objects;
+	createObjects(mSceneMgr, 3000, 2000, nodes, objects);
+	mSceneMgr->_updateSceneGraph(0);
+
+	AxisAlignedBox box(-300, -200, -100, 300, 200, 100);
+	Sphere sphere(Vector3(100, 50, -200), 250);
+	Ray ray(Vector3(-1000, 10, 20), Vector3(1, 0.01f, 0.02f).normalisedCopy());
+	size_t expectedBox = 0, expectedSphere = 0, expectedRay = 0;
+	for (BoxObjectVec::iterator i = objects.begin(); i != objects.end(); ++i)
+	{
+		const AxisAlignedBox& objBox = (*i)->getWorldBoundingBox();
+		if (box.intersects(objBox))
+			++expectedBox;
+		if (sphere.intersects(objBox))
+			++expectedSphere;
+		if (ray.intersects(objBox).first)
+			++expectedRay;
+	}
+
+	CountingListener boxListener, sphereListener, rayListener;
+	SceneManager* sceneMgr = mSceneMgr;
+	AxisAlignedBoxSceneQuery* boxQuery = sceneMgr->createAABBQuery(box);
+	boxQuery->execute(&boxListener);
+	SphereSceneQuery* sphereQuery = sceneMgr->createSphereQuery(sphere);
+	sphereQuery->execute(&sphereListener);
+	RaySceneQuery* rayQuery = sceneMgr->createRayQuery(ray);
+	rayQuery->execute(&rayListener);
+
+	CPPUNIT_ASSERT_EQUAL(expectedBox, boxListener.count);
+	CPPUNIT_ASSERT_EQUAL(expectedSphere, sphereListener.count);
+	CPPUNIT_ASSERT_EQUAL(expectedRay, rayListener.count);
+
+	mSceneMgr->destroyQuery(boxQuery);
+	mSceneMgr->destroyQuery(sphereQuery);
+	mSceneMgr->destroyQuery(rayQuery);
+
+	mSceneMgr->clearScene();
+	for (BoxObjectVec::iterator i = objects.begin(); i != objects.end(); ++i)
+		OGRE_DELETE *i;
+}
+
+void BVHSceneManagerTests::testIntersectionQuery()
+{
+	SceneNodeVec nodes;
+	BoxObjectVec objects;
+	createObjects(mSceneMgr, 1000, 1000, nodes, objects);
+	// Two objects on a same node must be paired as well
+	nodes[0]->attachObject(OGRE_NEW BoxObject("Extra", AxisAlignedBox(-1, -1, -1, 1, 1, 1)));
+	mSceneMgr->_updateSceneGraph(0);
+
+	size_t expected = 1;
+	for (size_t i = 0; i < objects.size(); ++i)
+	{
+		for (size_t j = i + 1; j < objects.size(); ++j)
+		{
+			if (objects[i]->getWorldBoundingBox().intersects(objects[j]->getWorldBoundingBox()))
+				++expected;
+		}
+		MovableObject* extra = nodes[0]->getAttachedObject("Extra");
+		if (i != 0 && objects[i]->getWorldBoundingBox().intersects(extra->getWorldBoundingBox()))
+			++expected;
+	}
+
+	CountingListener listener;
+	SceneManager* sceneMgr = mSceneMgr;
+	IntersectionSceneQuery* query = sceneMgr->createIntersectionQuery();
+	query->execute(&listener);
+	mSceneMgr->destroyQuery(query);
+	CPPUNIT_ASSERT_EQUAL(expected, listener.count);
+
+	MovableObject* extra = nodes[0]->detachObject("Extra");
+	OGRE_DELETE extra;
+	mSceneMgr->clearScene();
+	for (BoxObjectVec::iterator i = objects.begin(); i != objects.end(); ++i)
+		OGRE_DELETE *i;
+}
+
+void BVHSceneManagerTests::testMovingObjects()
+{
+	// Every object moving a little every frame, most of them shouldn't touch the tree
+	const size_t numObjects = 2000;
+	const size_t numFrames = 10;
+
+	SceneNodeVec nodes;
+	BoxObjectVec objects;
+	createObjects(mSceneMgr, numObjects, 2000, nodes, objects);
+	mSceneMgr->_updateSceneGraph(0);
+
+	uint32 seed = 54321;
+	for (size_t frame = 0; frame < numFrames; ++frame)
+	{
+		for (SceneNodeVec::iterator i = nodes.begin(); i != nodes.end(); ++i)
+			(*i)->translate(randomVector(seed, 10));
+		mSceneMgr->_updateSceneGraph(0);
+	}
+
+	size_t proxies = 0;
+	mSceneMgr->getOption("ProxyCount", &proxies);
+	CPPUNIT_ASSERT_EQUAL(numObjects, proxies);
+	CPPUNIT_ASSERT(mSceneMgr->getTree().validate());
+
+	mSceneMgr->clearScene();
+	for (BoxObjectVec::iterator i = objects.begin(); i != objects.end(); ++i)
+		OGRE_DELETE *i;
+}
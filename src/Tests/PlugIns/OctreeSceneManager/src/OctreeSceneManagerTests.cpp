@@ -0,0 +1,212 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2012 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OctreeSceneManagerTests.h"
+#include "OgreMovableObject.h"
+#include "OgreStringConverter.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OctreeSceneManagerTests );
+
+namespace
+{
+	/// Object with nothing to render and a fixed local bounding box
+	class BoxObject : public MovableObject
+	{
+	protected:
+		AxisAlignedBox mBox;
+		static String msMovableType;
+
+	public:
+		BoxObject(const String& name, const AxisAlignedBox& box)
+			: MovableObject(name), mBox(box) {}
+
+		const String& getMovableType(void) const { return msMovableType; }
+		const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+		Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+		void _updateRenderQueue(RenderQueue* queue) {}
+		void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+	};
+	String BoxObject::msMovableType = "BoxObject";
+
+	typedef vector<BoxObject*>::type BoxObjectVec;
+
+	/// Cheap deterministic generator so loose and classic runs see the same scene
+	Real nextRandom(uint32& seed)
+	{
+		seed = seed * 1664525 + 1013904223;
+		return (Real)(seed >> 8) / (Real)(1 << 24);
+	}
+
+	void createObjects(SceneManager* sceneMgr, size_t numObjects, Real worldSize,
+		SceneNodeVec& nodes, BoxObjectVec& objects)
+	{
+		uint32 seed = 12345;
+		for (size_t i = 0; i < numObjects; ++i)
+		{
+			Real size = 1 + nextRandom(seed) * 20;
+			BoxObject* obj = OGRE_NEW BoxObject("BoxObject" + StringConverter::toString(i),
+				AxisAlignedBox(-size, -size, -size, size, size, size));
+			SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+				Vector3((nextRandom(seed) - 0.5f) * worldSize,
+					(nextRandom(seed) - 0.5f) * worldSize,
+					(nextRandom(seed) - 0.5f) * worldSize));
+			node->attachObject(obj);
+			nodes.push_back(node);
+			objects.push_back(obj);
+		}
+	}
+
+	void destroyObjects(SceneManager* sceneMgr, SceneNodeVec& nodes, BoxObjectVec& objects)
+	{
+		sceneMgr->clearScene();
+		for (BoxObjectVec::iterator i = objects.begin(); i != objects.end(); ++i)
+			OGRE_DELETE *i;
+		nodes.clear();
+		objects.clear();
+	}
+}
+
+void OctreeSceneManagerTests::setUp()
+{
+	mRoot = OGRE_NEW Root("", "", "OctreeSceneManagerTests.log");
+}
+
+void OctreeSceneManagerTests::tearDown()
+{
+	OGRE_DELETE mRoot;
+}
+
+void OctreeSceneManagerTests::checkBoxQuery(OctreeSceneManager* sceneMgr,
+	const SceneNodeVec& nodes, const AxisAlignedBox& box)
+{
+	list<SceneNode*>::type found;
+	sceneMgr->findNodesIn(box, found);
+
+	size_t expected = 0;
+	for (SceneNodeVec::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+	{
+		if ((*i)->_getWorldAABB().intersects(box))
+			++expected;
+	}
+
+	CPPUNIT_ASSERT_EQUAL(expected, found.size());
+}
+
+void OctreeSceneManagerTests::moveObjects(OctreeSceneManager* sceneMgr,
+	size_t numObjects, size_t numFrames)
+{
+	const Real worldSize = 2000;
+	SceneNodeVec nodes;
+	BoxObjectVec objects;
+	createObjects(sceneMgr, numObjects, worldSize, nodes, objects);
+	sceneMgr->_updateSceneGraph(0);
+
+	uint32 seed = 54321;
+	for (size_t frame = 0; frame < numFrames; ++frame)
+	{
+		for (SceneNodeVec::iterator i = nodes.begin(); i != nodes.end(); ++i)
+		{
+			// Small steps, like most moving objects do from one frame to the next
+			(*i)->translate((nextRandom(seed) - 0.5f) * 10,
+				(nextRandom(seed) - 0.5f) * 10, (nextRandom(seed) - 0.5f) * 10);
+		}
+		sceneMgr->_updateSceneGraph(0);
+	}
+
+	checkBoxQuery(sceneMgr, nodes, AxisAlignedBox(-100, -100, -100, 100, 100, 100));
+	checkBoxQuery(sceneMgr, nodes, AxisAlignedBox(200, -700, 0, 600, -300, 900));
+
+	destroyObjects(sceneMgr, nodes, objects);
+}
+
+void OctreeSceneManagerTests::testLooseOctreeQueries()
+{
+	OctreeSceneManager* sceneMgr = OGRE_NEW OctreeSceneManager("LooseQueries");
+	AxisAlignedBox worldBox(-1000, -1000, -1000, 1000, 1000, 1000);
+	sceneMgr->setOption("Size", &worldBox);
+	bool loose = true;
+	sceneMgr->setOption("LooseOctree", &loose);
+	Real looseness = 1.5;
+	sceneMgr->setOption("Looseness", &looseness);
+
+	Real value = 0;
+	CPPUNIT_ASSERT(sceneMgr->getOption("Looseness", &value));
+	CPPUNIT_ASSERT_EQUAL(looseness, value);
+	Real tooTight = 1;
+	CPPUNIT_ASSERT(!sceneMgr->setOption("Looseness", &tooTight));
+
+	moveObjects(sceneMgr, 300, 10);
+
+	OGRE_DELETE sceneMgr;
+}
+
+void OctreeSceneManagerTests::testLooseOctreeGrowth()
+{
+	OctreeSceneManager* sceneMgr = OGRE_NEW OctreeSceneManager("LooseGrowth");
+	AxisAlignedBox worldBox(-100, -100, -100, 100, 100, 100);
+	sceneMgr->setOption("Size", &worldBox);
+	bool loose = true;
+	sceneMgr->setOption("LooseOctree", &loose);
+
+	BoxObject* obj = OGRE_NEW BoxObject("Wanderer", AxisAlignedBox(-1, -1, -1, 1, 1, 1));
+	SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode();
+	node->attachObject(obj);
+	sceneMgr->_updateSceneGraph(0);
+
+	// Leaving the world makes the tree grow instead of keeping the node in the root
+	node->setPosition(1000, 0, -1000);
+	sceneMgr->_updateSceneGraph(0);
+
+	AxisAlignedBox size;
+	sceneMgr->getOption("Size", &size);
+	CPPUNIT_ASSERT(size.contains(node->_getDerivedPosition()));
+	checkBoxQuery(sceneMgr, SceneNodeVec(1, node), AxisAlignedBox(990, -10, -1010, 1010, 10, -990));
+
+	sceneMgr->clearScene();
+	OGRE_DELETE obj;
+	OGRE_DELETE sceneMgr;
+}
+
+void OctreeSceneManagerTests::testMovingObjects()
+{
+	// Both modes must keep every moving object findable
+	const size_t numObjects = 300;
+	const size_t numFrames = 20;
+
+	OctreeSceneManager* sceneMgr = OGRE_NEW OctreeSceneManager("MovingObjects");
+	AxisAlignedBox worldBox(-1000, -1000, -1000, 1000, 1000, 1000);
+	sceneMgr->setOption("Size", &worldBox);
+
+	moveObjects(sceneMgr, numObjects, numFrames);
+
+	bool loose = true;
+	sceneMgr->setOption("LooseOctree", &loose);
+	moveObjects(sceneMgr, numObjects, numFrames);
+
+	OGRE_DELETE sceneMgr;
+}